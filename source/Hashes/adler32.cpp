@@ -4,19 +4,23 @@
 ||                                                                           ||
 ||    Author: Gary Hammock, PE                                               ||
 ||    Creation Date: 2009-12-17                                              ||
-||    Last Edit Date: 2014-03-13                                             ||
+||    Last Edit Date: 2026-10-16                                             ||
 ||                                                                           ||
 ||===========================================================================||
 ||  DESCRIPTION                                                              ||
 ||===========================================================================||
-||    This abstract data type is used to calculate the CRC32 sum of an input ||
-||    message or data stream.                                                ||
+||    This abstract data type is used to calculate the Adler-32 sum of an    ||
+||    input message or data stream.  The sum can also be kept over a window  ||
+||    that slides through the data a byte at a time (rolled), as the weak    ||
+||    checksum of the rsync algorithm.                                       ||
 ||                                                                           ||
 ||===========================================================================||
 ||  CODE DEPENDENCIES                                                        ||
 ||===========================================================================||
 ||    hash_abstract.cpp (hash_abstract.lib)                                  ||
 ||    hash_abstract.h                                                        ||
+||    hash_state.cpp (hash_state.lib)                                        ||
+||    hash_state.h                                                           ||
 ||                                                                           ||
 ||===========================================================================||
 ||  REFERENCES                                                               ||
@@ -56,6 +60,11 @@
 */
 
 #include "adler32.h"
+#include "hash_state.h"
+
+const uint32_t Adler32::FILE_BUFFER_BYTES;
+const uint32_t Adler32::MODULUS;
+const uint32_t Adler32::NMAX;
 
 /******************************************************
 **            Constructors / Destructors             **
@@ -63,7 +72,9 @@
 
 /** Default constructor.  */
 Adler32::Adler32 ()
-    : MessageHash(32)
+    : MessageHash(32),
+      _A(0x0001),
+      _B(0x0000)
 {}
 
 /** Copy constructor.
@@ -73,7 +84,9 @@ Adler32::Adler32 ()
  *  @param copyFrom The Adler32 object whose values are to be copied.
 */
 Adler32::Adler32 (const Adler32 &copyFrom)
-    : MessageHash(copyFrom)
+    : MessageHash(copyFrom),
+      _A(copyFrom._A),
+      _B(copyFrom._B)
 {}
 
 /** Initialize an Adler32 object by hashing an input std::string.
@@ -84,7 +97,9 @@ Adler32::Adler32 (const Adler32 &copyFrom)
  *  @param str The std::string that is to be hashed.
 */
 Adler32::Adler32 (const string &str)
-    : MessageHash(32)
+    : MessageHash(32),
+      _A(0x0001),
+      _B(0x0000)
 {
     calculateHash(str);
 }
@@ -97,7 +112,9 @@ Adler32::Adler32 (const string &str)
  *  @param data The data that is to be hashed.
 */
 Adler32::Adler32 (const vector < byte_t > &data)
-    : MessageHash(32)
+    : MessageHash(32),
+      _A(0x0001),
+      _B(0x0000)
 {
     calculateHash(data);
 }
@@ -110,7 +127,9 @@ Adler32::Adler32 (const vector < byte_t > &data)
  *  @param file A handle to the file that is to be hashed.
 */
 Adler32::Adler32 (ifstream &file)
-    : MessageHash(32)
+    : MessageHash(32),
+      _A(0x0001),
+      _B(0x0000)
 {
     calculateHash(file);
 }
@@ -122,6 +141,44 @@ Adler32::~Adler32 ()  { }
 **               Accessors / Mutators                **
 ******************************************************/
 
+////////////////////
+//    Getters
+////////////////////
+
+/** Retrieve the name of the algorithm.
+ *
+ *  @pre The object is instantiated.
+ *  @post none.
+ *  @return "Adler-32".
+*/
+string Adler32::algorithmName (void) const
+{
+    return "Adler-32";
+}
+
+/** Copy the object, including any partially processed message.
+ *
+ *  @pre none.
+ *  @post The caller owns (and must delete) the copy.
+ *  @return A new Adler32 object in the same state.
+*/
+Adler32 * Adler32::clone (void) const
+{
+    return new Adler32(*this);
+}
+
+/** Retrieve the checksum of the data absorbed so far.  Unlike
+ *  finalize() this is cheap enough to call after every roll().
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return The Adler-32 value ((B << 16) | A).
+*/
+uint32_t Adler32::checksum (void) const
+{
+    return (_B << 16) | _A;
+}
+
 ////////////////////
 //    Setters
 ////////////////////
@@ -147,24 +204,10 @@ string Adler32::calculateHash (const string &str)
 */
 string Adler32::calculateHash (const vector < byte_t > &data)
 {
-    _initialize(32);
-
-    unsigned short A = 0x0001,
-                   B = 0x0000;
-
-    vector < byte_t >::const_iterator it;
-    for (it = data.begin(); it != data.end(); ++it)
-    {
-        A += (unsigned short)(*it);
-        A %= 65521;
-
-        B += A;
-        B %= 65521;
-    }
-
-    _hash.at(0) = ((uint32_t)B << 16) | A;
+    reset();
+    update(data);
 
-    return asString();
+    return finalize();
 }
 
 /** Calculate the Adler32 value of a file.
@@ -176,34 +219,225 @@ string Adler32::calculateHash (const vector < byte_t > &data)
 */
 string Adler32::calculateHash (ifstream &file)
 {
-    _initialize(32);
+    reset();
 
     // Check that the file is valid before doing anything else.
-    // This will return an MD5 value of all zeros.
+    // This will return a value of all zeros.
     if (file.fail() || !file.good())
+    {
+        _hash.assign(_hash.size(), 0x00000000);
         return asString();
+    }
+
+    // Read the file in large pieces rather than a byte at a time.
+    vector < byte_t > buffer(FILE_BUFFER_BYTES);
+
+    while (file.good())
+    {
+        file.read((char *)&buffer[0], buffer.size());
+        update(&buffer[0], (uint64_t)file.gcount());
+    }
+
+    // Reset the file flags and return to the file head.
+    file.clear();
+    file.seekg(0);  // Return to the head of the file.
+
+    return finalize();
+}
+
+/** Discard any message data and restart the Adler32 value.
+ *
+ *  @pre The object is instantiated.
+ *  @post The object is ready to accept a new message.
+ *  @return none.
+*/
+void Adler32::reset (void)
+{
+    _A = 0x0001;
+    _B = 0x0000;
 
-    unsigned short A = 0x0001,
-                   B = 0x0000;
+    return;
+}
 
-    byte_t value;
+/** Append message data to the Adler32 value.
+ *
+ *  @pre reset() has been called since the last finalize().
+ *  @post The data has been absorbed into the running value.
+ *  @param data A pointer to the message data.
+ *  @param length The number of bytes at data.
+ *  @return none.
+*/
+void Adler32::update (const byte_t *data, uint64_t length)
+{
+    uint32_t A = _A,
+             B = _B;
 
-    while (file.peek() != -1)
+    // The sums are only reduced every NMAX bytes; the 16-bit sums that
+    // were reduced after every byte wrapped before the reduction.
+    while (length > 0)
     {
-        value = file.get();
+        uint32_t run = (length < NMAX) ? (uint32_t)length : NMAX;
+        length -= run;
 
-        A += (unsigned short)value;
-        A %= 65521;
+        for (uint32_t i = 0; i < run; ++i)
+        {
+            A += data[i];
+            B += A;
+        }
 
-        B += A;
-        B %= 65521;
+        data += run;
+        A %= MODULUS;
+        B %= MODULUS;
     }
 
-    _hash.at(0) = ((uint32_t)B << 16) | A;
+    _A = A;
+    _B = B;
 
-    // Reset the file flags and return to the file head.
-    file.clear();
-    file.seekg(0);  // Return to the head of the file.
+    return;
+}
+
+/** Append message data to the Adler32 value.
+ *
+ *  @pre reset() has been called since the last finalize().
+ *  @post The data has been absorbed into the running value.
+ *  @param data The message data.
+ *  @return none.
+*/
+void Adler32::update (const vector < byte_t > &data)
+{
+    if (!data.empty())
+        update(&data[0], data.size());
+
+    return;
+}
+
+/** Append a run of zero bytes to the checksum in closed form: A is
+ *  unchanged and B grows by length times A.
+ *
+ *  @pre reset() has been called since the last finalize().
+ *  @post The checksum is as if length zero bytes had been passed to
+ *        update().
+ *  @param length The number of zero bytes.
+ *  @return none.
+*/
+void Adler32::updateZeros (uint64_t length)
+{
+    _B = (uint32_t)((_B + (length % MODULUS) * _A) % MODULUS);
+
+    return;
+}
+
+/** Complete the Adler32 value of the message.
+ *
+ *  @pre reset() has been called since the last finalize().
+ *  @post The Adler32 value is stored in the _hash values.
+ *  @return The Adler32 value as a std::string.
+*/
+string Adler32::finalize (void)
+{
+    _hash.at(0) = checksum();
 
     return asString();
-}
\ No newline at end of file
+}
+
+/** Append one byte to the window.
+ *
+ *  @pre none.
+ *  @post The sums cover the window with in appended.
+ *  @param in The byte that enters the window.
+ *  @return none.
+*/
+void Adler32::rollIn (byte_t in)
+{
+    _A += in;
+    if (_A >= MODULUS)
+        _A -= MODULUS;
+
+    _B += _A;
+    if (_B >= MODULUS)
+        _B -= MODULUS;
+
+    return;
+}
+
+/** Remove the oldest byte of the window.
+ *
+ *  @pre The sums cover a window of windowLength bytes whose first
+ *       byte is out.
+ *  @post The sums cover the last windowLength - 1 bytes.
+ *  @param out The byte that leaves the window.
+ *  @param windowLength The length of the window, including out.
+ *  @return none.
+*/
+void Adler32::rollOut (byte_t out, uint64_t windowLength)
+{
+    // out added itself to A once and (through A) to each of the
+    // windowLength values summed into B, along with A's initial 1.
+    uint32_t outB = (uint32_t)(((windowLength % MODULUS) * out + 1)
+                               % MODULUS);
+
+    _A = (_A + MODULUS - out) % MODULUS;
+    _B = (_B + MODULUS - outB) % MODULUS;
+
+    return;
+}
+
+/** Slide the window one byte in O(1): rollOut() and then rollIn().
+ *
+ *  @pre The sums cover a window of windowLength bytes whose first
+ *       byte is out.
+ *  @post The sums cover the window moved on by one byte.
+ *  @param out The byte that leaves the window.
+ *  @param in The byte that enters the window.
+ *  @param windowLength The length of the window.
+ *  @return none.
+*/
+void Adler32::roll (byte_t out, byte_t in, uint64_t windowLength)
+{
+    rollOut(out, windowLength);
+    rollIn(in);
+
+    return;
+}
+
+/******************************************************
+**                   Helper Methods                  **
+******************************************************/
+
+/** Append the running value to an exported state.
+ *
+ *  @pre none.
+ *  @post The midstate is appended to state.
+ *  @param state The state that is being exported.
+ *  @return none.
+*/
+void Adler32::_saveState (HashState &state) const
+{
+    state.putWord32(_A);
+    state.putWord32(_B);
+
+    return;
+}
+
+/** Restore the running value from an imported state.
+ *
+ *  @pre The common header of state has been read and checked.
+ *  @post The object holds the imported state.
+ *  @param state The state that is being imported.
+ *  @return true The values read are consistent.
+ *  @return false The state is corrupt.
+*/
+bool Adler32::_loadState (HashState &state)
+{
+    uint32_t A = state.getWord32(),
+             B = state.getWord32();
+
+    // Both sums are reduced modulo 65521 between calls.
+    if ((A >= MODULUS) || (B >= MODULUS))
+        return false;
+
+    _A = A;
+    _B = B;
+
+    return true;
+}
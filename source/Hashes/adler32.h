@@ -4,13 +4,15 @@
 ||                                                                           ||
 ||    Author: Gary Hammock, PE                                               ||
 ||    Creation Date: 2009-12-17                                              ||
-||    Last Edit Date: 2014-03-13                                             ||
+||    Last Edit Date: 2026-10-16                                             ||
 ||                                                                           ||
 ||===========================================================================||
 ||  DESCRIPTION                                                              ||
 ||===========================================================================||
-||    This abstract data type is used to calculate the CRC32 sum of an input ||
-||    message or data stream.                                                ||
+||    This abstract data type is used to calculate the Adler-32 sum of an    ||
+||    input message or data stream.  The sum can also be kept over a window  ||
+||    that slides through the data a byte at a time (rolled), as the weak    ||
+||    checksum of the rsync algorithm.                                       ||
 ||                                                                           ||
 ||===========================================================================||
 ||  CODE DEPENDENCIES                                                        ||
@@ -67,6 +69,20 @@
 class Adler32 : public MessageHash
 {
   public:
+    /******************************************************
+    **                     Constants                     **
+    ******************************************************/
+
+    /// The number of bytes read from a file per call to update().
+    static const uint32_t FILE_BUFFER_BYTES = 65536;
+
+    /// The sums are reduced modulo the largest prime below 2^16.
+    static const uint32_t MODULUS = 65521;
+
+    /// The most bytes that can be summed before B could overflow 32 bits
+    /// (and so between the reductions of update()).
+    static const uint32_t NMAX = 5552;
+
     /******************************************************
     **            Constructors / Destructors             **
     ******************************************************/
@@ -116,6 +132,35 @@ class Adler32 : public MessageHash
     **               Accessors / Mutators                **
     ******************************************************/
 
+    ////////////////////
+    //    Getters
+    ////////////////////
+
+    /** Retrieve the name of the algorithm.
+     *
+     *  @pre The object is instantiated.
+     *  @post none.
+     *  @return "Adler-32".
+    */
+    string algorithmName (void) const;
+
+    /** Copy the object, including any partially processed message.
+     *
+     *  @pre none.
+     *  @post The caller owns (and must delete) the copy.
+     *  @return A new Adler32 object in the same state.
+    */
+    Adler32 * clone (void) const;
+
+    /** Retrieve the checksum of the data absorbed so far.  Unlike
+     *  finalize() this is cheap enough to call after every roll().
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return The Adler-32 value ((B << 16) | A).
+    */
+    uint32_t checksum (void) const;
+
     ////////////////////
     //    Setters
     ////////////////////
@@ -147,6 +192,114 @@ class Adler32 : public MessageHash
     */
     string calculateHash (ifstream &file);
 
-};  // End class CRC32.
+    /** Discard any message data and restart the Adler32 value.
+     *
+     *  @pre The object is instantiated.
+     *  @post The object is ready to accept a new message.
+     *  @return none.
+    */
+    void reset (void);
+
+    /** Append message data to the Adler32 value.
+     *
+     *  @pre reset() has been called since the last finalize().
+     *  @post The data has been absorbed into the running value.
+     *  @param data A pointer to the message data.
+     *  @param length The number of bytes at data.
+     *  @return none.
+    */
+    void update (const byte_t *data, uint64_t length);
+
+    /** Append message data to the Adler32 value.
+     *
+     *  @pre reset() has been called since the last finalize().
+     *  @post The data has been absorbed into the running value.
+     *  @param data The message data.
+     *  @return none.
+    */
+    void update (const vector < byte_t > &data);
+
+    /** Append a run of zero bytes to the checksum in closed form: A is
+     *  unchanged and B grows by length times A.
+     *
+     *  @pre reset() has been called since the last finalize().
+     *  @post The checksum is as if length zero bytes had been passed to
+     *        update().
+     *  @param length The number of zero bytes.
+     *  @return none.
+    */
+    void updateZeros (uint64_t length);
+
+    /** Complete the Adler32 value of the message.
+     *
+     *  @pre reset() has been called since the last finalize().
+     *  @post The Adler32 value is stored in the _hash values.
+     *  @return The Adler32 value as a std::string.
+    */
+    string finalize (void);
+
+    /** Append one byte to the window.
+     *
+     *  @pre none.
+     *  @post The sums cover the window with in appended.
+     *  @param in The byte that enters the window.
+     *  @return none.
+    */
+    void rollIn (byte_t in);
+
+    /** Remove the oldest byte of the window.
+     *
+     *  @pre The sums cover a window of windowLength bytes whose first
+     *       byte is out.
+     *  @post The sums cover the last windowLength - 1 bytes.
+     *  @param out The byte that leaves the window.
+     *  @param windowLength The length of the window, including out.
+     *  @return none.
+    */
+    void rollOut (byte_t out, uint64_t windowLength);
+
+    /** Slide the window one byte in O(1): rollOut() and then rollIn().
+     *
+     *  @pre The sums cover a window of windowLength bytes whose first
+     *       byte is out.
+     *  @post The sums cover the window moved on by one byte.
+     *  @param out The byte that leaves the window.
+     *  @param in The byte that enters the window.
+     *  @param windowLength The length of the window.
+     *  @return none.
+    */
+    void roll (byte_t out, byte_t in, uint64_t windowLength);
+
+  private:
+    /******************************************************
+    **                      Members                      **
+    ******************************************************/
+    uint32_t _A;  // The running sum of the bytes.
+    uint32_t _B;  // The running sum of the A values.
+
+    /******************************************************
+    **                   Helper Methods                  **
+    ******************************************************/
+
+    /** Append the running value to an exported state.
+     *
+     *  @pre none.
+     *  @post The midstate is appended to state.
+     *  @param state The state that is being exported.
+     *  @return none.
+    */
+    void _saveState (HashState &state) const;
+
+    /** Restore the running value from an imported state.
+     *
+     *  @pre The common header of state has been read and checked.
+     *  @post The object holds the imported state.
+     *  @param state The state that is being imported.
+     *  @return true The values read are consistent.
+     *  @return false The state is corrupt.
+    */
+    bool _loadState (HashState &state);
+
+};  // End class Adler32.
 
 #endif
\ No newline at end of file
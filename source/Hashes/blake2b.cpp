@@ -0,0 +1,1633 @@
+/******************************************************************************
+||  blake2b.cpp                                                              ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    This abstract data type is used to calculate the BLAKE2b hash of an    ||
+||    input message or data stream, optionally keyed, and the BLAKE2bp       ||
+||    variant which splits the message over four BLAKE2b leaves that are     ||
+||    hashed side by side (in the lanes of the AVX2 kernel or on separate    ||
+||    threads).                                                              ||
+||                                                                           ||
+||    The compression kernels are chosen at run time: SSE4.1 and AVX2        ||
+||    kernels for a single message, and an AVX2 kernel that advances all     ||
+||    four BLAKE2bp leaves at once.                                          ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    cpu_features.cpp (cpu_features.lib)                                    ||
+||    cpu_features.h                                                         ||
+||    hash_abstract.cpp (hash_abstract.lib)                                  ||
+||    hash_abstract.h                                                        ||
+||    pthread                                                                ||
+||                                                                           ||
+||===========================================================================||
+||  REFERENCES                                                               ||
+||===========================================================================||
+||    Saarinen, M-J. and Aumasson, J-P.  RFC 7693.  "The BLAKE2              ||
+||        Cryptographic Hash and Message Authentication Code (MAC)".  Nov    ||
+||        2015.                                                              ||
+||                                                                           ||
+||    Aumasson, J-P., Neves, S., Wilcox-O'Hearn, Z. and Winnerlein, C.       ||
+||        "BLAKE2: simpler, smaller, fast as MD5".  Jan 2013.                ||
+||        https://www.blake2.net/blake2.pdf                                  ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file blake2b.cpp
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "blake2b.h"
+#include "hash_state.h"
+#include "cpu_features.h"
+
+#ifdef GASH_X86_SIMD
+  #include <immintrin.h>
+#endif
+
+const uint32_t BLAKE2b::BLOCK_BYTES;
+const uint32_t BLAKE2b::MAX_DIGEST_BYTES;
+const uint32_t BLAKE2b::MAX_KEY_BYTES;
+const uint32_t BLAKE2b::FILE_BUFFER_BYTES;
+const uint32_t BLAKE2bp::LEAVES;
+const uint32_t BLAKE2bp::PARALLEL_BUFFER_BYTES;
+const uint32_t BLAKE2bp::SUPERBLOCK_BYTES;
+const uint32_t BLAKE2bp::HOLD_BYTES;
+
+// BLAKE2b reuses the SHA-512 initial hash values.
+static const uint64_t IV2B[8] =
+{
+    0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL,
+    0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+    0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL,
+    0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL
+};
+
+// The message word order of each round; rounds 10 and 11 reuse the
+// first two rows.
+static const uint8_t SIGMA[10][16] =
+{
+    {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+    { 14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3 },
+    { 11,  8, 12,  0,  5,  2, 15, 13, 10, 14,  3,  6,  7,  1,  9,  4 },
+    {  7,  9,  3,  1, 13, 12, 11, 14,  2,  6,  5, 10,  4,  0, 15,  8 },
+    {  9,  0,  5,  7,  2,  4, 10, 15, 14,  1, 11, 12,  6,  8,  3, 13 },
+    {  2, 12,  6, 10,  0, 11,  8,  3,  4, 13,  7,  5, 15, 14,  1,  9 },
+    { 12,  5,  1, 15, 14, 13,  4, 10,  0,  7,  6,  3,  9,  2,  8, 11 },
+    { 13, 11,  7, 14, 12,  1,  3,  9,  5,  0, 15,  4,  8,  6,  2, 10 },
+    {  6, 15, 14,  9, 11,  3,  0,  8, 12,  2, 13,  7,  1,  4, 10,  5 },
+    { 10,  2,  8,  4,  7,  6,  1,  5, 15, 11,  9, 14,  3, 12, 13,  0 }
+};
+
+// The finalization flags of a compression.
+enum
+{
+    FINAL_BLOCK = 0x01,   // The last block of a node.
+    LAST_NODE   = 0x02    // ... which is also the last node of its level.
+};
+
+// Leaf ranges smaller than this are not worth handing to other threads.
+static const uint64_t MIN_THREAD_BYTES = 256 * 1024;
+
+/******************************************************
+**                 Compression Kernels               **
+******************************************************/
+
+// A kernel compresses count blocks that are stride bytes apart.  The
+// counter is the message length up to and including the first block and
+// advances by one block for each of the others; flags apply to every
+// block, so final blocks are compressed on their own.
+typedef void (*Blake2bKernel)(uint64_t h[8], const byte_t *blocks,
+                              uint64_t count, uint64_t stride,
+                              uint64_t counter, uint32_t flags);
+
+// A leaves kernel advances all four BLAKE2bp leaves by one block of each
+// superblock (none of which are final blocks).
+typedef void (*Blake2bLeavesKernel)(uint64_t leaves[4][8],
+                                    const byte_t *superblocks,
+                                    uint64_t count, uint64_t counter);
+
+static inline uint64_t rotr64 (uint64_t x, uint32_t n)
+{  return ((x >> n) | (x << (64 - n)));  }
+
+static inline uint64_t loadLittleEndian64 (const byte_t *p)
+{
+    uint64_t x = 0;
+    for (int i = 7; i >= 0; --i)
+        x = (x << 8) | p[i];
+
+    return x;
+}
+
+static inline void storeLittleEndian64 (byte_t *p, uint64_t x)
+{
+    for (uint32_t i = 0; i < 8; ++i)
+        p[i] = (byte_t)(x >> (i * 8));
+}
+
+/** The mixing function.  */
+static GASH_ALWAYS_INLINE void
+blake2bG (uint64_t v[16], uint32_t a, uint32_t b, uint32_t c, uint32_t d,
+          uint64_t x, uint64_t y)
+{
+    v[a] = v[a] + v[b] + x;
+    v[d] = rotr64(v[d] ^ v[a], 32);
+    v[c] = v[c] + v[d];
+    v[b] = rotr64(v[b] ^ v[c], 24);
+    v[a] = v[a] + v[b] + y;
+    v[d] = rotr64(v[d] ^ v[a], 16);
+    v[c] = v[c] + v[d];
+    v[b] = rotr64(v[b] ^ v[c], 63);
+}
+
+/** One round: mix the columns and then the diagonals.  */
+static GASH_ALWAYS_INLINE void
+blake2bRound (uint64_t v[16], const uint64_t m[16], uint32_t r)
+{
+    const uint8_t *s = SIGMA[r % 10];
+
+    blake2bG(v, 0, 4,  8, 12, m[s[ 0]], m[s[ 1]]);
+    blake2bG(v, 1, 5,  9, 13, m[s[ 2]], m[s[ 3]]);
+    blake2bG(v, 2, 6, 10, 14, m[s[ 4]], m[s[ 5]]);
+    blake2bG(v, 3, 7, 11, 15, m[s[ 6]], m[s[ 7]]);
+
+    blake2bG(v, 0, 5, 10, 15, m[s[ 8]], m[s[ 9]]);
+    blake2bG(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+    blake2bG(v, 2, 7,  8, 13, m[s[12]], m[s[13]]);
+    blake2bG(v, 3, 4,  9, 14, m[s[14]], m[s[15]]);
+}
+
+/** The portable kernel.  */
+static void blake2bCompressPortable (uint64_t h[8], const byte_t *blocks,
+                                     uint64_t count, uint64_t stride,
+                                     uint64_t counter, uint32_t flags)
+{
+    uint64_t m[16], v[16];
+
+    for (; count > 0; --count, blocks += stride,
+                      counter += BLAKE2b::BLOCK_BYTES)
+    {
+        for (uint32_t i = 0; i < 16; ++i)
+            m[i] = loadLittleEndian64(blocks + (i * 8));
+
+        for (uint32_t i = 0; i < 8; ++i)
+        {
+            v[i] = h[i];
+            v[i + 8] = IV2B[i];
+        }
+
+        // The high word of the 128-bit counter is always zero here.
+        v[12] ^= counter;
+        if (flags & FINAL_BLOCK)
+            v[14] = ~v[14];
+        if (flags & LAST_NODE)
+            v[15] = ~v[15];
+
+        for (uint32_t r = 0; r < 12; ++r)
+            blake2bRound(v, m, r);
+
+        for (uint32_t i = 0; i < 8; ++i)
+            h[i] ^= v[i] ^ v[i + 8];
+    }
+}
+
+#ifdef GASH_X86_SIMD
+
+// The single message kernels keep each row of the 4x4 working matrix in
+// registers (two XMM or one YMM register per row) and run the four G
+// functions of a column or diagonal step side by side; the rows are
+// rotated between the steps to line up the diagonals.
+
+__attribute__((target("sse4.1")))
+static GASH_ALWAYS_INLINE __m128i rotr64x2 (__m128i x, int n)
+{
+    // Rotations by whole bytes are a single shuffle.
+    if (n == 32)
+        return _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1));
+    if (n == 24)
+        return _mm_shuffle_epi8(x, _mm_setr_epi8( 3,  4,  5,  6,  7,  0,  1,  2,
+                                                 11, 12, 13, 14, 15,  8,  9, 10));
+    if (n == 16)
+        return _mm_shuffle_epi8(x, _mm_setr_epi8( 2,  3,  4,  5,  6,  7,  0,  1,
+                                                 10, 11, 12, 13, 14, 15,  8,  9));
+
+    return _mm_or_si128(_mm_srli_epi64(x, n), _mm_slli_epi64(x, 64 - n));
+}
+
+/** The four G functions of a column (or diagonal) step.  row[2k] and
+ *  row[2k + 1] are the low and high halves of row k; s points to the
+ *  eight message indices of the step.
+*/
+__attribute__((target("sse4.1")))
+static GASH_ALWAYS_INLINE void
+blake2bStep2 (__m128i row[8], const uint64_t m[16], const uint8_t *s)
+{
+    __m128i xl = _mm_set_epi64x((long long)m[s[2]], (long long)m[s[0]]),
+            xh = _mm_set_epi64x((long long)m[s[6]], (long long)m[s[4]]),
+            yl = _mm_set_epi64x((long long)m[s[3]], (long long)m[s[1]]),
+            yh = _mm_set_epi64x((long long)m[s[7]], (long long)m[s[5]]);
+
+    row[0] = _mm_add_epi64(_mm_add_epi64(row[0], row[2]), xl);
+    row[1] = _mm_add_epi64(_mm_add_epi64(row[1], row[3]), xh);
+    row[6] = rotr64x2(_mm_xor_si128(row[6], row[0]), 32);
+    row[7] = rotr64x2(_mm_xor_si128(row[7], row[1]), 32);
+    row[4] = _mm_add_epi64(row[4], row[6]);
+    row[5] = _mm_add_epi64(row[5], row[7]);
+    row[2] = rotr64x2(_mm_xor_si128(row[2], row[4]), 24);
+    row[3] = rotr64x2(_mm_xor_si128(row[3], row[5]), 24);
+
+    row[0] = _mm_add_epi64(_mm_add_epi64(row[0], row[2]), yl);
+    row[1] = _mm_add_epi64(_mm_add_epi64(row[1], row[3]), yh);
+    row[6] = rotr64x2(_mm_xor_si128(row[6], row[0]), 16);
+    row[7] = rotr64x2(_mm_xor_si128(row[7], row[1]), 16);
+    row[4] = _mm_add_epi64(row[4], row[6]);
+    row[5] = _mm_add_epi64(row[5], row[7]);
+    row[2] = rotr64x2(_mm_xor_si128(row[2], row[4]), 63);
+    row[3] = rotr64x2(_mm_xor_si128(row[3], row[5]), 63);
+}
+
+/** The SSE4.1 kernel.  */
+__attribute__((target("sse4.1")))
+static void blake2bCompressSSE41 (uint64_t h[8], const byte_t *blocks,
+                                  uint64_t count, uint64_t stride,
+                                  uint64_t counter, uint32_t flags)
+{
+    const __m128i iv0 = _mm_loadu_si128((const __m128i *)&IV2B[0]),
+                  iv1 = _mm_loadu_si128((const __m128i *)&IV2B[2]),
+                  iv2 = _mm_loadu_si128((const __m128i *)&IV2B[4]),
+                  iv3 = _mm_loadu_si128((const __m128i *)&IV2B[6]);
+
+    const __m128i final = _mm_set_epi64x(
+                              (flags & LAST_NODE) ? -1LL : 0LL,
+                              (flags & FINAL_BLOCK) ? -1LL : 0LL);
+
+    __m128i h0 = _mm_loadu_si128((const __m128i *)&h[0]),
+            h1 = _mm_loadu_si128((const __m128i *)&h[2]),
+            h2 = _mm_loadu_si128((const __m128i *)&h[4]),
+            h3 = _mm_loadu_si128((const __m128i *)&h[6]);
+
+    uint64_t m[16];
+    __m128i row[8], t0, t1;
+
+    for (; count > 0; --count, blocks += stride,
+                      counter += BLAKE2b::BLOCK_BYTES)
+    {
+        memcpy(m, blocks, sizeof(m));
+
+        row[0] = h0;
+        row[1] = h1;
+        row[2] = h2;
+        row[3] = h3;
+        row[4] = iv0;
+        row[5] = iv1;
+        row[6] = _mm_xor_si128(iv2, _mm_set_epi64x(0, (long long)counter));
+        row[7] = _mm_xor_si128(iv3, final);
+
+        for (uint32_t r = 0; r < 12; ++r)
+        {
+            const uint8_t *s = SIGMA[r % 10];
+
+            blake2bStep2(row, m, s);
+
+            // Rotate rows 1, 2 and 3 left by 1, 2 and 3 words so that the
+            // diagonals become columns.
+            t0 = _mm_alignr_epi8(row[3], row[2], 8);
+            t1 = _mm_alignr_epi8(row[2], row[3], 8);
+            row[2] = t0;
+            row[3] = t1;
+            t0 = row[4];
+            row[4] = row[5];
+            row[5] = t0;
+            t0 = _mm_alignr_epi8(row[7], row[6], 8);
+            t1 = _mm_alignr_epi8(row[6], row[7], 8);
+            row[6] = t1;
+            row[7] = t0;
+
+            blake2bStep2(row, m, s + 8);
+
+            t0 = _mm_alignr_epi8(row[2], row[3], 8);
+            t1 = _mm_alignr_epi8(row[3], row[2], 8);
+            row[2] = t0;
+            row[3] = t1;
+            t0 = row[4];
+            row[4] = row[5];
+            row[5] = t0;
+            t0 = _mm_alignr_epi8(row[6], row[7], 8);
+            t1 = _mm_alignr_epi8(row[7], row[6], 8);
+            row[6] = t1;
+            row[7] = t0;
+        }
+
+        h0 = _mm_xor_si128(h0, _mm_xor_si128(row[0], row[4]));
+        h1 = _mm_xor_si128(h1, _mm_xor_si128(row[1], row[5]));
+        h2 = _mm_xor_si128(h2, _mm_xor_si128(row[2], row[6]));
+        h3 = _mm_xor_si128(h3, _mm_xor_si128(row[3], row[7]));
+    }
+
+    _mm_storeu_si128((__m128i *)&h[0], h0);
+    _mm_storeu_si128((__m128i *)&h[2], h1);
+    _mm_storeu_si128((__m128i *)&h[4], h2);
+    _mm_storeu_si128((__m128i *)&h[6], h3);
+}
+
+__attribute__((target("avx2")))
+static GASH_ALWAYS_INLINE __m256i rotr64x4 (__m256i x, int n)
+{
+    if (n == 32)
+        return _mm256_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1));
+    if (n == 24)
+        return _mm256_shuffle_epi8(x, _mm256_setr_epi8(
+                   3,  4,  5,  6,  7,  0,  1,  2, 11, 12, 13, 14, 15,  8,  9, 10,
+                   3,  4,  5,  6,  7,  0,  1,  2, 11, 12, 13, 14, 15,  8,  9, 10));
+    if (n == 16)
+        return _mm256_shuffle_epi8(x, _mm256_setr_epi8(
+                   2,  3,  4,  5,  6,  7,  0,  1, 10, 11, 12, 13, 14, 15,  8,  9,
+                   2,  3,  4,  5,  6,  7,  0,  1, 10, 11, 12, 13, 14, 15,  8,  9));
+    if (n == 63)
+        return _mm256_or_si256(_mm256_srli_epi64(x, 63), _mm256_add_epi64(x, x));
+
+    return _mm256_or_si256(_mm256_srli_epi64(x, n),
+                           _mm256_slli_epi64(x, 64 - n));
+}
+
+/** The four G functions of a column (or diagonal) step with one row per
+ *  YMM register.
+*/
+__attribute__((target("avx2")))
+static GASH_ALWAYS_INLINE void
+blake2bStep4 (__m256i row[4], const uint64_t m[16], const uint8_t *s)
+{
+    __m256i x = _mm256_set_epi64x((long long)m[s[6]], (long long)m[s[4]],
+                                  (long long)m[s[2]], (long long)m[s[0]]),
+            y = _mm256_set_epi64x((long long)m[s[7]], (long long)m[s[5]],
+                                  (long long)m[s[3]], (long long)m[s[1]]);
+
+    row[0] = _mm256_add_epi64(_mm256_add_epi64(row[0], row[1]), x);
+    row[3] = rotr64x4(_mm256_xor_si256(row[3], row[0]), 32);
+    row[2] = _mm256_add_epi64(row[2], row[3]);
+    row[1] = rotr64x4(_mm256_xor_si256(row[1], row[2]), 24);
+    row[0] = _mm256_add_epi64(_mm256_add_epi64(row[0], row[1]), y);
+    row[3] = rotr64x4(_mm256_xor_si256(row[3], row[0]), 16);
+    row[2] = _mm256_add_epi64(row[2], row[3]);
+    row[1] = rotr64x4(_mm256_xor_si256(row[1], row[2]), 63);
+}
+
+/** The AVX2 kernel.  */
+__attribute__((target("avx2")))
+static void blake2bCompressAVX2 (uint64_t h[8], const byte_t *blocks,
+                                 uint64_t count, uint64_t stride,
+                                 uint64_t counter, uint32_t flags)
+{
+    const __m256i iv0 = _mm256_loadu_si256((const __m256i *)&IV2B[0]),
+                  iv1 = _mm256_loadu_si256((const __m256i *)&IV2B[4]);
+
+    const __m256i final = _mm256_set_epi64x(
+                              (flags & LAST_NODE) ? -1LL : 0LL,
+                              (flags & FINAL_BLOCK) ? -1LL : 0LL, 0, 0);
+
+    __m256i h0 = _mm256_loadu_si256((const __m256i *)&h[0]),
+            h1 = _mm256_loadu_si256((const __m256i *)&h[4]);
+
+    uint64_t m[16];
+    __m256i row[4];
+
+    for (; count > 0; --count, blocks += stride,
+                      counter += BLAKE2b::BLOCK_BYTES)
+    {
+        memcpy(m, blocks, sizeof(m));
+
+        row[0] = h0;
+        row[1] = h1;
+        row[2] = iv0;
+        row[3] = _mm256_xor_si256(iv1, _mm256_xor_si256(final,
+                     _mm256_set_epi64x(0, 0, 0, (long long)counter)));
+
+        for (uint32_t r = 0; r < 12; ++r)
+        {
+            const uint8_t *s = SIGMA[r % 10];
+
+            blake2bStep4(row, m, s);
+
+            row[1] = _mm256_permute4x64_epi64(row[1], _MM_SHUFFLE(0, 3, 2, 1));
+            row[2] = _mm256_permute4x64_epi64(row[2], _MM_SHUFFLE(1, 0, 3, 2));
+            row[3] = _mm256_permute4x64_epi64(row[3], _MM_SHUFFLE(2, 1, 0, 3));
+
+            blake2bStep4(row, m, s + 8);
+
+            row[1] = _mm256_permute4x64_epi64(row[1], _MM_SHUFFLE(2, 1, 0, 3));
+            row[2] = _mm256_permute4x64_epi64(row[2], _MM_SHUFFLE(1, 0, 3, 2));
+            row[3] = _mm256_permute4x64_epi64(row[3], _MM_SHUFFLE(0, 3, 2, 1));
+        }
+
+        h0 = _mm256_xor_si256(h0, _mm256_xor_si256(row[0], row[2]));
+        h1 = _mm256_xor_si256(h1, _mm256_xor_si256(row[1], row[3]));
+    }
+
+    _mm256_storeu_si256((__m256i *)&h[0], h0);
+    _mm256_storeu_si256((__m256i *)&h[4], h1);
+}
+
+/** The mixing function on four independent states.  */
+__attribute__((target("avx2")))
+static GASH_ALWAYS_INLINE void
+blake2bG4 (__m256i v[16], uint32_t a, uint32_t b, uint32_t c, uint32_t d,
+           __m256i x, __m256i y)
+{
+    v[a] = _mm256_add_epi64(_mm256_add_epi64(v[a], v[b]), x);
+    v[d] = rotr64x4(_mm256_xor_si256(v[d], v[a]), 32);
+    v[c] = _mm256_add_epi64(v[c], v[d]);
+    v[b] = rotr64x4(_mm256_xor_si256(v[b], v[c]), 24);
+    v[a] = _mm256_add_epi64(_mm256_add_epi64(v[a], v[b]), y);
+    v[d] = rotr64x4(_mm256_xor_si256(v[d], v[a]), 16);
+    v[c] = _mm256_add_epi64(v[c], v[d]);
+    v[b] = rotr64x4(_mm256_xor_si256(v[b], v[c]), 63);
+}
+
+/** Transpose a 4x4 matrix of 64-bit words.  */
+__attribute__((target("avx2")))
+static GASH_ALWAYS_INLINE void transpose4x4 (__m256i x[4])
+{
+    __m256i t0 = _mm256_unpacklo_epi64(x[0], x[1]),
+            t1 = _mm256_unpackhi_epi64(x[0], x[1]),
+            t2 = _mm256_unpacklo_epi64(x[2], x[3]),
+            t3 = _mm256_unpackhi_epi64(x[2], x[3]);
+
+    x[0] = _mm256_permute2x128_si256(t0, t2, 0x20);
+    x[1] = _mm256_permute2x128_si256(t1, t3, 0x20);
+    x[2] = _mm256_permute2x128_si256(t0, t2, 0x31);
+    x[3] = _mm256_permute2x128_si256(t1, t3, 0x31);
+}
+
+/** The AVX2 leaves kernel: word i of every leaf's state shares vector i
+ *  (one leaf per 64-bit lane), so no rows have to be rotated.
+*/
+__attribute__((target("avx2")))
+static void blake2bLeavesAVX2 (uint64_t leaves[4][8],
+                               const byte_t *superblocks, uint64_t count,
+                               uint64_t counter)
+{
+    __m256i h[8], m[16], v[16];
+
+    for (uint32_t i = 0; i < 8; ++i)
+        h[i] = _mm256_set_epi64x((long long)leaves[3][i],
+                                 (long long)leaves[2][i],
+                                 (long long)leaves[1][i],
+                                 (long long)leaves[0][i]);
+
+    for (; count > 0; --count, superblocks += 4 * BLAKE2b::BLOCK_BYTES,
+                      counter += BLAKE2b::BLOCK_BYTES)
+    {
+        // Row j of each 4x4 tile is four message words of leaf j.
+        for (uint32_t q = 0; q < 4; ++q)
+        {
+            for (uint32_t j = 0; j < 4; ++j)
+                m[(q * 4) + j] = _mm256_loadu_si256((const __m256i *)
+                    (superblocks + (j * BLAKE2b::BLOCK_BYTES) + (q * 32)));
+
+            transpose4x4(m + (q * 4));
+        }
+
+        for (uint32_t i = 0; i < 8; ++i)
+        {
+            v[i] = h[i];
+            v[i + 8] = _mm256_set1_epi64x((long long)IV2B[i]);
+        }
+
+        v[12] = _mm256_set1_epi64x((long long)(IV2B[4] ^ counter));
+
+        for (uint32_t r = 0; r < 12; ++r)
+        {
+            const uint8_t *s = SIGMA[r % 10];
+
+            blake2bG4(v, 0, 4,  8, 12, m[s[ 0]], m[s[ 1]]);
+            blake2bG4(v, 1, 5,  9, 13, m[s[ 2]], m[s[ 3]]);
+            blake2bG4(v, 2, 6, 10, 14, m[s[ 4]], m[s[ 5]]);
+            blake2bG4(v, 3, 7, 11, 15, m[s[ 6]], m[s[ 7]]);
+
+            blake2bG4(v, 0, 5, 10, 15, m[s[ 8]], m[s[ 9]]);
+            blake2bG4(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+            blake2bG4(v, 2, 7,  8, 13, m[s[12]], m[s[13]]);
+            blake2bG4(v, 3, 4,  9, 14, m[s[14]], m[s[15]]);
+        }
+
+        for (uint32_t i = 0; i < 8; ++i)
+            h[i] = _mm256_xor_si256(h[i], _mm256_xor_si256(v[i], v[i + 8]));
+    }
+
+    uint64_t lanes[4];
+
+    for (uint32_t i = 0; i < 8; ++i)
+    {
+        _mm256_storeu_si256((__m256i *)lanes, h[i]);
+
+        for (uint32_t j = 0; j < 4; ++j)
+            leaves[j][i] = lanes[j];
+    }
+}
+
+#endif  // GASH_X86_SIMD
+
+/** Choose the fastest kernel that the host supports.  */
+static Blake2bKernel selectBlake2bKernel (void)
+{
+#ifdef GASH_X86_SIMD
+    if (CPUFeatures::has(CPUFeatures::AVX2))
+        return blake2bCompressAVX2;
+
+    if (CPUFeatures::has(CPUFeatures::SSE41))
+        return blake2bCompressSSE41;
+#endif
+
+    return blake2bCompressPortable;
+}
+
+/** Choose a leaves kernel; NULL when the leaves are to be compressed
+ *  one at a time.
+*/
+static Blake2bLeavesKernel selectBlake2bLeavesKernel (void)
+{
+#ifdef GASH_X86_SIMD
+    if (CPUFeatures::has(CPUFeatures::AVX2))
+        return blake2bLeavesAVX2;
+#endif
+
+    return NULL;
+}
+
+static Blake2bKernel blake2bKernel (void)
+{
+    static const Blake2bKernel kernel = selectBlake2bKernel();
+    return kernel;
+}
+
+/** Load the chaining values from the IV and the parameter block.  */
+static void blake2bInitialize (uint64_t h[8], uint32_t digestBytes,
+                               uint32_t keyBytes, uint32_t fanout,
+                               uint32_t depth, uint64_t nodeOffset,
+                               uint32_t nodeDepth, uint32_t innerBytes)
+{
+    // The leaf length, salt and personalization are always zero.
+    uint64_t param[8] =
+    {
+          (uint64_t)digestBytes | ((uint64_t)keyBytes << 8)
+        | ((uint64_t)fanout << 16) | ((uint64_t)depth << 24),
+        nodeOffset,
+        (uint64_t)nodeDepth | ((uint64_t)innerBytes << 8),
+        0, 0, 0, 0, 0
+    };
+
+    for (uint32_t i = 0; i < 8; ++i)
+        h[i] = IV2B[i] ^ param[i];
+}
+
+/** Serialize the chaining values (little endian).  */
+static void blake2bDigest (const uint64_t h[8], byte_t digest[64])
+{
+    for (uint32_t i = 0; i < 8; ++i)
+        storeLittleEndian64(digest + (i * 8), h[i]);
+}
+
+/** One thread's share of the BLAKE2bp leaves.  */
+struct Blake2bLeafJob
+{
+    uint64_t (*leaves)[8];
+    uint32_t first;        // The first leaf of the share ...
+    uint32_t step;         // ... and the distance to the next.
+    const byte_t *superblocks;
+    uint64_t count;
+    uint64_t counter;
+};
+
+static void * blake2bLeafThread (void *arg)
+{
+    Blake2bLeafJob *job = (Blake2bLeafJob *)arg;
+
+    for (uint32_t i = job->first; i < BLAKE2bp::LEAVES; i += job->step)
+        blake2bKernel()(job->leaves[i],
+                        job->superblocks + (i * BLAKE2b::BLOCK_BYTES),
+                        job->count, BLAKE2bp::LEAVES * BLAKE2b::BLOCK_BYTES,
+                        job->counter, 0);
+
+    return NULL;
+}
+
+/******************************************************
+**            Constructors / Destructors             **
+******************************************************/
+
+/** Default constructor (BLAKE2b-512).  */
+BLAKE2b::BLAKE2b ()
+    : MessageHash(512),
+      _keyBytes(0),
+      _lastNode(false),
+      _fileBufferBytes(FILE_BUFFER_BYTES)
+{
+    memset(_key, 0, sizeof(_key));
+    _setTreeParameters(1, 1, 0, 0);
+    reset();
+}
+
+/** Initialize a BLAKE2b object with a shorter digest.
+ *
+ *  @pre bits is a multiple of 32 between 32 and 512.
+ *  @post The object produces a digest of the given length (which
+ *        is a parameter of the hash, not a truncation).
+ *  @param bits The number of bits in the hash.
+*/
+BLAKE2b::BLAKE2b (uint32_t bits)
+    : MessageHash(bits),
+      _keyBytes(0),
+      _lastNode(false),
+      _fileBufferBytes(FILE_BUFFER_BYTES)
+{
+    memset(_key, 0, sizeof(_key));
+    _setTreeParameters(1, 1, 0, 0);
+    reset();
+}
+
+/** Copy constructor.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated from the copied BLAKE2b object
+ *        including any partially processed message.
+ *  @param copyFrom The BLAKE2b object whose values are to be copied.
+*/
+BLAKE2b::BLAKE2b (const BLAKE2b &copyFrom)
+    : MessageHash(copyFrom)
+{
+    *this = copyFrom;
+}
+
+/** Initialize a BLAKE2b object by hashing an input std::string.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated containing the
+ *        hashed value of the input data.
+ *  @param str The std::string that is to be hashed.
+*/
+BLAKE2b::BLAKE2b (const string &str)
+    : MessageHash(512),
+      _keyBytes(0),
+      _lastNode(false),
+      _fileBufferBytes(FILE_BUFFER_BYTES)
+{
+    memset(_key, 0, sizeof(_key));
+    _setTreeParameters(1, 1, 0, 0);
+    calculateHash(str);
+}
+
+/** Initialize a BLAKE2b object by hashing an input data stream.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated containing the
+ *        hashed value of the input data.
+ *  @param data The data that is to be hashed.
+*/
+BLAKE2b::BLAKE2b (const vector < byte_t > &data)
+    : MessageHash(512),
+      _keyBytes(0),
+      _lastNode(false),
+      _fileBufferBytes(FILE_BUFFER_BYTES)
+{
+    memset(_key, 0, sizeof(_key));
+    _setTreeParameters(1, 1, 0, 0);
+    calculateHash(data);
+}
+
+/** Initialize a BLAKE2b object by hashing an input file stream.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated containing the
+ *        hashed value of the input data.
+ *  @param file A handle to the file that is to be hashed.
+*/
+BLAKE2b::BLAKE2b (ifstream &file)
+    : MessageHash(512),
+      _keyBytes(0),
+      _lastNode(false),
+      _fileBufferBytes(FILE_BUFFER_BYTES)
+{
+    memset(_key, 0, sizeof(_key));
+    _setTreeParameters(1, 1, 0, 0);
+    calculateHash(file);
+}
+
+/** Default destructor.  */
+BLAKE2b::~BLAKE2b ()  { }
+
+/******************************************************
+**               Accessors / Mutators                **
+******************************************************/
+
+////////////////////
+//    Getters
+////////////////////
+
+/** Retrieve the name of the algorithm.
+ *
+ *  @pre The object is instantiated.
+ *  @post none.
+ *  @return "BLAKE2b-" followed by the digest length in bits.
+*/
+string BLAKE2b::algorithmName (void) const
+{
+    stringstream ss;
+    ss << "BLAKE2b-" << (_hash.size() * 32);
+
+    return ss.str();
+}
+
+/** Retrieve the name of the kernel that the host selected.
+ *
+ *  @pre The object is instantiated.
+ *  @post none.
+ *  @return "AVX2", "SSE4.1" or "portable".
+*/
+string BLAKE2b::kernelName (void) const
+{
+#ifdef GASH_X86_SIMD
+    Blake2bKernel kernel = blake2bKernel();
+
+    if (kernel == blake2bCompressAVX2)
+        return "AVX2";
+
+    if (kernel == blake2bCompressSSE41)
+        return "SSE4.1";
+#endif
+
+    return "portable";
+}
+
+/** Copy the object, including any partially processed message.
+ *
+ *  @pre none.
+ *  @post The caller owns (and must delete) the copy.
+ *  @return A new BLAKE2b object in the same state.
+*/
+BLAKE2b * BLAKE2b::clone (void) const
+{
+    return new BLAKE2b(*this);
+}
+
+////////////////////
+//    Setters
+////////////////////
+
+/** Calculate the hash from an input std::string.
+ *
+ *  @pre The object is instantiated.
+ *  @post The computed hash is stored in the _hash values.
+ *  @param str The string whose value is to be hashed.
+ *  @return The hash as a std::string.
+*/
+string BLAKE2b::calculateHash (const string &str)
+{
+    reset();
+    update((const byte_t *)str.data(), str.size());
+
+    return finalize();
+}
+
+/** Calculate the hash from an input data stream.
+ *
+ *  @pre The object is instantiated.
+ *  @post The computed hash is stored in the _hash values.
+ *  @param data The data that is to be hashed.
+ *  @return The hash as a std::string.
+*/
+string BLAKE2b::calculateHash (const vector < byte_t > &data)
+{
+    reset();
+    update(data);
+
+    return finalize();
+}
+
+/** Calculate the hash of a file.
+ *
+ *  @pre The object is instantiated.
+ *  @post The computed hash is stored in the _hash values.
+ *  @param file The file whose hash value is to be calculated.
+ *  @return The hash as a std::string.
+*/
+string BLAKE2b::calculateHash (ifstream &file)
+{
+    reset();
+
+    // Check that the file is valid before doing anything else.
+    // This will return a hash value of all zeros.
+    if (file.fail() || !file.good())
+    {
+        _hash.assign(_hash.size(), 0x00000000);
+        return asString();
+    }
+
+    // Size the buffer to the file so that small files do not pay for
+    // a large read buffer.
+    file.seekg(0, ios::end);
+    uint64_t fileSize = (uint64_t)file.tellg();
+    file.seekg(0, ios::beg);
+
+    uint64_t bufferSize = _fileBufferBytes;
+    if (fileSize < bufferSize)
+        bufferSize = fileSize + 1;
+
+    vector < byte_t > buffer((size_t)bufferSize);
+
+    while (file.good())
+    {
+        file.read((char *)&buffer[0], buffer.size());
+        update(&buffer[0], (uint64_t)file.gcount());
+    }
+
+    // Reset the file flags and return to the file head.
+    file.clear();
+    file.seekg(0);  // Return to the head of the file.
+
+    return finalize();
+}
+
+/** Switch to the keyed hash (MAC) mode.
+ *
+ *  @pre length is no more than MAX_KEY_BYTES.
+ *  @post Any message data is discarded and later hashes are
+ *        keyed with the given key; a zero length removes the key.
+ *  @param key A pointer to the key.
+ *  @param length The number of bytes in the key.
+ *  @return none.
+*/
+void BLAKE2b::setKey (const byte_t *key, uint32_t length)
+{
+    if (length > MAX_KEY_BYTES)
+        length = MAX_KEY_BYTES;
+
+    memset(_key, 0, sizeof(_key));
+    memcpy(_key, key, length);
+    _keyBytes = length;
+
+    reset();
+
+    return;
+}
+
+/** Discard any message data and restart the hash.
+ *
+ *  @pre The object is instantiated.
+ *  @post The chaining values hold their initial values.
+ *  @return none.
+*/
+void BLAKE2b::reset (void)
+{
+    blake2bInitialize(_h, (uint32_t)_hash.size() * 4, _keyBytes, _fanout,
+                      _depth, 0, _nodeDepth, _innerBytes);
+
+    _counter = 0;
+    memset(_block, 0, sizeof(_block));
+    _pending = 0;
+
+    // A key is hashed as a zero padded first block.
+    if (_keyBytes > 0)
+    {
+        memcpy(_block, _key, _keyBytes);
+        _pending = BLOCK_BYTES;
+    }
+
+    return;
+}
+
+/** Append message data to the hash.
+ *
+ *  @pre reset() has been called since the last finalize().
+ *  @post All but the last block of the data seen so far have
+ *        been compressed.
+ *  @param data A pointer to the message data.
+ *  @param length The number of bytes at data.
+ *  @return none.
+*/
+void BLAKE2b::update (const byte_t *data, uint64_t length)
+{
+    // The last block is compressed differently, so a block is only
+    // compressed once there is data after it.
+    if (_pending + length <= BLOCK_BYTES)
+    {
+        memcpy(_block + _pending, data, (size_t)length);
+        _pending += (uint32_t)length;
+
+        return;
+    }
+
+    if (_pending > 0)
+    {
+        uint32_t fill = BLOCK_BYTES - _pending;
+
+        memcpy(_block + _pending, data, fill);
+        data += fill;
+        length -= fill;
+
+        _counter += BLOCK_BYTES;
+        blake2bKernel()(_h, _block, 1, BLOCK_BYTES, _counter, 0);
+        _pending = 0;
+    }
+
+    uint64_t blocks = (length - 1) / BLOCK_BYTES;
+    if (blocks > 0)
+    {
+        blake2bKernel()(_h, data, blocks, BLOCK_BYTES,
+                        _counter + BLOCK_BYTES, 0);
+
+        _counter += blocks * BLOCK_BYTES;
+        data += blocks * BLOCK_BYTES;
+        length -= blocks * BLOCK_BYTES;
+    }
+
+    memcpy(_block, data, (size_t)length);
+    _pending = (uint32_t)length;
+
+    return;
+}
+
+/** Append message data to the hash.
+ *
+ *  @pre reset() has been called since the last finalize().
+ *  @post The message data has been absorbed.
+ *  @param data The message data.
+ *  @return none.
+*/
+void BLAKE2b::update (const vector < byte_t > &data)
+{
+    if (!data.empty())
+        update(&data[0], data.size());
+
+    return;
+}
+
+/** Compress the final block and produce the hash.
+ *
+ *  @pre reset() has been called since the last finalize().
+ *  @post The computed hash is stored in the _hash values.
+ *  @return The hash as a std::string.
+*/
+string BLAKE2b::finalize (void)
+{
+    memset(_block + _pending, 0, BLOCK_BYTES - _pending);
+    _counter += _pending;
+
+    blake2bKernel()(_h, _block, 1, BLOCK_BYTES, _counter,
+                    FINAL_BLOCK | (_lastNode ? LAST_NODE : 0));
+    _pending = 0;
+
+    _storeHash();
+
+    return asString();
+}
+
+/******************************************************
+**                     Operators                     **
+******************************************************/
+
+/** Assignment from another BLAKE2b object.
+ *
+ *  @pre The object is instantiated.
+ *  @post The object contains the values copied from rhs.
+ *  @param rhs The BLAKE2b object whose values are to be copied/stored.
+ *  @return A reference to the object.
+*/
+BLAKE2b & BLAKE2b::operator = (const BLAKE2b &rhs)
+{
+    if (this != &rhs)
+    {
+        MessageHash::operator = (rhs);
+
+        memcpy(_h, rhs._h, sizeof(_h));
+        _counter = rhs._counter;
+        memcpy(_block, rhs._block, sizeof(_block));
+        _pending = rhs._pending;
+
+        memcpy(_key, rhs._key, sizeof(_key));
+        _keyBytes = rhs._keyBytes;
+
+        _fanout = rhs._fanout;
+        _depth = rhs._depth;
+        _nodeDepth = rhs._nodeDepth;
+        _innerBytes = rhs._innerBytes;
+        _lastNode = rhs._lastNode;
+
+        _fileBufferBytes = rhs._fileBufferBytes;
+    }
+
+    return *this;
+}
+
+/******************************************************
+**                   Helper Methods                  **
+******************************************************/
+
+/** Set up the object as a node of a hash tree.
+ *
+ *  @pre none.
+ *  @post The parameter block describes the given tree node.
+ *  @param fanout The number of children of each node.
+ *  @param depth The number of levels in the tree.
+ *  @param nodeDepth The level of this node (zero for leaves).
+ *  @param innerBytes The digest length of the inner nodes.
+ *  @return none.
+*/
+void BLAKE2b::_setTreeParameters (uint32_t fanout, uint32_t depth,
+                                  uint32_t nodeDepth, uint32_t innerBytes)
+{
+    _fanout = fanout;
+    _depth = depth;
+    _nodeDepth = nodeDepth;
+    _innerBytes = innerBytes;
+
+    return;
+}
+
+/** Copy the chaining values into the _hash words.
+ *
+ *  @pre The final block has been compressed.
+ *  @post The _hash values hold the message digest.
+ *  @return none.
+*/
+void BLAKE2b::_storeHash (void)
+{
+    byte_t digest[64];
+    blake2bDigest(_h, digest);
+
+    // The digest is printed a word at a time, most significant byte
+    // first, so the byte string is packed big endian.
+    for (uint32_t i = 0; i < _hash.size(); ++i)
+        _hash.at(i) =   ((uint32_t)digest[(i * 4)    ] << 24)
+                      | ((uint32_t)digest[(i * 4) + 1] << 16)
+                      | ((uint32_t)digest[(i * 4) + 2] <<  8)
+                      | ((uint32_t)digest[(i * 4) + 3]      );
+
+    return;
+}
+
+/** Append the algorithm specific part of the midstate.
+ *
+ *  @pre none.
+ *  @post The state is appended to state.
+ *  @param state The state that is being exported.
+ *  @return none.
+*/
+void BLAKE2b::_saveState (HashState &state) const
+{
+    state.putWords64(_h, 8);
+    state.putWord64(_counter);
+    state.putWord32(_pending);
+    state.putBytes(_block, BLOCK_BYTES);
+
+    // The key is part of the state: a keyed hash restarts with it.
+    state.putWord32(_keyBytes);
+    state.putBytes(_key, MAX_KEY_BYTES);
+
+    state.putWord32(_fanout);
+    state.putWord32(_depth);
+    state.putWord32(_nodeDepth);
+    state.putWord32(_innerBytes);
+    state.putWord32(_lastNode ? 1 : 0);
+
+    return;
+}
+
+/** Restore the algorithm specific part of the midstate.
+ *
+ *  @pre The common header of state has been read and checked.
+ *  @post The object holds the imported state.
+ *  @param state The state that is being imported.
+ *  @return true The values read are consistent.
+ *  @return false The state is corrupt.
+*/
+bool BLAKE2b::_loadState (HashState &state)
+{
+    uint64_t h[8];
+    byte_t block[BLOCK_BYTES],
+           key[MAX_KEY_BYTES];
+
+    state.getWords64(h, 8);
+    uint64_t counter = state.getWord64();
+    uint32_t pending = state.getWord32();
+    state.getBytes(block, BLOCK_BYTES);
+
+    uint32_t keyBytes = state.getWord32();
+    state.getBytes(key, MAX_KEY_BYTES);
+
+    // The tree parameters are fixed by the type of the object, so a state
+    // of another node (or of the parallel variant) is refused.
+    bool sameNode = (state.getWord32() == _fanout)
+                    && (state.getWord32() == _depth)
+                    && (state.getWord32() == _nodeDepth)
+                    && (state.getWord32() == _innerBytes)
+                    && (state.getWord32() == (_lastNode ? 1u : 0u));
+
+    // Nothing is taken from a corrupt state: the reset() that follows
+    // copies _keyBytes bytes of the key.
+    if (!sameNode || (pending > BLOCK_BYTES) || (keyBytes > MAX_KEY_BYTES))
+        return false;
+
+    memcpy(_h, h, sizeof(_h));
+    _counter = counter;
+    _pending = pending;
+    memcpy(_block, block, sizeof(_block));
+    _keyBytes = keyBytes;
+    memcpy(_key, key, sizeof(_key));
+
+    return true;
+}
+
+/******************************************************
+**                      BLAKE2bp                     **
+******************************************************/
+
+/** Default constructor.  */
+BLAKE2bp::BLAKE2bp ()
+    : BLAKE2b(512)
+{
+    _setTreeParameters(LEAVES, 2, 1, MAX_DIGEST_BYTES);
+    _lastNode = true;
+    _fileBufferBytes = PARALLEL_BUFFER_BYTES;
+
+    setThreads(0);
+    reset();
+}
+
+/** Copy constructor.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated from the copied BLAKE2bp object
+ *        including any partially processed message.
+ *  @param copyFrom The BLAKE2bp object whose values are to be copied.
+*/
+BLAKE2bp::BLAKE2bp (const BLAKE2bp &copyFrom)
+    : BLAKE2b(copyFrom)
+{
+    *this = copyFrom;
+}
+
+/** Initialize a BLAKE2bp object by hashing an input std::string.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated containing the
+ *        hashed value of the input data.
+ *  @param str The std::string that is to be hashed.
+*/
+BLAKE2bp::BLAKE2bp (const string &str)
+    : BLAKE2b(512)
+{
+    _setTreeParameters(LEAVES, 2, 1, MAX_DIGEST_BYTES);
+    _lastNode = true;
+    _fileBufferBytes = PARALLEL_BUFFER_BYTES;
+
+    setThreads(0);
+    calculateHash(str);
+}
+
+/** Initialize a BLAKE2bp object by hashing an input data stream.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated containing the
+ *        hashed value of the input data.
+ *  @param data The data that is to be hashed.
+*/
+BLAKE2bp::BLAKE2bp (const vector < byte_t > &data)
+    : BLAKE2b(512)
+{
+    _setTreeParameters(LEAVES, 2, 1, MAX_DIGEST_BYTES);
+    _lastNode = true;
+    _fileBufferBytes = PARALLEL_BUFFER_BYTES;
+
+    setThreads(0);
+    calculateHash(data);
+}
+
+/** Initialize a BLAKE2bp object by hashing an input file stream.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated containing the
+ *        hashed value of the input data.
+ *  @param file A handle to the file that is to be hashed.
+*/
+BLAKE2bp::BLAKE2bp (ifstream &file)
+    : BLAKE2b(512)
+{
+    _setTreeParameters(LEAVES, 2, 1, MAX_DIGEST_BYTES);
+    _lastNode = true;
+    _fileBufferBytes = PARALLEL_BUFFER_BYTES;
+
+    setThreads(0);
+    calculateHash(file);
+}
+
+/** Default destructor.  */
+BLAKE2bp::~BLAKE2bp ()  { }
+
+/** Retrieve the name of the algorithm.
+ *
+ *  @pre The object is instantiated.
+ *  @post none.
+ *  @return "BLAKE2bp".
+*/
+string BLAKE2bp::algorithmName (void) const
+{
+    return "BLAKE2bp";
+}
+
+/** Retrieve the name of the kernel that the host selected.
+ *
+ *  @pre The object is instantiated.
+ *  @post none.
+ *  @return "AVX2 leaves" where the four leaves are compressed together,
+ *          otherwise the kernel of BLAKE2b.
+*/
+string BLAKE2bp::kernelName (void) const
+{
+    if (selectBlake2bLeavesKernel() != NULL)
+        return "AVX2 leaves";
+
+    return BLAKE2b::kernelName();
+}
+
+/** Copy the object, including any partially processed message.
+ *
+ *  @pre none.
+ *  @post The caller owns (and must delete) the copy.
+ *  @return A new BLAKE2bp object in the same state.
+*/
+BLAKE2bp * BLAKE2bp::clone (void) const
+{
+    return new BLAKE2bp(*this);
+}
+
+/** Set the number of threads used to hash large inputs.
+ *
+ *  @pre The object is instantiated.
+ *  @post The leaves of later update() calls are spread over
+ *        at most the given number of threads.
+ *  @param threads The thread limit; zero selects one thread for
+ *         each online processor.
+ *  @return none.
+*/
+void BLAKE2bp::setThreads (uint32_t threads)
+{
+    if (threads == 0)
+    {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (online > 0) ? (uint32_t)online : 1;
+    }
+
+    _threads = threads;
+
+    return;
+}
+
+/** Discard any message data and restart the hash.
+ *
+ *  @pre The object is instantiated.
+ *  @post The leaves and the root hold their initial values.
+ *  @return none.
+*/
+void BLAKE2bp::reset (void)
+{
+    BLAKE2b::reset();
+
+    // The root only takes the key length as a parameter; the key block
+    // is hashed by each of the leaves instead.
+    memset(_block, 0, sizeof(_block));
+    _pending = 0;
+
+    for (uint32_t i = 0; i < LEAVES; ++i)
+        blake2bInitialize(_leaves[i], MAX_DIGEST_BYTES, _keyBytes, LEAVES, 2,
+                          i, 0, MAX_DIGEST_BYTES);
+
+    _leafBytes = 0;
+    _keyPending = (_keyBytes > 0);
+    _buffered = 0;
+
+    return;
+}
+
+/** Append message data to the hash.
+ *
+ *  @pre reset() has been called since the last finalize().
+ *  @post Each leaf has compressed every block of the data seen so
+ *        far except the blocks that might still be its last.
+ *  @param data A pointer to the message data.
+ *  @param length The number of bytes at data.
+ *  @return none.
+*/
+void BLAKE2bp::update (const byte_t *data, uint64_t length)
+{
+    uint64_t total = _buffered + length;
+
+    if (total <= HOLD_BYTES)
+    {
+        memcpy(_buffer + _buffered, data, (size_t)length);
+        _buffered += (uint32_t)length;
+
+        return;
+    }
+
+    // The number of superblocks that leave no more than HOLD_BYTES.
+    uint64_t ready = (total - HOLD_BYTES + SUPERBLOCK_BYTES - 1)
+                     / SUPERBLOCK_BYTES;
+
+    // Superblocks that start in the buffer are completed from the data.
+    while ((ready > 0) && (_buffered > 0))
+    {
+        if (_buffered < SUPERBLOCK_BYTES)
+        {
+            uint32_t fill = SUPERBLOCK_BYTES - _buffered;
+
+            memcpy(_buffer + _buffered, data, fill);
+            data += fill;
+            length -= fill;
+            _buffered = SUPERBLOCK_BYTES;
+        }
+
+        _compressLeaves(_buffer, 1);
+
+        _buffered -= SUPERBLOCK_BYTES;
+        memmove(_buffer, _buffer + SUPERBLOCK_BYTES, _buffered);
+        --ready;
+    }
+
+    // The rest are compressed straight from the caller's buffer.
+    if (ready > 0)
+    {
+        _compressLeaves(data, ready);
+        data += ready * SUPERBLOCK_BYTES;
+        length -= ready * SUPERBLOCK_BYTES;
+    }
+
+    memcpy(_buffer + _buffered, data, (size_t)length);
+    _buffered += (uint32_t)length;
+
+    return;
+}
+
+/** Finish the leaves, hash their digests in the root and produce
+ *  the hash.
+ *
+ *  @pre reset() has been called since the last finalize().
+ *  @post The computed hash is stored in the _hash values.
+ *  @return The hash as a std::string.
+*/
+string BLAKE2bp::finalize (void)
+{
+    byte_t keyBlock[BLOCK_BYTES], tail[BLOCK_BYTES];
+    byte_t digests[LEAVES][MAX_DIGEST_BYTES];
+
+    memset(keyBlock, 0, sizeof(keyBlock));
+    memcpy(keyBlock, _key, _keyBytes);
+
+    for (uint32_t i = 0; i < LEAVES; ++i)
+    {
+        uint64_t *h = _leaves[i];
+        uint64_t bytes = _leafBytes;
+        uint32_t finalFlags = FINAL_BLOCK
+                              | ((i == LEAVES - 1) ? LAST_NODE : 0);
+
+        // Leaf i's remaining blocks start at i * BLOCK_BYTES and then
+        // every SUPERBLOCK_BYTES; the key block comes before them.
+        uint32_t offset = i * BLOCK_BYTES;
+        bool hasData = (_buffered > offset);
+
+        if (_keyPending)
+        {
+            bytes += BLOCK_BYTES;
+            blake2bKernel()(h, keyBlock, 1, BLOCK_BYTES, bytes,
+                            hasData ? 0 : finalFlags);
+        }
+        else if (!hasData)
+        {
+            // An empty leaf compresses one zero block.
+            memset(tail, 0, sizeof(tail));
+            blake2bKernel()(h, tail, 1, BLOCK_BYTES, bytes, finalFlags);
+        }
+
+        for (; hasData; offset += SUPERBLOCK_BYTES)
+        {
+            if (offset + SUPERBLOCK_BYTES < _buffered)
+            {
+                bytes += BLOCK_BYTES;
+                blake2bKernel()(h, _buffer + offset, 1, BLOCK_BYTES, bytes, 0);
+                continue;
+            }
+
+            uint32_t length = _buffered - offset;
+            if (length > BLOCK_BYTES)
+                length = BLOCK_BYTES;
+
+            memset(tail, 0, sizeof(tail));
+            memcpy(tail, _buffer + offset, length);
+            bytes += length;
+            blake2bKernel()(h, tail, 1, BLOCK_BYTES, bytes, finalFlags);
+
+            break;
+        }
+
+        blake2bDigest(h, digests[i]);
+    }
+
+    BLAKE2b::update(&digests[0][0], sizeof(digests));
+
+    return BLAKE2b::finalize();
+}
+
+/** Assignment from another BLAKE2bp object.
+ *
+ *  @pre The object is instantiated.
+ *  @post The object contains the values copied from rhs.
+ *  @param rhs The BLAKE2bp object whose values are to be copied/stored.
+ *  @return A reference to the object.
+*/
+BLAKE2bp & BLAKE2bp::operator = (const BLAKE2bp &rhs)
+{
+    if (this != &rhs)
+    {
+        BLAKE2b::operator = (rhs);
+
+        memcpy(_leaves, rhs._leaves, sizeof(_leaves));
+        _leafBytes = rhs._leafBytes;
+        _keyPending = rhs._keyPending;
+        memcpy(_buffer, rhs._buffer, sizeof(_buffer));
+        _buffered = rhs._buffered;
+        _threads = rhs._threads;
+    }
+
+    return *this;
+}
+
+/** Compress whole superblocks into the leaves.
+ *
+ *  @pre Every leaf has at least one more block after them.
+ *  @post Each leaf has compressed its block of each superblock.
+ *  @param superblocks A pointer to the first superblock.
+ *  @param count The number of consecutive superblocks.
+ *  @return none.
+*/
+void BLAKE2bp::_compressLeaves (const byte_t *superblocks, uint64_t count)
+{
+    static const Blake2bLeavesKernel leavesKernel =
+                                     selectBlake2bLeavesKernel();
+
+    // The key blocks can go now that each leaf has data after them.
+    if (_keyPending)
+    {
+        byte_t keyBlock[BLOCK_BYTES];
+
+        memset(keyBlock, 0, sizeof(keyBlock));
+        memcpy(keyBlock, _key, _keyBytes);
+
+        for (uint32_t i = 0; i < LEAVES; ++i)
+            blake2bKernel()(_leaves[i], keyBlock, 1, BLOCK_BYTES,
+                            BLOCK_BYTES, 0);
+
+        _leafBytes = BLOCK_BYTES;
+        _keyPending = false;
+    }
+
+    uint64_t counter = _leafBytes + BLOCK_BYTES;
+    uint32_t threads = (_threads < LEAVES) ? _threads : LEAVES;
+
+    if ((threads > 1) && (count * SUPERBLOCK_BYTES >= MIN_THREAD_BYTES))
+    {
+        // Each thread takes every threads-th leaf; this thread does the
+        // first share itself.
+        Blake2bLeafJob jobs[LEAVES];
+        pthread_t workers[LEAVES];
+        bool started[LEAVES];
+
+        for (uint32_t t = 0; t < threads; ++t)
+        {
+            Blake2bLeafJob job = { _leaves, t, threads, superblocks, count,
+                                   counter };
+            jobs[t] = job;
+            started[t] = (t > 0) && (pthread_create(&workers[t], NULL,
+                                         blake2bLeafThread, &jobs[t]) == 0);
+        }
+
+        for (uint32_t t = 0; t < threads; ++t)
+        {
+            if (t == 0 || !started[t])
+                blake2bLeafThread(&jobs[t]);
+        }
+
+        for (uint32_t t = 1; t < threads; ++t)
+        {
+            if (started[t])
+                pthread_join(workers[t], NULL);
+        }
+    }
+    else if (leavesKernel != NULL)
+        leavesKernel(_leaves, superblocks, count, counter);
+    else
+    {
+        for (uint32_t i = 0; i < LEAVES; ++i)
+            blake2bKernel()(_leaves[i], superblocks + (i * BLOCK_BYTES),
+                            count, SUPERBLOCK_BYTES, counter, 0);
+    }
+
+    _leafBytes += count * BLOCK_BYTES;
+
+    return;
+}
+
+/** Append the algorithm specific part of the midstate.
+ *
+ *  @pre none.
+ *  @post The state is appended to state.
+ *  @param state The state that is being exported.
+ *  @return none.
+*/
+void BLAKE2bp::_saveState (HashState &state) const
+{
+    BLAKE2b::_saveState(state);
+
+    state.putWords64(&_leaves[0][0], LEAVES * 8);
+    state.putWord64(_leafBytes);
+    state.putWord32(_keyPending ? 1 : 0);
+    state.putWord32(_buffered);
+    state.putBytes(_buffer, _buffered);
+
+    return;
+}
+
+/** Restore the algorithm specific part of the midstate.
+ *
+ *  @pre The common header of state has been read and checked.
+ *  @post The object holds the imported state.
+ *  @param state The state that is being imported.
+ *  @return true The values read are consistent.
+ *  @return false The state is corrupt.
+*/
+bool BLAKE2bp::_loadState (HashState &state)
+{
+    // The key of the root is put back if the leaves turn out corrupt.
+    uint32_t keyBytes = _keyBytes;
+    byte_t key[MAX_KEY_BYTES];
+
+    memcpy(key, _key, sizeof(key));
+
+    if (!BLAKE2b::_loadState(state))
+        return false;
+
+    state.getWords64(&_leaves[0][0], LEAVES * 8);
+    uint64_t leafBytes = state.getWord64();
+    bool keyPending = (state.getWord32() != 0);
+    uint32_t buffered = state.getWord32();
+
+    if ((buffered > sizeof(_buffer)) || ((leafBytes % BLOCK_BYTES) != 0))
+    {
+        _keyBytes = keyBytes;
+        memcpy(_key, key, sizeof(_key));
+
+        return false;
+    }
+
+    _leafBytes = leafBytes;
+    _keyPending = keyPending;
+    _buffered = buffered;
+    state.getBytes(_buffer, _buffered);
+
+    return true;
+}
\ No newline at end of file
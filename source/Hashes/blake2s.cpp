@@ -0,0 +1,1517 @@
+/******************************************************************************
+||  blake2s.cpp                                                              ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    This abstract data type is used to calculate the BLAKE2s hash of an    ||
+||    input message or data stream, optionally keyed, and the BLAKE2sp       ||
+||    variant which splits the message over eight BLAKE2s leaves that are    ||
+||    hashed side by side (in the lanes of the AVX2 kernel or on separate    ||
+||    threads).  BLAKE2s works on 32-bit words, which suits 32-bit hosts     ||
+||    and short messages.                                                    ||
+||                                                                           ||
+||    The compression kernels are chosen at run time: an SSE4.1 kernel for   ||
+||    a single message, and an AVX2 kernel that advances all eight BLAKE2sp  ||
+||    leaves at once.                                                        ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    cpu_features.cpp (cpu_features.lib)                                    ||
+||    cpu_features.h                                                         ||
+||    hash_abstract.cpp (hash_abstract.lib)                                  ||
+||    hash_abstract.h                                                        ||
+||    pthread                                                                ||
+||                                                                           ||
+||===========================================================================||
+||  REFERENCES                                                               ||
+||===========================================================================||
+||    Saarinen, M-J. and Aumasson, J-P.  RFC 7693.  "The BLAKE2              ||
+||        Cryptographic Hash and Message Authentication Code (MAC)".  Nov    ||
+||        2015.                                                              ||
+||                                                                           ||
+||    Aumasson, J-P., Neves, S., Wilcox-O'Hearn, Z. and Winnerlein, C.       ||
+||        "BLAKE2: simpler, smaller, fast as MD5".  Jan 2013.                ||
+||        https://www.blake2.net/blake2.pdf                                  ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file blake2s.cpp
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "blake2s.h"
+#include "hash_state.h"
+#include "cpu_features.h"
+
+#ifdef GASH_X86_SIMD
+  #include <immintrin.h>
+#endif
+
+const uint32_t BLAKE2s::BLOCK_BYTES;
+const uint32_t BLAKE2s::MAX_DIGEST_BYTES;
+const uint32_t BLAKE2s::MAX_KEY_BYTES;
+const uint32_t BLAKE2s::FILE_BUFFER_BYTES;
+const uint32_t BLAKE2sp::LEAVES;
+const uint32_t BLAKE2sp::PARALLEL_BUFFER_BYTES;
+const uint32_t BLAKE2sp::SUPERBLOCK_BYTES;
+const uint32_t BLAKE2sp::HOLD_BYTES;
+
+// BLAKE2s reuses the SHA-256 initial hash values.
+static const uint32_t IV2S[8] =
+{
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+// The message word order of each of the ten rounds.
+static const uint8_t SIGMA[10][16] =
+{
+    {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+    { 14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3 },
+    { 11,  8, 12,  0,  5,  2, 15, 13, 10, 14,  3,  6,  7,  1,  9,  4 },
+    {  7,  9,  3,  1, 13, 12, 11, 14,  2,  6,  5, 10,  4,  0, 15,  8 },
+    {  9,  0,  5,  7,  2,  4, 10, 15, 14,  1, 11, 12,  6,  8,  3, 13 },
+    {  2, 12,  6, 10,  0, 11,  8,  3,  4, 13,  7,  5, 15, 14,  1,  9 },
+    { 12,  5,  1, 15, 14, 13,  4, 10,  0,  7,  6,  3,  9,  2,  8, 11 },
+    { 13, 11,  7, 14, 12,  1,  3,  9,  5,  0, 15,  4,  8,  6,  2, 10 },
+    {  6, 15, 14,  9, 11,  3,  0,  8, 12,  2, 13,  7,  1,  4, 10,  5 },
+    { 10,  2,  8,  4,  7,  6,  1,  5, 15, 11,  9, 14,  3, 12, 13,  0 }
+};
+
+// The finalization flags of a compression.
+enum
+{
+    FINAL_BLOCK = 0x01,   // The last block of a node.
+    LAST_NODE   = 0x02    // ... which is also the last node of its level.
+};
+
+// Leaf ranges smaller than this are not worth handing to other threads.
+static const uint64_t MIN_THREAD_BYTES = 256 * 1024;
+
+/******************************************************
+**                 Compression Kernels               **
+******************************************************/
+
+// A kernel compresses count blocks that are stride bytes apart.  The
+// counter is the message length up to and including the first block and
+// advances by one block for each of the others; flags apply to every
+// block, so final blocks are compressed on their own.
+typedef void (*Blake2sKernel)(uint32_t h[8], const byte_t *blocks,
+                              uint64_t count, uint64_t stride,
+                              uint64_t counter, uint32_t flags);
+
+// A leaves kernel advances all eight BLAKE2sp leaves by one block of
+// each superblock (none of which are final blocks).
+typedef void (*Blake2sLeavesKernel)(uint32_t leaves[8][8],
+                                    const byte_t *superblocks,
+                                    uint64_t count, uint64_t counter);
+
+static inline uint32_t rotr32 (uint32_t x, uint32_t n)
+{  return ((x >> n) | (x << (32 - n)));  }
+
+static inline uint32_t loadLittleEndian32 (const byte_t *p)
+{
+    return   ((uint32_t)p[0]      ) | ((uint32_t)p[1] <<  8)
+           | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void storeLittleEndian32 (byte_t *p, uint32_t x)
+{
+    p[0] = (byte_t)(x      );
+    p[1] = (byte_t)(x >>  8);
+    p[2] = (byte_t)(x >> 16);
+    p[3] = (byte_t)(x >> 24);
+}
+
+/** The mixing function.  */
+static GASH_ALWAYS_INLINE void
+blake2sG (uint32_t v[16], uint32_t a, uint32_t b, uint32_t c, uint32_t d,
+          uint32_t x, uint32_t y)
+{
+    v[a] = v[a] + v[b] + x;
+    v[d] = rotr32(v[d] ^ v[a], 16);
+    v[c] = v[c] + v[d];
+    v[b] = rotr32(v[b] ^ v[c], 12);
+    v[a] = v[a] + v[b] + y;
+    v[d] = rotr32(v[d] ^ v[a], 8);
+    v[c] = v[c] + v[d];
+    v[b] = rotr32(v[b] ^ v[c], 7);
+}
+
+/** One round: mix the columns and then the diagonals.  */
+static GASH_ALWAYS_INLINE void
+blake2sRound (uint32_t v[16], const uint32_t m[16], uint32_t r)
+{
+    const uint8_t *s = SIGMA[r];
+
+    blake2sG(v, 0, 4,  8, 12, m[s[ 0]], m[s[ 1]]);
+    blake2sG(v, 1, 5,  9, 13, m[s[ 2]], m[s[ 3]]);
+    blake2sG(v, 2, 6, 10, 14, m[s[ 4]], m[s[ 5]]);
+    blake2sG(v, 3, 7, 11, 15, m[s[ 6]], m[s[ 7]]);
+
+    blake2sG(v, 0, 5, 10, 15, m[s[ 8]], m[s[ 9]]);
+    blake2sG(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+    blake2sG(v, 2, 7,  8, 13, m[s[12]], m[s[13]]);
+    blake2sG(v, 3, 4,  9, 14, m[s[14]], m[s[15]]);
+}
+
+/** The portable kernel.  */
+static void blake2sCompressPortable (uint32_t h[8], const byte_t *blocks,
+                                     uint64_t count, uint64_t stride,
+                                     uint64_t counter, uint32_t flags)
+{
+    uint32_t m[16], v[16];
+
+    for (; count > 0; --count, blocks += stride,
+                      counter += BLAKE2s::BLOCK_BYTES)
+    {
+        for (uint32_t i = 0; i < 16; ++i)
+            m[i] = loadLittleEndian32(blocks + (i * 4));
+
+        for (uint32_t i = 0; i < 8; ++i)
+        {
+            v[i] = h[i];
+            v[i + 8] = IV2S[i];
+        }
+
+        v[12] ^= (uint32_t)counter;
+        v[13] ^= (uint32_t)(counter >> 32);
+        if (flags & FINAL_BLOCK)
+            v[14] = ~v[14];
+        if (flags & LAST_NODE)
+            v[15] = ~v[15];
+
+        for (uint32_t r = 0; r < 10; ++r)
+            blake2sRound(v, m, r);
+
+        for (uint32_t i = 0; i < 8; ++i)
+            h[i] ^= v[i] ^ v[i + 8];
+    }
+}
+
+#ifdef GASH_X86_SIMD
+
+// The SSE4.1 kernel keeps each row of the 4x4 working matrix in one XMM
+// register and runs the four G functions of a column or diagonal step
+// side by side; the rows are rotated between the steps to line up the
+// diagonals.
+
+__attribute__((target("sse4.1")))
+static GASH_ALWAYS_INLINE __m128i rotr32x4 (__m128i x, int n)
+{
+    // Rotations by whole bytes are a single shuffle.
+    if (n == 16)
+        return _mm_shuffle_epi8(x, _mm_setr_epi8( 2,  3,  0,  1,  6,  7,  4,  5,
+                                                 10, 11,  8,  9, 14, 15, 12, 13));
+    if (n == 8)
+        return _mm_shuffle_epi8(x, _mm_setr_epi8( 1,  2,  3,  0,  5,  6,  7,  4,
+                                                  9, 10, 11,  8, 13, 14, 15, 12));
+
+    return _mm_or_si128(_mm_srli_epi32(x, n), _mm_slli_epi32(x, 32 - n));
+}
+
+/** The four G functions of a column (or diagonal) step; s points to the
+ *  eight message indices of the step.
+*/
+__attribute__((target("sse4.1")))
+static GASH_ALWAYS_INLINE void
+blake2sStep4 (__m128i row[4], const uint32_t m[16], const uint8_t *s)
+{
+    __m128i x = _mm_set_epi32((int)m[s[6]], (int)m[s[4]],
+                              (int)m[s[2]], (int)m[s[0]]),
+            y = _mm_set_epi32((int)m[s[7]], (int)m[s[5]],
+                              (int)m[s[3]], (int)m[s[1]]);
+
+    row[0] = _mm_add_epi32(_mm_add_epi32(row[0], row[1]), x);
+    row[3] = rotr32x4(_mm_xor_si128(row[3], row[0]), 16);
+    row[2] = _mm_add_epi32(row[2], row[3]);
+    row[1] = rotr32x4(_mm_xor_si128(row[1], row[2]), 12);
+    row[0] = _mm_add_epi32(_mm_add_epi32(row[0], row[1]), y);
+    row[3] = rotr32x4(_mm_xor_si128(row[3], row[0]), 8);
+    row[2] = _mm_add_epi32(row[2], row[3]);
+    row[1] = rotr32x4(_mm_xor_si128(row[1], row[2]), 7);
+}
+
+/** The SSE4.1 kernel.  */
+__attribute__((target("sse4.1")))
+static void blake2sCompressSSE41 (uint32_t h[8], const byte_t *blocks,
+                                  uint64_t count, uint64_t stride,
+                                  uint64_t counter, uint32_t flags)
+{
+    const __m128i iv0 = _mm_loadu_si128((const __m128i *)&IV2S[0]),
+                  iv1 = _mm_loadu_si128((const __m128i *)&IV2S[4]);
+
+    const int final = (flags & FINAL_BLOCK) ? -1 : 0,
+              last = (flags & LAST_NODE) ? -1 : 0;
+
+    __m128i h0 = _mm_loadu_si128((const __m128i *)&h[0]),
+            h1 = _mm_loadu_si128((const __m128i *)&h[4]);
+
+    uint32_t m[16];
+    __m128i row[4];
+
+    for (; count > 0; --count, blocks += stride,
+                      counter += BLAKE2s::BLOCK_BYTES)
+    {
+        memcpy(m, blocks, sizeof(m));
+
+        row[0] = h0;
+        row[1] = h1;
+        row[2] = iv0;
+        row[3] = _mm_xor_si128(iv1, _mm_set_epi32(last, final,
+                                        (int)(counter >> 32), (int)counter));
+
+        for (uint32_t r = 0; r < 10; ++r)
+        {
+            const uint8_t *s = SIGMA[r];
+
+            blake2sStep4(row, m, s);
+
+            row[1] = _mm_shuffle_epi32(row[1], _MM_SHUFFLE(0, 3, 2, 1));
+            row[2] = _mm_shuffle_epi32(row[2], _MM_SHUFFLE(1, 0, 3, 2));
+            row[3] = _mm_shuffle_epi32(row[3], _MM_SHUFFLE(2, 1, 0, 3));
+
+            blake2sStep4(row, m, s + 8);
+
+            row[1] = _mm_shuffle_epi32(row[1], _MM_SHUFFLE(2, 1, 0, 3));
+            row[2] = _mm_shuffle_epi32(row[2], _MM_SHUFFLE(1, 0, 3, 2));
+            row[3] = _mm_shuffle_epi32(row[3], _MM_SHUFFLE(0, 3, 2, 1));
+        }
+
+        h0 = _mm_xor_si128(h0, _mm_xor_si128(row[0], row[2]));
+        h1 = _mm_xor_si128(h1, _mm_xor_si128(row[1], row[3]));
+    }
+
+    _mm_storeu_si128((__m128i *)&h[0], h0);
+    _mm_storeu_si128((__m128i *)&h[4], h1);
+}
+
+__attribute__((target("avx2")))
+static GASH_ALWAYS_INLINE __m256i rotr32x8 (__m256i x, int n)
+{
+    if (n == 16)
+        return _mm256_shuffle_epi8(x, _mm256_setr_epi8(
+                   2,  3,  0,  1,  6,  7,  4,  5, 10, 11,  8,  9, 14, 15, 12, 13,
+                   2,  3,  0,  1,  6,  7,  4,  5, 10, 11,  8,  9, 14, 15, 12, 13));
+    if (n == 8)
+        return _mm256_shuffle_epi8(x, _mm256_setr_epi8(
+                   1,  2,  3,  0,  5,  6,  7,  4,  9, 10, 11,  8, 13, 14, 15, 12,
+                   1,  2,  3,  0,  5,  6,  7,  4,  9, 10, 11,  8, 13, 14, 15, 12));
+
+    return _mm256_or_si256(_mm256_srli_epi32(x, n),
+                           _mm256_slli_epi32(x, 32 - n));
+}
+
+/** The mixing function on eight independent states.  */
+__attribute__((target("avx2")))
+static GASH_ALWAYS_INLINE void
+blake2sG8 (__m256i v[16], uint32_t a, uint32_t b, uint32_t c, uint32_t d,
+           __m256i x, __m256i y)
+{
+    v[a] = _mm256_add_epi32(_mm256_add_epi32(v[a], v[b]), x);
+    v[d] = rotr32x8(_mm256_xor_si256(v[d], v[a]), 16);
+    v[c] = _mm256_add_epi32(v[c], v[d]);
+    v[b] = rotr32x8(_mm256_xor_si256(v[b], v[c]), 12);
+    v[a] = _mm256_add_epi32(_mm256_add_epi32(v[a], v[b]), y);
+    v[d] = rotr32x8(_mm256_xor_si256(v[d], v[a]), 8);
+    v[c] = _mm256_add_epi32(v[c], v[d]);
+    v[b] = rotr32x8(_mm256_xor_si256(v[b], v[c]), 7);
+}
+
+/** Transpose an 8x8 matrix of 32-bit words.  */
+__attribute__((target("avx2")))
+static GASH_ALWAYS_INLINE void transpose8x8 (__m256i x[8])
+{
+    // Interleave the words, then the word pairs, within each 128-bit
+    // lane; the lanes are exchanged last.
+    __m256i ab0145 = _mm256_unpacklo_epi32(x[0], x[1]);
+    __m256i ab2367 = _mm256_unpackhi_epi32(x[0], x[1]);
+    __m256i cd0145 = _mm256_unpacklo_epi32(x[2], x[3]);
+    __m256i cd2367 = _mm256_unpackhi_epi32(x[2], x[3]);
+    __m256i ef0145 = _mm256_unpacklo_epi32(x[4], x[5]);
+    __m256i ef2367 = _mm256_unpackhi_epi32(x[4], x[5]);
+    __m256i gh0145 = _mm256_unpacklo_epi32(x[6], x[7]);
+    __m256i gh2367 = _mm256_unpackhi_epi32(x[6], x[7]);
+
+    __m256i abcd04 = _mm256_unpacklo_epi64(ab0145, cd0145);
+    __m256i abcd15 = _mm256_unpackhi_epi64(ab0145, cd0145);
+    __m256i abcd26 = _mm256_unpacklo_epi64(ab2367, cd2367);
+    __m256i abcd37 = _mm256_unpackhi_epi64(ab2367, cd2367);
+    __m256i efgh04 = _mm256_unpacklo_epi64(ef0145, gh0145);
+    __m256i efgh15 = _mm256_unpackhi_epi64(ef0145, gh0145);
+    __m256i efgh26 = _mm256_unpacklo_epi64(ef2367, gh2367);
+    __m256i efgh37 = _mm256_unpackhi_epi64(ef2367, gh2367);
+
+    x[0] = _mm256_permute2x128_si256(abcd04, efgh04, 0x20);
+    x[1] = _mm256_permute2x128_si256(abcd15, efgh15, 0x20);
+    x[2] = _mm256_permute2x128_si256(abcd26, efgh26, 0x20);
+    x[3] = _mm256_permute2x128_si256(abcd37, efgh37, 0x20);
+    x[4] = _mm256_permute2x128_si256(abcd04, efgh04, 0x31);
+    x[5] = _mm256_permute2x128_si256(abcd15, efgh15, 0x31);
+    x[6] = _mm256_permute2x128_si256(abcd26, efgh26, 0x31);
+    x[7] = _mm256_permute2x128_si256(abcd37, efgh37, 0x31);
+}
+
+/** The AVX2 leaves kernel: word i of every leaf's state shares vector i
+ *  (one leaf per 32-bit lane), so no rows have to be rotated.
+*/
+__attribute__((target("avx2")))
+static void blake2sLeavesAVX2 (uint32_t leaves[8][8],
+                               const byte_t *superblocks, uint64_t count,
+                               uint64_t counter)
+{
+    __m256i h[8], m[16], v[16];
+
+    for (uint32_t i = 0; i < 8; ++i)
+        h[i] = _mm256_setr_epi32((int)leaves[0][i], (int)leaves[1][i],
+                                 (int)leaves[2][i], (int)leaves[3][i],
+                                 (int)leaves[4][i], (int)leaves[5][i],
+                                 (int)leaves[6][i], (int)leaves[7][i]);
+
+    for (; count > 0; --count, superblocks += 8 * BLAKE2s::BLOCK_BYTES,
+                      counter += BLAKE2s::BLOCK_BYTES)
+    {
+        // Row j of each 8x8 tile is eight message words of leaf j.
+        for (uint32_t q = 0; q < 2; ++q)
+        {
+            for (uint32_t j = 0; j < 8; ++j)
+                m[(q * 8) + j] = _mm256_loadu_si256((const __m256i *)
+                    (superblocks + (j * BLAKE2s::BLOCK_BYTES) + (q * 32)));
+
+            transpose8x8(m + (q * 8));
+        }
+
+        for (uint32_t i = 0; i < 8; ++i)
+        {
+            v[i] = h[i];
+            v[i + 8] = _mm256_set1_epi32((int)IV2S[i]);
+        }
+
+        v[12] = _mm256_set1_epi32((int)(IV2S[4] ^ (uint32_t)counter));
+        v[13] = _mm256_set1_epi32((int)(IV2S[5] ^ (uint32_t)(counter >> 32)));
+
+        for (uint32_t r = 0; r < 10; ++r)
+        {
+            const uint8_t *s = SIGMA[r];
+
+            blake2sG8(v, 0, 4,  8, 12, m[s[ 0]], m[s[ 1]]);
+            blake2sG8(v, 1, 5,  9, 13, m[s[ 2]], m[s[ 3]]);
+            blake2sG8(v, 2, 6, 10, 14, m[s[ 4]], m[s[ 5]]);
+            blake2sG8(v, 3, 7, 11, 15, m[s[ 6]], m[s[ 7]]);
+
+            blake2sG8(v, 0, 5, 10, 15, m[s[ 8]], m[s[ 9]]);
+            blake2sG8(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+            blake2sG8(v, 2, 7,  8, 13, m[s[12]], m[s[13]]);
+            blake2sG8(v, 3, 4,  9, 14, m[s[14]], m[s[15]]);
+        }
+
+        for (uint32_t i = 0; i < 8; ++i)
+            h[i] = _mm256_xor_si256(h[i], _mm256_xor_si256(v[i], v[i + 8]));
+    }
+
+    // The transposition is its own inverse.
+    transpose8x8(h);
+
+    for (uint32_t j = 0; j < 8; ++j)
+        _mm256_storeu_si256((__m256i *)leaves[j], h[j]);
+}
+
+#endif  // GASH_X86_SIMD
+
+/** Choose the fastest kernel that the host supports.  */
+static Blake2sKernel selectBlake2sKernel (void)
+{
+#ifdef GASH_X86_SIMD
+    if (CPUFeatures::has(CPUFeatures::SSE41))
+        return blake2sCompressSSE41;
+#endif
+
+    return blake2sCompressPortable;
+}
+
+/** Choose a leaves kernel; NULL when the leaves are to be compressed
+ *  one at a time.
+*/
+static Blake2sLeavesKernel selectBlake2sLeavesKernel (void)
+{
+#ifdef GASH_X86_SIMD
+    if (CPUFeatures::has(CPUFeatures::AVX2))
+        return blake2sLeavesAVX2;
+#endif
+
+    return NULL;
+}
+
+static Blake2sKernel blake2sKernel (void)
+{
+    static const Blake2sKernel kernel = selectBlake2sKernel();
+    return kernel;
+}
+
+/** Load the chaining values from the IV and the parameter block.  */
+static void blake2sInitialize (uint32_t h[8], uint32_t digestBytes,
+                               uint32_t keyBytes, uint32_t fanout,
+                               uint32_t depth, uint64_t nodeOffset,
+                               uint32_t nodeDepth, uint32_t innerBytes)
+{
+    // The leaf length, salt and personalization are always zero; the
+    // node offset is 48 bits long.
+    uint32_t param[8] =
+    {
+        digestBytes | (keyBytes << 8) | (fanout << 16) | (depth << 24),
+        0,
+        (uint32_t)nodeOffset,
+        ((uint32_t)(nodeOffset >> 32) & 0xffff) | (nodeDepth << 16)
+                                                | (innerBytes << 24),
+        0, 0, 0, 0
+    };
+
+    for (uint32_t i = 0; i < 8; ++i)
+        h[i] = IV2S[i] ^ param[i];
+}
+
+/** Serialize the chaining values (little endian).  */
+static void blake2sDigest (const uint32_t h[8], byte_t digest[32])
+{
+    for (uint32_t i = 0; i < 8; ++i)
+        storeLittleEndian32(digest + (i * 4), h[i]);
+}
+
+/** One thread's share of the BLAKE2sp leaves.  */
+struct Blake2sLeafJob
+{
+    uint32_t (*leaves)[8];
+    uint32_t first;        // The first leaf of the share ...
+    uint32_t step;         // ... and the distance to the next.
+    const byte_t *superblocks;
+    uint64_t count;
+    uint64_t counter;
+};
+
+static void * blake2sLeafThread (void *arg)
+{
+    Blake2sLeafJob *job = (Blake2sLeafJob *)arg;
+
+    for (uint32_t i = job->first; i < BLAKE2sp::LEAVES; i += job->step)
+        blake2sKernel()(job->leaves[i],
+                        job->superblocks + (i * BLAKE2s::BLOCK_BYTES),
+                        job->count, BLAKE2sp::LEAVES * BLAKE2s::BLOCK_BYTES,
+                        job->counter, 0);
+
+    return NULL;
+}
+
+/******************************************************
+**            Constructors / Destructors             **
+******************************************************/
+
+/** Default constructor (BLAKE2s-256).  */
+BLAKE2s::BLAKE2s ()
+    : MessageHash(256),
+      _keyBytes(0),
+      _lastNode(false),
+      _fileBufferBytes(FILE_BUFFER_BYTES)
+{
+    memset(_key, 0, sizeof(_key));
+    _setTreeParameters(1, 1, 0, 0);
+    reset();
+}
+
+/** Initialize a BLAKE2s object with a shorter digest.
+ *
+ *  @pre bits is a multiple of 32 between 32 and 256.
+ *  @post The object produces a digest of the given length (which
+ *        is a parameter of the hash, not a truncation).
+ *  @param bits The number of bits in the hash.
+*/
+BLAKE2s::BLAKE2s (uint32_t bits)
+    : MessageHash(bits),
+      _keyBytes(0),
+      _lastNode(false),
+      _fileBufferBytes(FILE_BUFFER_BYTES)
+{
+    memset(_key, 0, sizeof(_key));
+    _setTreeParameters(1, 1, 0, 0);
+    reset();
+}
+
+/** Copy constructor.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated from the copied BLAKE2s object
+ *        including any partially processed message.
+ *  @param copyFrom The BLAKE2s object whose values are to be copied.
+*/
+BLAKE2s::BLAKE2s (const BLAKE2s &copyFrom)
+    : MessageHash(copyFrom)
+{
+    *this = copyFrom;
+}
+
+/** Initialize a BLAKE2s object by hashing an input std::string.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated containing the
+ *        hashed value of the input data.
+ *  @param str The std::string that is to be hashed.
+*/
+BLAKE2s::BLAKE2s (const string &str)
+    : MessageHash(256),
+      _keyBytes(0),
+      _lastNode(false),
+      _fileBufferBytes(FILE_BUFFER_BYTES)
+{
+    memset(_key, 0, sizeof(_key));
+    _setTreeParameters(1, 1, 0, 0);
+    calculateHash(str);
+}
+
+/** Initialize a BLAKE2s object by hashing an input data stream.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated containing the
+ *        hashed value of the input data.
+ *  @param data The data that is to be hashed.
+*/
+BLAKE2s::BLAKE2s (const vector < byte_t > &data)
+    : MessageHash(256),
+      _keyBytes(0),
+      _lastNode(false),
+      _fileBufferBytes(FILE_BUFFER_BYTES)
+{
+    memset(_key, 0, sizeof(_key));
+    _setTreeParameters(1, 1, 0, 0);
+    calculateHash(data);
+}
+
+/** Initialize a BLAKE2s object by hashing an input file stream.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated containing the
+ *        hashed value of the input data.
+ *  @param file A handle to the file that is to be hashed.
+*/
+BLAKE2s::BLAKE2s (ifstream &file)
+    : MessageHash(256),
+      _keyBytes(0),
+      _lastNode(false),
+      _fileBufferBytes(FILE_BUFFER_BYTES)
+{
+    memset(_key, 0, sizeof(_key));
+    _setTreeParameters(1, 1, 0, 0);
+    calculateHash(file);
+}
+
+/** Default destructor.  */
+BLAKE2s::~BLAKE2s ()  { }
+
+/******************************************************
+**               Accessors / Mutators                **
+******************************************************/
+
+////////////////////
+//    Getters
+////////////////////
+
+/** Retrieve the name of the algorithm.
+ *
+ *  @pre The object is instantiated.
+ *  @post none.
+ *  @return "BLAKE2s-" followed by the digest length in bits.
+*/
+string BLAKE2s::algorithmName (void) const
+{
+    stringstream ss;
+    ss << "BLAKE2s-" << (_hash.size() * 32);
+
+    return ss.str();
+}
+
+/** Retrieve the name of the kernel that the host selected.
+ *
+ *  @pre The object is instantiated.
+ *  @post none.
+ *  @return "SSE4.1" or "portable".
+*/
+string BLAKE2s::kernelName (void) const
+{
+#ifdef GASH_X86_SIMD
+    if (blake2sKernel() == blake2sCompressSSE41)
+        return "SSE4.1";
+#endif
+
+    return "portable";
+}
+
+/** Copy the object, including any partially processed message.
+ *
+ *  @pre none.
+ *  @post The caller owns (and must delete) the copy.
+ *  @return A new BLAKE2s object in the same state.
+*/
+BLAKE2s * BLAKE2s::clone (void) const
+{
+    return new BLAKE2s(*this);
+}
+
+////////////////////
+//    Setters
+////////////////////
+
+/** Calculate the hash from an input std::string.
+ *
+ *  @pre The object is instantiated.
+ *  @post The computed hash is stored in the _hash values.
+ *  @param str The string whose value is to be hashed.
+ *  @return The hash as a std::string.
+*/
+string BLAKE2s::calculateHash (const string &str)
+{
+    reset();
+    update((const byte_t *)str.data(), str.size());
+
+    return finalize();
+}
+
+/** Calculate the hash from an input data stream.
+ *
+ *  @pre The object is instantiated.
+ *  @post The computed hash is stored in the _hash values.
+ *  @param data The data that is to be hashed.
+ *  @return The hash as a std::string.
+*/
+string BLAKE2s::calculateHash (const vector < byte_t > &data)
+{
+    reset();
+    update(data);
+
+    return finalize();
+}
+
+/** Calculate the hash of a file.
+ *
+ *  @pre The object is instantiated.
+ *  @post The computed hash is stored in the _hash values.
+ *  @param file The file whose hash value is to be calculated.
+ *  @return The hash as a std::string.
+*/
+string BLAKE2s::calculateHash (ifstream &file)
+{
+    reset();
+
+    // Check that the file is valid before doing anything else.
+    // This will return a hash value of all zeros.
+    if (file.fail() || !file.good())
+    {
+        _hash.assign(_hash.size(), 0x00000000);
+        return asString();
+    }
+
+    // Size the buffer to the file so that small files do not pay for
+    // a large read buffer.
+    file.seekg(0, ios::end);
+    uint64_t fileSize = (uint64_t)file.tellg();
+    file.seekg(0, ios::beg);
+
+    uint64_t bufferSize = _fileBufferBytes;
+    if (fileSize < bufferSize)
+        bufferSize = fileSize + 1;
+
+    vector < byte_t > buffer((size_t)bufferSize);
+
+    while (file.good())
+    {
+        file.read((char *)&buffer[0], buffer.size());
+        update(&buffer[0], (uint64_t)file.gcount());
+    }
+
+    // Reset the file flags and return to the file head.
+    file.clear();
+    file.seekg(0);  // Return to the head of the file.
+
+    return finalize();
+}
+
+/** Switch to the keyed hash (MAC) mode.
+ *
+ *  @pre length is no more than MAX_KEY_BYTES.
+ *  @post Any message data is discarded and later hashes are
+ *        keyed with the given key; a zero length removes the key.
+ *  @param key A pointer to the key.
+ *  @param length The number of bytes in the key.
+ *  @return none.
+*/
+void BLAKE2s::setKey (const byte_t *key, uint32_t length)
+{
+    if (length > MAX_KEY_BYTES)
+        length = MAX_KEY_BYTES;
+
+    memset(_key, 0, sizeof(_key));
+    memcpy(_key, key, length);
+    _keyBytes = length;
+
+    reset();
+
+    return;
+}
+
+/** Discard any message data and restart the hash.
+ *
+ *  @pre The object is instantiated.
+ *  @post The chaining values hold their initial values.
+ *  @return none.
+*/
+void BLAKE2s::reset (void)
+{
+    blake2sInitialize(_h, (uint32_t)_hash.size() * 4, _keyBytes, _fanout,
+                      _depth, 0, _nodeDepth, _innerBytes);
+
+    _counter = 0;
+    memset(_block, 0, sizeof(_block));
+    _pending = 0;
+
+    // A key is hashed as a zero padded first block.
+    if (_keyBytes > 0)
+    {
+        memcpy(_block, _key, _keyBytes);
+        _pending = BLOCK_BYTES;
+    }
+
+    return;
+}
+
+/** Append message data to the hash.
+ *
+ *  @pre reset() has been called since the last finalize().
+ *  @post All but the last block of the data seen so far have
+ *        been compressed.
+ *  @param data A pointer to the message data.
+ *  @param length The number of bytes at data.
+ *  @return none.
+*/
+void BLAKE2s::update (const byte_t *data, uint64_t length)
+{
+    // The last block is compressed differently, so a block is only
+    // compressed once there is data after it.
+    if (_pending + length <= BLOCK_BYTES)
+    {
+        memcpy(_block + _pending, data, (size_t)length);
+        _pending += (uint32_t)length;
+
+        return;
+    }
+
+    if (_pending > 0)
+    {
+        uint32_t fill = BLOCK_BYTES - _pending;
+
+        memcpy(_block + _pending, data, fill);
+        data += fill;
+        length -= fill;
+
+        _counter += BLOCK_BYTES;
+        blake2sKernel()(_h, _block, 1, BLOCK_BYTES, _counter, 0);
+        _pending = 0;
+    }
+
+    uint64_t blocks = (length - 1) / BLOCK_BYTES;
+    if (blocks > 0)
+    {
+        blake2sKernel()(_h, data, blocks, BLOCK_BYTES,
+                        _counter + BLOCK_BYTES, 0);
+
+        _counter += blocks * BLOCK_BYTES;
+        data += blocks * BLOCK_BYTES;
+        length -= blocks * BLOCK_BYTES;
+    }
+
+    memcpy(_block, data, (size_t)length);
+    _pending = (uint32_t)length;
+
+    return;
+}
+
+/** Append message data to the hash.
+ *
+ *  @pre reset() has been called since the last finalize().
+ *  @post The message data has been absorbed.
+ *  @param data The message data.
+ *  @return none.
+*/
+void BLAKE2s::update (const vector < byte_t > &data)
+{
+    if (!data.empty())
+        update(&data[0], data.size());
+
+    return;
+}
+
+/** Compress the final block and produce the hash.
+ *
+ *  @pre reset() has been called since the last finalize().
+ *  @post The computed hash is stored in the _hash values.
+ *  @return The hash as a std::string.
+*/
+string BLAKE2s::finalize (void)
+{
+    memset(_block + _pending, 0, BLOCK_BYTES - _pending);
+    _counter += _pending;
+
+    blake2sKernel()(_h, _block, 1, BLOCK_BYTES, _counter,
+                    FINAL_BLOCK | (_lastNode ? LAST_NODE : 0));
+    _pending = 0;
+
+    _storeHash();
+
+    return asString();
+}
+
+/******************************************************
+**                     Operators                     **
+******************************************************/
+
+/** Assignment from another BLAKE2s object.
+ *
+ *  @pre The object is instantiated.
+ *  @post The object contains the values copied from rhs.
+ *  @param rhs The BLAKE2s object whose values are to be copied/stored.
+ *  @return A reference to the object.
+*/
+BLAKE2s & BLAKE2s::operator = (const BLAKE2s &rhs)
+{
+    if (this != &rhs)
+    {
+        MessageHash::operator = (rhs);
+
+        memcpy(_h, rhs._h, sizeof(_h));
+        _counter = rhs._counter;
+        memcpy(_block, rhs._block, sizeof(_block));
+        _pending = rhs._pending;
+
+        memcpy(_key, rhs._key, sizeof(_key));
+        _keyBytes = rhs._keyBytes;
+
+        _fanout = rhs._fanout;
+        _depth = rhs._depth;
+        _nodeDepth = rhs._nodeDepth;
+        _innerBytes = rhs._innerBytes;
+        _lastNode = rhs._lastNode;
+
+        _fileBufferBytes = rhs._fileBufferBytes;
+    }
+
+    return *this;
+}
+
+/******************************************************
+**                   Helper Methods                  **
+******************************************************/
+
+/** Set up the object as a node of a hash tree.
+ *
+ *  @pre none.
+ *  @post The parameter block describes the given tree node.
+ *  @param fanout The number of children of each node.
+ *  @param depth The number of levels in the tree.
+ *  @param nodeDepth The level of this node (zero for leaves).
+ *  @param innerBytes The digest length of the inner nodes.
+ *  @return none.
+*/
+void BLAKE2s::_setTreeParameters (uint32_t fanout, uint32_t depth,
+                                  uint32_t nodeDepth, uint32_t innerBytes)
+{
+    _fanout = fanout;
+    _depth = depth;
+    _nodeDepth = nodeDepth;
+    _innerBytes = innerBytes;
+
+    return;
+}
+
+/** Copy the chaining values into the _hash words.
+ *
+ *  @pre The final block has been compressed.
+ *  @post The _hash values hold the message digest.
+ *  @return none.
+*/
+void BLAKE2s::_storeHash (void)
+{
+    byte_t digest[32];
+    blake2sDigest(_h, digest);
+
+    // The digest is printed a word at a time, most significant byte
+    // first, so the byte string is packed big endian.
+    for (uint32_t i = 0; i < _hash.size(); ++i)
+        _hash.at(i) =   ((uint32_t)digest[(i * 4)    ] << 24)
+                      | ((uint32_t)digest[(i * 4) + 1] << 16)
+                      | ((uint32_t)digest[(i * 4) + 2] <<  8)
+                      | ((uint32_t)digest[(i * 4) + 3]      );
+
+    return;
+}
+
+/** Append the algorithm specific part of the midstate.
+ *
+ *  @pre none.
+ *  @post The state is appended to state.
+ *  @param state The state that is being exported.
+ *  @return none.
+*/
+void BLAKE2s::_saveState (HashState &state) const
+{
+    state.putWords32(_h, 8);
+    state.putWord64(_counter);
+    state.putWord32(_pending);
+    state.putBytes(_block, BLOCK_BYTES);
+
+    // The key is part of the state: a keyed hash restarts with it.
+    state.putWord32(_keyBytes);
+    state.putBytes(_key, MAX_KEY_BYTES);
+
+    state.putWord32(_fanout);
+    state.putWord32(_depth);
+    state.putWord32(_nodeDepth);
+    state.putWord32(_innerBytes);
+    state.putWord32(_lastNode ? 1 : 0);
+
+    return;
+}
+
+/** Restore the algorithm specific part of the midstate.
+ *
+ *  @pre The common header of state has been read and checked.
+ *  @post The object holds the imported state.
+ *  @param state The state that is being imported.
+ *  @return true The values read are consistent.
+ *  @return false The state is corrupt.
+*/
+bool BLAKE2s::_loadState (HashState &state)
+{
+    uint32_t h[8];
+    byte_t block[BLOCK_BYTES],
+           key[MAX_KEY_BYTES];
+
+    state.getWords32(h, 8);
+    uint64_t counter = state.getWord64();
+    uint32_t pending = state.getWord32();
+    state.getBytes(block, BLOCK_BYTES);
+
+    uint32_t keyBytes = state.getWord32();
+    state.getBytes(key, MAX_KEY_BYTES);
+
+    // The tree parameters are fixed by the type of the object, so a state
+    // of another node (or of the parallel variant) is refused.
+    bool sameNode = (state.getWord32() == _fanout)
+                    && (state.getWord32() == _depth)
+                    && (state.getWord32() == _nodeDepth)
+                    && (state.getWord32() == _innerBytes)
+                    && (state.getWord32() == (_lastNode ? 1u : 0u));
+
+    // Nothing is taken from a corrupt state: the reset() that follows
+    // copies _keyBytes bytes of the key.
+    if (!sameNode || (pending > BLOCK_BYTES) || (keyBytes > MAX_KEY_BYTES))
+        return false;
+
+    memcpy(_h, h, sizeof(_h));
+    _counter = counter;
+    _pending = pending;
+    memcpy(_block, block, sizeof(_block));
+    _keyBytes = keyBytes;
+    memcpy(_key, key, sizeof(_key));
+
+    return true;
+}
+
+/******************************************************
+**                      BLAKE2sp                     **
+******************************************************/
+
+/** Default constructor.  */
+BLAKE2sp::BLAKE2sp ()
+    : BLAKE2s(256)
+{
+    _setTreeParameters(LEAVES, 2, 1, MAX_DIGEST_BYTES);
+    _lastNode = true;
+    _fileBufferBytes = PARALLEL_BUFFER_BYTES;
+
+    setThreads(0);
+    reset();
+}
+
+/** Copy constructor.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated from the copied BLAKE2sp object
+ *        including any partially processed message.
+ *  @param copyFrom The BLAKE2sp object whose values are to be copied.
+*/
+BLAKE2sp::BLAKE2sp (const BLAKE2sp &copyFrom)
+    : BLAKE2s(copyFrom)
+{
+    *this = copyFrom;
+}
+
+/** Initialize a BLAKE2sp object by hashing an input std::string.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated containing the
+ *        hashed value of the input data.
+ *  @param str The std::string that is to be hashed.
+*/
+BLAKE2sp::BLAKE2sp (const string &str)
+    : BLAKE2s(256)
+{
+    _setTreeParameters(LEAVES, 2, 1, MAX_DIGEST_BYTES);
+    _lastNode = true;
+    _fileBufferBytes = PARALLEL_BUFFER_BYTES;
+
+    setThreads(0);
+    calculateHash(str);
+}
+
+/** Initialize a BLAKE2sp object by hashing an input data stream.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated containing the
+ *        hashed value of the input data.
+ *  @param data The data that is to be hashed.
+*/
+BLAKE2sp::BLAKE2sp (const vector < byte_t > &data)
+    : BLAKE2s(256)
+{
+    _setTreeParameters(LEAVES, 2, 1, MAX_DIGEST_BYTES);
+    _lastNode = true;
+    _fileBufferBytes = PARALLEL_BUFFER_BYTES;
+
+    setThreads(0);
+    calculateHash(data);
+}
+
+/** Initialize a BLAKE2sp object by hashing an input file stream.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated containing the
+ *        hashed value of the input data.
+ *  @param file A handle to the file that is to be hashed.
+*/
+BLAKE2sp::BLAKE2sp (ifstream &file)
+    : BLAKE2s(256)
+{
+    _setTreeParameters(LEAVES, 2, 1, MAX_DIGEST_BYTES);
+    _lastNode = true;
+    _fileBufferBytes = PARALLEL_BUFFER_BYTES;
+
+    setThreads(0);
+    calculateHash(file);
+}
+
+/** Default destructor.  */
+BLAKE2sp::~BLAKE2sp ()  { }
+
+/** Retrieve the name of the algorithm.
+ *
+ *  @pre The object is instantiated.
+ *  @post none.
+ *  @return "BLAKE2sp".
+*/
+string BLAKE2sp::algorithmName (void) const
+{
+    return "BLAKE2sp";
+}
+
+/** Retrieve the name of the kernel that the host selected.
+ *
+ *  @pre The object is instantiated.
+ *  @post none.
+ *  @return "AVX2 leaves" where the eight leaves are compressed together,
+ *          otherwise the kernel of BLAKE2s.
+*/
+string BLAKE2sp::kernelName (void) const
+{
+    if (selectBlake2sLeavesKernel() != NULL)
+        return "AVX2 leaves";
+
+    return BLAKE2s::kernelName();
+}
+
+/** Copy the object, including any partially processed message.
+ *
+ *  @pre none.
+ *  @post The caller owns (and must delete) the copy.
+ *  @return A new BLAKE2sp object in the same state.
+*/
+BLAKE2sp * BLAKE2sp::clone (void) const
+{
+    return new BLAKE2sp(*this);
+}
+
+/** Set the number of threads used to hash large inputs.
+ *
+ *  @pre The object is instantiated.
+ *  @post The leaves of later update() calls are spread over
+ *        at most the given number of threads.
+ *  @param threads The thread limit; zero selects one thread for
+ *         each online processor.
+ *  @return none.
+*/
+void BLAKE2sp::setThreads (uint32_t threads)
+{
+    if (threads == 0)
+    {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (online > 0) ? (uint32_t)online : 1;
+    }
+
+    _threads = threads;
+
+    return;
+}
+
+/** Discard any message data and restart the hash.
+ *
+ *  @pre The object is instantiated.
+ *  @post The leaves and the root hold their initial values.
+ *  @return none.
+*/
+void BLAKE2sp::reset (void)
+{
+    BLAKE2s::reset();
+
+    // The root only takes the key length as a parameter; the key block
+    // is hashed by each of the leaves instead.
+    memset(_block, 0, sizeof(_block));
+    _pending = 0;
+
+    for (uint32_t i = 0; i < LEAVES; ++i)
+        blake2sInitialize(_leaves[i], MAX_DIGEST_BYTES, _keyBytes, LEAVES, 2,
+                          i, 0, MAX_DIGEST_BYTES);
+
+    _leafBytes = 0;
+    _keyPending = (_keyBytes > 0);
+    _buffered = 0;
+
+    return;
+}
+
+/** Append message data to the hash.
+ *
+ *  @pre reset() has been called since the last finalize().
+ *  @post Each leaf has compressed every block of the data seen so
+ *        far except the blocks that might still be its last.
+ *  @param data A pointer to the message data.
+ *  @param length The number of bytes at data.
+ *  @return none.
+*/
+void BLAKE2sp::update (const byte_t *data, uint64_t length)
+{
+    uint64_t total = _buffered + length;
+
+    if (total <= HOLD_BYTES)
+    {
+        memcpy(_buffer + _buffered, data, (size_t)length);
+        _buffered += (uint32_t)length;
+
+        return;
+    }
+
+    // The number of superblocks that leave no more than HOLD_BYTES.
+    uint64_t ready = (total - HOLD_BYTES + SUPERBLOCK_BYTES - 1)
+                     / SUPERBLOCK_BYTES;
+
+    // Superblocks that start in the buffer are completed from the data.
+    while ((ready > 0) && (_buffered > 0))
+    {
+        if (_buffered < SUPERBLOCK_BYTES)
+        {
+            uint32_t fill = SUPERBLOCK_BYTES - _buffered;
+
+            memcpy(_buffer + _buffered, data, fill);
+            data += fill;
+            length -= fill;
+            _buffered = SUPERBLOCK_BYTES;
+        }
+
+        _compressLeaves(_buffer, 1);
+
+        _buffered -= SUPERBLOCK_BYTES;
+        memmove(_buffer, _buffer + SUPERBLOCK_BYTES, _buffered);
+        --ready;
+    }
+
+    // The rest are compressed straight from the caller's buffer.
+    if (ready > 0)
+    {
+        _compressLeaves(data, ready);
+        data += ready * SUPERBLOCK_BYTES;
+        length -= ready * SUPERBLOCK_BYTES;
+    }
+
+    memcpy(_buffer + _buffered, data, (size_t)length);
+    _buffered += (uint32_t)length;
+
+    return;
+}
+
+/** Finish the leaves, hash their digests in the root and produce
+ *  the hash.
+ *
+ *  @pre reset() has been called since the last finalize().
+ *  @post The computed hash is stored in the _hash values.
+ *  @return The hash as a std::string.
+*/
+string BLAKE2sp::finalize (void)
+{
+    byte_t keyBlock[BLOCK_BYTES], tail[BLOCK_BYTES];
+    byte_t digests[LEAVES][MAX_DIGEST_BYTES];
+
+    memset(keyBlock, 0, sizeof(keyBlock));
+    memcpy(keyBlock, _key, _keyBytes);
+
+    for (uint32_t i = 0; i < LEAVES; ++i)
+    {
+        uint32_t *h = _leaves[i];
+        uint64_t bytes = _leafBytes;
+        uint32_t finalFlags = FINAL_BLOCK
+                              | ((i == LEAVES - 1) ? LAST_NODE : 0);
+
+        // Leaf i's remaining blocks start at i * BLOCK_BYTES and then
+        // every SUPERBLOCK_BYTES; the key block comes before them.
+        uint32_t offset = i * BLOCK_BYTES;
+        bool hasData = (_buffered > offset);
+
+        if (_keyPending)
+        {
+            bytes += BLOCK_BYTES;
+            blake2sKernel()(h, keyBlock, 1, BLOCK_BYTES, bytes,
+                            hasData ? 0 : finalFlags);
+        }
+        else if (!hasData)
+        {
+            // An empty leaf compresses one zero block.
+            memset(tail, 0, sizeof(tail));
+            blake2sKernel()(h, tail, 1, BLOCK_BYTES, bytes, finalFlags);
+        }
+
+        for (; hasData; offset += SUPERBLOCK_BYTES)
+        {
+            if (offset + SUPERBLOCK_BYTES < _buffered)
+            {
+                bytes += BLOCK_BYTES;
+                blake2sKernel()(h, _buffer + offset, 1, BLOCK_BYTES, bytes, 0);
+                continue;
+            }
+
+            uint32_t length = _buffered - offset;
+            if (length > BLOCK_BYTES)
+                length = BLOCK_BYTES;
+
+            memset(tail, 0, sizeof(tail));
+            memcpy(tail, _buffer + offset, length);
+            bytes += length;
+            blake2sKernel()(h, tail, 1, BLOCK_BYTES, bytes, finalFlags);
+
+            break;
+        }
+
+        blake2sDigest(h, digests[i]);
+    }
+
+    BLAKE2s::update(&digests[0][0], sizeof(digests));
+
+    return BLAKE2s::finalize();
+}
+
+/** Assignment from another BLAKE2sp object.
+ *
+ *  @pre The object is instantiated.
+ *  @post The object contains the values copied from rhs.
+ *  @param rhs The BLAKE2sp object whose values are to be copied/stored.
+ *  @return A reference to the object.
+*/
+BLAKE2sp & BLAKE2sp::operator = (const BLAKE2sp &rhs)
+{
+    if (this != &rhs)
+    {
+        BLAKE2s::operator = (rhs);
+
+        memcpy(_leaves, rhs._leaves, sizeof(_leaves));
+        _leafBytes = rhs._leafBytes;
+        _keyPending = rhs._keyPending;
+        memcpy(_buffer, rhs._buffer, sizeof(_buffer));
+        _buffered = rhs._buffered;
+        _threads = rhs._threads;
+    }
+
+    return *this;
+}
+
+/** Compress whole superblocks into the leaves.
+ *
+ *  @pre Every leaf has at least one more block after them.
+ *  @post Each leaf has compressed its block of each superblock.
+ *  @param superblocks A pointer to the first superblock.
+ *  @param count The number of consecutive superblocks.
+ *  @return none.
+*/
+void BLAKE2sp::_compressLeaves (const byte_t *superblocks, uint64_t count)
+{
+    static const Blake2sLeavesKernel leavesKernel =
+                                     selectBlake2sLeavesKernel();
+
+    // The key blocks can go now that each leaf has data after them.
+    if (_keyPending)
+    {
+        byte_t keyBlock[BLOCK_BYTES];
+
+        memset(keyBlock, 0, sizeof(keyBlock));
+        memcpy(keyBlock, _key, _keyBytes);
+
+        for (uint32_t i = 0; i < LEAVES; ++i)
+            blake2sKernel()(_leaves[i], keyBlock, 1, BLOCK_BYTES,
+                            BLOCK_BYTES, 0);
+
+        _leafBytes = BLOCK_BYTES;
+        _keyPending = false;
+    }
+
+    uint64_t counter = _leafBytes + BLOCK_BYTES;
+    uint32_t threads = (_threads < LEAVES) ? _threads : LEAVES;
+
+    if ((threads > 1) && (count * SUPERBLOCK_BYTES >= MIN_THREAD_BYTES))
+    {
+        // Each thread takes every threads-th leaf; this thread does the
+        // first share itself.
+        Blake2sLeafJob jobs[LEAVES];
+        pthread_t workers[LEAVES];
+        bool started[LEAVES];
+
+        for (uint32_t t = 0; t < threads; ++t)
+        {
+            Blake2sLeafJob job = { _leaves, t, threads, superblocks, count,
+                                   counter };
+            jobs[t] = job;
+            started[t] = (t > 0) && (pthread_create(&workers[t], NULL,
+                                         blake2sLeafThread, &jobs[t]) == 0);
+        }
+
+        for (uint32_t t = 0; t < threads; ++t)
+        {
+            if (t == 0 || !started[t])
+                blake2sLeafThread(&jobs[t]);
+        }
+
+        for (uint32_t t = 1; t < threads; ++t)
+        {
+            if (started[t])
+                pthread_join(workers[t], NULL);
+        }
+    }
+    else if (leavesKernel != NULL)
+        leavesKernel(_leaves, superblocks, count, counter);
+    else
+    {
+        for (uint32_t i = 0; i < LEAVES; ++i)
+            blake2sKernel()(_leaves[i], superblocks + (i * BLOCK_BYTES),
+                            count, SUPERBLOCK_BYTES, counter, 0);
+    }
+
+    _leafBytes += count * BLOCK_BYTES;
+
+    return;
+}
+
+/** Append the algorithm specific part of the midstate.
+ *
+ *  @pre none.
+ *  @post The state is appended to state.
+ *  @param state The state that is being exported.
+ *  @return none.
+*/
+void BLAKE2sp::_saveState (HashState &state) const
+{
+    BLAKE2s::_saveState(state);
+
+    state.putWords32(&_leaves[0][0], LEAVES * 8);
+    state.putWord64(_leafBytes);
+    state.putWord32(_keyPending ? 1 : 0);
+    state.putWord32(_buffered);
+    state.putBytes(_buffer, _buffered);
+
+    return;
+}
+
+/** Restore the algorithm specific part of the midstate.
+ *
+ *  @pre The common header of state has been read and checked.
+ *  @post The object holds the imported state.
+ *  @param state The state that is being imported.
+ *  @return true The values read are consistent.
+ *  @return false The state is corrupt.
+*/
+bool BLAKE2sp::_loadState (HashState &state)
+{
+    // The key of the root is put back if the leaves turn out corrupt.
+    uint32_t keyBytes = _keyBytes;
+    byte_t key[MAX_KEY_BYTES];
+
+    memcpy(key, _key, sizeof(key));
+
+    if (!BLAKE2s::_loadState(state))
+        return false;
+
+    state.getWords32(&_leaves[0][0], LEAVES * 8);
+    uint64_t leafBytes = state.getWord64();
+    bool keyPending = (state.getWord32() != 0);
+    uint32_t buffered = state.getWord32();
+
+    if ((buffered > sizeof(_buffer)) || ((leafBytes % BLOCK_BYTES) != 0))
+    {
+        _keyBytes = keyBytes;
+        memcpy(_key, key, sizeof(_key));
+
+        return false;
+    }
+
+    _leafBytes = leafBytes;
+    _keyPending = keyPending;
+    _buffered = buffered;
+    state.getBytes(_buffer, _buffered);
+
+    return true;
+}
\ No newline at end of file
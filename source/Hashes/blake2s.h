@@ -0,0 +1,555 @@
+/******************************************************************************
+||  blake2s.h                                                                ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    This abstract data type is used to calculate the BLAKE2s hash of an    ||
+||    input message or data stream, optionally keyed, and the BLAKE2sp       ||
+||    variant which splits the message over eight BLAKE2s leaves that are    ||
+||    hashed side by side (in the lanes of the AVX2 kernel or on separate    ||
+||    threads).  BLAKE2s works on 32-bit words, which suits 32-bit hosts     ||
+||    and short messages.                                                    ||
+||                                                                           ||
+||    The compression kernels are chosen at run time: an SSE4.1 kernel for   ||
+||    a single message, and an AVX2 kernel that advances all eight BLAKE2sp  ||
+||    leaves at once.                                                        ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    cpu_features.cpp (cpu_features.lib)                                    ||
+||    cpu_features.h                                                         ||
+||    hash_abstract.cpp (hash_abstract.lib)                                  ||
+||    hash_abstract.h                                                        ||
+||    pthread                                                                ||
+||                                                                           ||
+||===========================================================================||
+||  REFERENCES                                                               ||
+||===========================================================================||
+||    Saarinen, M-J. and Aumasson, J-P.  RFC 7693.  "The BLAKE2              ||
+||        Cryptographic Hash and Message Authentication Code (MAC)".  Nov    ||
+||        2015.                                                              ||
+||                                                                           ||
+||    Aumasson, J-P., Neves, S., Wilcox-O'Hearn, Z. and Winnerlein, C.       ||
+||        "BLAKE2: simpler, smaller, fast as MD5".  Jan 2013.                ||
+||        https://www.blake2.net/blake2.pdf                                  ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file blake2s.h
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+#ifndef _GH_BLAKE_2S_DEF_H
+#define _GH_BLAKE_2S_DEF_H
+
+#include "hash_abstract.h"
+
+/**
+ *  @class BLAKE2s An abstract data type to calculate and
+ *         manipulate BLAKE2s hashes.
+*/
+class BLAKE2s : public MessageHash
+{
+  public:
+    /******************************************************
+    **                     Constants                     **
+    ******************************************************/
+    static const uint32_t BLOCK_BYTES = 64;       // Bytes per compression.
+    static const uint32_t MAX_DIGEST_BYTES = 32;  // The longest digest.
+    static const uint32_t MAX_KEY_BYTES = 32;     // The longest key.
+
+    // The size of the read buffer used to hash files.
+    static const uint32_t FILE_BUFFER_BYTES = 65536;
+
+    /******************************************************
+    **            Constructors / Destructors             **
+    ******************************************************/
+
+    /** Default constructor (BLAKE2s-256).  */
+    BLAKE2s ();
+
+    /** Initialize a BLAKE2s object with a shorter digest.
+     *
+     *  @pre bits is a multiple of 32 between 32 and 256.
+     *  @post The object produces a digest of the given length (which
+     *        is a parameter of the hash, not a truncation).
+     *  @param bits The number of bits in the hash.
+    */
+    explicit BLAKE2s (uint32_t bits);
+
+    /** Copy constructor.
+     *
+     *  @pre none.
+     *  @post A new object is instantiated from the copied BLAKE2s object
+     *        including any partially processed message.
+     *  @param copyFrom The BLAKE2s object whose values are to be copied.
+    */
+    BLAKE2s (const BLAKE2s &copyFrom);
+
+    /** Initialize a BLAKE2s object by hashing an input std::string.
+     *
+     *  @pre none.
+     *  @post A new object is instantiated containing the
+     *        hashed value of the input data.
+     *  @param str The std::string that is to be hashed.
+    */
+    BLAKE2s (const string &str);
+
+    /** Initialize a BLAKE2s object by hashing an input data stream.
+     *
+     *  @pre none.
+     *  @post A new object is instantiated containing the
+     *        hashed value of the input data.
+     *  @param data The data that is to be hashed.
+    */
+    BLAKE2s (const vector < byte_t > &data);
+
+    /** Initialize a BLAKE2s object by hashing an input file stream.
+     *
+     *  @pre none.
+     *  @post A new object is instantiated containing the
+     *        hashed value of the input data.
+     *  @param file A handle to the file that is to be hashed.
+    */
+    BLAKE2s (ifstream &file);
+
+    /** Default destructor.  */
+    virtual ~BLAKE2s ();
+
+    /******************************************************
+    **               Accessors / Mutators                **
+    ******************************************************/
+
+    ////////////////////
+    //    Getters
+    ////////////////////
+
+    /** Retrieve the name of the algorithm.
+     *
+     *  @pre The object is instantiated.
+     *  @post none.
+     *  @return "BLAKE2s-" followed by the digest length in bits.
+    */
+    virtual string algorithmName (void) const;
+
+    /** Retrieve the name of the kernel that the host selected.
+     *
+     *  @pre The object is instantiated.
+     *  @post none.
+     *  @return "SSE4.1" or "portable".
+    */
+    virtual string kernelName (void) const;
+
+    /** Copy the object, including any partially processed message.
+     *
+     *  @pre none.
+     *  @post The caller owns (and must delete) the copy.
+     *  @return A new BLAKE2s object in the same state.
+    */
+    virtual BLAKE2s * clone (void) const;
+
+    ////////////////////
+    //    Setters
+    ////////////////////
+
+    /** Calculate the hash from an input std::string.
+     *
+     *  @pre The object is instantiated.
+     *  @post The computed hash is stored in the _hash values.
+     *  @param str The string whose value is to be hashed.
+     *  @return The hash as a std::string.
+    */
+    string calculateHash (const string &str);
+
+    /** Calculate the hash from an input data stream.
+     *
+     *  @pre The object is instantiated.
+     *  @post The computed hash is stored in the _hash values.
+     *  @param data The data that is to be hashed.
+     *  @return The hash as a std::string.
+    */
+    string calculateHash (const vector < byte_t > &data);
+
+    /** Calculate the hash of a file.
+     *
+     *  @pre The object is instantiated.
+     *  @post The computed hash is stored in the _hash values.
+     *  @param file The file whose hash value is to be calculated.
+     *  @return The hash as a std::string.
+    */
+    string calculateHash (ifstream &file);
+
+    /** Switch to the keyed hash (MAC) mode.
+     *
+     *  @pre length is no more than MAX_KEY_BYTES.
+     *  @post Any message data is discarded and later hashes are
+     *        keyed with the given key; a zero length removes the key.
+     *  @param key A pointer to the key.
+     *  @param length The number of bytes in the key.
+     *  @return none.
+    */
+    void setKey (const byte_t *key, uint32_t length);
+
+    /** Discard any message data and restart the hash.
+     *
+     *  @pre The object is instantiated.
+     *  @post The chaining values hold their initial values.
+     *  @return none.
+    */
+    virtual void reset (void);
+
+    /** Append message data to the hash.
+     *
+     *  @pre reset() has been called since the last finalize().
+     *  @post All but the last block of the data seen so far have
+     *        been compressed.
+     *  @param data A pointer to the message data.
+     *  @param length The number of bytes at data.
+     *  @return none.
+    */
+    virtual void update (const byte_t *data, uint64_t length);
+
+    /** Append message data to the hash.
+     *
+     *  @pre reset() has been called since the last finalize().
+     *  @post The message data has been absorbed.
+     *  @param data The message data.
+     *  @return none.
+    */
+    void update (const vector < byte_t > &data);
+
+    /** Compress the final block and produce the hash.
+     *
+     *  @pre reset() has been called since the last finalize().
+     *  @post The computed hash is stored in the _hash values.
+     *  @return The hash as a std::string.
+    */
+    virtual string finalize (void);
+
+    /******************************************************
+    **                     Operators                     **
+    ******************************************************/
+
+    /** Assignment from another BLAKE2s object.
+     *
+     *  @pre The object is instantiated.
+     *  @post The object contains the values copied from rhs.
+     *  @param rhs The BLAKE2s object whose values are to be copied/stored.
+     *  @return A reference to the object.
+    */
+    BLAKE2s & operator = (const BLAKE2s &rhs);
+
+  protected:
+    /******************************************************
+    **                      Members                      **
+    ******************************************************/
+    uint32_t _h[8];               // The chaining values.
+    uint64_t _counter;            // The message bytes compressed so far.
+    byte_t _block[BLOCK_BYTES];   // The last (uncompressed) block.
+    uint32_t _pending;            // The number of bytes in _block.
+
+    byte_t _key[MAX_KEY_BYTES];   // The MAC key (zero padded).
+    uint32_t _keyBytes;           // The key length; zero if not keyed.
+
+    // The tree hashing parameters of the node (sequential by default).
+    uint32_t _fanout;
+    uint32_t _depth;
+    uint32_t _nodeDepth;
+    uint32_t _innerBytes;
+    bool _lastNode;
+
+    uint32_t _fileBufferBytes;    // The read size used for files.
+
+    /******************************************************
+    **                   Helper Methods                  **
+    ******************************************************/
+
+    /** Set up the object as a node of a hash tree.
+     *
+     *  @pre none.
+     *  @post The parameter block describes the given tree node.
+     *  @param fanout The number of children of each node.
+     *  @param depth The number of levels in the tree.
+     *  @param nodeDepth The level of this node (zero for leaves).
+     *  @param innerBytes The digest length of the inner nodes.
+     *  @return none.
+    */
+    void _setTreeParameters (uint32_t fanout, uint32_t depth,
+                             uint32_t nodeDepth, uint32_t innerBytes);
+
+    /** Copy the chaining values into the _hash words.
+     *
+     *  @pre The final block has been compressed.
+     *  @post The _hash values hold the message digest.
+     *  @return none.
+    */
+    void _storeHash (void);
+
+    /** Append the algorithm specific part of the midstate.
+     *
+     *  @pre none.
+     *  @post The state is appended to state.
+     *  @param state The state that is being exported.
+     *  @return none.
+    */
+    virtual void _saveState (HashState &state) const;
+
+    /** Restore the algorithm specific part of the midstate.
+     *
+     *  @pre The common header of state has been read and checked.
+     *  @post The object holds the imported state.
+     *  @param state The state that is being imported.
+     *  @return true The values read are consistent.
+     *  @return false The state is corrupt.
+    */
+    virtual bool _loadState (HashState &state);
+
+};  // End class BLAKE2s.
+
+/**
+ *  @class BLAKE2sp An abstract data type to calculate and
+ *         manipulate BLAKE2sp hashes (eight BLAKE2s leaves
+ *         hashed in parallel under a BLAKE2s root).
+*/
+class BLAKE2sp : public BLAKE2s
+{
+  public:
+    /******************************************************
+    **                     Constants                     **
+    ******************************************************/
+    static const uint32_t LEAVES = 8;   // The number of leaves.
+
+    // The size of the read buffer used to hash files; large reads keep
+    // every worker thread busy.
+    static const uint32_t PARALLEL_BUFFER_BYTES = 4 * 1024 * 1024;
+
+    /******************************************************
+    **            Constructors / Destructors             **
+    ******************************************************/
+
+    /** Default constructor.  */
+    BLAKE2sp ();
+
+    /** Copy constructor.
+     *
+     *  @pre none.
+     *  @post A new object is instantiated from the copied BLAKE2sp object
+     *        including any partially processed message.
+     *  @param copyFrom The BLAKE2sp object whose values are to be copied.
+    */
+    BLAKE2sp (const BLAKE2sp &copyFrom);
+
+    /** Initialize a BLAKE2sp object by hashing an input std::string.
+     *
+     *  @pre none.
+     *  @post A new object is instantiated containing the
+     *        hashed value of the input data.
+     *  @param str The std::string that is to be hashed.
+    */
+    BLAKE2sp (const string &str);
+
+    /** Initialize a BLAKE2sp object by hashing an input data stream.
+     *
+     *  @pre none.
+     *  @post A new object is instantiated containing the
+     *        hashed value of the input data.
+     *  @param data The data that is to be hashed.
+    */
+    BLAKE2sp (const vector < byte_t > &data);
+
+    /** Initialize a BLAKE2sp object by hashing an input file stream.
+     *
+     *  @pre none.
+     *  @post A new object is instantiated containing the
+     *        hashed value of the input data.
+     *  @param file A handle to the file that is to be hashed.
+    */
+    BLAKE2sp (ifstream &file);
+
+    /** Default destructor.  */
+    ~BLAKE2sp ();
+
+    /******************************************************
+    **               Accessors / Mutators                **
+    ******************************************************/
+
+    ////////////////////
+    //    Getters
+    ////////////////////
+
+    /** Retrieve the name of the algorithm.
+     *
+     *  @pre The object is instantiated.
+     *  @post none.
+     *  @return "BLAKE2sp".
+    */
+    string algorithmName (void) const;
+
+    /** Retrieve the name of the kernel that the host selected.
+     *
+     *  @pre The object is instantiated.
+     *  @post none.
+     *  @return "AVX2 leaves" where the eight leaves are compressed together, otherwise the kernel of BLAKE2s.
+    */
+    string kernelName (void) const;
+
+    /** Copy the object, including any partially processed message.
+     *
+     *  @pre none.
+     *  @post The caller owns (and must delete) the copy.
+     *  @return A new BLAKE2sp object in the same state.
+    */
+    BLAKE2sp * clone (void) const;
+
+    ////////////////////
+    //    Setters
+    ////////////////////
+
+    /** Set the number of threads used to hash large inputs.
+     *
+     *  @pre The object is instantiated.
+     *  @post The leaves of later update() calls are spread over
+     *        at most the given number of threads.
+     *  @param threads The thread limit; zero selects one thread for
+     *         each online processor.
+     *  @return none.
+    */
+    void setThreads (uint32_t threads);
+
+    /** Discard any message data and restart the hash.
+     *
+     *  @pre The object is instantiated.
+     *  @post The leaves and the root hold their initial values.
+     *  @return none.
+    */
+    void reset (void);
+
+    /** Append message data to the hash.
+     *
+     *  @pre reset() has been called since the last finalize().
+     *  @post Each leaf has compressed every block of the data seen so
+     *        far except the blocks that might still be its last.
+     *  @param data A pointer to the message data.
+     *  @param length The number of bytes at data.
+     *  @return none.
+    */
+    void update (const byte_t *data, uint64_t length);
+    using BLAKE2s::update;
+
+    /** Finish the leaves, hash their digests in the root and produce
+     *  the hash.
+     *
+     *  @pre reset() has been called since the last finalize().
+     *  @post The computed hash is stored in the _hash values.
+     *  @return The hash as a std::string.
+    */
+    string finalize (void);
+
+    /******************************************************
+    **                     Operators                     **
+    ******************************************************/
+
+    /** Assignment from another BLAKE2sp object.
+     *
+     *  @pre The object is instantiated.
+     *  @post The object contains the values copied from rhs.
+     *  @param rhs The BLAKE2sp object whose values are to be copied/stored.
+     *  @return A reference to the object.
+    */
+    BLAKE2sp & operator = (const BLAKE2sp &rhs);
+
+  protected:
+    /******************************************************
+    **                     Constants                     **
+    ******************************************************/
+
+    // The leaves take the message blocks in turn, one "superblock" of
+    // LEAVES blocks at a time.
+    static const uint32_t SUPERBLOCK_BYTES = LEAVES * BLOCK_BYTES;
+
+    // A superblock can only be compressed once every leaf is known to
+    // have another block after it, i.e. once more than this many bytes
+    // are available from the start of the superblock.
+    static const uint32_t HOLD_BYTES = SUPERBLOCK_BYTES
+                                       + ((LEAVES - 1) * BLOCK_BYTES);
+
+    /******************************************************
+    **                      Members                      **
+    ******************************************************/
+    uint32_t _leaves[LEAVES][8];   // The chaining values of each leaf.
+    uint64_t _leafBytes;           // The bytes compressed by each leaf.
+    bool _keyPending;              // The key blocks are not compressed.
+
+    byte_t _buffer[2 * SUPERBLOCK_BYTES];  // Data held back from the leaves.
+    uint32_t _buffered;                    // The number of bytes held.
+
+    uint32_t _threads;             // The most threads that update() uses.
+
+    /******************************************************
+    **                   Helper Methods                  **
+    ******************************************************/
+
+    /** Compress whole superblocks into the leaves.
+     *
+     *  @pre Every leaf has at least one more block after them.
+     *  @post Each leaf has compressed its block of each superblock.
+     *  @param superblocks A pointer to the first superblock.
+     *  @param count The number of consecutive superblocks.
+     *  @return none.
+    */
+    void _compressLeaves (const byte_t *superblocks, uint64_t count);
+
+    /** Append the algorithm specific part of the midstate.
+     *
+     *  @pre none.
+     *  @post The state is appended to state.
+     *  @param state The state that is being exported.
+     *  @return none.
+    */
+    void _saveState (HashState &state) const;
+
+    /** Restore the algorithm specific part of the midstate.
+     *
+     *  @pre The common header of state has been read and checked.
+     *  @post The object holds the imported state.
+     *  @param state The state that is being imported.
+     *  @return true The values read are consistent.
+     *  @return false The state is corrupt.
+    */
+    bool _loadState (HashState &state);
+
+};  // End class BLAKE2sp.
+
+#endif
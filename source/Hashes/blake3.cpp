@@ -0,0 +1,1723 @@
+/******************************************************************************
+||  blake3.cpp                                                               ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    An implementation of the BLAKE3 cryptographic hash.  The message is    ||
+||    split into 1 KiB chunks that form the leaves of a binary hash tree, so ||
+||    whole subtrees can be compressed many chunks at a time by the SSE4.1,  ||
+||    AVX2 or AVX-512 kernels and large inputs can be spread over several    ||
+||    threads.                                                               ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    cpu_features.cpp (cpu_features.lib)                                    ||
+||    cpu_features.h                                                         ||
+||    hash_abstract.cpp (hash_abstract.lib)                                  ||
+||    hash_abstract.h                                                        ||
+||    pthread                                                                ||
+||                                                                           ||
+||===========================================================================||
+||  REFERENCES                                                               ||
+||===========================================================================||
+||    O'Connor, J., Aumasson, J.-P., Neves, S. and Wilcox-O'Hearn, Z.        ||
+||        "BLAKE3: One function, fast everywhere".  9 Jan 2020.              ||
+||        https://github.com/BLAKE3-team/BLAKE3-specs                        ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file blake3.cpp
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "blake3.h"
+#include "hash_state.h"
+#include "cpu_features.h"
+
+#ifdef GASH_X86_SIMD
+  #include <immintrin.h>
+#endif
+
+const uint32_t BLAKE3::BLOCK_BYTES;
+const uint32_t BLAKE3::CHUNK_BYTES;
+const uint32_t BLAKE3::KEY_BYTES;
+const uint32_t BLAKE3::FILE_BUFFER_BYTES;
+const uint32_t BLAKE3::MAX_STACK_DEPTH;
+
+// BLAKE3 reuses the SHA-256 initial hash values.
+static const uint32_t IV3[8] =
+{
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+// The message word order of each of the seven rounds (the message
+// permutation applied round after round).
+static const uint8_t MSG_SCHEDULE[7][16] =
+{
+    {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+    {  2,  6,  3, 10,  7,  0,  4, 13,  1, 11, 12,  5,  9, 14, 15,  8 },
+    {  3,  4, 10, 12, 13,  2,  7, 14,  6,  5,  9,  0, 11, 15,  8,  1 },
+    { 10,  7, 12,  9, 14,  3, 13, 15,  4,  0, 11,  2,  5,  8,  1,  6 },
+    { 12, 13,  9, 11, 15, 10, 14,  8,  7,  2,  5,  3,  0,  1,  6,  4 },
+    {  9, 14, 11,  5,  8, 12, 15,  1, 13,  3,  0, 10,  2,  6,  4,  7 },
+    { 11, 15,  5,  0,  1,  9,  8,  6, 14, 10,  2, 12,  3,  4,  7, 13 }
+};
+
+// The domain separation flags of the compression function.
+enum
+{
+    CHUNK_START = 0x01,
+    CHUNK_END   = 0x02,
+    PARENT      = 0x04,
+    ROOT        = 0x08,
+    KEYED_HASH  = 0x10
+};
+
+// The most inputs that any kernel compresses at once (AVX-512).
+static const uint32_t MAX_SIMD_DEGREE = 16;
+
+// Subtrees smaller than this are not worth handing to another thread.
+static const uint64_t MIN_THREAD_BYTES = 256 * 1024;
+
+/** The inputs of the last compression of a chunk or parent node.  Its
+ *  compression gives either the node's chaining value or, with the ROOT
+ *  flag, the hash itself.
+*/
+struct Blake3Output
+{
+    uint32_t cv[8];
+    byte_t block[64];
+    uint32_t blockLength;
+    uint64_t counter;
+    uint32_t flags;
+};
+
+/******************************************************
+**                 Compression Kernels               **
+******************************************************/
+
+// A kernel hashes count equally spaced inputs of the same number of
+// blocks, each from the key, and writes one 32 byte chaining value per
+// input.  The chunk counter advances by counterStep from one input to the
+// next (one for chunks, zero for parent nodes).
+typedef void (*Blake3Kernel)(const byte_t *inputs, uint64_t stride,
+                             uint32_t count, uint32_t blocks,
+                             const uint32_t key[8], uint64_t counter,
+                             uint32_t counterStep, uint32_t flags,
+                             uint32_t flagsStart, uint32_t flagsEnd,
+                             byte_t *out);
+
+static inline uint32_t rotr32 (uint32_t x, uint32_t n)
+{  return ((x >> n) | (x << (32 - n)));  }
+
+static inline uint32_t loadLittleEndian32 (const byte_t *p)
+{
+    return   ((uint32_t)p[0]      ) | ((uint32_t)p[1] <<  8)
+           | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void storeLittleEndian32 (byte_t *p, uint32_t x)
+{
+    p[0] = (byte_t)(x      );
+    p[1] = (byte_t)(x >>  8);
+    p[2] = (byte_t)(x >> 16);
+    p[3] = (byte_t)(x >> 24);
+}
+
+/** The quarter-round mixing function.  */
+static GASH_ALWAYS_INLINE void
+blake3G (uint32_t v[16], uint32_t a, uint32_t b, uint32_t c, uint32_t d,
+         uint32_t mx, uint32_t my)
+{
+    v[a] = v[a] + v[b] + mx;
+    v[d] = rotr32(v[d] ^ v[a], 16);
+    v[c] = v[c] + v[d];
+    v[b] = rotr32(v[b] ^ v[c], 12);
+    v[a] = v[a] + v[b] + my;
+    v[d] = rotr32(v[d] ^ v[a], 8);
+    v[c] = v[c] + v[d];
+    v[b] = rotr32(v[b] ^ v[c], 7);
+}
+
+/** One round: mix the columns and then the diagonals.  */
+static GASH_ALWAYS_INLINE void
+blake3Round (uint32_t v[16], const uint32_t m[16], uint32_t r)
+{
+    const uint8_t *s = MSG_SCHEDULE[r];
+
+    blake3G(v, 0, 4,  8, 12, m[s[ 0]], m[s[ 1]]);
+    blake3G(v, 1, 5,  9, 13, m[s[ 2]], m[s[ 3]]);
+    blake3G(v, 2, 6, 10, 14, m[s[ 4]], m[s[ 5]]);
+    blake3G(v, 3, 7, 11, 15, m[s[ 6]], m[s[ 7]]);
+
+    blake3G(v, 0, 5, 10, 15, m[s[ 8]], m[s[ 9]]);
+    blake3G(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+    blake3G(v, 2, 7,  8, 13, m[s[12]], m[s[13]]);
+    blake3G(v, 3, 4,  9, 14, m[s[14]], m[s[15]]);
+}
+
+/** The compression function.  The first eight output words are the new
+ *  chaining value; all sixteen are output bytes of a root node.
+*/
+static void blake3Compress (const uint32_t cv[8], const byte_t block[64],
+                            uint32_t blockLength, uint64_t counter,
+                            uint32_t flags, uint32_t out[16])
+{
+    uint32_t m[16], v[16];
+
+    for (uint32_t i = 0; i < 16; ++i)
+        m[i] = loadLittleEndian32(block + (i * 4));
+
+    for (uint32_t i = 0; i < 8; ++i)
+        v[i] = cv[i];
+
+    v[ 8] = IV3[0];
+    v[ 9] = IV3[1];
+    v[10] = IV3[2];
+    v[11] = IV3[3];
+    v[12] = (uint32_t)counter;
+    v[13] = (uint32_t)(counter >> 32);
+    v[14] = blockLength;
+    v[15] = flags;
+
+    for (uint32_t r = 0; r < 7; ++r)
+        blake3Round(v, m, r);
+
+    for (uint32_t i = 0; i < 8; ++i)
+    {
+        out[i] = v[i] ^ v[i + 8];
+        out[i + 8] = v[i + 8] ^ cv[i];
+    }
+}
+
+/** The portable kernel: one input at a time.  */
+static void blake3HashManyPortable (const byte_t *inputs, uint64_t stride,
+                                    uint32_t count, uint32_t blocks,
+                                    const uint32_t key[8], uint64_t counter,
+                                    uint32_t counterStep, uint32_t flags,
+                                    uint32_t flagsStart, uint32_t flagsEnd,
+                                    byte_t *out)
+{
+    uint32_t cv[8], words[16];
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        memcpy(cv, key, sizeof(cv));
+
+        for (uint32_t b = 0; b < blocks; ++b)
+        {
+            uint32_t blockFlags = flags;
+            if (b == 0)
+                blockFlags |= flagsStart;
+            if (b == blocks - 1)
+                blockFlags |= flagsEnd;
+
+            blake3Compress(cv, inputs + (b * 64), 64, counter, blockFlags,
+                           words);
+            memcpy(cv, words, sizeof(cv));
+        }
+
+        for (uint32_t j = 0; j < 8; ++j)
+            storeLittleEndian32(out + (j * 4), cv[j]);
+
+        inputs += stride;
+        counter += counterStep;
+        out += 32;
+    }
+}
+
+#ifdef GASH_X86_SIMD
+
+// The SIMD kernels hold word i of the state of every input in vector i
+// (one input per 32-bit lane), so the message blocks are transposed on
+// the way in and the chaining values on the way out.
+
+/** Split the chunk counters of consecutive inputs into low and high
+ *  words.
+*/
+static inline void laneCounters (uint64_t counter, uint32_t counterStep,
+                                 uint32_t lanes, uint32_t *low,
+                                 uint32_t *high)
+{
+    for (uint32_t i = 0; i < lanes; ++i)
+    {
+        uint64_t c = counter + ((uint64_t)i * counterStep);
+        low[i] = (uint32_t)c;
+        high[i] = (uint32_t)(c >> 32);
+    }
+}
+
+__attribute__((target("sse4.1")))
+static GASH_ALWAYS_INLINE __m128i rotr32x4 (__m128i x, int n)
+{
+    // Rotations by whole bytes are a single byte shuffle.
+    if (n == 16)
+        return _mm_shuffle_epi8(x, _mm_set_epi8(13, 12, 15, 14,  9,  8, 11, 10,
+                                                 5,  4,  7,  6,  1,  0,  3,  2));
+    if (n == 8)
+        return _mm_shuffle_epi8(x, _mm_set_epi8(12, 15, 14, 13,  8, 11, 10,  9,
+                                                 4,  7,  6,  5,  0,  3,  2,  1));
+
+    return _mm_or_si128(_mm_srli_epi32(x, n), _mm_slli_epi32(x, 32 - n));
+}
+
+__attribute__((target("sse4.1")))
+static GASH_ALWAYS_INLINE void
+blake3G4 (__m128i v[16], uint32_t a, uint32_t b, uint32_t c, uint32_t d,
+          __m128i mx, __m128i my)
+{
+    v[a] = _mm_add_epi32(_mm_add_epi32(v[a], v[b]), mx);
+    v[d] = rotr32x4(_mm_xor_si128(v[d], v[a]), 16);
+    v[c] = _mm_add_epi32(v[c], v[d]);
+    v[b] = rotr32x4(_mm_xor_si128(v[b], v[c]), 12);
+    v[a] = _mm_add_epi32(_mm_add_epi32(v[a], v[b]), my);
+    v[d] = rotr32x4(_mm_xor_si128(v[d], v[a]), 8);
+    v[c] = _mm_add_epi32(v[c], v[d]);
+    v[b] = rotr32x4(_mm_xor_si128(v[b], v[c]), 7);
+}
+
+__attribute__((target("sse4.1")))
+static GASH_ALWAYS_INLINE void
+blake3Round4 (__m128i v[16], const __m128i m[16], uint32_t r)
+{
+    const uint8_t *s = MSG_SCHEDULE[r];
+
+    blake3G4(v, 0, 4,  8, 12, m[s[ 0]], m[s[ 1]]);
+    blake3G4(v, 1, 5,  9, 13, m[s[ 2]], m[s[ 3]]);
+    blake3G4(v, 2, 6, 10, 14, m[s[ 4]], m[s[ 5]]);
+    blake3G4(v, 3, 7, 11, 15, m[s[ 6]], m[s[ 7]]);
+
+    blake3G4(v, 0, 5, 10, 15, m[s[ 8]], m[s[ 9]]);
+    blake3G4(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+    blake3G4(v, 2, 7,  8, 13, m[s[12]], m[s[13]]);
+    blake3G4(v, 3, 4,  9, 14, m[s[14]], m[s[15]]);
+}
+
+/** Transpose a 4x4 matrix of 32-bit words.  */
+__attribute__((target("sse4.1")))
+static GASH_ALWAYS_INLINE void transpose4x4 (__m128i x[4])
+{
+    __m128i ab01 = _mm_unpacklo_epi32(x[0], x[1]);
+    __m128i ab23 = _mm_unpackhi_epi32(x[0], x[1]);
+    __m128i cd01 = _mm_unpacklo_epi32(x[2], x[3]);
+    __m128i cd23 = _mm_unpackhi_epi32(x[2], x[3]);
+
+    x[0] = _mm_unpacklo_epi64(ab01, cd01);
+    x[1] = _mm_unpackhi_epi64(ab01, cd01);
+    x[2] = _mm_unpacklo_epi64(ab23, cd23);
+    x[3] = _mm_unpackhi_epi64(ab23, cd23);
+}
+
+/** Hash four inputs at once.  */
+__attribute__((target("sse4.1")))
+static void blake3Hash4 (const byte_t *inputs, uint64_t stride,
+                         uint32_t blocks, const uint32_t key[8],
+                         uint64_t counter, uint32_t counterStep,
+                         uint32_t flags, uint32_t flagsStart,
+                         uint32_t flagsEnd, byte_t *out)
+{
+    uint32_t low[4], high[4];
+    laneCounters(counter, counterStep, 4, low, high);
+
+    const __m128i counterLow = _mm_loadu_si128((const __m128i *)low);
+    const __m128i counterHigh = _mm_loadu_si128((const __m128i *)high);
+
+    __m128i h[8], m[16], v[16];
+
+    for (uint32_t i = 0; i < 8; ++i)
+        h[i] = _mm_set1_epi32((int)key[i]);
+
+    for (uint32_t b = 0; b < blocks; ++b)
+    {
+        uint32_t blockFlags = flags;
+        if (b == 0)
+            blockFlags |= flagsStart;
+        if (b == blocks - 1)
+            blockFlags |= flagsEnd;
+
+        // Row j of each 4x4 tile is four message words of input j.
+        for (uint32_t q = 0; q < 4; ++q)
+        {
+            for (uint32_t j = 0; j < 4; ++j)
+                m[(q * 4) + j] = _mm_loadu_si128((const __m128i *)
+                                   (inputs + (j * stride) + (b * 64) + (q * 16)));
+
+            transpose4x4(m + (q * 4));
+        }
+
+        for (uint32_t i = 0; i < 8; ++i)
+            v[i] = h[i];
+
+        v[ 8] = _mm_set1_epi32((int)IV3[0]);
+        v[ 9] = _mm_set1_epi32((int)IV3[1]);
+        v[10] = _mm_set1_epi32((int)IV3[2]);
+        v[11] = _mm_set1_epi32((int)IV3[3]);
+        v[12] = counterLow;
+        v[13] = counterHigh;
+        v[14] = _mm_set1_epi32(64);
+        v[15] = _mm_set1_epi32((int)blockFlags);
+
+        for (uint32_t r = 0; r < 7; ++r)
+            blake3Round4(v, m, r);
+
+        for (uint32_t i = 0; i < 8; ++i)
+            h[i] = _mm_xor_si128(v[i], v[i + 8]);
+    }
+
+    transpose4x4(h);
+    transpose4x4(h + 4);
+
+    for (uint32_t j = 0; j < 4; ++j)
+    {
+        _mm_storeu_si128((__m128i *)(out + (j * 32)), h[j]);
+        _mm_storeu_si128((__m128i *)(out + (j * 32) + 16), h[j + 4]);
+    }
+}
+
+/** The SSE4.1 kernel: groups of four inputs.  */
+__attribute__((target("sse4.1")))
+static void blake3HashManySSE41 (const byte_t *inputs, uint64_t stride,
+                                 uint32_t count, uint32_t blocks,
+                                 const uint32_t key[8], uint64_t counter,
+                                 uint32_t counterStep, uint32_t flags,
+                                 uint32_t flagsStart, uint32_t flagsEnd,
+                                 byte_t *out)
+{
+    for (; count >= 4; count -= 4)
+    {
+        blake3Hash4(inputs, stride, blocks, key, counter, counterStep,
+                    flags, flagsStart, flagsEnd, out);
+
+        inputs += 4 * stride;
+        counter += 4 * counterStep;
+        out += 4 * 32;
+    }
+
+    blake3HashManyPortable(inputs, stride, count, blocks, key, counter,
+                           counterStep, flags, flagsStart, flagsEnd, out);
+}
+
+__attribute__((target("avx2")))
+static GASH_ALWAYS_INLINE __m256i rotr32x8 (__m256i x, int n)
+{
+    if (n == 16)
+        return _mm256_shuffle_epi8(x, _mm256_set_epi8(
+                   13, 12, 15, 14,  9,  8, 11, 10,  5,  4,  7,  6,  1,  0,  3,  2,
+                   13, 12, 15, 14,  9,  8, 11, 10,  5,  4,  7,  6,  1,  0,  3,  2));
+    if (n == 8)
+        return _mm256_shuffle_epi8(x, _mm256_set_epi8(
+                   12, 15, 14, 13,  8, 11, 10,  9,  4,  7,  6,  5,  0,  3,  2,  1,
+                   12, 15, 14, 13,  8, 11, 10,  9,  4,  7,  6,  5,  0,  3,  2,  1));
+
+    return _mm256_or_si256(_mm256_srli_epi32(x, n),
+                           _mm256_slli_epi32(x, 32 - n));
+}
+
+__attribute__((target("avx2")))
+static GASH_ALWAYS_INLINE void
+blake3G8 (__m256i v[16], uint32_t a, uint32_t b, uint32_t c, uint32_t d,
+          __m256i mx, __m256i my)
+{
+    v[a] = _mm256_add_epi32(_mm256_add_epi32(v[a], v[b]), mx);
+    v[d] = rotr32x8(_mm256_xor_si256(v[d], v[a]), 16);
+    v[c] = _mm256_add_epi32(v[c], v[d]);
+    v[b] = rotr32x8(_mm256_xor_si256(v[b], v[c]), 12);
+    v[a] = _mm256_add_epi32(_mm256_add_epi32(v[a], v[b]), my);
+    v[d] = rotr32x8(_mm256_xor_si256(v[d], v[a]), 8);
+    v[c] = _mm256_add_epi32(v[c], v[d]);
+    v[b] = rotr32x8(_mm256_xor_si256(v[b], v[c]), 7);
+}
+
+__attribute__((target("avx2")))
+static GASH_ALWAYS_INLINE void
+blake3Round8 (__m256i v[16], const __m256i m[16], uint32_t r)
+{
+    const uint8_t *s = MSG_SCHEDULE[r];
+
+    blake3G8(v, 0, 4,  8, 12, m[s[ 0]], m[s[ 1]]);
+    blake3G8(v, 1, 5,  9, 13, m[s[ 2]], m[s[ 3]]);
+    blake3G8(v, 2, 6, 10, 14, m[s[ 4]], m[s[ 5]]);
+    blake3G8(v, 3, 7, 11, 15, m[s[ 6]], m[s[ 7]]);
+
+    blake3G8(v, 0, 5, 10, 15, m[s[ 8]], m[s[ 9]]);
+    blake3G8(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+    blake3G8(v, 2, 7,  8, 13, m[s[12]], m[s[13]]);
+    blake3G8(v, 3, 4,  9, 14, m[s[14]], m[s[15]]);
+}
+
+/** Transpose an 8x8 matrix of 32-bit words.  */
+__attribute__((target("avx2")))
+static GASH_ALWAYS_INLINE void transpose8x8 (__m256i x[8])
+{
+    // Interleave the words, then the word pairs, within each 128-bit
+    // lane; the lanes are exchanged last.
+    __m256i ab0145 = _mm256_unpacklo_epi32(x[0], x[1]);
+    __m256i ab2367 = _mm256_unpackhi_epi32(x[0], x[1]);
+    __m256i cd0145 = _mm256_unpacklo_epi32(x[2], x[3]);
+    __m256i cd2367 = _mm256_unpackhi_epi32(x[2], x[3]);
+    __m256i ef0145 = _mm256_unpacklo_epi32(x[4], x[5]);
+    __m256i ef2367 = _mm256_unpackhi_epi32(x[4], x[5]);
+    __m256i gh0145 = _mm256_unpacklo_epi32(x[6], x[7]);
+    __m256i gh2367 = _mm256_unpackhi_epi32(x[6], x[7]);
+
+    __m256i abcd04 = _mm256_unpacklo_epi64(ab0145, cd0145);
+    __m256i abcd15 = _mm256_unpackhi_epi64(ab0145, cd0145);
+    __m256i abcd26 = _mm256_unpacklo_epi64(ab2367, cd2367);
+    __m256i abcd37 = _mm256_unpackhi_epi64(ab2367, cd2367);
+    __m256i efgh04 = _mm256_unpacklo_epi64(ef0145, gh0145);
+    __m256i efgh15 = _mm256_unpackhi_epi64(ef0145, gh0145);
+    __m256i efgh26 = _mm256_unpacklo_epi64(ef2367, gh2367);
+    __m256i efgh37 = _mm256_unpackhi_epi64(ef2367, gh2367);
+
+    x[0] = _mm256_permute2x128_si256(abcd04, efgh04, 0x20);
+    x[1] = _mm256_permute2x128_si256(abcd15, efgh15, 0x20);
+    x[2] = _mm256_permute2x128_si256(abcd26, efgh26, 0x20);
+    x[3] = _mm256_permute2x128_si256(abcd37, efgh37, 0x20);
+    x[4] = _mm256_permute2x128_si256(abcd04, efgh04, 0x31);
+    x[5] = _mm256_permute2x128_si256(abcd15, efgh15, 0x31);
+    x[6] = _mm256_permute2x128_si256(abcd26, efgh26, 0x31);
+    x[7] = _mm256_permute2x128_si256(abcd37, efgh37, 0x31);
+}
+
+/** Hash eight inputs at once.  */
+__attribute__((target("avx2")))
+static void blake3Hash8 (const byte_t *inputs, uint64_t stride,
+                         uint32_t blocks, const uint32_t key[8],
+                         uint64_t counter, uint32_t counterStep,
+                         uint32_t flags, uint32_t flagsStart,
+                         uint32_t flagsEnd, byte_t *out)
+{
+    uint32_t low[8], high[8];
+    laneCounters(counter, counterStep, 8, low, high);
+
+    const __m256i counterLow = _mm256_loadu_si256((const __m256i *)low);
+    const __m256i counterHigh = _mm256_loadu_si256((const __m256i *)high);
+
+    __m256i h[8], m[16], v[16];
+
+    for (uint32_t i = 0; i < 8; ++i)
+        h[i] = _mm256_set1_epi32((int)key[i]);
+
+    for (uint32_t b = 0; b < blocks; ++b)
+    {
+        uint32_t blockFlags = flags;
+        if (b == 0)
+            blockFlags |= flagsStart;
+        if (b == blocks - 1)
+            blockFlags |= flagsEnd;
+
+        for (uint32_t q = 0; q < 2; ++q)
+        {
+            for (uint32_t j = 0; j < 8; ++j)
+                m[(q * 8) + j] = _mm256_loadu_si256((const __m256i *)
+                                   (inputs + (j * stride) + (b * 64) + (q * 32)));
+
+            transpose8x8(m + (q * 8));
+        }
+
+        for (uint32_t i = 0; i < 8; ++i)
+            v[i] = h[i];
+
+        v[ 8] = _mm256_set1_epi32((int)IV3[0]);
+        v[ 9] = _mm256_set1_epi32((int)IV3[1]);
+        v[10] = _mm256_set1_epi32((int)IV3[2]);
+        v[11] = _mm256_set1_epi32((int)IV3[3]);
+        v[12] = counterLow;
+        v[13] = counterHigh;
+        v[14] = _mm256_set1_epi32(64);
+        v[15] = _mm256_set1_epi32((int)blockFlags);
+
+        for (uint32_t r = 0; r < 7; ++r)
+            blake3Round8(v, m, r);
+
+        for (uint32_t i = 0; i < 8; ++i)
+            h[i] = _mm256_xor_si256(v[i], v[i + 8]);
+    }
+
+    transpose8x8(h);
+
+    for (uint32_t j = 0; j < 8; ++j)
+        _mm256_storeu_si256((__m256i *)(out + (j * 32)), h[j]);
+}
+
+/** The AVX2 kernel: groups of eight inputs.  */
+__attribute__((target("avx2")))
+static void blake3HashManyAVX2 (const byte_t *inputs, uint64_t stride,
+                                uint32_t count, uint32_t blocks,
+                                const uint32_t key[8], uint64_t counter,
+                                uint32_t counterStep, uint32_t flags,
+                                uint32_t flagsStart, uint32_t flagsEnd,
+                                byte_t *out)
+{
+    for (; count >= 8; count -= 8)
+    {
+        blake3Hash8(inputs, stride, blocks, key, counter, counterStep,
+                    flags, flagsStart, flagsEnd, out);
+
+        inputs += 8 * stride;
+        counter += 8 * counterStep;
+        out += 8 * 32;
+    }
+
+    blake3HashManySSE41(inputs, stride, count, blocks, key, counter,
+                        counterStep, flags, flagsStart, flagsEnd, out);
+}
+
+__attribute__((target("avx512f")))
+static GASH_ALWAYS_INLINE void
+blake3G16 (__m512i v[16], uint32_t a, uint32_t b, uint32_t c, uint32_t d,
+           __m512i mx, __m512i my)
+{
+    v[a] = _mm512_add_epi32(_mm512_add_epi32(v[a], v[b]), mx);
+    v[d] = _mm512_ror_epi32(_mm512_xor_si512(v[d], v[a]), 16);
+    v[c] = _mm512_add_epi32(v[c], v[d]);
+    v[b] = _mm512_ror_epi32(_mm512_xor_si512(v[b], v[c]), 12);
+    v[a] = _mm512_add_epi32(_mm512_add_epi32(v[a], v[b]), my);
+    v[d] = _mm512_ror_epi32(_mm512_xor_si512(v[d], v[a]), 8);
+    v[c] = _mm512_add_epi32(v[c], v[d]);
+    v[b] = _mm512_ror_epi32(_mm512_xor_si512(v[b], v[c]), 7);
+}
+
+__attribute__((target("avx512f")))
+static GASH_ALWAYS_INLINE void
+blake3Round16 (__m512i v[16], const __m512i m[16], uint32_t r)
+{
+    const uint8_t *s = MSG_SCHEDULE[r];
+
+    blake3G16(v, 0, 4,  8, 12, m[s[ 0]], m[s[ 1]]);
+    blake3G16(v, 1, 5,  9, 13, m[s[ 2]], m[s[ 3]]);
+    blake3G16(v, 2, 6, 10, 14, m[s[ 4]], m[s[ 5]]);
+    blake3G16(v, 3, 7, 11, 15, m[s[ 6]], m[s[ 7]]);
+
+    blake3G16(v, 0, 5, 10, 15, m[s[ 8]], m[s[ 9]]);
+    blake3G16(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+    blake3G16(v, 2, 7,  8, 13, m[s[12]], m[s[13]]);
+    blake3G16(v, 3, 4,  9, 14, m[s[14]], m[s[15]]);
+}
+
+/** Transpose a 16x16 matrix of 32-bit words.  */
+__attribute__((target("avx512f")))
+static GASH_ALWAYS_INLINE void transpose16x16 (__m512i x[16])
+{
+    __m512i t[16];
+
+    // Interleave the words and then the word pairs within each 128-bit
+    // lane, so that t[4k + j] holds word j of rows 4k..4k+3 in each lane.
+    for (uint32_t k = 0; k < 4; ++k)
+    {
+        __m512i lo01 = _mm512_unpacklo_epi32(x[4 * k], x[(4 * k) + 1]);
+        __m512i hi01 = _mm512_unpackhi_epi32(x[4 * k], x[(4 * k) + 1]);
+        __m512i lo23 = _mm512_unpacklo_epi32(x[(4 * k) + 2], x[(4 * k) + 3]);
+        __m512i hi23 = _mm512_unpackhi_epi32(x[(4 * k) + 2], x[(4 * k) + 3]);
+
+        t[(4 * k)    ] = _mm512_unpacklo_epi64(lo01, lo23);
+        t[(4 * k) + 1] = _mm512_unpackhi_epi64(lo01, lo23);
+        t[(4 * k) + 2] = _mm512_unpacklo_epi64(hi01, hi23);
+        t[(4 * k) + 3] = _mm512_unpackhi_epi64(hi01, hi23);
+    }
+
+    // Then exchange the 128-bit lanes in two steps: 0x88 gathers the even
+    // lanes of both operands and 0xdd the odd lanes.
+    __m512i u[16];
+
+    for (uint32_t j = 0; j < 4; ++j)
+    {
+        u[j     ] = _mm512_shuffle_i32x4(t[j], t[j + 4], 0x88);
+        u[j +  4] = _mm512_shuffle_i32x4(t[j], t[j + 4], 0xdd);
+        u[j +  8] = _mm512_shuffle_i32x4(t[j + 8], t[j + 12], 0x88);
+        u[j + 12] = _mm512_shuffle_i32x4(t[j + 8], t[j + 12], 0xdd);
+    }
+
+    for (uint32_t j = 0; j < 8; ++j)
+    {
+        x[j    ] = _mm512_shuffle_i32x4(u[j], u[j + 8], 0x88);
+        x[j + 8] = _mm512_shuffle_i32x4(u[j], u[j + 8], 0xdd);
+    }
+}
+
+/** Hash sixteen inputs at once.  */
+__attribute__((target("avx512f")))
+static void blake3Hash16 (const byte_t *inputs, uint64_t stride,
+                          uint32_t blocks, const uint32_t key[8],
+                          uint64_t counter, uint32_t counterStep,
+                          uint32_t flags, uint32_t flagsStart,
+                          uint32_t flagsEnd, byte_t *out)
+{
+    uint32_t low[16], high[16];
+    laneCounters(counter, counterStep, 16, low, high);
+
+    const __m512i counterLow = _mm512_loadu_si512(low);
+    const __m512i counterHigh = _mm512_loadu_si512(high);
+
+    __m512i h[16], m[16], v[16];
+
+    for (uint32_t i = 0; i < 8; ++i)
+        h[i] = _mm512_set1_epi32((int)key[i]);
+
+    for (uint32_t b = 0; b < blocks; ++b)
+    {
+        uint32_t blockFlags = flags;
+        if (b == 0)
+            blockFlags |= flagsStart;
+        if (b == blocks - 1)
+            blockFlags |= flagsEnd;
+
+        for (uint32_t j = 0; j < 16; ++j)
+            m[j] = _mm512_loadu_si512(inputs + (j * stride) + (b * 64));
+
+        transpose16x16(m);
+
+        for (uint32_t i = 0; i < 8; ++i)
+            v[i] = h[i];
+
+        v[ 8] = _mm512_set1_epi32((int)IV3[0]);
+        v[ 9] = _mm512_set1_epi32((int)IV3[1]);
+        v[10] = _mm512_set1_epi32((int)IV3[2]);
+        v[11] = _mm512_set1_epi32((int)IV3[3]);
+        v[12] = counterLow;
+        v[13] = counterHigh;
+        v[14] = _mm512_set1_epi32(64);
+        v[15] = _mm512_set1_epi32((int)blockFlags);
+
+        for (uint32_t r = 0; r < 7; ++r)
+            blake3Round16(v, m, r);
+
+        for (uint32_t i = 0; i < 8; ++i)
+            h[i] = _mm512_xor_si512(v[i], v[i + 8]);
+    }
+
+    // Only the first eight words of each transposed row are the chaining
+    // value; the rest of the matrix is padding.
+    for (uint32_t i = 8; i < 16; ++i)
+        h[i] = _mm512_setzero_si512();
+
+    transpose16x16(h);
+
+    for (uint32_t j = 0; j < 16; ++j)
+        _mm256_storeu_si256((__m256i *)(out + (j * 32)),
+                            _mm512_castsi512_si256(h[j]));
+}
+
+/** The AVX-512 kernel: groups of sixteen inputs.  */
+__attribute__((target("avx512f")))
+static void blake3HashManyAVX512 (const byte_t *inputs, uint64_t stride,
+                                  uint32_t count, uint32_t blocks,
+                                  const uint32_t key[8], uint64_t counter,
+                                  uint32_t counterStep, uint32_t flags,
+                                  uint32_t flagsStart, uint32_t flagsEnd,
+                                  byte_t *out)
+{
+    for (; count >= 16; count -= 16)
+    {
+        blake3Hash16(inputs, stride, blocks, key, counter, counterStep,
+                     flags, flagsStart, flagsEnd, out);
+
+        inputs += 16 * stride;
+        counter += 16 * counterStep;
+        out += 16 * 32;
+    }
+
+    blake3HashManyAVX2(inputs, stride, count, blocks, key, counter,
+                       counterStep, flags, flagsStart, flagsEnd, out);
+}
+
+#endif  // GASH_X86_SIMD
+
+/** The kernel chosen for the host and the number of inputs it
+ *  compresses at once.
+*/
+struct Blake3Platform
+{
+    Blake3Kernel hashMany;
+    uint32_t degree;
+};
+
+/** Choose the fastest kernel that the host supports.  */
+static Blake3Platform selectBlake3Platform (void)
+{
+    Blake3Platform platform = { blake3HashManyPortable, 1 };
+
+#ifdef GASH_X86_SIMD
+    if (CPUFeatures::has(CPUFeatures::AVX512))
+    {
+        platform.hashMany = blake3HashManyAVX512;
+        platform.degree = 16;
+    }
+    else if (CPUFeatures::has(CPUFeatures::AVX2))
+    {
+        platform.hashMany = blake3HashManyAVX2;
+        platform.degree = 8;
+    }
+    else if (CPUFeatures::has(CPUFeatures::SSE41))
+    {
+        platform.hashMany = blake3HashManySSE41;
+        platform.degree = 4;
+    }
+#endif
+
+    return platform;
+}
+
+static const Blake3Platform & blake3Platform (void)
+{
+    static const Blake3Platform platform = selectBlake3Platform();
+    return platform;
+}
+
+/******************************************************
+**                    Tree Hashing                   **
+******************************************************/
+
+/** Compress the final block of a node into its chaining value.  */
+static void outputChainingValue (const Blake3Output &output, byte_t cv[32])
+{
+    uint32_t words[16];
+    blake3Compress(output.cv, output.block, output.blockLength,
+                   output.counter, output.flags, words);
+
+    for (uint32_t i = 0; i < 8; ++i)
+        storeLittleEndian32(cv + (i * 4), words[i]);
+}
+
+/** Set up the output of a parent node from its two children.  */
+static void parentOutput (const byte_t *left, const byte_t *right,
+                          const uint32_t key[8], uint32_t flags,
+                          Blake3Output &output)
+{
+    memcpy(output.cv, key, sizeof(output.cv));
+    memcpy(output.block, left, 32);
+    memcpy(output.block + 32, right, 32);
+    output.blockLength = 64;
+    output.counter = 0;
+    output.flags = flags | PARENT;
+}
+
+/** The largest power of two that is no greater than x (x > 0).  */
+static inline uint64_t largestPowerOfTwo (uint64_t x)
+{
+    uint64_t p = 1;
+    while ((p << 1) <= x)
+        p <<= 1;
+
+    return p;
+}
+
+/** Hash one chunk that may be shorter than CHUNK_BYTES.  */
+static void hashPartialChunk (const byte_t *input, uint32_t length,
+                              const uint32_t key[8], uint64_t counter,
+                              uint32_t flags, byte_t cv[32])
+{
+    Blake3Output output;
+    uint32_t words[16];
+    uint32_t blockFlags = flags | CHUNK_START;
+
+    memcpy(output.cv, key, sizeof(output.cv));
+
+    while (length > 64)
+    {
+        blake3Compress(output.cv, input, 64, counter, blockFlags, words);
+        memcpy(output.cv, words, sizeof(output.cv));
+
+        blockFlags = flags;
+        input += 64;
+        length -= 64;
+    }
+
+    memset(output.block, 0, sizeof(output.block));
+    memcpy(output.block, input, length);
+    output.blockLength = length;
+    output.counter = counter;
+    output.flags = blockFlags | CHUNK_END;
+
+    outputChainingValue(output, cv);
+}
+
+/** Hash up to degree chunks side by side, writing one chaining value for
+ *  each chunk.  Returns the number of chaining values.
+*/
+static uint32_t compressChunks (const byte_t *input, uint64_t length,
+                                const uint32_t key[8], uint64_t counter,
+                                uint32_t flags, byte_t *out)
+{
+    uint32_t whole = (uint32_t)(length / BLAKE3::CHUNK_BYTES),
+             tail  = (uint32_t)(length % BLAKE3::CHUNK_BYTES);
+
+    blake3Platform().hashMany(input, BLAKE3::CHUNK_BYTES, whole,
+                              BLAKE3::CHUNK_BYTES / 64, key, counter, 1,
+                              flags, CHUNK_START, CHUNK_END, out);
+
+    if (tail == 0)
+        return whole;
+
+    hashPartialChunk(input + ((uint64_t)whole * BLAKE3::CHUNK_BYTES), tail,
+                     key, counter + whole, flags, out + (whole * 32));
+
+    return (whole + 1);
+}
+
+/** Combine adjacent pairs of chaining values into their parents.  An odd
+ *  one out is passed through to the next level.  Returns the number of
+ *  chaining values written.
+*/
+static uint32_t compressParents (const byte_t *cvs, uint32_t count,
+                                 const uint32_t key[8], uint32_t flags,
+                                 byte_t *out)
+{
+    uint32_t pairs = count / 2;
+
+    blake3Platform().hashMany(cvs, 64, pairs, 1, key, 0, 0, flags | PARENT,
+                              0, 0, out);
+
+    if ((count & 1) == 0)
+        return pairs;
+
+    memcpy(out + (pairs * 32), cvs + (pairs * 64), 32);
+
+    return (pairs + 1);
+}
+
+static uint32_t compressSubtreeWide (const byte_t *input, uint64_t length,
+                                     const uint32_t key[8], uint64_t counter,
+                                     uint32_t flags, uint32_t threads,
+                                     byte_t *out);
+
+/** The arguments of a subtree that is hashed by another thread.  */
+struct SubtreeJob
+{
+    const byte_t *input;
+    uint64_t length;
+    const uint32_t *key;
+    uint64_t counter;
+    uint32_t flags;
+    uint32_t threads;
+    byte_t *out;
+    uint32_t count;
+};
+
+static void * subtreeThread (void *arg)
+{
+    SubtreeJob *job = (SubtreeJob *)arg;
+
+    job->count = compressSubtreeWide(job->input, job->length, job->key,
+                                     job->counter, job->flags, job->threads,
+                                     job->out);
+
+    return NULL;
+}
+
+/** Hash a subtree whose first chunk is chunk number counter, leaving it
+ *  up to one tree level short of its root: the result is at most
+ *  max(degree, 2) chaining values, so that the caller can compress the
+ *  last levels as wide as possible.  The left half (which is always a
+ *  power of two chunks) runs on another thread when threads allow.
+ *  Returns the number of chaining values.
+*/
+static uint32_t compressSubtreeWide (const byte_t *input, uint64_t length,
+                                     const uint32_t key[8], uint64_t counter,
+                                     uint32_t flags, uint32_t threads,
+                                     byte_t *out)
+{
+    uint32_t degree = blake3Platform().degree;
+
+    if (length <= (uint64_t)degree * BLAKE3::CHUNK_BYTES)
+        return compressChunks(input, length, key, counter, flags, out);
+
+    // The left subtree takes the largest power of two whole chunks that
+    // leaves at least one byte for the right subtree.
+    uint64_t leftLength = largestPowerOfTwo((length - 1) / BLAKE3::CHUNK_BYTES)
+                          * BLAKE3::CHUNK_BYTES;
+    uint64_t rightCounter = counter + (leftLength / BLAKE3::CHUNK_BYTES);
+
+    // The left subtree returns degree chaining values (at least two) unless
+    // it is a single chunk.
+    if (leftLength == BLAKE3::CHUNK_BYTES)
+        degree = 1;
+    else if (degree < 2)
+        degree = 2;
+
+    byte_t cvs[2 * MAX_SIMD_DEGREE * 32];
+    byte_t *leftOut = cvs,
+           *rightOut = cvs + (degree * 32);
+
+    uint32_t leftCount = 0, rightCount = 0;
+    bool joined = false;
+
+    if ((threads > 1) && (length >= MIN_THREAD_BYTES))
+    {
+        SubtreeJob job = { input, leftLength, key, counter, flags,
+                           threads / 2, leftOut, 0 };
+        pthread_t thread;
+
+        if (pthread_create(&thread, NULL, subtreeThread, &job) == 0)
+        {
+            rightCount = compressSubtreeWide(input + leftLength,
+                                             length - leftLength, key,
+                                             rightCounter, flags,
+                                             threads - (threads / 2),
+                                             rightOut);
+            pthread_join(thread, NULL);
+
+            leftCount = job.count;
+            joined = true;
+        }
+    }
+
+    if (!joined)
+    {
+        leftCount = compressSubtreeWide(input, leftLength, key, counter,
+                                        flags, 1, leftOut);
+        rightCount = compressSubtreeWide(input + leftLength,
+                                         length - leftLength, key,
+                                         rightCounter, flags, 1, rightOut);
+    }
+
+    // Two single chunks are returned as they are so that the caller
+    // always receives at least two chaining values.
+    if (leftCount == 1)
+    {
+        memcpy(out, cvs, 64);
+        return 2;
+    }
+
+    return compressParents(cvs, leftCount + rightCount, key, flags, out);
+}
+
+/** Hash a subtree of more than one chunk down to the two children of its
+ *  root node (which is not compressed because it might be the root of
+ *  the whole tree).
+*/
+static void compressSubtreeToParent (const byte_t *input, uint64_t length,
+                                     const uint32_t key[8], uint64_t counter,
+                                     uint32_t flags, uint32_t threads,
+                                     byte_t out[64])
+{
+    byte_t cvs[MAX_SIMD_DEGREE * 32],
+           parents[MAX_SIMD_DEGREE * 16];
+
+    uint32_t count = compressSubtreeWide(input, length, key, counter, flags,
+                                         threads, cvs);
+
+    while (count > 2)
+    {
+        count = compressParents(cvs, count, key, flags, parents);
+        memcpy(cvs, parents, count * 32);
+    }
+
+    memcpy(out, cvs, 64);
+}
+
+/******************************************************
+**            Constructors / Destructors             **
+******************************************************/
+
+/** Default constructor.  */
+BLAKE3::BLAKE3 ()
+    : MessageHash(256),
+      _flags(0),
+      _threads(0)
+{
+    memcpy(_key, IV3, sizeof(_key));
+    setThreads(0);
+    reset();
+}
+
+/** Copy constructor.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated from the copied BLAKE3 object
+ *        including any partially processed message.
+ *  @param copyFrom The BLAKE3 object whose values are to be copied.
+*/
+BLAKE3::BLAKE3 (const BLAKE3 &copyFrom)
+    : MessageHash(copyFrom)
+{
+    *this = copyFrom;
+}
+
+/** Initialize a BLAKE3 object by hashing an input std::string.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated containing the
+ *        hashed value of the input data.
+ *  @param str The std::string that is to be hashed.
+*/
+BLAKE3::BLAKE3 (const string &str)
+    : MessageHash(256),
+      _flags(0),
+      _threads(0)
+{
+    memcpy(_key, IV3, sizeof(_key));
+    setThreads(0);
+    calculateHash(str);
+}
+
+/** Initialize a BLAKE3 object by hashing an input data stream.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated containing the
+ *        hashed value of the input data.
+ *  @param data The data that is to be hashed.
+*/
+BLAKE3::BLAKE3 (const vector < byte_t > &data)
+    : MessageHash(256),
+      _flags(0),
+      _threads(0)
+{
+    memcpy(_key, IV3, sizeof(_key));
+    setThreads(0);
+    calculateHash(data);
+}
+
+/** Initialize a BLAKE3 object by hashing an input file stream.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated containing the
+ *        hashed value of the input data.
+ *  @param file A handle to the file that is to be hashed.
+*/
+BLAKE3::BLAKE3 (ifstream &file)
+    : MessageHash(256),
+      _flags(0),
+      _threads(0)
+{
+    memcpy(_key, IV3, sizeof(_key));
+    setThreads(0);
+    calculateHash(file);
+}
+
+/** Default destructor.  */
+BLAKE3::~BLAKE3 ()  { }
+
+/******************************************************
+**               Accessors / Mutators                **
+******************************************************/
+
+////////////////////
+//    Getters
+////////////////////
+
+/** Retrieve the name of the algorithm.
+ *
+ *  @pre The object is instantiated.
+ *  @post none.
+ *  @return "BLAKE3".
+*/
+string BLAKE3::algorithmName (void) const
+{
+    return "BLAKE3";
+}
+
+/** Retrieve the name of the kernel that the host selected.
+ *
+ *  @pre The object is instantiated.
+ *  @post none.
+ *  @return "AVX-512", "AVX2", "SSE4.1" or "portable".
+*/
+string BLAKE3::kernelName (void) const
+{
+#ifdef GASH_X86_SIMD
+    const Blake3Platform &platform = blake3Platform();
+
+    if (platform.hashMany == blake3HashManyAVX512)
+        return "AVX-512";
+
+    if (platform.hashMany == blake3HashManyAVX2)
+        return "AVX2";
+
+    if (platform.hashMany == blake3HashManySSE41)
+        return "SSE4.1";
+#endif
+
+    return "portable";
+}
+
+/** Copy the object, including any partially processed message.
+ *
+ *  @pre none.
+ *  @post The caller owns (and must delete) the copy.
+ *  @return A new BLAKE3 object in the same state.
+*/
+BLAKE3 * BLAKE3::clone (void) const
+{
+    return new BLAKE3(*this);
+}
+
+////////////////////
+//    Setters
+////////////////////
+
+/** Calculate the hash from an input std::string.
+ *
+ *  @pre The object is instantiated.
+ *  @post The computed hash is stored in the _hash values.
+ *  @param str The string whose value is to be hashed.
+ *  @return The hash as a std::string.
+*/
+string BLAKE3::calculateHash (const string &str)
+{
+    reset();
+    update((const byte_t *)str.data(), str.size());
+
+    return finalize();
+}
+
+/** Calculate the hash from an input data stream.
+ *
+ *  @pre The object is instantiated.
+ *  @post The computed hash is stored in the _hash values.
+ *  @param data The data that is to be hashed.
+ *  @return The hash as a std::string.
+*/
+string BLAKE3::calculateHash (const vector < byte_t > &data)
+{
+    reset();
+    update(data);
+
+    return finalize();
+}
+
+/** Calculate the hash of a file.
+ *
+ *  @pre The object is instantiated.
+ *  @post The computed hash is stored in the _hash values.
+ *  @param file The file whose hash value is to be calculated.
+ *  @return The hash as a std::string.
+*/
+string BLAKE3::calculateHash (ifstream &file)
+{
+    reset();
+
+    // Check that the file is valid before doing anything else.
+    // This will return a hash value of all zeros.
+    if (file.fail() || !file.good())
+    {
+        _hash.assign(_hash.size(), 0x00000000);
+        return asString();
+    }
+
+    // Size the buffer to the file so that small files do not pay for
+    // the full FILE_BUFFER_BYTES.
+    file.seekg(0, ios::end);
+    uint64_t fileSize = (uint64_t)file.tellg();
+    file.seekg(0, ios::beg);
+
+    uint64_t bufferSize = FILE_BUFFER_BYTES;
+    if (fileSize < bufferSize)
+        bufferSize = fileSize + 1;
+
+    vector < byte_t > buffer((size_t)bufferSize);
+
+    while (file.good())
+    {
+        file.read((char *)&buffer[0], buffer.size());
+        update(&buffer[0], (uint64_t)file.gcount());
+    }
+
+    // Reset the file flags and return to the file head.
+    file.clear();
+    file.seekg(0);  // Return to the head of the file.
+
+    return finalize();
+}
+
+/** Switch to the keyed hash mode.
+ *
+ *  @pre The object is instantiated.
+ *  @post Any message data is discarded and later hashes are
+ *        keyed with the given key.
+ *  @param key A pointer to the KEY_BYTES byte key.
+ *  @return none.
+*/
+void BLAKE3::setKey (const byte_t *key)
+{
+    for (uint32_t i = 0; i < 8; ++i)
+        _key[i] = loadLittleEndian32(key + (i * 4));
+
+    _flags = KEYED_HASH;
+    reset();
+
+    return;
+}
+
+/** Set the number of threads used to hash large inputs.
+ *
+ *  @pre The object is instantiated.
+ *  @post Subtrees of later update() calls are spread over
+ *        at most the given number of threads.
+ *  @param threads The thread limit; zero selects one thread for
+ *         each online processor.
+ *  @return none.
+*/
+void BLAKE3::setThreads (uint32_t threads)
+{
+    if (threads == 0)
+    {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (online > 0) ? (uint32_t)online : 1;
+    }
+
+    _threads = threads;
+
+    return;
+}
+
+/** Discard any message data and restart the hash.
+ *
+ *  @pre The object is instantiated.
+ *  @post The chunk state and the chaining value stack are cleared.
+ *  @return none.
+*/
+void BLAKE3::reset (void)
+{
+    _cvStackSize = 0;
+    _startChunk(0);
+
+    return;
+}
+
+/** Append message data to the hash.
+ *
+ *  @pre reset() has been called since the last finalize().
+ *  @post Every complete subtree has been compressed onto the
+ *        chaining value stack and the remainder is held in the
+ *        chunk state.
+ *  @param data A pointer to the message data.
+ *  @param length The number of bytes at data.
+ *  @return none.
+*/
+void BLAKE3::update (const byte_t *data, uint64_t length)
+{
+    // Finish a partially filled chunk first.  It is only known not to be
+    // the last chunk (and so can be finalized) once more data arrives.
+    if (_chunkLength() > 0)
+    {
+        uint64_t take = CHUNK_BYTES - _chunkLength();
+        if (take > length)
+            take = length;
+
+        _updateChunk(data, (uint32_t)take);
+        data += take;
+        length -= take;
+
+        if (length == 0)
+            return;
+
+        Blake3Output output;
+        byte_t cv[32];
+
+        _chunkOutput(output);
+        outputChainingValue(output, cv);
+        _pushCV(cv, _chunkCounter);
+        _startChunk(_chunkCounter + 1);
+    }
+
+    // Hash the largest whole subtrees that we can.  A subtree must be a
+    // power of two chunks and must start at a multiple of its own size
+    // (so that it lines up with the subtrees already on the stack), and
+    // the final chunk is always left for the chunk state since it might
+    // be the root.
+    while (length > CHUNK_BYTES)
+    {
+        uint64_t subtreeLength = largestPowerOfTwo(length);
+        uint64_t countSoFar = _chunkCounter * CHUNK_BYTES;
+
+        while (((subtreeLength - 1) & countSoFar) != 0)
+            subtreeLength >>= 1;
+
+        uint64_t subtreeChunks = subtreeLength / CHUNK_BYTES;
+
+        if (subtreeLength <= CHUNK_BYTES)
+        {
+            byte_t cv[32];
+
+            hashPartialChunk(data, (uint32_t)subtreeLength, _key,
+                             _chunkCounter, _flags, cv);
+            _pushCV(cv, _chunkCounter);
+        }
+        else
+        {
+            // The stack merges lazily, so pushing both halves can never
+            // merge away the root.
+            byte_t children[64];
+
+            compressSubtreeToParent(data, subtreeLength, _key, _chunkCounter,
+                                    _flags, _threads, children);
+            _pushCV(children, _chunkCounter);
+            _pushCV(children + 32, _chunkCounter + (subtreeChunks / 2));
+        }
+
+        _chunkCounter += subtreeChunks;
+        data += subtreeLength;
+        length -= subtreeLength;
+    }
+
+    // What remains is at most one chunk.  Once it is in the chunk state
+    // the stack can be merged, since none of it can be the root now.
+    if (length > 0)
+    {
+        _updateChunk(data, (uint32_t)length);
+        _mergeStack(_chunkCounter);
+    }
+
+    return;
+}
+
+/** Append message data to the hash.
+ *
+ *  @pre reset() has been called since the last finalize().
+ *  @post The message data has been absorbed.
+ *  @param data The message data.
+ *  @return none.
+*/
+void BLAKE3::update (const vector < byte_t > &data)
+{
+    if (!data.empty())
+        update(&data[0], data.size());
+
+    return;
+}
+
+/** Merge the tree down to its root and produce the hash.
+ *
+ *  @pre reset() has been called since the last finalize().
+ *  @post The computed hash is stored in the _hash values.
+ *  @return The hash as a std::string.
+*/
+string BLAKE3::finalize (void)
+{
+    Blake3Output output;
+    uint32_t remaining = _cvStackSize;
+
+    // A partial (or empty) chunk is merged with everything on the stack;
+    // otherwise the top two subtrees form the first parent.
+    if ((_chunkLength() > 0) || (remaining == 0))
+        _chunkOutput(output);
+    else
+    {
+        parentOutput(_cvStack[remaining - 2], _cvStack[remaining - 1], _key,
+                     _flags, output);
+        remaining -= 2;
+    }
+
+    byte_t cv[32];
+
+    while (remaining > 0)
+    {
+        outputChainingValue(output, cv);
+        parentOutput(_cvStack[remaining - 1], cv, _key, _flags, output);
+        --remaining;
+    }
+
+    // The root node is compressed once more with the ROOT flag.
+    output.flags |= ROOT;
+    output.counter = 0;
+    outputChainingValue(output, cv);
+
+    _storeHash(cv);
+
+    return asString();
+}
+
+/******************************************************
+**                     Operators                     **
+******************************************************/
+
+/** Assignment from another BLAKE3 object.
+ *
+ *  @pre The object is instantiated.
+ *  @post The object contains the values copied from rhs.
+ *  @param rhs The BLAKE3 object whose values are to be copied/stored.
+ *  @return A reference to the object.
+*/
+BLAKE3 & BLAKE3::operator = (const BLAKE3 &rhs)
+{
+    if (this != &rhs)
+    {
+        MessageHash::operator = (rhs);
+
+        memcpy(_key, rhs._key, sizeof(_key));
+        _flags = rhs._flags;
+        _threads = rhs._threads;
+
+        memcpy(_chunkCV, rhs._chunkCV, sizeof(_chunkCV));
+        _chunkCounter = rhs._chunkCounter;
+        memcpy(_block, rhs._block, sizeof(_block));
+        _blockLength = rhs._blockLength;
+        _blocksCompressed = rhs._blocksCompressed;
+
+        memcpy(_cvStack, rhs._cvStack, sizeof(_cvStack));
+        _cvStackSize = rhs._cvStackSize;
+    }
+
+    return *this;
+}
+
+/******************************************************
+**                   Helper Methods                  **
+******************************************************/
+
+/** Start a new chunk.
+ *
+ *  @pre none.
+ *  @post The chunk state is empty and has the given index.
+ *  @param counter The index of the chunk in the message.
+ *  @return none.
+*/
+void BLAKE3::_startChunk (uint64_t counter)
+{
+    memcpy(_chunkCV, _key, sizeof(_chunkCV));
+    _chunkCounter = counter;
+    memset(_block, 0, sizeof(_block));
+    _blockLength = 0;
+    _blocksCompressed = 0;
+
+    return;
+}
+
+/** The number of message bytes held by the chunk state.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return The length of the current chunk.
+*/
+uint32_t BLAKE3::_chunkLength (void) const
+{
+    return ((_blocksCompressed * BLOCK_BYTES) + _blockLength);
+}
+
+/** Append message data to the current chunk.
+ *
+ *  @pre The data fits within the current chunk.
+ *  @post All but the final (possibly partial) block of the chunk
+ *        are compressed.
+ *  @param data A pointer to the message data.
+ *  @param length The number of bytes at data.
+ *  @return none.
+*/
+void BLAKE3::_updateChunk (const byte_t *data, uint32_t length)
+{
+    uint32_t words[16];
+
+    while (length > 0)
+    {
+        // A full block is only compressed once more data shows that it
+        // is not the chunk's last block.
+        if (_blockLength == BLOCK_BYTES)
+        {
+            uint32_t flags = _flags;
+            if (_blocksCompressed == 0)
+                flags |= CHUNK_START;
+
+            blake3Compress(_chunkCV, _block, BLOCK_BYTES, _chunkCounter,
+                           flags, words);
+            memcpy(_chunkCV, words, sizeof(_chunkCV));
+
+            ++_blocksCompressed;
+            memset(_block, 0, sizeof(_block));
+            _blockLength = 0;
+        }
+
+        uint32_t take = BLOCK_BYTES - _blockLength;
+        if (take > length)
+            take = length;
+
+        memcpy(_block + _blockLength, data, take);
+        _blockLength += take;
+        data += take;
+        length -= take;
+    }
+
+    return;
+}
+
+/** Capture the final block of the current chunk.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @param output Receives the inputs of the chunk's last compression.
+ *  @return none.
+*/
+void BLAKE3::_chunkOutput (Blake3Output &output) const
+{
+    memcpy(output.cv, _chunkCV, sizeof(output.cv));
+    memcpy(output.block, _block, sizeof(output.block));
+    output.blockLength = _blockLength;
+    output.counter = _chunkCounter;
+    output.flags = _flags | CHUNK_END;
+
+    if (_blocksCompressed == 0)
+        output.flags |= CHUNK_START;
+
+    return;
+}
+
+/** Merge completed subtrees so that the stack holds one chaining
+ *  value for each set bit of the chunk count.
+ *
+ *  @pre none.
+ *  @post The stack is merged down to the given chunk count.
+ *  @param totalChunks The number of chunks hashed so far.
+ *  @return none.
+*/
+void BLAKE3::_mergeStack (uint64_t totalChunks)
+{
+    uint32_t subtrees = 0;
+    for (; totalChunks != 0; totalChunks &= (totalChunks - 1))
+        ++subtrees;
+
+    while (_cvStackSize > subtrees)
+    {
+        Blake3Output output;
+
+        parentOutput(_cvStack[_cvStackSize - 2], _cvStack[_cvStackSize - 1],
+                     _key, _flags, output);
+        outputChainingValue(output, _cvStack[_cvStackSize - 2]);
+        --_cvStackSize;
+    }
+
+    return;
+}
+
+/** Push the chaining value of a completed subtree.
+ *
+ *  @pre none.
+ *  @post Older subtrees are merged and cv is on top of the stack.
+ *  @param cv The 32 byte chaining value.
+ *  @param chunkCounter The index of the first chunk of the subtree.
+ *  @return none.
+*/
+void BLAKE3::_pushCV (const byte_t *cv, uint64_t chunkCounter)
+{
+    _mergeStack(chunkCounter);
+
+    memcpy(_cvStack[_cvStackSize], cv, 32);
+    ++_cvStackSize;
+
+    return;
+}
+
+/** Copy the output bytes into the _hash words.
+ *
+ *  @pre none.
+ *  @post The _hash values hold the message digest.
+ *  @param bytes The 32 output bytes of the root node.
+ *  @return none.
+*/
+void BLAKE3::_storeHash (const byte_t *bytes)
+{
+    // The digest is printed a word at a time, most significant byte
+    // first, so the byte string is packed big endian.
+    for (uint32_t i = 0; i < 8; ++i)
+        _hash.at(i) =   ((uint32_t)bytes[(i * 4)    ] << 24)
+                      | ((uint32_t)bytes[(i * 4) + 1] << 16)
+                      | ((uint32_t)bytes[(i * 4) + 2] <<  8)
+                      | ((uint32_t)bytes[(i * 4) + 3]      );
+
+    return;
+}
+
+/** Append the algorithm specific part of the midstate.
+ *
+ *  @pre none.
+ *  @post The state is appended to state.
+ *  @param state The state that is being exported.
+ *  @return none.
+*/
+void BLAKE3::_saveState (HashState &state) const
+{
+    // The key and flags are saved so that a keyed hash resumes keyed.
+    state.putWords32(_key, 8);
+    state.putWord32(_flags);
+
+    state.putWords32(_chunkCV, 8);
+    state.putWord64(_chunkCounter);
+    state.putWord32(_blocksCompressed);
+    state.putWord32(_blockLength);
+    state.putBytes(_block, _blockLength);
+
+    state.putWord32(_cvStackSize);
+    state.putBytes(&_cvStack[0][0], _cvStackSize * 32);
+
+    return;
+}
+
+/** Restore the algorithm specific part of the midstate.
+ *
+ *  @pre The common header of state has been read and checked.
+ *  @post The object holds the imported state.
+ *  @param state The state that is being imported.
+ *  @return true The values read are consistent.
+ *  @return false The state is corrupt.
+*/
+bool BLAKE3::_loadState (HashState &state)
+{
+    // The key and mode are only taken once the rest has been checked, so
+    // that the reset() after a corrupt state keeps those of the object.
+    uint32_t key[8];
+
+    state.getWords32(key, 8);
+    uint32_t flags = state.getWord32();
+
+    state.getWords32(_chunkCV, 8);
+    _chunkCounter = state.getWord64();
+    _blocksCompressed = state.getWord32();
+    _blockLength = state.getWord32();
+
+    if ((_blockLength > BLOCK_BYTES)
+        || (_blocksCompressed >= (CHUNK_BYTES / BLOCK_BYTES)))
+        return false;
+
+    memset(_block, 0, sizeof(_block));
+    state.getBytes(_block, _blockLength);
+
+    _cvStackSize = state.getWord32();
+    if (_cvStackSize > MAX_STACK_DEPTH)
+        return false;
+
+    state.getBytes(&_cvStack[0][0], _cvStackSize * 32);
+
+    if ((flags != 0) && (flags != KEYED_HASH))
+        return false;
+
+    memcpy(_key, key, sizeof(_key));
+    _flags = flags;
+
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,389 @@
+/******************************************************************************
+||  blake3.h                                                                 ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    An implementation of the BLAKE3 cryptographic hash.  The message is    ||
+||    split into 1 KiB chunks that form the leaves of a binary hash tree, so ||
+||    whole subtrees can be compressed many chunks at a time by the SSE4.1,  ||
+||    AVX2 or AVX-512 kernels and large inputs can be spread over several    ||
+||    threads.                                                               ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    cpu_features.cpp (cpu_features.lib)                                    ||
+||    cpu_features.h                                                         ||
+||    hash_abstract.cpp (hash_abstract.lib)                                  ||
+||    hash_abstract.h                                                        ||
+||    pthread                                                                ||
+||                                                                           ||
+||===========================================================================||
+||  REFERENCES                                                               ||
+||===========================================================================||
+||    O'Connor, J., Aumasson, J.-P., Neves, S. and Wilcox-O'Hearn, Z.        ||
+||        "BLAKE3: One function, fast everywhere".  9 Jan 2020.              ||
+||        https://github.com/BLAKE3-team/BLAKE3-specs                        ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file blake3.h
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+#ifndef _GH_BLAKE_3_DEF_H
+#define _GH_BLAKE_3_DEF_H
+
+#include "hash_abstract.h"
+
+// The finished state of a chunk or parent node; defined in blake3.cpp.
+struct Blake3Output;
+
+/**
+ *  @class BLAKE3 An abstract data type to calculate and
+ *         manipulate BLAKE3 hashes.
+*/
+class BLAKE3 : public MessageHash
+{
+  public:
+    /******************************************************
+    **                     Constants                     **
+    ******************************************************/
+    static const uint32_t BLOCK_BYTES = 64;     // Bytes per compression.
+    static const uint32_t CHUNK_BYTES = 1024;   // Bytes per tree leaf.
+    static const uint32_t KEY_BYTES = 32;       // Bytes in a keyed-hash key.
+
+    // The size of the read buffer used to hash files; large reads give
+    // the tree code whole subtrees to spread over the worker threads.
+    static const uint32_t FILE_BUFFER_BYTES = 16 * 1024 * 1024;
+
+    /******************************************************
+    **            Constructors / Destructors             **
+    ******************************************************/
+
+    /** Default constructor.  */
+    BLAKE3 ();
+
+    /** Copy constructor.
+     *
+     *  @pre none.
+     *  @post A new object is instantiated from the copied BLAKE3 object
+     *        including any partially processed message.
+     *  @param copyFrom The BLAKE3 object whose values are to be copied.
+    */
+    BLAKE3 (const BLAKE3 &copyFrom);
+
+    /** Initialize a BLAKE3 object by hashing an input std::string.
+     *
+     *  @pre none.
+     *  @post A new object is instantiated containing the
+     *        hashed value of the input data.
+     *  @param str The std::string that is to be hashed.
+    */
+    BLAKE3 (const string &str);
+
+    /** Initialize a BLAKE3 object by hashing an input data stream.
+     *
+     *  @pre none.
+     *  @post A new object is instantiated containing the
+     *        hashed value of the input data.
+     *  @param data The data that is to be hashed.
+    */
+    BLAKE3 (const vector < byte_t > &data);
+
+    /** Initialize a BLAKE3 object by hashing an input file stream.
+     *
+     *  @pre none.
+     *  @post A new object is instantiated containing the
+     *        hashed value of the input data.
+     *  @param file A handle to the file that is to be hashed.
+    */
+    BLAKE3 (ifstream &file);
+
+    /** Default destructor.  */
+    ~BLAKE3 ();
+
+    /******************************************************
+    **               Accessors / Mutators                **
+    ******************************************************/
+
+    ////////////////////
+    //    Getters
+    ////////////////////
+
+    /** Retrieve the name of the algorithm.
+     *
+     *  @pre The object is instantiated.
+     *  @post none.
+     *  @return "BLAKE3".
+    */
+    string algorithmName (void) const;
+
+    /** Retrieve the name of the kernel that the host selected.
+     *
+     *  @pre The object is instantiated.
+     *  @post none.
+     *  @return "AVX-512", "AVX2", "SSE4.1" or "portable".
+    */
+    string kernelName (void) const;
+
+    /** Copy the object, including any partially processed message.
+     *
+     *  @pre none.
+     *  @post The caller owns (and must delete) the copy.
+     *  @return A new BLAKE3 object in the same state.
+    */
+    BLAKE3 * clone (void) const;
+
+    ////////////////////
+    //    Setters
+    ////////////////////
+
+    /** Calculate the hash from an input std::string.
+     *
+     *  @pre The object is instantiated.
+     *  @post The computed hash is stored in the _hash values.
+     *  @param str The string whose value is to be hashed.
+     *  @return The hash as a std::string.
+    */
+    string calculateHash (const string &str);
+
+    /** Calculate the hash from an input data stream.
+     *
+     *  @pre The object is instantiated.
+     *  @post The computed hash is stored in the _hash values.
+     *  @param data The data that is to be hashed.
+     *  @return The hash as a std::string.
+    */
+    string calculateHash (const vector < byte_t > &data);
+
+    /** Calculate the hash of a file.
+     *
+     *  @pre The object is instantiated.
+     *  @post The computed hash is stored in the _hash values.
+     *  @param file The file whose hash value is to be calculated.
+     *  @return The hash as a std::string.
+    */
+    string calculateHash (ifstream &file);
+
+    /** Switch to the keyed hash mode.
+     *
+     *  @pre The object is instantiated.
+     *  @post Any message data is discarded and later hashes are
+     *        keyed with the given key.
+     *  @param key A pointer to the KEY_BYTES byte key.
+     *  @return none.
+    */
+    void setKey (const byte_t *key);
+
+    /** Set the number of threads used to hash large inputs.
+     *
+     *  @pre The object is instantiated.
+     *  @post Subtrees of later update() calls are spread over
+     *        at most the given number of threads.
+     *  @param threads The thread limit; zero selects one thread for
+     *         each online processor.
+     *  @return none.
+    */
+    void setThreads (uint32_t threads);
+
+    /** Discard any message data and restart the hash.
+     *
+     *  @pre The object is instantiated.
+     *  @post The chunk state and the chaining value stack are cleared.
+     *  @return none.
+    */
+    void reset (void);
+
+    /** Append message data to the hash.
+     *
+     *  @pre reset() has been called since the last finalize().
+     *  @post Every complete subtree has been compressed onto the
+     *        chaining value stack and the remainder is held in the
+     *        chunk state.
+     *  @param data A pointer to the message data.
+     *  @param length The number of bytes at data.
+     *  @return none.
+    */
+    void update (const byte_t *data, uint64_t length);
+
+    /** Append message data to the hash.
+     *
+     *  @pre reset() has been called since the last finalize().
+     *  @post The message data has been absorbed.
+     *  @param data The message data.
+     *  @return none.
+    */
+    void update (const vector < byte_t > &data);
+
+    /** Merge the tree down to its root and produce the hash.
+     *
+     *  @pre reset() has been called since the last finalize().
+     *  @post The computed hash is stored in the _hash values.
+     *  @return The hash as a std::string.
+    */
+    string finalize (void);
+
+    /******************************************************
+    **                     Operators                     **
+    ******************************************************/
+
+    /** Assignment from another BLAKE3 object.
+     *
+     *  @pre The object is instantiated.
+     *  @post The object contains the values copied from rhs.
+     *  @param rhs The BLAKE3 object whose values are to be copied/stored.
+     *  @return A reference to the object.
+    */
+    BLAKE3 & operator = (const BLAKE3 &rhs);
+
+  protected:
+    /******************************************************
+    **                     Constants                     **
+    ******************************************************/
+
+    // One chaining value for each level of a tree of 2^54 chunks,
+    // which covers any 64-bit message length.
+    static const uint32_t MAX_STACK_DEPTH = 54;
+
+    /******************************************************
+    **                      Members                      **
+    ******************************************************/
+    uint32_t _key[8];       // The key words (the IV when not keyed).
+    uint32_t _flags;        // The domain flags common to every node.
+    uint32_t _threads;      // The most threads that update() may use.
+
+    // The chunk that is currently being filled.
+    uint32_t _chunkCV[8];         // The chunk's running chaining value.
+    uint64_t _chunkCounter;       // The chunk's index in the message.
+    byte_t _block[BLOCK_BYTES];   // The latest (uncompressed) block.
+    uint32_t _blockLength;        // The number of bytes in _block.
+    uint32_t _blocksCompressed;   // The blocks of the chunk compressed.
+
+    // The chaining values of the completed subtrees, as bytes.
+    byte_t _cvStack[MAX_STACK_DEPTH][32];
+    uint32_t _cvStackSize;
+
+    /******************************************************
+    **                   Helper Methods                  **
+    ******************************************************/
+
+    /** Start a new chunk.
+     *
+     *  @pre none.
+     *  @post The chunk state is empty and has the given index.
+     *  @param counter The index of the chunk in the message.
+     *  @return none.
+    */
+    void _startChunk (uint64_t counter);
+
+    /** The number of message bytes held by the chunk state.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return The length of the current chunk.
+    */
+    uint32_t _chunkLength (void) const;
+
+    /** Append message data to the current chunk.
+     *
+     *  @pre The data fits within the current chunk.
+     *  @post All but the final (possibly partial) block of the chunk
+     *        are compressed.
+     *  @param data A pointer to the message data.
+     *  @param length The number of bytes at data.
+     *  @return none.
+    */
+    void _updateChunk (const byte_t *data, uint32_t length);
+
+    /** Capture the final block of the current chunk.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @param output Receives the inputs of the chunk's last compression.
+     *  @return none.
+    */
+    void _chunkOutput (Blake3Output &output) const;
+
+    /** Merge completed subtrees so that the stack holds one chaining
+     *  value for each set bit of the chunk count.
+     *
+     *  @pre none.
+     *  @post The stack is merged down to the given chunk count.
+     *  @param totalChunks The number of chunks hashed so far.
+     *  @return none.
+    */
+    void _mergeStack (uint64_t totalChunks);
+
+    /** Push the chaining value of a completed subtree.
+     *
+     *  @pre none.
+     *  @post Older subtrees are merged and cv is on top of the stack.
+     *  @param cv The 32 byte chaining value.
+     *  @param chunkCounter The index of the first chunk of the subtree.
+     *  @return none.
+    */
+    void _pushCV (const byte_t *cv, uint64_t chunkCounter);
+
+    /** Copy the output bytes into the _hash words.
+     *
+     *  @pre none.
+     *  @post The _hash values hold the message digest.
+     *  @param bytes The 32 output bytes of the root node.
+     *  @return none.
+    */
+    void _storeHash (const byte_t *bytes);
+
+    /** Append the algorithm specific part of the midstate.
+     *
+     *  @pre none.
+     *  @post The state is appended to state.
+     *  @param state The state that is being exported.
+     *  @return none.
+    */
+    void _saveState (HashState &state) const;
+
+    /** Restore the algorithm specific part of the midstate.
+     *
+     *  @pre The common header of state has been read and checked.
+     *  @post The object holds the imported state.
+     *  @param state The state that is being imported.
+     *  @return true The values read are consistent.
+     *  @return false The state is corrupt.
+    */
+    bool _loadState (HashState &state);
+
+};  // End class BLAKE3.
+
+#endif
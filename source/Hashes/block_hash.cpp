@@ -0,0 +1,413 @@
+/******************************************************************************
+||  block_hash.cpp                                                           ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    This abstract base class implements the buffering, padding and         ||
+||    streaming logic that is shared by the Merkle-Damgard hash functions    ||
+||    (the SHA family).  A derived class only has to provide its chaining    ||
+||    variables and a block compression function.                            ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    hash_abstract.cpp (hash_abstract.lib)                                  ||
+||    hash_abstract.h                                                        ||
+||                                                                           ||
+||===========================================================================||
+||  REFERENCES                                                               ||
+||===========================================================================||
+||    FIPS 180-4, "Secure Hash Standard".  Aug 2015.  National Institute of  ||
+||        Standards and Technology.                                          ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file block_hash.cpp
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+#include <string.h>
+
+#include "block_hash.h"
+#include "hash_state.h"
+
+const uint32_t BlockHash::MAX_BLOCK_BYTES;
+const uint32_t BlockHash::FILE_BUFFER_BYTES;
+
+/******************************************************
+**            Constructors / Destructors             **
+******************************************************/
+
+/** Initialize the block buffer.
+ *
+ *  @pre none.
+ *  @post The object is ready to accept message data.
+ *  @param bits The number of bits in the hash.
+ *  @param blockBytes The size of a message block (64 or 128 bytes).
+ *  @param lengthBytes The size of the length field in the final
+ *         block (8 or 16 bytes).
+ *  @param lengthLittleEndian The length field is stored least
+ *         significant byte first (MD5) rather than big endian.
+*/
+BlockHash::BlockHash (uint32_t bits, uint32_t blockBytes, uint32_t lengthBytes,
+                      bool lengthLittleEndian)
+    : MessageHash(bits),
+      _blockBytes(blockBytes),
+      _lengthBytes(lengthBytes),
+      _lengthLittleEndian(lengthLittleEndian),
+      _pending(0),
+      _messageBytes(0)
+{
+    memset(_block, 0, sizeof(_block));
+}
+
+/** Copy constructor.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated from the copied BlockHash object
+ *        including any partially processed message.
+ *  @param copyFrom The BlockHash object whose values are to be copied.
+*/
+BlockHash::BlockHash (const BlockHash &copyFrom)
+    : MessageHash(copyFrom),
+      _blockBytes(copyFrom._blockBytes),
+      _lengthBytes(copyFrom._lengthBytes),
+      _lengthLittleEndian(copyFrom._lengthLittleEndian),
+      _pending(copyFrom._pending),
+      _messageBytes(copyFrom._messageBytes)
+{
+    memcpy(_block, copyFrom._block, sizeof(_block));
+}
+
+/** Default destructor.  */
+BlockHash::~BlockHash ()  { }
+
+/******************************************************
+**               Accessors / Mutators                **
+******************************************************/
+
+////////////////////
+//    Getters
+////////////////////
+
+/** Retrieve the size of a message block.
+ *
+ *  @pre The object is instantiated.
+ *  @post none.
+ *  @return The number of bytes per block (64 or 128).
+*/
+uint32_t BlockHash::blockBytes (void) const
+{
+    return _blockBytes;
+}
+
+////////////////////
+//    Setters
+////////////////////
+
+/** Calculate the hash from an input std::string.
+ *
+ *  @pre The object is instantiated.
+ *  @post The computed hash is stored in the _hash values.
+ *  @param str The string whose value is to be hashed.
+ *  @return The hash as a std::string.
+*/
+string BlockHash::calculateHash (const string &str)
+{
+    reset();
+    update((const byte_t *)str.data(), str.size());
+
+    return finalize();
+}
+
+/** Calculate the hash from an input data stream.
+ *
+ *  @pre The object is instantiated.
+ *  @post The computed hash is stored in the _hash values.
+ *  @param data The data that is to be hashed.
+ *  @return The hash as a std::string.
+*/
+string BlockHash::calculateHash (const vector < byte_t > &data)
+{
+    reset();
+    update(data);
+
+    return finalize();
+}
+
+/** Calculate the hash of a file.
+ *
+ *  @pre The object is instantiated.
+ *  @post The computed hash is stored in the _hash values.
+ *  @param file The file whose hash value is to be calculated.
+ *  @return The hash as a std::string.
+*/
+string BlockHash::calculateHash (ifstream &file)
+{
+    reset();
+
+    // Check that the file is valid before doing anything else.
+    // This will return a hash value of all zeros.
+    if (file.fail() || !file.good())
+    {
+        _hash.assign(_hash.size(), 0x00000000);
+        return asString();
+    }
+
+    // Read the file in large pieces rather than a byte at a time;
+    // update() takes care of splitting the data into blocks.
+    vector < byte_t > buffer(FILE_BUFFER_BYTES);
+
+    while (file.good())
+    {
+        file.read((char *)&buffer[0], buffer.size());
+        update(&buffer[0], (uint64_t)file.gcount());
+    }
+
+    // Reset the file flags and return to the file head.
+    file.clear();
+    file.seekg(0);  // Return to the head of the file.
+
+    return finalize();
+}
+
+/** Discard any message data and restart the hash.
+ *
+ *  @pre The object is instantiated.
+ *  @post The chaining variables hold their initial values.
+ *  @return none.
+*/
+void BlockHash::reset (void)
+{
+    _pending = 0;
+    _messageBytes = 0;
+    _initializeHash();
+
+    return;
+}
+
+/** Append message data to the hash.
+ *
+ *  @pre reset() has been called since the last finalize().
+ *  @post Every complete block has been compressed and the remaining
+ *        bytes are held in the block buffer.
+ *  @param data A pointer to the message data.
+ *  @param length The number of bytes at data.
+ *  @return none.
+*/
+void BlockHash::update (const byte_t *data, uint64_t length)
+{
+    _messageBytes += length;
+
+    // Top up a partially filled block first.
+    if (_pending > 0)
+    {
+        uint64_t fill = _blockBytes - _pending;
+        if (fill > length)
+            fill = length;
+
+        memcpy(_block + _pending, data, (size_t)fill);
+        _pending += (uint32_t)fill;
+        data += fill;
+        length -= fill;
+
+        if (_pending < _blockBytes)
+            return;
+
+        _compress(_block, 1);
+        _pending = 0;
+    }
+
+    // Whole blocks are compressed straight from the caller's buffer.
+    uint64_t blocks = length / _blockBytes;
+    if (blocks > 0)
+    {
+        _compress(data, blocks);
+        data += blocks * _blockBytes;
+        length -= blocks * _blockBytes;
+    }
+
+    // Hold on to the tail until more data (or finalize) arrives.
+    if (length > 0)
+    {
+        memcpy(_block, data, (size_t)length);
+        _pending = (uint32_t)length;
+    }
+
+    return;
+}
+
+/** Append message data to the hash.
+ *
+ *  @pre reset() has been called since the last finalize().
+ *  @post Every complete block has been compressed and the remaining
+ *        bytes are held in the block buffer.
+ *  @param data The message data.
+ *  @return none.
+*/
+void BlockHash::update (const vector < byte_t > &data)
+{
+    if (!data.empty())
+        update(&data[0], data.size());
+
+    return;
+}
+
+/** Pad the message and produce the hash.
+ *
+ *  @pre reset() has been called since the last finalize().
+ *  @post The computed hash is stored in the _hash values.
+ *  @return The hash as a std::string.
+*/
+string BlockHash::finalize (void)
+{
+    // The first padded bit is a '1' followed by zeros until we reach
+    // the length field at the end of the final block.
+    _block[_pending++] = 0x80;
+
+    if (_pending > (_blockBytes - _lengthBytes))
+    {
+        memset(_block + _pending, 0, _blockBytes - _pending);
+        _compress(_block, 1);
+        _pending = 0;
+    }
+
+    memset(_block + _pending, 0, _blockBytes - _pending);
+
+    // The length field is the message size in bits presented as a big
+    // endian value.  Only the low 64 bits can be non-zero for SHA-384/512.
+    uint64_t bitsHigh = _messageBytes >> 61,
+             bitsLow  = _messageBytes << 3;
+
+    if (_lengthLittleEndian)
+    {
+        for (uint32_t i = 0; i < 8; ++i)
+            _block[_blockBytes - 8 + i] = (byte_t)(bitsLow >> (i * 8));
+    }
+    else
+    {
+        for (uint32_t i = 0; i < 8; ++i)
+            _block[_blockBytes - 1 - i] = (byte_t)(bitsLow >> (i * 8));
+
+        if (_lengthBytes > 8)
+            _block[_blockBytes - 9] = (byte_t)bitsHigh;
+    }
+
+    _compress(_block, 1);
+    _pending = 0;
+
+    _storeHash();
+
+    return asString();
+}
+
+/******************************************************
+**                     Operators                     **
+******************************************************/
+
+/** Assignment from another BlockHash object.
+ *
+ *  @pre The object is instantiated.
+ *  @post The object contains the values copied from rhs.
+ *  @param rhs The BlockHash object whose values are to be copied/stored.
+ *  @return A reference to the object.
+*/
+BlockHash & BlockHash::operator = (const BlockHash &rhs)
+{
+    if (this != &rhs)
+    {
+        MessageHash::operator = (rhs);
+
+        _blockBytes = rhs._blockBytes;
+        _lengthBytes = rhs._lengthBytes;
+        _lengthLittleEndian = rhs._lengthLittleEndian;
+        _pending = rhs._pending;
+        _messageBytes = rhs._messageBytes;
+        memcpy(_block, rhs._block, sizeof(_block));
+    }
+
+    return *this;
+}
+
+/******************************************************
+**                   Helper Methods                  **
+******************************************************/
+
+/** Append the byte count, the buffered tail and the chaining
+ *  variables to an exported state.
+ *
+ *  @pre none.
+ *  @post The midstate is appended to state.
+ *  @param state The state that is being exported.
+ *  @return none.
+*/
+void BlockHash::_saveState (HashState &state) const
+{
+    state.putWord64(_messageBytes);
+    state.putWord32(_pending);
+    state.putBytes(_block, _pending);
+
+    _saveChaining(state);
+
+    return;
+}
+
+/** Restore the byte count, the buffered tail and the chaining
+ *  variables from an imported state.
+ *
+ *  @pre The common header of state has been read and checked.
+ *  @post The object holds the imported state.
+ *  @param state The state that is being imported.
+ *  @return true The values read are consistent.
+ *  @return false The state is corrupt.
+*/
+bool BlockHash::_loadState (HashState &state)
+{
+    uint64_t messageBytes = state.getWord64();
+    uint32_t pending = state.getWord32();
+
+    // The buffered tail is always the part of the message that does not
+    // fill a whole block.
+    if (   (pending >= _blockBytes)
+        || ((messageBytes % _blockBytes) != pending))
+        return false;
+
+    _messageBytes = messageBytes;
+    _pending = pending;
+    state.getBytes(_block, _pending);
+
+    _loadChaining(state);
+
+    return true;
+}
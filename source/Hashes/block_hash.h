@@ -0,0 +1,290 @@
+/******************************************************************************
+||  block_hash.h                                                             ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    This abstract base class implements the buffering, padding and         ||
+||    streaming logic that is shared by the Merkle-Damgard hash functions    ||
+||    (the SHA family).  A derived class only has to provide its chaining    ||
+||    variables and a block compression function.                            ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    hash_abstract.cpp (hash_abstract.lib)                                  ||
+||    hash_abstract.h                                                        ||
+||                                                                           ||
+||===========================================================================||
+||  REFERENCES                                                               ||
+||===========================================================================||
+||    FIPS 180-4, "Secure Hash Standard".  Aug 2015.  National Institute of  ||
+||        Standards and Technology.                                          ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file block_hash.h
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+#ifndef _GH_BLOCK_HASH_DEF_H
+#define _GH_BLOCK_HASH_DEF_H
+
+#include "hash_abstract.h"
+
+/**
+ *  @class BlockHash An Abstract Base Class (ABC) for hashes that consume
+ *         their message in fixed size blocks and finish with the
+ *         Merkle-Damgard length padding.
+*/
+class BlockHash : public MessageHash
+{
+  public:
+    /******************************************************
+    **                     Constants                     **
+    ******************************************************/
+    static const uint32_t MAX_BLOCK_BYTES = 128;
+
+    /// The number of bytes read from a file per call to update().
+    static const uint32_t FILE_BUFFER_BYTES = 65536;
+
+    /******************************************************
+    **            Constructors / Destructors             **
+    ******************************************************/
+
+    /** Initialize the block buffer.
+     *
+     *  @pre none.
+     *  @post The object is ready to accept message data.
+     *  @param bits The number of bits in the hash.
+     *  @param blockBytes The size of a message block (64 or 128 bytes).
+     *  @param lengthBytes The size of the length field in the final
+     *         block (8 or 16 bytes).
+     *  @param lengthLittleEndian The length field is stored least
+     *         significant byte first (MD5) rather than big endian.
+    */
+    BlockHash (uint32_t bits, uint32_t blockBytes, uint32_t lengthBytes,
+               bool lengthLittleEndian = false);
+
+    /** Copy constructor.
+     *
+     *  @pre none.
+     *  @post A new object is instantiated from the copied BlockHash object
+     *        including any partially processed message.
+     *  @param copyFrom The BlockHash object whose values are to be copied.
+    */
+    BlockHash (const BlockHash &copyFrom);
+
+    /** Default destructor.  */
+    virtual ~BlockHash ();
+
+    /******************************************************
+    **               Accessors / Mutators                **
+    ******************************************************/
+
+    ////////////////////
+    //    Getters
+    ////////////////////
+
+    /** Retrieve the size of a message block.
+     *
+     *  @pre The object is instantiated.
+     *  @post none.
+     *  @return The number of bytes per block (64 or 128).
+    */
+    uint32_t blockBytes (void) const;
+
+    ////////////////////
+    //    Setters
+    ////////////////////
+
+    /** Calculate the hash from an input std::string.
+     *
+     *  @pre The object is instantiated.
+     *  @post The computed hash is stored in the _hash values.
+     *  @param str The string whose value is to be hashed.
+     *  @return The hash as a std::string.
+    */
+    string calculateHash (const string &str);
+
+    /** Calculate the hash from an input data stream.
+     *
+     *  @pre The object is instantiated.
+     *  @post The computed hash is stored in the _hash values.
+     *  @param data The data that is to be hashed.
+     *  @return The hash as a std::string.
+    */
+    string calculateHash (const vector < byte_t > &data);
+
+    /** Calculate the hash of a file.
+     *
+     *  @pre The object is instantiated.
+     *  @post The computed hash is stored in the _hash values.
+     *  @param file The file whose hash value is to be calculated.
+     *  @return The hash as a std::string.
+    */
+    string calculateHash (ifstream &file);
+
+    /** Discard any message data and restart the hash.
+     *
+     *  @pre The object is instantiated.
+     *  @post The chaining variables hold their initial values.
+     *  @return none.
+    */
+    void reset (void);
+
+    /** Append message data to the hash.
+     *
+     *  @pre reset() has been called since the last finalize().
+     *  @post Every complete block has been compressed and the remaining
+     *        bytes are held in the block buffer.
+     *  @param data A pointer to the message data.
+     *  @param length The number of bytes at data.
+     *  @return none.
+    */
+    void update (const byte_t *data, uint64_t length);
+
+    /** Append message data to the hash.
+     *
+     *  @pre reset() has been called since the last finalize().
+     *  @post Every complete block has been compressed and the remaining
+     *        bytes are held in the block buffer.
+     *  @param data The message data.
+     *  @return none.
+    */
+    void update (const vector < byte_t > &data);
+
+    /** Pad the message and produce the hash.
+     *
+     *  @pre reset() has been called since the last finalize().
+     *  @post The computed hash is stored in the _hash values.
+     *  @return The hash as a std::string.
+    */
+    string finalize (void);
+
+    /******************************************************
+    **                     Operators                     **
+    ******************************************************/
+
+    /** Assignment from another BlockHash object.
+     *
+     *  @pre The object is instantiated.
+     *  @post The object contains the values copied from rhs.
+     *  @param rhs The BlockHash object whose values are to be copied/stored.
+     *  @return A reference to the object.
+    */
+    BlockHash & operator = (const BlockHash &rhs);
+
+  protected:
+    /******************************************************
+    **                      Members                      **
+    ******************************************************/
+    uint32_t _blockBytes;      // The size of a message block in bytes.
+    uint32_t _lengthBytes;     // The size of the trailing length field.
+    bool _lengthLittleEndian;  // The length field is little endian.
+    uint32_t _pending;         // The number of bytes held in _block.
+    uint64_t _messageBytes;    // The number of message bytes consumed.
+    byte_t _block[MAX_BLOCK_BYTES];  // A partially filled message block.
+
+    /******************************************************
+    **                   Helper Methods                  **
+    ******************************************************/
+
+    /** Load the initial chaining variables.
+     *
+     *  @pre The object is instantiated.
+     *  @post The chaining variables hold their initial values.
+     *  @return none.
+    */
+    virtual void _initializeHash (void) = 0;
+
+    /** Compress whole message blocks into the chaining variables.
+     *
+     *  @pre The chaining variables have been initialized.
+     *  @post The chaining variables are updated.
+     *  @param blocks A pointer to the first block.
+     *  @param count The number of consecutive blocks at blocks.
+     *  @return none.
+    */
+    virtual void _compress (const byte_t *blocks, uint64_t count) = 0;
+
+    /** Copy the chaining variables into the _hash words.
+     *
+     *  @pre The final block has been compressed.
+     *  @post The _hash values hold the message digest.
+     *  @return none.
+    */
+    virtual void _storeHash (void) = 0;
+
+    /** Append the chaining variables to an exported state.
+     *
+     *  @pre none.
+     *  @post The chaining variables are appended to state.
+     *  @param state The state that is being exported.
+     *  @return none.
+    */
+    virtual void _saveChaining (HashState &state) const = 0;
+
+    /** Restore the chaining variables from an imported state.
+     *
+     *  @pre The block buffer has been read from state.
+     *  @post The chaining variables are restored.
+     *  @param state The state that is being imported.
+     *  @return none.
+    */
+    virtual void _loadChaining (HashState &state) = 0;
+
+    /** Append the byte count, the buffered tail and the chaining
+     *  variables to an exported state.
+     *
+     *  @pre none.
+     *  @post The midstate is appended to state.
+     *  @param state The state that is being exported.
+     *  @return none.
+    */
+    void _saveState (HashState &state) const;
+
+    /** Restore the byte count, the buffered tail and the chaining
+     *  variables from an imported state.
+     *
+     *  @pre The common header of state has been read and checked.
+     *  @post The object holds the imported state.
+     *  @param state The state that is being imported.
+     *  @return true The values read are consistent.
+     *  @return false The state is corrupt.
+    */
+    bool _loadState (HashState &state);
+
+};  // End abstract base class BlockHash.
+
+#endif
@@ -0,0 +1,160 @@
+/******************************************************************************
+||  cpu_features.cpp                                                         ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    Run-time detection of the processor instruction set extensions that    ||
+||    the accelerated hash kernels depend on.  Each algorithm queries this   ||
+||    class once and then dispatches to the fastest kernel that the host     ||
+||    (and the operating system) actually supports.                          ||
+||                                                                           ||
+||===========================================================================||
+||  REFERENCES                                                               ||
+||===========================================================================||
+||    Intel Corporation.  "Intel 64 and IA-32 Architectures Software         ||
+||        Developer's Manual", Volume 2A, CPUID -- CPU Identification.       ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file cpu_features.cpp
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+#include <stdlib.h>
+
+#include "cpu_features.h"
+
+#ifdef GASH_X86_SIMD
+  #include <cpuid.h>
+#endif
+
+/******************************************************
+**                      Getters                      **
+******************************************************/
+
+/** Determine whether the host supports an instruction set extension.
+ *
+ *  @pre none.
+ *  @post The host is probed the first time this is called.
+ *  @param feature The extension that is to be queried.
+ *  @return true The processor and operating system support it.
+ *  @return false The extension is absent or has been disabled.
+*/
+bool CPUFeatures::has (Feature feature)
+{
+    return ((flags() & (uint32_t)feature) != 0);
+}
+
+/** Retrieve the full set of supported extensions.
+ *
+ *  @pre none.
+ *  @post The host is probed the first time this is called.
+ *  @return A bitwise OR of the supported Feature values.
+*/
+uint32_t CPUFeatures::flags (void)
+{
+    static const uint32_t detected = _detect();
+    return detected;
+}
+
+/******************************************************
+**                   Helper Methods                  **
+******************************************************/
+
+/** Probe the processor with CPUID.
+ *
+ *  Setting the GASH_NO_SIMD environment variable masks every extension
+ *  so that the portable kernels can be exercised on any host.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return A bitwise OR of the supported Feature values.
+*/
+uint32_t CPUFeatures::_detect (void)
+{
+    uint32_t features = 0;
+
+    if (getenv("GASH_NO_SIMD") != NULL)
+        return features;
+
+#ifdef GASH_X86_SIMD
+    unsigned int eax, ebx, ecx, edx;
+
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        return features;
+
+    if (edx & (1u << 26))  features |= SSE2;
+    if (ecx & (1u <<  9))  features |= SSSE3;
+    if (ecx & (1u << 19))  features |= SSE41;
+
+    // The AVX register state must also be enabled by the operating
+    // system (XCR0 bits 1 and 2) before any VEX encoded kernel is used.
+    bool osxsave = ((ecx & (1u << 27)) != 0);
+    uint64_t xcr0 = 0;
+
+    if (osxsave)
+    {
+        uint32_t lo, hi;
+        __asm__ __volatile__ ("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+        xcr0 = ((uint64_t)hi << 32) | lo;
+    }
+
+    bool avxState    = osxsave && ((xcr0 & 0x06) == 0x06);
+    bool avx512State = avxState && ((xcr0 & 0xe0) == 0xe0);
+
+    if (avxState && (ecx & (1u << 28)))
+        features |= AVX;
+
+    if (__get_cpuid_max(0, NULL) >= 7)
+    {
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+
+        if ((features & AVX) && (ebx & (1u << 5)))
+            features |= AVX2;
+
+        // Only the F, BW and VL subsets are used by the kernels.
+        const uint32_t avx512Bits = (1u << 16) | (1u << 30) | (1u << 31);
+        if (avx512State && (features & AVX2) &&
+            ((ebx & avx512Bits) == avx512Bits))
+            features |= AVX512;
+
+        // The SHA extensions operate on XMM registers; SSE4.1 is also
+        // required by the kernels that use them.
+        if ((ebx & (1u << 29)) && (features & SSE41))
+            features |= SHA;
+    }
+#endif
+
+    return features;
+}
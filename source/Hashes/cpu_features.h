@@ -0,0 +1,133 @@
+/******************************************************************************
+||  cpu_features.h                                                           ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    Run-time detection of the processor instruction set extensions that    ||
+||    the accelerated hash kernels depend on.  Each algorithm queries this   ||
+||    class once and then dispatches to the fastest kernel that the host     ||
+||    (and the operating system) actually supports.                          ||
+||                                                                           ||
+||===========================================================================||
+||  REFERENCES                                                               ||
+||===========================================================================||
+||    Intel Corporation.  "Intel 64 and IA-32 Architectures Software         ||
+||        Developer's Manual", Volume 2A, CPUID -- CPU Identification.       ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file cpu_features.h
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+#ifndef _GH_CPU_FEATURES_DEF_H
+#define _GH_CPU_FEATURES_DEF_H
+
+#include <stdint.h>
+
+// The SIMD kernels are written with GCC/Clang intrinsics and per-function
+// target attributes, so the rest of the program can still be built for a
+// baseline x86 processor.  Every other compiler/architecture only gets the
+// portable kernels.
+#if (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+  #define GASH_X86_SIMD 1
+#endif
+
+// The round helpers of the compression kernels must be inlined into each
+// kernel (so that constant arguments fold away); GCC's -O2 heuristics do
+// not always do so on their own.
+#if defined(__GNUC__) || defined(__clang__)
+  #define GASH_ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+  #define GASH_ALWAYS_INLINE inline
+#endif
+
+/**
+ *  @class CPUFeatures Queries the instruction set extensions of the host.
+*/
+class CPUFeatures
+{
+  public:
+    /******************************************************
+    **                     Constants                     **
+    ******************************************************/
+    enum Feature
+    {
+        SSE2    = 0x0001,
+        SSSE3   = 0x0002,
+        SSE41   = 0x0004,
+        AVX     = 0x0008,
+        AVX2    = 0x0010,
+        AVX512  = 0x0020,  // AVX-512 F, VL and BW together.
+        SHA     = 0x0040   // The SHA-1/SHA-256 extensions (SHA-NI).
+    };
+
+    /******************************************************
+    **                      Getters                      **
+    ******************************************************/
+
+    /** Determine whether the host supports an instruction set extension.
+     *
+     *  @pre none.
+     *  @post The host is probed the first time this is called.
+     *  @param feature The extension that is to be queried.
+     *  @return true The processor and operating system support it.
+     *  @return false The extension is absent or has been disabled.
+    */
+    static bool has (Feature feature);
+
+    /** Retrieve the full set of supported extensions.
+     *
+     *  @pre none.
+     *  @post The host is probed the first time this is called.
+     *  @return A bitwise OR of the supported Feature values.
+    */
+    static uint32_t flags (void);
+
+  private:
+    /** Probe the processor with CPUID.
+     *
+     *  Setting the GASH_NO_SIMD environment variable masks every extension
+     *  so that the portable kernels can be exercised on any host.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return A bitwise OR of the supported Feature values.
+    */
+    static uint32_t _detect (void);
+
+};  // End class CPUFeatures.
+
+#endif
@@ -4,7 +4,7 @@
 ||                                                                           ||
 ||    Author: Gary Hammock, PE                                               ||
 ||    Creation Date: 2009-12-17                                              ||
-||    Last Edit Date: 2014-03-13                                             ||
+||    Last Edit Date: 2026-10-16                                             ||
 ||                                                                           ||
 ||===========================================================================||
 ||  DESCRIPTION                                                              ||
@@ -17,6 +17,8 @@
 ||===========================================================================||
 ||    hash_abstract.cpp (hash_abstract.lib)                                  ||
 ||    hash_abstract.h                                                        ||
+||    hash_state.cpp (hash_state.lib)                                        ||
+||    hash_state.h                                                           ||
 ||                                                                           ||
 ||===========================================================================||
 ||  REFERENCES                                                               ||
@@ -56,7 +58,12 @@
  *  @date 2014-03-13
 */
 
+#include <string.h>
+
 #include "crc32.h"
+#include "hash_state.h"
+
+const uint32_t CRC32::FILE_BUFFER_BYTES;
 
 // CRC32 Polynomial = x32 + x26 + x23 + x22 + x16
 //                       + x12 + x11 + x10 + x8 + x7
@@ -73,7 +80,8 @@ const uint32_t CRC32::_polynomial = 0xedb88320;
 
 /** Default constructor.  */
 CRC32::CRC32 ()
-    : MessageHash(32)
+    : MessageHash(32),
+      _crc(0xFFFFFFFF)
 {
     _makeTable();
 }
@@ -85,9 +93,12 @@ CRC32::CRC32 ()
  *  @param copyFrom The CRC32 object whose values are to be copied.
 */
 CRC32::CRC32 (const CRC32 &copyFrom)
-    : MessageHash(copyFrom)
+    : MessageHash(copyFrom),
+      _crc(copyFrom._crc)
 {
-    _makeTable();
+    // Copying the table is much cheaper than building it again, which
+    // matters when a hash is forked for many messages.
+    memcpy(_table, copyFrom._table, sizeof(_table));
 }
 
 /** Initialize a CRC32 object by hashing an input std::string.
@@ -98,7 +109,8 @@ CRC32::CRC32 (const CRC32 &copyFrom)
  *  @param str The std::string that is to be hashed.
 */
 CRC32::CRC32 (const string &str)
-    : MessageHash(32)
+    : MessageHash(32),
+      _crc(0xFFFFFFFF)
 {
     _makeTable();
     calculateHash(str);
@@ -112,7 +124,8 @@ CRC32::CRC32 (const string &str)
  *  @param data The data that is to be hashed.
 */
 CRC32::CRC32 (const vector < byte_t > &data)
-    : MessageHash(32)
+    : MessageHash(32),
+      _crc(0xFFFFFFFF)
 {
     _makeTable();
     calculateHash(data);
@@ -126,7 +139,8 @@ CRC32::CRC32 (const vector < byte_t > &data)
  *  @param file A handle to the file that is to be hashed.
 */
 CRC32::CRC32 (ifstream &file)
-    : MessageHash(32)
+    : MessageHash(32),
+      _crc(0xFFFFFFFF)
 {
     _makeTable();
     calculateHash(file);
@@ -139,6 +153,32 @@ CRC32::~CRC32 ()  { }
 **               Accessors / Mutators                **
 ******************************************************/
 
+////////////////////
+//    Getters
+////////////////////
+
+/** Retrieve the name of the algorithm.
+ *
+ *  @pre The object is instantiated.
+ *  @post none.
+ *  @return "CRC-32".
+*/
+string CRC32::algorithmName (void) const
+{
+    return "CRC-32";
+}
+
+/** Copy the object, including any partially processed message.
+ *
+ *  @pre none.
+ *  @post The caller owns (and must delete) the copy.
+ *  @return A new CRC32 object in the same state.
+*/
+CRC32 * CRC32::clone (void) const
+{
+    return new CRC32(*this);
+}
+
 ////////////////////
 //    Setters
 ////////////////////
@@ -164,20 +204,10 @@ string CRC32::calculateHash (const string &str)
 */
 string CRC32::calculateHash (const vector < byte_t > &data)
 {
-    _initialize(32);
-
-    // Compute the Cyclic Redundancy Check of the message
-    // using the precomputed table.
-    _hash.at(0) = 0xFFFFFFFF;
-    for (uint32_t i = 0; i < data.size(); ++i)
-    {
-        _hash.at(0) =  (_hash.at(0) >> 8)
-                      ^ _table[(_hash.at(0) & 0xFF) ^ data.at(i)];
-    }
-
-    _hash.at(0) = ~(_hash.at(0));
+    reset();
+    update(data);
 
-    return asString();
+    return finalize();
 }
 
 /** Calculate the CRC32 value of a file.
@@ -189,35 +219,123 @@ string CRC32::calculateHash (const vector < byte_t > &data)
 */
 string CRC32::calculateHash (ifstream &file)
 {
-    _initialize(32);
+    reset();
 
     // Check that the file is valid before doing anything else.
-    // This will return an MD5 value of all zeros.
+    // This will return a value of all zeros.
     if (file.fail() || !file.good())
+    {
+        _hash.assign(_hash.size(), 0x00000000);
         return asString();
+    }
 
-    byte_t value;  // A byte read from the file.
+    // Read the file in large pieces rather than a byte at a time.
+    vector < byte_t > buffer(FILE_BUFFER_BYTES);
 
+    while (file.good())
+    {
+        file.read((char *)&buffer[0], buffer.size());
+        update(&buffer[0], (uint64_t)file.gcount());
+    }
+
+    // Reset the file flags and return to the file head.
+    file.clear();
+    file.seekg(0);  // Return to the head of the file.
+
+    return finalize();
+}
+
+/** Discard any message data and restart the CRC32 value.
+ *
+ *  @pre The object is instantiated.
+ *  @post The object is ready to accept a new message.
+ *  @return none.
+*/
+void CRC32::reset (void)
+{
+    _crc = 0xFFFFFFFF;
+
+    return;
+}
+
+/** Append message data to the CRC32 value.
+ *
+ *  @pre reset() has been called since the last finalize().
+ *  @post The data has been absorbed into the running value.
+ *  @param data A pointer to the message data.
+ *  @param length The number of bytes at data.
+ *  @return none.
+*/
+void CRC32::update (const byte_t *data, uint64_t length)
+{
     // Compute the Cyclic Redundancy Check of the message
     // using the precomputed table.
-    _hash.at(0) = 0xFFFFFFFF;
-    while (file.peek() != -1)
+    uint32_t crc = _crc;
+
+    for (uint64_t i = 0; i < length; ++i)
+        crc = (crc >> 8) ^ _table[(crc & 0xFF) ^ data[i]];
+
+    _crc = crc;
+
+    return;
+}
+
+/** Append message data to the CRC32 value.
+ *
+ *  @pre reset() has been called since the last finalize().
+ *  @post The data has been absorbed into the running value.
+ *  @param data The message data.
+ *  @return none.
+*/
+void CRC32::update (const vector < byte_t > &data)
+{
+    if (!data.empty())
+        update(&data[0], data.size());
+
+    return;
+}
+
+/** Append a run of zero bytes to the CRC32 value in closed form:
+ *  the register is multiplied by x^(8 * length) modulo the
+ *  polynomial, which takes O(log length) steps.
+ *
+ *  @pre reset() has been called since the last finalize().
+ *  @post The value is as if length zero bytes had been passed to
+ *        update().
+ *  @param length The number of zero bytes.
+ *  @return none.
+*/
+void CRC32::updateZeros (uint64_t length)
+{
+    // A zero byte shifts the register through the table once, which is
+    // cheaper than the multiplication for a short run.
+    if (length < 64)
     {
-        value = file.get();
+        for (uint64_t i = 0; i < length; ++i)
+            _crc = (_crc >> 8) ^ _table[_crc & 0xFF];
 
-        _hash.at(0) =  (_hash.at(0) >> 8)
-                      ^ _table[(_hash.at(0) & 0xFF) ^ value];
+        return;
     }
 
-    _hash.at(0) = ~(_hash.at(0));
+    _crc = _multiply(_zerosFactor(length), _crc);
 
-    // Reset the file flags and return to the file head.
-    file.clear();
-    file.seekg(0);  // Return to the head of the file.
+    return;
+}
+
+/** Complete the CRC32 value of the message.
+ *
+ *  @pre reset() has been called since the last finalize().
+ *  @post The CRC32 value is stored in the _hash values.
+ *  @return The CRC32 value as a std::string.
+*/
+string CRC32::finalize (void)
+{
+    _hash.at(0) = ~_crc;
 
     return asString();
 }
 
+
 /******************************************************
 **                   Helper Methods                  **
 ******************************************************/
@@ -250,4 +368,80 @@ void CRC32::_makeTable (void)
     }
 
     return;
-}
\ No newline at end of file
+}
+
+/** Append the running value to an exported state.
+ *
+ *  @pre none.
+ *  @post The midstate is appended to state.
+ *  @param state The state that is being exported.
+ *  @return none.
+*/
+void CRC32::_saveState (HashState &state) const
+{
+    state.putWord32(_crc);
+
+    return;
+}
+
+/** Restore the running value from an imported state.
+ *
+ *  @pre The common header of state has been read and checked.
+ *  @post The object holds the imported state.
+ *  @param state The state that is being imported.
+ *  @return true The values read are consistent.
+ *  @return false The state is corrupt.
+*/
+bool CRC32::_loadState (HashState &state)
+{
+    _crc = state.getWord32();
+
+    return true;
+}
+
+/** Multiply two polynomials modulo the CRC32 polynomial (in the
+ *  reflected bit order of the register).
+ *
+ *  @param a The first polynomial.
+ *  @param b The second polynomial.
+ *  @return The product.
+*/
+uint32_t CRC32::_multiply (uint32_t a, uint32_t b)
+{
+    // The most significant bit holds x^0.
+    uint32_t product = 0;
+
+    for (uint32_t term = 0x80000000; term != 0; term >>= 1)
+    {
+        if (a & term)
+            product ^= b;
+
+        // b *= x.
+        b = (b & 1) ? ((b >> 1) ^ _polynomial) : (b >> 1);
+    }
+
+    return product;
+}
+
+/** Compute x^(8 * bytes) modulo the CRC32 polynomial, the factor
+ *  that appending that many zero bytes multiplies the register by.
+ *
+ *  @param bytes The number of zero bytes.
+ *  @return The factor.
+*/
+uint32_t CRC32::_zerosFactor (uint64_t bytes)
+{
+    uint32_t factor = 0x80000000,   // x^0
+             power = 0x00800000;    // x^8, then x^16, x^32, ...
+
+    // Square and multiply over the bits of bytes.
+    for (; bytes != 0; bytes >>= 1)
+    {
+        if (bytes & 1)
+            factor = _multiply(power, factor);
+
+        power = _multiply(power, power);
+    }
+
+    return factor;
+}
@@ -4,7 +4,7 @@
 ||                                                                           ||
 ||    Author: Gary Hammock, PE                                               ||
 ||    Creation Date: 2009-12-17                                              ||
-||    Last Edit Date: 2014-03-13                                             ||
+||    Last Edit Date: 2026-10-16                                             ||
 ||                                                                           ||
 ||===========================================================================||
 ||  DESCRIPTION                                                              ||
@@ -68,6 +68,13 @@
 class CRC32 : public MessageHash
 {
   public:
+    /******************************************************
+    **                     Constants                     **
+    ******************************************************/
+
+    /// The number of bytes read from a file per call to update().
+    static const uint32_t FILE_BUFFER_BYTES = 65536;
+
     /******************************************************
     **            Constructors / Destructors             **
     ******************************************************/
@@ -117,6 +124,26 @@ class CRC32 : public MessageHash
     **               Accessors / Mutators                **
     ******************************************************/
 
+    ////////////////////
+    //    Getters
+    ////////////////////
+
+    /** Retrieve the name of the algorithm.
+     *
+     *  @pre The object is instantiated.
+     *  @post none.
+     *  @return "CRC-32".
+    */
+    string algorithmName (void) const;
+
+    /** Copy the object, including any partially processed message.
+     *
+     *  @pre none.
+     *  @post The caller owns (and must delete) the copy.
+     *  @return A new CRC32 object in the same state.
+    */
+    CRC32 * clone (void) const;
+
     ////////////////////
     //    Setters
     ////////////////////
@@ -148,6 +175,53 @@ class CRC32 : public MessageHash
     */
     string calculateHash (ifstream &file);
 
+    /** Discard any message data and restart the CRC32 value.
+     *
+     *  @pre The object is instantiated.
+     *  @post The object is ready to accept a new message.
+     *  @return none.
+    */
+    void reset (void);
+
+    /** Append message data to the CRC32 value.
+     *
+     *  @pre reset() has been called since the last finalize().
+     *  @post The data has been absorbed into the running value.
+     *  @param data A pointer to the message data.
+     *  @param length The number of bytes at data.
+     *  @return none.
+    */
+    void update (const byte_t *data, uint64_t length);
+
+    /** Append message data to the CRC32 value.
+     *
+     *  @pre reset() has been called since the last finalize().
+     *  @post The data has been absorbed into the running value.
+     *  @param data The message data.
+     *  @return none.
+    */
+    void update (const vector < byte_t > &data);
+
+    /** Append a run of zero bytes to the CRC32 value in closed form:
+     *  the register is multiplied by x^(8 * length) modulo the
+     *  polynomial, which takes O(log length) steps.
+     *
+     *  @pre reset() has been called since the last finalize().
+     *  @post The value is as if length zero bytes had been passed to
+     *        update().
+     *  @param length The number of zero bytes.
+     *  @return none.
+    */
+    void updateZeros (uint64_t length);
+
+    /** Complete the CRC32 value of the message.
+     *
+     *  @pre reset() has been called since the last finalize().
+     *  @post The CRC32 value is stored in the _hash values.
+     *  @return The CRC32 value as a std::string.
+    */
+    string finalize (void);
+
   private:
     /******************************************************
     **                      Members                      **
@@ -163,11 +237,31 @@ class CRC32 : public MessageHash
     static const uint32_t _polynomial;
 
     uint32_t _table[256];
+    uint32_t _crc;    // The running (inverted) CRC register.
 
     /******************************************************
     **                   Helper Methods                  **
     ******************************************************/
 
+    /** Append the running value to an exported state.
+     *
+     *  @pre none.
+     *  @post The midstate is appended to state.
+     *  @param state The state that is being exported.
+     *  @return none.
+    */
+    void _saveState (HashState &state) const;
+
+    /** Restore the running value from an imported state.
+     *
+     *  @pre The common header of state has been read and checked.
+     *  @post The object holds the imported state.
+     *  @param state The state that is being imported.
+     *  @return true The values read are consistent.
+     *  @return false The state is corrupt.
+    */
+    bool _loadState (HashState &state);
+
     /** Build the CRC32 table so we can operate on byte values.
      *
      *  @pre none.
@@ -176,6 +270,23 @@ class CRC32 : public MessageHash
     */
     void _makeTable (void);
 
+    /** Multiply two polynomials modulo the CRC32 polynomial (in the
+     *  reflected bit order of the register).
+     *
+     *  @param a The first polynomial.
+     *  @param b The second polynomial.
+     *  @return The product.
+    */
+    static uint32_t _multiply (uint32_t a, uint32_t b);
+
+    /** Compute x^(8 * bytes) modulo the CRC32 polynomial, the factor
+     *  that appending that many zero bytes multiplies the register by.
+     *
+     *  @param bytes The number of zero bytes.
+     *  @return The factor.
+    */
+    static uint32_t _zerosFactor (uint64_t bytes);
+
 };  // End class CRC32.
 
 #endif
\ No newline at end of file
@@ -17,6 +17,8 @@
 ||===========================================================================||
 ||    hash_abstract.cpp (hash_abstract.lib)                                  ||
 ||    hash_abstract.h                                                        ||
+||    hash_state.cpp (hash_state.lib)                                        ||
+||    hash_state.h                                                           ||
 ||                                                                           ||
 ||===========================================================================||
 ||  REFERENCES                                                               ||
@@ -55,6 +57,9 @@
  *  @date 2014-03-13
 */
 #include "elf.h"
+#include "hash_state.h"
+
+const uint32_t ELF::FILE_BUFFER_BYTES;
 
 /******************************************************
 **            Constructors / Destructors             **
@@ -62,7 +67,8 @@
 
 /** Default constructor.  */
 ELF::ELF ()
-    : MessageHash(32)
+    : MessageHash(32),
+      _value(0)
 {}
 
 /** Copy constructor.
@@ -72,7 +78,8 @@ ELF::ELF ()
  *  @param copyFrom The ELF object whose values are to be copied.
 */
 ELF::ELF (const ELF &copyFrom)
-    : MessageHash(copyFrom)
+    : MessageHash(copyFrom),
+      _value(copyFrom._value)
 {}
 
 /** Initialize an ELF object by hashing an input std::string.
@@ -83,7 +90,8 @@ ELF::ELF (const ELF &copyFrom)
  *  @param str The std::string that is to be hashed.
 */
 ELF::ELF (const string &str)
-    : MessageHash(32)
+    : MessageHash(32),
+      _value(0)
 {
     calculateHash(str);
 }
@@ -96,7 +104,8 @@ ELF::ELF (const string &str)
  *  @param data The data that is to be hashed.
 */
 ELF::ELF (const vector < byte_t > &data)
-    : MessageHash(32)
+    : MessageHash(32),
+      _value(0)
 {
     calculateHash(data);
 }
@@ -109,7 +118,8 @@ ELF::ELF (const vector < byte_t > &data)
  *  @param file A handle to the file that is to be hashed.
 */
 ELF::ELF (ifstream &file)
-    : MessageHash(32)
+    : MessageHash(32),
+      _value(0)
 {
     calculateHash(file);
 }
@@ -121,6 +131,32 @@ ELF::~ELF ()  { }
 **               Accessors / Mutators                **
 ******************************************************/
 
+////////////////////
+//    Getters
+////////////////////
+
+/** Retrieve the name of the algorithm.
+ *
+ *  @pre The object is instantiated.
+ *  @post none.
+ *  @return "ELF".
+*/
+string ELF::algorithmName (void) const
+{
+    return "ELF";
+}
+
+/** Copy the object, including any partially processed message.
+ *
+ *  @pre none.
+ *  @post The caller owns (and must delete) the copy.
+ *  @return A new ELF object in the same state.
+*/
+ELF * ELF::clone (void) const
+{
+    return new ELF(*this);
+}
+
 ////////////////////
 //    Setters
 ////////////////////
@@ -146,24 +182,10 @@ string ELF::calculateHash (const string &str)
 */
 string ELF::calculateHash (const vector < byte_t > &data)
 {
-    _initialize(32);
-
-    uint32_t temp;
-
-    vector < byte_t >::const_iterator it;
-    for (it = data.begin(); it != data.end(); ++it)
-    {
-        _hash.at(0) = (_hash.at(0) << 4) + (uint32_t)(*it);
-
-        temp = _hash.at(0) & 0xf0000000;
+    reset();
+    update(data);
 
-        if (temp != 0x00000000)
-            _hash.at(0) ^= (temp >> 24);
-
-        _hash.at(0) &= ~temp;
-    }
-
-    return asString();
+    return finalize();
 }
 
 /** Calculate the ELF value of a file.
@@ -175,33 +197,132 @@ string ELF::calculateHash (const vector < byte_t > &data)
 */
 string ELF::calculateHash (ifstream &file)
 {
-    _initialize(32);
+    reset();
 
     // Check that the file is valid before doing anything else.
-    // This will return an MD5 value of all zeros.
+    // This will return a value of all zeros.
     if (file.fail() || !file.good())
+    {
+        _hash.assign(_hash.size(), 0x00000000);
         return asString();
+    }
 
-    uint32_t temp;
-    byte_t value;
+    // Read the file in large pieces rather than a byte at a time.
+    vector < byte_t > buffer(FILE_BUFFER_BYTES);
 
-    while (file.peek() != -1)
+    while (file.good())
     {
-        value = file.get();
+        file.read((char *)&buffer[0], buffer.size());
+        update(&buffer[0], (uint64_t)file.gcount());
+    }
+
+    // Reset the file flags and return to the file head.
+    file.clear();
+    file.seekg(0);  // Return to the head of the file.
 
-        _hash.at(0) = (_hash.at(0) << 4) + (uint32_t)value;
+    return finalize();
+}
+
+/** Discard any message data and restart the ELF value.
+ *
+ *  @pre The object is instantiated.
+ *  @post The object is ready to accept a new message.
+ *  @return none.
+*/
+void ELF::reset (void)
+{
+    _value = 0;
 
-        temp = _hash.at(0) & 0xf0000000;
+    return;
+}
+
+/** Append message data to the ELF value.
+ *
+ *  @pre reset() has been called since the last finalize().
+ *  @post The data has been absorbed into the running value.
+ *  @param data A pointer to the message data.
+ *  @param length The number of bytes at data.
+ *  @return none.
+*/
+void ELF::update (const byte_t *data, uint64_t length)
+{
+    uint32_t value = _value,
+             temp;
+
+    for (uint64_t i = 0; i < length; ++i)
+    {
+        value = (value << 4) + (uint32_t)data[i];
+
+        temp = value & 0xf0000000;
 
         if (temp != 0x00000000)
-            _hash.at(0) ^= (temp >> 24);
+            value ^= (temp >> 24);
 
-        _hash.at(0) &= ~temp;
+        value &= ~temp;
     }
 
-    // Reset the file flags and return to the file head.
-    file.clear();
-    file.seekg(0);  // Return to the head of the file.
+    _value = value;
+
+    return;
+}
+
+/** Append message data to the ELF value.
+ *
+ *  @pre reset() has been called since the last finalize().
+ *  @post The data has been absorbed into the running value.
+ *  @param data The message data.
+ *  @return none.
+*/
+void ELF::update (const vector < byte_t > &data)
+{
+    if (!data.empty())
+        update(&data[0], data.size());
+
+    return;
+}
+
+/** Complete the ELF value of the message.
+ *
+ *  @pre reset() has been called since the last finalize().
+ *  @post The ELF value is stored in the _hash values.
+ *  @return The ELF value as a std::string.
+*/
+string ELF::finalize (void)
+{
+    _hash.at(0) = _value;
 
     return asString();
-}
\ No newline at end of file
+}
+
+/******************************************************
+**                   Helper Methods                  **
+******************************************************/
+
+/** Append the running value to an exported state.
+ *
+ *  @pre none.
+ *  @post The midstate is appended to state.
+ *  @param state The state that is being exported.
+ *  @return none.
+*/
+void ELF::_saveState (HashState &state) const
+{
+    state.putWord32(_value);
+
+    return;
+}
+
+/** Restore the running value from an imported state.
+ *
+ *  @pre The common header of state has been read and checked.
+ *  @post The object holds the imported state.
+ *  @param state The state that is being imported.
+ *  @return true The values read are consistent.
+ *  @return false The state is corrupt.
+*/
+bool ELF::_loadState (HashState &state)
+{
+    _value = state.getWord32();
+
+    return true;
+}
@@ -67,6 +67,13 @@
 class ELF : public MessageHash
 {
   public:
+    /******************************************************
+    **                     Constants                     **
+    ******************************************************/
+
+    /// The number of bytes read from a file per call to update().
+    static const uint32_t FILE_BUFFER_BYTES = 65536;
+
     /******************************************************
     **            Constructors / Destructors             **
     ******************************************************/
@@ -116,6 +123,26 @@ class ELF : public MessageHash
     **               Accessors / Mutators                **
     ******************************************************/
 
+    ////////////////////
+    //    Getters
+    ////////////////////
+
+    /** Retrieve the name of the algorithm.
+     *
+     *  @pre The object is instantiated.
+     *  @post none.
+     *  @return "ELF".
+    */
+    string algorithmName (void) const;
+
+    /** Copy the object, including any partially processed message.
+     *
+     *  @pre none.
+     *  @post The caller owns (and must delete) the copy.
+     *  @return A new ELF object in the same state.
+    */
+    ELF * clone (void) const;
+
     ////////////////////
     //    Setters
     ////////////////////
@@ -147,6 +174,70 @@ class ELF : public MessageHash
     */
     string calculateHash (ifstream &file);
 
+    /** Discard any message data and restart the ELF value.
+     *
+     *  @pre The object is instantiated.
+     *  @post The object is ready to accept a new message.
+     *  @return none.
+    */
+    void reset (void);
+
+    /** Append message data to the ELF value.
+     *
+     *  @pre reset() has been called since the last finalize().
+     *  @post The data has been absorbed into the running value.
+     *  @param data A pointer to the message data.
+     *  @param length The number of bytes at data.
+     *  @return none.
+    */
+    void update (const byte_t *data, uint64_t length);
+
+    /** Append message data to the ELF value.
+     *
+     *  @pre reset() has been called since the last finalize().
+     *  @post The data has been absorbed into the running value.
+     *  @param data The message data.
+     *  @return none.
+    */
+    void update (const vector < byte_t > &data);
+
+    /** Complete the ELF value of the message.
+     *
+     *  @pre reset() has been called since the last finalize().
+     *  @post The ELF value is stored in the _hash values.
+     *  @return The ELF value as a std::string.
+    */
+    string finalize (void);
+
+  private:
+    /******************************************************
+    **                      Members                      **
+    ******************************************************/
+    uint32_t _value;  // The running hash value.
+
+    /******************************************************
+    **                   Helper Methods                  **
+    ******************************************************/
+
+    /** Append the running value to an exported state.
+     *
+     *  @pre none.
+     *  @post The midstate is appended to state.
+     *  @param state The state that is being exported.
+     *  @return none.
+    */
+    void _saveState (HashState &state) const;
+
+    /** Restore the running value from an imported state.
+     *
+     *  @pre The common header of state has been read and checked.
+     *  @post The object holds the imported state.
+     *  @param state The state that is being imported.
+     *  @return true The values read are consistent.
+     *  @return false The state is corrupt.
+    */
+    bool _loadState (HashState &state);
+
 };  // End class ELF.
 
 #endif
\ No newline at end of file
@@ -4,7 +4,7 @@
 ||                                                                           ||
 ||    Author: Gary Hammock, PE                                               ||
 ||    Creation Date: 2014-02-27                                              ||
-||    Last Edit Date: 2014-03-13                                             ||
+||    Last Edit Date: 2026-10-16                                             ||
 ||                                                                           ||
 ||===========================================================================||
 ||  DESCRIPTION                                                              ||
@@ -46,7 +46,15 @@
  *  @date 2014-03-13
 */
 
+#include <string.h>
+
 #include "hash_abstract.h"
+#include "hash_state.h"
+
+const uint32_t MessageHash::STATE_VERSION;
+
+/// Identifies an exported midstate.
+static const byte_t STATE_MAGIC[4] = { 'G', 'H', 'S', 'T' };
 
 /******************************************************
 **            Constructors / Destructors             **
@@ -120,6 +128,149 @@ void MessageHash::asArray (uint32_t store[]) const
     return;
 }
 
+/** Retrieve the MessageHash value as a byte string.
+ *
+ *  @pre The object is instantiated.
+ *  @post none.
+ *  @return The bytes of the hash in the order that asString()
+ *          prints them.
+*/
+vector < byte_t > MessageHash::asBytes (void) const
+{
+    vector < byte_t > bytes;
+    bytes.reserve(_hash.size() * 4);
+
+    vector < uint32_t >::const_iterator it;
+    for (it = _hash.begin(); it != _hash.end(); ++it)
+    {
+        bytes.push_back((byte_t)(*it >> 24));
+        bytes.push_back((byte_t)(*it >> 16));
+        bytes.push_back((byte_t)(*it >>  8));
+        bytes.push_back((byte_t)(*it      ));
+    }
+
+    return bytes;
+}
+
+/** Retrieve the name of the kernel that the host selected for the
+ *  algorithm.
+ *
+ *  @pre The object is instantiated.
+ *  @post none.
+ *  @return "portable" (algorithms with SIMD kernels override this).
+*/
+string MessageHash::kernelName (void) const
+{
+    return "portable";
+}
+
+/** Serialize the intermediate state (the midstate) of the message
+ *  that is being hashed.
+ *
+ *  @pre update() may have been called since the last reset().
+ *  @post none.
+ *  @return The state as a portable byte string.
+*/
+vector < byte_t > MessageHash::exportState (void) const
+{
+    HashState state;
+
+    state.putBytes(STATE_MAGIC, sizeof(STATE_MAGIC));
+    state.putWord32(STATE_VERSION);
+    state.putString(algorithmName());
+    state.putWord32((uint32_t)_hash.size() * 32);
+
+    _saveState(state);
+
+    return state.bytes();
+}
+
+////////////////////
+//    Setters
+////////////////////
+
+/** Replace the hash value with a digest that was stored earlier
+ *  (for example in a cache), so that it prints like a calculated one.
+ *
+ *  @pre none.
+ *  @post The _hash values hold the digest.
+ *  @param bytes The digest, in the order that asBytes() returns.
+ *  @return true The digest was stored.
+ *  @return false bytes is not the length of the hash.
+*/
+bool MessageHash::setHash (const vector < byte_t > &bytes)
+{
+    if (bytes.size() != (_hash.size() * 4))
+        return false;
+
+    for (size_t i = 0; i < _hash.size(); ++i)
+    {
+        _hash[i] = ((uint32_t)bytes[(i * 4)    ] << 24)
+                 | ((uint32_t)bytes[(i * 4) + 1] << 16)
+                 | ((uint32_t)bytes[(i * 4) + 2] <<  8)
+                 | ((uint32_t)bytes[(i * 4) + 3]      );
+    }
+
+    return true;
+}
+
+/** Append a run of zero bytes to the hash (a hole of a sparse file).
+ *
+ *  @pre reset() has been called since the last finalize().
+ *  @post The hash is as if length zero bytes had been passed to
+ *        update().
+ *  @param length The number of zero bytes.
+ *  @return none.
+*/
+void MessageHash::updateZeros (uint64_t length)
+{
+    static const byte_t zeros[65536] = { 0 };
+
+    while (length > 0)
+    {
+        uint64_t run = (length < sizeof(zeros)) ? length : sizeof(zeros);
+        update(zeros, run);
+        length -= run;
+    }
+
+    return;
+}
+
+/** Resume a message from a state that exportState() produced.
+ *
+ *  @pre The object is of the same algorithm (and digest size) as the
+ *       one that exported the state.
+ *  @post On success the object holds the imported state.  A state
+ *        that is malformed leaves the object reset.
+ *  @param state The serialized state.
+ *  @return true The state was imported.
+ *  @return false The state is of another algorithm or version, or is
+ *          corrupt.
+*/
+bool MessageHash::importState (const vector < byte_t > &state)
+{
+    HashState reader(state);
+
+    byte_t magic[sizeof(STATE_MAGIC)];
+    reader.getBytes(magic, sizeof(magic));
+
+    // The object is left untouched unless the header matches.
+    if (   (memcmp(magic, STATE_MAGIC, sizeof(magic)) != 0)
+        || (reader.getWord32() != STATE_VERSION)
+        || (reader.getString() != algorithmName())
+        || (reader.getWord32() != (uint32_t)_hash.size() * 32)
+        || !reader.good()
+       )
+        return false;
+
+    if (_loadState(reader) && reader.good() && reader.atEnd())
+        return true;
+
+    reset();
+
+    return false;
+}
+
 /******************************************************
 **                     Operators                     **
 ******************************************************/
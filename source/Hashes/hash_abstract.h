@@ -4,7 +4,7 @@
 ||                                                                           ||
 ||    Author: Gary Hammock, PE                                               ||
 ||    Creation Date: 2014-02-27                                              ||
-||    Last Edit Date: 2014-03-13                                             ||
+||    Last Edit Date: 2026-10-16                                             ||
 ||                                                                           ||
 ||===========================================================================||
 ||  DESCRIPTION                                                              ||
@@ -43,7 +43,7 @@
 
 /** @file hash_abstract.h
  *  @author Gary Hammock, PE
- *  @date 2014-03-13
+ *  @date 2026-10-16
 */
 
 #ifndef _GH_HASH_ABC_DEF_H
@@ -55,6 +55,7 @@
 #include <sstream>
 #include <iomanip>
 #include <vector>
+#include <stdint.h>
 
 using std::ostream;
 using std::ifstream;
@@ -69,10 +70,11 @@ using std::hex;
 ///////////////////////////////////////
 //    Type definitions
 ////////////////////////
+// The fixed-width integer types come from <stdint.h>; redefining them here
+// conflicts with the C library headers pulled in by <iostream>.
 typedef unsigned char      byte_t;
-typedef unsigned short     uint16_t;
-typedef unsigned int       uint32_t;
-typedef unsigned long long uint64_t;
+
+class HashState;
 
 /**
  *  @class Hash An Abstract Base Class (ABC) for use in implementing
@@ -81,6 +83,13 @@ typedef unsigned long long uint64_t;
 class MessageHash
 {
   public:
+    /******************************************************
+    **                     Constants                     **
+    ******************************************************/
+
+    /// The layout version of exportState(); importState() rejects others.
+    static const uint32_t STATE_VERSION = 1;
+
     /******************************************************
     **            Constructors / Destructors             **
     ******************************************************/
@@ -135,6 +144,55 @@ class MessageHash
     */
     void asArray (uint32_t store[]) const;
 
+    /** Retrieve the MessageHash value as a byte string.
+     *
+     *  @pre The object is instantiated.
+     *  @post none.
+     *  @return The bytes of the hash in the order that asString()
+     *          prints them.
+    */
+    vector < byte_t > asBytes (void) const;
+
+    /** Retrieve the name of the algorithm (and variant).
+     *
+     *  @pre The object is instantiated.
+     *  @post none.
+     *  @return The name, e.g. "SHA-256".
+    */
+    virtual string algorithmName (void) const = 0;
+
+    /** Retrieve the name of the kernel that the host selected for the
+     *  algorithm (for reports such as gash --perf).
+     *
+     *  @pre The object is instantiated.
+     *  @post none.
+     *  @return The name, e.g. "AVX2", or "portable" where the algorithm
+     *          has a single kernel.
+    */
+    virtual string kernelName (void) const;
+
+    /** Fork the hash mid-stream.  The copy holds the chaining values,
+     *  the byte count and any buffered partial block, so a message
+     *  prefix that many messages share is compressed only once and
+     *  each copy then continues with its own suffix.
+     *
+     *  @pre none.
+     *  @post The caller owns (and must delete) the copy.
+     *  @return A new object of the same algorithm in the same state.
+    */
+    virtual MessageHash * clone (void) const = 0;
+
+    /** Serialize the intermediate state (the midstate) of the message
+     *  that is being hashed: the chaining variables, the byte count and
+     *  any buffered tail.  The state carries a version number and the
+     *  algorithm name so that it cannot be imported into the wrong hash.
+     *
+     *  @pre update() may have been called since the last reset().
+     *  @post none.
+     *  @return The state as a portable byte string.
+    */
+    vector < byte_t > exportState (void) const;
+
     ////////////////////
     //    Setters
     ////////////////////
@@ -166,6 +224,69 @@ class MessageHash
     */
     virtual string calculateHash (ifstream &file) = 0;
 
+    /** Discard any message data and restart the hash.
+     *
+     *  @pre The object is instantiated.
+     *  @post The object is ready to accept a new message.
+     *  @return none.
+    */
+    virtual void reset (void) = 0;
+
+    /** Append message data to the hash.
+     *
+     *  @pre reset() has been called since the last finalize().
+     *  @post The data has been absorbed into the hash state.
+     *  @param data A pointer to the message data.
+     *  @param length The number of bytes at data.
+     *  @return none.
+    */
+    virtual void update (const byte_t *data, uint64_t length) = 0;
+
+    /** Append a run of zero bytes to the hash (a hole of a sparse file).
+     *  The zeros are hashed from a shared zero buffer, so nothing is
+     *  read; algorithms that can skip the run in closed form override it.
+     *
+     *  @pre reset() has been called since the last finalize().
+     *  @post The hash is as if length zero bytes had been passed to
+     *        update().
+     *  @param length The number of zero bytes.
+     *  @return none.
+    */
+    virtual void updateZeros (uint64_t length);
+
+    /** Complete the hash of the message.
+     *
+     *  @pre reset() has been called since the last finalize().
+     *  @post The computed hash is stored in the _hash values.
+     *  @return The hash as a std::string.
+    */
+    virtual string finalize (void) = 0;
+
+    /** Replace the hash value with a digest that was stored earlier
+     *  (for example in a cache), so that it prints like a calculated one.
+     *
+     *  @pre none.
+     *  @post The _hash values hold the digest.
+     *  @param bytes The digest, in the order that asBytes() returns.
+     *  @return true The digest was stored.
+     *  @return false bytes is not the length of the hash.
+    */
+    bool setHash (const vector < byte_t > &bytes);
+
+    /** Resume a message from a state that exportState() produced, in
+     *  this or another process.  Hashing then continues with update().
+     *
+     *  @pre The object is of the same algorithm (and digest size) as the
+     *       one that exported the state.
+     *  @post On success the object holds the imported state.  A state
+     *        that is malformed leaves the object reset.
+     *  @param state The serialized state.
+     *  @return true The state was imported.
+     *  @return false The state is of another algorithm or version, or is
+     *          corrupt.
+    */
+    bool importState (const vector < byte_t > &state);
+
     /******************************************************
     **                     Operators                     **
     ******************************************************/
@@ -238,6 +359,25 @@ class MessageHash
     */
     bool _isLittleEndian (void) const;
 
+    /** Append the algorithm specific part of the midstate.
+     *
+     *  @pre none.
+     *  @post The state is appended to state.
+     *  @param state The state that is being exported.
+     *  @return none.
+    */
+    virtual void _saveState (HashState &state) const = 0;
+
+    /** Restore the algorithm specific part of the midstate.
+     *
+     *  @pre The common header of state has been read and checked.
+     *  @post The object holds the imported state.
+     *  @param state The state that is being imported.
+     *  @return true The values read are consistent.
+     *  @return false The state is corrupt.
+    */
+    virtual bool _loadState (HashState &state) = 0;
+
     /** Perform a bitwise left circular-shift.
      *
      *  @param x The value to shift.
@@ -0,0 +1,380 @@
+/******************************************************************************
+||  hash_state.cpp                                                           ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    A byte buffer that the hash algorithms write their intermediate state  ||
+||    (midstate) into, and read it back from, so that a long computation can ||
+||    be checkpointed and resumed in another process.                        ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    hash_abstract.cpp (hash_abstract.lib)                                  ||
+||    hash_abstract.h                                                        ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file hash_state.cpp
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+
+#include <string.h>
+
+#include "hash_state.h"
+
+/******************************************************
+**            Constructors / Destructors             **
+******************************************************/
+
+/** Default constructor (an empty state that is to be written).  */
+HashState::HashState ()
+    : _position(0),
+      _good(true)
+{}
+
+/** Initialize a HashState object that is to be read.
+ *
+ *  @pre none.
+ *  @post The read position is at the start of bytes.
+ *  @param bytes A state that was previously written.
+*/
+HashState::HashState (const vector < byte_t > &bytes)
+    : _bytes(bytes),
+      _position(0),
+      _good(true)
+{}
+
+/** Default destructor.  */
+HashState::~HashState ()  { }
+
+/******************************************************
+**               Accessors / Mutators                **
+******************************************************/
+
+////////////////////
+//    Getters
+////////////////////
+
+/** Retrieve the serialized state.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return The bytes that have been written.
+*/
+const vector < byte_t > & HashState::bytes (void) const
+{
+    return _bytes;
+}
+
+/** Determine whether every read so far was within the buffer.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return true No read has run past the end of the state.
+ *  @return false The state is truncated (or the wrong type).
+*/
+bool HashState::good (void) const
+{
+    return _good;
+}
+
+/** Determine whether the whole state has been read.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return true The read position is at the end of the state.
+ *  @return false Bytes remain to be read.
+*/
+bool HashState::atEnd (void) const
+{
+    return (_position == _bytes.size());
+}
+
+/** Read a 32-bit value.
+ *
+ *  @pre none.
+ *  @post The read position advances by four bytes.
+ *  @return The value (zero past the end of the state).
+*/
+uint32_t HashState::getWord32 (void)
+{
+    if (!_available(4))
+        return 0;
+
+    const byte_t *p = &_bytes[_position];
+    _position += 4;
+
+    return   ((uint32_t)p[0]      ) | ((uint32_t)p[1] <<  8)
+           | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/** Read a 64-bit value.
+ *
+ *  @pre none.
+ *  @post The read position advances by eight bytes.
+ *  @return The value (zero past the end of the state).
+*/
+uint64_t HashState::getWord64 (void)
+{
+    uint64_t low = getWord32();
+
+    return low | ((uint64_t)getWord32() << 32);
+}
+
+/** Read an array of 32-bit values.
+ *
+ *  @pre none.
+ *  @post The read position advances by 4 * count bytes.
+ *  @param words The array that is to receive the values.
+ *  @param count The number of values.
+ *  @return none.
+*/
+void HashState::getWords32 (uint32_t words[], uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i)
+        words[i] = getWord32();
+
+    return;
+}
+
+/** Read an array of 64-bit values.
+ *
+ *  @pre none.
+ *  @post The read position advances by 8 * count bytes.
+ *  @param words The array that is to receive the values.
+ *  @param count The number of values.
+ *  @return none.
+*/
+void HashState::getWords64 (uint64_t words[], uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i)
+        words[i] = getWord64();
+
+    return;
+}
+
+/** Read raw bytes.
+ *
+ *  @pre none.
+ *  @post The read position advances by length bytes.
+ *  @param data The buffer that is to receive the bytes.
+ *  @param length The number of bytes.
+ *  @return none.
+*/
+void HashState::getBytes (byte_t data[], uint32_t length)
+{
+    if (!_available(length))
+    {
+        memset(data, 0, length);
+        return;
+    }
+
+    if (length > 0)
+        memcpy(data, &_bytes[_position], length);
+
+    _position += length;
+
+    return;
+}
+
+/** Read a length prefixed byte string.
+ *
+ *  @pre none.
+ *  @post The read position advances past the string.
+ *  @return The bytes (empty past the end of the state).
+*/
+vector < byte_t > HashState::getBlob (void)
+{
+    uint32_t length = getWord32();
+
+    if (!_available(length))
+        return vector < byte_t >();
+
+    vector < byte_t > data(_bytes.begin() + _position,
+                           _bytes.begin() + _position + length);
+    _position += length;
+
+    return data;
+}
+
+/** Read a length prefixed std::string.
+ *
+ *  @pre none.
+ *  @post The read position advances past the string.
+ *  @return The string (empty past the end of the state).
+*/
+string HashState::getString (void)
+{
+    vector < byte_t > data = getBlob();
+
+    return string(data.begin(), data.end());
+}
+
+////////////////////
+//    Setters
+////////////////////
+
+/** Append a 32-bit value.
+ *
+ *  @pre none.
+ *  @post The value is appended to the state.
+ *  @param value The value that is to be stored.
+ *  @return none.
+*/
+void HashState::putWord32 (uint32_t value)
+{
+    _bytes.push_back((byte_t)(value      ));
+    _bytes.push_back((byte_t)(value >>  8));
+    _bytes.push_back((byte_t)(value >> 16));
+    _bytes.push_back((byte_t)(value >> 24));
+
+    return;
+}
+
+/** Append a 64-bit value.
+ *
+ *  @pre none.
+ *  @post The value is appended to the state.
+ *  @param value The value that is to be stored.
+ *  @return none.
+*/
+void HashState::putWord64 (uint64_t value)
+{
+    putWord32((uint32_t)value);
+    putWord32((uint32_t)(value >> 32));
+
+    return;
+}
+
+/** Append an array of 32-bit values.
+ *
+ *  @pre none.
+ *  @post The values are appended to the state.
+ *  @param words The values that are to be stored.
+ *  @param count The number of values.
+ *  @return none.
+*/
+void HashState::putWords32 (const uint32_t words[], uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i)
+        putWord32(words[i]);
+
+    return;
+}
+
+/** Append an array of 64-bit values.
+ *
+ *  @pre none.
+ *  @post The values are appended to the state.
+ *  @param words The values that are to be stored.
+ *  @param count The number of values.
+ *  @return none.
+*/
+void HashState::putWords64 (const uint64_t words[], uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i)
+        putWord64(words[i]);
+
+    return;
+}
+
+/** Append raw bytes.
+ *
+ *  @pre none.
+ *  @post The bytes are appended to the state.
+ *  @param data A pointer to the bytes.
+ *  @param length The number of bytes.
+ *  @return none.
+*/
+void HashState::putBytes (const byte_t data[], uint32_t length)
+{
+    _bytes.insert(_bytes.end(), data, data + length);
+
+    return;
+}
+
+/** Append a length prefixed byte string.
+ *
+ *  @pre none.
+ *  @post The length and bytes are appended to the state.
+ *  @param data The bytes that are to be stored.
+ *  @return none.
+*/
+void HashState::putBlob (const vector < byte_t > &data)
+{
+    putWord32((uint32_t)data.size());
+    _bytes.insert(_bytes.end(), data.begin(), data.end());
+
+    return;
+}
+
+/** Append a length prefixed std::string.
+ *
+ *  @pre none.
+ *  @post The length and characters are appended to the state.
+ *  @param str The string that is to be stored.
+ *  @return none.
+*/
+void HashState::putString (const string &str)
+{
+    putBlob(vector < byte_t >(str.begin(), str.end()));
+
+    return;
+}
+
+/******************************************************
+**                   Helper Methods                  **
+******************************************************/
+
+/** Check that a read of length bytes fits in the state.
+ *
+ *  @pre none.
+ *  @post _good is cleared (and the read position moved to the end)
+ *        if it does not.
+ *  @param length The number of bytes that are to be read.
+ *  @return true The bytes are available.
+ *  @return false The state is too short.
+*/
+bool HashState::_available (uint64_t length)
+{
+    if (_good && (length <= (_bytes.size() - _position)))
+        return true;
+
+    _good = false;
+    _position = _bytes.size();
+
+    return false;
+}
@@ -0,0 +1,275 @@
+/******************************************************************************
+||  hash_state.h                                                             ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    A byte buffer that the hash algorithms write their intermediate state  ||
+||    (midstate) into, and read it back from, so that a long computation can ||
+||    be checkpointed and resumed in another process.                        ||
+||                                                                           ||
+||    Every value is stored little endian with a fixed width, so a state     ||
+||    that is exported on one host can be imported on any other.  Reads past ||
+||    the end of the buffer do not fail immediately; they yield zeros and    ||
+||    clear the good() flag, which the caller checks once at the end.        ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    hash_abstract.cpp (hash_abstract.lib)                                  ||
+||    hash_abstract.h                                                        ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file hash_state.h
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+
+#ifndef _GH_HASH_STATE_DEF_H
+#define _GH_HASH_STATE_DEF_H
+
+#include "hash_abstract.h"
+
+/**
+ *  @class HashState A serialized hash midstate.
+*/
+class HashState
+{
+  public:
+    /******************************************************
+    **            Constructors / Destructors             **
+    ******************************************************/
+
+    /** Default constructor (an empty state that is to be written).  */
+    HashState ();
+
+    /** Initialize a HashState object that is to be read.
+     *
+     *  @pre none.
+     *  @post The read position is at the start of bytes.
+     *  @param bytes A state that was previously written.
+    */
+    HashState (const vector < byte_t > &bytes);
+
+    /** Default destructor.  */
+    ~HashState ();
+
+    /******************************************************
+    **               Accessors / Mutators                **
+    ******************************************************/
+
+    ////////////////////
+    //    Getters
+    ////////////////////
+
+    /** Retrieve the serialized state.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return The bytes that have been written.
+    */
+    const vector < byte_t > & bytes (void) const;
+
+    /** Determine whether every read so far was within the buffer.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return true No read has run past the end of the state.
+     *  @return false The state is truncated (or the wrong type).
+    */
+    bool good (void) const;
+
+    /** Determine whether the whole state has been read.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return true The read position is at the end of the state.
+     *  @return false Bytes remain to be read.
+    */
+    bool atEnd (void) const;
+
+    /** Read a 32-bit value.
+     *
+     *  @pre none.
+     *  @post The read position advances by four bytes.
+     *  @return The value (zero past the end of the state).
+    */
+    uint32_t getWord32 (void);
+
+    /** Read a 64-bit value.
+     *
+     *  @pre none.
+     *  @post The read position advances by eight bytes.
+     *  @return The value (zero past the end of the state).
+    */
+    uint64_t getWord64 (void);
+
+    /** Read an array of 32-bit values.
+     *
+     *  @pre none.
+     *  @post The read position advances by 4 * count bytes.
+     *  @param words The array that is to receive the values.
+     *  @param count The number of values.
+     *  @return none.
+    */
+    void getWords32 (uint32_t words[], uint32_t count);
+
+    /** Read an array of 64-bit values.
+     *
+     *  @pre none.
+     *  @post The read position advances by 8 * count bytes.
+     *  @param words The array that is to receive the values.
+     *  @param count The number of values.
+     *  @return none.
+    */
+    void getWords64 (uint64_t words[], uint32_t count);
+
+    /** Read raw bytes.
+     *
+     *  @pre none.
+     *  @post The read position advances by length bytes.
+     *  @param data The buffer that is to receive the bytes.
+     *  @param length The number of bytes.
+     *  @return none.
+    */
+    void getBytes (byte_t data[], uint32_t length);
+
+    /** Read a length prefixed byte string.
+     *
+     *  @pre none.
+     *  @post The read position advances past the string.
+     *  @return The bytes (empty past the end of the state).
+    */
+    vector < byte_t > getBlob (void);
+
+    /** Read a length prefixed std::string.
+     *
+     *  @pre none.
+     *  @post The read position advances past the string.
+     *  @return The string (empty past the end of the state).
+    */
+    string getString (void);
+
+    ////////////////////
+    //    Setters
+    ////////////////////
+
+    /** Append a 32-bit value.
+     *
+     *  @pre none.
+     *  @post The value is appended to the state.
+     *  @param value The value that is to be stored.
+     *  @return none.
+    */
+    void putWord32 (uint32_t value);
+
+    /** Append a 64-bit value.
+     *
+     *  @pre none.
+     *  @post The value is appended to the state.
+     *  @param value The value that is to be stored.
+     *  @return none.
+    */
+    void putWord64 (uint64_t value);
+
+    /** Append an array of 32-bit values.
+     *
+     *  @pre none.
+     *  @post The values are appended to the state.
+     *  @param words The values that are to be stored.
+     *  @param count The number of values.
+     *  @return none.
+    */
+    void putWords32 (const uint32_t words[], uint32_t count);
+
+    /** Append an array of 64-bit values.
+     *
+     *  @pre none.
+     *  @post The values are appended to the state.
+     *  @param words The values that are to be stored.
+     *  @param count The number of values.
+     *  @return none.
+    */
+    void putWords64 (const uint64_t words[], uint32_t count);
+
+    /** Append raw bytes.
+     *
+     *  @pre none.
+     *  @post The bytes are appended to the state.
+     *  @param data A pointer to the bytes.
+     *  @param length The number of bytes.
+     *  @return none.
+    */
+    void putBytes (const byte_t data[], uint32_t length);
+
+    /** Append a length prefixed byte string.
+     *
+     *  @pre none.
+     *  @post The length and bytes are appended to the state.
+     *  @param data The bytes that are to be stored.
+     *  @return none.
+    */
+    void putBlob (const vector < byte_t > &data);
+
+    /** Append a length prefixed std::string.
+     *
+     *  @pre none.
+     *  @post The length and characters are appended to the state.
+     *  @param str The string that is to be stored.
+     *  @return none.
+    */
+    void putString (const string &str);
+
+  private:
+    /******************************************************
+    **                      Members                      **
+    ******************************************************/
+    vector < byte_t > _bytes;  // The serialized state.
+    size_t _position;          // The read position in _bytes.
+    bool _good;                // No read has run past the end.
+
+    /** Check that a read of length bytes fits in the state.
+     *
+     *  @pre none.
+     *  @post _good is cleared (and the read position moved to the end)
+     *        if it does not.
+     *  @param length The number of bytes that are to be read.
+     *  @return true The bytes are available.
+     *  @return false The state is too short.
+    */
+    bool _available (uint64_t length);
+
+};  // End class HashState.
+
+#endif
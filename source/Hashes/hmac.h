@@ -0,0 +1,659 @@
+/******************************************************************************
+||  hmac.h                                                                   ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    A keyed-hash message authentication code (HMAC) built on any of the    ||
+||    Merkle-Damgard hashes (SHA-1 and the SHA-2 family).  The key is folded ||
+||    into the compression state once, when it is set: the states after the  ||
+||    ipad and opad blocks are kept, so that each message costs only its own ||
+||    blocks plus a single outer block, however many messages are            ||
+||    authenticated with the same key.                                       ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    block_hash.cpp (block_hash.lib)                                        ||
+||    block_hash.h                                                           ||
+||    hash_state.cpp (hash_state.lib)                                        ||
+||    hash_state.h                                                           ||
+||                                                                           ||
+||===========================================================================||
+||  REFERENCES                                                               ||
+||===========================================================================||
+||    Krawczyk, H., Bellare, M. and Canetti, R.  "HMAC: Keyed-Hashing for    ||
+||        Message Authentication", RFC 2104, 1997.                           ||
+||                                                                           ||
+||    National Institute of Standards and Technology.  "The Keyed-Hash       ||
+||        Message Authentication Code (HMAC)", FIPS PUB 198-1, 2008.         ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file hmac.h
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+
+#ifndef _GH_HMAC_DEF_H
+#define _GH_HMAC_DEF_H
+
+#include "block_hash.h"
+#include "hash_state.h"
+
+/**
+ *  @class HMAC An abstract data type to calculate and manipulate
+ *         HMAC values keyed over the hash H.
+ *
+ *  H must be a BlockHash (SHA1, SHA224, SHA256, SHA384, SHA512 or
+ *  SHA512_256) that is default constructible and copyable.
+*/
+template < class H >
+class HMAC : public MessageHash
+{
+  public:
+    /******************************************************
+    **            Constructors / Destructors             **
+    ******************************************************/
+
+    /** Default constructor (an empty key).  */
+    HMAC ();
+
+    /** Initialize an HMAC object with a secret key.
+     *
+     *  @pre none.
+     *  @post A new object is instantiated and keyed.
+     *  @param key A pointer to the key bytes.
+     *  @param length The number of bytes in the key.
+    */
+    HMAC (const byte_t *key, uint32_t length);
+
+    /** Initialize an HMAC object with a secret key.
+     *
+     *  @pre none.
+     *  @post A new object is instantiated and keyed.
+     *  @param key The key bytes.
+    */
+    HMAC (const vector < byte_t > &key);
+
+    /** Copy constructor.
+     *
+     *  @pre none.
+     *  @post A new object is instantiated from the copied HMAC object
+     *        (including its key and any pending message data).
+     *  @param copyFrom The HMAC object whose values are to be copied.
+    */
+    HMAC (const HMAC < H > &copyFrom);
+
+    /** Default destructor.  */
+    ~HMAC ();
+
+    /******************************************************
+    **               Accessors / Mutators                **
+    ******************************************************/
+
+    ////////////////////
+    //    Getters
+    ////////////////////
+
+    /** Retrieve the name of the algorithm.
+     *
+     *  @pre The object is instantiated.
+     *  @post none.
+     *  @return "HMAC-" followed by the name of H.
+    */
+    string algorithmName (void) const;
+
+    /** Retrieve the name of the kernel of H.
+     *
+     *  @pre The object is instantiated.
+     *  @post none.
+     *  @return The kernel that H selected.
+    */
+    string kernelName (void) const;
+
+    /** Copy the object, including its key and any partially processed
+     *  message.
+     *
+     *  @pre none.
+     *  @post The caller owns (and must delete) the copy.
+     *  @return A new HMAC object in the same state.
+    */
+    HMAC < H > * clone (void) const;
+
+    ////////////////////
+    //    Setters
+    ////////////////////
+
+    /** Replace the secret key.  A key longer than a block is hashed
+     *  first, as the standard requires.
+     *
+     *  @pre none.
+     *  @post The ipad/opad states are recomputed and any message data
+     *        is discarded.
+     *  @param key A pointer to the key bytes.
+     *  @param length The number of bytes in the key.
+     *  @return none.
+    */
+    void setKey (const byte_t *key, uint32_t length);
+
+    /** Calculate the MAC of a std::string.
+     *
+     *  @pre The object is keyed.
+     *  @post The MAC is stored in _hash.
+     *  @param str The std::string that is to be authenticated.
+     *  @return A std::string containing the MAC.
+    */
+    string calculateHash (const string &str);
+
+    /** Calculate the MAC of a data stream.
+     *
+     *  @pre The object is keyed.
+     *  @post The MAC is stored in _hash.
+     *  @param data The data that is to be authenticated.
+     *  @return A std::string containing the MAC.
+    */
+    string calculateHash (const vector < byte_t > &data);
+
+    /** Calculate the MAC of a file.
+     *
+     *  @pre The object is keyed.
+     *  @post The MAC is stored in _hash.  An unreadable file yields a
+     *        MAC of all zeros.
+     *  @param file A handle to the file that is to be authenticated.
+     *  @return A std::string containing the MAC.
+    */
+    string calculateHash (ifstream &file);
+
+    /** Start a new message under the current key.  This only copies the
+     *  cached ipad state; the key is not processed again.
+     *
+     *  @pre The object is keyed.
+     *  @post Any message data is discarded.
+     *  @return none.
+    */
+    void reset (void);
+
+    /** Authenticate the next piece of the message.
+     *
+     *  @pre The object is keyed.
+     *  @post The data is absorbed into the inner hash.
+     *  @param data A pointer to the message data.
+     *  @param length The number of bytes at data.
+     *  @return none.
+    */
+    void update (const byte_t *data, uint64_t length);
+
+    /** Authenticate the next piece of the message.
+     *
+     *  @pre The object is keyed.
+     *  @post The data is absorbed into the inner hash.
+     *  @param data The message data.
+     *  @return none.
+    */
+    void update (const vector < byte_t > &data);
+
+    /** Complete the MAC of the message.
+     *
+     *  @pre The object is keyed.
+     *  @post The MAC is stored in _hash and a new message is started.
+     *  @return A std::string containing the MAC.
+    */
+    string finalize (void);
+
+    /******************************************************
+    **                     Operators                     **
+    ******************************************************/
+
+    /** Assignment from another HMAC object.
+     *
+     *  @pre The object is instantiated.
+     *  @post The object contains the values copied from rhs.
+     *  @param rhs The HMAC object whose values are to be copied/stored.
+     *  @return A reference to the object.
+    */
+    HMAC < H > & operator = (const HMAC < H > &rhs);
+
+  private:
+    /******************************************************
+    **                      Members                      **
+    ******************************************************/
+    H _innerStart;  // The hash state after the key ^ ipad block.
+    H _outerStart;  // The hash state after the key ^ opad block.
+    H _inner;       // The inner hash of the current message.
+
+    /******************************************************
+    **                   Helper Methods                  **
+    ******************************************************/
+
+    /** Append the algorithm specific part of the midstate.
+     *
+     *  @pre none.
+     *  @post The state is appended to state.
+     *  @param state The state that is being exported.
+     *  @return none.
+    */
+    void _saveState (HashState &state) const;
+
+    /** Restore the algorithm specific part of the midstate.
+     *
+     *  @pre The common header of state has been read and checked.
+     *  @post The object holds the imported state.
+     *  @param state The state that is being imported.
+     *  @return true The values read are consistent.
+     *  @return false The state is corrupt.
+    */
+    bool _loadState (HashState &state);
+
+};  // End class HMAC.
+
+/******************************************************
+**            Constructors / Destructors             **
+******************************************************/
+
+/** Default constructor (an empty key).  */
+template < class H >
+HMAC < H >::HMAC ()
+    : MessageHash(H().asBytes().size() * 8)
+{
+    setKey(NULL, 0);
+}
+
+/** Initialize an HMAC object with a secret key.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated and keyed.
+ *  @param key A pointer to the key bytes.
+ *  @param length The number of bytes in the key.
+*/
+template < class H >
+HMAC < H >::HMAC (const byte_t *key, uint32_t length)
+    : MessageHash(H().asBytes().size() * 8)
+{
+    setKey(key, length);
+}
+
+/** Initialize an HMAC object with a secret key.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated and keyed.
+ *  @param key The key bytes.
+*/
+template < class H >
+HMAC < H >::HMAC (const vector < byte_t > &key)
+    : MessageHash(H().asBytes().size() * 8)
+{
+    setKey(key.empty() ? NULL : &key[0], (uint32_t)key.size());
+}
+
+/** Copy constructor.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated from the copied HMAC object
+ *        (including its key and any pending message data).
+ *  @param copyFrom The HMAC object whose values are to be copied.
+*/
+template < class H >
+HMAC < H >::HMAC (const HMAC < H > &copyFrom)
+    : MessageHash(copyFrom),
+      _innerStart(copyFrom._innerStart),
+      _outerStart(copyFrom._outerStart),
+      _inner(copyFrom._inner)
+{}
+
+/** Default destructor.  */
+template < class H >
+HMAC < H >::~HMAC ()  { }
+
+/******************************************************
+**               Accessors / Mutators                **
+******************************************************/
+
+////////////////////
+//    Getters
+////////////////////
+
+/** Retrieve the name of the algorithm.
+ *
+ *  @pre The object is instantiated.
+ *  @post none.
+ *  @return "HMAC-" followed by the name of H.
+*/
+template < class H >
+string HMAC < H >::algorithmName (void) const
+{
+    return "HMAC-" + _inner.algorithmName();
+}
+
+/** Retrieve the name of the kernel of H.
+ *
+ *  @pre The object is instantiated.
+ *  @post none.
+ *  @return The kernel that H selected.
+*/
+template < class H >
+string HMAC < H >::kernelName (void) const
+{
+    return _inner.kernelName();
+}
+
+/** Copy the object, including its key and any partially processed
+ *  message.
+ *
+ *  @pre none.
+ *  @post The caller owns (and must delete) the copy.
+ *  @return A new HMAC object in the same state.
+*/
+template < class H >
+HMAC < H > * HMAC < H >::clone (void) const
+{
+    return new HMAC < H >(*this);
+}
+
+////////////////////
+//    Setters
+////////////////////
+
+/** Replace the secret key.  A key longer than a block is hashed
+ *  first, as the standard requires.
+ *
+ *  @pre none.
+ *  @post The ipad/opad states are recomputed and any message data
+ *        is discarded.
+ *  @param key A pointer to the key bytes.
+ *  @param length The number of bytes in the key.
+ *  @return none.
+*/
+template < class H >
+void HMAC < H >::setKey (const byte_t *key, uint32_t length)
+{
+    const uint32_t blockBytes = _innerStart.blockBytes();
+
+    vector < byte_t > ipad(blockBytes, 0x00);
+
+    if (length > blockBytes)
+    {
+        H keyHash;
+        keyHash.update(key, length);
+        keyHash.finalize();
+
+        vector < byte_t > digest = keyHash.asBytes();
+        for (uint32_t i = 0; i < digest.size(); ++i)
+            ipad[i] = digest[i];
+    }
+    else
+    {
+        for (uint32_t i = 0; i < length; ++i)
+            ipad[i] = key[i];
+    }
+
+    vector < byte_t > opad(ipad);
+
+    for (uint32_t i = 0; i < blockBytes; ++i)
+    {
+        ipad[i] ^= 0x36;
+        opad[i] ^= 0x5c;
+    }
+
+    _innerStart.reset();
+    _innerStart.update(ipad);
+
+    _outerStart.reset();
+    _outerStart.update(opad);
+
+    // Do not leave copies of the padded key behind on the heap.
+    ipad.assign(blockBytes, 0x00);
+    opad.assign(blockBytes, 0x00);
+
+    reset();
+
+    return;
+}
+
+/** Calculate the MAC of a std::string.
+ *
+ *  @pre The object is keyed.
+ *  @post The MAC is stored in _hash.
+ *  @param str The std::string that is to be authenticated.
+ *  @return A std::string containing the MAC.
+*/
+template < class H >
+string HMAC < H >::calculateHash (const string &str)
+{
+    reset();
+    update((const byte_t *)str.data(), (uint64_t)str.size());
+
+    return finalize();
+}
+
+/** Calculate the MAC of a data stream.
+ *
+ *  @pre The object is keyed.
+ *  @post The MAC is stored in _hash.
+ *  @param data The data that is to be authenticated.
+ *  @return A std::string containing the MAC.
+*/
+template < class H >
+string HMAC < H >::calculateHash (const vector < byte_t > &data)
+{
+    reset();
+    update(data);
+
+    return finalize();
+}
+
+/** Calculate the MAC of a file.
+ *
+ *  @pre The object is keyed.
+ *  @post The MAC is stored in _hash.  An unreadable file yields a
+ *        MAC of all zeros.
+ *  @param file A handle to the file that is to be authenticated.
+ *  @return A std::string containing the MAC.
+*/
+template < class H >
+string HMAC < H >::calculateHash (ifstream &file)
+{
+    reset();
+
+    // Check that the file is valid before doing anything else.
+    if (file.fail() || !file.good())
+    {
+        _hash.assign(_hash.size(), 0x00000000);
+        return asString();
+    }
+
+    vector < byte_t > buffer(BlockHash::FILE_BUFFER_BYTES);
+
+    while (file.good())
+    {
+        file.read((char *)&buffer[0], buffer.size());
+        update(&buffer[0], (uint64_t)file.gcount());
+    }
+
+    // Reset the file flags and return to the file head.
+    file.clear();
+    file.seekg(0);
+
+    return finalize();
+}
+
+/** Start a new message under the current key.  This only copies the
+ *  cached ipad state; the key is not processed again.
+ *
+ *  @pre The object is keyed.
+ *  @post Any message data is discarded.
+ *  @return none.
+*/
+template < class H >
+void HMAC < H >::reset (void)
+{
+    _inner = _innerStart;
+
+    return;
+}
+
+/** Authenticate the next piece of the message.
+ *
+ *  @pre The object is keyed.
+ *  @post The data is absorbed into the inner hash.
+ *  @param data A pointer to the message data.
+ *  @param length The number of bytes at data.
+ *  @return none.
+*/
+template < class H >
+void HMAC < H >::update (const byte_t *data, uint64_t length)
+{
+    _inner.update(data, length);
+
+    return;
+}
+
+/** Authenticate the next piece of the message.
+ *
+ *  @pre The object is keyed.
+ *  @post The data is absorbed into the inner hash.
+ *  @param data The message data.
+ *  @return none.
+*/
+template < class H >
+void HMAC < H >::update (const vector < byte_t > &data)
+{
+    _inner.update(data);
+
+    return;
+}
+
+/** Complete the MAC of the message.
+ *
+ *  @pre The object is keyed.
+ *  @post The MAC is stored in _hash and a new message is started.
+ *  @return A std::string containing the MAC.
+*/
+template < class H >
+string HMAC < H >::finalize (void)
+{
+    _inner.finalize();
+
+    // The outer hash resumes from its cached state, so it compresses
+    // only the block holding the inner digest and the padding.
+    H outer(_outerStart);
+    outer.update(_inner.asBytes());
+    outer.finalize();
+
+    outer.asArray(&_hash[0]);
+
+    reset();
+
+    return asString();
+}
+
+/******************************************************
+**                     Operators                     **
+******************************************************/
+
+/** Assignment from another HMAC object.
+ *
+ *  @pre The object is instantiated.
+ *  @post The object contains the values copied from rhs.
+ *  @param rhs The HMAC object whose values are to be copied/stored.
+ *  @return A reference to the object.
+*/
+template < class H >
+HMAC < H > & HMAC < H >::operator = (const HMAC < H > &rhs)
+{
+    if (this != &rhs)
+    {
+        MessageHash::operator = (rhs);
+
+        _innerStart = rhs._innerStart;
+        _outerStart = rhs._outerStart;
+        _inner = rhs._inner;
+    }
+
+    return *this;
+}
+
+/******************************************************
+**                   Helper Methods                  **
+******************************************************/
+
+/** Append the algorithm specific part of the midstate.  The keyed
+ *  ipad/opad states are part of it, so the state must be protected
+ *  like the key itself.
+ *
+ *  @pre none.
+ *  @post The state is appended to state.
+ *  @param state The state that is being exported.
+ *  @return none.
+*/
+template < class H >
+void HMAC < H >::_saveState (HashState &state) const
+{
+    state.putBlob(_innerStart.exportState());
+    state.putBlob(_outerStart.exportState());
+    state.putBlob(_inner.exportState());
+
+    return;
+}
+
+/** Restore the algorithm specific part of the midstate.
+ *
+ *  @pre The common header of state has been read and checked.
+ *  @post The object holds the imported state.
+ *  @param state The state that is being imported.
+ *  @return true The values read are consistent.
+ *  @return false The state is corrupt.
+*/
+template < class H >
+bool HMAC < H >::_loadState (HashState &state)
+{
+    // The keyed starts are only replaced once all three parts import, so
+    // that the reset() after a corrupt state keeps the key of the object.
+    H innerStart(_innerStart),
+      outerStart(_outerStart),
+      inner(_inner);
+
+    if (   !innerStart.importState(state.getBlob())
+        || !outerStart.importState(state.getBlob())
+        || !inner.importState(state.getBlob())
+       )
+        return false;
+
+    _innerStart = innerStart;
+    _outerStart = outerStart;
+    _inner = inner;
+
+    return true;
+}
+
+#endif
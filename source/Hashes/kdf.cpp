@@ -0,0 +1,221 @@
+/******************************************************************************
+||  kdf.cpp                                                                  ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    Key derivation functions built on HMAC: the HKDF extract-and-expand    ||
+||    scheme and the PBKDF2 password based scheme, for any of the hashes     ||
+||    that HMAC accepts.                                                     ||
+||                                                                           ||
+||    PBKDF2 with SHA-256 has a dedicated implementation.  Every iteration   ||
+||    of PBKDF2 is two compressions of a single block whose layout is fixed, ||
+||    so it works on the raw ipad/opad chaining states and advances the      ||
+||    output blocks side by side in the lanes of the multi-buffer SHA-256    ||
+||    kernel.                                                                ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    hmac.h                                                                 ||
+||    kdf.h                                                                  ||
+||    sha256.cpp (sha256.lib)                                                ||
+||    sha256.h                                                               ||
+||                                                                           ||
+||===========================================================================||
+||  REFERENCES                                                               ||
+||===========================================================================||
+||    Krawczyk, H. and Eronen, P.  "HMAC-based Extract-and-Expand Key        ||
+||        Derivation Function (HKDF)", RFC 5869, 2010.                       ||
+||                                                                           ||
+||    Moriarty, K., Kaliski, B. and Rusch, A.  "PKCS #5: Password-Based      ||
+||        Cryptography Specification Version 2.1", RFC 8018, 2017.           ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file kdf.cpp
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+
+#include <string.h>
+
+#include "kdf.h"
+
+/// The number of PBKDF2 output blocks that are advanced side by side.
+static const uint32_t PBKDF2_LANES = 8;
+
+/** Store the eight chaining words of a SHA-256 state (a 256-bit
+ *  digest) as big endian bytes.
+*/
+static inline void storeDigest256 (byte_t out[32], const uint32_t state[8])
+{
+    for (uint32_t i = 0; i < 8; ++i)
+    {
+        out[(i * 4)    ] = (byte_t)(state[i] >> 24);
+        out[(i * 4) + 1] = (byte_t)(state[i] >> 16);
+        out[(i * 4) + 2] = (byte_t)(state[i] >>  8);
+        out[(i * 4) + 3] = (byte_t)(state[i]      );
+    }
+
+    return;
+}
+
+/** PBKDF2-HMAC-SHA256 on raw chaining states with multi-buffer lanes.
+ *
+ *  After the first, every HMAC of an iteration authenticates a 32-byte
+ *  message under the same key.  Both the inner hash (the ipad block and
+ *  the message) and the outer hash (the opad block and the inner digest)
+ *  are then 96-byte messages whose final block is the digest followed by
+ *  fixed padding, so an iteration is just two compressions started from
+ *  the cached ipad and opad states.  The output blocks are independent
+ *  and are compressed together through SHA256::compressLanes().
+ *
+ *  @pre iterations is at least one (zero is treated as one).
+ *  @post none.
+ *  @param password The password.
+ *  @param salt The salt.
+ *  @param iterations The iteration count.
+ *  @param length The number of output bytes.
+ *  @return The derived key.
+*/
+template <>
+vector < byte_t > pbkdf2 < SHA256 > (const vector < byte_t > &password,
+                                     const vector < byte_t > &salt,
+                                     uint32_t iterations, uint32_t length)
+{
+    // The ipad and opad states of the key.
+    byte_t pads[2][64];
+    memset(pads, 0, sizeof(pads));
+
+    if (password.size() > 64)
+    {
+        SHA256 keyHash(password);
+        vector < byte_t > digest = keyHash.asBytes();
+        memcpy(pads[0], &digest[0], digest.size());
+    }
+    else if (!password.empty())
+        memcpy(pads[0], &password[0], password.size());
+
+    for (uint32_t i = 0; i < 64; ++i)
+    {
+        pads[1][i] = pads[0][i] ^ 0x5c;
+        pads[0][i] ^= 0x36;
+    }
+
+    uint32_t padStates[2][8];
+    const byte_t *padBlocks[2] = { pads[0], pads[1] };
+
+    SHA256::initialState(padStates[0]);
+    SHA256::initialState(padStates[1]);
+    SHA256::compressLanes(padStates, padBlocks, 2);
+
+    memset(pads, 0, sizeof(pads));
+
+    // The first HMAC of each block covers the salt, whose length is
+    // arbitrary, so it goes through the general HMAC object.
+    HMAC < SHA256 > prf(password);
+
+    uint32_t u[PBKDF2_LANES][8], t[PBKDF2_LANES][8], inner[PBKDF2_LANES][8];
+    byte_t message[PBKDF2_LANES][64];
+    const byte_t *lanes[PBKDF2_LANES];
+
+    // Bytes 32-63 of the final block of a 96-byte message never change:
+    // the '1' bit, zeros and the length of 768 bits.
+    for (uint32_t j = 0; j < PBKDF2_LANES; ++j)
+    {
+        memset(message[j] + 32, 0, 32);
+        message[j][32] = 0x80;
+        message[j][62] = 0x03;
+
+        lanes[j] = message[j];
+    }
+
+    const uint32_t blocks = (length + 31) / 32;
+
+    vector < byte_t > dk(blocks * 32);
+
+    for (uint32_t first = 0; first < blocks; first += PBKDF2_LANES)
+    {
+        uint32_t count = blocks - first;
+        if (count > PBKDF2_LANES)
+            count = PBKDF2_LANES;
+
+        for (uint32_t j = 0; j < count; ++j)
+        {
+            uint32_t block = first + j + 1;
+            const byte_t index[4] = { (byte_t)(block >> 24),
+                                      (byte_t)(block >> 16),
+                                      (byte_t)(block >>  8),
+                                      (byte_t)(block      ) };
+
+            prf.reset();
+            prf.update(salt);
+            prf.update(index, 4);
+            prf.finalize();
+            prf.asArray(u[j]);
+
+            memcpy(t[j], u[j], sizeof(t[j]));
+        }
+
+        for (uint32_t i = 1; i < iterations; ++i)
+        {
+            for (uint32_t j = 0; j < count; ++j)
+            {
+                storeDigest256(message[j], u[j]);
+                memcpy(inner[j], padStates[0], sizeof(inner[j]));
+            }
+
+            SHA256::compressLanes(inner, lanes, count);
+
+            for (uint32_t j = 0; j < count; ++j)
+            {
+                storeDigest256(message[j], inner[j]);
+                memcpy(u[j], padStates[1], sizeof(u[j]));
+            }
+
+            SHA256::compressLanes(u, lanes, count);
+
+            for (uint32_t j = 0; j < count; ++j)
+                for (uint32_t k = 0; k < 8; ++k)
+                    t[j][k] ^= u[j][k];
+        }
+
+        for (uint32_t j = 0; j < count; ++j)
+            storeDigest256(&dk[(first + j) * 32], t[j]);
+    }
+
+    dk.resize(length);
+
+    return dk;
+}
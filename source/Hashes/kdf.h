@@ -0,0 +1,287 @@
+/******************************************************************************
+||  kdf.h                                                                    ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    Key derivation functions built on HMAC: the HKDF extract-and-expand    ||
+||    scheme and the PBKDF2 password based scheme, for any of the hashes     ||
+||    that HMAC accepts.                                                     ||
+||                                                                           ||
+||    PBKDF2 with SHA-256 has a dedicated implementation.  Every iteration   ||
+||    of PBKDF2 is two compressions of a single block whose layout is fixed, ||
+||    so it works on the raw ipad/opad chaining states and advances the      ||
+||    output blocks side by side in the lanes of the multi-buffer SHA-256    ||
+||    kernel.                                                                ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    hmac.h                                                                 ||
+||    kdf.cpp (kdf.lib)                                                      ||
+||    sha256.cpp (sha256.lib)                                                ||
+||    sha256.h                                                               ||
+||                                                                           ||
+||===========================================================================||
+||  REFERENCES                                                               ||
+||===========================================================================||
+||    Krawczyk, H. and Eronen, P.  "HMAC-based Extract-and-Expand Key        ||
+||        Derivation Function (HKDF)", RFC 5869, 2010.                       ||
+||                                                                           ||
+||    Moriarty, K., Kaliski, B. and Rusch, A.  "PKCS #5: Password-Based      ||
+||        Cryptography Specification Version 2.1", RFC 8018, 2017.           ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file kdf.h
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+
+#ifndef _GH_KDF_DEF_H
+#define _GH_KDF_DEF_H
+
+#include "hmac.h"
+#include "sha256.h"
+
+/** HKDF-Extract: concentrate the entropy of the input keying material
+ *  into a pseudorandom key.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @param salt An optional (possibly empty) non-secret salt.
+ *  @param ikm The input keying material.
+ *  @return The pseudorandom key (one digest of H).
+*/
+template < class H >
+vector < byte_t > hkdfExtract (const vector < byte_t > &salt,
+                               const vector < byte_t > &ikm);
+
+/** HKDF-Expand: stretch a pseudorandom key into output keying material.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @param prk The pseudorandom key (normally from hkdfExtract).
+ *  @param info Optional (possibly empty) context information.
+ *  @param length The number of output bytes.
+ *  @return The output keying material, or an empty vector if length is
+ *          more than 255 digests of H (an error in RFC 5869).
+*/
+template < class H >
+vector < byte_t > hkdfExpand (const vector < byte_t > &prk,
+                              const vector < byte_t > &info,
+                              uint32_t length);
+
+/** HKDF: extract followed by expand.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @param ikm The input keying material.
+ *  @param salt An optional (possibly empty) non-secret salt.
+ *  @param info Optional (possibly empty) context information.
+ *  @param length The number of output bytes.
+ *  @return The output keying material, or an empty vector if length is
+ *          more than 255 digests of H.
+*/
+template < class H >
+vector < byte_t > hkdf (const vector < byte_t > &ikm,
+                        const vector < byte_t > &salt,
+                        const vector < byte_t > &info,
+                        uint32_t length);
+
+/** PBKDF2 with HMAC over H as the pseudorandom function.
+ *
+ *  @pre iterations is at least one (zero is treated as one).
+ *  @post none.
+ *  @param password The password.
+ *  @param salt The salt.
+ *  @param iterations The iteration count.
+ *  @param length The number of output bytes.
+ *  @return The derived key.
+*/
+template < class H >
+vector < byte_t > pbkdf2 (const vector < byte_t > &password,
+                          const vector < byte_t > &salt,
+                          uint32_t iterations, uint32_t length);
+
+/** PBKDF2-HMAC-SHA256 on raw chaining states with multi-buffer lanes
+ *  (defined in kdf.cpp).
+*/
+template <>
+vector < byte_t > pbkdf2 < SHA256 > (const vector < byte_t > &password,
+                                     const vector < byte_t > &salt,
+                                     uint32_t iterations, uint32_t length);
+
+/******************************************************
+**                  Implementation                   **
+******************************************************/
+
+/** HKDF-Extract: concentrate the entropy of the input keying material
+ *  into a pseudorandom key.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @param salt An optional (possibly empty) non-secret salt.
+ *  @param ikm The input keying material.
+ *  @return The pseudorandom key (one digest of H).
+*/
+template < class H >
+vector < byte_t > hkdfExtract (const vector < byte_t > &salt,
+                               const vector < byte_t > &ikm)
+{
+    // An absent salt is a digest of zeros, which is exactly how HMAC pads
+    // an empty key.
+    HMAC < H > mac(salt);
+    mac.calculateHash(ikm);
+
+    return mac.asBytes();
+}
+
+/** HKDF-Expand: stretch a pseudorandom key into output keying material.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @param prk The pseudorandom key (normally from hkdfExtract).
+ *  @param info Optional (possibly empty) context information.
+ *  @param length The number of output bytes.
+ *  @return The output keying material, or an empty vector if length is
+ *          more than 255 digests of H (an error in RFC 5869).
+*/
+template < class H >
+vector < byte_t > hkdfExpand (const vector < byte_t > &prk,
+                              const vector < byte_t > &info,
+                              uint32_t length)
+{
+    // The key is set (and its ipad/opad blocks compressed) only once.
+    HMAC < H > mac(prk);
+
+    const uint32_t digestBytes = (uint32_t)mac.asBytes().size();
+
+    vector < byte_t > okm, t;
+
+    // The block counter is a single byte; a shorter key than was asked
+    // for would be worse than none.
+    if (length > (255 * digestBytes))
+        return okm;
+    okm.reserve(length);
+
+    for (byte_t counter = 1; okm.size() < length; ++counter)
+    {
+        mac.reset();
+        mac.update(t);
+        mac.update(info);
+        mac.update(&counter, 1);
+        mac.finalize();
+
+        t = mac.asBytes();
+
+        for (uint32_t i = 0; (i < t.size()) && (okm.size() < length); ++i)
+            okm.push_back(t[i]);
+    }
+
+    return okm;
+}
+
+/** HKDF: extract followed by expand.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @param ikm The input keying material.
+ *  @param salt An optional (possibly empty) non-secret salt.
+ *  @param info Optional (possibly empty) context information.
+ *  @param length The number of output bytes.
+ *  @return The output keying material, or an empty vector if length is
+ *          more than 255 digests of H.
+*/
+template < class H >
+vector < byte_t > hkdf (const vector < byte_t > &ikm,
+                        const vector < byte_t > &salt,
+                        const vector < byte_t > &info,
+                        uint32_t length)
+{
+    return hkdfExpand < H > (hkdfExtract < H > (salt, ikm), info, length);
+}
+
+/** PBKDF2 with HMAC over H as the pseudorandom function.
+ *
+ *  @pre iterations is at least one (zero is treated as one).
+ *  @post none.
+ *  @param password The password.
+ *  @param salt The salt.
+ *  @param iterations The iteration count.
+ *  @param length The number of output bytes.
+ *  @return The derived key.
+*/
+template < class H >
+vector < byte_t > pbkdf2 (const vector < byte_t > &password,
+                          const vector < byte_t > &salt,
+                          uint32_t iterations, uint32_t length)
+{
+    // Each iteration restarts from the cached ipad/opad states, so the
+    // password is processed once rather than twice per iteration.
+    HMAC < H > prf(password);
+
+    vector < byte_t > dk, u, t;
+    dk.reserve(length);
+
+    for (uint32_t block = 1; dk.size() < length; ++block)
+    {
+        const byte_t index[4] = { (byte_t)(block >> 24),
+                                  (byte_t)(block >> 16),
+                                  (byte_t)(block >>  8),
+                                  (byte_t)(block      ) };
+
+        prf.reset();
+        prf.update(salt);
+        prf.update(index, 4);
+        prf.finalize();
+
+        u = t = prf.asBytes();
+
+        for (uint32_t i = 1; i < iterations; ++i)
+        {
+            prf.calculateHash(u);
+            u = prf.asBytes();
+
+            for (uint32_t j = 0; j < t.size(); ++j)
+                t[j] ^= u[j];
+        }
+
+        for (uint32_t j = 0; (j < t.size()) && (dk.size() < length); ++j)
+            dk.push_back(t[j]);
+    }
+
+    return dk;
+}
+
+#endif
@@ -15,8 +15,12 @@
 ||===========================================================================||
 ||  CODE DEPENDENCIES                                                        ||
 ||===========================================================================||
+||    block_hash.cpp (block_hash.lib)                                        ||
+||    block_hash.h                                                           ||
 ||    hash_abstract.cpp (hash_abstract.lib)                                  ||
 ||    hash_abstract.h                                                        ||
+||    hash_state.cpp (hash_state.lib)                                        ||
+||    hash_state.h                                                           ||
 ||                                                                           ||
 ||===========================================================================||
 ||  REFERENCES                                                               ||
@@ -60,6 +64,7 @@
 */
 
 #include "md5.h"
+#include "hash_state.h"
 
 /******************************************************
 **            Constructors / Destructors             **
@@ -67,8 +72,10 @@
 
 /** Default constructor.  */
 MD5::MD5 ()
-    : MessageHash(128)
-{}
+    : BlockHash(128, 64, 8, true)
+{
+    _initializeHash();
+}
 
 /** Copy constructor.
  *
@@ -77,8 +84,11 @@ MD5::MD5 ()
  *  @param copyFrom The MD5 object whose values are to be copied.
 */
 MD5::MD5 (const MD5 &copyFrom)
-    : MessageHash(copyFrom)
-{}
+    : BlockHash(copyFrom)
+{
+    for (uint32_t i = 0; i < 4; ++i)
+        _state[i] = copyFrom._state[i];
+}
 
 /** Initialize an MD5 object by hashing an input std::string.
  *
@@ -88,7 +98,7 @@ MD5::MD5 (const MD5 &copyFrom)
  *  @param str The std::string that is to be hashed.
 */
 MD5::MD5 (const string &str)
-    : MessageHash(128)
+    : BlockHash(128, 64, 8, true)
 {
     calculateHash(str);
 }
@@ -101,7 +111,7 @@ MD5::MD5 (const string &str)
  *  @param data The data that is to be hashed.
 */
 MD5::MD5 (const vector < byte_t > &data)
-    : MessageHash(128)
+    : BlockHash(128, 64, 8, true)
 {
     calculateHash(data);
 }
@@ -114,7 +124,7 @@ MD5::MD5 (const vector < byte_t > &data)
  *  @param file A handle to the file that is to be hashed.
 */
 MD5::MD5 (ifstream &file)
-    : MessageHash(128)
+    : BlockHash(128, 64, 8, true)
 {
     calculateHash(file);
 }
@@ -127,207 +137,107 @@ MD5::~MD5 ()  { }
 ******************************************************/
 
 ////////////////////
-//    Setters
+//    Getters
 ////////////////////
 
-/** Calculate the MD5 value from an input std::string.
+/** Retrieve the name of the algorithm.
  *
  *  @pre The object is instantiated.
- *  @post The MD5 sum is stored in the _hash values.
- *  @param str The string whose value is to be hashed.
- *  @return The MD5 value as a std::string.
+ *  @post none.
+ *  @return "MD5".
 */
-string MD5::calculateHash (const string &str)
+string MD5::algorithmName (void) const
 {
-    return calculateHash(vector < byte_t >(str.begin(), str.end()));
+    return "MD5";
 }
 
-/** Calculate the MD5 value from an input data stream.
+/** Copy the object, including any partially processed message.
  *
- *  @pre The object is instantiated.
- *  @post The MD5 sum is stored in the _hash values.
- *  @param data The data that is to be hashed.
- *  @return The MD5 value as a std::string.
+ *  @pre none.
+ *  @post The caller owns (and must delete) the copy.
+ *  @return A new MD5 object in the same state.
 */
-string MD5::calculateHash (const vector < byte_t > &data)
+MD5 * MD5::clone (void) const
 {
-    _initialize(128);
-
-    vector < byte_t > message = _padVector(data);
-
-    // The message must be processed in 512-bit (64-byte) chunks
-    uint32_t chunks = message.size() / 64;
-
-    // We need to initialize the hash to the chaining variables.
-    _initializeHash();
-
-    // The 512-bit (16, 32-bit) message block.
-    vector < uint32_t > block;
+    return new MD5(*this);
+}
 
-    uint32_t offset,  // A calculated offset into the data.
-             append,  // A concatenation of 4 bytes into 1 32-bit word.
-             A,       // The chaining variable associated with _hash[0].
-             B,       // The chaining variable associated with _hash[1].
-             C,       // The chaining variable associated with _hash[2].
-             D;       // The chaining variable associated with _hash[3].
+/******************************************************
+**                     Operators                     **
+******************************************************/
 
-    for (uint32_t i = 0; i < chunks; ++i)
+/** Assignment from another MD5 object.
+ *
+ *  @pre The object is instantiated.
+ *  @post The object contains the values copied from rhs.
+ *  @param rhs The MD5 object whose values are to be copied/stored.
+ *  @return A reference to the object.
+*/
+MD5 & MD5::operator = (const MD5 &rhs)
+{
+    if (this != &rhs)
     {
-        // Initialize the four 32-bit chaining variables.
-        A = _hash[0];
-        B = _hash[1];
-        C = _hash[2];
-        D = _hash[3];
-
-        // Reset the 16 32-bit block to all zeros.
-        block.assign(16, 0x00000000);
-
-        // We need to concatenate the message contents into 512-bit block.
-        for (uint32_t j = 0; j < 16; ++j)
-        {
-            // The current offset into the message data.
-            offset = (i * 64) + (j * 4);
-
-            // With MD5, the words are appended in big-endian format, i.e.
-            // if the hardware is little-endian, we have to convert the
-            // bytes to big-endian.
-            if (_littleEndian)
-            {
-                append =   ((uint32_t)message.at(offset    )      )
-                         | ((uint32_t)message.at(offset + 1) <<  8)
-                         | ((uint32_t)message.at(offset + 2) << 16)
-                         | ((uint32_t)message.at(offset + 3) << 24);
-            }
-            else
-            {
-                append =   ((uint32_t)message.at(offset    ) << 24)
-                         | ((uint32_t)message.at(offset + 1) << 16)
-                         | ((uint32_t)message.at(offset + 2) <<  8)
-                         | ((uint32_t)message.at(offset + 3)      );
-            }
-
-            block.at(j) = append;
-
-        }  // End for-loop j.
+        BlockHash::operator = (rhs);
 
-        // These are the four rounds per chunk that are performed to compute
-        // the chaining variables which becomes the hash.
-        _round1(block);
-        _round2(block);
-        _round3(block);
-        _round4(block);
-
-        // After the rounds are complete, the calculated sub hash values
-        // are added to the chaining variables.  The final output is
-        // this concatenation.
-        _hash[0] += A;
-        _hash[1] += B;
-        _hash[2] += C;
-        _hash[3] += D;
-
-    }  // End for-loop i.
+        for (uint32_t i = 0; i < 4; ++i)
+            _state[i] = rhs._state[i];
+    }
 
-    // We need to flip the byte order if the system is little endian.
-    if (_littleEndian)
-        _convertToLittleEndian();
+    return *this;
+}
 
-    return asString();
-}  // End method md5compute (const vector < byte > data).
+/******************************************************
+**                   Helper Methods                  **
+******************************************************/
 
-/** Calculate the MD5 value of a file.
+/** Initialize the MD5 hash.
  *
  *  @pre The object is instantiated.
- *  @post The MD5 sum is stored in the _hash values.
- *  @param file The file whose MD5 is to be calculated.
- *  @return The MD5 value as a std::string.
+ *  @post The values in _state are initialized to the
+ *        chaining variable values.
+ *  @return none.
 */
-string MD5::calculateHash (ifstream &file)
+void MD5::_initializeHash (void)
 {
-    _initialize(128);
-
-    // Check that the file is valid before doing anything else.
-    // This will return an MD5 value of all zeros.
-    if (file.fail() || !file.good())
-        return "00000000000000000000000000000000";
-
-    uint64_t filesize,    // The size of the file in bytes.
-             paddedSize,  // The size of the data after padding.
-             filebits;    // The filesize in bits.
-
-    // We need to get the size of the file.
-    file.seekg(0, ios::end);
-    filesize = (uint64_t)file.tellg();
-    filebits = filesize * 8;
-    file.seekg(0);  // Return to the head of the file.
-
-    // We need to append 9 bytes to the data and fill the extra padding
-    // with zeros to get a 512-bit boundary.
-    paddedSize = filesize + 9;
-    while ((paddedSize % 64) != 0) ++paddedSize;
-
-    // The message must be processed in 512-bit (64-byte) chunks
-    uint64_t chunks = paddedSize >> 6;  // Divide by 64.
-
-    // The 512-bit (16, 32-bit) message block.
-    vector < uint32_t > block;
-
-    uint32_t append,     // A concatenation of 4 bytes into 1 32-bit word.
-             A,          // The chaining variable associated with _hash[0].
-             B,          // The chaining variable associated with _hash[1].
-             C,          // The chaining variable associated with _hash[2].
-             D,          // The chaining variable associated with _hash[3].
-             blockData;  // The number of message bytes in each block.
+    _state[0] = 0x67452301;
+    _state[1] = 0xefcdab89;
+    _state[2] = 0x98badcfe;
+    _state[3] = 0x10325476;
 
-    bool endOfStream = false;
+    return;
+}
 
-    // We need to initialize the hash to the chaining variables.
-    _initializeHash();
+/** Compress whole 512-bit message blocks.
+ *
+ *  @pre The chaining variables have been initialized.
+ *  @post The chaining variables are updated.
+ *  @param blocks A pointer to the first block.
+ *  @param count The number of consecutive blocks at blocks.
+ *  @return none.
+*/
+void MD5::_compress (const byte_t *blocks, uint64_t count)
+{
+    uint32_t block[16];  // The 512-bit (16, 32-bit) message block.
 
-    for (uint64_t i = 0; i < chunks; ++i)
+    for (uint64_t i = 0; i < count; ++i, blocks += 64)
     {
         // Initialize the four 32-bit chaining variables.
-        A = _hash[0];
-        B = _hash[1];
-        C = _hash[2];
-        D = _hash[3];
+        uint32_t A = _state[0],
+                 B = _state[1],
+                 C = _state[2],
+                 D = _state[3];
 
-        // Reset the 16 32-bit block to all zeros.
-        block.assign(16, 0x00000000);
-        blockData = 0;
-
-        // We need to concatenate the message contents into 512-bit block.
+        // With MD5, the message words are little endian whatever the
+        // byte order of the hardware.
         for (uint32_t j = 0; j < 16; ++j)
         {
-            // Initialize the data to be appended.
-            append = 0x00000000;
-
-            // With MD5, the words are appended in big-endian format, i.e.
-            // if the hardware is little-endian, we have to convert the
-            // bytes to big-endian.
-            for (uint32_t m = 0; (m < 4) && !endOfStream; ++m)
-            {
-                // Check for EOF.
-                if (file.peek() == -1)
-                    endOfStream = true;
-
-                else
-                {
-                    if (_littleEndian)
-                        append |= ((uint32_t)file.get() << (m * 8));
-                    else
-                        append |= ((uint32_t)file.get() << (24 - (m * 8)));
-
-                    // Increment the number of message bytes.
-                    ++blockData;
-                }
-            }
+            const byte_t *word = blocks + (j * 4);
 
-            block.at(j) = append;
-
-        }  // End for-loop j.
-
-        if (endOfStream)
-            _padLastBlock(block, blockData, filebits);
+            block[j] =   ((uint32_t)word[0]      )
+                       | ((uint32_t)word[1] <<  8)
+                       | ((uint32_t)word[2] << 16)
+                       | ((uint32_t)word[3] << 24);
+        }
 
         // These are the four rounds per chunk that are performed to compute
         // the chaining variables which becomes the hash.
@@ -339,156 +249,60 @@ string MD5::calculateHash (ifstream &file)
         // After the rounds are complete, the calculated sub hash values
         // are added to the chaining variables.  The final output is
         // this concatenation.
-        _hash[0] += A;
-        _hash[1] += B;
-        _hash[2] += C;
-        _hash[3] += D;
-
-    }  // End for-loop i.
-
-    // We need to flip the byte order if the system is little endian.
-    if (_littleEndian)
-        _convertToLittleEndian();
-
-    // Reset the file flags and return to the file head.
-    file.clear();
-    file.seekg(0);  // Return to the head of the file.
-
-    return asString();
-
-}  // End method md5compute (ifstream &file).
+        _state[0] += A;
+        _state[1] += B;
+        _state[2] += C;
+        _state[3] += D;
+    }
 
-/******************************************************
-**                   Helper Methods                  **
-******************************************************/
+    return;
+}
 
-/** Initialize the MD5 hash.
+/** Copy the chaining variables into the _hash words.  The digest is the
+ *  little endian bytes of the chaining variables, while the _hash words
+ *  print most significant byte first, so each word is byte swapped.
  *
- *  @pre The object is instantiated.
- *  @post The values in _hash are initialized to the
- *        chaining variable values.
+ *  @pre The final block has been compressed.
+ *  @post The _hash values hold the message digest.
  *  @return none.
 */
-void MD5::_initializeHash (void)
+void MD5::_storeHash (void)
 {
-    // MD5 uses a big-endian format.  So if the hardware is little-endian,
-    //    we have to initialize the chaining variables accordingly
-    if (_littleEndian)
-    {
-        _hash[0] = 0x67452301;
-        _hash[1] = 0xefcdab89;
-        _hash[2] = 0x98badcfe;
-        _hash[3] = 0x10325476;
-    }
-
-    else  // Big Endian.
+    for (uint32_t i = 0; i < 4; ++i)
     {
-        _hash[0] = 0x01234567;
-        _hash[1] = 0x89abcdef;
-        _hash[2] = 0xfedcba98;
-        _hash[3] = 0x76543210;
+        _hash[i] =   ((_state[i] & 0x000000ff) << 24)
+                   | ((_state[i] & 0x0000ff00) <<  8)
+                   | ((_state[i] & 0x00ff0000) >>  8)
+                   | ((_state[i] & 0xff000000) >> 24);
     }
 
     return;
 }
 
-/** Pad the message contents to meet RFC1321.
- *
- *  @pre The object is instantiated.
- *  @post none.
- *  @param data The data that is to be hashed.
- *  @return A vector containing the padded data.
-*/
-vector < byte_t > MD5::_padVector (const vector < byte_t > &data) const
-{
-    vector < byte_t > message = data;
-
-    uint32_t size = data.size();  // The size of the original data.
-
-    // We need to append 9 bytes to the data and fill the extra padding
-    // with zeros to get a 512-bit boundary.
-    uint32_t datasize = data.size() + 9;
-    while ((datasize % 64) != 0) ++datasize;
-
-    // The first padded bit is a '1' followed by zeros until we reach the
-    // the final 64-bits of the message.
-    message.push_back(0x80);
-    for (uint32_t i = (size + 1); i < datasize; ++i)
-        message.push_back(0x00);
-
-    // The final 64-bits (8-bytes) is the 64-bit representation of the
-    // message size in bits presented as a big endian value.  For simplicity,
-    // I'll only use a 32-bit value (assume the MSBs are 0x00).
-    uint32_t dataBits = size * 8;
-    // message.at(datasize - 1) = 0x00;
-    // message.at(datasize - 2) = 0x00;
-    // message.at(datasize - 3) = 0x00;
-    // message.at(datasize - 4) = 0x00;
-    message.at(datasize - 5) = (byte_t)((dataBits & 0xff000000) >> 24);
-    message.at(datasize - 6) = (byte_t)((dataBits & 0x00ff0000) >> 16);
-    message.at(datasize - 7) = (byte_t)((dataBits & 0x0000ff00) >>  8);
-    message.at(datasize - 8) = (byte_t)((dataBits & 0x000000ff)      );
-
-    return message;
-}
-
-/** Pad the message contents to meet RFC1321.
+/** Append the chaining variables to an exported state.
  *
- *  @pre The object is instantiated.
- *  @post none.
- *  @param lastBlock The last block of data from the file (the block
- *         that is to be padded).
- *  @param dataInBlock The number of bytes of message data in the block.
- *  @param bitsInFile The size of the message in bits.
+ *  @pre none.
+ *  @post The chaining variables are appended to state.
+ *  @param state The state that is being exported.
  *  @return none.
 */
-void MD5::_padLastBlock (vector < uint32_t > &lastBlock, uint32_t dataInBlock,
-                         uint64_t bitsInFile) const
+void MD5::_saveChaining (HashState &state) const
 {
-    // If there is no more data, we need to pad the block.
-    // The first padded bit is a '1' followed by zeros until we reach the
-    // the final 64-bits of the message.
-    uint32_t shift = (dataInBlock % 4);
-
-    uint32_t paddingWord = (dataInBlock / 4) % 16;
-
-    uint32_t append = lastBlock.at(paddingWord);
-
-    if (_littleEndian)
-        append |= (0x00000080 << (shift * 8));
-    else
-        append |= (0x00000080 << (24 - (shift * 8)));
-
-    lastBlock.at(paddingWord) = append;
-
-    for (uint32_t i = (paddingWord + 1); i < 16; ++i)
-        lastBlock.at(i) = 0x00000000;
-
-    // The final 64-bits (8-bytes) is the 64-bit representation of the
-    // message size in bits presented as a big endian value.
-
-    lastBlock.at(15) = (uint32_t)((bitsInFile >> 16) >> 16);  // 64-bit MSBs.
-    lastBlock.at(14) = (uint32_t)(bitsInFile & 0x00000000ffffffff);
+    state.putWords32(_state, 4);
 
     return;
 }
 
-/** Convert the hash from big endian to little endian format.
+/** Restore the chaining variables from an imported state.
  *
- *  @pre The object is instantiated.
- *  @post The values of _hash are rearranged to little endian format.
+ *  @pre The block buffer has been read from state.
+ *  @post The chaining variables are restored.
+ *  @param state The state that is being imported.
  *  @return none.
 */
-void MD5::_convertToLittleEndian (void)
+void MD5::_loadChaining (HashState &state)
 {
-    // Flip the byte order of the 32-bit words.
-    for (uint32_t i = 0; i < 4; ++i)
-    {
-        _hash[i] =   ((_hash[i] & 0x000000ff) << 24)
-                   + ((_hash[i] & 0x0000ff00) << 8)
-                   + ((_hash[i] & 0x00ff0000) >> 8)
-                   + ((_hash[i] & 0xff000000) >> 24);
-    }
+    state.getWords32(_state, 4);
 
     return;
 }
@@ -496,11 +310,11 @@ void MD5::_convertToLittleEndian (void)
 /** Avalanche effect, Round 1.
  *
  *  @pre The object is instantiated.
- *  @post The values of _hash are manipulated.
+ *  @post The values of _state are manipulated.
  *  @param b512 The 512-bit message block (16, 32-bit words).
  *  @return none.
 */
-void MD5::_round1 (vector < uint32_t > b512)
+void MD5::_round1 (const uint32_t b512[16])
 {
     ///////////////////////////////////////////////////////////////////////
     // There are four rounds per chunk that are performed to compute
@@ -509,22 +323,22 @@ void MD5::_round1 (vector < uint32_t > b512)
     //        t[i] = 2^32 * abs(sin(i)),  where i is in radians.
 
     // Round 1.
-    _FF(_hash[0], _hash[1], _hash[2], _hash[3], b512.at( 0),  7, 0xd76aa478);
-    _FF(_hash[3], _hash[0], _hash[1], _hash[2], b512.at( 1), 12, 0xe8c7b756);
-    _FF(_hash[2], _hash[3], _hash[0], _hash[1], b512.at( 2), 17, 0x242070db);
-    _FF(_hash[1], _hash[2], _hash[3], _hash[0], b512.at( 3), 22, 0xc1bdceee);
-    _FF(_hash[0], _hash[1], _hash[2], _hash[3], b512.at( 4),  7, 0xf57c0faf);
-    _FF(_hash[3], _hash[0], _hash[1], _hash[2], b512.at( 5), 12, 0x4787c62a);
-    _FF(_hash[2], _hash[3], _hash[0], _hash[1], b512.at( 6), 17, 0xa8304613);
-    _FF(_hash[1], _hash[2], _hash[3], _hash[0], b512.at( 7), 22, 0xfd469501);
-    _FF(_hash[0], _hash[1], _hash[2], _hash[3], b512.at( 8),  7, 0x698098d8);
-    _FF(_hash[3], _hash[0], _hash[1], _hash[2], b512.at( 9), 12, 0x8b44f7af);
-    _FF(_hash[2], _hash[3], _hash[0], _hash[1], b512.at(10), 17, 0xffff5bb1);
-    _FF(_hash[1], _hash[2], _hash[3], _hash[0], b512.at(11), 22, 0x895cd7be);
-    _FF(_hash[0], _hash[1], _hash[2], _hash[3], b512.at(12),  7, 0x6b901122);
-    _FF(_hash[3], _hash[0], _hash[1], _hash[2], b512.at(13), 12, 0xfd987193);
-    _FF(_hash[2], _hash[3], _hash[0], _hash[1], b512.at(14), 17, 0xa679438e);
-    _FF(_hash[1], _hash[2], _hash[3], _hash[0], b512.at(15), 22, 0x49b40821);
+    _FF(_state[0], _state[1], _state[2], _state[3], b512[ 0],  7, 0xd76aa478);
+    _FF(_state[3], _state[0], _state[1], _state[2], b512[ 1], 12, 0xe8c7b756);
+    _FF(_state[2], _state[3], _state[0], _state[1], b512[ 2], 17, 0x242070db);
+    _FF(_state[1], _state[2], _state[3], _state[0], b512[ 3], 22, 0xc1bdceee);
+    _FF(_state[0], _state[1], _state[2], _state[3], b512[ 4],  7, 0xf57c0faf);
+    _FF(_state[3], _state[0], _state[1], _state[2], b512[ 5], 12, 0x4787c62a);
+    _FF(_state[2], _state[3], _state[0], _state[1], b512[ 6], 17, 0xa8304613);
+    _FF(_state[1], _state[2], _state[3], _state[0], b512[ 7], 22, 0xfd469501);
+    _FF(_state[0], _state[1], _state[2], _state[3], b512[ 8],  7, 0x698098d8);
+    _FF(_state[3], _state[0], _state[1], _state[2], b512[ 9], 12, 0x8b44f7af);
+    _FF(_state[2], _state[3], _state[0], _state[1], b512[10], 17, 0xffff5bb1);
+    _FF(_state[1], _state[2], _state[3], _state[0], b512[11], 22, 0x895cd7be);
+    _FF(_state[0], _state[1], _state[2], _state[3], b512[12],  7, 0x6b901122);
+    _FF(_state[3], _state[0], _state[1], _state[2], b512[13], 12, 0xfd987193);
+    _FF(_state[2], _state[3], _state[0], _state[1], b512[14], 17, 0xa679438e);
+    _FF(_state[1], _state[2], _state[3], _state[0], b512[15], 22, 0x49b40821);
 
     return;
 }
@@ -532,11 +346,11 @@ void MD5::_round1 (vector < uint32_t > b512)
 /** Avalanche effect, Round 2.
  *
  *  @pre The object is instantiated.
- *  @post The values of _hash are manipulated.
+ *  @post The values of _state are manipulated.
  *  @param b512 The 512-bit message block (16, 32-bit words).
  *  @return none.
 */
-void MD5::_round2 (vector < uint32_t > b512)
+void MD5::_round2 (const uint32_t b512[16])
 {
     ///////////////////////////////////////////////////////////////////////
     // There are four rounds per chunk that are performed to compute
@@ -545,22 +359,22 @@ void MD5::_round2 (vector < uint32_t > b512)
     //        t[i] = 2^32 * abs(sin(i)),  where i is in radians.
 
     // Round 2.
-    _GG(_hash[0], _hash[1], _hash[2], _hash[3], b512.at( 1),  5, 0xf61e2562);
-    _GG(_hash[3], _hash[0], _hash[1], _hash[2], b512.at( 6),  9, 0xc040b340);
-    _GG(_hash[2], _hash[3], _hash[0], _hash[1], b512.at(11), 14, 0x265e5a51);
-    _GG(_hash[1], _hash[2], _hash[3], _hash[0], b512.at( 0), 20, 0xe9b6c7aa);
-    _GG(_hash[0], _hash[1], _hash[2], _hash[3], b512.at( 5),  5, 0xd62f105d);
-    _GG(_hash[3], _hash[0], _hash[1], _hash[2], b512.at(10),  9, 0x02441453);
-    _GG(_hash[2], _hash[3], _hash[0], _hash[1], b512.at(15), 14, 0xd8a1e681);
-    _GG(_hash[1], _hash[2], _hash[3], _hash[0], b512.at( 4), 20, 0xe7d3fbc8);
-    _GG(_hash[0], _hash[1], _hash[2], _hash[3], b512.at( 9),  5, 0x21e1cde6);
-    _GG(_hash[3], _hash[0], _hash[1], _hash[2], b512.at(14),  9, 0xc33707d6);
-    _GG(_hash[2], _hash[3], _hash[0], _hash[1], b512.at( 3), 14, 0xf4d50d87);
-    _GG(_hash[1], _hash[2], _hash[3], _hash[0], b512.at( 8), 20, 0x455a14ed);
-    _GG(_hash[0], _hash[1], _hash[2], _hash[3], b512.at(13),  5, 0xa9e3e905);
-    _GG(_hash[3], _hash[0], _hash[1], _hash[2], b512.at( 2),  9, 0xfcefa3f8);
-    _GG(_hash[2], _hash[3], _hash[0], _hash[1], b512.at( 7), 14, 0x676f02d9);
-    _GG(_hash[1], _hash[2], _hash[3], _hash[0], b512.at(12), 20, 0x8d2a4c8a);
+    _GG(_state[0], _state[1], _state[2], _state[3], b512[ 1],  5, 0xf61e2562);
+    _GG(_state[3], _state[0], _state[1], _state[2], b512[ 6],  9, 0xc040b340);
+    _GG(_state[2], _state[3], _state[0], _state[1], b512[11], 14, 0x265e5a51);
+    _GG(_state[1], _state[2], _state[3], _state[0], b512[ 0], 20, 0xe9b6c7aa);
+    _GG(_state[0], _state[1], _state[2], _state[3], b512[ 5],  5, 0xd62f105d);
+    _GG(_state[3], _state[0], _state[1], _state[2], b512[10],  9, 0x02441453);
+    _GG(_state[2], _state[3], _state[0], _state[1], b512[15], 14, 0xd8a1e681);
+    _GG(_state[1], _state[2], _state[3], _state[0], b512[ 4], 20, 0xe7d3fbc8);
+    _GG(_state[0], _state[1], _state[2], _state[3], b512[ 9],  5, 0x21e1cde6);
+    _GG(_state[3], _state[0], _state[1], _state[2], b512[14],  9, 0xc33707d6);
+    _GG(_state[2], _state[3], _state[0], _state[1], b512[ 3], 14, 0xf4d50d87);
+    _GG(_state[1], _state[2], _state[3], _state[0], b512[ 8], 20, 0x455a14ed);
+    _GG(_state[0], _state[1], _state[2], _state[3], b512[13],  5, 0xa9e3e905);
+    _GG(_state[3], _state[0], _state[1], _state[2], b512[ 2],  9, 0xfcefa3f8);
+    _GG(_state[2], _state[3], _state[0], _state[1], b512[ 7], 14, 0x676f02d9);
+    _GG(_state[1], _state[2], _state[3], _state[0], b512[12], 20, 0x8d2a4c8a);
 
     return;
 }
@@ -568,11 +382,11 @@ void MD5::_round2 (vector < uint32_t > b512)
 /** Avalanche effect, Round 3.
 *
 *  @pre The object is instantiated.
-*  @post The values of _hash are manipulated.
+*  @post The values of _state are manipulated.
 *  @param b512 The 512-bit message block (16, 32-bit words).
 *  @return none.
 */
-void MD5::_round3 (vector < uint32_t > b512)
+void MD5::_round3 (const uint32_t b512[16])
 {
     ///////////////////////////////////////////////////////////////////////
     // There are four rounds per chunk that are performed to compute
@@ -581,22 +395,22 @@ void MD5::_round3 (vector < uint32_t > b512)
     //        t[i] = 2^32 * abs(sin(i)),  where i is in radians.
 
     // Round 3.
-    _HH(_hash[0], _hash[1], _hash[2], _hash[3], b512.at( 5),  4, 0xfffa3942);
-    _HH(_hash[3], _hash[0], _hash[1], _hash[2], b512.at( 8), 11, 0x8771f681);
-    _HH(_hash[2], _hash[3], _hash[0], _hash[1], b512.at(11), 16, 0x6d9d6122);
-    _HH(_hash[1], _hash[2], _hash[3], _hash[0], b512.at(14), 23, 0xfde5380c);
-    _HH(_hash[0], _hash[1], _hash[2], _hash[3], b512.at( 1),  4, 0xa4beea44);
-    _HH(_hash[3], _hash[0], _hash[1], _hash[2], b512.at( 4), 11, 0x4bdecfa9);
-    _HH(_hash[2], _hash[3], _hash[0], _hash[1], b512.at( 7), 16, 0xf6bb4b60);
-    _HH(_hash[1], _hash[2], _hash[3], _hash[0], b512.at(10), 23, 0xbebfbc70);
-    _HH(_hash[0], _hash[1], _hash[2], _hash[3], b512.at(13),  4, 0x289b7ec6);
-    _HH(_hash[3], _hash[0], _hash[1], _hash[2], b512.at( 0), 11, 0xeaa127fa);
-    _HH(_hash[2], _hash[3], _hash[0], _hash[1], b512.at( 3), 16, 0xd4ef3085);
-    _HH(_hash[1], _hash[2], _hash[3], _hash[0], b512.at( 6), 23, 0x04881d05);
-    _HH(_hash[0], _hash[1], _hash[2], _hash[3], b512.at( 9),  4, 0xd9d4d039);
-    _HH(_hash[3], _hash[0], _hash[1], _hash[2], b512.at(12), 11, 0xe6db99e5);
-    _HH(_hash[2], _hash[3], _hash[0], _hash[1], b512.at(15), 16, 0x1fa27cf8);
-    _HH(_hash[1], _hash[2], _hash[3], _hash[0], b512.at( 2), 23, 0xc4ac5665);
+    _HH(_state[0], _state[1], _state[2], _state[3], b512[ 5],  4, 0xfffa3942);
+    _HH(_state[3], _state[0], _state[1], _state[2], b512[ 8], 11, 0x8771f681);
+    _HH(_state[2], _state[3], _state[0], _state[1], b512[11], 16, 0x6d9d6122);
+    _HH(_state[1], _state[2], _state[3], _state[0], b512[14], 23, 0xfde5380c);
+    _HH(_state[0], _state[1], _state[2], _state[3], b512[ 1],  4, 0xa4beea44);
+    _HH(_state[3], _state[0], _state[1], _state[2], b512[ 4], 11, 0x4bdecfa9);
+    _HH(_state[2], _state[3], _state[0], _state[1], b512[ 7], 16, 0xf6bb4b60);
+    _HH(_state[1], _state[2], _state[3], _state[0], b512[10], 23, 0xbebfbc70);
+    _HH(_state[0], _state[1], _state[2], _state[3], b512[13],  4, 0x289b7ec6);
+    _HH(_state[3], _state[0], _state[1], _state[2], b512[ 0], 11, 0xeaa127fa);
+    _HH(_state[2], _state[3], _state[0], _state[1], b512[ 3], 16, 0xd4ef3085);
+    _HH(_state[1], _state[2], _state[3], _state[0], b512[ 6], 23, 0x04881d05);
+    _HH(_state[0], _state[1], _state[2], _state[3], b512[ 9],  4, 0xd9d4d039);
+    _HH(_state[3], _state[0], _state[1], _state[2], b512[12], 11, 0xe6db99e5);
+    _HH(_state[2], _state[3], _state[0], _state[1], b512[15], 16, 0x1fa27cf8);
+    _HH(_state[1], _state[2], _state[3], _state[0], b512[ 2], 23, 0xc4ac5665);
 
     return;
 }
@@ -604,11 +418,11 @@ void MD5::_round3 (vector < uint32_t > b512)
 /** Avalanche effect, Round 4.
 *
 *  @pre The object is instantiated.
-*  @post The values of _hash are manipulated.
+*  @post The values of _state are manipulated.
 *  @param b512 The 512-bit message block (16, 32-bit words).
 *  @return none.
 */
-void MD5::_round4 (vector < uint32_t > b512)
+void MD5::_round4 (const uint32_t b512[16])
 {
     ///////////////////////////////////////////////////////////////////////
     // There are four rounds per chunk that are performed to compute
@@ -617,22 +431,22 @@ void MD5::_round4 (vector < uint32_t > b512)
     //        t[i] = 2^32 * abs(sin(i)),  where i is in radians.
 
     // Round 4.
-    _II(_hash[0], _hash[1], _hash[2], _hash[3], b512.at( 0),  6, 0xf4292244);
-    _II(_hash[3], _hash[0], _hash[1], _hash[2], b512.at( 7), 10, 0x432aff97);
-    _II(_hash[2], _hash[3], _hash[0], _hash[1], b512.at(14), 15, 0xab9423a7);
-    _II(_hash[1], _hash[2], _hash[3], _hash[0], b512.at( 5), 21, 0xfc93a039);
-    _II(_hash[0], _hash[1], _hash[2], _hash[3], b512.at(12),  6, 0x655b59c3);
-    _II(_hash[3], _hash[0], _hash[1], _hash[2], b512.at( 3), 10, 0x8f0ccc92);
-    _II(_hash[2], _hash[3], _hash[0], _hash[1], b512.at(10), 15, 0xffeff47d);
-    _II(_hash[1], _hash[2], _hash[3], _hash[0], b512.at( 1), 21, 0x85845dd1);
-    _II(_hash[0], _hash[1], _hash[2], _hash[3], b512.at( 8),  6, 0x6fa87e4f);
-    _II(_hash[3], _hash[0], _hash[1], _hash[2], b512.at(15), 10, 0xfe2ce6e0);
-    _II(_hash[2], _hash[3], _hash[0], _hash[1], b512.at( 6), 15, 0xa3014314);
-    _II(_hash[1], _hash[2], _hash[3], _hash[0], b512.at(13), 21, 0x4e0811a1);
-    _II(_hash[0], _hash[1], _hash[2], _hash[3], b512.at( 4),  6, 0xf7537e82);
-    _II(_hash[3], _hash[0], _hash[1], _hash[2], b512.at(11), 10, 0xbd3af235);
-    _II(_hash[2], _hash[3], _hash[0], _hash[1], b512.at( 2), 15, 0x2ad7d2bb);
-    _II(_hash[1], _hash[2], _hash[3], _hash[0], b512.at( 9), 21, 0xeb86d391);
+    _II(_state[0], _state[1], _state[2], _state[3], b512[ 0],  6, 0xf4292244);
+    _II(_state[3], _state[0], _state[1], _state[2], b512[ 7], 10, 0x432aff97);
+    _II(_state[2], _state[3], _state[0], _state[1], b512[14], 15, 0xab9423a7);
+    _II(_state[1], _state[2], _state[3], _state[0], b512[ 5], 21, 0xfc93a039);
+    _II(_state[0], _state[1], _state[2], _state[3], b512[12],  6, 0x655b59c3);
+    _II(_state[3], _state[0], _state[1], _state[2], b512[ 3], 10, 0x8f0ccc92);
+    _II(_state[2], _state[3], _state[0], _state[1], b512[10], 15, 0xffeff47d);
+    _II(_state[1], _state[2], _state[3], _state[0], b512[ 1], 21, 0x85845dd1);
+    _II(_state[0], _state[1], _state[2], _state[3], b512[ 8],  6, 0x6fa87e4f);
+    _II(_state[3], _state[0], _state[1], _state[2], b512[15], 10, 0xfe2ce6e0);
+    _II(_state[2], _state[3], _state[0], _state[1], b512[ 6], 15, 0xa3014314);
+    _II(_state[1], _state[2], _state[3], _state[0], b512[13], 21, 0x4e0811a1);
+    _II(_state[0], _state[1], _state[2], _state[3], b512[ 4],  6, 0xf7537e82);
+    _II(_state[3], _state[0], _state[1], _state[2], b512[11], 10, 0xbd3af235);
+    _II(_state[2], _state[3], _state[0], _state[1], b512[ 2], 15, 0x2ad7d2bb);
+    _II(_state[1], _state[2], _state[3], _state[0], b512[ 9], 21, 0xeb86d391);
 
     return;
 }
@@ -643,11 +457,11 @@ void MD5::_round4 (vector < uint32_t > b512)
 /** The avalanche function used for Round 1 as specified by RFC 1321.
 *
 *  @pre The object is instantiated.
-*  @post The _hash values are manipulated.
-*  @param a The current chaining variable of the _hash sub-part A.
-*  @param b The current chaining variable of the _hash sub-part B.
-*  @param c The current chaining variable of the _hash sub-part C.
-*  @param d The current chaining variable of the _hash sub-part D.
+*  @post The _state values are manipulated.
+*  @param a The current chaining variable of the _state sub-part A.
+*  @param b The current chaining variable of the _state sub-part B.
+*  @param c The current chaining variable of the _state sub-part C.
+*  @param d The current chaining variable of the _state sub-part D.
 *  @param Mi The i-th sub-block of the message.
 *  @param s The number of bits used in the left circular shift.
 *  @param t A constant which is the integer part of:
@@ -668,11 +482,11 @@ void MD5::_FF (uint32_t &a, uint32_t b, uint32_t c, uint32_t d,
 /** The avalanche function used for Round 2 as specified by RFC 1321.
 *
 *  @pre The object is instantiated.
-*  @post The _hash values are manipulated.
-*  @param a The current chaining variable of the _hash sub-part A.
-*  @param b The current chaining variable of the _hash sub-part B.
-*  @param c The current chaining variable of the _hash sub-part C.
-*  @param d The current chaining variable of the _hash sub-part D.
+*  @post The _state values are manipulated.
+*  @param a The current chaining variable of the _state sub-part A.
+*  @param b The current chaining variable of the _state sub-part B.
+*  @param c The current chaining variable of the _state sub-part C.
+*  @param d The current chaining variable of the _state sub-part D.
 *  @param Mi The i-th sub-block of the message.
 *  @param s The number of bits used in the left circular shift.
 *  @param t A constant which is the integer part of:
@@ -693,11 +507,11 @@ void MD5::_GG (uint32_t &a, uint32_t b, uint32_t c, uint32_t d,
 /** The avalanche function used for Round 3 as specified by RFC 1321.
 *
 *  @pre The object is instantiated.
-*  @post The _hash values are manipulated.
-*  @param a The current chaining variable of the _hash sub-part A.
-*  @param b The current chaining variable of the _hash sub-part B.
-*  @param c The current chaining variable of the _hash sub-part C.
-*  @param d The current chaining variable of the _hash sub-part D.
+*  @post The _state values are manipulated.
+*  @param a The current chaining variable of the _state sub-part A.
+*  @param b The current chaining variable of the _state sub-part B.
+*  @param c The current chaining variable of the _state sub-part C.
+*  @param d The current chaining variable of the _state sub-part D.
 *  @param Mi The i-th sub-block of the message.
 *  @param s The number of bits used in the left circular shift.
 *  @param t A constant which is the integer part of:
@@ -718,11 +532,11 @@ void MD5::_HH (uint32_t &a, uint32_t b, uint32_t c, uint32_t d,
 /** The avalanche function used for Round 4 as specified by RFC 1321.
 *
 *  @pre The object is instantiated.
-*  @post The _hash values are manipulated.
-*  @param a The current chaining variable of the _hash sub-part A.
-*  @param b The current chaining variable of the _hash sub-part B.
-*  @param c The current chaining variable of the _hash sub-part C.
-*  @param d The current chaining variable of the _hash sub-part D.
+*  @post The _state values are manipulated.
+*  @param a The current chaining variable of the _state sub-part A.
+*  @param b The current chaining variable of the _state sub-part B.
+*  @param c The current chaining variable of the _state sub-part C.
+*  @param d The current chaining variable of the _state sub-part D.
 *  @param Mi The i-th sub-block of the message.
 *  @param s The number of bits used in the left circular shift.
 *  @param t A constant which is the integer part of:
@@ -15,6 +15,8 @@
 ||===========================================================================||
 ||  CODE DEPENDENCIES                                                        ||
 ||===========================================================================||
+||    block_hash.cpp (block_hash.lib)                                        ||
+||    block_hash.h                                                           ||
 ||    hash_abstract.cpp (hash_abstract.lib)                                  ||
 ||    hash_abstract.h                                                        ||
 ||                                                                           ||
@@ -62,12 +64,12 @@
 #ifndef _GH_MD5_DEF_H
 #define _GH_MD5_DEF_H
 
-#include "hash_abstract.h"
+#include "block_hash.h"
 
 /**
  *  @class MD5 An abstract data type to calculate and manipulate MD5 sums.
 */
-class MD5 : public MessageHash
+class MD5 : public BlockHash
 {
   public:
     /******************************************************
@@ -120,37 +122,44 @@ class MD5 : public MessageHash
     ******************************************************/
 
     ////////////////////
-    //    Setters
+    //    Getters
     ////////////////////
 
-    /** Calculate the MD5 value from an input std::string.
+    /** Retrieve the name of the algorithm.
      *
      *  @pre The object is instantiated.
-     *  @post The MD5 sum is stored in the _hash values.
-     *  @param str The string whose value is to be hashed.
-     *  @return The MD5 value as a std::string.
+     *  @post none.
+     *  @return "MD5".
     */
-    string calculateHash (const string &str);
+    string algorithmName (void) const;
 
-    /** Calculate the MD5 value from an input data stream.
+    /** Copy the object, including any partially processed message.
      *
-     *  @pre The object is instantiated.
-     *  @post The MD5 sum is stored in the _hash values.
-     *  @param data The data that is to be hashed.
-     *  @return The MD5 value as a std::string.
+     *  @pre none.
+     *  @post The caller owns (and must delete) the copy.
+     *  @return A new MD5 object in the same state.
     */
-    string calculateHash (const vector < byte_t > &data);
+    MD5 * clone (void) const;
 
-    /** Calculate the MD5 value of a file.
+    /******************************************************
+    **                     Operators                     **
+    ******************************************************/
+
+    /** Assignment from another MD5 object.
      *
      *  @pre The object is instantiated.
-     *  @post The MD5 sum is stored in the _hash values.
-     *  @param file The file whose MD5 is to be calculated.
-     *  @return The MD5 value as a std::string.
+     *  @post The object contains the values copied from rhs.
+     *  @param rhs The MD5 object whose values are to be copied/stored.
+     *  @return A reference to the object.
     */
-    string calculateHash (ifstream &file);
+    MD5 & operator = (const MD5 &rhs);
+
+  protected:
+    /******************************************************
+    **                      Members                      **
+    ******************************************************/
+    uint32_t _state[4];  // The four 32-bit chaining variables.
 
-  private:
     /******************************************************
     **                   Helper Methods                  **
     ******************************************************/
@@ -158,77 +167,83 @@ class MD5 : public MessageHash
     /** Initialize the MD5 hash.
      *
      *  @pre The object is instantiated.
-     *  @post The values in _hash are initialized to the
+     *  @post The values in _state are initialized to the
      *        chaining variable values.
      *  @return none.
     */
     void _initializeHash (void);
 
-    /** Pad the message contents to meet RFC1321.
+    /** Compress whole 512-bit message blocks.
      *
-     *  @pre The object is instantiated.
-     *  @post none.
-     *  @param data The data that is to be hashed.
-     *  @return A vector containing the padded data.
+     *  @pre The chaining variables have been initialized.
+     *  @post The chaining variables are updated.
+     *  @param blocks A pointer to the first block.
+     *  @param count The number of consecutive blocks at blocks.
+     *  @return none.
     */
-    vector < byte_t > _padVector (const vector < byte_t > &data) const;
+    void _compress (const byte_t *blocks, uint64_t count);
 
-    /** Pad the message contents to meet RFC1321.
+    /** Copy the chaining variables into the _hash words.
      *
-     *  @pre The object is instantiated.
-     *  @post none.
-     *  @param lastBlock The last block of data from the file (the block
-     *         that is to be padded).
-     *  @param dataInBlock The number of bytes of message data in the block.
-     *  @param bitsInFile The size of the message in bits.
+     *  @pre The final block has been compressed.
+     *  @post The _hash values hold the message digest.
      *  @return none.
     */
-    void _padLastBlock (vector < uint32_t > &lastBlock, uint32_t dataInBlock,
-                        uint64_t bitsInFile) const;
+    void _storeHash (void);
 
-    /** Convert the hash from big endian to little endian format.
+    /** Append the chaining variables to an exported state.
      *
-     *  @pre The object is instantiated.
-     *  @post The values of _hash are rearranged to little endian format.
+     *  @pre none.
+     *  @post The chaining variables are appended to state.
+     *  @param state The state that is being exported.
+     *  @return none.
+    */
+    void _saveChaining (HashState &state) const;
+
+    /** Restore the chaining variables from an imported state.
+     *
+     *  @pre The block buffer has been read from state.
+     *  @post The chaining variables are restored.
+     *  @param state The state that is being imported.
      *  @return none.
     */
-    void _convertToLittleEndian (void);
+    void _loadChaining (HashState &state);
 
     /** Avalanche effect, Round 1.
      *
      *  @pre The object is instantiated.
-     *  @post The values of _hash are manipulated.
+     *  @post The values of _state are manipulated.
      *  @param b512 The 512-bit message block (16, 32-bit words).
      *  @return none.
     */
-    void _round1 (vector < uint32_t > b512);
+    void _round1 (const uint32_t b512[16]);
 
     /** Avalanche effect, Round 2.
      *
      *  @pre The object is instantiated.
-     *  @post The values of _hash are manipulated.
+     *  @post The values of _state are manipulated.
      *  @param b512 The 512-bit message block (16, 32-bit words).
      *  @return none.
     */
-    void _round2 (vector < uint32_t > b512);
+    void _round2 (const uint32_t b512[16]);
 
     /** Avalanche effect, Round 3.
      *
      *  @pre The object is instantiated.
-     *  @post The values of _hash are manipulated.
+     *  @post The values of _state are manipulated.
      *  @param b512 The 512-bit message block (16, 32-bit words).
      *  @return none.
     */
-    void _round3 (vector < uint32_t > b512);
+    void _round3 (const uint32_t b512[16]);
 
     /** Avalanche effect, Round 4.
      *
      *  @pre The object is instantiated.
-     *  @post The values of _hash are manipulated.
+     *  @post The values of _state are manipulated.
      *  @param b512 The 512-bit message block (16, 32-bit words).
      *  @return none.
     */
-    void _round4 (vector < uint32_t > b512);
+    void _round4 (const uint32_t b512[16]);
 
     // These functions are used for the rounding (avalanche effect)
     // of the MD5 algorithm as specified by RFC 1321
@@ -236,11 +251,11 @@ class MD5 : public MessageHash
     /** The avalanche function used for Round 1 as specified by RFC 1321.
      *
      *  @pre The object is instantiated.
-     *  @post The _hash values are manipulated.
-     *  @param a The current chaining variable of the _hash sub-part A.
-     *  @param b The current chaining variable of the _hash sub-part B.
-     *  @param c The current chaining variable of the _hash sub-part C.
-     *  @param d The current chaining variable of the _hash sub-part D.
+     *  @post The _state values are manipulated.
+     *  @param a The current chaining variable of the _state sub-part A.
+     *  @param b The current chaining variable of the _state sub-part B.
+     *  @param c The current chaining variable of the _state sub-part C.
+     *  @param d The current chaining variable of the _state sub-part D.
      *  @param Mi The i-th sub-block of the message.
      *  @param s The number of bits used in the left circular shift.
      *  @param t A constant which is the integer part of:
@@ -253,11 +268,11 @@ class MD5 : public MessageHash
     /** The avalanche function used for Round 2 as specified by RFC 1321.
      *
      *  @pre The object is instantiated.
-     *  @post The _hash values are manipulated.
-     *  @param a The current chaining variable of the _hash sub-part A.
-     *  @param b The current chaining variable of the _hash sub-part B.
-     *  @param c The current chaining variable of the _hash sub-part C.
-     *  @param d The current chaining variable of the _hash sub-part D.
+     *  @post The _state values are manipulated.
+     *  @param a The current chaining variable of the _state sub-part A.
+     *  @param b The current chaining variable of the _state sub-part B.
+     *  @param c The current chaining variable of the _state sub-part C.
+     *  @param d The current chaining variable of the _state sub-part D.
      *  @param Mi The i-th sub-block of the message.
      *  @param s The number of bits used in the left circular shift.
      *  @param t A constant which is the integer part of:
@@ -270,11 +285,11 @@ class MD5 : public MessageHash
     /** The avalanche function used for Round 3 as specified by RFC 1321.
      *
      *  @pre The object is instantiated.
-     *  @post The _hash values are manipulated.
-     *  @param a The current chaining variable of the _hash sub-part A.
-     *  @param b The current chaining variable of the _hash sub-part B.
-     *  @param c The current chaining variable of the _hash sub-part C.
-     *  @param d The current chaining variable of the _hash sub-part D.
+     *  @post The _state values are manipulated.
+     *  @param a The current chaining variable of the _state sub-part A.
+     *  @param b The current chaining variable of the _state sub-part B.
+     *  @param c The current chaining variable of the _state sub-part C.
+     *  @param d The current chaining variable of the _state sub-part D.
      *  @param Mi The i-th sub-block of the message.
      *  @param s The number of bits used in the left circular shift.
      *  @param t A constant which is the integer part of:
@@ -287,11 +302,11 @@ class MD5 : public MessageHash
     /** The avalanche function used for Round 4 as specified by RFC 1321.
      *
      *  @pre The object is instantiated.
-     *  @post The _hash values are manipulated.
-     *  @param a The current chaining variable of the _hash sub-part A.
-     *  @param b The current chaining variable of the _hash sub-part B.
-     *  @param c The current chaining variable of the _hash sub-part C.
-     *  @param d The current chaining variable of the _hash sub-part D.
+     *  @post The _state values are manipulated.
+     *  @param a The current chaining variable of the _state sub-part A.
+     *  @param b The current chaining variable of the _state sub-part B.
+     *  @param c The current chaining variable of the _state sub-part C.
+     *  @param d The current chaining variable of the _state sub-part D.
      *  @param Mi The i-th sub-block of the message.
      *  @param s The number of bits used in the left circular shift.
      *  @param t A constant which is the integer part of:
@@ -0,0 +1,745 @@
+/******************************************************************************
+||  sha1.cpp                                                                 ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    This abstract data type is used to calculate the SHA-1 hash of an      ||
+||    input message or data stream.  SHA-1 is no longer collision resistant; ||
+||    it is provided for verifying digests published by other systems.       ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    block_hash.cpp (block_hash.lib)                                        ||
+||    block_hash.h                                                           ||
+||    cpu_features.cpp (cpu_features.lib)                                    ||
+||    cpu_features.h                                                         ||
+||    hash_abstract.cpp (hash_abstract.lib)                                  ||
+||    hash_abstract.h                                                        ||
+||                                                                           ||
+||===========================================================================||
+||  REFERENCES                                                               ||
+||===========================================================================||
+||    FIPS 180-1, "Secure Hash Standard".  17 Apr 1995.  National Institute  ||
+||        of Standards and Technology.                                       ||
+||                                                                           ||
+||    Gulley, S. et al.  "Intel SHA Extensions".  Intel Corporation.  Jul    ||
+||        2013.                                                              ||
+||                                                                           ||
+||    Locktyukhin, M.  "Improving the Performance of the Secure Hash         ||
+||        Algorithm (SHA-1)".  Intel Corporation.  Mar 2010.                 ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file sha1.cpp
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+#include "sha1.h"
+#include "hash_state.h"
+#include "cpu_features.h"
+
+#ifdef GASH_X86_SIMD
+  #include <immintrin.h>
+#endif
+
+// SHA-1 uses one additive constant for each group of 20 rounds; these are
+// the integer parts of 2^30 times the square roots of 2, 3, 5 and 10.
+static const uint32_t K1[4] =
+                     { 0x5a827999, 0x6ed9eba1, 0x8f1bbcdc, 0xca62c1d6 };
+
+/******************************************************
+**                 Compression Kernels               **
+******************************************************/
+
+// The kernels are plain functions (rather than members) so that each one
+// can be compiled for its own instruction set; _compress() picks the
+// fastest one the host supports the first time it is called.
+typedef void (*Sha1Kernel)(uint32_t state[5], const byte_t *blocks,
+                           uint64_t count);
+
+static inline uint32_t rotl32 (uint32_t x, uint32_t n)
+{  return ((x << n) | (x >> (32 - n)));  }
+
+static inline uint32_t loadBigEndian32 (const byte_t *p)
+{
+    return   ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16)
+           | ((uint32_t)p[2] <<  8) | ((uint32_t)p[3]      );
+}
+
+/** The round function of each group of 20 rounds.  */
+static GASH_ALWAYS_INLINE uint32_t
+sha1F (uint32_t phase, uint32_t b, uint32_t c, uint32_t d)
+{
+    switch (phase)
+    {
+        case 0:   return (d ^ (b & (c ^ d)));            // Choose.
+        case 2:   return ((b & c) | (d & (b | c)));      // Majority.
+        default:  return (b ^ c ^ d);                    // Parity.
+    }
+}
+
+/** One SHA-1 round.  The caller rotates the argument order rather than
+ *  shuffling the five working variables; only b and e are written.
+*/
+static GASH_ALWAYS_INLINE void
+sha1Round (uint32_t phase, uint32_t a, uint32_t &b, uint32_t c, uint32_t d,
+           uint32_t &e, uint32_t wk)
+{
+    e += rotl32(a, 5) + sha1F(phase, b, c, d) + wk;
+    b = rotl32(b, 30);
+}
+
+/** Fetch word j of a schedule stored in strided groups of four.  */
+static GASH_ALWAYS_INLINE uint32_t
+scheduleWord (const uint32_t *wk, uint32_t stride, uint32_t j)
+{  return wk[((j >> 2) * stride) + (j & 3)];  }
+
+/** Run one group of 20 rounds (which share a round function).  */
+static GASH_ALWAYS_INLINE void
+sha1Rounds20 (uint32_t phase, uint32_t &a, uint32_t &b, uint32_t &c,
+              uint32_t &d, uint32_t &e, const uint32_t *wk, uint32_t stride)
+{
+    for (uint32_t j = phase * 20; j < (phase + 1) * 20; j += 5)
+    {
+        sha1Round(phase, a, b, c, d, e, scheduleWord(wk, stride, j));
+        sha1Round(phase, e, a, b, c, d, scheduleWord(wk, stride, j + 1));
+        sha1Round(phase, d, e, a, b, c, scheduleWord(wk, stride, j + 2));
+        sha1Round(phase, c, d, e, a, b, scheduleWord(wk, stride, j + 3));
+        sha1Round(phase, b, c, d, e, a, scheduleWord(wk, stride, j + 4));
+    }
+}
+
+/** Run the 80 rounds over a schedule that already includes the K words.
+ *  The schedule is stored in groups of four words, consecutive groups
+ *  being stride words apart (the two block AVX2 kernel interleaves the
+ *  groups of both blocks).
+*/
+static GASH_ALWAYS_INLINE void
+sha1Rounds (uint32_t state[5], const uint32_t *wk, uint32_t stride)
+{
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3],
+             e = state[4];
+
+    // The phase is a constant in each call so that the round function
+    // switch folds away.
+    sha1Rounds20(0, a, b, c, d, e, wk, stride);
+    sha1Rounds20(1, a, b, c, d, e, wk, stride);
+    sha1Rounds20(2, a, b, c, d, e, wk, stride);
+    sha1Rounds20(3, a, b, c, d, e, wk, stride);
+
+    state[0] += a;  state[1] += b;  state[2] += c;  state[3] += d;
+    state[4] += e;
+}
+
+/** The portable kernel: a scalar message schedule and scalar rounds.  */
+static void sha1CompressPortable (uint32_t state[5], const byte_t *blocks,
+                                  uint64_t count)
+{
+    uint32_t w[80], wk[80];
+
+    for (uint64_t i = 0; i < count; ++i, blocks += 64)
+    {
+        for (uint32_t j = 0; j < 16; ++j)
+            w[j] = loadBigEndian32(blocks + (j * 4));
+
+        for (uint32_t j = 16; j < 80; ++j)
+            w[j] = rotl32(w[j - 3] ^ w[j - 8] ^ w[j - 14] ^ w[j - 16], 1);
+
+        for (uint32_t j = 0; j < 80; ++j)
+            wk[j] = w[j] + K1[j / 20];
+
+        sha1Rounds(state, wk, 4);
+    }
+}
+
+#ifdef GASH_X86_SIMD
+
+__attribute__((target("ssse3")))
+static inline __m128i rotl32x4 (__m128i x, int n)
+{  return _mm_or_si128(_mm_slli_epi32(x, n), _mm_srli_epi32(x, 32 - n));  }
+
+/** The next four schedule words.  W[t+3] depends on W[t], which is
+ *  computed in the same group, so the group is first evaluated with zero
+ *  in place of W[t] and then corrected: rotl(x ^ W[t], 1) is
+ *  rotl(x, 1) ^ rotl(W[t], 1).
+*/
+__attribute__((target("ssse3")))
+static inline __m128i sha1Schedule4 (__m128i w16, __m128i w12, __m128i w8,
+                                     __m128i w4)
+{
+    __m128i x = _mm_xor_si128(_mm_xor_si128(_mm_srli_si128(w4, 4), w8),
+                              _mm_xor_si128(_mm_alignr_epi8(w12, w16, 8), w16));
+    x = rotl32x4(x, 1);
+
+    return _mm_xor_si128(x, rotl32x4(_mm_slli_si128(x, 12), 1));
+}
+
+/** The SSSE3 kernel: the message schedule is computed four words at a
+ *  time and the rounds are scalar.
+*/
+__attribute__((target("ssse3")))
+static void sha1CompressSSSE3 (uint32_t state[5], const byte_t *blocks,
+                               uint64_t count)
+{
+    // Reverses the bytes within each 32-bit word.
+    const __m128i byteSwap = _mm_set_epi8(12, 13, 14, 15,  8,  9, 10, 11,
+                                           4,  5,  6,  7,  0,  1,  2,  3);
+
+    __m128i w[20];
+    uint32_t wk[80] __attribute__((aligned(16)));
+
+    for (uint64_t i = 0; i < count; ++i, blocks += 64)
+    {
+        for (uint32_t j = 0; j < 20; ++j)
+        {
+            if (j < 4)
+                w[j] = _mm_shuffle_epi8(
+                           _mm_loadu_si128((const __m128i *)(blocks + j * 16)),
+                           byteSwap);
+            else
+                w[j] = sha1Schedule4(w[j - 4], w[j - 3], w[j - 2], w[j - 1]);
+
+            _mm_store_si128((__m128i *)&wk[j * 4],
+                            _mm_add_epi32(w[j], _mm_set1_epi32(K1[j / 5])));
+        }
+
+        sha1Rounds(state, wk, 4);
+    }
+}
+
+__attribute__((target("avx2")))
+static inline __m256i rotl32x8 (__m256i x, int n)
+{
+    return _mm256_or_si256(_mm256_slli_epi32(x, n),
+                           _mm256_srli_epi32(x, 32 - n));
+}
+
+/** sha1Schedule4() for two blocks, one per 128-bit lane.  */
+__attribute__((target("avx2")))
+static inline __m256i sha1Schedule8 (__m256i w16, __m256i w12, __m256i w8,
+                                     __m256i w4)
+{
+    __m256i x = _mm256_xor_si256(
+                    _mm256_xor_si256(_mm256_srli_si256(w4, 4), w8),
+                    _mm256_xor_si256(_mm256_alignr_epi8(w12, w16, 8), w16));
+    x = rotl32x8(x, 1);
+
+    return _mm256_xor_si256(x, rotl32x8(_mm256_slli_si256(x, 12), 1));
+}
+
+/** The AVX2 kernel: the SSSE3 schedule is run on two blocks at once, one
+ *  per 128-bit lane, and the rounds of the two blocks run back to back.
+*/
+__attribute__((target("avx2")))
+static void sha1CompressAVX2 (uint32_t state[5], const byte_t *blocks,
+                              uint64_t count)
+{
+    const __m256i byteSwap = _mm256_set_epi8(12, 13, 14, 15,  8,  9, 10, 11,
+                                              4,  5,  6,  7,  0,  1,  2,  3,
+                                             12, 13, 14, 15,  8,  9, 10, 11,
+                                              4,  5,  6,  7,  0,  1,  2,  3);
+
+    __m256i w[20];
+    uint32_t wk[160] __attribute__((aligned(32)));
+
+    for (; count >= 2; count -= 2, blocks += 128)
+    {
+        for (uint32_t j = 0; j < 20; ++j)
+        {
+            if (j < 4)
+                w[j] = _mm256_shuffle_epi8(_mm256_inserti128_si256(
+                           _mm256_castsi128_si256(_mm_loadu_si128(
+                               (const __m128i *)(blocks + j * 16))),
+                           _mm_loadu_si128(
+                               (const __m128i *)(blocks + 64 + j * 16)),
+                           1), byteSwap);
+            else
+                w[j] = sha1Schedule8(w[j - 4], w[j - 3], w[j - 2], w[j - 1]);
+
+            _mm256_store_si256((__m256i *)&wk[j * 8], _mm256_add_epi32(w[j],
+                               _mm256_set1_epi32(K1[j / 5])));
+        }
+
+        sha1Rounds(state, wk, 8);
+        sha1Rounds(state, wk + 4, 8);
+    }
+
+    if (count > 0)
+        sha1CompressSSSE3(state, blocks, count);
+}
+
+/** Four rounds with the SHA extensions.  The round function selector of
+ *  sha1rnds4 must be an immediate, hence the switch.
+*/
+__attribute__((target("sha,sse4.1")))
+static inline __m128i sha1NiRounds (__m128i abcd, __m128i e, int phase)
+{
+    switch (phase)
+    {
+        case 0:   return _mm_sha1rnds4_epu32(abcd, e, 0);
+        case 1:   return _mm_sha1rnds4_epu32(abcd, e, 1);
+        case 2:   return _mm_sha1rnds4_epu32(abcd, e, 2);
+        default:  return _mm_sha1rnds4_epu32(abcd, e, 3);
+    }
+}
+
+/** The SHA extensions kernel.  */
+__attribute__((target("sha,sse4.1")))
+static void sha1CompressSHA (uint32_t state[5], const byte_t *blocks,
+                             uint64_t count)
+{
+    // Reverses all 16 bytes; sha1rnds4 keeps A in the most significant
+    // lane.
+    const __m128i byteSwap = _mm_set_epi64x(0x0001020304050607ULL,
+                                            0x08090a0b0c0d0e0fULL);
+
+    __m128i abcd = _mm_shuffle_epi32(
+                       _mm_loadu_si128((const __m128i *)state), 0x1b);
+    __m128i e0 = _mm_set_epi32((int)state[4], 0, 0, 0);
+    __m128i e1;
+
+    for (uint64_t i = 0; i < count; ++i, blocks += 64)
+    {
+        __m128i abcdSave = abcd,
+                e0Save = e0;
+
+        __m128i msg0 = _mm_shuffle_epi8(
+                    _mm_loadu_si128((const __m128i *)(blocks     )), byteSwap);
+        __m128i msg1 = _mm_shuffle_epi8(
+                    _mm_loadu_si128((const __m128i *)(blocks + 16)), byteSwap);
+        __m128i msg2 = _mm_shuffle_epi8(
+                    _mm_loadu_si128((const __m128i *)(blocks + 32)), byteSwap);
+        __m128i msg3 = _mm_shuffle_epi8(
+                    _mm_loadu_si128((const __m128i *)(blocks + 48)), byteSwap);
+
+        // Rounds 0-3
+        e0 = _mm_add_epi32(e0, msg0);
+        e1 = abcd;
+        abcd = sha1NiRounds(abcd, e0, 0);
+
+        // Rounds 4-7
+        e1 = _mm_sha1nexte_epu32(e1, msg1);
+        e0 = abcd;
+        abcd = sha1NiRounds(abcd, e1, 0);
+        msg0 = _mm_sha1msg1_epu32(msg0, msg1);
+
+        // Rounds 8-11
+        e0 = _mm_sha1nexte_epu32(e0, msg2);
+        e1 = abcd;
+        abcd = sha1NiRounds(abcd, e0, 0);
+        msg1 = _mm_sha1msg1_epu32(msg1, msg2);
+        msg0 = _mm_xor_si128(msg0, msg2);
+
+        // Rounds 12-15
+        e1 = _mm_sha1nexte_epu32(e1, msg3);
+        e0 = abcd;
+        abcd = sha1NiRounds(abcd, e1, 0);
+        msg0 = _mm_sha1msg2_epu32(msg0, msg3);
+        msg2 = _mm_sha1msg1_epu32(msg2, msg3);
+        msg1 = _mm_xor_si128(msg1, msg3);
+
+        // Rounds 16-19
+        e0 = _mm_sha1nexte_epu32(e0, msg0);
+        e1 = abcd;
+        abcd = sha1NiRounds(abcd, e0, 0);
+        msg1 = _mm_sha1msg2_epu32(msg1, msg0);
+        msg3 = _mm_sha1msg1_epu32(msg3, msg0);
+        msg2 = _mm_xor_si128(msg2, msg0);
+
+        // Rounds 20-23
+        e1 = _mm_sha1nexte_epu32(e1, msg1);
+        e0 = abcd;
+        abcd = sha1NiRounds(abcd, e1, 1);
+        msg2 = _mm_sha1msg2_epu32(msg2, msg1);
+        msg0 = _mm_sha1msg1_epu32(msg0, msg1);
+        msg3 = _mm_xor_si128(msg3, msg1);
+
+        // Rounds 24-27
+        e0 = _mm_sha1nexte_epu32(e0, msg2);
+        e1 = abcd;
+        abcd = sha1NiRounds(abcd, e0, 1);
+        msg3 = _mm_sha1msg2_epu32(msg3, msg2);
+        msg1 = _mm_sha1msg1_epu32(msg1, msg2);
+        msg0 = _mm_xor_si128(msg0, msg2);
+
+        // Rounds 28-31
+        e1 = _mm_sha1nexte_epu32(e1, msg3);
+        e0 = abcd;
+        abcd = sha1NiRounds(abcd, e1, 1);
+        msg0 = _mm_sha1msg2_epu32(msg0, msg3);
+        msg2 = _mm_sha1msg1_epu32(msg2, msg3);
+        msg1 = _mm_xor_si128(msg1, msg3);
+
+        // Rounds 32-35
+        e0 = _mm_sha1nexte_epu32(e0, msg0);
+        e1 = abcd;
+        abcd = sha1NiRounds(abcd, e0, 1);
+        msg1 = _mm_sha1msg2_epu32(msg1, msg0);
+        msg3 = _mm_sha1msg1_epu32(msg3, msg0);
+        msg2 = _mm_xor_si128(msg2, msg0);
+
+        // Rounds 36-39
+        e1 = _mm_sha1nexte_epu32(e1, msg1);
+        e0 = abcd;
+        abcd = sha1NiRounds(abcd, e1, 1);
+        msg2 = _mm_sha1msg2_epu32(msg2, msg1);
+        msg0 = _mm_sha1msg1_epu32(msg0, msg1);
+        msg3 = _mm_xor_si128(msg3, msg1);
+
+        // Rounds 40-43
+        e0 = _mm_sha1nexte_epu32(e0, msg2);
+        e1 = abcd;
+        abcd = sha1NiRounds(abcd, e0, 2);
+        msg3 = _mm_sha1msg2_epu32(msg3, msg2);
+        msg1 = _mm_sha1msg1_epu32(msg1, msg2);
+        msg0 = _mm_xor_si128(msg0, msg2);
+
+        // Rounds 44-47
+        e1 = _mm_sha1nexte_epu32(e1, msg3);
+        e0 = abcd;
+        abcd = sha1NiRounds(abcd, e1, 2);
+        msg0 = _mm_sha1msg2_epu32(msg0, msg3);
+        msg2 = _mm_sha1msg1_epu32(msg2, msg3);
+        msg1 = _mm_xor_si128(msg1, msg3);
+
+        // Rounds 48-51
+        e0 = _mm_sha1nexte_epu32(e0, msg0);
+        e1 = abcd;
+        abcd = sha1NiRounds(abcd, e0, 2);
+        msg1 = _mm_sha1msg2_epu32(msg1, msg0);
+        msg3 = _mm_sha1msg1_epu32(msg3, msg0);
+        msg2 = _mm_xor_si128(msg2, msg0);
+
+        // Rounds 52-55
+        e1 = _mm_sha1nexte_epu32(e1, msg1);
+        e0 = abcd;
+        abcd = sha1NiRounds(abcd, e1, 2);
+        msg2 = _mm_sha1msg2_epu32(msg2, msg1);
+        msg0 = _mm_sha1msg1_epu32(msg0, msg1);
+        msg3 = _mm_xor_si128(msg3, msg1);
+
+        // Rounds 56-59
+        e0 = _mm_sha1nexte_epu32(e0, msg2);
+        e1 = abcd;
+        abcd = sha1NiRounds(abcd, e0, 2);
+        msg3 = _mm_sha1msg2_epu32(msg3, msg2);
+        msg1 = _mm_sha1msg1_epu32(msg1, msg2);
+        msg0 = _mm_xor_si128(msg0, msg2);
+
+        // Rounds 60-63
+        e1 = _mm_sha1nexte_epu32(e1, msg3);
+        e0 = abcd;
+        abcd = sha1NiRounds(abcd, e1, 3);
+        msg0 = _mm_sha1msg2_epu32(msg0, msg3);
+        msg2 = _mm_sha1msg1_epu32(msg2, msg3);
+        msg1 = _mm_xor_si128(msg1, msg3);
+
+        // Rounds 64-67
+        e0 = _mm_sha1nexte_epu32(e0, msg0);
+        e1 = abcd;
+        abcd = sha1NiRounds(abcd, e0, 3);
+        msg1 = _mm_sha1msg2_epu32(msg1, msg0);
+        msg3 = _mm_sha1msg1_epu32(msg3, msg0);
+        msg2 = _mm_xor_si128(msg2, msg0);
+
+        // Rounds 68-71
+        e1 = _mm_sha1nexte_epu32(e1, msg1);
+        e0 = abcd;
+        abcd = sha1NiRounds(abcd, e1, 3);
+        msg2 = _mm_sha1msg2_epu32(msg2, msg1);
+        msg3 = _mm_xor_si128(msg3, msg1);
+
+        // Rounds 72-75
+        e0 = _mm_sha1nexte_epu32(e0, msg2);
+        e1 = abcd;
+        abcd = sha1NiRounds(abcd, e0, 3);
+        msg3 = _mm_sha1msg2_epu32(msg3, msg2);
+
+        // Rounds 76-79
+        e1 = _mm_sha1nexte_epu32(e1, msg3);
+        e0 = abcd;
+        abcd = sha1NiRounds(abcd, e1, 3);
+        e0 = _mm_sha1nexte_epu32(e0, e0Save);
+        abcd = _mm_add_epi32(abcd, abcdSave);
+    }
+
+    abcd = _mm_shuffle_epi32(abcd, 0x1b);
+    _mm_storeu_si128((__m128i *)state, abcd);
+    state[4] = (uint32_t)_mm_extract_epi32(e0, 3);
+}
+
+#endif  // GASH_X86_SIMD
+
+/** Choose the fastest kernel that the host supports.  */
+static Sha1Kernel selectSha1Kernel (void)
+{
+#ifdef GASH_X86_SIMD
+    if (CPUFeatures::has(CPUFeatures::SHA))
+        return sha1CompressSHA;
+
+    if (CPUFeatures::has(CPUFeatures::AVX2))
+        return sha1CompressAVX2;
+
+    if (CPUFeatures::has(CPUFeatures::SSSE3))
+        return sha1CompressSSSE3;
+#endif
+
+    return sha1CompressPortable;
+}
+
+/******************************************************
+**            Constructors / Destructors             **
+******************************************************/
+
+/** Default constructor.  */
+SHA1::SHA1 ()
+    : BlockHash(160, 64, 8)
+{
+    _initializeHash();
+}
+
+/** Copy constructor.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated from the copied SHA1 object.
+ *  @param copyFrom The SHA1 object whose values are to be copied.
+*/
+SHA1::SHA1 (const SHA1 &copyFrom)
+    : BlockHash(copyFrom)
+{
+    for (uint32_t i = 0; i < 5; ++i)
+        _state[i] = copyFrom._state[i];
+}
+
+/** Initialize an SHA1 object by hashing an input std::string.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated containing the
+ *        hashed value of the input data.
+ *  @param str The std::string that is to be hashed.
+*/
+SHA1::SHA1 (const string &str)
+    : BlockHash(160, 64, 8)
+{
+    calculateHash(str);
+}
+
+/** Initialize an SHA1 object by hashing an input data stream.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated containing the
+ *        hashed value of the input data.
+ *  @param data The data that is to be hashed.
+*/
+SHA1::SHA1 (const vector < byte_t > &data)
+    : BlockHash(160, 64, 8)
+{
+    calculateHash(data);
+}
+
+/** Initialize an SHA1 object by hashing an input file stream.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated containing the
+ *        hashed value of the input data.
+ *  @param file A handle to the file that is to be hashed.
+*/
+SHA1::SHA1 (ifstream &file)
+    : BlockHash(160, 64, 8)
+{
+    calculateHash(file);
+}
+
+/** Default destructor.  */
+SHA1::~SHA1 ()  { }
+
+/******************************************************
+**               Accessors / Mutators                **
+******************************************************/
+
+////////////////////
+//    Getters
+////////////////////
+
+/** Retrieve the name of the algorithm.
+ *
+ *  @pre The object is instantiated.
+ *  @post none.
+ *  @return "SHA-1".
+*/
+string SHA1::algorithmName (void) const
+{
+    return "SHA-1";
+}
+
+/** Retrieve the name of the kernel that the host selected.
+ *
+ *  @pre The object is instantiated.
+ *  @post none.
+ *  @return "SHA-NI", "AVX2", "SSSE3" or "portable".
+*/
+string SHA1::kernelName (void) const
+{
+#ifdef GASH_X86_SIMD
+    Sha1Kernel kernel = selectSha1Kernel();
+
+    if (kernel == sha1CompressSHA)
+        return "SHA-NI";
+
+    if (kernel == sha1CompressAVX2)
+        return "AVX2";
+
+    if (kernel == sha1CompressSSSE3)
+        return "SSSE3";
+#endif
+
+    return "portable";
+}
+
+/** Copy the object, including any partially processed message.
+ *
+ *  @pre none.
+ *  @post The caller owns (and must delete) the copy.
+ *  @return A new SHA1 object in the same state.
+*/
+SHA1 * SHA1::clone (void) const
+{
+    return new SHA1(*this);
+}
+
+/******************************************************
+**                     Operators                     **
+******************************************************/
+
+/** Assignment from another SHA1 object.
+ *
+ *  @pre The object is instantiated.
+ *  @post The object contains the values copied from rhs.
+ *  @param rhs The SHA1 object whose values are to be copied/stored.
+ *  @return A reference to the object.
+*/
+SHA1 & SHA1::operator = (const SHA1 &rhs)
+{
+    if (this != &rhs)
+    {
+        BlockHash::operator = (rhs);
+
+        for (uint32_t i = 0; i < 5; ++i)
+            _state[i] = rhs._state[i];
+    }
+
+    return *this;
+}
+
+/******************************************************
+**                   Helper Methods                  **
+******************************************************/
+
+/** Initialize the SHA1 hash.
+ *
+ *  @pre The object is instantiated.
+ *  @post The values in _state are initialized to the
+ *        chaining variable values.
+ *  @return none.
+*/
+void SHA1::_initializeHash (void)
+{
+    _state[0] = 0x67452301;
+    _state[1] = 0xefcdab89;
+    _state[2] = 0x98badcfe;
+    _state[3] = 0x10325476;
+    _state[4] = 0xc3d2e1f0;
+
+    return;
+}
+
+/** Compress whole 512-bit message blocks.
+ *
+ *  @pre The chaining variables have been initialized.
+ *  @post The chaining variables are updated.
+ *  @param blocks A pointer to the first block.
+ *  @param count The number of consecutive blocks at blocks.
+ *  @return none.
+*/
+void SHA1::_compress (const byte_t *blocks, uint64_t count)
+{
+    static const Sha1Kernel kernel = selectSha1Kernel();
+
+    kernel(_state, blocks, count);
+
+    return;
+}
+
+/** Copy the chaining variables into the _hash words.
+ *
+ *  @pre The final block has been compressed.
+ *  @post The _hash values hold the message digest.
+ *  @return none.
+*/
+void SHA1::_storeHash (void)
+{
+    for (uint32_t i = 0; i < 5; ++i)
+        _hash.at(i) = _state[i];
+
+    return;
+}
+
+/** Append the chaining variables to an exported state.
+ *
+ *  @pre none.
+ *  @post The chaining variables are appended to state.
+ *  @param state The state that is being exported.
+ *  @return none.
+*/
+void SHA1::_saveChaining (HashState &state) const
+{
+    state.putWords32(_state, 5);
+
+    return;
+}
+
+/** Restore the chaining variables from an imported state.
+ *
+ *  @pre The block buffer has been read from state.
+ *  @post The chaining variables are restored.
+ *  @param state The state that is being imported.
+ *  @return none.
+*/
+void SHA1::_loadChaining (HashState &state)
+{
+    state.getWords32(_state, 5);
+
+    return;
+}
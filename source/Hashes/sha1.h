@@ -0,0 +1,228 @@
+/******************************************************************************
+||  sha1.h                                                                   ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    This abstract data type is used to calculate the SHA-1 hash of an      ||
+||    input message or data stream.  SHA-1 is no longer collision resistant; ||
+||    it is provided for verifying digests published by other systems.       ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    block_hash.cpp (block_hash.lib)                                        ||
+||    block_hash.h                                                           ||
+||    cpu_features.cpp (cpu_features.lib)                                    ||
+||    cpu_features.h                                                         ||
+||    hash_abstract.cpp (hash_abstract.lib)                                  ||
+||    hash_abstract.h                                                        ||
+||                                                                           ||
+||===========================================================================||
+||  REFERENCES                                                               ||
+||===========================================================================||
+||    FIPS 180-1, "Secure Hash Standard".  17 Apr 1995.  National Institute  ||
+||        of Standards and Technology.                                       ||
+||                                                                           ||
+||    Gulley, S. et al.  "Intel SHA Extensions".  Intel Corporation.  Jul    ||
+||        2013.                                                              ||
+||                                                                           ||
+||    Locktyukhin, M.  "Improving the Performance of the Secure Hash         ||
+||        Algorithm (SHA-1)".  Intel Corporation.  Mar 2010.                 ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file sha1.h
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+#ifndef _GH_SHA_1_DEF_H
+#define _GH_SHA_1_DEF_H
+
+#include "block_hash.h"
+
+/**
+ *  @class SHA1 An abstract data type to calculate and
+ *         manipulate SHA-1 hashes.
+*/
+class SHA1 : public BlockHash
+{
+  public:
+    /******************************************************
+    **            Constructors / Destructors             **
+    ******************************************************/
+
+    /** Default constructor.  */
+    SHA1 ();
+
+    /** Copy constructor.
+     *
+     *  @pre none.
+     *  @post A new object is instantiated from the copied SHA1 object.
+     *  @param copyFrom The SHA1 object whose values are to be copied.
+    */
+    SHA1 (const SHA1 &copyFrom);
+
+    /** Initialize an SHA1 object by hashing an input std::string.
+     *
+     *  @pre none.
+     *  @post A new object is instantiated containing the
+     *        hashed value of the input data.
+     *  @param str The std::string that is to be hashed.
+    */
+    SHA1 (const string &str);
+
+    /** Initialize an SHA1 object by hashing an input data stream.
+     *
+     *  @pre none.
+     *  @post A new object is instantiated containing the
+     *        hashed value of the input data.
+     *  @param data The data that is to be hashed.
+    */
+    SHA1 (const vector < byte_t > &data);
+
+    /** Initialize an SHA1 object by hashing an input file stream.
+     *
+     *  @pre none.
+     *  @post A new object is instantiated containing the
+     *        hashed value of the input data.
+     *  @param file A handle to the file that is to be hashed.
+    */
+    SHA1 (ifstream &file);
+
+    /** Default destructor.  */
+    ~SHA1 ();
+
+    /******************************************************
+    **               Accessors / Mutators                **
+    ******************************************************/
+
+    ////////////////////
+    //    Getters
+    ////////////////////
+
+    /** Retrieve the name of the algorithm.
+     *
+     *  @pre The object is instantiated.
+     *  @post none.
+     *  @return "SHA-1".
+    */
+    string algorithmName (void) const;
+
+    /** Retrieve the name of the kernel that the host selected.
+     *
+     *  @pre The object is instantiated.
+     *  @post none.
+     *  @return "SHA-NI", "AVX2", "SSSE3" or "portable".
+    */
+    string kernelName (void) const;
+
+    /** Copy the object, including any partially processed message.
+     *
+     *  @pre none.
+     *  @post The caller owns (and must delete) the copy.
+     *  @return A new SHA1 object in the same state.
+    */
+    SHA1 * clone (void) const;
+
+    /******************************************************
+    **                     Operators                     **
+    ******************************************************/
+
+    /** Assignment from another SHA1 object.
+     *
+     *  @pre The object is instantiated.
+     *  @post The object contains the values copied from rhs.
+     *  @param rhs The SHA1 object whose values are to be copied/stored.
+     *  @return A reference to the object.
+    */
+    SHA1 & operator = (const SHA1 &rhs);
+
+  protected:
+    /******************************************************
+    **                      Members                      **
+    ******************************************************/
+    uint32_t _state[5];  // The five 32-bit chaining variables.
+
+    /******************************************************
+    **                   Helper Methods                  **
+    ******************************************************/
+
+    /** Initialize the SHA1 hash.
+     *
+     *  @pre The object is instantiated.
+     *  @post The values in _state are initialized to the
+     *        chaining variable values.
+     *  @return none.
+    */
+    void _initializeHash (void);
+
+    /** Compress whole 512-bit message blocks.
+     *
+     *  @pre The chaining variables have been initialized.
+     *  @post The chaining variables are updated.
+     *  @param blocks A pointer to the first block.
+     *  @param count The number of consecutive blocks at blocks.
+     *  @return none.
+    */
+    void _compress (const byte_t *blocks, uint64_t count);
+
+    /** Copy the chaining variables into the _hash words.
+     *
+     *  @pre The final block has been compressed.
+     *  @post The _hash values hold the message digest.
+     *  @return none.
+    */
+    void _storeHash (void);
+
+    /** Append the chaining variables to an exported state.
+     *
+     *  @pre none.
+     *  @post The chaining variables are appended to state.
+     *  @param state The state that is being exported.
+     *  @return none.
+    */
+    void _saveChaining (HashState &state) const;
+
+    /** Restore the chaining variables from an imported state.
+     *
+     *  @pre The block buffer has been read from state.
+     *  @post The chaining variables are restored.
+     *  @param state The state that is being imported.
+     *  @return none.
+    */
+    void _loadChaining (HashState &state);
+
+};  // End class SHA1.
+
+#endif
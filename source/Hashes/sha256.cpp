@@ -4,17 +4,21 @@
 ||                                                                           ||
 ||    Author: Gary Hammock, PE                                               ||
 ||    Creation Date: 2008-08-27                                              ||
-||    Last Edit Date: 2014-03-13                                             ||
+||    Last Edit Date: 2026-10-16                                             ||
 ||                                                                           ||
 ||===========================================================================||
 ||  DESCRIPTION                                                              ||
 ||===========================================================================||
-||    This abstract data type is used to calculate the SHA-256 hash of an    ||
-||    input message or data stream.                                          ||
+||    These abstract data types are used to calculate the SHA-256 and        ||
+||    SHA-224 hashes of an input message or data stream.                     ||
 ||                                                                           ||
 ||===========================================================================||
 ||  CODE DEPENDENCIES                                                        ||
 ||===========================================================================||
+||    block_hash.cpp (block_hash.lib)                                        ||
+||    block_hash.h                                                           ||
+||    cpu_features.cpp (cpu_features.lib)                                    ||
+||    cpu_features.h                                                         ||
 ||    hash_abstract.cpp (hash_abstract.lib)                                  ||
 ||    hash_abstract.h                                                        ||
 ||                                                                           ||
@@ -27,6 +31,9 @@
 ||    FIPS 180-2, "Secure Hash Standard".  01 Aug 2002.  National Institute  ||
 ||        of Standards and Technology.                                       ||
 ||                                                                           ||
+||    Gulley, S. et al.  "Intel SHA Extensions".  Intel Corporation.  Jul    ||
+||        2013.                                                              ||
+||                                                                           ||
 ||===========================================================================||
 ||  LICENSE    (MIT/X11 License)                                             ||
 ||===========================================================================||
@@ -55,15 +62,21 @@
 
 /** @file sha256.cpp
  *  @author Gary Hammock, PE
- *  @date 2014-03-13
+ *  @date 2026-10-16
 */
 
 #include "sha256.h"
+#include "hash_state.h"
+#include "cpu_features.h"
+
+#ifdef GASH_X86_SIMD
+  #include <immintrin.h>
+#endif
 
 // SHA-256 uses a sequence of 64 constant 32-bit words.  These words
 // represent the first 32 bits of the fractional parts of the
 // cube roots of the first 64 prime numbers.
-const uint32_t SHA256::_K[64] =
+static const uint32_t K256[64] =
                      { 0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
                        0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
                        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
@@ -82,14 +95,543 @@ const uint32_t SHA256::_K[64] =
                        0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
                      };
 
+// The initial chaining values of SHA-256 are the first 32 bits of the
+// fractional parts of the square roots of the first 8 primes.
+static const uint32_t IV256[8] =
+                     { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                       0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+                     };
+
+// SHA-224 uses the second 32 bits of the fractional parts of the square
+// roots of the 9th through 16th primes.
+static const uint32_t IV224[8] =
+                     { 0xc1059ed8, 0x367cd507, 0x3070dd17, 0xf70e5939,
+                       0xffc00b31, 0x68581511, 0x64f98fa7, 0xbefa4fa4
+                     };
+
+/******************************************************
+**                 Compression Kernels               **
+******************************************************/
+
+// The kernels are plain functions (rather than members) so that each one
+// can be compiled for its own instruction set; _compress() picks the
+// fastest one the host supports the first time it is called.
+typedef void (*Sha256Kernel)(uint32_t state[8], const byte_t *blocks,
+                             uint64_t count);
+
+static inline uint32_t rotr32 (uint32_t x, uint32_t n)
+{  return ((x >> n) | (x << (32 - n)));  }
+
+static inline uint32_t loadBigEndian32 (const byte_t *p)
+{
+    return   ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16)
+           | ((uint32_t)p[2] <<  8) | ((uint32_t)p[3]      );
+}
+
+/** One SHA-256 round.  Rather than shuffling the eight working variables
+ *  every round, the caller rotates the argument order; only d and h are
+ *  written.
+*/
+static GASH_ALWAYS_INLINE void
+sha256Round (uint32_t a, uint32_t b, uint32_t c, uint32_t &d, uint32_t e,
+             uint32_t f, uint32_t g, uint32_t &h, uint32_t wk)
+{
+    uint32_t t1 = h + (rotr32(e, 6) ^ rotr32(e, 11) ^ rotr32(e, 25))
+                    + ((e & f) ^ (~e & g)) + wk;
+    uint32_t t2 = (rotr32(a, 2) ^ rotr32(a, 13) ^ rotr32(a, 22))
+                    + ((a & b) ^ (a & c) ^ (b & c));
+    d += t1;
+    h = t1 + t2;
+}
+
+/** Run the 64 rounds over a schedule that already includes the K words.
+ *  The schedule is stored in groups of four words, consecutive groups
+ *  being stride words apart (the two block AVX2 kernel interleaves the
+ *  groups of both blocks).
+*/
+static GASH_ALWAYS_INLINE void
+sha256Rounds (uint32_t state[8], const uint32_t *wk, uint32_t stride)
+{
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3],
+             e = state[4], f = state[5], g = state[6], h = state[7];
+
+    for (uint32_t j = 0; j < 16; j += 2)
+    {
+        const uint32_t *lo = wk + (j * stride),
+                       *hi = lo + stride;
+
+        sha256Round(a, b, c, d, e, f, g, h, lo[0]);
+        sha256Round(h, a, b, c, d, e, f, g, lo[1]);
+        sha256Round(g, h, a, b, c, d, e, f, lo[2]);
+        sha256Round(f, g, h, a, b, c, d, e, lo[3]);
+        sha256Round(e, f, g, h, a, b, c, d, hi[0]);
+        sha256Round(d, e, f, g, h, a, b, c, hi[1]);
+        sha256Round(c, d, e, f, g, h, a, b, hi[2]);
+        sha256Round(b, c, d, e, f, g, h, a, hi[3]);
+    }
+
+    state[0] += a;  state[1] += b;  state[2] += c;  state[3] += d;
+    state[4] += e;  state[5] += f;  state[6] += g;  state[7] += h;
+}
+
+/** The portable kernel: a scalar message schedule and scalar rounds.  */
+static void sha256CompressPortable (uint32_t state[8], const byte_t *blocks,
+                                    uint64_t count)
+{
+    uint32_t w[64], wk[64];
+
+    for (uint64_t i = 0; i < count; ++i, blocks += 64)
+    {
+        for (uint32_t j = 0; j < 16; ++j)
+            w[j] = loadBigEndian32(blocks + (j * 4));
+
+        for (uint32_t j = 16; j < 64; ++j)
+        {
+            uint32_t s0 = rotr32(w[j - 15], 7) ^ rotr32(w[j - 15], 18)
+                            ^ (w[j - 15] >> 3);
+            uint32_t s1 = rotr32(w[j - 2], 17) ^ rotr32(w[j - 2], 19)
+                            ^ (w[j - 2] >> 10);
+            w[j] = w[j - 16] + s0 + w[j - 7] + s1;
+        }
+
+        for (uint32_t j = 0; j < 64; ++j)
+            wk[j] = w[j] + K256[j];
+
+        sha256Rounds(state, wk, 4);
+    }
+}
+
+#ifdef GASH_X86_SIMD
+
+__attribute__((target("ssse3")))
+static inline __m128i rotr32x4 (__m128i x, int n)
+{  return _mm_or_si128(_mm_srli_epi32(x, n), _mm_slli_epi32(x, 32 - n));  }
+
+__attribute__((target("ssse3")))
+static inline __m128i sha256Sig0x4 (__m128i x)
+{
+    return _mm_xor_si128(_mm_xor_si128(rotr32x4(x, 7), rotr32x4(x, 18)),
+                         _mm_srli_epi32(x, 3));
+}
+
+__attribute__((target("ssse3")))
+static inline __m128i sha256Sig1x4 (__m128i x)
+{
+    return _mm_xor_si128(_mm_xor_si128(rotr32x4(x, 17), rotr32x4(x, 19)),
+                         _mm_srli_epi32(x, 10));
+}
+
+/** The SSSE3 kernel: the message schedule is computed four words at a
+ *  time.  Within a group of four, the sigma1 term of the upper two words
+ *  depends on the lower two, so it is applied in two passes; sigma1(0) is
+ *  zero, which lets the byte shifts stand in for lane masks.
+*/
+__attribute__((target("ssse3")))
+static void sha256CompressSSSE3 (uint32_t state[8], const byte_t *blocks,
+                                 uint64_t count)
+{
+    // Reverses the bytes within each 32-bit word.
+    const __m128i byteSwap = _mm_set_epi8(12, 13, 14, 15,  8,  9, 10, 11,
+                                           4,  5,  6,  7,  0,  1,  2,  3);
+
+    __m128i w[16];
+    uint32_t wk[64] __attribute__((aligned(16)));
+
+    for (uint64_t i = 0; i < count; ++i, blocks += 64)
+    {
+        for (uint32_t j = 0; j < 4; ++j)
+        {
+            w[j] = _mm_shuffle_epi8(
+                       _mm_loadu_si128((const __m128i *)(blocks + j * 16)),
+                       byteSwap);
+            _mm_store_si128((__m128i *)&wk[j * 4], _mm_add_epi32(w[j],
+                            _mm_loadu_si128((const __m128i *)&K256[j * 4])));
+        }
+
+        for (uint32_t j = 4; j < 16; ++j)
+        {
+            __m128i w15 = _mm_alignr_epi8(w[j - 3], w[j - 4], 4);
+            __m128i w7  = _mm_alignr_epi8(w[j - 1], w[j - 2], 4);
+
+            __m128i next = _mm_add_epi32(_mm_add_epi32(w[j - 4], w7),
+                                         sha256Sig0x4(w15));
+
+            next = _mm_add_epi32(next,
+                       sha256Sig1x4(_mm_srli_si128(w[j - 1], 8)));
+            next = _mm_add_epi32(next,
+                       sha256Sig1x4(_mm_slli_si128(next, 8)));
+
+            w[j] = next;
+            _mm_store_si128((__m128i *)&wk[j * 4], _mm_add_epi32(next,
+                            _mm_loadu_si128((const __m128i *)&K256[j * 4])));
+        }
+
+        sha256Rounds(state, wk, 4);
+    }
+}
+
+__attribute__((target("avx2")))
+static inline __m256i rotr32x8 (__m256i x, int n)
+{
+    return _mm256_or_si256(_mm256_srli_epi32(x, n),
+                           _mm256_slli_epi32(x, 32 - n));
+}
+
+__attribute__((target("avx2")))
+static inline __m256i sha256Sig0x8 (__m256i x)
+{
+    return _mm256_xor_si256(_mm256_xor_si256(rotr32x8(x, 7), rotr32x8(x, 18)),
+                            _mm256_srli_epi32(x, 3));
+}
+
+__attribute__((target("avx2")))
+static inline __m256i sha256Sig1x8 (__m256i x)
+{
+    return _mm256_xor_si256(_mm256_xor_si256(rotr32x8(x, 17),
+                                             rotr32x8(x, 19)),
+                            _mm256_srli_epi32(x, 10));
+}
+
+/** The AVX2 kernel: the SSSE3 schedule is run on two blocks at once, one
+ *  per 128-bit lane (the byte shifts and alignr operate within a lane).
+ *  The rounds of the two blocks then run back to back.
+*/
+__attribute__((target("avx2")))
+static void sha256CompressAVX2 (uint32_t state[8], const byte_t *blocks,
+                                uint64_t count)
+{
+    const __m256i byteSwap = _mm256_set_epi8(12, 13, 14, 15,  8,  9, 10, 11,
+                                              4,  5,  6,  7,  0,  1,  2,  3,
+                                             12, 13, 14, 15,  8,  9, 10, 11,
+                                              4,  5,  6,  7,  0,  1,  2,  3);
+
+    __m256i w[16];
+    uint32_t wk[128] __attribute__((aligned(32)));
+
+    for (; count >= 2; count -= 2, blocks += 128)
+    {
+        for (uint32_t j = 0; j < 4; ++j)
+        {
+            __m256i k = _mm256_broadcastsi128_si256(
+                            _mm_loadu_si128((const __m128i *)&K256[j * 4]));
+
+            w[j] = _mm256_shuffle_epi8(_mm256_inserti128_si256(
+                       _mm256_castsi128_si256(_mm_loadu_si128(
+                           (const __m128i *)(blocks + j * 16))),
+                       _mm_loadu_si128((const __m128i *)(blocks + 64 + j * 16)),
+                       1), byteSwap);
+            _mm256_store_si256((__m256i *)&wk[j * 8],
+                               _mm256_add_epi32(w[j], k));
+        }
+
+        for (uint32_t j = 4; j < 16; ++j)
+        {
+            __m256i k = _mm256_broadcastsi128_si256(
+                            _mm_loadu_si128((const __m128i *)&K256[j * 4]));
+
+            __m256i w15 = _mm256_alignr_epi8(w[j - 3], w[j - 4], 4);
+            __m256i w7  = _mm256_alignr_epi8(w[j - 1], w[j - 2], 4);
+
+            __m256i next = _mm256_add_epi32(_mm256_add_epi32(w[j - 4], w7),
+                                            sha256Sig0x8(w15));
+
+            next = _mm256_add_epi32(next,
+                       sha256Sig1x8(_mm256_srli_si256(w[j - 1], 8)));
+            next = _mm256_add_epi32(next,
+                       sha256Sig1x8(_mm256_slli_si256(next, 8)));
+
+            w[j] = next;
+            _mm256_store_si256((__m256i *)&wk[j * 8],
+                               _mm256_add_epi32(next, k));
+        }
+
+        sha256Rounds(state, wk, 8);
+        sha256Rounds(state, wk + 4, 8);
+    }
+
+    if (count > 0)
+        sha256CompressSSSE3(state, blocks, count);
+}
+
+/** Four rounds with the SHA extensions (two sha256rnds2 instructions).  */
+__attribute__((target("sha,sse4.1")))
+static inline void sha256NiRounds (__m128i &state0, __m128i &state1,
+                                   __m128i msg, const uint32_t *k)
+{
+    msg = _mm_add_epi32(msg, _mm_loadu_si128((const __m128i *)k));
+    state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+    msg = _mm_shuffle_epi32(msg, 0x0e);
+    state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+}
+
+/** Complete the next four schedule words (after sha256msg1).  */
+__attribute__((target("sha,sse4.1")))
+static inline __m128i sha256NiSchedule (__m128i next, __m128i cur,
+                                        __m128i prev)
+{
+    next = _mm_add_epi32(next, _mm_alignr_epi8(cur, prev, 4));
+    return _mm_sha256msg2_epu32(next, cur);
+}
+
+/** The SHA extensions kernel.  The chaining variables are kept in the
+ *  ABEF/CDGH register layout that sha256rnds2 expects.
+*/
+__attribute__((target("sha,sse4.1")))
+static void sha256CompressSHA (uint32_t state[8], const byte_t *blocks,
+                               uint64_t count)
+{
+    const __m128i byteSwap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL,
+                                            0x0405060700010203ULL);
+
+    __m128i tmp    = _mm_loadu_si128((const __m128i *)&state[0]);
+    __m128i state1 = _mm_loadu_si128((const __m128i *)&state[4]);
+
+    tmp    = _mm_shuffle_epi32(tmp, 0xb1);             // CDAB
+    state1 = _mm_shuffle_epi32(state1, 0x1b);          // EFGH
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);  // ABEF
+    state1 = _mm_blend_epi16(state1, tmp, 0xf0);       // CDGH
+
+    for (uint64_t i = 0; i < count; ++i, blocks += 64)
+    {
+        __m128i abefSave = state0,
+                cdghSave = state1;
+
+        __m128i msg0 = _mm_shuffle_epi8(
+                    _mm_loadu_si128((const __m128i *)(blocks     )), byteSwap);
+        __m128i msg1 = _mm_shuffle_epi8(
+                    _mm_loadu_si128((const __m128i *)(blocks + 16)), byteSwap);
+        __m128i msg2 = _mm_shuffle_epi8(
+                    _mm_loadu_si128((const __m128i *)(blocks + 32)), byteSwap);
+        __m128i msg3 = _mm_shuffle_epi8(
+                    _mm_loadu_si128((const __m128i *)(blocks + 48)), byteSwap);
+
+        // Rounds 0-3
+        sha256NiRounds(state0, state1, msg0, &K256[0]);
+
+        // Rounds 4-7
+        sha256NiRounds(state0, state1, msg1, &K256[4]);
+        msg0 = _mm_sha256msg1_epu32(msg0, msg1);
+
+        // Rounds 8-11
+        sha256NiRounds(state0, state1, msg2, &K256[8]);
+        msg1 = _mm_sha256msg1_epu32(msg1, msg2);
+
+        // Rounds 12-15
+        sha256NiRounds(state0, state1, msg3, &K256[12]);
+        msg0 = sha256NiSchedule(msg0, msg3, msg2);
+        msg2 = _mm_sha256msg1_epu32(msg2, msg3);
+
+        // Rounds 16-19
+        sha256NiRounds(state0, state1, msg0, &K256[16]);
+        msg1 = sha256NiSchedule(msg1, msg0, msg3);
+        msg3 = _mm_sha256msg1_epu32(msg3, msg0);
+
+        // Rounds 20-23
+        sha256NiRounds(state0, state1, msg1, &K256[20]);
+        msg2 = sha256NiSchedule(msg2, msg1, msg0);
+        msg0 = _mm_sha256msg1_epu32(msg0, msg1);
+
+        // Rounds 24-27
+        sha256NiRounds(state0, state1, msg2, &K256[24]);
+        msg3 = sha256NiSchedule(msg3, msg2, msg1);
+        msg1 = _mm_sha256msg1_epu32(msg1, msg2);
+
+        // Rounds 28-31
+        sha256NiRounds(state0, state1, msg3, &K256[28]);
+        msg0 = sha256NiSchedule(msg0, msg3, msg2);
+        msg2 = _mm_sha256msg1_epu32(msg2, msg3);
+
+        // Rounds 32-35
+        sha256NiRounds(state0, state1, msg0, &K256[32]);
+        msg1 = sha256NiSchedule(msg1, msg0, msg3);
+        msg3 = _mm_sha256msg1_epu32(msg3, msg0);
+
+        // Rounds 36-39
+        sha256NiRounds(state0, state1, msg1, &K256[36]);
+        msg2 = sha256NiSchedule(msg2, msg1, msg0);
+        msg0 = _mm_sha256msg1_epu32(msg0, msg1);
+
+        // Rounds 40-43
+        sha256NiRounds(state0, state1, msg2, &K256[40]);
+        msg3 = sha256NiSchedule(msg3, msg2, msg1);
+        msg1 = _mm_sha256msg1_epu32(msg1, msg2);
+
+        // Rounds 44-47
+        sha256NiRounds(state0, state1, msg3, &K256[44]);
+        msg0 = sha256NiSchedule(msg0, msg3, msg2);
+        msg2 = _mm_sha256msg1_epu32(msg2, msg3);
+
+        // Rounds 48-51
+        sha256NiRounds(state0, state1, msg0, &K256[48]);
+        msg1 = sha256NiSchedule(msg1, msg0, msg3);
+        msg3 = _mm_sha256msg1_epu32(msg3, msg0);
+
+        // Rounds 52-55
+        sha256NiRounds(state0, state1, msg1, &K256[52]);
+        msg2 = sha256NiSchedule(msg2, msg1, msg0);
+
+        // Rounds 56-59
+        sha256NiRounds(state0, state1, msg2, &K256[56]);
+        msg3 = sha256NiSchedule(msg3, msg2, msg1);
+
+        // Rounds 60-63
+        sha256NiRounds(state0, state1, msg3, &K256[60]);
+        state0 = _mm_add_epi32(state0, abefSave);
+        state1 = _mm_add_epi32(state1, cdghSave);
+    }
+
+    tmp    = _mm_shuffle_epi32(state0, 0x1b);          // FEBA
+    state1 = _mm_shuffle_epi32(state1, 0xb1);          // DCHG
+    state0 = _mm_blend_epi16(tmp, state1, 0xf0);       // DCBA
+    state1 = _mm_alignr_epi8(state1, tmp, 8);          // HGFE
+
+    _mm_storeu_si128((__m128i *)&state[0], state0);
+    _mm_storeu_si128((__m128i *)&state[4], state1);
+}
+
+/** Transpose an 8x8 matrix of 32-bit words.  */
+__attribute__((target("avx2")))
+static GASH_ALWAYS_INLINE void transpose8x8 (__m256i x[8])
+{
+    // Interleave the words, then the word pairs, within each 128-bit
+    // lane; the lanes are exchanged last.
+    __m256i ab0145 = _mm256_unpacklo_epi32(x[0], x[1]);
+    __m256i ab2367 = _mm256_unpackhi_epi32(x[0], x[1]);
+    __m256i cd0145 = _mm256_unpacklo_epi32(x[2], x[3]);
+    __m256i cd2367 = _mm256_unpackhi_epi32(x[2], x[3]);
+    __m256i ef0145 = _mm256_unpacklo_epi32(x[4], x[5]);
+    __m256i ef2367 = _mm256_unpackhi_epi32(x[4], x[5]);
+    __m256i gh0145 = _mm256_unpacklo_epi32(x[6], x[7]);
+    __m256i gh2367 = _mm256_unpackhi_epi32(x[6], x[7]);
+
+    __m256i abcd04 = _mm256_unpacklo_epi64(ab0145, cd0145);
+    __m256i abcd15 = _mm256_unpackhi_epi64(ab0145, cd0145);
+    __m256i abcd26 = _mm256_unpacklo_epi64(ab2367, cd2367);
+    __m256i abcd37 = _mm256_unpackhi_epi64(ab2367, cd2367);
+    __m256i efgh04 = _mm256_unpacklo_epi64(ef0145, gh0145);
+    __m256i efgh15 = _mm256_unpackhi_epi64(ef0145, gh0145);
+    __m256i efgh26 = _mm256_unpacklo_epi64(ef2367, gh2367);
+    __m256i efgh37 = _mm256_unpackhi_epi64(ef2367, gh2367);
+
+    x[0] = _mm256_permute2x128_si256(abcd04, efgh04, 0x20);
+    x[1] = _mm256_permute2x128_si256(abcd15, efgh15, 0x20);
+    x[2] = _mm256_permute2x128_si256(abcd26, efgh26, 0x20);
+    x[3] = _mm256_permute2x128_si256(abcd37, efgh37, 0x20);
+    x[4] = _mm256_permute2x128_si256(abcd04, efgh04, 0x31);
+    x[5] = _mm256_permute2x128_si256(abcd15, efgh15, 0x31);
+    x[6] = _mm256_permute2x128_si256(abcd26, efgh26, 0x31);
+    x[7] = _mm256_permute2x128_si256(abcd37, efgh37, 0x31);
+}
+
+/** The AVX2 multi-buffer kernel: eight independent messages advance by one
+ *  block each, one message per 32-bit lane.  Unlike the single stream
+ *  kernels there is no dependency between the lanes, so the rounds
+ *  themselves are vectorized rather than only the message schedule.
+*/
+__attribute__((target("avx2")))
+static void sha256LanesAVX2 (uint32_t states[][8],
+                             const byte_t *const blocks[8])
+{
+    const __m256i byteSwap = _mm256_set_epi8(12, 13, 14, 15,  8,  9, 10, 11,
+                                              4,  5,  6,  7,  0,  1,  2,  3,
+                                             12, 13, 14, 15,  8,  9, 10, 11,
+                                              4,  5,  6,  7,  0,  1,  2,  3);
+
+    __m256i s[8], w[16];
+
+    // Row j of each 8x8 tile is eight message words of lane j.
+    for (uint32_t q = 0; q < 2; ++q)
+    {
+        for (uint32_t j = 0; j < 8; ++j)
+            w[(q * 8) + j] = _mm256_loadu_si256(
+                                 (const __m256i *)(blocks[j] + (q * 32)));
+
+        transpose8x8(w + (q * 8));
+    }
+
+    for (uint32_t i = 0; i < 16; ++i)
+        w[i] = _mm256_shuffle_epi8(w[i], byteSwap);
+
+    for (uint32_t j = 0; j < 8; ++j)
+        s[j] = _mm256_loadu_si256((const __m256i *)states[j]);
+
+    transpose8x8(s);
+
+    __m256i a = s[0], b = s[1], c = s[2], d = s[3],
+            e = s[4], f = s[5], g = s[6], h = s[7];
+
+    for (uint32_t t = 0; t < 64; ++t)
+    {
+        if (t >= 16)
+            w[t & 15] = _mm256_add_epi32(
+                            _mm256_add_epi32(w[t & 15],
+                                             sha256Sig0x8(w[(t - 15) & 15])),
+                            _mm256_add_epi32(w[(t - 7) & 15],
+                                             sha256Sig1x8(w[(t - 2) & 15])));
+
+        __m256i sum1 = _mm256_xor_si256(_mm256_xor_si256(rotr32x8(e, 6),
+                                                         rotr32x8(e, 11)),
+                                        rotr32x8(e, 25));
+        __m256i ch   = _mm256_xor_si256(_mm256_and_si256(e, f),
+                                        _mm256_andnot_si256(e, g));
+        __m256i t1   = _mm256_add_epi32(
+                           _mm256_add_epi32(h, sum1),
+                           _mm256_add_epi32(ch, _mm256_add_epi32(w[t & 15],
+                               _mm256_set1_epi32((int)K256[t]))));
+
+        __m256i sum0 = _mm256_xor_si256(_mm256_xor_si256(rotr32x8(a, 2),
+                                                         rotr32x8(a, 13)),
+                                        rotr32x8(a, 22));
+        __m256i maj  = _mm256_or_si256(_mm256_and_si256(a, b),
+                           _mm256_and_si256(c, _mm256_or_si256(a, b)));
+
+        h = g;  g = f;  f = e;  e = _mm256_add_epi32(d, t1);
+        d = c;  c = b;  b = a;  a = _mm256_add_epi32(t1,
+                                      _mm256_add_epi32(sum0, maj));
+    }
+
+    s[0] = _mm256_add_epi32(s[0], a);  s[1] = _mm256_add_epi32(s[1], b);
+    s[2] = _mm256_add_epi32(s[2], c);  s[3] = _mm256_add_epi32(s[3], d);
+    s[4] = _mm256_add_epi32(s[4], e);  s[5] = _mm256_add_epi32(s[5], f);
+    s[6] = _mm256_add_epi32(s[6], g);  s[7] = _mm256_add_epi32(s[7], h);
+
+    // The transposition is its own inverse.
+    transpose8x8(s);
+
+    for (uint32_t j = 0; j < 8; ++j)
+        _mm256_storeu_si256((__m256i *)states[j], s[j]);
+}
+
+#endif  // GASH_X86_SIMD
+
+/** Choose the fastest kernel that the host supports.  */
+static Sha256Kernel selectSha256Kernel (void)
+{
+#ifdef GASH_X86_SIMD
+    if (CPUFeatures::has(CPUFeatures::SHA))
+        return sha256CompressSHA;
+
+    if (CPUFeatures::has(CPUFeatures::AVX2))
+        return sha256CompressAVX2;
+
+    if (CPUFeatures::has(CPUFeatures::SSSE3))
+        return sha256CompressSSSE3;
+#endif
+
+    return sha256CompressPortable;
+}
+
 /******************************************************
 **            Constructors / Destructors             **
 ******************************************************/
 
 /** Default constructor.  */
 SHA256::SHA256 ()
-    : MessageHash(256)
-{}
+    : BlockHash(256, 64, 8),
+      _iv(IV256)
+{
+    _initializeHash();
+}
 
 /** Copy constructor.
  *
@@ -98,8 +640,12 @@ SHA256::SHA256 ()
  *  @param copyFrom The SHA256 object whose values are to be copied.
 */
 SHA256::SHA256 (const SHA256 &copyFrom)
-    : MessageHash(copyFrom)
-{}
+    : BlockHash(copyFrom),
+      _iv(copyFrom._iv)
+{
+    for (uint32_t i = 0; i < 8; ++i)
+        _state[i] = copyFrom._state[i];
+}
 
 /** Initialize an SHA256 object by hashing an input std::string.
  *
@@ -109,7 +655,8 @@ SHA256::SHA256 (const SHA256 &copyFrom)
  *  @param str The std::string that is to be hashed.
 */
 SHA256::SHA256 (const string &str)
-    : MessageHash(256)
+    : BlockHash(256, 64, 8),
+      _iv(IV256)
 {
     calculateHash(str);
 }
@@ -122,7 +669,8 @@ SHA256::SHA256 (const string &str)
  *  @param data The data that is to be hashed.
 */
 SHA256::SHA256 (const vector < byte_t > &data)
-    : MessageHash(256)
+    : BlockHash(256, 64, 8),
+      _iv(IV256)
 {
     calculateHash(data);
 }
@@ -135,313 +683,252 @@ SHA256::SHA256 (const vector < byte_t > &data)
  *  @param file A handle to the file that is to be hashed.
 */
 SHA256::SHA256 (ifstream &file)
-    : MessageHash(256)
+    : BlockHash(256, 64, 8),
+      _iv(IV256)
 {
     calculateHash(file);
 }
 
+/** Initialize a truncated member of the SHA-256 family.
+ *
+ *  @pre none.
+ *  @post The object is ready to accept message data.
+ *  @param bits The number of bits in the (truncated) hash.
+ *  @param iv The eight initial chaining values of the variant.
+*/
+SHA256::SHA256 (uint32_t bits, const uint32_t iv[8])
+    : BlockHash(bits, 64, 8),
+      _iv(iv)
+{
+    _initializeHash();
+}
+
 /** Default destructor.  */
 SHA256::~SHA256 ()  { }
 
+/** Default constructor.  */
+SHA224::SHA224 ()
+    : SHA256(224, IV224)
+{}
+
+/** Initialize an SHA224 object by hashing an input std::string.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated containing the
+ *        hashed value of the input data.
+ *  @param str The std::string that is to be hashed.
+*/
+SHA224::SHA224 (const string &str)
+    : SHA256(224, IV224)
+{
+    calculateHash(str);
+}
+
+/** Initialize an SHA224 object by hashing an input data stream.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated containing the
+ *        hashed value of the input data.
+ *  @param data The data that is to be hashed.
+*/
+SHA224::SHA224 (const vector < byte_t > &data)
+    : SHA256(224, IV224)
+{
+    calculateHash(data);
+}
+
+/** Initialize an SHA224 object by hashing an input file stream.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated containing the
+ *        hashed value of the input data.
+ *  @param file A handle to the file that is to be hashed.
+*/
+SHA224::SHA224 (ifstream &file)
+    : SHA256(224, IV224)
+{
+    calculateHash(file);
+}
+
 /******************************************************
 **               Accessors / Mutators                **
 ******************************************************/
 
 ////////////////////
-//    Setters
+//    Getters
 ////////////////////
 
-/** Calculate the hash from an input std::string.
+/** Retrieve the name of the algorithm.
  *
  *  @pre The object is instantiated.
- *  @post The computed hash is stored in the _hash values.
- *  @param str The string whose value is to be hashed.
- *  @return The hash as a std::string.
+ *  @post none.
+ *  @return "SHA-256".
 */
-string SHA256::calculateHash (const string &str)
+string SHA256::algorithmName (void) const
 {
-    return calculateHash(vector < byte_t >(str.begin(), str.end()));
+    return "SHA-256";
 }
 
-/** Calculate the SHA256 hash from an input data stream.
+/** Retrieve the name of the kernel that the host selected.
  *
  *  @pre The object is instantiated.
- *  @post The SHA256 sum is stored in the _hash values.
- *  @param data The data that is to be hashed.
- *  @return The SHA256 hash as a std::string.
+ *  @post none.
+ *  @return "SHA-NI", "AVX2", "SSSE3" or "portable".
 */
-string SHA256::calculateHash (const vector < byte_t > &data)
+string SHA256::kernelName (void) const
 {
-    _initialize(256);
+#ifdef GASH_X86_SIMD
+    Sha256Kernel kernel = selectSha256Kernel();
 
-    vector < byte_t > message = _padVector(data);
+    if (kernel == sha256CompressSHA)
+        return "SHA-NI";
 
-    // The message must be processed in 512-bit (64-byte) chunks
-    uint32_t chunks = message.size() / 64;
+    if (kernel == sha256CompressAVX2)
+        return "AVX2";
 
-    // We need to initialize the hash to the chaining variables.
-    _initializeHash();
+    if (kernel == sha256CompressSSSE3)
+        return "SSSE3";
+#endif
+
+    return "portable";
+}
+
+/** Copy the object, including any partially processed message.
+ *
+ *  @pre none.
+ *  @post The caller owns (and must delete) the copy.
+ *  @return A new SHA256 object in the same state.
+*/
+SHA256 * SHA256::clone (void) const
+{
+    return new SHA256(*this);
+}
+
+/** Retrieve the name of the algorithm.
+ *
+ *  @pre The object is instantiated.
+ *  @post none.
+ *  @return "SHA-224".
+*/
+string SHA224::algorithmName (void) const
+{
+    return "SHA-224";
+}
 
-    // A message schedule of 64 32-bit words (this is the
-    // message block + the schedule).
-    vector < uint32_t > schedule;
-
-    uint32_t offset,  // A calculated offset into the data.
-           append,    // A concatenation of 4 bytes into 1 32-bit word.
-           a,         // The chaining variable associated with _hash[0].
-           b,         // The chaining variable associated with _hash[1].
-           c,         // The chaining variable associated with _hash[2].
-           d,         // The chaining variable associated with _hash[3].
-           e,         // The chaining variable associated with _hash[4].
-           f,         // The chaining variable associated with _hash[5].
-           g,         // The chaining variable associated with _hash[6].
-           h,         // The chaining variable associated with _hash[7].
-           t1,        // A temporary word to hold the part of the avalanche.
-           t2;        // A temporary word to hold the part of the avalanche.
-
-    // We need to process N message blocks (chunks).
-    for (uint32_t i = 0; i < chunks; ++i)
+/** Copy the object, including any partially processed message.
+ *
+ *  @pre none.
+ *  @post The caller owns (and must delete) the copy.
+ *  @return A new SHA224 object in the same state.
+*/
+SHA224 * SHA224::clone (void) const
+{
+    return new SHA224(*this);
+}
+
+/******************************************************
+**                     Operators                     **
+******************************************************/
+
+/** Assignment from another SHA256 object.
+ *
+ *  @pre The object is instantiated.
+ *  @post The object contains the values copied from rhs.
+ *  @param rhs The SHA256 object whose values are to be copied/stored.
+ *  @return A reference to the object.
+*/
+SHA256 & SHA256::operator = (const SHA256 &rhs)
+{
+    if (this != &rhs)
     {
-        // Initialize the eight 32-bit chaining variables.
-        a = _hash.at(0);
-        b = _hash.at(1);
-        c = _hash.at(2);
-        d = _hash.at(3);
-        e = _hash.at(4);
-        f = _hash.at(5);
-        g = _hash.at(6);
-        h = _hash.at(7);
-
-        // Reset the 64 32-bit block to all zeros.
-        schedule.assign(64, 0x00000000);
-
-        // According to FIP 180-2, we first need to prepare the
-        // message schedule where the first 16 words are the
-        // 512-bit message block.
-        for (uint32_t j = 0; j < 16; ++j)
-        {
-            // The current offset into the message data.
-            offset = (i * 64) + (j * 4);
+        BlockHash::operator = (rhs);
 
-            // The words are appended in little-endian format, i.e.
-            // if the hardware is big-endian, we have to convert the
-            // bytes to little-endian.
-            if (_littleEndian)
-            {
-                append =   ((uint32_t)message.at(offset    ) << 24)
-                         | ((uint32_t)message.at(offset + 1) << 16)
-                         | ((uint32_t)message.at(offset + 2) <<  8)
-                         | ((uint32_t)message.at(offset + 3)      );
-            }
-            else
-            {
-                append =   ((uint32_t)message.at(offset    )      )
-                         | ((uint32_t)message.at(offset + 1) <<  8)
-                         | ((uint32_t)message.at(offset + 2) << 16)
-                         | ((uint32_t)message.at(offset + 3) << 24);
-            }
+        _iv = rhs._iv;
+        for (uint32_t i = 0; i < 8; ++i)
+            _state[i] = rhs._state[i];
+    }
 
-            schedule.at(j) = append;
+    return *this;
+}
 
-        }  // End for-loop j [ 0, 15].
+/******************************************************
+**                  Static Methods                   **
+******************************************************/
 
-        // The remaining 48 words in the message schedule are computed
-        // from the logical functions using the previous words in the
-        // schedule for avalanching the later indices in the schedule.
-        for (uint32_t j = 16; j < 64; ++j)
-        {
-            schedule.at(j) =   _sig1(schedule.at(j -  2))
-                                   + schedule.at(j -  7)
-                             + _sig0(schedule.at(j - 15))
-                                   + schedule.at(j - 16);
+/** Load the SHA-256 initial chaining values.
+ *
+ *  @pre none.
+ *  @post state holds the SHA-256 (not SHA-224) initial values.
+ *  @param state The eight chaining variables that are to be set.
+ *  @return none.
+*/
+void SHA256::initialState (uint32_t state[8])
+{
+    for (uint32_t i = 0; i < 8; ++i)
+        state[i] = IV256[i];
 
-        }  // End for-loop j [16, 63].
+    return;
+}
 
-        // The actual avalance effect is performed in this loop.
-        for (uint32_t j = 0; j < 64; ++j)
-        {
-            t1 = h + _Sigma1(e) + _Ch(e, f, g) + _K[j] + schedule.at(j);
-            t2 = _Sigma0(a) + _Maj(a, b, c);
-            h = g;
-            g = f;
-            f = e;
-            e = d + t1;
-            d = c;
-            c = b;
-            b = a;
-            a = t1 + t2;
-        }  // End for-loop j.
-
-        // The i-th intermediate hash value.
-        _hash.at(0) += a;
-        _hash.at(1) += b;
-        _hash.at(2) += c;
-        _hash.at(3) += d;
-        _hash.at(4) += e;
-        _hash.at(5) += f;
-        _hash.at(6) += g;
-        _hash.at(7) += h;
-
-    } // End for-loop i.
-
-    return asString();
-}
-
-/** Calculate the SHA256 hash of a file.
-*
-*  @pre The object is instantiated.
-*  @post The SHA256 sum is stored in the _hash values.
-*  @param file The file whose SHA256 is to be calculated.
-*  @return The SHA256 hash as a std::string.
+/** Compress one 512-bit block into each of several independent
+ *  chaining states.
+ *
+ *  @pre Each state holds valid chaining variables.
+ *  @post states[i] is advanced by the 64 bytes at blocks[i].
+ *  @param states The chaining variables of each message.
+ *  @param blocks A pointer to the next block of each message.
+ *  @param lanes The number of messages.
+ *  @return none.
 */
-string SHA256::calculateHash (ifstream &file)
-{
-    _initialize(256);
-
-    // Check that the file is valid before doing anything else.
-    // This will return an MD5 value of all zeros.
-    if (file.fail() || !file.good())
-        return asString();
-
-    uint64_t filesize,    // The size of the file in bytes.
-             paddedSize,  // The size of the data after padding.
-             filebits;    // The filesize in bits.
-
-    // We need to get the size of the file.
-    file.seekg(0, ios::end);
-    filesize = (uint64_t)file.tellg();
-    filebits = filesize * 8;
-    file.seekg(0);  // Return to the head of the file.
-
-    // We need to append 9 bytes to the data and fill the extra padding
-    // with zeros to get a 512-bit boundary.
-    paddedSize = filesize + 9;
-    while ((paddedSize % 64) != 0) ++paddedSize;
-
-    // The message must be processed in 512-bit (64-byte) chunks
-    uint64_t chunks = paddedSize >> 6;  // Divide by 64.
-
-    // A message schedule of 64 32-bit words (this is the
-    // message block + the schedule).
-    vector < uint32_t > schedule;
-
-    uint32_t append,    // A concatenation of 4 bytes into 1 32-bit word.
-             a,         // The chaining variable associated with _hash[0].
-             b,         // The chaining variable associated with _hash[1].
-             c,         // The chaining variable associated with _hash[2].
-             d,         // The chaining variable associated with _hash[3].
-             e,         // The chaining variable associated with _hash[4].
-             f,         // The chaining variable associated with _hash[5].
-             g,         // The chaining variable associated with _hash[6].
-             h,         // The chaining variable associated with _hash[7].
-             t1,        // A temporary word to hold the part of the avalanche.
-             t2,        // A temporary word to hold the part of the avalanche.
-             blockData; // The number of message bytes in each block.
-
-    bool endOfStream = false;
-
-    // We need to initialize the hash to the chaining variables.
-    _initializeHash();
+void SHA256::compressLanes (uint32_t states[][8],
+                            const byte_t *const blocks[], uint32_t lanes)
+{
+    static const Sha256Kernel kernel = selectSha256Kernel();
+
+    uint32_t i = 0;
+
+#ifdef GASH_X86_SIMD
+    // The SHA extensions retire a block faster than the eight lane kernel
+    // retires eight, so the lanes are only used without them.
+    static const bool useLanes = !CPUFeatures::has(CPUFeatures::SHA) &&
+                                  CPUFeatures::has(CPUFeatures::AVX2);
 
-    // We need to process N message blocks (chunks).
-    for (uint64_t i = 0; i < chunks; ++i)
+    if (useLanes)
     {
-        // Initialize the eight 32-bit chaining variables.
-        a = _hash.at(0);
-        b = _hash.at(1);
-        c = _hash.at(2);
-        d = _hash.at(3);
-        e = _hash.at(4);
-        f = _hash.at(5);
-        g = _hash.at(6);
-        h = _hash.at(7);
-
-        // Reset the 64 32-bit block to all zeros.
-        schedule.assign(64, 0x00000000);
-        blockData = 0;
-
-        // According to FIP 180-2, we first need to prepare the
-        // message schedule where the first 16 words are the
-        // 512-bit message block.
-        for (uint32_t j = 0; j < 16; ++j)
+        for (; (i + 8) <= lanes; i += 8)
+            sha256LanesAVX2(states + i, blocks + i);
+
+        // A partial group is padded with copies of its first lane, whose
+        // duplicate results are discarded.
+        if ((lanes - i) > 1)
         {
-            // Initialize the data to be appended.
-            append = 0x00000000;
+            uint32_t spare[8][8];
+            const byte_t *group[8];
 
-            // The words are appended in little-endian format, i.e.
-            // if the hardware is big-endian, we have to convert the
-            // bytes to little-endian.
-            for (uint32_t m = 0; (m < 4) && !endOfStream; ++m)
+            for (uint32_t j = 0; j < 8; ++j)
             {
-                // Check for EOF.
-                if (file.peek() == -1)
-                    endOfStream = true;
-
-                else
-                {
-                    if (_littleEndian)
-                        append |= ((uint32_t)file.get() << (24 - (m * 8)));
-                    else
-                        append |= ((uint32_t)file.get() <<       (m * 8) );
-
-                    // Increment the number of message bytes.
-                    ++blockData;
-                }
-            }
+                uint32_t from = ((i + j) < lanes) ? (i + j) : i;
 
-            schedule.at(j) = append;
+                for (uint32_t k = 0; k < 8; ++k)
+                    spare[j][k] = states[from][k];
 
-        }  // End for-loop j [ 0, 15].
+                group[j] = blocks[from];
+            }
 
-        if (endOfStream)
-            _padLastBlock(schedule, blockData, filebits);
+            sha256LanesAVX2(spare, group);
 
-        // The remaining 48 words in the message schedule are computed
-        // from the logical functions using the previous words in the
-        // schedule for avalanching the later indices in the schedule.
-        for (uint32_t j = 16; j < 64; ++j)
-        {
-            schedule.at(j) =   _sig1(schedule.at(j -  2))
-                                   + schedule.at(j -  7)
-                             + _sig0(schedule.at(j - 15))
-                                   + schedule.at(j - 16);
+            for (; i < lanes; ++i)
+                for (uint32_t k = 0; k < 8; ++k)
+                    states[i][k] = spare[i & 7][k];
+        }
+    }
+#endif
 
-        }  // End for-loop j [16, 63].
+    for (; i < lanes; ++i)
+        kernel(states[i], blocks[i], 1);
 
-        // The actual avalance effect is performed in this loop.
-        for (uint32_t j = 0; j < 64; ++j)
-        {
-            t1 = h + _Sigma1(e) + _Ch(e, f, g) + _K[j] + schedule.at(j);
-            t2 = _Sigma0(a) + _Maj(a, b, c);
-            h = g;
-            g = f;
-            f = e;
-            e = d + t1;
-            d = c;
-            c = b;
-            b = a;
-            a = t1 + t2;
-        }  // End for-loop j.
-
-        // The i-th intermediate hash value.
-        _hash.at(0) += a;
-        _hash.at(1) += b;
-        _hash.at(2) += c;
-        _hash.at(3) += d;
-        _hash.at(4) += e;
-        _hash.at(5) += f;
-        _hash.at(6) += g;
-        _hash.at(7) += h;
-
-    } // End for-loop i.
-
-    // Reset the file flags and return to the file head.
-    file.clear();
-    file.seekg(0);  // Return to the head of the file.
-
-    return asString();
-
-}    // End method sha256compute (ifstream &file).
+    return;
+}
 
 /******************************************************
 **                   Helper Methods                  **
@@ -450,165 +937,73 @@ string SHA256::calculateHash (ifstream &file)
 /** Initialize the SHA256 hash.
  *
  *  @pre The object is instantiated.
- *  @post The values in _hash are initialized to the
+ *  @post The values in _state are initialized to the
  *        chaining variable values.
  *  @return none.
 */
 void SHA256::_initializeHash (void)
 {
-    _hash.at(0) = 0x6a09e667;
-    _hash.at(1) = 0xbb67ae85;
-    _hash.at(2) = 0x3c6ef372;
-    _hash.at(3) = 0xa54ff53a;
-    _hash.at(4) = 0x510e527f;
-    _hash.at(5) = 0x9b05688c;
-    _hash.at(6) = 0x1f83d9ab;
-    _hash.at(7) = 0x5be0cd19;
+    for (uint32_t i = 0; i < 8; ++i)
+        _state[i] = _iv[i];
 
     return;
 }
 
-/** Pad the message contents to meet FIPS 180-2.
+/** Compress whole 512-bit message blocks.
  *
- *  @pre The object is instantiated.
- *  @post none.
- *  @param data The data that is to be hashed.
- *  @return A vector containing the padded data.
+ *  @pre The chaining variables have been initialized.
+ *  @post The chaining variables are updated.
+ *  @param blocks A pointer to the first block.
+ *  @param count The number of consecutive blocks at blocks.
+ *  @return none.
 */
-vector < byte_t > SHA256::_padVector (const vector < byte_t > &data) const
+void SHA256::_compress (const byte_t *blocks, uint64_t count)
 {
-    vector < byte_t > message = data;
-
-    uint32_t size = data.size();  // The size of the original data.
-
-    // We need to append 9 bytes to the data and fill the extra padding
-    // with zeros to get a 512-bit boundary.
-    uint32_t datasize = data.size() + 9;
-    while ((datasize % 64) != 0) ++datasize;
-
-    // The first padded bit is a '1' followed by zeros until we reach the
-    // the final 64-bits of the message.
-    message.push_back(0x80);
-    for (uint32_t i = (size + 1); i < datasize; ++i)
-        message.push_back(0x00);
+    static const Sha256Kernel kernel = selectSha256Kernel();
 
-    // The final 64-bits (8-bytes) is the 64-bit representation of the
-    // message size in bits presented as a little endian value.  For
-    // simplicity, I'll only use a 32-bit value (assume the MSBs are 0x00).
-    uint32_t dataBits = size * 8;
-    // message.at(datasize - 8) = 0x00;
-    // message.at(datasize - 7) = 0x00;
-    // message.at(datasize - 6) = 0x00;
-    // message.at(datasize - 5) = 0x00;
-    message.at(datasize - 4) = (byte_t)((dataBits & 0xff000000) >> 24);
-    message.at(datasize - 3) = (byte_t)((dataBits & 0x00ff0000) >> 16);
-    message.at(datasize - 2) = (byte_t)((dataBits & 0x0000ff00) >>  8);
-    message.at(datasize - 1) = (byte_t)((dataBits & 0x000000ff)      );
+    kernel(_state, blocks, count);
 
-    return message;
+    return;
 }
 
-/** Pad the message contents to meet FIPS 180-2.
+/** Copy the leading chaining variables into the _hash words.
  *
- *  @pre The object is instantiated.
- *  @post none.
- *  @param lastBlock The last block of data from the file (the block
- *         that is to be padded).
- *  @param dataInBlock The number of bytes of message data in the block.
- *  @param bitsInFile The size of the message in bits.
+ *  @pre The final block has been compressed.
+ *  @post The _hash values hold the (truncated) message digest.
  *  @return none.
 */
-void SHA256::_padLastBlock (vector < uint32_t > &lastBlock, uint32_t dataInBlock,
-                            uint64_t bitsInFile) const
+void SHA256::_storeHash (void)
 {
-    // If there is no more data, we need to pad the block.
-    // The first padded bit is a '1' followed by zeros until we reach the
-    // the final 64-bits of the message.
-    uint32_t shift = (dataInBlock % 4);
-
-    uint32_t paddingWord = (dataInBlock / 4) % 16;
-
-    uint32_t append = lastBlock.at(paddingWord);
-
-    if (_littleEndian)
-        append |= (0x00000080 << (24 - (shift * 8)));
-    else
-        append |= (0x00000080 <<       (shift * 8) );
-
-    lastBlock.at(paddingWord) = append;
-
-    for (uint32_t i = (paddingWord + 1); i < 16; ++i)
-        lastBlock.at(i) = 0x00000000;
-
-    // The final 64-bits (8-bytes) is the 64-bit representation of the
-    // message size in bits presented as a big endian value.
-
-    lastBlock.at(14) = (uint32_t)((bitsInFile >> 16) >> 16);  // 64-bit MSBs.
-    lastBlock.at(15) = (uint32_t)(bitsInFile & 0x00000000ffffffff);
+    for (uint32_t i = 0; i < _hash.size(); ++i)
+        _hash.at(i) = _state[i];
 
     return;
 }
 
-/** The first of 6 logical functions used by SHA-256.
- *
- *  @pre none.
- *  @post none.
- *  @param x The first 32-bit word in the function.
- *  @param y The second 32-bit word in the function.
- *  @param z The final 32-bit word in the function.
- *  @return A 32-bit word that is the result of the logical function.
-*/
-inline uint32_t SHA256::_Ch (uint32_t x, uint32_t y, uint32_t z) const
-{  return ((x & y) ^ (~x & z));  }
-
-/** The second of 6 logical functions used by SHA-256.
+/** Append the chaining variables to an exported state.
  *
  *  @pre none.
- *  @post none.
- *  @param x The first 32-bit word in the function.
- *  @param y The second 32-bit word in the function.
- *  @param z The final 32-bit word in the function.
- *  @return A 32-bit word that is the result of the logical function.
-*/
-inline uint32_t SHA256::_Maj (uint32_t x, uint32_t y, uint32_t z) const
-{  return ((x & y) ^ (x & z) ^ (y & z));  }
-
-/** The third of 6 logical functions used by SHA-256.
- *
- *  @pre none.
- *  @post none.
- *  @param x The value that is to be used in the shifts.
- *  @return A 32-bit word that is the result of the logical function.
+ *  @post The chaining variables are appended to state.
+ *  @param state The state that is being exported.
+ *  @return none.
 */
-inline uint32_t SHA256::_Sigma0 (uint32_t x) const
-{  return (_rcshift(x, 2) ^ _rcshift(x, 13) ^ _rcshift(x, 22));  }
+void SHA256::_saveChaining (HashState &state) const
+{
+    state.putWords32(_state, 8);
 
-/** The fourth of 6 logical functions used by SHA-256.
- *
- *  @pre none.
- *  @post none.
- *  @param x The value that is to be used in the shifts.
- *  @return A 32-bit word that is the result of the logical function.
-*/
-inline uint32_t SHA256::_Sigma1 (uint32_t x) const
-{  return (_rcshift(x, 6) ^ _rcshift(x, 11) ^ _rcshift(x, 25));  }
+    return;
+}
 
-/** The fifth of 6 logical functions used by SHA-256.
+/** Restore the chaining variables from an imported state.
  *
- *  @pre none.
- *  @post none.
- *  @param x The value that is to be used in the shifts.
- *  @return A 32-bit word that is the result of the logical function.
+ *  @pre The block buffer has been read from state.
+ *  @post The chaining variables are restored.
+ *  @param state The state that is being imported.
+ *  @return none.
 */
-inline uint32_t SHA256::_sig0 (uint32_t x) const
-{  return (_rcshift(x, 7) ^ _rcshift(x, 18) ^ (x >> 3));  }
+void SHA256::_loadChaining (HashState &state)
+{
+    state.getWords32(_state, 8);
 
-/** The sixth of 6 logical functions used by SHA-256.
- *
- *  @pre none.
- *  @post none.
- *  @param x The value that is to be used in the shifts.
- *  @return A 32-bit word that is the result of the logical function.
-*/
-inline uint32_t SHA256::_sig1 (uint32_t x) const
-{  return (_rcshift(x, 17) ^ _rcshift(x, 19) ^ (x >> 10));  }
\ No newline at end of file
+    return;
+}
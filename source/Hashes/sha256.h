@@ -4,17 +4,21 @@
 ||                                                                           ||
 ||    Author: Gary Hammock, PE                                               ||
 ||    Creation Date: 2008-08-27                                              ||
-||    Last Edit Date: 2014-03-13                                             ||
+||    Last Edit Date: 2026-10-16                                             ||
 ||                                                                           ||
 ||===========================================================================||
 ||  DESCRIPTION                                                              ||
 ||===========================================================================||
-||    This abstract data type is used to calculate the SHA-256 hash of an    ||
-||    input message or data stream.                                          ||
+||    These abstract data types are used to calculate the SHA-256 and        ||
+||    SHA-224 hashes of an input message or data stream.                     ||
 ||                                                                           ||
 ||===========================================================================||
 ||  CODE DEPENDENCIES                                                        ||
 ||===========================================================================||
+||    block_hash.cpp (block_hash.lib)                                        ||
+||    block_hash.h                                                           ||
+||    cpu_features.cpp (cpu_features.lib)                                    ||
+||    cpu_features.h                                                         ||
 ||    hash_abstract.cpp (hash_abstract.lib)                                  ||
 ||    hash_abstract.h                                                        ||
 ||                                                                           ||
@@ -27,6 +31,9 @@
 ||    FIPS 180-2, "Secure Hash Standard".  01 Aug 2002.  National Institute  ||
 ||        of Standards and Technology.                                       ||
 ||                                                                           ||
+||    Gulley, S. et al.  "Intel SHA Extensions".  Intel Corporation.  Jul    ||
+||        2013.                                                              ||
+||                                                                           ||
 ||===========================================================================||
 ||  LICENSE    (MIT/X11 License)                                             ||
 ||===========================================================================||
@@ -55,19 +62,19 @@
 
 /** @file sha256.h
  *  @author Gary Hammock, PE
- *  @date 2014-03-13
+ *  @date 2026-10-16
 */
 
 #ifndef _GH_SHA_256_DEF_H
 #define _GH_SHA_256_DEF_H
 
-#include "hash_abstract.h"
+#include "block_hash.h"
 
 /**
  *  @class SHA256 An abstract data type to calculate and
  *         manipulate SHA-256 hashes.
 */
-class SHA256 : public MessageHash
+class SHA256 : public BlockHash
 {
   public:
     /******************************************************
@@ -120,44 +127,90 @@ class SHA256 : public MessageHash
     ******************************************************/
 
     ////////////////////
-    //    Setters
+    //    Getters
     ////////////////////
 
-    /** Calculate the hash from an input std::string.
+    /** Retrieve the name of the algorithm.
      *
      *  @pre The object is instantiated.
-     *  @post The computed hash is stored in the _hash values.
-     *  @param str The string whose value is to be hashed.
-     *  @return The hash as a std::string.
+     *  @post none.
+     *  @return "SHA-256".
     */
-    string calculateHash (const string &str);
+    string algorithmName (void) const;
 
-    /** Calculate the SHA256 hash from an input data stream.
+    /** Retrieve the name of the kernel that the host selected.
      *
      *  @pre The object is instantiated.
-     *  @post The SHA256 sum is stored in the _hash values.
-     *  @param data The data that is to be hashed.
-     *  @return The SHA256 hash as a std::string.
+     *  @post none.
+     *  @return "SHA-NI", "AVX2", "SSSE3" or "portable".
+    */
+    string kernelName (void) const;
+
+    /** Copy the object, including any partially processed message.
+     *
+     *  @pre none.
+     *  @post The caller owns (and must delete) the copy.
+     *  @return A new SHA256 object in the same state.
     */
-    string calculateHash (const vector < byte_t > &data);
+    SHA256 * clone (void) const;
 
-    /** Calculate the SHA256 hash of a file.
+    /******************************************************
+    **                     Operators                     **
+    ******************************************************/
+
+    /** Assignment from another SHA256 object.
      *
      *  @pre The object is instantiated.
-     *  @post The SHA256 sum is stored in the _hash values.
-     *  @param file The file whose SHA256 is to be calculated.
-     *  @return The SHA256 hash as a std::string.
+     *  @post The object contains the values copied from rhs.
+     *  @param rhs The SHA256 object whose values are to be copied/stored.
+     *  @return A reference to the object.
+    */
+    SHA256 & operator = (const SHA256 &rhs);
+
+    /******************************************************
+    **                  Static Methods                   **
+    ******************************************************/
+
+    /** Load the SHA-256 initial chaining values.
+     *
+     *  @pre none.
+     *  @post state holds the SHA-256 (not SHA-224) initial values.
+     *  @param state The eight chaining variables that are to be set.
+     *  @return none.
+    */
+    static void initialState (uint32_t state[8]);
+
+    /** Compress one 512-bit block into each of several independent
+     *  chaining states.  Drivers that iterate the compression function
+     *  over many short messages (HMAC based key derivation) use this so
+     *  that the messages can share the vector lanes of a multi-buffer
+     *  kernel when that is faster than hashing them one at a time.
+     *
+     *  @pre Each state holds valid chaining variables.
+     *  @post states[i] is advanced by the 64 bytes at blocks[i].
+     *  @param states The chaining variables of each message.
+     *  @param blocks A pointer to the next block of each message.
+     *  @param lanes The number of messages.
+     *  @return none.
     */
-    string calculateHash (ifstream &file);
+    static void compressLanes (uint32_t states[][8],
+                               const byte_t *const blocks[], uint32_t lanes);
 
-  private:
+  protected:
     /******************************************************
     **                      Members                      **
     ******************************************************/
-    static const uint32_t _K[64];  // SHA-256 constants.  These represent the
-                                   // first 32 bits of the fractional parts of
-                                   // the cube roots of the first 64 prime
-                                   // numbers.
+    uint32_t _state[8];   // The eight 32-bit chaining variables.
+    const uint32_t *_iv;  // The initial chaining values of this variant.
+
+    /** Initialize a truncated member of the SHA-256 family.
+     *
+     *  @pre none.
+     *  @post The object is ready to accept message data.
+     *  @param bits The number of bits in the (truncated) hash.
+     *  @param iv The eight initial chaining values of the variant.
+    */
+    SHA256 (uint32_t bits, const uint32_t iv[8]);
 
     /******************************************************
     **                   Helper Methods                  **
@@ -166,92 +219,103 @@ class SHA256 : public MessageHash
     /** Initialize the SHA256 hash.
      *
      *  @pre The object is instantiated.
-     *  @post The values in _hash are initialized to the
+     *  @post The values in _state are initialized to the
      *        chaining variable values.
      *  @return none.
     */
     void _initializeHash (void);
 
-    /** Pad the message contents to meet FIPS 180-2.
+    /** Compress whole 512-bit message blocks.
      *
-     *  @pre The object is instantiated.
-     *  @post none.
-     *  @param data The data that is to be hashed.
-     *  @return A vector containing the padded data.
+     *  @pre The chaining variables have been initialized.
+     *  @post The chaining variables are updated.
+     *  @param blocks A pointer to the first block.
+     *  @param count The number of consecutive blocks at blocks.
+     *  @return none.
     */
-    vector < byte_t > _padVector (const vector < byte_t > &data) const;
+    void _compress (const byte_t *blocks, uint64_t count);
 
-    /** Pad the message contents to meet FIPS 180-2.
+    /** Copy the leading chaining variables into the _hash words.
      *
-     *  @pre The object is instantiated.
-     *  @post none.
-     *  @param lastBlock The last block of data from the file (the block
-     *         that is to be padded).
-     *  @param dataInBlock The number of bytes of message data in the block.
-     *  @param bitsInFile The size of the message in bits.
+     *  @pre The final block has been compressed.
+     *  @post The _hash values hold the (truncated) message digest.
      *  @return none.
     */
-    void _padLastBlock (vector < uint32_t > &lastBlock, uint32_t dataInBlock,
-                        uint64_t bitsInFile) const;
+    void _storeHash (void);
 
-    /** The first of 6 logical functions used by SHA-256.
+    /** Append the chaining variables to an exported state.
      *
      *  @pre none.
-     *  @post none.
-     *  @param x The first 32-bit word in the function.
-     *  @param y The second 32-bit word in the function.
-     *  @param z The final 32-bit word in the function.
-     *  @return A 32-bit word that is the result of the logical function.
+     *  @post The chaining variables are appended to state.
+     *  @param state The state that is being exported.
+     *  @return none.
     */
-    inline uint32_t _Ch (uint32_t x, uint32_t y, uint32_t z) const;
+    void _saveChaining (HashState &state) const;
 
-    /** The second of 6 logical functions used by SHA-256.
+    /** Restore the chaining variables from an imported state.
      *
-     *  @pre none.
-     *  @post none.
-     *  @param x The first 32-bit word in the function.
-     *  @param y The second 32-bit word in the function.
-     *  @param z The final 32-bit word in the function.
-     *  @return A 32-bit word that is the result of the logical function.
+     *  @pre The block buffer has been read from state.
+     *  @post The chaining variables are restored.
+     *  @param state The state that is being imported.
+     *  @return none.
     */
-    inline uint32_t _Maj (uint32_t x, uint32_t y, uint32_t z) const;
+    void _loadChaining (HashState &state);
+
+};  // End class SHA256.
 
-    /** The third of 6 logical functions used by SHA-256.
+/**
+ *  @class SHA224 An abstract data type to calculate and
+ *         manipulate SHA-224 hashes.
+*/
+class SHA224 : public SHA256
+{
+  public:
+    /** Default constructor.  */
+    SHA224 ();
+
+    /** Initialize an SHA224 object by hashing an input std::string.
      *
      *  @pre none.
-     *  @post none.
-     *  @param x The value that is to be used in the shifts.
-     *  @return A 32-bit word that is the result of the logical function.
+     *  @post A new object is instantiated containing the
+     *        hashed value of the input data.
+     *  @param str The std::string that is to be hashed.
     */
-    inline uint32_t _Sigma0 (uint32_t x) const;
+    SHA224 (const string &str);
 
-    /** The fourth of 6 logical functions used by SHA-256.
+    /** Initialize an SHA224 object by hashing an input data stream.
      *
      *  @pre none.
-     *  @post none.
-     *  @param x The value that is to be used in the shifts.
-     *  @return A 32-bit word that is the result of the logical function.
+     *  @post A new object is instantiated containing the
+     *        hashed value of the input data.
+     *  @param data The data that is to be hashed.
     */
-    inline uint32_t _Sigma1 (uint32_t x) const;
+    SHA224 (const vector < byte_t > &data);
 
-    /** The fifth of 6 logical functions used by SHA-256.
+    /** Initialize an SHA224 object by hashing an input file stream.
      *
      *  @pre none.
+     *  @post A new object is instantiated containing the
+     *        hashed value of the input data.
+     *  @param file A handle to the file that is to be hashed.
+    */
+    SHA224 (ifstream &file);
+
+    /** Retrieve the name of the algorithm.
+     *
+     *  @pre The object is instantiated.
      *  @post none.
-     *  @param x The value that is to be used in the shifts.
-     *  @return A 32-bit word that is the result of the logical function.
+     *  @return "SHA-224".
     */
-    inline uint32_t _sig0 (uint32_t x) const;
+    string algorithmName (void) const;
 
-    /** The sixth of 6 logical functions used by SHA-256.
+    /** Copy the object, including any partially processed message.
      *
      *  @pre none.
-     *  @post none.
-     *  @param x The value that is to be used in the shifts.
-     *  @return A 32-bit word that is the result of the logical function.
+     *  @post The caller owns (and must delete) the copy.
+     *  @return A new SHA224 object in the same state.
     */
-    inline uint32_t _sig1 (uint32_t x) const;
+    SHA224 * clone (void) const;
 
-};  // End class SHA256.
+};  // End class SHA224.
 
-#endif
\ No newline at end of file
+#endif
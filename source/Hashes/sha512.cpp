@@ -0,0 +1,685 @@
+/******************************************************************************
+||  sha512.cpp                                                               ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    These abstract data types are used to calculate the SHA-512, SHA-384   ||
+||    and SHA-512/256 hashes of an input message or data stream.  The three  ||
+||    algorithms share one 64-bit compression function and differ only in    ||
+||    their initial chaining values and the length of the digest.            ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    block_hash.cpp (block_hash.lib)                                        ||
+||    block_hash.h                                                           ||
+||    cpu_features.cpp (cpu_features.lib)                                    ||
+||    cpu_features.h                                                         ||
+||    hash_abstract.cpp (hash_abstract.lib)                                  ||
+||    hash_abstract.h                                                        ||
+||                                                                           ||
+||===========================================================================||
+||  REFERENCES                                                               ||
+||===========================================================================||
+||    FIPS 180-4, "Secure Hash Standard".  Aug 2015.  National Institute of  ||
+||        Standards and Technology.                                          ||
+||                                                                           ||
+||    Gueron, S. and Krasnov, V.  "Parallelizing message schedules to        ||
+||        accelerate the computations of hash functions".  Journal of        ||
+||        Cryptographic Engineering 2, 2012.                                 ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file sha512.cpp
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+#include "sha512.h"
+#include "hash_state.h"
+#include "cpu_features.h"
+
+#ifdef GASH_X86_SIMD
+  #include <immintrin.h>
+#endif
+
+// SHA-512 uses a sequence of 80 constant 64-bit words.  These words
+// represent the first 64 bits of the fractional parts of the
+// cube roots of the first 80 prime numbers.
+static const uint64_t K512[80] =
+        { 0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL, 0xb5c0fbcfec4d3b2fULL,
+          0xe9b5dba58189dbbcULL, 0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL,
+          0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL, 0xd807aa98a3030242ULL,
+          0x12835b0145706fbeULL, 0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+          0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL,
+          0xc19bf174cf692694ULL, 0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL,
+          0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL, 0x2de92c6f592b0275ULL,
+          0x4a7484aa6ea6e483ULL, 0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
+          0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL, 0xb00327c898fb213fULL,
+          0xbf597fc7beef0ee4ULL, 0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL,
+          0x06ca6351e003826fULL, 0x142929670a0e6e70ULL, 0x27b70a8546d22ffcULL,
+          0x2e1b21385c26c926ULL, 0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
+          0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL, 0x81c2c92e47edaee6ULL,
+          0x92722c851482353bULL, 0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL,
+          0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL, 0xd192e819d6ef5218ULL,
+          0xd69906245565a910ULL, 0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
+          0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL, 0x2748774cdf8eeb99ULL,
+          0x34b0bcb5e19b48a8ULL, 0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL,
+          0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL, 0x748f82ee5defb2fcULL,
+          0x78a5636f43172f60ULL, 0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+          0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL, 0xbef9a3f7b2c67915ULL,
+          0xc67178f2e372532bULL, 0xca273eceea26619cULL, 0xd186b8c721c0c207ULL,
+          0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL, 0x06f067aa72176fbaULL,
+          0x0a637dc5a2c898a6ULL, 0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
+          0x28db77f523047d84ULL, 0x32caab7b40c72493ULL, 0x3c9ebe0a15c9bebcULL,
+          0x431d67c49c100d4cULL, 0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL,
+          0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL
+        };
+
+// The initial chaining values of SHA-512 are the first 64 bits of the
+// fractional parts of the square roots of the first 8 primes.
+static const uint64_t IV512[8] =
+        { 0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL,
+          0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+          0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL,
+          0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL
+        };
+
+// SHA-384 uses the square roots of the 9th through 16th primes.
+static const uint64_t IV384[8] =
+        { 0xcbbb9d5dc1059ed8ULL, 0x629a292a367cd507ULL,
+          0x9159015a3070dd17ULL, 0x152fecd8f70e5939ULL,
+          0x67332667ffc00b31ULL, 0x8eb44a8768581511ULL,
+          0xdb0c2e0d64f98fa7ULL, 0x47b5481dbefa4fa4ULL
+        };
+
+// SHA-512/t uses chaining values generated by the SHA-512/t IV
+// generation function (FIPS 180-4, section 5.3.6) for t = 256.
+static const uint64_t IV512_256[8] =
+        { 0x22312194fc2bf72cULL, 0x9f555fa3c84c64c2ULL,
+          0x2393b86b6f53b151ULL, 0x963877195940eabdULL,
+          0x96283ee2a88effe3ULL, 0xbe5e1e2553863992ULL,
+          0x2b0199fc2c85b8aaULL, 0x0eb72ddc81c52ca2ULL
+        };
+
+/******************************************************
+**                 Compression Kernels               **
+******************************************************/
+
+// The kernels are plain functions (rather than members) so that each one
+// can be compiled for its own instruction set; _compress() picks the
+// fastest one the host supports the first time it is called.
+typedef void (*Sha512Kernel)(uint64_t state[8], const byte_t *blocks,
+                             uint64_t count);
+
+static inline uint64_t rotr64 (uint64_t x, uint32_t n)
+{  return ((x >> n) | (x << (64 - n)));  }
+
+static inline uint64_t loadBigEndian64 (const byte_t *p)
+{
+    return   ((uint64_t)p[0] << 56) | ((uint64_t)p[1] << 48)
+           | ((uint64_t)p[2] << 40) | ((uint64_t)p[3] << 32)
+           | ((uint64_t)p[4] << 24) | ((uint64_t)p[5] << 16)
+           | ((uint64_t)p[6] <<  8) | ((uint64_t)p[7]      );
+}
+
+/** One SHA-512 round.  Rather than shuffling the eight working variables
+ *  every round, the caller rotates the argument order; only d and h are
+ *  written.
+*/
+static GASH_ALWAYS_INLINE void
+sha512Round (uint64_t a, uint64_t b, uint64_t c, uint64_t &d, uint64_t e,
+             uint64_t f, uint64_t g, uint64_t &h, uint64_t wk)
+{
+    uint64_t t1 = h + (rotr64(e, 14) ^ rotr64(e, 18) ^ rotr64(e, 41))
+                    + ((e & f) ^ (~e & g)) + wk;
+    uint64_t t2 = (rotr64(a, 28) ^ rotr64(a, 34) ^ rotr64(a, 39))
+                    + ((a & b) ^ (a & c) ^ (b & c));
+    d += t1;
+    h = t1 + t2;
+}
+
+/** Run the 80 rounds over a schedule that already includes the K words.  */
+static GASH_ALWAYS_INLINE void
+sha512Rounds (uint64_t state[8], const uint64_t wk[80])
+{
+    uint64_t a = state[0], b = state[1], c = state[2], d = state[3],
+             e = state[4], f = state[5], g = state[6], h = state[7];
+
+    for (uint32_t j = 0; j < 80; j += 8)
+    {
+        sha512Round(a, b, c, d, e, f, g, h, wk[j    ]);
+        sha512Round(h, a, b, c, d, e, f, g, wk[j + 1]);
+        sha512Round(g, h, a, b, c, d, e, f, wk[j + 2]);
+        sha512Round(f, g, h, a, b, c, d, e, wk[j + 3]);
+        sha512Round(e, f, g, h, a, b, c, d, wk[j + 4]);
+        sha512Round(d, e, f, g, h, a, b, c, wk[j + 5]);
+        sha512Round(c, d, e, f, g, h, a, b, wk[j + 6]);
+        sha512Round(b, c, d, e, f, g, h, a, wk[j + 7]);
+    }
+
+    state[0] += a;  state[1] += b;  state[2] += c;  state[3] += d;
+    state[4] += e;  state[5] += f;  state[6] += g;  state[7] += h;
+}
+
+/** The portable kernel: a scalar message schedule and scalar rounds.  */
+static void sha512CompressPortable (uint64_t state[8], const byte_t *blocks,
+                                    uint64_t count)
+{
+    uint64_t w[80], wk[80];
+
+    for (uint64_t i = 0; i < count; ++i, blocks += 128)
+    {
+        for (uint32_t j = 0; j < 16; ++j)
+            w[j] = loadBigEndian64(blocks + (j * 8));
+
+        for (uint32_t j = 16; j < 80; ++j)
+        {
+            uint64_t s0 = rotr64(w[j - 15], 1) ^ rotr64(w[j - 15], 8)
+                            ^ (w[j - 15] >> 7);
+            uint64_t s1 = rotr64(w[j - 2], 19) ^ rotr64(w[j - 2], 61)
+                            ^ (w[j - 2] >> 6);
+            w[j] = w[j - 16] + s0 + w[j - 7] + s1;
+        }
+
+        for (uint32_t j = 0; j < 80; ++j)
+            wk[j] = w[j] + K512[j];
+
+        sha512Rounds(state, wk);
+    }
+}
+
+#ifdef GASH_X86_SIMD
+
+__attribute__((target("avx2")))
+static inline __m256i rotr64x4 (__m256i x, int n)
+{
+    return _mm256_or_si256(_mm256_srli_epi64(x, n),
+                           _mm256_slli_epi64(x, 64 - n));
+}
+
+__attribute__((target("avx2")))
+static inline __m128i rotr64x2 (__m128i x, int n)
+{
+    return _mm_or_si128(_mm_srli_epi64(x, n), _mm_slli_epi64(x, 64 - n));
+}
+
+__attribute__((target("avx2")))
+static inline __m128i sha512Sig1x2 (__m128i x)
+{
+    return _mm_xor_si128(_mm_xor_si128(rotr64x2(x, 19), rotr64x2(x, 61)),
+                         _mm_srli_epi64(x, 6));
+}
+
+/** The AVX2 kernel: the message schedule (and the addition of the round
+ *  constants) is computed four words at a time.  Within each group of four,
+ *  the sigma1 term of the upper two words depends on the lower two, so it
+ *  is evaluated in two 128-bit halves.  The rounds themselves are serial
+ *  and remain scalar.
+*/
+__attribute__((target("avx2")))
+static void sha512CompressAVX2 (uint64_t state[8], const byte_t *blocks,
+                                uint64_t count)
+{
+    // Reverses the bytes within each 64-bit word.
+    const __m256i byteSwap = _mm256_set_epi8( 8,  9, 10, 11, 12, 13, 14, 15,
+                                              0,  1,  2,  3,  4,  5,  6,  7,
+                                              8,  9, 10, 11, 12, 13, 14, 15,
+                                              0,  1,  2,  3,  4,  5,  6,  7);
+
+    uint64_t w[80]  __attribute__((aligned(32)));
+    uint64_t wk[80] __attribute__((aligned(32)));
+
+    for (uint64_t i = 0; i < count; ++i, blocks += 128)
+    {
+        for (uint32_t j = 0; j < 16; j += 4)
+        {
+            __m256i m = _mm256_loadu_si256((const __m256i *)(blocks + j * 8));
+            m = _mm256_shuffle_epi8(m, byteSwap);
+            _mm256_store_si256((__m256i *)&w[j], m);
+            _mm256_store_si256((__m256i *)&wk[j], _mm256_add_epi64(m,
+                               _mm256_loadu_si256((const __m256i *)&K512[j])));
+        }
+
+        for (uint32_t j = 16; j < 80; j += 4)
+        {
+            __m256i w16 = _mm256_load_si256((const __m256i *)&w[j - 16]);
+            __m256i w15 = _mm256_loadu_si256((const __m256i *)&w[j - 15]);
+            __m256i w7  = _mm256_loadu_si256((const __m256i *)&w[j - 7]);
+
+            __m256i s0 = _mm256_xor_si256(
+                             _mm256_xor_si256(rotr64x4(w15, 1),
+                                              rotr64x4(w15, 8)),
+                             _mm256_srli_epi64(w15, 7));
+
+            __m256i partial = _mm256_add_epi64(_mm256_add_epi64(w16, s0), w7);
+
+            __m128i w2 = _mm_loadu_si128((const __m128i *)&w[j - 2]);
+            __m128i lo = _mm_add_epi64(_mm256_castsi256_si128(partial),
+                                       sha512Sig1x2(w2));
+            __m128i hi = _mm_add_epi64(_mm256_extracti128_si256(partial, 1),
+                                       sha512Sig1x2(lo));
+
+            __m256i next = _mm256_inserti128_si256(
+                               _mm256_castsi128_si256(lo), hi, 1);
+
+            _mm256_store_si256((__m256i *)&w[j], next);
+            _mm256_store_si256((__m256i *)&wk[j], _mm256_add_epi64(next,
+                               _mm256_loadu_si256((const __m256i *)&K512[j])));
+        }
+
+        sha512Rounds(state, wk);
+    }
+}
+
+#endif  // GASH_X86_SIMD
+
+/** Choose the fastest kernel that the host supports.  */
+static Sha512Kernel selectSha512Kernel (void)
+{
+#ifdef GASH_X86_SIMD
+    if (CPUFeatures::has(CPUFeatures::AVX2))
+        return sha512CompressAVX2;
+#endif
+
+    return sha512CompressPortable;
+}
+
+/******************************************************
+**            Constructors / Destructors             **
+******************************************************/
+
+/** Default constructor.  */
+SHA512::SHA512 ()
+    : BlockHash(512, 128, 16),
+      _iv(IV512)
+{
+    _initializeHash();
+}
+
+/** Copy constructor.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated from the copied SHA512 object.
+ *  @param copyFrom The SHA512 object whose values are to be copied.
+*/
+SHA512::SHA512 (const SHA512 &copyFrom)
+    : BlockHash(copyFrom),
+      _iv(copyFrom._iv)
+{
+    for (uint32_t i = 0; i < 8; ++i)
+        _state[i] = copyFrom._state[i];
+}
+
+/** Initialize an SHA512 object by hashing an input std::string.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated containing the
+ *        hashed value of the input data.
+ *  @param str The std::string that is to be hashed.
+*/
+SHA512::SHA512 (const string &str)
+    : BlockHash(512, 128, 16),
+      _iv(IV512)
+{
+    calculateHash(str);
+}
+
+/** Initialize an SHA512 object by hashing an input data stream.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated containing the
+ *        hashed value of the input data.
+ *  @param data The data that is to be hashed.
+*/
+SHA512::SHA512 (const vector < byte_t > &data)
+    : BlockHash(512, 128, 16),
+      _iv(IV512)
+{
+    calculateHash(data);
+}
+
+/** Initialize an SHA512 object by hashing an input file stream.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated containing the
+ *        hashed value of the input data.
+ *  @param file A handle to the file that is to be hashed.
+*/
+SHA512::SHA512 (ifstream &file)
+    : BlockHash(512, 128, 16),
+      _iv(IV512)
+{
+    calculateHash(file);
+}
+
+/** Initialize a truncated member of the SHA-512 family.
+ *
+ *  @pre none.
+ *  @post The object is ready to accept message data.
+ *  @param bits The number of bits in the (truncated) hash.
+ *  @param iv The eight initial chaining values of the variant.
+*/
+SHA512::SHA512 (uint32_t bits, const uint64_t iv[8])
+    : BlockHash(bits, 128, 16),
+      _iv(iv)
+{
+    _initializeHash();
+}
+
+/** Default destructor.  */
+SHA512::~SHA512 ()  { }
+
+/** Default constructor.  */
+SHA384::SHA384 ()
+    : SHA512(384, IV384)
+{}
+
+/** Initialize an SHA384 object by hashing an input std::string.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated containing the
+ *        hashed value of the input data.
+ *  @param str The std::string that is to be hashed.
+*/
+SHA384::SHA384 (const string &str)
+    : SHA512(384, IV384)
+{
+    calculateHash(str);
+}
+
+/** Initialize an SHA384 object by hashing an input data stream.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated containing the
+ *        hashed value of the input data.
+ *  @param data The data that is to be hashed.
+*/
+SHA384::SHA384 (const vector < byte_t > &data)
+    : SHA512(384, IV384)
+{
+    calculateHash(data);
+}
+
+/** Initialize an SHA384 object by hashing an input file stream.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated containing the
+ *        hashed value of the input data.
+ *  @param file A handle to the file that is to be hashed.
+*/
+SHA384::SHA384 (ifstream &file)
+    : SHA512(384, IV384)
+{
+    calculateHash(file);
+}
+
+/** Default constructor.  */
+SHA512_256::SHA512_256 ()
+    : SHA512(256, IV512_256)
+{}
+
+/** Initialize an SHA512_256 object by hashing an input std::string.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated containing the
+ *        hashed value of the input data.
+ *  @param str The std::string that is to be hashed.
+*/
+SHA512_256::SHA512_256 (const string &str)
+    : SHA512(256, IV512_256)
+{
+    calculateHash(str);
+}
+
+/** Initialize an SHA512_256 object by hashing an input data stream.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated containing the
+ *        hashed value of the input data.
+ *  @param data The data that is to be hashed.
+*/
+SHA512_256::SHA512_256 (const vector < byte_t > &data)
+    : SHA512(256, IV512_256)
+{
+    calculateHash(data);
+}
+
+/** Initialize an SHA512_256 object by hashing an input file stream.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated containing the
+ *        hashed value of the input data.
+ *  @param file A handle to the file that is to be hashed.
+*/
+SHA512_256::SHA512_256 (ifstream &file)
+    : SHA512(256, IV512_256)
+{
+    calculateHash(file);
+}
+
+/******************************************************
+**               Accessors / Mutators                **
+******************************************************/
+
+////////////////////
+//    Getters
+////////////////////
+
+/** Retrieve the name of the algorithm.
+ *
+ *  @pre The object is instantiated.
+ *  @post none.
+ *  @return "SHA-512".
+*/
+string SHA512::algorithmName (void) const
+{
+    return "SHA-512";
+}
+
+/** Retrieve the name of the kernel that the host selected.
+ *
+ *  @pre The object is instantiated.
+ *  @post none.
+ *  @return "AVX2" or "portable".
+*/
+string SHA512::kernelName (void) const
+{
+#ifdef GASH_X86_SIMD
+    if (selectSha512Kernel() == sha512CompressAVX2)
+        return "AVX2";
+#endif
+
+    return "portable";
+}
+
+/** Copy the object, including any partially processed message.
+ *
+ *  @pre none.
+ *  @post The caller owns (and must delete) the copy.
+ *  @return A new SHA512 object in the same state.
+*/
+SHA512 * SHA512::clone (void) const
+{
+    return new SHA512(*this);
+}
+
+/** Retrieve the name of the algorithm.
+ *
+ *  @pre The object is instantiated.
+ *  @post none.
+ *  @return "SHA-384".
+*/
+string SHA384::algorithmName (void) const
+{
+    return "SHA-384";
+}
+
+/** Copy the object, including any partially processed message.
+ *
+ *  @pre none.
+ *  @post The caller owns (and must delete) the copy.
+ *  @return A new SHA384 object in the same state.
+*/
+SHA384 * SHA384::clone (void) const
+{
+    return new SHA384(*this);
+}
+
+/** Retrieve the name of the algorithm.
+ *
+ *  @pre The object is instantiated.
+ *  @post none.
+ *  @return "SHA-512/256".
+*/
+string SHA512_256::algorithmName (void) const
+{
+    return "SHA-512/256";
+}
+
+/** Copy the object, including any partially processed message.
+ *
+ *  @pre none.
+ *  @post The caller owns (and must delete) the copy.
+ *  @return A new SHA512_256 object in the same state.
+*/
+SHA512_256 * SHA512_256::clone (void) const
+{
+    return new SHA512_256(*this);
+}
+
+/******************************************************
+**                     Operators                     **
+******************************************************/
+
+/** Assignment from another SHA512 object.
+ *
+ *  @pre The object is instantiated.
+ *  @post The object contains the values copied from rhs.
+ *  @param rhs The SHA512 object whose values are to be copied/stored.
+ *  @return A reference to the object.
+*/
+SHA512 & SHA512::operator = (const SHA512 &rhs)
+{
+    if (this != &rhs)
+    {
+        BlockHash::operator = (rhs);
+
+        _iv = rhs._iv;
+        for (uint32_t i = 0; i < 8; ++i)
+            _state[i] = rhs._state[i];
+    }
+
+    return *this;
+}
+
+/******************************************************
+**                   Helper Methods                  **
+******************************************************/
+
+/** Initialize the SHA512 hash.
+ *
+ *  @pre The object is instantiated.
+ *  @post The chaining variables hold the values of the variant.
+ *  @return none.
+*/
+void SHA512::_initializeHash (void)
+{
+    for (uint32_t i = 0; i < 8; ++i)
+        _state[i] = _iv[i];
+
+    return;
+}
+
+/** Compress whole 1024-bit message blocks.
+ *
+ *  @pre The chaining variables have been initialized.
+ *  @post The chaining variables are updated.
+ *  @param blocks A pointer to the first block.
+ *  @param count The number of consecutive blocks at blocks.
+ *  @return none.
+*/
+void SHA512::_compress (const byte_t *blocks, uint64_t count)
+{
+    static const Sha512Kernel kernel = selectSha512Kernel();
+
+    kernel(_state, blocks, count);
+
+    return;
+}
+
+/** Copy the leading chaining variables into the _hash words.
+ *
+ *  @pre The final block has been compressed.
+ *  @post The _hash values hold the (truncated) message digest.
+ *  @return none.
+*/
+void SHA512::_storeHash (void)
+{
+    // Each 64-bit chaining variable supplies two 32-bit hash words.
+    for (uint32_t i = 0; i < _hash.size(); ++i)
+    {
+        uint64_t word = _state[i / 2];
+        _hash.at(i) = (i % 2 == 0) ? (uint32_t)(word >> 32) : (uint32_t)word;
+    }
+
+    return;
+}
+
+/** Append the chaining variables to an exported state.
+ *
+ *  @pre none.
+ *  @post The chaining variables are appended to state.
+ *  @param state The state that is being exported.
+ *  @return none.
+*/
+void SHA512::_saveChaining (HashState &state) const
+{
+    state.putWords64(_state, 8);
+
+    return;
+}
+
+/** Restore the chaining variables from an imported state.
+ *
+ *  @pre The block buffer has been read from state.
+ *  @post The chaining variables are restored.
+ *  @param state The state that is being imported.
+ *  @return none.
+*/
+void SHA512::_loadChaining (HashState &state)
+{
+    state.getWords64(_state, 8);
+
+    return;
+}
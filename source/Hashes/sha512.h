@@ -0,0 +1,346 @@
+/******************************************************************************
+||  sha512.h                                                                 ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    These abstract data types are used to calculate the SHA-512, SHA-384   ||
+||    and SHA-512/256 hashes of an input message or data stream.  The three  ||
+||    algorithms share one 64-bit compression function and differ only in    ||
+||    their initial chaining values and the length of the digest.            ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    block_hash.cpp (block_hash.lib)                                        ||
+||    block_hash.h                                                           ||
+||    cpu_features.cpp (cpu_features.lib)                                    ||
+||    cpu_features.h                                                         ||
+||    hash_abstract.cpp (hash_abstract.lib)                                  ||
+||    hash_abstract.h                                                        ||
+||                                                                           ||
+||===========================================================================||
+||  REFERENCES                                                               ||
+||===========================================================================||
+||    FIPS 180-4, "Secure Hash Standard".  Aug 2015.  National Institute of  ||
+||        Standards and Technology.                                          ||
+||                                                                           ||
+||    Gueron, S. and Krasnov, V.  "Parallelizing message schedules to        ||
+||        accelerate the computations of hash functions".  Journal of        ||
+||        Cryptographic Engineering 2, 2012.                                 ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file sha512.h
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+#ifndef _GH_SHA_512_DEF_H
+#define _GH_SHA_512_DEF_H
+
+#include "block_hash.h"
+
+/**
+ *  @class SHA512 An abstract data type to calculate and
+ *         manipulate SHA-512 hashes.
+*/
+class SHA512 : public BlockHash
+{
+  public:
+    /******************************************************
+    **            Constructors / Destructors             **
+    ******************************************************/
+
+    /** Default constructor.  */
+    SHA512 ();
+
+    /** Copy constructor.
+     *
+     *  @pre none.
+     *  @post A new object is instantiated from the copied SHA512 object.
+     *  @param copyFrom The SHA512 object whose values are to be copied.
+    */
+    SHA512 (const SHA512 &copyFrom);
+
+    /** Initialize an SHA512 object by hashing an input std::string.
+     *
+     *  @pre none.
+     *  @post A new object is instantiated containing the
+     *        hashed value of the input data.
+     *  @param str The std::string that is to be hashed.
+    */
+    SHA512 (const string &str);
+
+    /** Initialize an SHA512 object by hashing an input data stream.
+     *
+     *  @pre none.
+     *  @post A new object is instantiated containing the
+     *        hashed value of the input data.
+     *  @param data The data that is to be hashed.
+    */
+    SHA512 (const vector < byte_t > &data);
+
+    /** Initialize an SHA512 object by hashing an input file stream.
+     *
+     *  @pre none.
+     *  @post A new object is instantiated containing the
+     *        hashed value of the input data.
+     *  @param file A handle to the file that is to be hashed.
+    */
+    SHA512 (ifstream &file);
+
+    /** Default destructor.  */
+    ~SHA512 ();
+
+    /******************************************************
+    **               Accessors / Mutators                **
+    ******************************************************/
+
+    ////////////////////
+    //    Getters
+    ////////////////////
+
+    /** Retrieve the name of the algorithm.
+     *
+     *  @pre The object is instantiated.
+     *  @post none.
+     *  @return "SHA-512".
+    */
+    string algorithmName (void) const;
+
+    /** Retrieve the name of the kernel that the host selected.
+     *
+     *  @pre The object is instantiated.
+     *  @post none.
+     *  @return "AVX2" or "portable".
+    */
+    string kernelName (void) const;
+
+    /** Copy the object, including any partially processed message.
+     *
+     *  @pre none.
+     *  @post The caller owns (and must delete) the copy.
+     *  @return A new SHA512 object in the same state.
+    */
+    SHA512 * clone (void) const;
+
+    /******************************************************
+    **                     Operators                     **
+    ******************************************************/
+
+    /** Assignment from another SHA512 object.
+     *
+     *  @pre The object is instantiated.
+     *  @post The object contains the values copied from rhs.
+     *  @param rhs The SHA512 object whose values are to be copied/stored.
+     *  @return A reference to the object.
+    */
+    SHA512 & operator = (const SHA512 &rhs);
+
+  protected:
+    /******************************************************
+    **                      Members                      **
+    ******************************************************/
+    uint64_t _state[8];   // The eight 64-bit chaining variables.
+    const uint64_t *_iv;  // The initial chaining values of this variant.
+
+    /** Initialize a truncated member of the SHA-512 family.
+     *
+     *  @pre none.
+     *  @post The object is ready to accept message data.
+     *  @param bits The number of bits in the (truncated) hash.
+     *  @param iv The eight initial chaining values of the variant.
+    */
+    SHA512 (uint32_t bits, const uint64_t iv[8]);
+
+    /******************************************************
+    **                   Helper Methods                  **
+    ******************************************************/
+
+    /** Initialize the SHA512 hash.
+     *
+     *  @pre The object is instantiated.
+     *  @post The chaining variables hold the values of the variant.
+     *  @return none.
+    */
+    void _initializeHash (void);
+
+    /** Compress whole 1024-bit message blocks.
+     *
+     *  @pre The chaining variables have been initialized.
+     *  @post The chaining variables are updated.
+     *  @param blocks A pointer to the first block.
+     *  @param count The number of consecutive blocks at blocks.
+     *  @return none.
+    */
+    void _compress (const byte_t *blocks, uint64_t count);
+
+    /** Copy the leading chaining variables into the _hash words.
+     *
+     *  @pre The final block has been compressed.
+     *  @post The _hash values hold the (truncated) message digest.
+     *  @return none.
+    */
+    void _storeHash (void);
+
+    /** Append the chaining variables to an exported state.
+     *
+     *  @pre none.
+     *  @post The chaining variables are appended to state.
+     *  @param state The state that is being exported.
+     *  @return none.
+    */
+    void _saveChaining (HashState &state) const;
+
+    /** Restore the chaining variables from an imported state.
+     *
+     *  @pre The block buffer has been read from state.
+     *  @post The chaining variables are restored.
+     *  @param state The state that is being imported.
+     *  @return none.
+    */
+    void _loadChaining (HashState &state);
+
+};  // End class SHA512.
+
+/**
+ *  @class SHA384 An abstract data type to calculate and
+ *         manipulate SHA-384 hashes.
+*/
+class SHA384 : public SHA512
+{
+  public:
+    /** Default constructor.  */
+    SHA384 ();
+
+    /** Initialize an SHA384 object by hashing an input std::string.
+     *
+     *  @pre none.
+     *  @post A new object is instantiated containing the
+     *        hashed value of the input data.
+     *  @param str The std::string that is to be hashed.
+    */
+    SHA384 (const string &str);
+
+    /** Initialize an SHA384 object by hashing an input data stream.
+     *
+     *  @pre none.
+     *  @post A new object is instantiated containing the
+     *        hashed value of the input data.
+     *  @param data The data that is to be hashed.
+    */
+    SHA384 (const vector < byte_t > &data);
+
+    /** Initialize an SHA384 object by hashing an input file stream.
+     *
+     *  @pre none.
+     *  @post A new object is instantiated containing the
+     *        hashed value of the input data.
+     *  @param file A handle to the file that is to be hashed.
+    */
+    SHA384 (ifstream &file);
+
+    /** Retrieve the name of the algorithm.
+     *
+     *  @pre The object is instantiated.
+     *  @post none.
+     *  @return "SHA-384".
+    */
+    string algorithmName (void) const;
+
+    /** Copy the object, including any partially processed message.
+     *
+     *  @pre none.
+     *  @post The caller owns (and must delete) the copy.
+     *  @return A new SHA384 object in the same state.
+    */
+    SHA384 * clone (void) const;
+
+};  // End class SHA384.
+
+/**
+ *  @class SHA512_256 An abstract data type to calculate and
+ *         manipulate SHA-512/256 hashes.
+*/
+class SHA512_256 : public SHA512
+{
+  public:
+    /** Default constructor.  */
+    SHA512_256 ();
+
+    /** Initialize an SHA512_256 object by hashing an input std::string.
+     *
+     *  @pre none.
+     *  @post A new object is instantiated containing the
+     *        hashed value of the input data.
+     *  @param str The std::string that is to be hashed.
+    */
+    SHA512_256 (const string &str);
+
+    /** Initialize an SHA512_256 object by hashing an input data stream.
+     *
+     *  @pre none.
+     *  @post A new object is instantiated containing the
+     *        hashed value of the input data.
+     *  @param data The data that is to be hashed.
+    */
+    SHA512_256 (const vector < byte_t > &data);
+
+    /** Initialize an SHA512_256 object by hashing an input file stream.
+     *
+     *  @pre none.
+     *  @post A new object is instantiated containing the
+     *        hashed value of the input data.
+     *  @param file A handle to the file that is to be hashed.
+    */
+    SHA512_256 (ifstream &file);
+
+    /** Retrieve the name of the algorithm.
+     *
+     *  @pre The object is instantiated.
+     *  @post none.
+     *  @return "SHA-512/256".
+    */
+    string algorithmName (void) const;
+
+    /** Copy the object, including any partially processed message.
+     *
+     *  @pre none.
+     *  @post The caller owns (and must delete) the copy.
+     *  @return A new SHA512_256 object in the same state.
+    */
+    SHA512_256 * clone (void) const;
+
+};  // End class SHA512_256.
+
+#endif
@@ -0,0 +1,1390 @@
+/******************************************************************************
+||  xxh3.cpp                                                                 ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    This abstract data type is used to calculate the XXH3 hash, in its     ||
+||    64-bit (XXH3_64) and 128-bit (XXH3_128) forms, of an input message or  ||
+||    data stream.  XXH3 is a fast non-cryptographic hash meant for change   ||
+||    detection and for bucketing large numbers of files; it must not be     ||
+||    used where an adversary can choose the input.                          ||
+||                                                                           ||
+||    The stripe accumulation and scrambling kernels are chosen at run time: ||
+||    SSE2, AVX2 and AVX-512 kernels keep the eight 64-bit accumulators in   ||
+||    vector registers.                                                      ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    cpu_features.cpp (cpu_features.lib)                                    ||
+||    cpu_features.h                                                         ||
+||    hash_abstract.cpp (hash_abstract.lib)                                  ||
+||    hash_abstract.h                                                        ||
+||                                                                           ||
+||===========================================================================||
+||  REFERENCES                                                               ||
+||===========================================================================||
+||    Collet, Y.  "xxHash - Extremely fast hash algorithm", XXH3 reference   ||
+||        implementation, version 0.8.  https://github.com/Cyan4973/xxHash   ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file xxh3.cpp
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+
+#include <string.h>
+
+#include "xxh3.h"
+#include "hash_state.h"
+#include "cpu_features.h"
+
+#ifdef GASH_X86_SIMD
+  #include <immintrin.h>
+#endif
+
+const uint32_t XXH3_64::STRIPE_BYTES;
+const uint32_t XXH3_64::SECRET_BYTES;
+const uint32_t XXH3_64::MIDSIZE_MAX;
+const uint32_t XXH3_64::FILE_BUFFER_BYTES;
+const uint32_t XXH3_64::BUFFER_BYTES;
+
+static const uint32_t PRIME32_1 = 0x9E3779B1U;
+static const uint32_t PRIME32_2 = 0x85EBCA77U;
+static const uint32_t PRIME32_3 = 0xC2B2AE3DU;
+
+static const uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+static const uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+static const uint64_t PRIME64_3 = 0x165667B19E3779F9ULL;
+static const uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+static const uint64_t PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+static const uint64_t PRIME_MX1 = 0x165667919E3779F9ULL;
+static const uint64_t PRIME_MX2 = 0x9FB21C651E98DF25ULL;
+
+// The default secret; a seeded hash of a long message uses a copy with
+// the seed added to (and subtracted from) alternate words.
+static const byte_t DEFAULT_SECRET[XXH3_64::SECRET_BYTES] =
+{
+    0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe,
+    0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+    0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb,
+    0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+    0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78,
+    0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+    0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e,
+    0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+    0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb,
+    0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+    0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e,
+    0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+    0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f,
+    0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+    0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31,
+    0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+    0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3,
+    0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+    0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49,
+    0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+    0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc,
+    0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+    0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28,
+    0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e
+};
+
+// The accumulators are scrambled after each block of stripes; each
+// stripe of a block is keyed with the secret 8 bytes further along.
+static const uint32_t STRIPES_PER_BLOCK =
+    (XXH3_64::SECRET_BYTES - XXH3_64::STRIPE_BYTES) / 8;
+
+// The offsets into the secret of the last stripe, the accumulator merge
+// and the tail of a 129 to 240 byte message.
+static const uint32_t SECRET_LAST_STRIPE =
+    XXH3_64::SECRET_BYTES - XXH3_64::STRIPE_BYTES - 7;
+static const uint32_t SECRET_MERGE = 11;
+static const uint32_t SECRET_MIDSIZE_START = 3;
+static const uint32_t SECRET_MIDSIZE_LAST = 136 - 17;
+
+/******************************************************
+**                   Shared Helpers                  **
+******************************************************/
+
+static inline uint64_t loadLittleEndian64 (const byte_t *p)
+{
+    // Written out so that the compiler reduces it to a single load.
+    return   ((uint64_t)p[0]      ) | ((uint64_t)p[1] <<  8)
+           | ((uint64_t)p[2] << 16) | ((uint64_t)p[3] << 24)
+           | ((uint64_t)p[4] << 32) | ((uint64_t)p[5] << 40)
+           | ((uint64_t)p[6] << 48) | ((uint64_t)p[7] << 56);
+}
+
+static inline uint32_t loadLittleEndian32 (const byte_t *p)
+{
+    return   ((uint32_t)p[0]      ) | ((uint32_t)p[1] <<  8)
+           | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void storeLittleEndian64 (byte_t *p, uint64_t x)
+{
+    for (uint32_t i = 0; i < 8; ++i)
+        p[i] = (byte_t)(x >> (i * 8));
+}
+
+static inline uint64_t rotl64 (uint64_t x, uint32_t n)
+{  return ((x << n) | (x >> (64 - n)));  }
+
+static inline uint32_t rotl32 (uint32_t x, uint32_t n)
+{  return ((x << n) | (x >> (32 - n)));  }
+
+static inline uint32_t swap32 (uint32_t x)
+{
+    return   ((x << 24) & 0xff000000U) | ((x <<  8) & 0x00ff0000U)
+           | ((x >>  8) & 0x0000ff00U) | ((x >> 24) & 0x000000ffU);
+}
+
+static inline uint64_t swap64 (uint64_t x)
+{
+    return ((uint64_t)swap32((uint32_t)x) << 32) | swap32((uint32_t)(x >> 32));
+}
+
+/** The full 128-bit product of two 64-bit values.  */
+static inline void multiply128 (uint64_t a, uint64_t b,
+                                uint64_t &low, uint64_t &high)
+{
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 product = (unsigned __int128)a * b;
+
+    low = (uint64_t)product;
+    high = (uint64_t)(product >> 64);
+#else
+    uint64_t loLo = (a & 0xffffffffULL) * (b & 0xffffffffULL),
+             hiLo = (a >> 32) * (b & 0xffffffffULL),
+             loHi = (a & 0xffffffffULL) * (b >> 32),
+             hiHi = (a >> 32) * (b >> 32);
+
+    uint64_t cross = (loLo >> 32) + (hiLo & 0xffffffffULL) + loHi;
+
+    low = (cross << 32) | (loLo & 0xffffffffULL);
+    high = (hiLo >> 32) + (cross >> 32) + hiHi;
+#endif
+}
+
+/** The 128-bit product of two values, folded to 64 bits.  */
+static inline uint64_t multiplyFold64 (uint64_t a, uint64_t b)
+{
+    uint64_t low, high;
+    multiply128(a, b, low, high);
+
+    return low ^ high;
+}
+
+/** The XXH64 avalanche.  */
+static inline uint64_t xxh64Avalanche (uint64_t h)
+{
+    h ^= h >> 33;
+    h *= PRIME64_2;
+    h ^= h >> 29;
+    h *= PRIME64_3;
+    h ^= h >> 32;
+
+    return h;
+}
+
+/** The (shorter) XXH3 avalanche.  */
+static inline uint64_t xxh3Avalanche (uint64_t h)
+{
+    h ^= h >> 37;
+    h *= PRIME_MX1;
+    h ^= h >> 32;
+
+    return h;
+}
+
+/** A stronger avalanche for 4 to 8 byte messages.  */
+static inline uint64_t rrmxmx (uint64_t h, uint64_t length)
+{
+    h ^= rotl64(h, 49) ^ rotl64(h, 24);
+    h *= PRIME_MX2;
+    h ^= (h >> 35) + length;
+    h *= PRIME_MX2;
+
+    return h ^ (h >> 28);
+}
+
+/** Mix 16 bytes of input with 16 bytes of secret.  */
+static inline uint64_t mix16 (const byte_t *data, const byte_t *secret,
+                              uint64_t seed)
+{
+    return multiplyFold64(
+               loadLittleEndian64(data) ^ (loadLittleEndian64(secret) + seed),
+               loadLittleEndian64(data + 8)
+               ^ (loadLittleEndian64(secret + 8) - seed));
+}
+
+/** Mix 32 bytes of input into a 128-bit accumulator.  */
+static inline void mix32 (uint64_t &low, uint64_t &high,
+                          const byte_t *data1, const byte_t *data2,
+                          const byte_t *secret, uint64_t seed)
+{
+    low += mix16(data1, secret, seed);
+    low ^= loadLittleEndian64(data2) + loadLittleEndian64(data2 + 8);
+    high += mix16(data2, secret + 16, seed);
+    high ^= loadLittleEndian64(data1) + loadLittleEndian64(data1 + 8);
+}
+
+/******************************************************
+**                 Short Message Hashes              **
+******************************************************/
+
+/** The 64-bit hash of a message of at most MIDSIZE_MAX bytes.  */
+static uint64_t xxh3Short64 (const byte_t *data, uint64_t length,
+                             uint64_t seed)
+{
+    const byte_t *secret = DEFAULT_SECRET;
+
+    if (length == 0)
+        return xxh64Avalanche(seed ^ (loadLittleEndian64(secret + 56)
+                                      ^ loadLittleEndian64(secret + 64)));
+
+    if (length <= 3)
+    {
+        uint32_t combined =   ((uint32_t)data[0] << 16)
+                            | ((uint32_t)data[length >> 1] << 24)
+                            | ((uint32_t)data[length - 1])
+                            | ((uint32_t)length << 8);
+        uint64_t bitflip = (loadLittleEndian32(secret)
+                            ^ loadLittleEndian32(secret + 4)) + seed;
+
+        return xxh64Avalanche((uint64_t)combined ^ bitflip);
+    }
+
+    if (length <= 8)
+    {
+        seed ^= (uint64_t)swap32((uint32_t)seed) << 32;
+
+        uint64_t bitflip = (loadLittleEndian64(secret + 8)
+                            ^ loadLittleEndian64(secret + 16)) - seed;
+        uint64_t input =   loadLittleEndian32(data + length - 4)
+                         + ((uint64_t)loadLittleEndian32(data) << 32);
+
+        return rrmxmx(input ^ bitflip, length);
+    }
+
+    if (length <= 16)
+    {
+        uint64_t bitflip1 = (loadLittleEndian64(secret + 24)
+                             ^ loadLittleEndian64(secret + 32)) + seed;
+        uint64_t bitflip2 = (loadLittleEndian64(secret + 40)
+                             ^ loadLittleEndian64(secret + 48)) - seed;
+        uint64_t low = loadLittleEndian64(data) ^ bitflip1;
+        uint64_t high = loadLittleEndian64(data + length - 8) ^ bitflip2;
+
+        return xxh3Avalanche(length + swap64(low) + high
+                             + multiplyFold64(low, high));
+    }
+
+    uint64_t acc = length * PRIME64_1;
+
+    if (length <= 128)
+    {
+        // Pairs of 16 byte slices from both ends.
+        if (length > 32)
+        {
+            if (length > 64)
+            {
+                if (length > 96)
+                {
+                    acc += mix16(data + 48, secret + 96, seed);
+                    acc += mix16(data + length - 64, secret + 112, seed);
+                }
+
+                acc += mix16(data + 32, secret + 64, seed);
+                acc += mix16(data + length - 48, secret + 80, seed);
+            }
+
+            acc += mix16(data + 16, secret + 32, seed);
+            acc += mix16(data + length - 32, secret + 48, seed);
+        }
+
+        acc += mix16(data, secret, seed);
+        acc += mix16(data + length - 16, secret + 16, seed);
+
+        return xxh3Avalanche(acc);
+    }
+
+    uint32_t rounds = (uint32_t)length / 16;
+
+    for (uint32_t i = 0; i < 8; ++i)
+        acc += mix16(data + (16 * i), secret + (16 * i), seed);
+
+    acc = xxh3Avalanche(acc);
+
+    for (uint32_t i = 8; i < rounds; ++i)
+        acc += mix16(data + (16 * i),
+                     secret + (16 * (i - 8)) + SECRET_MIDSIZE_START, seed);
+
+    acc += mix16(data + length - 16, secret + SECRET_MIDSIZE_LAST, seed);
+
+    return xxh3Avalanche(acc);
+}
+
+/** The 128-bit hash of a message of at most MIDSIZE_MAX bytes.  */
+static void xxh3Short128 (const byte_t *data, uint64_t length,
+                          uint64_t seed, uint64_t &low, uint64_t &high)
+{
+    const byte_t *secret = DEFAULT_SECRET;
+
+    if (length == 0)
+    {
+        low = xxh64Avalanche(seed ^ loadLittleEndian64(secret + 64)
+                                  ^ loadLittleEndian64(secret + 72));
+        high = xxh64Avalanche(seed ^ loadLittleEndian64(secret + 80)
+                                   ^ loadLittleEndian64(secret + 88));
+        return;
+    }
+
+    if (length <= 3)
+    {
+        uint32_t combinedLow =   ((uint32_t)data[0] << 16)
+                               | ((uint32_t)data[length >> 1] << 24)
+                               | ((uint32_t)data[length - 1])
+                               | ((uint32_t)length << 8);
+        uint32_t combinedHigh = rotl32(swap32(combinedLow), 13);
+
+        uint64_t bitflipLow = (loadLittleEndian32(secret)
+                               ^ loadLittleEndian32(secret + 4)) + seed;
+        uint64_t bitflipHigh = (loadLittleEndian32(secret + 8)
+                                ^ loadLittleEndian32(secret + 12)) - seed;
+
+        low = xxh64Avalanche((uint64_t)combinedLow ^ bitflipLow);
+        high = xxh64Avalanche((uint64_t)combinedHigh ^ bitflipHigh);
+        return;
+    }
+
+    if (length <= 8)
+    {
+        seed ^= (uint64_t)swap32((uint32_t)seed) << 32;
+
+        uint64_t input =   loadLittleEndian32(data)
+                         + ((uint64_t)loadLittleEndian32(data + length - 4)
+                            << 32);
+        uint64_t bitflip = (loadLittleEndian64(secret + 16)
+                            ^ loadLittleEndian64(secret + 24)) + seed;
+
+        multiply128(input ^ bitflip, PRIME64_1 + (length << 2), low, high);
+
+        high += low << 1;
+        low ^= high >> 3;
+        low ^= low >> 35;
+        low *= PRIME_MX2;
+        low ^= low >> 28;
+        high = xxh3Avalanche(high);
+        return;
+    }
+
+    if (length <= 16)
+    {
+        uint64_t bitflipLow = (loadLittleEndian64(secret + 32)
+                               ^ loadLittleEndian64(secret + 40)) - seed;
+        uint64_t bitflipHigh = (loadLittleEndian64(secret + 48)
+                                ^ loadLittleEndian64(secret + 56)) + seed;
+        uint64_t inputLow = loadLittleEndian64(data);
+        uint64_t inputHigh = loadLittleEndian64(data + length - 8);
+        uint64_t mLow, mHigh;
+
+        multiply128(inputLow ^ inputHigh ^ bitflipLow, PRIME64_1,
+                    mLow, mHigh);
+
+        mLow += (uint64_t)(length - 1) << 54;
+        inputHigh ^= bitflipHigh;
+        mHigh += inputHigh
+                 + ((uint64_t)(uint32_t)inputHigh * (PRIME32_2 - 1));
+        mLow ^= swap64(mHigh);
+
+        multiply128(mLow, PRIME64_2, low, high);
+        high += mHigh * PRIME64_2;
+
+        low = xxh3Avalanche(low);
+        high = xxh3Avalanche(high);
+        return;
+    }
+
+    uint64_t accLow = length * PRIME64_1, accHigh = 0;
+
+    if (length <= 128)
+    {
+        if (length > 32)
+        {
+            if (length > 64)
+            {
+                if (length > 96)
+                    mix32(accLow, accHigh, data + 48, data + length - 64,
+                          secret + 96, seed);
+
+                mix32(accLow, accHigh, data + 32, data + length - 48,
+                      secret + 64, seed);
+            }
+
+            mix32(accLow, accHigh, data + 16, data + length - 32,
+                  secret + 32, seed);
+        }
+
+        mix32(accLow, accHigh, data, data + length - 16, secret, seed);
+    }
+    else
+    {
+        uint32_t rounds = (uint32_t)length / 32;
+
+        for (uint32_t i = 0; i < 4; ++i)
+            mix32(accLow, accHigh, data + (32 * i), data + (32 * i) + 16,
+                  secret + (32 * i), seed);
+
+        accLow = xxh3Avalanche(accLow);
+        accHigh = xxh3Avalanche(accHigh);
+
+        for (uint32_t i = 4; i < rounds; ++i)
+            mix32(accLow, accHigh, data + (32 * i), data + (32 * i) + 16,
+                  secret + SECRET_MIDSIZE_START + (32 * (i - 4)), seed);
+
+        mix32(accLow, accHigh, data + length - 16, data + length - 32,
+              secret + SECRET_MIDSIZE_LAST - 16, 0 - seed);
+    }
+
+    low = xxh3Avalanche(accLow + accHigh);
+    high = 0 - xxh3Avalanche(  (accLow * PRIME64_1) + (accHigh * PRIME64_4)
+                             + ((length - seed) * PRIME64_2));
+}
+
+/******************************************************
+**                 Accumulator Kernels               **
+******************************************************/
+
+// An accumulate kernel absorbs count consecutive stripes, keying each
+// with the secret 8 bytes after the previous one.  A scramble kernel
+// mixes the accumulators with the last stripe of the secret at the end
+// of each block.
+typedef void (*Xxh3AccumulateKernel)(uint64_t acc[8], const byte_t *stripes,
+                                     const byte_t *secret, uint64_t count);
+
+typedef void (*Xxh3ScrambleKernel)(uint64_t acc[8], const byte_t *secret);
+
+struct Xxh3Kernels
+{
+    Xxh3AccumulateKernel accumulate;
+    Xxh3ScrambleKernel scramble;
+};
+
+/** The portable accumulate kernel.  */
+static void xxh3AccumulatePortable (uint64_t acc[8], const byte_t *stripes,
+                                    const byte_t *secret, uint64_t count)
+{
+    for (; count > 0; --count, stripes += XXH3_64::STRIPE_BYTES, secret += 8)
+    {
+        for (uint32_t i = 0; i < 8; ++i)
+        {
+            uint64_t value = loadLittleEndian64(stripes + (8 * i));
+            uint64_t keyed = value ^ loadLittleEndian64(secret + (8 * i));
+
+            // Each word also lands in its neighbour so that no input is
+            // lost to a zero product.
+            acc[i ^ 1] += value;
+            acc[i] += (keyed & 0xffffffffULL) * (keyed >> 32);
+        }
+    }
+}
+
+/** The portable scramble kernel.  */
+static void xxh3ScramblePortable (uint64_t acc[8], const byte_t *secret)
+{
+    for (uint32_t i = 0; i < 8; ++i)
+    {
+        uint64_t a = acc[i];
+
+        a ^= a >> 47;
+        a ^= loadLittleEndian64(secret + (8 * i));
+        acc[i] = a * PRIME32_1;
+    }
+}
+
+#ifdef GASH_X86_SIMD
+
+// The vector kernels split the accumulators over 2 (SSE2), 4 (AVX2) or
+// 8 (AVX-512) 64-bit lanes per register.  The 32x32 -> 64-bit multiply
+// of the keyed halves is a single mul_epu32, and the neighbour swap is
+// a shuffle within each 128-bit lane.
+
+/** The SSE2 accumulate kernel.  */
+__attribute__((target("sse2")))
+static void xxh3AccumulateSSE2 (uint64_t acc[8], const byte_t *stripes,
+                                const byte_t *secret, uint64_t count)
+{
+    __m128i a[4];
+
+    for (uint32_t i = 0; i < 4; ++i)
+        a[i] = _mm_loadu_si128((const __m128i *)(acc + (2 * i)));
+
+    for (; count > 0; --count, stripes += XXH3_64::STRIPE_BYTES, secret += 8)
+    {
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            __m128i value = _mm_loadu_si128((const __m128i *)(stripes + (16 * i)));
+            __m128i keyed = _mm_xor_si128(value,
+                                _mm_loadu_si128((const __m128i *)(secret + (16 * i))));
+            __m128i product = _mm_mul_epu32(keyed,
+                                  _mm_shuffle_epi32(keyed, _MM_SHUFFLE(0, 3, 0, 1)));
+            __m128i swapped = _mm_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2));
+
+            a[i] = _mm_add_epi64(a[i], _mm_add_epi64(product, swapped));
+        }
+    }
+
+    for (uint32_t i = 0; i < 4; ++i)
+        _mm_storeu_si128((__m128i *)(acc + (2 * i)), a[i]);
+}
+
+/** The SSE2 scramble kernel.  */
+__attribute__((target("sse2")))
+static void xxh3ScrambleSSE2 (uint64_t acc[8], const byte_t *secret)
+{
+    const __m128i prime = _mm_set1_epi32((int)PRIME32_1);
+
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i *)(acc + (2 * i)));
+
+        a = _mm_xor_si128(a, _mm_srli_epi64(a, 47));
+        a = _mm_xor_si128(a, _mm_loadu_si128((const __m128i *)(secret + (16 * i))));
+
+        // A 64 x 32-bit multiply from two 32 x 32-bit products.
+        __m128i low = _mm_mul_epu32(a, prime);
+        __m128i high = _mm_mul_epu32(_mm_srli_epi64(a, 32), prime);
+
+        a = _mm_add_epi64(low, _mm_slli_epi64(high, 32));
+        _mm_storeu_si128((__m128i *)(acc + (2 * i)), a);
+    }
+}
+
+/** The AVX2 accumulate kernel.  */
+__attribute__((target("avx2")))
+static void xxh3AccumulateAVX2 (uint64_t acc[8], const byte_t *stripes,
+                                const byte_t *secret, uint64_t count)
+{
+    __m256i a[2];
+
+    for (uint32_t i = 0; i < 2; ++i)
+        a[i] = _mm256_loadu_si256((const __m256i *)(acc + (4 * i)));
+
+    for (; count > 0; --count, stripes += XXH3_64::STRIPE_BYTES, secret += 8)
+    {
+        for (uint32_t i = 0; i < 2; ++i)
+        {
+            __m256i value = _mm256_loadu_si256((const __m256i *)(stripes + (32 * i)));
+            __m256i keyed = _mm256_xor_si256(value,
+                                _mm256_loadu_si256((const __m256i *)(secret + (32 * i))));
+            __m256i product = _mm256_mul_epu32(keyed,
+                                  _mm256_shuffle_epi32(keyed, _MM_SHUFFLE(0, 3, 0, 1)));
+            __m256i swapped = _mm256_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2));
+
+            a[i] = _mm256_add_epi64(a[i], _mm256_add_epi64(product, swapped));
+        }
+    }
+
+    for (uint32_t i = 0; i < 2; ++i)
+        _mm256_storeu_si256((__m256i *)(acc + (4 * i)), a[i]);
+}
+
+/** The AVX2 scramble kernel.  */
+__attribute__((target("avx2")))
+static void xxh3ScrambleAVX2 (uint64_t acc[8], const byte_t *secret)
+{
+    const __m256i prime = _mm256_set1_epi32((int)PRIME32_1);
+
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(acc + (4 * i)));
+
+        a = _mm256_xor_si256(a, _mm256_srli_epi64(a, 47));
+        a = _mm256_xor_si256(a, _mm256_loadu_si256((const __m256i *)(secret + (32 * i))));
+
+        __m256i low = _mm256_mul_epu32(a, prime);
+        __m256i high = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), prime);
+
+        a = _mm256_add_epi64(low, _mm256_slli_epi64(high, 32));
+        _mm256_storeu_si256((__m256i *)(acc + (4 * i)), a);
+    }
+}
+
+/** The AVX-512 accumulate kernel: all eight accumulators in one
+ *  register.
+*/
+__attribute__((target("avx512f,avx512vl,avx512bw")))
+static void xxh3AccumulateAVX512 (uint64_t acc[8], const byte_t *stripes,
+                                  const byte_t *secret, uint64_t count)
+{
+    __m512i a = _mm512_loadu_si512((const void *)acc);
+
+    for (; count > 0; --count, stripes += XXH3_64::STRIPE_BYTES, secret += 8)
+    {
+        __m512i value = _mm512_loadu_si512((const void *)stripes);
+        __m512i keyed = _mm512_xor_si512(value,
+                                         _mm512_loadu_si512((const void *)secret));
+        __m512i product = _mm512_mul_epu32(keyed,
+                              _mm512_shuffle_epi32(keyed,
+                                  (_MM_PERM_ENUM)_MM_SHUFFLE(0, 3, 0, 1)));
+        __m512i swapped = _mm512_shuffle_epi32(value,
+                              (_MM_PERM_ENUM)_MM_SHUFFLE(1, 0, 3, 2));
+
+        a = _mm512_add_epi64(a, _mm512_add_epi64(product, swapped));
+    }
+
+    _mm512_storeu_si512((void *)acc, a);
+}
+
+/** The AVX-512 scramble kernel.  */
+__attribute__((target("avx512f,avx512vl,avx512bw")))
+static void xxh3ScrambleAVX512 (uint64_t acc[8], const byte_t *secret)
+{
+    const __m512i prime = _mm512_set1_epi32((int)PRIME32_1);
+
+    __m512i a = _mm512_loadu_si512((const void *)acc);
+
+    // a ^ (a >> 47) ^ secret in one three-way XOR.
+    a = _mm512_ternarylogic_epi32(a, _mm512_srli_epi64(a, 47),
+                                  _mm512_loadu_si512((const void *)secret),
+                                  0x96);
+
+    __m512i low = _mm512_mul_epu32(a, prime);
+    __m512i high = _mm512_mul_epu32(_mm512_srli_epi64(a, 32), prime);
+
+    a = _mm512_add_epi64(low, _mm512_slli_epi64(high, 32));
+    _mm512_storeu_si512((void *)acc, a);
+}
+
+#endif  // GASH_X86_SIMD
+
+/** Choose the fastest kernels that the host supports.  */
+static Xxh3Kernels selectXxh3Kernels (void)
+{
+    Xxh3Kernels kernels = { xxh3AccumulatePortable, xxh3ScramblePortable };
+
+#ifdef GASH_X86_SIMD
+    if (CPUFeatures::has(CPUFeatures::AVX512))
+    {
+        kernels.accumulate = xxh3AccumulateAVX512;
+        kernels.scramble = xxh3ScrambleAVX512;
+    }
+    else if (CPUFeatures::has(CPUFeatures::AVX2))
+    {
+        kernels.accumulate = xxh3AccumulateAVX2;
+        kernels.scramble = xxh3ScrambleAVX2;
+    }
+    else if (CPUFeatures::has(CPUFeatures::SSE2))
+    {
+        kernels.accumulate = xxh3AccumulateSSE2;
+        kernels.scramble = xxh3ScrambleSSE2;
+    }
+#endif
+
+    return kernels;
+}
+
+static const Xxh3Kernels & xxh3Kernels (void)
+{
+    static const Xxh3Kernels kernels = selectXxh3Kernels();
+    return kernels;
+}
+
+/** Absorb whole stripes, scrambling at the end of each block.  */
+static void xxh3Consume (uint64_t acc[8], uint32_t &stripesInBlock,
+                         const byte_t *stripes, uint64_t count,
+                         const byte_t *secret)
+{
+    const Xxh3Kernels &kernels = xxh3Kernels();
+
+    while (count > 0)
+    {
+        uint64_t run = STRIPES_PER_BLOCK - stripesInBlock;
+        if (run > count)
+            run = count;
+
+        kernels.accumulate(acc, stripes, secret + (8 * stripesInBlock), run);
+        stripes += run * XXH3_64::STRIPE_BYTES;
+        count -= run;
+        stripesInBlock += (uint32_t)run;
+
+        if (stripesInBlock == STRIPES_PER_BLOCK)
+        {
+            kernels.scramble(acc, secret + XXH3_64::SECRET_BYTES
+                                         - XXH3_64::STRIPE_BYTES);
+            stripesInBlock = 0;
+        }
+    }
+}
+
+/** Fold the accumulators into a 64-bit value.  */
+static uint64_t xxh3MergeAccumulators (const uint64_t acc[8],
+                                       const byte_t *secret, uint64_t start)
+{
+    uint64_t result = start;
+
+    for (uint32_t i = 0; i < 4; ++i)
+        result += multiplyFold64(
+                      acc[2 * i] ^ loadLittleEndian64(secret + (16 * i)),
+                      acc[(2 * i) + 1]
+                      ^ loadLittleEndian64(secret + (16 * i) + 8));
+
+    return xxh3Avalanche(result);
+}
+
+/******************************************************
+**            Constructors / Destructors             **
+******************************************************/
+
+/** Default constructor.  */
+XXH3_64::XXH3_64 ()
+    : MessageHash(64),
+      _seed(0)
+{
+    reset();
+}
+
+/** Copy constructor.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated from the copied XXH3_64 object
+ *        including any partially processed message.
+ *  @param copyFrom The XXH3_64 object whose values are to be copied.
+*/
+XXH3_64::XXH3_64 (const XXH3_64 &copyFrom)
+    : MessageHash(copyFrom)
+{
+    *this = copyFrom;
+}
+
+/** Initialize an XXH3_64 object by hashing an input std::string.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated containing the
+ *        hashed value of the input data.
+ *  @param str The std::string that is to be hashed.
+*/
+XXH3_64::XXH3_64 (const string &str)
+    : MessageHash(64),
+      _seed(0)
+{
+    calculateHash(str);
+}
+
+/** Initialize an XXH3_64 object by hashing an input data stream.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated containing the
+ *        hashed value of the input data.
+ *  @param data The data that is to be hashed.
+*/
+XXH3_64::XXH3_64 (const vector < byte_t > &data)
+    : MessageHash(64),
+      _seed(0)
+{
+    calculateHash(data);
+}
+
+/** Initialize an XXH3_64 object by hashing an input file stream.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated containing the
+ *        hashed value of the input data.
+ *  @param file A handle to the file that is to be hashed.
+*/
+XXH3_64::XXH3_64 (ifstream &file)
+    : MessageHash(64),
+      _seed(0)
+{
+    calculateHash(file);
+}
+
+/** Initialize the object for a digest of the given length.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated with its initial values.
+ *  @param bits The number of bits in the hash (64 or 128).
+*/
+XXH3_64::XXH3_64 (uint32_t bits)
+    : MessageHash(bits),
+      _seed(0)
+{
+    reset();
+}
+
+/** Default destructor.  */
+XXH3_64::~XXH3_64 ()  { }
+
+/******************************************************
+**               Accessors / Mutators                **
+******************************************************/
+
+////////////////////
+//    Getters
+////////////////////
+
+/** Retrieve the name of the algorithm.
+ *
+ *  @pre The object is instantiated.
+ *  @post none.
+ *  @return "XXH3-64".
+*/
+string XXH3_64::algorithmName (void) const
+{
+    return "XXH3-64";
+}
+
+/** Retrieve the name of the kernel that the host selected.
+ *
+ *  @pre The object is instantiated.
+ *  @post none.
+ *  @return "AVX-512", "AVX2", "SSE2" or "portable".
+*/
+string XXH3_64::kernelName (void) const
+{
+#ifdef GASH_X86_SIMD
+    const Xxh3Kernels &kernels = xxh3Kernels();
+
+    if (kernels.accumulate == xxh3AccumulateAVX512)
+        return "AVX-512";
+
+    if (kernels.accumulate == xxh3AccumulateAVX2)
+        return "AVX2";
+
+    if (kernels.accumulate == xxh3AccumulateSSE2)
+        return "SSE2";
+#endif
+
+    return "portable";
+}
+
+/** Copy the object, including any partially processed message.
+ *
+ *  @pre none.
+ *  @post The caller owns (and must delete) the copy.
+ *  @return A new XXH3_64 object in the same state.
+*/
+XXH3_64 * XXH3_64::clone (void) const
+{
+    return new XXH3_64(*this);
+}
+
+/** Retrieve the leading 64 bits of the hash as an integer.
+ *
+ *  @pre finalize() has been called.
+ *  @post none.
+ *  @return The 64-bit hash value (the high half of an XXH3_128).
+*/
+uint64_t XXH3_64::asUint64 (void) const
+{
+    return ((uint64_t)_hash.at(0) << 32) | _hash.at(1);
+}
+
+////////////////////
+//    Setters
+////////////////////
+
+/** Calculate the hash from an input std::string.
+ *
+ *  @pre The object is instantiated.
+ *  @post The computed hash is stored in the _hash values.
+ *  @param str The string whose value is to be hashed.
+ *  @return The hash as a std::string.
+*/
+string XXH3_64::calculateHash (const string &str)
+{
+    reset();
+    update((const byte_t *)str.data(), str.size());
+
+    return finalize();
+}
+
+/** Calculate the hash from an input data stream.
+ *
+ *  @pre The object is instantiated.
+ *  @post The computed hash is stored in the _hash values.
+ *  @param data The data that is to be hashed.
+ *  @return The hash as a std::string.
+*/
+string XXH3_64::calculateHash (const vector < byte_t > &data)
+{
+    reset();
+    update(data);
+
+    return finalize();
+}
+
+/** Calculate the hash of a file.
+ *
+ *  @pre The object is instantiated.
+ *  @post The computed hash is stored in the _hash values.
+ *  @param file The file whose hash value is to be calculated.
+ *  @return The hash as a std::string.
+*/
+string XXH3_64::calculateHash (ifstream &file)
+{
+    reset();
+
+    // Check that the file is valid before doing anything else.
+    // This will return a hash value of all zeros.
+    if (file.fail() || !file.good())
+    {
+        _hash.assign(_hash.size(), 0x00000000);
+        return asString();
+    }
+
+    vector < byte_t > buffer(FILE_BUFFER_BYTES);
+
+    while (file.good())
+    {
+        file.read((char *)&buffer[0], buffer.size());
+        update(&buffer[0], (uint64_t)file.gcount());
+    }
+
+    // Reset the file flags and return to the file head.
+    file.clear();
+    file.seekg(0);  // Return to the head of the file.
+
+    return finalize();
+}
+
+/** Select a seed; differently seeded hashes are unrelated.
+ *
+ *  @pre none.
+ *  @post Any message data is discarded and later hashes use
+ *        the given seed (zero by default).
+ *  @param seed The seed value.
+ *  @return none.
+*/
+void XXH3_64::setSeed (uint64_t seed)
+{
+    _seed = seed;
+    reset();
+
+    return;
+}
+
+/** Discard any message data and restart the hash.
+ *
+ *  @pre The object is instantiated.
+ *  @post The accumulators hold their initial values.
+ *  @return none.
+*/
+void XXH3_64::reset (void)
+{
+    for (uint32_t i = 0; i < SECRET_BYTES; i += 16)
+    {
+        storeLittleEndian64(_secret + i,
+            loadLittleEndian64(DEFAULT_SECRET + i) + _seed);
+        storeLittleEndian64(_secret + i + 8,
+            loadLittleEndian64(DEFAULT_SECRET + i + 8) - _seed);
+    }
+
+    _acc[0] = PRIME32_3;
+    _acc[1] = PRIME64_1;
+    _acc[2] = PRIME64_2;
+    _acc[3] = PRIME64_3;
+    _acc[4] = PRIME64_4;
+    _acc[5] = PRIME32_2;
+    _acc[6] = PRIME64_5;
+    _acc[7] = PRIME32_1;
+
+    _stripesInBlock = 0;
+    _length = 0;
+    memset(_buffer, 0, sizeof(_buffer));
+    _buffered = 0;
+
+    return;
+}
+
+/** Append message data to the hash.
+ *
+ *  @pre reset() has been called since the last finalize().
+ *  @post The accumulators have absorbed every stripe of the data
+ *        seen so far except those that are still buffered.
+ *  @param data A pointer to the message data.
+ *  @param length The number of bytes at data.
+ *  @return none.
+*/
+void XXH3_64::update (const byte_t *data, uint64_t length)
+{
+    _length += length;
+
+    // The last stripe is keyed differently, so a stripe is only
+    // absorbed once there is data after it.
+    if (_buffered + length <= BUFFER_BYTES)
+    {
+        memcpy(_buffer + _buffered, data, (size_t)length);
+        _buffered += (uint32_t)length;
+
+        return;
+    }
+
+    if (_buffered > 0)
+    {
+        uint32_t fill = BUFFER_BYTES - _buffered;
+
+        memcpy(_buffer + _buffered, data, fill);
+        data += fill;
+        length -= fill;
+
+        xxh3Consume(_acc, _stripesInBlock, _buffer,
+                    BUFFER_BYTES / STRIPE_BYTES, _secret);
+        _buffered = 0;
+    }
+
+    if (length > BUFFER_BYTES)
+    {
+        uint64_t stripes = (length - 1) / STRIPE_BYTES;
+
+        xxh3Consume(_acc, _stripesInBlock, data, stripes, _secret);
+        data += stripes * STRIPE_BYTES;
+        length -= stripes * STRIPE_BYTES;
+
+        // Keep the last absorbed stripe; a short tail borrows from it.
+        memcpy(_buffer + BUFFER_BYTES - STRIPE_BYTES,
+               data - STRIPE_BYTES, STRIPE_BYTES);
+    }
+
+    memcpy(_buffer, data, (size_t)length);
+    _buffered = (uint32_t)length;
+
+    return;
+}
+
+/** Append message data to the hash.
+ *
+ *  @pre reset() has been called since the last finalize().
+ *  @post The message data has been absorbed.
+ *  @param data The message data.
+ *  @return none.
+*/
+void XXH3_64::update (const vector < byte_t > &data)
+{
+    if (!data.empty())
+        update(&data[0], data.size());
+
+    return;
+}
+
+/** Produce the hash.
+ *
+ *  @pre reset() has been called since the last finalize().
+ *  @post The computed hash is stored in the _hash values.
+ *  @return The hash as a std::string.
+*/
+string XXH3_64::finalize (void)
+{
+    uint64_t hash;
+
+    if (_length > MIDSIZE_MAX)
+    {
+        uint64_t acc[8];
+        _finishAccumulators(acc);
+
+        hash = xxh3MergeAccumulators(acc, _secret + SECRET_MERGE,
+                                     _length * PRIME64_1);
+    }
+    else
+        hash = xxh3Short64(_buffer, _length, _seed);
+
+    _hash.at(0) = (uint32_t)(hash >> 32);
+    _hash.at(1) = (uint32_t)hash;
+
+    return asString();
+}
+
+/******************************************************
+**                     Operators                     **
+******************************************************/
+
+/** Assignment from another XXH3_64 object.
+ *
+ *  @pre The object is instantiated.
+ *  @post The object contains the values copied from rhs.
+ *  @param rhs The XXH3_64 object whose values are to be copied/stored.
+ *  @return A reference to the object.
+*/
+XXH3_64 & XXH3_64::operator = (const XXH3_64 &rhs)
+{
+    if (this != &rhs)
+    {
+        MessageHash::operator = (rhs);
+
+        _seed = rhs._seed;
+        memcpy(_secret, rhs._secret, sizeof(_secret));
+        memcpy(_acc, rhs._acc, sizeof(_acc));
+        _stripesInBlock = rhs._stripesInBlock;
+        _length = rhs._length;
+        memcpy(_buffer, rhs._buffer, sizeof(_buffer));
+        _buffered = rhs._buffered;
+    }
+
+    return *this;
+}
+
+/******************************************************
+**                   Helper Methods                  **
+******************************************************/
+
+/** Absorb the held back data into a copy of the accumulators.
+ *
+ *  @pre The message is longer than MIDSIZE_MAX bytes.
+ *  @post The object is unchanged.
+ *  @param acc The array that receives the final accumulators.
+ *  @return none.
+*/
+void XXH3_64::_finishAccumulators (uint64_t acc[8]) const
+{
+    byte_t lastStripe[STRIPE_BYTES];
+    const byte_t *last;
+    uint32_t stripesInBlock = _stripesInBlock;
+
+    memcpy(acc, _acc, sizeof(_acc));
+
+    if (_buffered >= STRIPE_BYTES)
+    {
+        uint32_t stripes = (_buffered - 1) / STRIPE_BYTES;
+
+        xxh3Consume(acc, stripesInBlock, _buffer, stripes, _secret);
+        last = _buffer + _buffered - STRIPE_BYTES;
+    }
+    else
+    {
+        // The last stripe overlaps the previously absorbed one, which
+        // is kept at the end of the buffer.
+        uint32_t borrowed = STRIPE_BYTES - _buffered;
+
+        memcpy(lastStripe, _buffer + BUFFER_BYTES - borrowed, borrowed);
+        memcpy(lastStripe + borrowed, _buffer, _buffered);
+        last = lastStripe;
+    }
+
+    xxh3Kernels().accumulate(acc, last, _secret + SECRET_LAST_STRIPE, 1);
+
+    return;
+}
+
+/** Append the algorithm specific part of the midstate.
+ *
+ *  @pre none.
+ *  @post The state is appended to state.
+ *  @param state The state that is being exported.
+ *  @return none.
+*/
+void XXH3_64::_saveState (HashState &state) const
+{
+    state.putWord64(_seed);
+    state.putWords64(_acc, 8);
+    state.putWord32(_stripesInBlock);
+    state.putWord64(_length);
+    state.putWord32(_buffered);
+
+    // A short last stripe borrows from the end of the buffer, so the
+    // whole buffer is saved.
+    state.putBytes(_buffer, BUFFER_BYTES);
+
+    return;
+}
+
+/** Restore the algorithm specific part of the midstate.
+ *
+ *  @pre The common header of state has been read and checked.
+ *  @post The object holds the imported state.
+ *  @param state The state that is being imported.
+ *  @return true The values read are consistent.
+ *  @return false The state is corrupt.
+*/
+bool XXH3_64::_loadState (HashState &state)
+{
+    uint64_t seed = state.getWord64(),
+             acc[8];
+
+    state.getWords64(acc, 8);
+    uint32_t stripesInBlock = state.getWord32();
+    uint64_t length = state.getWord64();
+    uint32_t buffered = state.getWord32();
+
+    // A corrupt state leaves the seed of the object alone.
+    if ((buffered > BUFFER_BYTES) || (buffered > length)
+        || (stripesInBlock >= STRIPES_PER_BLOCK))
+        return false;
+
+    // The secret is derived from the seed again.
+    setSeed(seed);
+
+    memcpy(_acc, acc, sizeof(_acc));
+    _stripesInBlock = stripesInBlock;
+    _length = length;
+    _buffered = buffered;
+    state.getBytes(_buffer, BUFFER_BYTES);
+
+    return true;
+}
+
+/******************************************************
+**                      XXH3_128                     **
+******************************************************/
+
+/** Default constructor.  */
+XXH3_128::XXH3_128 ()
+    : XXH3_64(128)
+{ }
+
+/** Copy constructor.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated from the copied XXH3_128 object
+ *        including any partially processed message.
+ *  @param copyFrom The XXH3_128 object whose values are to be copied.
+*/
+XXH3_128::XXH3_128 (const XXH3_128 &copyFrom)
+    : XXH3_64(copyFrom)
+{ }
+
+/** Initialize an XXH3_128 object by hashing an input std::string.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated containing the
+ *        hashed value of the input data.
+ *  @param str The std::string that is to be hashed.
+*/
+XXH3_128::XXH3_128 (const string &str)
+    : XXH3_64(128)
+{
+    calculateHash(str);
+}
+
+/** Initialize an XXH3_128 object by hashing an input data stream.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated containing the
+ *        hashed value of the input data.
+ *  @param data The data that is to be hashed.
+*/
+XXH3_128::XXH3_128 (const vector < byte_t > &data)
+    : XXH3_64(128)
+{
+    calculateHash(data);
+}
+
+/** Initialize an XXH3_128 object by hashing an input file stream.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated containing the
+ *        hashed value of the input data.
+ *  @param file A handle to the file that is to be hashed.
+*/
+XXH3_128::XXH3_128 (ifstream &file)
+    : XXH3_64(128)
+{
+    calculateHash(file);
+}
+
+/** Default destructor.  */
+XXH3_128::~XXH3_128 ()  { }
+
+/** Retrieve the name of the algorithm.
+ *
+ *  @pre The object is instantiated.
+ *  @post none.
+ *  @return "XXH3-128".
+*/
+string XXH3_128::algorithmName (void) const
+{
+    return "XXH3-128";
+}
+
+/** Copy the object, including any partially processed message.
+ *
+ *  @pre none.
+ *  @post The caller owns (and must delete) the copy.
+ *  @return A new XXH3_128 object in the same state.
+*/
+XXH3_128 * XXH3_128::clone (void) const
+{
+    return new XXH3_128(*this);
+}
+
+/** Produce the hash.
+ *
+ *  @pre reset() has been called since the last finalize().
+ *  @post The computed hash is stored in the _hash values.
+ *  @return The hash as a std::string.
+*/
+string XXH3_128::finalize (void)
+{
+    uint64_t low, high;
+
+    if (_length > MIDSIZE_MAX)
+    {
+        uint64_t acc[8];
+        _finishAccumulators(acc);
+
+        low = xxh3MergeAccumulators(acc, _secret + SECRET_MERGE,
+                                    _length * PRIME64_1);
+        high = xxh3MergeAccumulators(acc, _secret + SECRET_BYTES
+                                          - STRIPE_BYTES - SECRET_MERGE,
+                                     ~(_length * PRIME64_2));
+    }
+    else
+        xxh3Short128(_buffer, _length, _seed, low, high);
+
+    // The canonical form is big endian, high half first.
+    _hash.at(0) = (uint32_t)(high >> 32);
+    _hash.at(1) = (uint32_t)high;
+    _hash.at(2) = (uint32_t)(low >> 32);
+    _hash.at(3) = (uint32_t)low;
+
+    return asString();
+}
+
+/** Assignment from another XXH3_128 object.
+ *
+ *  @pre The object is instantiated.
+ *  @post The object contains the values copied from rhs.
+ *  @param rhs The XXH3_128 object whose values are to be copied/stored.
+ *  @return A reference to the object.
+*/
+XXH3_128 & XXH3_128::operator = (const XXH3_128 &rhs)
+{
+    XXH3_64::operator = (rhs);
+
+    return *this;
+}
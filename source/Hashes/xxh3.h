@@ -0,0 +1,437 @@
+/******************************************************************************
+||  xxh3.h                                                                   ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    This abstract data type is used to calculate the XXH3 hash, in its     ||
+||    64-bit (XXH3_64) and 128-bit (XXH3_128) forms, of an input message or  ||
+||    data stream.  XXH3 is a fast non-cryptographic hash meant for change   ||
+||    detection and for bucketing large numbers of files; it must not be     ||
+||    used where an adversary can choose the input.                          ||
+||                                                                           ||
+||    The stripe accumulation and scrambling kernels are chosen at run time: ||
+||    SSE2, AVX2 and AVX-512 kernels keep the eight 64-bit accumulators in   ||
+||    vector registers.                                                      ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    cpu_features.cpp (cpu_features.lib)                                    ||
+||    cpu_features.h                                                         ||
+||    hash_abstract.cpp (hash_abstract.lib)                                  ||
+||    hash_abstract.h                                                        ||
+||                                                                           ||
+||===========================================================================||
+||  REFERENCES                                                               ||
+||===========================================================================||
+||    Collet, Y.  "xxHash - Extremely fast hash algorithm", XXH3 reference   ||
+||        implementation, version 0.8.  https://github.com/Cyan4973/xxHash   ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file xxh3.h
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+
+#ifndef _GH_XXH3_DEF_H
+#define _GH_XXH3_DEF_H
+
+#include "hash_abstract.h"
+
+/**
+ *  @class XXH3_64 An abstract data type to calculate and
+ *         manipulate 64-bit XXH3 hashes.
+*/
+class XXH3_64 : public MessageHash
+{
+  public:
+    /******************************************************
+    **                     Constants                     **
+    ******************************************************/
+    static const uint32_t STRIPE_BYTES = 64;    // Bytes per accumulation.
+    static const uint32_t SECRET_BYTES = 192;   // The length of the secret.
+
+    // Messages up to this length are hashed without the accumulators.
+    static const uint32_t MIDSIZE_MAX = 240;
+
+    // The size of the read buffer used to hash files.
+    static const uint32_t FILE_BUFFER_BYTES = 1024 * 1024;
+
+    /******************************************************
+    **            Constructors / Destructors             **
+    ******************************************************/
+
+    /** Default constructor.  */
+    XXH3_64 ();
+
+    /** Copy constructor.
+     *
+     *  @pre none.
+     *  @post A new object is instantiated from the copied XXH3_64 object
+     *        including any partially processed message.
+     *  @param copyFrom The XXH3_64 object whose values are to be copied.
+    */
+    XXH3_64 (const XXH3_64 &copyFrom);
+
+    /** Initialize an XXH3_64 object by hashing an input std::string.
+     *
+     *  @pre none.
+     *  @post A new object is instantiated containing the
+     *        hashed value of the input data.
+     *  @param str The std::string that is to be hashed.
+    */
+    XXH3_64 (const string &str);
+
+    /** Initialize an XXH3_64 object by hashing an input data stream.
+     *
+     *  @pre none.
+     *  @post A new object is instantiated containing the
+     *        hashed value of the input data.
+     *  @param data The data that is to be hashed.
+    */
+    XXH3_64 (const vector < byte_t > &data);
+
+    /** Initialize an XXH3_64 object by hashing an input file stream.
+     *
+     *  @pre none.
+     *  @post A new object is instantiated containing the
+     *        hashed value of the input data.
+     *  @param file A handle to the file that is to be hashed.
+    */
+    XXH3_64 (ifstream &file);
+
+    /** Default destructor.  */
+    virtual ~XXH3_64 ();
+
+    /******************************************************
+    **               Accessors / Mutators                **
+    ******************************************************/
+
+    ////////////////////
+    //    Getters
+    ////////////////////
+
+    /** Retrieve the name of the algorithm.
+     *
+     *  @pre The object is instantiated.
+     *  @post none.
+     *  @return "XXH3-64".
+    */
+    virtual string algorithmName (void) const;
+
+    /** Retrieve the name of the kernel that the host selected.
+     *
+     *  @pre The object is instantiated.
+     *  @post none.
+     *  @return "AVX-512", "AVX2", "SSE2" or "portable".
+    */
+    string kernelName (void) const;
+
+    /** Copy the object, including any partially processed message.
+     *
+     *  @pre none.
+     *  @post The caller owns (and must delete) the copy.
+     *  @return A new XXH3_64 object in the same state.
+    */
+    virtual XXH3_64 * clone (void) const;
+
+    /** Retrieve the leading 64 bits of the hash as an integer.
+     *
+     *  @pre finalize() has been called.
+     *  @post none.
+     *  @return The 64-bit hash value (the high half of an XXH3_128).
+    */
+    uint64_t asUint64 (void) const;
+
+    ////////////////////
+    //    Setters
+    ////////////////////
+
+    /** Calculate the hash from an input std::string.
+     *
+     *  @pre The object is instantiated.
+     *  @post The computed hash is stored in the _hash values.
+     *  @param str The string whose value is to be hashed.
+     *  @return The hash as a std::string.
+    */
+    string calculateHash (const string &str);
+
+    /** Calculate the hash from an input data stream.
+     *
+     *  @pre The object is instantiated.
+     *  @post The computed hash is stored in the _hash values.
+     *  @param data The data that is to be hashed.
+     *  @return The hash as a std::string.
+    */
+    string calculateHash (const vector < byte_t > &data);
+
+    /** Calculate the hash of a file.
+     *
+     *  @pre The object is instantiated.
+     *  @post The computed hash is stored in the _hash values.
+     *  @param file The file whose hash value is to be calculated.
+     *  @return The hash as a std::string.
+    */
+    string calculateHash (ifstream &file);
+
+    /** Select a seed; differently seeded hashes are unrelated.
+     *
+     *  @pre none.
+     *  @post Any message data is discarded and later hashes use
+     *        the given seed (zero by default).
+     *  @param seed The seed value.
+     *  @return none.
+    */
+    void setSeed (uint64_t seed);
+
+    /** Discard any message data and restart the hash.
+     *
+     *  @pre The object is instantiated.
+     *  @post The accumulators hold their initial values.
+     *  @return none.
+    */
+    void reset (void);
+
+    /** Append message data to the hash.
+     *
+     *  @pre reset() has been called since the last finalize().
+     *  @post The accumulators have absorbed every stripe of the data
+     *        seen so far except those that are still buffered.
+     *  @param data A pointer to the message data.
+     *  @param length The number of bytes at data.
+     *  @return none.
+    */
+    void update (const byte_t *data, uint64_t length);
+
+    /** Append message data to the hash.
+     *
+     *  @pre reset() has been called since the last finalize().
+     *  @post The message data has been absorbed.
+     *  @param data The message data.
+     *  @return none.
+    */
+    void update (const vector < byte_t > &data);
+
+    /** Produce the hash.
+     *
+     *  @pre reset() has been called since the last finalize().
+     *  @post The computed hash is stored in the _hash values.
+     *  @return The hash as a std::string.
+    */
+    virtual string finalize (void);
+
+    /******************************************************
+    **                     Operators                     **
+    ******************************************************/
+
+    /** Assignment from another XXH3_64 object.
+     *
+     *  @pre The object is instantiated.
+     *  @post The object contains the values copied from rhs.
+     *  @param rhs The XXH3_64 object whose values are to be copied/stored.
+     *  @return A reference to the object.
+    */
+    XXH3_64 & operator = (const XXH3_64 &rhs);
+
+  protected:
+    /******************************************************
+    **                     Constants                     **
+    ******************************************************/
+
+    // Whole stripes are only absorbed once there is data after them,
+    // so up to this many bytes are held back.
+    static const uint32_t BUFFER_BYTES = 4 * STRIPE_BYTES;
+
+    /******************************************************
+    **                      Members                      **
+    ******************************************************/
+    uint64_t _seed;
+    byte_t _secret[SECRET_BYTES];  // The secret derived from the seed.
+
+    uint64_t _acc[8];              // The stripe accumulators.
+    uint32_t _stripesInBlock;      // The stripes absorbed since the
+                                   // last scramble.
+    uint64_t _length;              // The message length so far.
+
+    byte_t _buffer[BUFFER_BYTES];  // Data held back from the accumulators.
+    uint32_t _buffered;            // The number of bytes held.
+
+    /******************************************************
+    **                   Helper Methods                  **
+    ******************************************************/
+
+    /** Initialize the object for a digest of the given length.
+     *
+     *  @pre none.
+     *  @post A new object is instantiated with its initial values.
+     *  @param bits The number of bits in the hash (64 or 128).
+    */
+    explicit XXH3_64 (uint32_t bits);
+
+    /** Absorb the held back data into a copy of the accumulators.
+     *
+     *  @pre The message is longer than MIDSIZE_MAX bytes.
+     *  @post The object is unchanged.
+     *  @param acc The array that receives the final accumulators.
+     *  @return none.
+    */
+    void _finishAccumulators (uint64_t acc[8]) const;
+
+    /** Append the algorithm specific part of the midstate.
+     *
+     *  @pre none.
+     *  @post The state is appended to state.
+     *  @param state The state that is being exported.
+     *  @return none.
+    */
+    void _saveState (HashState &state) const;
+
+    /** Restore the algorithm specific part of the midstate.
+     *
+     *  @pre The common header of state has been read and checked.
+     *  @post The object holds the imported state.
+     *  @param state The state that is being imported.
+     *  @return true The values read are consistent.
+     *  @return false The state is corrupt.
+    */
+    bool _loadState (HashState &state);
+
+};  // End class XXH3_64.
+
+/**
+ *  @class XXH3_128 An abstract data type to calculate and
+ *         manipulate 128-bit XXH3 hashes.
+*/
+class XXH3_128 : public XXH3_64
+{
+  public:
+    /******************************************************
+    **            Constructors / Destructors             **
+    ******************************************************/
+
+    /** Default constructor.  */
+    XXH3_128 ();
+
+    /** Copy constructor.
+     *
+     *  @pre none.
+     *  @post A new object is instantiated from the copied XXH3_128 object
+     *        including any partially processed message.
+     *  @param copyFrom The XXH3_128 object whose values are to be copied.
+    */
+    XXH3_128 (const XXH3_128 &copyFrom);
+
+    /** Initialize an XXH3_128 object by hashing an input std::string.
+     *
+     *  @pre none.
+     *  @post A new object is instantiated containing the
+     *        hashed value of the input data.
+     *  @param str The std::string that is to be hashed.
+    */
+    XXH3_128 (const string &str);
+
+    /** Initialize an XXH3_128 object by hashing an input data stream.
+     *
+     *  @pre none.
+     *  @post A new object is instantiated containing the
+     *        hashed value of the input data.
+     *  @param data The data that is to be hashed.
+    */
+    XXH3_128 (const vector < byte_t > &data);
+
+    /** Initialize an XXH3_128 object by hashing an input file stream.
+     *
+     *  @pre none.
+     *  @post A new object is instantiated containing the
+     *        hashed value of the input data.
+     *  @param file A handle to the file that is to be hashed.
+    */
+    XXH3_128 (ifstream &file);
+
+    /** Default destructor.  */
+    ~XXH3_128 ();
+
+    /******************************************************
+    **               Accessors / Mutators                **
+    ******************************************************/
+
+    ////////////////////
+    //    Getters
+    ////////////////////
+
+    /** Retrieve the name of the algorithm.
+     *
+     *  @pre The object is instantiated.
+     *  @post none.
+     *  @return "XXH3-128".
+    */
+    string algorithmName (void) const;
+
+    /** Copy the object, including any partially processed message.
+     *
+     *  @pre none.
+     *  @post The caller owns (and must delete) the copy.
+     *  @return A new XXH3_128 object in the same state.
+    */
+    XXH3_128 * clone (void) const;
+
+    ////////////////////
+    //    Setters
+    ////////////////////
+
+    /** Produce the hash.
+     *
+     *  @pre reset() has been called since the last finalize().
+     *  @post The computed hash is stored in the _hash values.
+     *  @return The hash as a std::string.
+    */
+    string finalize (void);
+
+    /******************************************************
+    **                     Operators                     **
+    ******************************************************/
+
+    /** Assignment from another XXH3_128 object.
+     *
+     *  @pre The object is instantiated.
+     *  @post The object contains the values copied from rhs.
+     *  @param rhs The XXH3_128 object whose values are to be copied/stored.
+     *  @return A reference to the object.
+    */
+    XXH3_128 & operator = (const XXH3_128 &rhs);
+
+};  // End class XXH3_128.
+
+#endif
@@ -0,0 +1,541 @@
+/******************************************************************************
+||  xxh64.cpp                                                                ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    This abstract data type is used to calculate the XXH64 hash of an      ||
+||    input message or data stream.  XXH64 is a fast non-cryptographic       ||
+||    64-bit hash meant for change detection and for bucketing large numbers ||
+||    of files; it must not be used where an adversary can choose the input. ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    hash_abstract.cpp (hash_abstract.lib)                                  ||
+||    hash_abstract.h                                                        ||
+||                                                                           ||
+||===========================================================================||
+||  REFERENCES                                                               ||
+||===========================================================================||
+||    Collet, Y.  "xxHash fast digest algorithm", version 0.1.1.  Oct 2018.  ||
+||        https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md     ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file xxh64.cpp
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+
+#include <string.h>
+
+#include "xxh64.h"
+#include "hash_state.h"
+
+const uint32_t XXH64::STRIPE_BYTES;
+const uint32_t XXH64::FILE_BUFFER_BYTES;
+
+// The five 64-bit primes of XXH64.
+static const uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+static const uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+static const uint64_t PRIME64_3 = 0x165667B19E3779F9ULL;
+static const uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+static const uint64_t PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+static inline uint64_t rotl64 (uint64_t x, uint32_t n)
+{  return ((x << n) | (x >> (64 - n)));  }
+
+static inline uint64_t loadLittleEndian64 (const byte_t *p)
+{
+    // Written out so that the compiler reduces it to a single load.
+    return   ((uint64_t)p[0]      ) | ((uint64_t)p[1] <<  8)
+           | ((uint64_t)p[2] << 16) | ((uint64_t)p[3] << 24)
+           | ((uint64_t)p[4] << 32) | ((uint64_t)p[5] << 40)
+           | ((uint64_t)p[6] << 48) | ((uint64_t)p[7] << 56);
+}
+
+static inline uint32_t loadLittleEndian32 (const byte_t *p)
+{
+    return   ((uint32_t)p[0]      ) | ((uint32_t)p[1] <<  8)
+           | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/** Absorb one 64-bit input into a lane.  */
+static inline uint64_t xxh64Round (uint64_t lane, uint64_t input)
+{
+    lane += input * PRIME64_2;
+    lane = rotl64(lane, 31);
+
+    return lane * PRIME64_1;
+}
+
+/** Fold a lane into the hash.  */
+static inline uint64_t xxh64MergeLane (uint64_t hash, uint64_t lane)
+{
+    hash ^= xxh64Round(0, lane);
+
+    return (hash * PRIME64_1) + PRIME64_4;
+}
+
+/** Absorb whole stripes; the four lanes are independent, so the
+ *  compiler interleaves their multiplies.
+*/
+static void xxh64Stripes (uint64_t lanes[4], const byte_t *data,
+                          uint64_t stripes)
+{
+    uint64_t v1 = lanes[0], v2 = lanes[1], v3 = lanes[2], v4 = lanes[3];
+
+    for (; stripes > 0; --stripes, data += XXH64::STRIPE_BYTES)
+    {
+        v1 = xxh64Round(v1, loadLittleEndian64(data));
+        v2 = xxh64Round(v2, loadLittleEndian64(data +  8));
+        v3 = xxh64Round(v3, loadLittleEndian64(data + 16));
+        v4 = xxh64Round(v4, loadLittleEndian64(data + 24));
+    }
+
+    lanes[0] = v1;
+    lanes[1] = v2;
+    lanes[2] = v3;
+    lanes[3] = v4;
+}
+
+/******************************************************
+**            Constructors / Destructors             **
+******************************************************/
+
+/** Default constructor.  */
+XXH64::XXH64 ()
+    : MessageHash(64),
+      _seed(0)
+{
+    reset();
+}
+
+/** Copy constructor.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated from the copied XXH64 object
+ *        including any partially processed message.
+ *  @param copyFrom The XXH64 object whose values are to be copied.
+*/
+XXH64::XXH64 (const XXH64 &copyFrom)
+    : MessageHash(copyFrom)
+{
+    *this = copyFrom;
+}
+
+/** Initialize an XXH64 object by hashing an input std::string.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated containing the
+ *        hashed value of the input data.
+ *  @param str The std::string that is to be hashed.
+*/
+XXH64::XXH64 (const string &str)
+    : MessageHash(64),
+      _seed(0)
+{
+    calculateHash(str);
+}
+
+/** Initialize an XXH64 object by hashing an input data stream.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated containing the
+ *        hashed value of the input data.
+ *  @param data The data that is to be hashed.
+*/
+XXH64::XXH64 (const vector < byte_t > &data)
+    : MessageHash(64),
+      _seed(0)
+{
+    calculateHash(data);
+}
+
+/** Initialize an XXH64 object by hashing an input file stream.
+ *
+ *  @pre none.
+ *  @post A new object is instantiated containing the
+ *        hashed value of the input data.
+ *  @param file A handle to the file that is to be hashed.
+*/
+XXH64::XXH64 (ifstream &file)
+    : MessageHash(64),
+      _seed(0)
+{
+    calculateHash(file);
+}
+
+/** Default destructor.  */
+XXH64::~XXH64 ()  { }
+
+/******************************************************
+**               Accessors / Mutators                **
+******************************************************/
+
+////////////////////
+//    Getters
+////////////////////
+
+/** Retrieve the name of the algorithm.
+ *
+ *  @pre The object is instantiated.
+ *  @post none.
+ *  @return "XXH64".
+*/
+string XXH64::algorithmName (void) const
+{
+    return "XXH64";
+}
+
+/** Copy the object, including any partially processed message.
+ *
+ *  @pre none.
+ *  @post The caller owns (and must delete) the copy.
+ *  @return A new XXH64 object in the same state.
+*/
+XXH64 * XXH64::clone (void) const
+{
+    return new XXH64(*this);
+}
+
+/** Retrieve the hash as an integer.
+ *
+ *  @pre finalize() has been called.
+ *  @post none.
+ *  @return The 64-bit hash value.
+*/
+uint64_t XXH64::asUint64 (void) const
+{
+    return ((uint64_t)_hash.at(0) << 32) | _hash.at(1);
+}
+
+////////////////////
+//    Setters
+////////////////////
+
+/** Calculate the hash from an input std::string.
+ *
+ *  @pre The object is instantiated.
+ *  @post The computed hash is stored in the _hash values.
+ *  @param str The string whose value is to be hashed.
+ *  @return The hash as a std::string.
+*/
+string XXH64::calculateHash (const string &str)
+{
+    reset();
+    update((const byte_t *)str.data(), str.size());
+
+    return finalize();
+}
+
+/** Calculate the hash from an input data stream.
+ *
+ *  @pre The object is instantiated.
+ *  @post The computed hash is stored in the _hash values.
+ *  @param data The data that is to be hashed.
+ *  @return The hash as a std::string.
+*/
+string XXH64::calculateHash (const vector < byte_t > &data)
+{
+    reset();
+    update(data);
+
+    return finalize();
+}
+
+/** Calculate the hash of a file.
+ *
+ *  @pre The object is instantiated.
+ *  @post The computed hash is stored in the _hash values.
+ *  @param file The file whose hash value is to be calculated.
+ *  @return The hash as a std::string.
+*/
+string XXH64::calculateHash (ifstream &file)
+{
+    reset();
+
+    // Check that the file is valid before doing anything else.
+    // This will return a hash value of all zeros.
+    if (file.fail() || !file.good())
+    {
+        _hash.assign(_hash.size(), 0x00000000);
+        return asString();
+    }
+
+    vector < byte_t > buffer(FILE_BUFFER_BYTES);
+
+    while (file.good())
+    {
+        file.read((char *)&buffer[0], buffer.size());
+        update(&buffer[0], (uint64_t)file.gcount());
+    }
+
+    // Reset the file flags and return to the file head.
+    file.clear();
+    file.seekg(0);  // Return to the head of the file.
+
+    return finalize();
+}
+
+/** Select a seed; differently seeded hashes are unrelated.
+ *
+ *  @pre none.
+ *  @post Any message data is discarded and later hashes use
+ *        the given seed (zero by default).
+ *  @param seed The seed value.
+ *  @return none.
+*/
+void XXH64::setSeed (uint64_t seed)
+{
+    _seed = seed;
+    reset();
+
+    return;
+}
+
+/** Discard any message data and restart the hash.
+ *
+ *  @pre The object is instantiated.
+ *  @post The accumulators hold their initial values.
+ *  @return none.
+*/
+void XXH64::reset (void)
+{
+    _lanes[0] = _seed + PRIME64_1 + PRIME64_2;
+    _lanes[1] = _seed + PRIME64_2;
+    _lanes[2] = _seed;
+    _lanes[3] = _seed - PRIME64_1;
+
+    _length = 0;
+    memset(_stripe, 0, sizeof(_stripe));
+    _buffered = 0;
+
+    return;
+}
+
+/** Append message data to the hash.
+ *
+ *  @pre reset() has been called since the last finalize().
+ *  @post Every whole stripe of the data seen so far has been
+ *        absorbed by the accumulators.
+ *  @param data A pointer to the message data.
+ *  @param length The number of bytes at data.
+ *  @return none.
+*/
+void XXH64::update (const byte_t *data, uint64_t length)
+{
+    _length += length;
+
+    if (_buffered + length < STRIPE_BYTES)
+    {
+        memcpy(_stripe + _buffered, data, (size_t)length);
+        _buffered += (uint32_t)length;
+
+        return;
+    }
+
+    if (_buffered > 0)
+    {
+        uint32_t fill = STRIPE_BYTES - _buffered;
+
+        memcpy(_stripe + _buffered, data, fill);
+        data += fill;
+        length -= fill;
+
+        xxh64Stripes(_lanes, _stripe, 1);
+        _buffered = 0;
+    }
+
+    uint64_t stripes = length / STRIPE_BYTES;
+    xxh64Stripes(_lanes, data, stripes);
+    data += stripes * STRIPE_BYTES;
+    length -= stripes * STRIPE_BYTES;
+
+    memcpy(_stripe, data, (size_t)length);
+    _buffered = (uint32_t)length;
+
+    return;
+}
+
+/** Append message data to the hash.
+ *
+ *  @pre reset() has been called since the last finalize().
+ *  @post The message data has been absorbed.
+ *  @param data The message data.
+ *  @return none.
+*/
+void XXH64::update (const vector < byte_t > &data)
+{
+    if (!data.empty())
+        update(&data[0], data.size());
+
+    return;
+}
+
+/** Fold the accumulators and the buffered tail into the hash.
+ *
+ *  @pre reset() has been called since the last finalize().
+ *  @post The computed hash is stored in the _hash values.
+ *  @return The hash as a std::string.
+*/
+string XXH64::finalize (void)
+{
+    uint64_t hash;
+
+    // Short messages never touch the lanes.
+    if (_length >= STRIPE_BYTES)
+    {
+        hash =   rotl64(_lanes[0],  1) + rotl64(_lanes[1],  7)
+               + rotl64(_lanes[2], 12) + rotl64(_lanes[3], 18);
+
+        for (uint32_t i = 0; i < 4; ++i)
+            hash = xxh64MergeLane(hash, _lanes[i]);
+    }
+    else
+        hash = _seed + PRIME64_5;
+
+    hash += _length;
+
+    const byte_t *p = _stripe;
+    uint32_t remaining = _buffered;
+
+    for (; remaining >= 8; remaining -= 8, p += 8)
+    {
+        hash ^= xxh64Round(0, loadLittleEndian64(p));
+        hash = (rotl64(hash, 27) * PRIME64_1) + PRIME64_4;
+    }
+
+    if (remaining >= 4)
+    {
+        hash ^= (uint64_t)loadLittleEndian32(p) * PRIME64_1;
+        hash = (rotl64(hash, 23) * PRIME64_2) + PRIME64_3;
+        remaining -= 4;
+        p += 4;
+    }
+
+    for (; remaining > 0; --remaining, ++p)
+    {
+        hash ^= (uint64_t)(*p) * PRIME64_5;
+        hash = rotl64(hash, 11) * PRIME64_1;
+    }
+
+    // The final avalanche.
+    hash ^= hash >> 33;
+    hash *= PRIME64_2;
+    hash ^= hash >> 29;
+    hash *= PRIME64_3;
+    hash ^= hash >> 32;
+
+    _hash.at(0) = (uint32_t)(hash >> 32);
+    _hash.at(1) = (uint32_t)hash;
+
+    return asString();
+}
+
+/******************************************************
+**                     Operators                     **
+******************************************************/
+
+/** Assignment from another XXH64 object.
+ *
+ *  @pre The object is instantiated.
+ *  @post The object contains the values copied from rhs.
+ *  @param rhs The XXH64 object whose values are to be copied/stored.
+ *  @return A reference to the object.
+*/
+XXH64 & XXH64::operator = (const XXH64 &rhs)
+{
+    if (this != &rhs)
+    {
+        MessageHash::operator = (rhs);
+
+        _seed = rhs._seed;
+        memcpy(_lanes, rhs._lanes, sizeof(_lanes));
+        _length = rhs._length;
+        memcpy(_stripe, rhs._stripe, sizeof(_stripe));
+        _buffered = rhs._buffered;
+    }
+
+    return *this;
+}
+
+/******************************************************
+**                   Helper Methods                  **
+******************************************************/
+
+/** Append the algorithm specific part of the midstate.
+ *
+ *  @pre none.
+ *  @post The state is appended to state.
+ *  @param state The state that is being exported.
+ *  @return none.
+*/
+void XXH64::_saveState (HashState &state) const
+{
+    state.putWord64(_seed);
+    state.putWords64(_lanes, 4);
+    state.putWord64(_length);
+    state.putWord32(_buffered);
+    state.putBytes(_stripe, _buffered);
+
+    return;
+}
+
+/** Restore the algorithm specific part of the midstate.
+ *
+ *  @pre The common header of state has been read and checked.
+ *  @post The object holds the imported state.
+ *  @param state The state that is being imported.
+ *  @return true The values read are consistent.
+ *  @return false The state is corrupt.
+*/
+bool XXH64::_loadState (HashState &state)
+{
+    uint64_t seed = state.getWord64();
+
+    state.getWords64(_lanes, 4);
+    _length = state.getWord64();
+    _buffered = state.getWord32();
+
+    // A corrupt state leaves the seed of the object alone.
+    if ((_buffered >= STRIPE_BYTES) || ((_length % STRIPE_BYTES) != _buffered))
+        return false;
+
+    _seed = seed;
+    memset(_stripe, 0, sizeof(_stripe));
+    state.getBytes(_stripe, _buffered);
+
+    return true;
+}
\ No newline at end of file
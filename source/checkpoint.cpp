@@ -0,0 +1,372 @@
+/******************************************************************************
+||  checkpoint.cpp                                                           ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    Periodic checkpoints of a long running file hash.  A checkpoint holds  ||
+||    the exported midstate of the hash together with the file offset that   ||
+||    it covers, so that an interrupted job can be resumed from that offset  ||
+||    rather than from the start of the file.                                ||
+||                                                                           ||
+||    A checkpoint also records the size and modification time of the file   ||
+||    that is being hashed and is ignored if either has changed since.       ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    Hashes/hash_abstract.cpp (hash_abstract.lib)                           ||
+||    Hashes/hash_abstract.h                                                 ||
+||    Hashes/hash_state.cpp (hash_state.lib)                                 ||
+||    Hashes/hash_state.h                                                    ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file checkpoint.cpp
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "checkpoint.h"
+#include "Hashes/hash_state.h"
+#include "Hashes/sha256.h"
+
+// The first bytes of every checkpoint file.
+static const char CHECKPOINT_MAGIC[] = "GHCK";
+
+// The length of the checksum (SHA-256) that ends every state file.
+static const size_t CHECKSUM_BYTES = 32;
+
+const uint32_t Checkpoint::VERSION;
+const uint32_t Checkpoint::DEFAULT_INTERVAL;
+const uint32_t Checkpoint::READ_BUFFER_BYTES;
+
+/******************************************************
+**            Constructors / Destructors             **
+******************************************************/
+
+/** Initialize a Checkpoint object.
+ *
+ *  @pre none.
+ *  @post Nothing is read or written until load() or save().
+ *  @param path The checkpoint file.
+ *  @param target The file that is being hashed.
+*/
+Checkpoint::Checkpoint (const string &path, const string &target)
+    : _path(path),
+      _target(target)
+{}
+
+/** Default destructor.  */
+Checkpoint::~Checkpoint ()  { }
+
+/******************************************************
+**               Accessors / Mutators                **
+******************************************************/
+
+////////////////////
+//    Getters
+////////////////////
+
+/** Retrieve the name of the checkpoint file.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return The path of the checkpoint file.
+*/
+const string & Checkpoint::path (void) const
+{
+    return _path;
+}
+
+////////////////////
+//    Setters
+////////////////////
+
+/** Resume a job from the checkpoint file.
+ *
+ *  @pre none.
+ *  @post On success hash holds the midstate of the first offset
+ *        bytes of the target.
+ *  @param hash The hash that is to be resumed.
+ *  @param offset Receives the number of bytes already hashed.
+ *  @return true The job was resumed.
+ *  @return false There is no usable checkpoint (none was written,
+ *          the target has changed since, or it is of another
+ *          algorithm); hash is then reset.
+*/
+bool Checkpoint::load (MessageHash &hash, uint64_t &offset)
+{
+    hash.reset();
+    offset = 0;
+
+    vector < byte_t > bytes;
+    uint64_t size = 0, seconds = 0, nanoseconds = 0;
+
+    if (!readFile(_path, bytes) || !_unseal(bytes)
+        || !_identify(size, seconds, nanoseconds))
+        return false;
+
+    HashState state(bytes);
+    byte_t magic[4];
+    state.getBytes(magic, sizeof(magic));
+
+    bool current = (memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)) == 0)
+                   && (state.getWord32() == VERSION)
+                   && (state.getWord64() == size)
+                   && (state.getWord64() == seconds)
+                   && (state.getWord64() == nanoseconds);
+
+    uint64_t resumeAt = state.getWord64();
+    vector < byte_t > midstate = state.getBlob();
+
+    if (!current || !state.good() || !state.atEnd() || (resumeAt > size))
+        return false;
+
+    if (!hash.importState(midstate))
+    {
+        hash.reset();
+        return false;
+    }
+
+    offset = resumeAt;
+
+    return true;
+}
+
+/** Record the progress of the job.  The file is replaced atomically
+ *  so that an interruption never leaves a torn checkpoint behind.
+ *
+ *  @pre hash has absorbed exactly the first offset bytes of the
+ *       target.
+ *  @post The checkpoint file holds the midstate and offset.
+ *  @param hash The hash of the job.
+ *  @param offset The number of bytes hashed so far.
+ *  @return true The checkpoint was written.
+ *  @return false The checkpoint file could not be written.
+*/
+bool Checkpoint::save (const MessageHash &hash, uint64_t offset)
+{
+    uint64_t size = 0, seconds = 0, nanoseconds = 0;
+    if (!_identify(size, seconds, nanoseconds))
+        return false;
+
+    HashState state;
+    state.putBytes((const byte_t *)CHECKPOINT_MAGIC, 4);
+    state.putWord32(VERSION);
+    state.putWord64(size);
+    state.putWord64(seconds);
+    state.putWord64(nanoseconds);
+    state.putWord64(offset);
+    state.putBlob(hash.exportState());
+
+    vector < byte_t > bytes = state.bytes();
+    _seal(bytes);
+
+    return replaceFile(_path, bytes);
+}
+
+/** Delete the checkpoint file once the job has completed.
+ *
+ *  @pre none.
+ *  @post The checkpoint file no longer exists.
+ *  @return none.
+*/
+void Checkpoint::remove (void)
+{
+    unlink(_path.c_str());
+
+    return;
+}
+
+/******************************************************
+**                   Helper Methods                  **
+******************************************************/
+
+/** Identify the current version of the target.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @param size Receives the size of the target in bytes.
+ *  @param seconds Receives the modification time (seconds).
+ *  @param nanoseconds Receives the fraction of the modification time.
+ *  @return true The target was found.
+ *  @return false The target could not be examined.
+*/
+bool Checkpoint::_identify (uint64_t &size, uint64_t &seconds,
+                            uint64_t &nanoseconds) const
+{
+    struct stat status;
+
+    if (stat(_target.c_str(), &status) != 0)
+        return false;
+
+    size = (uint64_t)status.st_size;
+    seconds = (uint64_t)status.st_mtim.tv_sec;
+    nanoseconds = (uint64_t)status.st_mtim.tv_nsec;
+
+    return true;
+}
+
+/** Append the checksum (SHA-256) of a state file to its bytes.
+ *
+ *  @pre none.
+ *  @post bytes end in the SHA-256 of what they held.
+ *  @param bytes The contents of the file.
+ *  @return none.
+*/
+void Checkpoint::_seal (vector < byte_t > &bytes)
+{
+    SHA256 checksum;
+
+    if (!bytes.empty())
+        checksum.update(&bytes[0], bytes.size());
+    checksum.finalize();
+
+    vector < byte_t > digest = checksum.asBytes();
+    bytes.insert(bytes.end(), digest.begin(), digest.end());
+
+    return;
+}
+
+/** Check and remove the checksum that _seal() appended.
+ *
+ *  @pre none.
+ *  @post On success the checksum is removed from bytes.
+ *  @param bytes The contents of the file.
+ *  @return true The checksum matches.
+ *  @return false The file is torn or corrupt.
+*/
+bool Checkpoint::_unseal (vector < byte_t > &bytes)
+{
+    if (bytes.size() < CHECKSUM_BYTES)
+        return false;
+
+    SHA256 checksum;
+    size_t body = bytes.size() - CHECKSUM_BYTES;
+
+    if (body > 0)
+        checksum.update(&bytes[0], body);
+    checksum.finalize();
+
+    vector < byte_t > digest = checksum.asBytes();
+
+    if (memcmp(&digest[0], &bytes[body], CHECKSUM_BYTES) != 0)
+        return false;
+
+    bytes.resize(body);
+
+    return true;
+}
+
+/******************************************************
+**                  Static Methods                   **
+******************************************************/
+
+/** Read a whole (small) file.  The state files of gash are read
+ *  and written with these helpers.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @param path The file that is to be read.
+ *  @param bytes Receives the contents of the file.
+ *  @return true The file was read.
+ *  @return false The file does not exist or could not be read.
+*/
+bool Checkpoint::readFile (const string &path, vector < byte_t > &bytes)
+{
+    ifstream file(path.c_str(), ios::in | ios::binary);
+    if (file.fail())
+        return false;
+
+    char buffer[4096];
+    bytes.clear();
+
+    while (file.good())
+    {
+        file.read(buffer, sizeof(buffer));
+        bytes.insert(bytes.end(), buffer, buffer + file.gcount());
+    }
+
+    return !file.bad();
+}
+
+/** Replace a file atomically: the bytes are written to a temporary
+ *  file, flushed to disk and renamed over the file, so that a crash
+ *  leaves either the old or the new contents behind.
+ *
+ *  @pre none.
+ *  @post The file holds bytes.
+ *  @param path The file that is to be replaced.
+ *  @param bytes The new contents.
+ *  @return true The file was replaced.
+ *  @return false The file could not be written.
+*/
+bool Checkpoint::replaceFile (const string &path,
+                              const vector < byte_t > &bytes)
+{
+    // The midstate of a keyed hash (HMAC, keyed BLAKE) is as sensitive
+    // as the key, so the file is only readable by its owner.
+    string temporary = path + ".tmp";
+    int fd = open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0)
+        return false;
+
+    size_t written = 0;
+
+    while (written < bytes.size())
+    {
+        ssize_t count = write(fd, &bytes[written], bytes.size() - written);
+        if (count <= 0)
+            break;
+
+        written += (size_t)count;
+    }
+
+    // The data must be on disk before the rename makes it current.
+    bool saved = (written == bytes.size()) && (fsync(fd) == 0);
+    saved = (close(fd) == 0) && saved;
+
+    if (!saved || (rename(temporary.c_str(), path.c_str()) != 0))
+    {
+        unlink(temporary.c_str());
+        return false;
+    }
+
+    return true;
+}
\ No newline at end of file
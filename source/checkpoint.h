@@ -0,0 +1,234 @@
+/******************************************************************************
+||  checkpoint.h                                                             ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    Periodic checkpoints of a long running file hash.  A checkpoint holds  ||
+||    the exported midstate of the hash together with the file offset that   ||
+||    it covers, so that an interrupted job can be resumed from that offset  ||
+||    rather than from the start of the file.                                ||
+||                                                                           ||
+||    A checkpoint also records the size and modification time of the file   ||
+||    that is being hashed and is ignored if either has changed since.  It   ||
+||    ends in the SHA-256 of the bytes before it, and a file whose checksum  ||
+||    does not match is ignored too: the job starts again from byte 0.       ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    Hashes/hash_abstract.cpp (hash_abstract.lib)                           ||
+||    Hashes/hash_abstract.h                                                 ||
+||    Hashes/hash_state.cpp (hash_state.lib)                                 ||
+||    Hashes/hash_state.h                                                    ||
+||    Hashes/sha256.cpp (sha256.lib)                                         ||
+||    Hashes/sha256.h                                                        ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file checkpoint.h
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+#ifndef _GH_CHECKPOINT_DEF_H
+#define _GH_CHECKPOINT_DEF_H
+
+#include "Hashes/hash_abstract.h"
+
+/**
+ *  @class Checkpoint The checkpoint file of one hashing job.
+*/
+class Checkpoint
+{
+  public:
+    /******************************************************
+    **                     Constants                     **
+    ******************************************************/
+
+    /// The layout version of the file; other versions are ignored.
+    static const uint32_t VERSION = 1;
+
+    /// The default number of seconds between checkpoints.
+    static const uint32_t DEFAULT_INTERVAL = 60;
+
+    /// The size of the reads of a checkpointed job (large enough to keep
+    /// the threaded tree hashes busy).
+    static const uint32_t READ_BUFFER_BYTES = 16 * 1024 * 1024;
+
+    /******************************************************
+    **            Constructors / Destructors             **
+    ******************************************************/
+
+    /** Initialize a Checkpoint object.
+     *
+     *  @pre none.
+     *  @post Nothing is read or written until load() or save().
+     *  @param path The checkpoint file.
+     *  @param target The file that is being hashed.
+    */
+    Checkpoint (const string &path, const string &target);
+
+    /** Default destructor.  */
+    ~Checkpoint ();
+
+    /******************************************************
+    **               Accessors / Mutators                **
+    ******************************************************/
+
+    ////////////////////
+    //    Getters
+    ////////////////////
+
+    /** Retrieve the name of the checkpoint file.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return The path of the checkpoint file.
+    */
+    const string & path (void) const;
+
+    ////////////////////
+    //    Setters
+    ////////////////////
+
+    /** Resume a job from the checkpoint file.
+     *
+     *  @pre none.
+     *  @post On success hash holds the midstate of the first offset
+     *        bytes of the target.
+     *  @param hash The hash that is to be resumed.
+     *  @param offset Receives the number of bytes already hashed.
+     *  @return true The job was resumed.
+     *  @return false There is no usable checkpoint (none was written,
+     *          the target has changed since, or it is of another
+     *          algorithm); hash is then reset.
+    */
+    bool load (MessageHash &hash, uint64_t &offset);
+
+    /** Record the progress of the job.  The file is replaced atomically
+     *  so that an interruption never leaves a torn checkpoint behind.
+     *
+     *  @pre hash has absorbed exactly the first offset bytes of the
+     *       target.
+     *  @post The checkpoint file holds the midstate and offset.
+     *  @param hash The hash of the job.
+     *  @param offset The number of bytes hashed so far.
+     *  @return true The checkpoint was written.
+     *  @return false The checkpoint file could not be written.
+    */
+    bool save (const MessageHash &hash, uint64_t offset);
+
+    /** Delete the checkpoint file once the job has completed.
+     *
+     *  @pre none.
+     *  @post The checkpoint file no longer exists.
+     *  @return none.
+    */
+    void remove (void);
+
+    /******************************************************
+    **                  Static Methods                   **
+    ******************************************************/
+
+    /** Read a whole (small) file.  The state files of gash are read
+     *  and written with these helpers.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @param path The file that is to be read.
+     *  @param bytes Receives the contents of the file.
+     *  @return true The file was read.
+     *  @return false The file does not exist or could not be read.
+    */
+    static bool readFile (const string &path, vector < byte_t > &bytes);
+
+    /** Replace a file atomically: the bytes are written to a temporary
+     *  file, flushed to disk and renamed over the file, so that a crash
+     *  leaves either the old or the new contents behind.
+     *
+     *  @pre none.
+     *  @post The file holds bytes.
+     *  @param path The file that is to be replaced.
+     *  @param bytes The new contents.
+     *  @return true The file was replaced.
+     *  @return false The file could not be written.
+    */
+    static bool replaceFile (const string &path,
+                             const vector < byte_t > &bytes);
+
+  protected:
+    /******************************************************
+    **                      Members                      **
+    ******************************************************/
+    string _path;     // The checkpoint file.
+    string _target;   // The file that is being hashed.
+
+    /******************************************************
+    **                   Helper Methods                  **
+    ******************************************************/
+
+    /** Identify the current version of the target.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @param size Receives the size of the target in bytes.
+     *  @param seconds Receives the modification time (seconds).
+     *  @param nanoseconds Receives the fraction of the modification time.
+     *  @return true The target was found.
+     *  @return false The target could not be examined.
+    */
+    bool _identify (uint64_t &size, uint64_t &seconds,
+                    uint64_t &nanoseconds) const;
+
+    /** Append the checksum (SHA-256) of a state file to its bytes.
+     *
+     *  @pre none.
+     *  @post bytes end in the SHA-256 of what they held.
+     *  @param bytes The contents of the file.
+     *  @return none.
+    */
+    static void _seal (vector < byte_t > &bytes);
+
+    /** Check and remove the checksum that _seal() appended.
+     *
+     *  @pre none.
+     *  @post On success the checksum is removed from bytes.
+     *  @param bytes The contents of the file.
+     *  @return true The checksum matches.
+     *  @return false The file is torn or corrupt.
+    */
+    static bool _unseal (vector < byte_t > &bytes);
+
+};  // End class Checkpoint.
+
+#endif
\ No newline at end of file
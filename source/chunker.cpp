@@ -0,0 +1,645 @@
+/******************************************************************************
+||  chunker.cpp                                                              ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    A content-defined chunker for deduplication.  A Gear rolling hash over ||
+||    the last 64 bytes of the stream selects the chunk boundaries, with the ||
+||    normalized chunking of FastCDC: below the average size a boundary      ||
+||    needs more zero bits than above it, which narrows the spread of the    ||
+||    chunk sizes.  The bytes before the minimum size are skipped, and every ||
+||    chunk is cut at the maximum size.                                      ||
+||                                                                           ||
+||    The files are read in large blocks.  The boundaries of each block are  ||
+||    found on the calling thread (with an AVX-512 scanning kernel where the ||
+||    host has one), and the strong digests of its chunks are then computed  ||
+||    on a pool of threads.                                                  ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    chunker.h                                                              ||
+||    Hashes/cpu_features.cpp (cpu_features.lib)                             ||
+||    Hashes/cpu_features.h                                                  ||
+||    Hashes/hash_abstract.cpp (hash_abstract.lib)                           ||
+||    Hashes/hash_abstract.h                                                 ||
+||    pthread                                                                ||
+||                                                                           ||
+||===========================================================================||
+||  REFERENCES                                                               ||
+||===========================================================================||
+||    Xia, W. et al.  "FastCDC: a Fast and Efficient Content-Defined         ||
+||        Chunking Approach for Data Deduplication", USENIX ATC 2016.        ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file chunker.cpp
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "chunker.h"
+#include "Hashes/cpu_features.h"
+
+#ifdef GASH_X86_SIMD
+  #include <immintrin.h>
+#endif
+
+const uint32_t Chunker::DEFAULT_MIN_BYTES;
+const uint32_t Chunker::DEFAULT_AVERAGE_BYTES;
+const uint32_t Chunker::DEFAULT_MAX_BYTES;
+const uint32_t Chunker::WINDOW_BYTES;
+const uint32_t Chunker::MAX_CHUNK_BYTES;
+const uint32_t Chunker::READ_BUFFER_BYTES;
+
+/**
+ *  @struct GearTable The random value that the Gear hash adds for each
+ *          byte.  The values come from SplitMix64 (seeded with zero);
+ *          changing them would move every chunk boundary.
+*/
+struct GearTable
+{
+    uint64_t values[256];
+
+    GearTable ()
+    {
+        uint64_t state = 0;
+
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            state += 0x9E3779B97F4A7C15ULL;
+
+            uint64_t z = state;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            values[i] = z ^ (z >> 31);
+        }
+    }
+};
+
+static const uint64_t * gearTable (void)
+{
+    static const GearTable table;
+    return table.values;
+}
+
+/** A mask of the top bits of the hash.  The high bits of a Gear hash
+ *  depend on the most bytes of the window.  */
+static uint64_t topBits (uint32_t bits)
+{
+    return (bits == 0) ? 0 : (~0ULL << (64 - bits));
+}
+
+/**
+ *  @struct DigestJob The chunks of a block shared by the digest threads.
+*/
+struct Chunker::DigestJob
+{
+    const byte_t *buffer;           // The block.
+    uint64_t bufferOffset;          // The position of buffer[0].
+    vector < Chunk > *chunks;
+    const MessageHash *prototype;
+
+    pthread_mutex_t lock;           // Guards next.
+    size_t next;                    // The next chunk to digest.
+};
+
+/******************************************************
+**                  Scanning Kernels                 **
+******************************************************/
+
+// A scanning kernel returns the first position i in [from, to) whose
+// window hash (of bytes i - 63 through i) has no bit of mask set, or to if
+// there is none.  The hash at i is sum(gear[data[i - j]] << j) over the
+// window, so the kernels start 63 bytes before from.
+typedef size_t (*GearScanKernel)(const byte_t *data, size_t from, size_t to,
+                                 uint64_t mask);
+
+/** The portable scanning kernel.  */
+static size_t gearScanPortable (const byte_t *data, size_t from, size_t to,
+                                uint64_t mask)
+{
+    const uint64_t *gear = gearTable();
+    uint64_t hash = 0;
+
+    for (size_t i = from - (Chunker::WINDOW_BYTES - 1); i < from; ++i)
+        hash = (hash << 1) + gear[data[i]];
+
+    for (size_t i = from; i < to; ++i)
+    {
+        hash = (hash << 1) + gear[data[i]];
+
+        if ((hash & mask) == 0)
+            return i;
+    }
+
+    return to;
+}
+
+#ifdef GASH_X86_SIMD
+
+/** The AVX-512 scanning kernel: the hashes of eight consecutive
+ *  positions per step.  With g the gathered table values, the hash at
+ *  position n is (hash[n - 8] << 8) + sum(g[n - j] << j) for j < 8, and
+ *  that sum is built from g in three shift-and-add steps (over 1, 2 and
+ *  4 positions), each of which borrows the last lanes of the previous
+ *  step's vector.  */
+__attribute__((target("avx512f,avx512vl,avx512bw")))
+static size_t gearScanAVX512 (const byte_t *data, size_t from, size_t to,
+                              uint64_t mask)
+{
+    const uint64_t *gear = gearTable();
+
+    if (to - from < 8)
+        return gearScanPortable(data, from, to, mask);
+
+    // Seed the lanes with the eight positions before from.  Bytes before
+    // the warm up would be more than 64 positions from any tested hash.
+    uint64_t hash = 0;
+    uint64_t lanes[8], sums1[8], sums2[8], sums4[8];
+
+    for (size_t i = from - (Chunker::WINDOW_BYTES - 1); i < from; ++i)
+    {
+        hash = (hash << 1) + gear[data[i]];
+
+        if (i >= from - 8)
+            lanes[i - (from - 8)] = hash;
+    }
+
+    for (uint32_t k = 0; k < 8; ++k)
+    {
+        const byte_t *p = data + from - 8 + k;
+
+        sums1[k] = gear[p[0]];
+        sums2[k] = sums1[k] + (gear[p[-1]] << 1);
+        sums4[k] = sums2[k] + ((gear[p[-2]] + (gear[p[-3]] << 1)) << 2);
+    }
+
+    __m512i h = _mm512_loadu_si512(lanes);
+    __m512i g1 = _mm512_loadu_si512(sums1);
+    __m512i g2 = _mm512_loadu_si512(sums2);
+    __m512i g4 = _mm512_loadu_si512(sums4);
+    __m512i bits = _mm512_set1_epi64((long long)mask);
+
+    size_t i = from;
+    for (; i + 8 <= to; i += 8)
+    {
+        __m128i bytes = _mm_loadl_epi64((const __m128i *)(data + i));
+        __m512i g = _mm512_i64gather_epi64(_mm512_cvtepu8_epi64(bytes),
+                                           (const long long *)gear, 8);
+
+        __m512i s2 = _mm512_add_epi64(g, _mm512_slli_epi64(
+                         _mm512_alignr_epi64(g, g1, 7), 1));
+        __m512i s4 = _mm512_add_epi64(s2, _mm512_slli_epi64(
+                         _mm512_alignr_epi64(s2, g2, 6), 2));
+        __m512i s8 = _mm512_add_epi64(s4, _mm512_slli_epi64(
+                         _mm512_alignr_epi64(s4, g4, 4), 4));
+
+        h = _mm512_add_epi64(_mm512_slli_epi64(h, 8), s8);
+
+        __mmask8 zero = _mm512_testn_epi64_mask(h, bits);
+        if (zero != 0)
+            return i + __builtin_ctz(zero);
+
+        g1 = g;
+        g2 = s2;
+        g4 = s4;
+    }
+
+    _mm512_storeu_si512(lanes, h);
+    hash = lanes[7];
+
+    for (; i < to; ++i)
+    {
+        hash = (hash << 1) + gear[data[i]];
+
+        if ((hash & mask) == 0)
+            return i;
+    }
+
+    return to;
+}
+
+#endif  // GASH_X86_SIMD
+
+/** Choose the fastest scanning kernel that the host supports.  AVX2
+ *  kernels (four lanes per gather) were measured to be no faster than
+ *  the portable loop, so there is none.  */
+static GearScanKernel selectGearScanKernel (void)
+{
+#ifdef GASH_X86_SIMD
+    if (CPUFeatures::has(CPUFeatures::AVX512))
+        return gearScanAVX512;
+#endif
+
+    return gearScanPortable;
+}
+
+static GearScanKernel gearScanKernel (void)
+{
+    static const GearScanKernel kernel = selectGearScanKernel();
+    return kernel;
+}
+
+/******************************************************
+**            Constructors / Destructors             **
+******************************************************/
+
+/** Initialize a Chunker object.
+ *
+ *  @pre validSizes(minBytes, averageBytes, maxBytes).
+ *  @post The digests are computed with clones of prototype, on one
+ *        thread per online processor.
+ *  @param prototype A (reset) hash object of the digest algorithm;
+ *         it is copied.
+ *  @param minBytes The smallest chunk (other than the last).
+ *  @param averageBytes The intended average chunk size.
+ *  @param maxBytes The largest chunk.
+*/
+Chunker::Chunker (const MessageHash &prototype, uint32_t minBytes,
+                  uint32_t averageBytes, uint32_t maxBytes)
+    : _prototype(prototype.clone()),
+      _min(minBytes),
+      _average(averageBytes),
+      _max(maxBytes),
+      _threads(1),
+      _file(NULL),
+      _bufferBytes(0),
+      _chunkedBytes(0),
+      _bufferOffset(0),
+      _eof(true),
+      _failed(false),
+      _nextChunk(0)
+{
+    // Normalized chunking: two more mask bits than log2(average) below
+    // the average size and two fewer above it.
+    uint32_t bits = 0;
+    while ((2ULL << bits) <= _average)
+        ++bits;
+
+    _maskSmall = topBits(bits + 2);
+    _maskLarge = topBits((bits > 2) ? (bits - 2) : 0);
+
+    setThreads(0);
+}
+
+/** Default destructor.  */
+Chunker::~Chunker ()
+{
+    delete _prototype;
+}
+
+/******************************************************
+**               Accessors / Mutators                **
+******************************************************/
+
+////////////////////
+//    Getters
+////////////////////
+
+/** Retrieve the minimum chunk size.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return The size in bytes.
+*/
+uint32_t Chunker::minBytes (void) const
+{
+    return _min;
+}
+
+/** Retrieve the average chunk size.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return The size in bytes.
+*/
+uint32_t Chunker::averageBytes (void) const
+{
+    return _average;
+}
+
+/** Retrieve the maximum chunk size.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return The size in bytes.
+*/
+uint32_t Chunker::maxBytes (void) const
+{
+    return _max;
+}
+
+/** Retrieve the number of threads that compute the digests.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return The number of threads.
+*/
+uint32_t Chunker::threads (void) const
+{
+    return _threads;
+}
+
+/** Determine whether reading the stream failed.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return true next() stopped on a read error.
+ *  @return false The stream was read to its end (so far).
+*/
+bool Chunker::failed (void) const
+{
+    return _failed;
+}
+
+////////////////////
+//    Setters
+////////////////////
+
+/** Select the number of threads that compute the digests.
+ *
+ *  @pre none.
+ *  @post Subsequent blocks use the given number of threads.
+ *  @param threads The number of threads; zero selects one thread for
+ *         each online processor.
+ *  @return none.
+*/
+void Chunker::setThreads (uint32_t threads)
+{
+    if (threads == 0)
+    {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (online > 0) ? (uint32_t)online : 1;
+    }
+
+    _threads = threads;
+
+    return;
+}
+
+/******************************************************
+**                      Methods                      **
+******************************************************/
+
+/** Begin to chunk a stream.
+ *
+ *  @pre file is open in binary mode and outlives the chunking.
+ *  @post The stream is read from its current position by next().
+ *  @param file The stream.
+ *  @return none.
+*/
+void Chunker::start (ifstream &file)
+{
+    _file = &file;
+    _buffer.resize(READ_BUFFER_BYTES);
+    _bufferBytes = 0;
+    _chunkedBytes = 0;
+    _bufferOffset = 0;
+    _eof = false;
+    _failed = false;
+    _chunks.clear();
+    _nextChunk = 0;
+
+    return;
+}
+
+/** Retrieve the next chunk of the stream.
+ *
+ *  @pre start() was called.
+ *  @post The chunk is consumed.
+ *  @param chunk Receives the chunk and its digest.
+ *  @return true A chunk was produced.
+ *  @return false The stream is exhausted (or failed()).
+*/
+bool Chunker::next (Chunk &chunk)
+{
+    if ((_nextChunk == _chunks.size()) && !_nextBlock())
+        return false;
+
+    chunk.offset = _chunks[_nextChunk].offset;
+    chunk.length = _chunks[_nextChunk].length;
+    chunk.digest.swap(_chunks[_nextChunk].digest);
+    ++_nextChunk;
+
+    return true;
+}
+
+/** Find the end of the chunk that starts at data.
+ *
+ *  @pre data holds length bytes, which are at least maxBytes() or
+ *       the rest of the stream.
+ *  @post none.
+ *  @param data The start of the chunk.
+ *  @param length The number of bytes available.
+ *  @return The length of the chunk.
+*/
+uint32_t Chunker::cut (const byte_t *data, size_t length) const
+{
+    if (length <= _min)
+        return (uint32_t)length;
+
+    size_t limit = (length < _max) ? length : _max;
+    size_t normal = (_average < limit) ? _average : limit;
+    GearScanKernel scan = gearScanKernel();
+
+    // A chunk of n bytes ends at position n - 1.
+    size_t end = scan(data, _min - 1, normal - 1, _maskSmall);
+    if (end == normal - 1)
+        end = scan(data, normal - 1, limit, _maskLarge);
+
+    return (uint32_t)((end < limit) ? (end + 1) : limit);
+}
+
+/******************************************************
+**                  Static Methods                   **
+******************************************************/
+
+/** Determine whether a set of chunk sizes is usable.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @param minBytes The smallest chunk.
+ *  @param averageBytes The intended average chunk size.
+ *  @param maxBytes The largest chunk.
+ *  @return true WINDOW_BYTES <= min <= average <= max and max does
+ *          not exceed MAX_CHUNK_BYTES.
+ *  @return false The sizes are out of order or out of range.
+*/
+bool Chunker::validSizes (uint32_t minBytes, uint32_t averageBytes,
+                          uint32_t maxBytes)
+{
+    return (minBytes >= WINDOW_BYTES) && (minBytes <= averageBytes)
+           && (averageBytes <= maxBytes) && (maxBytes <= MAX_CHUNK_BYTES);
+}
+
+/******************************************************
+**                   Helper Methods                  **
+******************************************************/
+
+/** Read the next block and split it into chunks.
+ *
+ *  @pre Every chunk of the previous block has been returned.
+ *  @post _chunks holds the digested chunks of the block.
+ *  @return true At least one chunk was produced.
+ *  @return false The stream is exhausted or failed.
+*/
+bool Chunker::_nextBlock (void)
+{
+    if ((_file == NULL) || _failed)
+        return false;
+
+    // The bytes after the last cut begin the next chunk.
+    size_t kept = _bufferBytes - _chunkedBytes;
+    if (kept > 0)
+        memmove(&_buffer[0], &_buffer[_chunkedBytes], kept);
+
+    _bufferOffset += _chunkedBytes;
+    _bufferBytes = kept;
+    _chunkedBytes = 0;
+    _chunks.clear();
+    _nextChunk = 0;
+
+    while (!_eof && (_bufferBytes < _buffer.size()))
+    {
+        _file->read((char *)&_buffer[_bufferBytes],
+                    _buffer.size() - _bufferBytes);
+        _bufferBytes += (size_t)_file->gcount();
+
+        if (_file->eof())
+            _eof = true;
+        else if (_file->fail())
+        {
+            _failed = true;
+            return false;
+        }
+    }
+
+    // Cut until a chunk might run past the block.
+    while (_chunkedBytes < _bufferBytes)
+    {
+        size_t remaining = _bufferBytes - _chunkedBytes;
+        if (!_eof && (remaining < _max))
+            break;
+
+        Chunk chunk;
+        chunk.offset = _bufferOffset + _chunkedBytes;
+        chunk.length = cut(&_buffer[_chunkedBytes], remaining);
+
+        _chunks.push_back(chunk);
+        _chunkedBytes += chunk.length;
+    }
+
+    if (_chunks.empty())
+        return false;
+
+    _digestBlock();
+
+    return true;
+}
+
+/** Compute the digests of _chunks in parallel.
+ *
+ *  @pre The bytes of each chunk are in _buffer.
+ *  @post The digest of each chunk is set.
+ *  @return none.
+*/
+void Chunker::_digestBlock (void)
+{
+    DigestJob job;
+    job.buffer = &_buffer[0];
+    job.bufferOffset = _bufferOffset;
+    job.chunks = &_chunks;
+    job.prototype = _prototype;
+    job.next = 0;
+    pthread_mutex_init(&job.lock, NULL);
+
+    // This thread is one of the workers.
+    uint32_t threads = (_threads < _chunks.size()) ? _threads
+                                                   : (uint32_t)_chunks.size();
+    vector < pthread_t > workers(threads);
+    vector < bool > started(threads, false);
+
+    for (uint32_t t = 1; t < threads; ++t)
+        started[t] = (pthread_create(&workers[t], NULL, _worker, &job) == 0);
+
+    _worker(&job);
+
+    for (uint32_t t = 1; t < threads; ++t)
+    {
+        if (started[t])
+            pthread_join(workers[t], NULL);
+    }
+
+    pthread_mutex_destroy(&job.lock);
+
+    return;
+}
+
+/******************************************************
+**                  Static Methods                   **
+******************************************************/
+
+/** The body of each thread of _digestBlock().  */
+void * Chunker::_worker (void *arg)
+{
+    DigestJob *job = (DigestJob *)arg;
+    MessageHash *hash = job->prototype->clone();
+
+    for (;;)
+    {
+        pthread_mutex_lock(&job->lock);
+        size_t next = job->next++;
+        pthread_mutex_unlock(&job->lock);
+
+        if (next >= job->chunks->size())
+            break;
+
+        Chunk &chunk = (*job->chunks)[next];
+
+        hash->reset();
+        hash->update(job->buffer + (chunk.offset - job->bufferOffset),
+                     chunk.length);
+        hash->finalize();
+        chunk.digest = hash->asBytes();
+    }
+
+    delete hash;
+
+    return NULL;
+}
\ No newline at end of file
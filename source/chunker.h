@@ -0,0 +1,308 @@
+/******************************************************************************
+||  chunker.h                                                                ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    A content-defined chunker for deduplication.  A Gear rolling hash over ||
+||    the last 64 bytes of the stream selects the chunk boundaries, with the ||
+||    normalized chunking of FastCDC: below the average size a boundary      ||
+||    needs more zero bits than above it, which narrows the spread of the    ||
+||    chunk sizes.  The bytes before the minimum size are skipped, and every ||
+||    chunk is cut at the maximum size.                                      ||
+||                                                                           ||
+||    The files are read in large blocks.  The boundaries of each block are  ||
+||    found on the calling thread (with an AVX-512 scanning kernel where the ||
+||    host has one), and the strong digests of its chunks are then computed  ||
+||    on a pool of threads.                                                  ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    Hashes/cpu_features.cpp (cpu_features.lib)                             ||
+||    Hashes/cpu_features.h                                                  ||
+||    Hashes/hash_abstract.cpp (hash_abstract.lib)                           ||
+||    Hashes/hash_abstract.h                                                 ||
+||    pthread                                                                ||
+||                                                                           ||
+||===========================================================================||
+||  REFERENCES                                                               ||
+||===========================================================================||
+||    Xia, W. et al.  "FastCDC: a Fast and Efficient Content-Defined         ||
+||        Chunking Approach for Data Deduplication", USENIX ATC 2016.        ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file chunker.h
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+
+#ifndef _GH_CHUNKER_DEF_H
+#define _GH_CHUNKER_DEF_H
+
+#include "Hashes/hash_abstract.h"
+
+/**
+ *  @class Chunker Splits a stream into content-defined chunks.
+*/
+class Chunker
+{
+  public:
+    /******************************************************
+    **                     Constants                     **
+    ******************************************************/
+
+    /// The default minimum, average and maximum chunk sizes.
+    static const uint32_t DEFAULT_MIN_BYTES = 16384;
+    static const uint32_t DEFAULT_AVERAGE_BYTES = 65536;
+    static const uint32_t DEFAULT_MAX_BYTES = 262144;
+
+    /// The bytes that the rolling hash covers (the smallest minimum).
+    static const uint32_t WINDOW_BYTES = 64;
+
+    /// The largest maximum chunk size.
+    static const uint32_t MAX_CHUNK_BYTES = 4194304;
+
+    /// The size of the blocks that the stream is read in.
+    static const uint32_t READ_BUFFER_BYTES = 16777216;
+
+    /**
+     *  @struct Chunk A chunk of the stream.
+    */
+    struct Chunk
+    {
+        uint64_t offset;            // The position in the stream.
+        uint32_t length;            // The number of bytes.
+        vector < byte_t > digest;   // The strong digest of the bytes.
+    };
+
+    /******************************************************
+    **            Constructors / Destructors             **
+    ******************************************************/
+
+    /** Initialize a Chunker object.
+     *
+     *  @pre validSizes(minBytes, averageBytes, maxBytes).
+     *  @post The digests are computed with clones of prototype, on one
+     *        thread per online processor.
+     *  @param prototype A (reset) hash object of the digest algorithm;
+     *         it is copied.
+     *  @param minBytes The smallest chunk (other than the last).
+     *  @param averageBytes The intended average chunk size.
+     *  @param maxBytes The largest chunk.
+    */
+    Chunker (const MessageHash &prototype,
+             uint32_t minBytes = DEFAULT_MIN_BYTES,
+             uint32_t averageBytes = DEFAULT_AVERAGE_BYTES,
+             uint32_t maxBytes = DEFAULT_MAX_BYTES);
+
+    /** Default destructor.  */
+    ~Chunker ();
+
+    /******************************************************
+    **               Accessors / Mutators                **
+    ******************************************************/
+
+    ////////////////////
+    //    Getters
+    ////////////////////
+
+    /** Retrieve the minimum chunk size.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return The size in bytes.
+    */
+    uint32_t minBytes (void) const;
+
+    /** Retrieve the average chunk size.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return The size in bytes.
+    */
+    uint32_t averageBytes (void) const;
+
+    /** Retrieve the maximum chunk size.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return The size in bytes.
+    */
+    uint32_t maxBytes (void) const;
+
+    /** Retrieve the number of threads that compute the digests.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return The number of threads.
+    */
+    uint32_t threads (void) const;
+
+    /** Determine whether reading the stream failed.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return true next() stopped on a read error.
+     *  @return false The stream was read to its end (so far).
+    */
+    bool failed (void) const;
+
+    ////////////////////
+    //    Setters
+    ////////////////////
+
+    /** Select the number of threads that compute the digests.
+     *
+     *  @pre none.
+     *  @post Subsequent blocks use the given number of threads.
+     *  @param threads The number of threads; zero selects one thread for
+     *         each online processor.
+     *  @return none.
+    */
+    void setThreads (uint32_t threads);
+
+    /******************************************************
+    **                      Methods                      **
+    ******************************************************/
+
+    /** Begin to chunk a stream.
+     *
+     *  @pre file is open in binary mode and outlives the chunking.
+     *  @post The stream is read from its current position by next().
+     *  @param file The stream.
+     *  @return none.
+    */
+    void start (ifstream &file);
+
+    /** Retrieve the next chunk of the stream.
+     *
+     *  @pre start() was called.
+     *  @post The chunk is consumed.
+     *  @param chunk Receives the chunk and its digest.
+     *  @return true A chunk was produced.
+     *  @return false The stream is exhausted (or failed()).
+    */
+    bool next (Chunk &chunk);
+
+    /** Find the end of the chunk that starts at data.
+     *
+     *  @pre data holds length bytes, which are at least maxBytes() or
+     *       the rest of the stream.
+     *  @post none.
+     *  @param data The start of the chunk.
+     *  @param length The number of bytes available.
+     *  @return The length of the chunk.
+    */
+    uint32_t cut (const byte_t *data, size_t length) const;
+
+    /******************************************************
+    **                  Static Methods                   **
+    ******************************************************/
+
+    /** Determine whether a set of chunk sizes is usable.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @param minBytes The smallest chunk.
+     *  @param averageBytes The intended average chunk size.
+     *  @param maxBytes The largest chunk.
+     *  @return true WINDOW_BYTES <= min <= average <= max and max does
+     *          not exceed MAX_CHUNK_BYTES.
+     *  @return false The sizes are out of order or out of range.
+    */
+    static bool validSizes (uint32_t minBytes, uint32_t averageBytes,
+                            uint32_t maxBytes);
+
+  private:
+    /******************************************************
+    **                      Members                      **
+    ******************************************************/
+
+    struct DigestJob;               // The shared state of _digestBlock().
+
+    MessageHash *_prototype;        // The digest algorithm.
+    uint32_t _min;                  // The chunk sizes.
+    uint32_t _average;
+    uint32_t _max;
+    uint64_t _maskSmall;            // The boundary masks below and above
+    uint64_t _maskLarge;            // the average size.
+    uint32_t _threads;              // The threads that compute digests.
+
+    ifstream *_file;                // The stream being chunked.
+    vector < byte_t > _buffer;      // The current block of the stream.
+    size_t _bufferBytes;            // The valid bytes of _buffer.
+    size_t _chunkedBytes;           // The bytes of _buffer in _chunks.
+    uint64_t _bufferOffset;         // The position of _buffer[0].
+    bool _eof;                      // The stream has been read to its end.
+    bool _failed;                   // Reading the stream failed.
+
+    vector < Chunk > _chunks;       // The chunks of the current block.
+    size_t _nextChunk;              // The next of _chunks to return.
+
+    // Not copyable (owns _prototype).
+    Chunker (const Chunker &);
+    Chunker & operator = (const Chunker &);
+
+    /******************************************************
+    **                   Helper Methods                  **
+    ******************************************************/
+
+    /** Read the next block and split it into chunks.
+     *
+     *  @pre Every chunk of the previous block has been returned.
+     *  @post _chunks holds the digested chunks of the block.
+     *  @return true At least one chunk was produced.
+     *  @return false The stream is exhausted or failed.
+    */
+    bool _nextBlock (void);
+
+    /** Compute the digests of _chunks in parallel.
+     *
+     *  @pre The bytes of each chunk are in _buffer.
+     *  @post The digest of each chunk is set.
+     *  @return none.
+    */
+    void _digestBlock (void);
+
+    /******************************************************
+    **                  Static Methods                   **
+    ******************************************************/
+
+    /** The body of each thread of _digestBlock().  */
+    static void * _worker (void *arg);
+
+};  // End class Chunker.
+
+#endif
\ No newline at end of file
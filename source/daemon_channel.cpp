@@ -0,0 +1,374 @@
+/******************************************************************************
+||  daemon_channel.cpp                                                       ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    The protocol between the hashing daemon (gash daemon, or gashd) and its||
+||    clients.  The two ends exchange frames over a Unix domain socket: each ||
+||    frame is its length (a 32-bit little-endian word) and its bytes, which ||
+||    are written and read with HashState.                                   ||
+||                                                                           ||
+||    A client sends a request: the version of the protocol, the flags (the  ||
+||    cache options and --direct), the hash flag, its working directory, the ||
+||    byte ranges and the paths.  The daemon accepts it (with its version) or||
+||    refuses it, and then replies with a record per file, digest, range or  ||
+||    message, in the order of the request, and a final record that carries  ||
+||    the exit status.  A connection can carry one request after another.    ||
+||                                                                           ||
+||    Frames are queued and sent in batches, so that a reply of many small   ||
+||    records costs few system calls.                                        ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    Hashes/hash_state.cpp                                                  ||
+||    Hashes/hash_state.h                                                    ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file daemon_channel.cpp
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include <sstream>
+
+#include "daemon_channel.h"
+
+const uint32_t DaemonChannel::VERSION;
+const uint32_t DaemonChannel::MAX_FRAME_BYTES;
+const uint32_t DaemonChannel::NO_CACHE;
+const uint32_t DaemonChannel::VERIFY_CACHE;
+const uint32_t DaemonChannel::DIRECT;
+
+// The queued frames are sent once there are this many bytes of them.
+static const size_t SEND_BYTES = 65536;
+
+/******************************************************
+**            Constructors / Destructors             **
+******************************************************/
+
+/** Initialize a DaemonChannel object.
+ *
+ *  @pre none.
+ *  @post The channel owns fd (if any) and closes it.
+ *  @param fd A connected socket, or -1.
+*/
+DaemonChannel::DaemonChannel (int fd)
+    : _fd(fd)
+{}
+
+/** Default destructor (closes the socket).  */
+DaemonChannel::~DaemonChannel ()
+{
+    if (_fd >= 0)
+        close(_fd);
+}
+
+/******************************************************
+**                      Methods                      **
+******************************************************/
+
+/** Connect to the daemon (of this user only).
+ *
+ *  @pre none.
+ *  @post On success the channel is connected.
+ *  @param path The socket of the daemon.
+ *  @return true The daemon accepted the connection.
+ *  @return false No daemon is listening on path, or the one that is
+ *          runs as another user.
+*/
+bool DaemonChannel::connect (const string &path)
+{
+    struct sockaddr_un address;
+
+    if (path.size() >= sizeof(address.sun_path))
+        return false;
+
+    if (_fd >= 0)
+        close(_fd);
+
+    _fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (_fd < 0)
+        return false;
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    memcpy(address.sun_path, path.c_str(), path.size());
+
+    struct ucred peer;
+    socklen_t length = sizeof(peer);
+
+    // The paths and the digests are only trusted to a daemon of the same
+    // user: another one could answer with digests of its choosing.
+    if ((::connect(_fd, (const struct sockaddr *)&address,
+                   sizeof(address)) != 0)
+        || (getsockopt(_fd, SOL_SOCKET, SO_PEERCRED, &peer, &length) != 0)
+        || (peer.uid != geteuid()))
+    {
+        close(_fd);
+        _fd = -1;
+
+        return false;
+    }
+
+    return true;
+}
+
+/** Queue a frame to be sent (by flush(), or once enough are queued).
+ *
+ *  @pre The channel is connected.
+ *  @post The frame is queued.
+ *  @param frame The frame.
+ *  @return true The frame was queued (or sent).
+ *  @return false The connection failed.
+*/
+bool DaemonChannel::put (const HashState &frame)
+{
+    const vector < byte_t > &bytes = frame.bytes();
+    uint32_t length = (uint32_t)bytes.size();
+
+    // Each frame is its length (little endian) and its bytes.
+    for (uint32_t shift = 0; shift < 32; shift += 8)
+        _queued.push_back((byte_t)(length >> shift));
+
+    _queued.insert(_queued.end(), bytes.begin(), bytes.end());
+
+    return (_queued.size() < SEND_BYTES) || flush();
+}
+
+/** Send the queued frames.
+ *
+ *  @pre The channel is connected.
+ *  @post Nothing is queued.
+ *  @return true The frames were sent.
+ *  @return false The connection failed.
+*/
+bool DaemonChannel::flush (void)
+{
+    size_t sent = 0;
+
+    while (sent < _queued.size())
+    {
+        // A peer that has gone away is an error, not a SIGPIPE.
+        ssize_t length = send(_fd, &_queued[sent], _queued.size() - sent,
+                              MSG_NOSIGNAL);
+
+        if ((length < 0) && (errno == EINTR))
+            continue;
+
+        if (length <= 0)
+        {
+            _queued.clear();
+            return false;
+        }
+
+        sent += (size_t)length;
+    }
+
+    _queued.clear();
+
+    return true;
+}
+
+/** Receive a frame.
+ *
+ *  @pre The channel is connected.
+ *  @post On success frame holds the frame, to be read from the start.
+ *  @param frame Receives the frame.
+ *  @return true A frame was received.
+ *  @return false The connection was closed or failed, or the frame
+ *          is larger than MAX_FRAME_BYTES.
+*/
+bool DaemonChannel::get (HashState &frame)
+{
+    byte_t header[4];
+
+    if (!_readAll(header, sizeof(header)))
+        return false;
+
+    uint32_t length = (uint32_t)header[0]
+                    | ((uint32_t)header[1] <<  8)
+                    | ((uint32_t)header[2] << 16)
+                    | ((uint32_t)header[3] << 24);
+
+    if (length > MAX_FRAME_BYTES)
+        return false;
+
+    vector < byte_t > bytes(length);
+    if ((length > 0) && !_readAll(&bytes[0], length))
+        return false;
+
+    frame = HashState(bytes);
+
+    return true;
+}
+
+/** Send a request (and flush it).
+ *
+ *  @pre The channel is connected.
+ *  @post The request is sent.
+ *  @param request The request.
+ *  @return true The request was sent.
+ *  @return false The connection failed.
+*/
+bool DaemonChannel::sendRequest (const Request &request)
+{
+    HashState frame;
+
+    frame.putWord32(VERSION);
+    frame.putWord32(request.flags);
+    frame.putString(request.hashFlag);
+    frame.putString(request.directory);
+    frame.putString(request.ranges);
+    frame.putWord32((uint32_t)request.paths.size());
+
+    for (size_t i = 0; i < request.paths.size(); ++i)
+        frame.putString(request.paths[i]);
+
+    return put(frame) && flush();
+}
+
+/** Receive a request.
+ *
+ *  @pre The channel is connected.
+ *  @post On success request holds the request.
+ *  @param request Receives the request.
+ *  @param version Receives the version of the client's protocol.
+ *  @return true A request was received (of some version).
+ *  @return false The connection was closed, or the frame is corrupt.
+*/
+bool DaemonChannel::receiveRequest (Request &request, uint32_t &version)
+{
+    HashState frame;
+
+    if (!get(frame))
+        return false;
+
+    version = frame.getWord32();
+    if (!frame.good())
+        return false;
+
+    // The rest of a request of another version cannot be read.
+    if (version != VERSION)
+        return true;
+
+    request.flags = frame.getWord32();
+    request.hashFlag = frame.getString();
+    request.directory = frame.getString();
+    request.ranges = frame.getString();
+
+    uint32_t count = frame.getWord32();
+
+    request.paths.clear();
+    for (uint32_t i = 0; (i < count) && frame.good(); ++i)
+        request.paths.push_back(frame.getString());
+
+    return frame.good() && frame.atEnd();
+}
+
+/******************************************************
+**                  Static Methods                   **
+******************************************************/
+
+/** Find the default socket of the daemon: $GASH_SOCKET, else
+ *  gashd.sock in $XDG_RUNTIME_DIR, else gashd.sock in /tmp/gashd-<uid>.
+ *
+ *  @pre none.
+ *  @post /tmp/gashd-<uid> exists (mode 0700) if it is used.
+ *  @return The path of the socket, or "" if /tmp/gashd-<uid> is not a
+ *          directory of this user alone.
+*/
+string DaemonChannel::defaultPath (void)
+{
+    const char *socket = getenv("GASH_SOCKET");
+    if ((socket != NULL) && (*socket != '\0'))
+        return socket;
+
+    const char *runtime = getenv("XDG_RUNTIME_DIR");
+    if ((runtime != NULL) && (*runtime != '\0'))
+        return string(runtime) + "/gashd.sock";
+
+    // A directory of its own, so that no other user can take the name of
+    // the socket before the daemon does, or replace it.
+    std::ostringstream directory;
+    directory << "/tmp/gashd-" << geteuid();
+
+    struct stat status;
+    mkdir(directory.str().c_str(), 0700);
+
+    if ((lstat(directory.str().c_str(), &status) != 0)
+        || !S_ISDIR(status.st_mode) || (status.st_uid != geteuid())
+        || ((status.st_mode & 0077) != 0))
+        return "";
+
+    return directory.str() + "/gashd.sock";
+}
+
+/******************************************************
+**                   Helper Methods                  **
+******************************************************/
+
+/** Read exactly length bytes.
+ *
+ *  @param data Receives the bytes.
+ *  @param length The number of bytes.
+ *  @return true The bytes were read.
+ *  @return false The connection was closed or failed first.
+*/
+bool DaemonChannel::_readAll (byte_t *data, size_t length)
+{
+    while (length > 0)
+    {
+        ssize_t count = recv(_fd, data, length, 0);
+
+        if ((count < 0) && (errno == EINTR))
+            continue;
+
+        if (count <= 0)
+            return false;
+
+        data += count;
+        length -= (size_t)count;
+    }
+
+    return true;
+}
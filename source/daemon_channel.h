@@ -0,0 +1,248 @@
+/******************************************************************************
+||  daemon_channel.h                                                         ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    The protocol between the hashing daemon (gash daemon, or gashd) and its||
+||    clients.  The two ends exchange frames over a Unix domain socket: each ||
+||    frame is its length (a 32-bit little-endian word) and its bytes, which ||
+||    are written and read with HashState.                                   ||
+||                                                                           ||
+||    A client sends a request: the version of the protocol, the flags (the  ||
+||    cache options and --direct), the hash flag, its working directory, the ||
+||    byte ranges and the paths.  The daemon accepts it (with its version) or||
+||    refuses it, and then replies with a record per file, digest, range or  ||
+||    message, in the order of the request, and a final record that carries  ||
+||    the exit status.  A connection can carry one request after another.    ||
+||    Each end only talks to a process of its own user (SO_PEERCRED), and    ||
+||    the default socket is kept in a directory of that user alone.          ||
+||                                                                           ||
+||    Frames are queued and sent in batches, so that a reply of many small   ||
+||    records costs few system calls.                                        ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    Hashes/hash_state.cpp                                                  ||
+||    Hashes/hash_state.h                                                    ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file daemon_channel.h
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+
+#ifndef _GH_DAEMON_CHANNEL_DEF_H
+#define _GH_DAEMON_CHANNEL_DEF_H
+
+#include "Hashes/hash_state.h"
+
+/**
+ *  @class DaemonChannel One end of a connection between gash (or gashc)
+ *         and the hashing daemon.
+*/
+class DaemonChannel
+{
+  public:
+    /******************************************************
+    **                     Constants                     **
+    ******************************************************/
+
+    /// The version of the protocol; the daemon refuses other versions.
+    static const uint32_t VERSION = 1;
+
+    /// The largest frame that is accepted.
+    static const uint32_t MAX_FRAME_BYTES = 16777216;
+
+    /// The flags of a request.
+    static const uint32_t NO_CACHE = 0x01;      // Neither use nor update
+                                                // the digest cache.
+    static const uint32_t VERIFY_CACHE = 0x02;  // Hash and check cached
+                                                // digests.
+    static const uint32_t DIRECT = 0x04;        // Read around the page
+                                                // cache.
+
+    /// The types of the frames of a reply.
+    enum Record
+    {
+        RECORD_ACCEPT = 1,      // The request is served: the version of
+                                // the daemon.
+        RECORD_REFUSE = 2,      // It is not: the reason.
+        RECORD_FILE = 3,        // A file is reported: its name.
+        RECORD_DIGEST = 4,      // Its digest: the label and the digest.
+        RECORD_RANGE = 5,       // The digest of a byte range: the offset,
+                                // the length, the label and the digest.
+        RECORD_END = 6,         // The end of the ranges of a file.
+        RECORD_MESSAGE = 7,     // An error or a warning: the text.
+        RECORD_DONE = 8         // The end of the reply: the exit status.
+    };
+
+    /**
+     *  @struct Request A batch of files to hash.
+     */
+    struct Request
+    {
+        uint32_t flags;             // NO_CACHE, VERIFY_CACHE, DIRECT.
+        string hashFlag;            // The hash, as on the command line.
+        string directory;           // The working directory of the client
+                                    // (relative paths are in it).
+        string ranges;              // The byte ranges, as --range takes
+                                    // them (empty: the whole files).
+        vector < string > paths;    // The files and directories.
+    };
+
+    /******************************************************
+    **            Constructors / Destructors             **
+    ******************************************************/
+
+    /** Initialize a DaemonChannel object.
+     *
+     *  @pre none.
+     *  @post The channel owns fd (if any) and closes it.
+     *  @param fd A connected socket, or -1.
+    */
+    DaemonChannel (int fd = -1);
+
+    /** Default destructor (closes the socket).  */
+    ~DaemonChannel ();
+
+    /******************************************************
+    **                      Methods                      **
+    ******************************************************/
+
+    /** Connect to the daemon (of this user only).
+     *
+     *  @pre none.
+     *  @post On success the channel is connected.
+     *  @param path The socket of the daemon.
+     *  @return true The daemon accepted the connection.
+     *  @return false No daemon is listening on path, or the one that is
+     *          runs as another user.
+    */
+    bool connect (const string &path);
+
+    /** Queue a frame to be sent (by flush(), or once enough are queued).
+     *
+     *  @pre The channel is connected.
+     *  @post The frame is queued.
+     *  @param frame The frame.
+     *  @return true The frame was queued (or sent).
+     *  @return false The connection failed.
+    */
+    bool put (const HashState &frame);
+
+    /** Send the queued frames.
+     *
+     *  @pre The channel is connected.
+     *  @post Nothing is queued.
+     *  @return true The frames were sent.
+     *  @return false The connection failed.
+    */
+    bool flush (void);
+
+    /** Receive a frame.
+     *
+     *  @pre The channel is connected.
+     *  @post On success frame holds the frame, to be read from the start.
+     *  @param frame Receives the frame.
+     *  @return true A frame was received.
+     *  @return false The connection was closed or failed, or the frame
+     *          is larger than MAX_FRAME_BYTES.
+    */
+    bool get (HashState &frame);
+
+    /** Send a request (and flush it).
+     *
+     *  @pre The channel is connected.
+     *  @post The request is sent.
+     *  @param request The request.
+     *  @return true The request was sent.
+     *  @return false The connection failed.
+    */
+    bool sendRequest (const Request &request);
+
+    /** Receive a request.
+     *
+     *  @pre The channel is connected.
+     *  @post On success request holds the request.
+     *  @param request Receives the request.
+     *  @param version Receives the version of the client's protocol.
+     *  @return true A request was received (of some version).
+     *  @return false The connection was closed, or the frame is corrupt.
+    */
+    bool receiveRequest (Request &request, uint32_t &version);
+
+    /******************************************************
+    **                  Static Methods                   **
+    ******************************************************/
+
+    /** Find the default socket of the daemon: $GASH_SOCKET, else
+     *  gashd.sock in $XDG_RUNTIME_DIR, else gashd.sock in /tmp/gashd-<uid>.
+     *
+     *  @pre none.
+     *  @post /tmp/gashd-<uid> exists (mode 0700) if it is used.
+     *  @return The path of the socket, or "" if /tmp/gashd-<uid> is not a
+     *          directory of this user alone.
+    */
+    static string defaultPath (void);
+
+  private:
+    /******************************************************
+    **                      Members                      **
+    ******************************************************/
+
+    int _fd;                        // The socket.
+    vector < byte_t > _queued;      // The frames that are not sent yet.
+
+    /******************************************************
+    **                   Helper Methods                  **
+    ******************************************************/
+
+    /** Read exactly length bytes.
+     *
+     *  @param data Receives the bytes.
+     *  @param length The number of bytes.
+     *  @return true The bytes were read.
+     *  @return false The connection was closed or failed first.
+    */
+    bool _readAll (byte_t *data, size_t length);
+
+    // Not copyable (owns the socket).
+    DaemonChannel (const DaemonChannel &);
+    DaemonChannel & operator = (const DaemonChannel &);
+
+};  // End class DaemonChannel.
+
+#endif
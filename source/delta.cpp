@@ -0,0 +1,816 @@
+/******************************************************************************
+||  delta.cpp                                                                ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    The delta of the rsync algorithm: a newer version of a file described  ||
+||    as a sequence of copies of blocks of the old version (the basis) and   ||
+||    literal bytes, given only the Signature of the basis.                  ||
+||                                                                           ||
+||    The new file is scanned with a rolling Adler-32 window one block long. ||
+||    Each rolled sum is looked up in the signature's index, and a strong    ||
+||    digest of the window is only computed when some block has the same     ||
+||    weak sum.  A delta ends with the digest of the whole new file, which   ||
+||    patching checks before the output replaces its destination.            ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    delta.h                                                                ||
+||    signature.cpp (signature.lib)                                          ||
+||    signature.h                                                            ||
+||    Hashes/adler32.cpp (adler32.lib)                                       ||
+||    Hashes/adler32.h                                                       ||
+||    Hashes/hash_abstract.cpp (hash_abstract.lib)                           ||
+||    Hashes/hash_abstract.h                                                 ||
+||    Hashes/hash_state.cpp (hash_state.lib)                                 ||
+||    Hashes/hash_state.h                                                    ||
+||                                                                           ||
+||===========================================================================||
+||  REFERENCES                                                               ||
+||===========================================================================||
+||    Tridgell, A. and Mackerras, P.  "The rsync algorithm", Technical       ||
+||        Report TR-CS-96-05, Australian National University, 1996.          ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file delta.cpp
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "delta.h"
+#include "Hashes/adler32.h"
+#include "Hashes/hash_state.h"
+
+// The first bytes of every delta file.
+static const char DELTA_MAGIC[] = "GHDL";
+
+// The record types of a delta file.
+static const byte_t DELTA_END = 0;       // Size and digest of the new file.
+static const byte_t DELTA_COPY = 1;      // A run of blocks of the basis.
+static const byte_t DELTA_LITERAL = 2;   // Bytes that the basis lacks.
+
+// The output is written whenever this many bytes are queued.
+static const uint64_t WRITE_BUFFER_BYTES = 1048576;
+
+const uint32_t Delta::VERSION;
+const uint32_t Delta::READ_BUFFER_BYTES;
+
+/** Map a weak checksum to its bit of the filter.
+ *
+ *  @param weak The weak checksum.
+ *  @param shift 32 - log2(bits of the filter).
+ *  @return The bit.
+*/
+static uint32_t filterBit (uint32_t weak, uint32_t shift)
+{
+    return (weak * 0x9E3779B1U) >> shift;
+}
+
+/** Roll the window on (at least once) until its weak checksum passes
+ *  the filter, or until it starts at last.  This is Adler32::roll() with
+ *  the sums kept in registers and the outgoing byte's share of B taken
+ *  from a table, since it runs once for every byte that matches nothing.
+ *
+ *  @pre at < last, and a and b are the sums of data[at, at + window).
+ *  @post a and b are the sums of the window at the returned position.
+ *  @param data The buffer.
+ *  @param at The start of the window.
+ *  @param last The start of the last window that fits the buffer.
+ *  @param window The length of the window.
+ *  @param outB ((window * byte) + 1) mod 65521 for each byte.
+ *  @param filter One bit set for the weak checksum of each block.
+ *  @param shift 32 - log2(bits of the filter).
+ *  @param a The sum of the bytes.
+ *  @param b The sum of the A values.
+ *  @return The start of the window.
+*/
+static uint64_t rollWeak (const byte_t *data, uint64_t at, uint64_t last,
+                          uint32_t window, const uint32_t outB[256],
+                          const uint64_t *filter, uint32_t shift,
+                          uint32_t &a, uint32_t &b)
+{
+    const uint32_t M = Adler32::MODULUS;
+    uint32_t A = a,
+             B = b;
+
+    do
+    {
+        byte_t out = data[at],
+               in = data[at + window];
+
+        // Each sum stays below 3M before its two conditional reductions.
+        A += M + in - out;
+        A = (A >= M) ? A - M : A;
+        A = (A >= M) ? A - M : A;
+
+        B += M + A - outB[out];
+        B = (B >= M) ? B - M : B;
+        B = (B >= M) ? B - M : B;
+
+        ++at;
+
+        uint32_t bit = filterBit((B << 16) | A, shift);
+        if ((filter[bit >> 6] >> (bit & 63)) & 1)
+            break;
+    }
+    while (at < last);
+
+    a = A;
+    b = B;
+
+    return at;
+}
+
+/******************************************************
+**            Constructors / Destructors             **
+******************************************************/
+
+/** Default constructor.  */
+Delta::Delta ()
+    : _blockBytes(0),
+      _copied(0),
+      _literal(0),
+      _fd(-1),
+      _runFirst(0),
+      _runCount(0)
+{}
+
+/** Default destructor.  */
+Delta::~Delta ()
+{
+    if (_fd >= 0)
+        close(_fd);
+}
+
+/******************************************************
+**               Accessors / Mutators                **
+******************************************************/
+
+////////////////////
+//    Getters
+////////////////////
+
+/** Retrieve the block size of the delta.
+ *
+ *  @pre generate() or open() succeeded.
+ *  @post none.
+ *  @return The bytes per block of the basis.
+*/
+uint32_t Delta::blockBytes (void) const
+{
+    return _blockBytes;
+}
+
+/** Retrieve the name of the strong digest algorithm.
+ *
+ *  @pre generate() or open() succeeded.
+ *  @post none.
+ *  @return The algorithmName() of the digests.
+*/
+const string & Delta::algorithm (void) const
+{
+    return _algorithm;
+}
+
+/** Retrieve the number of bytes copied from the basis.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return The bytes of the new file that the last generate() or
+ *          apply() matched to blocks of the basis.
+*/
+uint64_t Delta::copiedBytes (void) const
+{
+    return _copied;
+}
+
+/** Retrieve the number of literal bytes.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return The bytes of the new file that the last generate() or
+ *          apply() carried in the delta itself.
+*/
+uint64_t Delta::literalBytes (void) const
+{
+    return _literal;
+}
+
+/******************************************************
+**                      Methods                      **
+******************************************************/
+
+/** Describe a file as a delta against a signature.
+ *
+ *  @pre target is open in binary mode at the start of the file.
+ *  @post The delta file is replaced atomically.
+ *  @param target The new version of the file.
+ *  @param signature The signature of the basis.
+ *  @param prototype A hash object of signature.algorithm().
+ *  @param path The delta file.
+ *  @return true The delta was written.
+ *  @return false target could not be read, the delta could not be
+ *          written, or prototype is not the signature's algorithm.
+*/
+bool Delta::generate (ifstream &target, const Signature &signature,
+                      const MessageHash &prototype, const string &path)
+{
+    if ((prototype.algorithmName() != signature.algorithm())
+        || !_create(path))
+        return false;
+
+    const uint32_t B = signature.blockBytes();
+    const uint64_t blocks = signature.wholeBlocks();
+
+    _blockBytes = B;
+    _algorithm = signature.algorithm();
+    _copied = 0;
+    _literal = 0;
+    _runCount = 0;
+
+    HashState header;
+    header.putBytes((const byte_t *)DELTA_MAGIC, 4);
+    header.putWord32(VERSION);
+    header.putWord32(B);
+    header.putString(_algorithm);
+
+    bool ok = _write(&header.bytes()[0], header.bytes().size());
+
+    MessageHash *strong = prototype.clone();   // Digests of the window.
+    MessageHash *whole = prototype.clone();    // Digest of the new file.
+    Adler32 adler;
+    vector < byte_t > digest;
+
+    // Most windows match no block, so their weak sums are first checked
+    // against a bitmap of about 16 bits per block (which rejects all but
+    // a few percent) before the index is consulted.
+    uint32_t bits = 10;
+    while ((bits < 32) && ((1ULL << bits) < 16 * blocks))
+        ++bits;
+
+    const uint32_t shift = 32 - bits;
+    vector < uint64_t > filter(((1ULL << bits) + 63) / 64, 0);
+
+    for (uint64_t block = 0; block < blocks; ++block)
+    {
+        uint32_t bit = filterBit(signature.weak(block), shift);
+        filter[bit >> 6] |= 1ULL << (bit & 63);
+    }
+
+    uint32_t outB[256];
+    for (uint32_t out = 0; out < 256; ++out)
+        outB[out] = ((B % Adler32::MODULUS) * out + 1) % Adler32::MODULUS;
+
+    uint32_t a = 0,
+             b = 0;
+
+    // The window is buffer[at, at + B); the bytes from literal up to at
+    // matched nothing and have not been written yet.
+    vector < byte_t > buffer(READ_BUFFER_BYTES + B);
+    uint64_t end = 0,
+             at = 0,
+             literal = 0,
+             lastBlock = Signature::NO_BLOCK,
+             size = 0;
+    bool primed = false,
+         eof = false;
+
+    while (ok)
+    {
+        // Rolling on needs the byte after the window, so refill while
+        // fewer than B + 1 bytes remain.  The pending literal bytes are
+        // written first, and the window moved to the front of the buffer
+        // (where its rolled sum remains valid).
+        if ((at + B >= end) && !eof)
+        {
+            ok = _flushRun() && _addLiteral(&buffer[literal], at - literal);
+
+            memmove(&buffer[0], &buffer[at], end - at);
+            end -= at;
+            at = 0;
+            literal = 0;
+
+            target.read((char *)&buffer[end], buffer.size() - end);
+            uint64_t length = (uint64_t)target.gcount();
+
+            whole->update(&buffer[end], length);
+            end += length;
+            size += length;
+            eof = !target.good();
+
+            continue;
+        }
+
+        if (at + B > end)
+            break;
+
+        if (!primed)
+        {
+            adler.reset();
+            adler.update(&buffer[at], B);
+
+            a = adler.checksum() & 0xFFFF;
+            b = adler.checksum() >> 16;
+            primed = true;
+        }
+        else if (at + B < end)
+        {
+            at = rollWeak(&buffer[0], at, end - B, B, outB, &filter[0],
+                          shift, a, b);
+        }
+        else
+            break;
+
+        uint32_t weak = (b << 16) | a;
+        uint64_t block = signature.find(weak);
+
+        if (block != Signature::NO_BLOCK)
+        {
+            strong->reset();
+            strong->update(&buffer[at], B);
+            strong->finalize();
+            digest = strong->asBytes();
+
+            // Try the block after the last match first, so that a run of
+            // blocks that repeat in the basis stays one copy.
+            uint64_t next = lastBlock + 1;
+            if ((lastBlock != Signature::NO_BLOCK) && (next < blocks)
+                && (signature.weak(next) == weak)
+                && (memcmp(signature.strong(next), &digest[0],
+                           digest.size()) == 0))
+                block = next;
+
+            while ((block != Signature::NO_BLOCK)
+                   && (memcmp(signature.strong(block), &digest[0],
+                              digest.size()) != 0))
+                block = signature.find(weak, block);
+        }
+
+        if (block != Signature::NO_BLOCK)
+        {
+            ok = _addLiteral(&buffer[literal], at - literal)
+                 && _copy(block, B);
+
+            lastBlock = block;
+            at += B;
+            literal = at;
+            primed = false;
+        }
+    }
+
+    // The final partial block of the basis can only match the end of the
+    // new file.
+    if (ok && target.eof() && (signature.blockCount() > blocks))
+    {
+        uint32_t length = signature.blockLength(blocks);
+
+        if (end - literal >= length)
+        {
+            const byte_t *tail = &buffer[end - length];
+
+            adler.reset();
+            adler.update(tail, length);
+
+            if (adler.checksum() == signature.weak(blocks))
+            {
+                strong->reset();
+                strong->update(tail, length);
+                strong->finalize();
+                digest = strong->asBytes();
+
+                if (memcmp(signature.strong(blocks), &digest[0],
+                           digest.size()) == 0)
+                {
+                    ok = _addLiteral(&buffer[literal],
+                                     end - length - literal)
+                         && _copy(blocks, length);
+
+                    literal = end;
+                }
+            }
+        }
+    }
+
+    // The bytes after the last match (including a final partial window).
+    ok = ok && target.eof() && _addLiteral(&buffer[literal], end - literal)
+         && _flushRun();
+
+    whole->finalize();
+
+    HashState trailer;
+    trailer.putBytes(&DELTA_END, 1);
+    trailer.putWord64(size);
+    trailer.putBlob(whole->asBytes());
+
+    ok = ok && _write(&trailer.bytes()[0], trailer.bytes().size());
+
+    delete strong;
+    delete whole;
+
+    target.clear();
+    target.seekg(0);
+
+    return _finish(path, ok);
+}
+
+/** Open a delta file and read its header, which names the algorithm
+ *  that apply() needs.
+ *
+ *  @pre none.
+ *  @post The file is ready for apply().
+ *  @param path The delta file.
+ *  @return true The header was read.
+ *  @return false The file could not be read or is not a delta.
+*/
+bool Delta::open (const string &path)
+{
+    if (_input.is_open())
+        _input.close();
+
+    _input.clear();
+    _input.open(path.c_str(), ios::in | ios::binary);
+
+    vector < byte_t > bytes;
+    if (!_read(16, bytes))
+        return false;
+
+    HashState fixed(bytes);
+    byte_t magic[4];
+
+    fixed.getBytes(magic, 4);
+    uint32_t version = fixed.getWord32();
+    uint32_t blockBytes = fixed.getWord32();
+    uint32_t nameLength = fixed.getWord32();
+
+    // Algorithm names are short; a long one is a corrupt length.
+    if ((memcmp(magic, DELTA_MAGIC, 4) != 0) || (version != VERSION)
+        || (blockBytes < Signature::MIN_BLOCK_BYTES)
+        || (blockBytes > Signature::MAX_BLOCK_BYTES) || (nameLength > 64)
+        || !_read(nameLength, bytes))
+    {
+        _input.close();
+        return false;
+    }
+
+    _blockBytes = blockBytes;
+    _algorithm.assign(bytes.begin(), bytes.end());
+
+    return true;
+}
+
+/** Rebuild the new file from the basis and the open delta.
+ *
+ *  @pre open() succeeded, and basis is open in binary mode.
+ *  @post The output file is replaced atomically if (and only if) the
+ *        rebuilt file has the digest that the delta recorded.  The
+ *        delta is closed.
+ *  @param basis The old version of the file.
+ *  @param prototype A hash object of algorithm().
+ *  @param path The output file.
+ *  @return true The file was rebuilt.
+ *  @return false A file could not be read or written, the delta is
+ *          malformed, or the result does not match (the basis is
+ *          not the file that was signed).
+*/
+bool Delta::apply (ifstream &basis, const MessageHash &prototype,
+                   const string &path)
+{
+    if (!_input.is_open() || (prototype.algorithmName() != _algorithm))
+        return false;
+
+    // The last block of the basis may be a partial one.
+    basis.seekg(0, ios::end);
+    uint64_t basisSize = (uint64_t)basis.tellg(),
+             basisBlocks = (basisSize + _blockBytes - 1) / _blockBytes;
+
+    if (basis.fail() || !_create(path))
+    {
+        _input.close();
+        return false;
+    }
+
+    _copied = 0;
+    _literal = 0;
+
+    MessageHash *whole = prototype.clone();
+    vector < byte_t > buffer(READ_BUFFER_BYTES),
+                      bytes;
+    bool ok = true,
+         ended = false;
+
+    while (ok && !ended && _read(1, bytes))
+    {
+        if (bytes[0] == DELTA_COPY)
+        {
+            ok = _read(16, bytes);
+
+            HashState record(bytes);
+            uint64_t first = record.getWord64(),
+                     count = record.getWord64();
+
+            ok = ok && (first < basisBlocks) && (count > 0)
+                 && (count <= basisBlocks - first);
+
+            uint64_t offset = first * _blockBytes,
+                     total = count * _blockBytes;
+
+            if (ok && (total > basisSize - offset))
+                total = basisSize - offset;
+
+            basis.seekg(offset);
+
+            for (uint64_t left = total; ok && (left > 0); )
+            {
+                uint64_t length = (left < buffer.size()) ? left
+                                                         : buffer.size();
+
+                basis.read((char *)&buffer[0], length);
+                ok = ((uint64_t)basis.gcount() == length)
+                     && _write(&buffer[0], length);
+
+                whole->update(&buffer[0], length);
+                _copied += length;
+                left -= length;
+            }
+        }
+        else if (bytes[0] == DELTA_LITERAL)
+        {
+            ok = _read(4, bytes);
+
+            HashState record(bytes);
+            uint32_t length = record.getWord32();
+
+            ok = ok && (length > 0) && (length <= buffer.size())
+                 && _read(length, bytes) && _write(&bytes[0], length);
+
+            if (ok)
+            {
+                whole->update(&bytes[0], length);
+                _literal += length;
+            }
+        }
+        else if (bytes[0] == DELTA_END)
+        {
+            ok = _read(12, bytes);
+
+            HashState record(bytes);
+            uint64_t size = record.getWord64();
+            uint32_t digestLength = record.getWord32();
+
+            whole->finalize();
+            vector < byte_t > expected = whole->asBytes();
+
+            // Nothing may follow the end of the delta.
+            ok = ok && (size == _copied + _literal)
+                 && (digestLength == expected.size())
+                 && _read(digestLength, bytes) && (bytes == expected)
+                 && (_input.peek() == EOF);
+
+            ended = true;
+        }
+        else
+            ok = false;
+    }
+
+    delete whole;
+    _input.close();
+
+    basis.clear();
+    basis.seekg(0);
+
+    return _finish(path, ok && ended);
+}
+
+/******************************************************
+**                   Helper Methods                  **
+******************************************************/
+
+/** Create the temporary file that the output is written to.
+ *
+ *  @param path The final path of the output.
+ *  @return true The file was created.
+ *  @return false The file could not be created.
+*/
+bool Delta::_create (const string &path)
+{
+    if (_fd >= 0)
+        close(_fd);
+
+    string temporary = path + ".tmp";
+    _fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    _output.clear();
+
+    return (_fd >= 0);
+}
+
+/** Queue bytes for the output file, writing them once enough have
+ *  accumulated.
+ *
+ *  @param data The bytes.
+ *  @param length The number of bytes.
+ *  @return true The bytes were queued (or written).
+ *  @return false A write failed.
+*/
+bool Delta::_write (const byte_t *data, uint64_t length)
+{
+    _output.insert(_output.end(), data, data + length);
+
+    if (_output.size() < WRITE_BUFFER_BYTES)
+        return true;
+
+    size_t written = 0;
+
+    while (written < _output.size())
+    {
+        ssize_t count = write(_fd, &_output[written],
+                              _output.size() - written);
+        if (count <= 0)
+            return false;
+
+        written += (size_t)count;
+    }
+
+    _output.clear();
+
+    return true;
+}
+
+/** Write the queued bytes and, if commit, rename the temporary file
+ *  over the output (otherwise it is removed).
+ *
+ *  @param path The final path of the output.
+ *  @param commit Whether the output is to be kept.
+ *  @return true The output was committed.
+ *  @return false It was discarded (or could not be written).
+*/
+bool Delta::_finish (const string &path, bool commit)
+{
+    string temporary = path + ".tmp";
+    size_t written = 0;
+
+    while (commit && (written < _output.size()))
+    {
+        ssize_t count = write(_fd, &_output[written],
+                              _output.size() - written);
+        if (count <= 0)
+            commit = false;
+        else
+            written += (size_t)count;
+    }
+
+    _output.clear();
+
+    // The data must be on disk before the rename makes it current.
+    commit = commit && (fsync(_fd) == 0);
+    commit = (close(_fd) == 0) && commit;
+    _fd = -1;
+
+    if (!commit || (rename(temporary.c_str(), path.c_str()) != 0))
+    {
+        unlink(temporary.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+/** Add a block of the basis to the delta, extending the pending run
+ *  of copies where it follows on.
+ *
+ *  @param block The index of the block.
+ *  @param length The length of the block.
+ *  @return true The copy was queued.
+ *  @return false A write failed.
+*/
+bool Delta::_copy (uint64_t block, uint32_t length)
+{
+    _copied += length;
+
+    if ((_runCount > 0) && (block == _runFirst + _runCount))
+    {
+        ++_runCount;
+        return true;
+    }
+
+    bool ok = _flushRun();
+
+    _runFirst = block;
+    _runCount = 1;
+
+    return ok;
+}
+
+/** Write the pending run of copies (if any).
+ *
+ *  @return true The run was written.
+ *  @return false A write failed.
+*/
+bool Delta::_flushRun (void)
+{
+    if (_runCount == 0)
+        return true;
+
+    HashState record;
+    record.putBytes(&DELTA_COPY, 1);
+    record.putWord64(_runFirst);
+    record.putWord64(_runCount);
+
+    _runCount = 0;
+
+    return _write(&record.bytes()[0], record.bytes().size());
+}
+
+/** Add literal bytes to the delta.
+ *
+ *  @param data The bytes.
+ *  @param length The number of bytes.
+ *  @return true The bytes were queued.
+ *  @return false A write failed.
+*/
+bool Delta::_addLiteral (const byte_t *data, uint64_t length)
+{
+    if (length == 0)
+        return true;
+
+    if (!_flushRun())
+        return false;
+
+    _literal += length;
+
+    // Each record fits in the read buffer, so apply() can hold it.
+    while (length > 0)
+    {
+        uint32_t part = (length < READ_BUFFER_BYTES) ? (uint32_t)length
+                                                     : READ_BUFFER_BYTES;
+
+        HashState record;
+        record.putBytes(&DELTA_LITERAL, 1);
+        record.putWord32(part);
+
+        if (!_write(&record.bytes()[0], record.bytes().size())
+            || !_write(data, part))
+            return false;
+
+        data += part;
+        length -= part;
+    }
+
+    return true;
+}
+
+/** Read a field of the open delta.
+ *
+ *  @param length The number of bytes.
+ *  @param bytes Receives the bytes.
+ *  @return true The bytes were read.
+ *  @return false The delta ended first.
+*/
+bool Delta::_read (uint64_t length, vector < byte_t > &bytes)
+{
+    bytes.resize(length);
+
+    if (length == 0)
+        return true;
+
+    _input.read((char *)&bytes[0], length);
+
+    return ((uint64_t)_input.gcount() == length);
+}
@@ -0,0 +1,280 @@
+/******************************************************************************
+||  delta.h                                                                  ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    The delta of the rsync algorithm: a newer version of a file described  ||
+||    as a sequence of copies of blocks of the old version (the basis) and   ||
+||    literal bytes, given only the Signature of the basis.                  ||
+||                                                                           ||
+||    The new file is scanned with a rolling Adler-32 window one block long. ||
+||    Each rolled sum is looked up in the signature's index, and a strong    ||
+||    digest of the window is only computed when some block has the same     ||
+||    weak sum.  A delta ends with the digest of the whole new file, which   ||
+||    patching checks before the output replaces its destination.            ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    signature.cpp (signature.lib)                                          ||
+||    signature.h                                                            ||
+||    Hashes/adler32.cpp (adler32.lib)                                       ||
+||    Hashes/adler32.h                                                       ||
+||    Hashes/hash_abstract.cpp (hash_abstract.lib)                           ||
+||    Hashes/hash_abstract.h                                                 ||
+||    Hashes/hash_state.cpp (hash_state.lib)                                 ||
+||    Hashes/hash_state.h                                                    ||
+||                                                                           ||
+||===========================================================================||
+||  REFERENCES                                                               ||
+||===========================================================================||
+||    Tridgell, A. and Mackerras, P.  "The rsync algorithm", Technical       ||
+||        Report TR-CS-96-05, Australian National University, 1996.          ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file delta.h
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+
+#ifndef _GH_DELTA_DEF_H
+#define _GH_DELTA_DEF_H
+
+#include "signature.h"
+
+/**
+ *  @class Delta Generates and applies rsync deltas.
+*/
+class Delta
+{
+  public:
+    /******************************************************
+    **                     Constants                     **
+    ******************************************************/
+
+    /// The layout version of the delta file.
+    static const uint32_t VERSION = 1;
+
+    /// The size of the blocks that files are read in.
+    static const uint32_t READ_BUFFER_BYTES = 16777216;
+
+    /******************************************************
+    **            Constructors / Destructors             **
+    ******************************************************/
+
+    /** Default constructor.  */
+    Delta ();
+
+    /** Default destructor.  */
+    ~Delta ();
+
+    /******************************************************
+    **               Accessors / Mutators                **
+    ******************************************************/
+
+    ////////////////////
+    //    Getters
+    ////////////////////
+
+    /** Retrieve the block size of the delta.
+     *
+     *  @pre generate() or open() succeeded.
+     *  @post none.
+     *  @return The bytes per block of the basis.
+    */
+    uint32_t blockBytes (void) const;
+
+    /** Retrieve the name of the strong digest algorithm.
+     *
+     *  @pre generate() or open() succeeded.
+     *  @post none.
+     *  @return The algorithmName() of the digests.
+    */
+    const string & algorithm (void) const;
+
+    /** Retrieve the number of bytes copied from the basis.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return The bytes of the new file that the last generate() or
+     *          apply() matched to blocks of the basis.
+    */
+    uint64_t copiedBytes (void) const;
+
+    /** Retrieve the number of literal bytes.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return The bytes of the new file that the last generate() or
+     *          apply() carried in the delta itself.
+    */
+    uint64_t literalBytes (void) const;
+
+    /******************************************************
+    **                      Methods                      **
+    ******************************************************/
+
+    /** Describe a file as a delta against a signature.
+     *
+     *  @pre target is open in binary mode at the start of the file.
+     *  @post The delta file is replaced atomically.
+     *  @param target The new version of the file.
+     *  @param signature The signature of the basis.
+     *  @param prototype A hash object of signature.algorithm().
+     *  @param path The delta file.
+     *  @return true The delta was written.
+     *  @return false target could not be read, the delta could not be
+     *          written, or prototype is not the signature's algorithm.
+    */
+    bool generate (ifstream &target, const Signature &signature,
+                   const MessageHash &prototype, const string &path);
+
+    /** Open a delta file and read its header, which names the algorithm
+     *  that apply() needs.
+     *
+     *  @pre none.
+     *  @post The file is ready for apply().
+     *  @param path The delta file.
+     *  @return true The header was read.
+     *  @return false The file could not be read or is not a delta.
+    */
+    bool open (const string &path);
+
+    /** Rebuild the new file from the basis and the open delta.
+     *
+     *  @pre open() succeeded, and basis is open in binary mode.
+     *  @post The output file is replaced atomically if (and only if) the
+     *        rebuilt file has the digest that the delta recorded.  The
+     *        delta is closed.
+     *  @param basis The old version of the file.
+     *  @param prototype A hash object of algorithm().
+     *  @param path The output file.
+     *  @return true The file was rebuilt.
+     *  @return false A file could not be read or written, the delta is
+     *          malformed, or the result does not match (the basis is
+     *          not the file that was signed).
+    */
+    bool apply (ifstream &basis, const MessageHash &prototype,
+                const string &path);
+
+  private:
+    /******************************************************
+    **                      Members                      **
+    ******************************************************/
+
+    uint32_t _blockBytes;           // The bytes per block.
+    string _algorithm;              // The strong digest algorithm.
+    uint64_t _copied;               // The bytes copied from the basis.
+    uint64_t _literal;              // The literal bytes.
+
+    ifstream _input;                // The delta that open() read.
+
+    int _fd;                        // The temporary output file.
+    vector < byte_t > _output;      // The bytes not yet written to _fd.
+
+    // The run of consecutive blocks that generate() has not written yet.
+    uint64_t _runFirst;
+    uint64_t _runCount;
+
+    /******************************************************
+    **                   Helper Methods                  **
+    ******************************************************/
+
+    /** Create the temporary file that the output is written to.
+     *
+     *  @param path The final path of the output.
+     *  @return true The file was created.
+     *  @return false The file could not be created.
+    */
+    bool _create (const string &path);
+
+    /** Queue bytes for the output file, writing them once enough have
+     *  accumulated.
+     *
+     *  @param data The bytes.
+     *  @param length The number of bytes.
+     *  @return true The bytes were queued (or written).
+     *  @return false A write failed.
+    */
+    bool _write (const byte_t *data, uint64_t length);
+
+    /** Write the queued bytes and, if commit, rename the temporary file
+     *  over the output (otherwise it is removed).
+     *
+     *  @param path The final path of the output.
+     *  @param commit Whether the output is to be kept.
+     *  @return true The output was committed.
+     *  @return false It was discarded (or could not be written).
+    */
+    bool _finish (const string &path, bool commit);
+
+    /** Add a block of the basis to the delta, extending the pending run
+     *  of copies where it follows on.
+     *
+     *  @param block The index of the block.
+     *  @param length The length of the block.
+     *  @return true The copy was queued.
+     *  @return false A write failed.
+    */
+    bool _copy (uint64_t block, uint32_t length);
+
+    /** Write the pending run of copies (if any).
+     *
+     *  @return true The run was written.
+     *  @return false A write failed.
+    */
+    bool _flushRun (void);
+
+    /** Add literal bytes to the delta.
+     *
+     *  @param data The bytes.
+     *  @param length The number of bytes.
+     *  @return true The bytes were queued.
+     *  @return false A write failed.
+    */
+    bool _addLiteral (const byte_t *data, uint64_t length);
+
+    /** Read a field of the open delta.
+     *
+     *  @param length The number of bytes.
+     *  @param bytes Receives the bytes.
+     *  @return true The bytes were read.
+     *  @return false The delta ended first.
+    */
+    bool _read (uint64_t length, vector < byte_t > &bytes);
+
+};  // End class Delta.
+
+#endif
@@ -0,0 +1,162 @@
+/******************************************************************************
+||  digest_attribute.cpp                                                     ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    Stores the digest of a file in an extended attribute of the file       ||
+||    itself (user.gash.<algorithm>), together with the size and             ||
+||    modification time that it was computed for.                            ||
+||                                                                           ||
+||    Unlike the digest cache, the attribute follows the file across renames ||
+||    and attribute-preserving copies (rsync -X, cp --preserve=xattr), and a ||
+||    later run only has to call getxattr to trust it.                       ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    digest_attribute.h                                                     ||
+||    Hashes/hash_abstract.cpp (hash_abstract.lib)                           ||
+||    Hashes/hash_abstract.h                                                 ||
+||    Hashes/hash_state.cpp (hash_state.lib)                                 ||
+||    Hashes/hash_state.h                                                    ||
+||                                                                           ||
+||===========================================================================||
+||  REFERENCES                                                               ||
+||===========================================================================||
+||    getxattr(2), setxattr(2) -- Linux Programmer's Manual.                 ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file digest_attribute.cpp
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+
+#include <sys/xattr.h>
+
+#include "digest_attribute.h"
+#include "Hashes/hash_state.h"
+
+const uint32_t DigestAttribute::VERSION;
+const char DigestAttribute::PREFIX[] = "user.gash.";
+const uint32_t DigestAttribute::VALUE_BYTES;
+
+/******************************************************
+**                  Static Methods                   **
+******************************************************/
+
+/** Read the digest that is stored with a file.
+ *
+ *  The modification time is compared rather than the change time,
+ *  since writing the attribute (or copying the file with rsync -t)
+ *  changes the latter.
+ *
+ *  @pre status was filled by stat() for the file.
+ *  @post On success the _hash values of hash hold the digest.
+ *  @param filename The file.
+ *  @param status The metadata of the file.
+ *  @param hash A hash object of the algorithm that is wanted.
+ *  @return true The attribute holds the digest of this version of
+ *          the file.
+ *  @return false There is no (current) attribute.
+*/
+bool DigestAttribute::load (const string &filename,
+                            const struct stat &status, MessageHash &hash)
+{
+    byte_t value[VALUE_BYTES];
+    ssize_t length = getxattr(filename.c_str(),
+                              attributeName(hash).c_str(),
+                              value, sizeof(value));
+
+    if (length <= 0)
+        return false;
+
+    HashState state(vector < byte_t > (value, value + length));
+
+    uint32_t version = state.getWord32();
+    uint64_t size = state.getWord64();
+    uint64_t seconds = state.getWord64();
+    uint32_t nanoseconds = state.getWord32();
+    vector < byte_t > digest = state.getBlob();
+
+    if (!state.good() || !state.atEnd() || (version != VERSION)
+        || (size != (uint64_t)status.st_size)
+        || (seconds != (uint64_t)status.st_mtim.tv_sec)
+        || (nanoseconds != (uint32_t)status.st_mtim.tv_nsec))
+        return false;
+
+    return hash.setHash(digest);
+}
+
+/** Store the digest of a file in its extended attribute.
+ *
+ *  @pre status was filled by stat() before the file was read and
+ *       hash holds the digest of the file.
+ *  @post The attribute of the algorithm is replaced.
+ *  @param filename The file.
+ *  @param status The metadata of the file.
+ *  @param hash The finalized hash of the file.
+ *  @return true The attribute was written.
+ *  @return false The file system (or the permissions of the file) do
+ *          not allow user attributes.
+*/
+bool DigestAttribute::store (const string &filename,
+                             const struct stat &status,
+                             const MessageHash &hash)
+{
+    HashState state;
+
+    state.putWord32(VERSION);
+    state.putWord64((uint64_t)status.st_size);
+    state.putWord64((uint64_t)status.st_mtim.tv_sec);
+    state.putWord32((uint32_t)status.st_mtim.tv_nsec);
+    state.putBlob(hash.asBytes());
+
+    const vector < byte_t > &value = state.bytes();
+
+    return (setxattr(filename.c_str(), attributeName(hash).c_str(),
+                     &value[0], value.size(), 0) == 0);
+}
+
+/** Retrieve the name of the attribute of an algorithm.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @param hash A hash object of the algorithm.
+ *  @return The name of the attribute (e.g. "user.gash.SHA-256").
+*/
+string DigestAttribute::attributeName (const MessageHash &hash)
+{
+    return string(PREFIX) + hash.algorithmName();
+}
\ No newline at end of file
@@ -0,0 +1,139 @@
+/******************************************************************************
+||  digest_attribute.h                                                       ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    Stores the digest of a file in an extended attribute of the file       ||
+||    itself (user.gash.<algorithm>), together with the size and             ||
+||    modification time that it was computed for.                            ||
+||                                                                           ||
+||    Unlike the digest cache, the attribute follows the file across renames ||
+||    and attribute-preserving copies (rsync -X, cp --preserve=xattr), and a ||
+||    later run only has to call getxattr to trust it.                       ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    Hashes/hash_abstract.cpp (hash_abstract.lib)                           ||
+||    Hashes/hash_abstract.h                                                 ||
+||    Hashes/hash_state.cpp (hash_state.lib)                                 ||
+||    Hashes/hash_state.h                                                    ||
+||                                                                           ||
+||===========================================================================||
+||  REFERENCES                                                               ||
+||===========================================================================||
+||    getxattr(2), setxattr(2) -- Linux Programmer's Manual.                 ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file digest_attribute.h
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+
+#ifndef _GH_DIGEST_ATTRIBUTE_DEF_H
+#define _GH_DIGEST_ATTRIBUTE_DEF_H
+
+#include <sys/stat.h>
+
+#include "Hashes/hash_abstract.h"
+
+/**
+ *  @class DigestAttribute Digests kept in extended attributes of the files.
+*/
+class DigestAttribute
+{
+  public:
+    /******************************************************
+    **                     Constants                     **
+    ******************************************************/
+
+    /// The layout version of the attribute; other versions are ignored.
+    static const uint32_t VERSION = 1;
+
+    /// The attribute of an algorithm is PREFIX + algorithmName().
+    static const char PREFIX[];
+
+    /// The longest attribute value that is read back.
+    static const uint32_t VALUE_BYTES = 256;
+
+    /******************************************************
+    **                  Static Methods                   **
+    ******************************************************/
+
+    /** Read the digest that is stored with a file.
+     *
+     *  The modification time is compared rather than the change time,
+     *  since writing the attribute (or copying the file with rsync -t)
+     *  changes the latter.
+     *
+     *  @pre status was filled by stat() for the file.
+     *  @post On success the _hash values of hash hold the digest.
+     *  @param filename The file.
+     *  @param status The metadata of the file.
+     *  @param hash A hash object of the algorithm that is wanted.
+     *  @return true The attribute holds the digest of this version of
+     *          the file.
+     *  @return false There is no (current) attribute.
+    */
+    static bool load (const string &filename, const struct stat &status,
+                      MessageHash &hash);
+
+    /** Store the digest of a file in its extended attribute.
+     *
+     *  @pre status was filled by stat() before the file was read and
+     *       hash holds the digest of the file.
+     *  @post The attribute of the algorithm is replaced.
+     *  @param filename The file.
+     *  @param status The metadata of the file.
+     *  @param hash The finalized hash of the file.
+     *  @return true The attribute was written.
+     *  @return false The file system (or the permissions of the file) do
+     *          not allow user attributes.
+    */
+    static bool store (const string &filename, const struct stat &status,
+                       const MessageHash &hash);
+
+    /** Retrieve the name of the attribute of an algorithm.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @param hash A hash object of the algorithm.
+     *  @return The name of the attribute (e.g. "user.gash.SHA-256").
+    */
+    static string attributeName (const MessageHash &hash);
+
+};  // End class DigestAttribute.
+
+#endif
\ No newline at end of file
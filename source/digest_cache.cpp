@@ -0,0 +1,516 @@
+/******************************************************************************
+||  digest_cache.cpp                                                         ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    A persistent cache of file digests, so that a repeated sweep does not  ||
+||    read the files that have not changed.  Entries are keyed by the device ||
+||    and inode of a file and the hash algorithm, and are only trusted while ||
+||    the size, modification time and status change time (both in            ||
+||    nanoseconds) of the file are those that the digest was calculated for. ||
+||                                                                           ||
+||    The cache is a header followed by fixed size records sorted by key.    ||
+||    It is mapped into memory (mmap) and searched in place, so a lookup     ||
+||    costs a binary search and no parsing; new digests are merged into a    ||
+||    fresh copy of the file when the sweep ends.                            ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    checkpoint.cpp (checkpoint.lib)                                        ||
+||    checkpoint.h                                                           ||
+||    Hashes/hash_abstract.cpp (hash_abstract.lib)                           ||
+||    Hashes/hash_abstract.h                                                 ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file digest_cache.cpp
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+
+#include "digest_cache.h"
+#include "checkpoint.h"
+
+// The first bytes of every cache file.
+static const char CACHE_MAGIC[] = "GHDC";
+
+// The offsets of the fields of a record.
+static const uint32_t DEVICE_AT = 0;
+static const uint32_t INODE_AT = 8;
+static const uint32_t NAME_AT = 16;
+static const uint32_t SIZE_AT = 32;
+static const uint32_t MTIME_AT = 40;
+static const uint32_t CTIME_AT = 48;
+static const uint32_t DIGEST_LENGTH_AT = 56;
+static const uint32_t DIGEST_AT = 64;
+
+const uint32_t DigestCache::VERSION;
+const uint32_t DigestCache::NAME_BYTES;
+const uint32_t DigestCache::DIGEST_BYTES;
+const uint32_t DigestCache::HEADER_BYTES;
+const uint32_t DigestCache::RECORD_BYTES;
+
+/** Convert a file time to nanoseconds.
+ *
+ *  @param time The time.
+ *  @return The nanoseconds since the epoch.
+*/
+static uint64_t nanoseconds (const struct timespec &time)
+{
+    return ((uint64_t)time.tv_sec * 1000000000ULL) + (uint64_t)time.tv_nsec;
+}
+
+/******************************************************
+**            Constructors / Destructors             **
+******************************************************/
+
+/** Initialize a DigestCache object.
+ *
+ *  @pre none.
+ *  @post The cache file is mapped if it exists and is valid;
+ *        otherwise the cache starts out empty.
+ *  @param path The cache file.
+*/
+DigestCache::DigestCache (const string &path)
+    : _path(path),
+      _map(NULL),
+      _mapBytes(0),
+      _records(0)
+{
+    _open();
+}
+
+/** Default destructor (unmaps the cache file).  */
+DigestCache::~DigestCache ()
+{
+    _close();
+}
+
+/******************************************************
+**               Accessors / Mutators                **
+******************************************************/
+
+////////////////////
+//    Getters
+////////////////////
+
+/** Retrieve the name of the cache file.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return The path of the cache file.
+*/
+const string & DigestCache::path (void) const
+{
+    return _path;
+}
+
+/** Look up the digest of a file.
+ *
+ *  @pre status was filled by stat() for the file.
+ *  @post On success the _hash values of hash hold the digest.
+ *  @param status The metadata of the file.
+ *  @param hash A hash object of the algorithm that is wanted.
+ *  @return true The digest was cached for this version of the file.
+ *  @return false There is no (current) entry.
+*/
+bool DigestCache::lookup (const struct stat &status, MessageHash &hash) const
+{
+    Key key;
+    if (!_makeKey(status, hash.algorithmName(), key))
+        return false;
+
+    // An entry stored during this run takes precedence.
+    const byte_t *record = NULL;
+    std::map < Key, vector < byte_t > >::const_iterator it = _stored.find(key);
+
+    if (it != _stored.end())
+        record = &it->second[0];
+    else
+        record = _find(key);
+
+    if (   (record == NULL)
+        || (_load64(record + SIZE_AT) != (uint64_t)status.st_size)
+        || (_load64(record + MTIME_AT) != nanoseconds(status.st_mtim))
+        || (_load64(record + CTIME_AT) != nanoseconds(status.st_ctim)))
+        return false;
+
+    uint64_t length = _load64(record + DIGEST_LENGTH_AT);
+    if (length > DIGEST_BYTES)
+        return false;
+
+    vector < byte_t > digest(record + DIGEST_AT, record + DIGEST_AT + length);
+
+    return hash.setHash(digest);
+}
+
+////////////////////
+//    Setters
+////////////////////
+
+/** Remember the digest of a file until save().
+ *
+ *  @pre status was filled by stat() before the file was read and
+ *       hash holds the digest of the file.
+ *  @post The digest replaces any entry of the file.
+ *  @param status The metadata of the file.
+ *  @param hash The finalized hash of the file.
+ *  @return none.
+*/
+void DigestCache::store (const struct stat &status, const MessageHash &hash)
+{
+    Key key;
+    vector < byte_t > digest = hash.asBytes();
+
+    if (!_makeKey(status, hash.algorithmName(), key)
+        || (digest.size() > DIGEST_BYTES))
+        return;
+
+    vector < byte_t > record(RECORD_BYTES, 0x00);
+
+    _store64(&record[DEVICE_AT], key.device);
+    _store64(&record[INODE_AT], key.inode);
+    memcpy(&record[NAME_AT], key.algorithm, NAME_BYTES);
+    _store64(&record[SIZE_AT], (uint64_t)status.st_size);
+    _store64(&record[MTIME_AT], nanoseconds(status.st_mtim));
+    _store64(&record[CTIME_AT], nanoseconds(status.st_ctim));
+    _store64(&record[DIGEST_LENGTH_AT], (uint64_t)digest.size());
+    memcpy(&record[DIGEST_AT], &digest[0], digest.size());
+
+    _stored[key] = record;
+
+    return;
+}
+
+/** Write the cache file if any digest was stored.  The file is
+ *  replaced atomically, so concurrent readers see the old or the
+ *  new cache; writers take turns on the lock file (<path>.lock), and
+ *  each merges its entries into the cache that the last one wrote.
+ *
+ *  @pre none.
+ *  @post The cache file holds the entries on disk and the stored
+ *        ones, and is mapped again; nothing is left stored.
+ *  @return true The cache is up to date on disk.
+ *  @return false The cache file could not be written (the stored
+ *          entries are kept).
+*/
+bool DigestCache::save (void)
+{
+    if (_stored.empty())
+        return true;
+
+    // The cache file itself is replaced by a rename, so the lock is taken
+    // on a file that stays.
+    string lockPath = _path + ".lock";
+    int lock = open(lockPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+
+    if (lock < 0)
+        return false;
+
+    while ((flock(lock, LOCK_EX) != 0) && (errno == EINTR))
+        ;
+
+    // Another process may have saved since the cache was mapped: merge
+    // into its file, not into the one mapped then.
+    _close();
+    _open();
+
+    vector < byte_t > bytes(HEADER_BYTES, 0x00);
+    bytes.reserve(HEADER_BYTES + ((_records + _stored.size()) * RECORD_BYTES));
+
+    // Merge the stored entries into the (sorted) mapped records.
+    std::map < Key, vector < byte_t > >::const_iterator it = _stored.begin();
+    uint64_t count = 0;
+
+    for (uint64_t i = 0; i < _records; ++i)
+    {
+        const byte_t *record = _map + HEADER_BYTES + (i * RECORD_BYTES);
+        Key key = _recordKey(record);
+
+        for (; (it != _stored.end()) && (it->first < key); ++it, ++count)
+            bytes.insert(bytes.end(), it->second.begin(), it->second.end());
+
+        if ((it != _stored.end()) && !(key < it->first))
+            continue;  // Replaced by the stored entry.
+
+        bytes.insert(bytes.end(), record, record + RECORD_BYTES);
+        ++count;
+    }
+
+    for (; it != _stored.end(); ++it, ++count)
+        bytes.insert(bytes.end(), it->second.begin(), it->second.end());
+
+    memcpy(&bytes[0], CACHE_MAGIC, 4);
+    _store64(&bytes[4], (uint64_t)VERSION | ((uint64_t)RECORD_BYTES << 32));
+    _store64(&bytes[16], count);
+
+    bool saved = Checkpoint::replaceFile(_path, bytes);
+
+    if (saved)
+    {
+        _close();
+        _open();
+        _stored.clear();
+    }
+
+    close(lock);
+
+    return saved;
+}
+
+/******************************************************
+**                  Static Methods                   **
+******************************************************/
+
+/** Find the default location of the cache file:
+ *  $XDG_CACHE_HOME/gash/digests, or ~/.cache/gash/digests.
+ *
+ *  @pre none.
+ *  @post The directory of the cache is created if necessary.
+ *  @return The path of the cache file (empty if there is no home
+ *          directory).
+*/
+string DigestCache::defaultPath (void)
+{
+    string directory;
+    const char *cacheHome = getenv("XDG_CACHE_HOME");
+    const char *home = getenv("HOME");
+
+    if ((cacheHome != NULL) && (cacheHome[0] == '/'))
+        directory = cacheHome;
+    else if ((home != NULL) && (home[0] != '\0'))
+        directory = string(home) + "/.cache";
+    else
+        return "";
+
+    mkdir(directory.c_str(), 0700);
+    directory += "/gash";
+    mkdir(directory.c_str(), 0700);
+
+    return directory + "/digests";
+}
+
+/******************************************************
+**                   Helper Methods                  **
+******************************************************/
+
+/** Compare two keys (by device, inode and then algorithm).
+ *
+ *  @param rhs The key to compare with.
+ *  @return true This key sorts before rhs.
+*/
+bool DigestCache::Key::operator < (const Key &rhs) const
+{
+    if (device != rhs.device)
+        return (device < rhs.device);
+
+    if (inode != rhs.inode)
+        return (inode < rhs.inode);
+
+    return (memcmp(algorithm, rhs.algorithm, NAME_BYTES) < 0);
+}
+
+/** Map the cache file and check its header.
+ *
+ *  @pre The cache is not mapped.
+ *  @post The valid cache file is mapped.
+ *  @return none.
+*/
+void DigestCache::_open (void)
+{
+    int fd = open(_path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+
+    struct stat status;
+    if ((fstat(fd, &status) != 0) || (status.st_size < (off_t)HEADER_BYTES))
+    {
+        close(fd);
+        return;
+    }
+
+    size_t length = (size_t)status.st_size;
+    void *map = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (map == MAP_FAILED)
+        return;
+
+    const byte_t *bytes = (const byte_t *)map;
+    uint64_t records = _load64(bytes + 16);
+
+    // A cache of another layout (or a torn one) is ignored and will be
+    // replaced by the next save().
+    if (   (memcmp(bytes, CACHE_MAGIC, 4) != 0)
+        || (_load64(bytes + 4) != ((uint64_t)VERSION
+                                   | ((uint64_t)RECORD_BYTES << 32)))
+        || (records > ((length - HEADER_BYTES) / RECORD_BYTES))
+        || (length != HEADER_BYTES + (records * RECORD_BYTES)))
+    {
+        munmap(map, length);
+        return;
+    }
+
+    _map = bytes;
+    _mapBytes = length;
+    _records = records;
+
+    return;
+}
+
+/** Unmap the cache file.
+ *
+ *  @pre none.
+ *  @post Nothing is mapped.
+ *  @return none.
+*/
+void DigestCache::_close (void)
+{
+    if (_map != NULL)
+        munmap((void *)_map, _mapBytes);
+
+    _map = NULL;
+    _mapBytes = 0;
+    _records = 0;
+
+    return;
+}
+
+/** Find the mapped record of a key.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @param key The key that is to be found.
+ *  @return A pointer to the record, or NULL.
+*/
+const byte_t * DigestCache::_find (const Key &key) const
+{
+    uint64_t low = 0;
+    uint64_t high = _records;
+
+    while (low < high)
+    {
+        uint64_t middle = low + ((high - low) / 2);
+        const byte_t *record = _map + HEADER_BYTES + (middle * RECORD_BYTES);
+        Key found = _recordKey(record);
+
+        if (found < key)
+            low = middle + 1;
+        else if (key < found)
+            high = middle;
+        else
+            return record;
+    }
+
+    return NULL;
+}
+
+/** Build the key of a file.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @param status The metadata of the file.
+ *  @param name The name of the hash algorithm.
+ *  @param key Receives the key.
+ *  @return true The key was built.
+ *  @return false The name is too long to be cached.
+*/
+bool DigestCache::_makeKey (const struct stat &status, const string &name,
+                            Key &key)
+{
+    if (name.size() > NAME_BYTES)
+        return false;
+
+    key.device = (uint64_t)status.st_dev;
+    key.inode = (uint64_t)status.st_ino;
+    memset(key.algorithm, 0, NAME_BYTES);
+    memcpy(key.algorithm, name.data(), name.size());
+
+    return true;
+}
+
+/** Read the key of a record.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @param record A pointer to the record.
+ *  @return The key of the record.
+*/
+DigestCache::Key DigestCache::_recordKey (const byte_t *record)
+{
+    Key key;
+
+    key.device = _load64(record + DEVICE_AT);
+    key.inode = _load64(record + INODE_AT);
+    memcpy(key.algorithm, record + NAME_AT, NAME_BYTES);
+
+    return key;
+}
+
+/** Read a little-endian 64-bit value.
+ *
+ *  @param bytes A pointer to the value.
+ *  @return The value.
+*/
+uint64_t DigestCache::_load64 (const byte_t *bytes)
+{
+    uint64_t value = 0;
+
+    for (int i = 7; i >= 0; --i)
+        value = (value << 8) | bytes[i];
+
+    return value;
+}
+
+/** Write a little-endian 64-bit value.
+ *
+ *  @param bytes A pointer to the destination.
+ *  @param value The value that is to be written.
+ *  @return none.
+*/
+void DigestCache::_store64 (byte_t *bytes, uint64_t value)
+{
+    for (int i = 0; i < 8; ++i)
+        bytes[i] = (byte_t)(value >> (8 * i));
+
+    return;
+}
\ No newline at end of file
@@ -0,0 +1,273 @@
+/******************************************************************************
+||  digest_cache.h                                                           ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    A persistent cache of file digests, so that a repeated sweep does not  ||
+||    read the files that have not changed.  Entries are keyed by the device ||
+||    and inode of a file and the hash algorithm, and are only trusted while ||
+||    the size, modification time and status change time (both in            ||
+||    nanoseconds) of the file are those that the digest was calculated for. ||
+||                                                                           ||
+||    The cache is a header followed by fixed size records sorted by key.    ||
+||    It is mapped into memory (mmap) and searched in place, so a lookup     ||
+||    costs a binary search and no parsing; new digests are merged into a    ||
+||    fresh copy of the file when the sweep ends.  The merge holds an flock  ||
+||    on a lock file beside the cache and starts from the file as it is on   ||
+||    disk then, so that gash, the daemon and watch keep each other's        ||
+||    entries.                                                               ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    checkpoint.cpp (checkpoint.lib)                                        ||
+||    checkpoint.h                                                           ||
+||    Hashes/hash_abstract.cpp (hash_abstract.lib)                           ||
+||    Hashes/hash_abstract.h                                                 ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file digest_cache.h
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+#ifndef _GH_DIGEST_CACHE_DEF_H
+#define _GH_DIGEST_CACHE_DEF_H
+
+#include <map>
+#include <sys/stat.h>
+
+#include "Hashes/hash_abstract.h"
+
+/**
+ *  @class DigestCache A persistent cache of file digests.
+*/
+class DigestCache
+{
+  public:
+    /******************************************************
+    **                     Constants                     **
+    ******************************************************/
+
+    /// The layout version of the file; other versions are ignored.
+    static const uint32_t VERSION = 1;
+
+    /// The longest algorithm name (and digest) that can be cached.
+    static const uint32_t NAME_BYTES = 16;
+    static const uint32_t DIGEST_BYTES = 64;
+
+    /// The size of the file header and of each record.
+    static const uint32_t HEADER_BYTES = 32;
+    static const uint32_t RECORD_BYTES = 128;
+
+    /******************************************************
+    **            Constructors / Destructors             **
+    ******************************************************/
+
+    /** Initialize a DigestCache object.
+     *
+     *  @pre none.
+     *  @post The cache file is mapped if it exists and is valid;
+     *        otherwise the cache starts out empty.
+     *  @param path The cache file.
+    */
+    DigestCache (const string &path);
+
+    /** Default destructor (unmaps the cache file).  */
+    ~DigestCache ();
+
+    /******************************************************
+    **               Accessors / Mutators                **
+    ******************************************************/
+
+    ////////////////////
+    //    Getters
+    ////////////////////
+
+    /** Retrieve the name of the cache file.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return The path of the cache file.
+    */
+    const string & path (void) const;
+
+    /** Look up the digest of a file.
+     *
+     *  @pre status was filled by stat() for the file.
+     *  @post On success the _hash values of hash hold the digest.
+     *  @param status The metadata of the file.
+     *  @param hash A hash object of the algorithm that is wanted.
+     *  @return true The digest was cached for this version of the file.
+     *  @return false There is no (current) entry.
+    */
+    bool lookup (const struct stat &status, MessageHash &hash) const;
+
+    ////////////////////
+    //    Setters
+    ////////////////////
+
+    /** Remember the digest of a file until save().
+     *
+     *  @pre status was filled by stat() before the file was read and
+     *       hash holds the digest of the file.
+     *  @post The digest replaces any entry of the file.
+     *  @param status The metadata of the file.
+     *  @param hash The finalized hash of the file.
+     *  @return none.
+    */
+    void store (const struct stat &status, const MessageHash &hash);
+
+    /** Write the cache file if any digest was stored.  The file is
+     *  replaced atomically, so concurrent readers see the old or the
+     *  new cache; writers take turns on the lock file (<path>.lock), and
+     *  each merges its entries into the cache that the last one wrote.
+     *
+     *  @pre none.
+     *  @post The cache file holds the entries on disk and the stored
+     *        ones, and is mapped again; nothing is left stored.
+     *  @return true The cache is up to date on disk.
+     *  @return false The cache file could not be written (the stored
+     *          entries are kept).
+    */
+    bool save (void);
+
+    /******************************************************
+    **                  Static Methods                   **
+    ******************************************************/
+
+    /** Find the default location of the cache file:
+     *  $XDG_CACHE_HOME/gash/digests, or ~/.cache/gash/digests.
+     *
+     *  @pre none.
+     *  @post The directory of the cache is created if necessary.
+     *  @return The path of the cache file (empty if there is no home
+     *          directory).
+    */
+    static string defaultPath (void);
+
+  private:
+    /******************************************************
+    **                      Members                      **
+    ******************************************************/
+
+    /**
+     *  @struct Key The identity of an entry.
+    */
+    struct Key
+    {
+        uint64_t device;
+        uint64_t inode;
+        char algorithm[NAME_BYTES];  // Zero padded.
+
+        bool operator < (const Key &rhs) const;
+    };
+
+    string _path;               // The cache file.
+    const byte_t *_map;         // The mapped cache file (or NULL).
+    size_t _mapBytes;           // The length of the mapping.
+    uint64_t _records;          // The number of mapped records.
+
+    // The entries stored during this run (encoded records).
+    std::map < Key, vector < byte_t > > _stored;
+
+    /******************************************************
+    **                   Helper Methods                  **
+    ******************************************************/
+
+    /** Map the cache file and check its header.
+     *
+     *  @pre The cache is not mapped.
+     *  @post The valid cache file is mapped.
+     *  @return none.
+    */
+    void _open (void);
+
+    /** Unmap the cache file.
+     *
+     *  @pre none.
+     *  @post Nothing is mapped.
+     *  @return none.
+    */
+    void _close (void);
+
+    /** Find the mapped record of a key.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @param key The key that is to be found.
+     *  @return A pointer to the record, or NULL.
+    */
+    const byte_t * _find (const Key &key) const;
+
+    /** Build the key of a file.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @param status The metadata of the file.
+     *  @param name The name of the hash algorithm.
+     *  @param key Receives the key.
+     *  @return true The key was built.
+     *  @return false The name is too long to be cached.
+    */
+    static bool _makeKey (const struct stat &status, const string &name,
+                          Key &key);
+
+    /** Read the key of a record.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @param record A pointer to the record.
+     *  @return The key of the record.
+    */
+    static Key _recordKey (const byte_t *record);
+
+    /** Read a little-endian 64-bit value.
+     *
+     *  @param bytes A pointer to the value.
+     *  @return The value.
+    */
+    static uint64_t _load64 (const byte_t *bytes);
+
+    /** Write a little-endian 64-bit value.
+     *
+     *  @param bytes A pointer to the destination.
+     *  @param value The value that is to be written.
+     *  @return none.
+    */
+    static void _store64 (byte_t *bytes, uint64_t value);
+
+};  // End class DigestCache.
+
+#endif
\ No newline at end of file
@@ -0,0 +1,662 @@
+/******************************************************************************
+||  direct_reader.cpp                                                        ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    Reads whole files for hashing without leaving them in the page cache,  ||
+||    so that a sweep of a file system does not evict the working set of the ||
+||    other processes on the host.  Files are opened with O_DIRECT and read  ||
+||    into aligned buffers straight from the device.                         ||
+||                                                                           ||
+||    Where O_DIRECT is refused (tmpfs, some network and FUSE file systems)  ||
+||    the file is read through the cache and the pages that the read brought ||
+||    in are dropped again with posix_fadvise(POSIX_FADV_DONTNEED).  The     ||
+||    pages that were cached before the read (checked with mincore()) are    ||
+||    left alone, since another process is using them (see CacheGuard).      ||
+||                                                                           ||
+||    The holes of a sparse file are not read at all: the reads stop at the  ||
+||    end of each extent of data (found with lseek(SEEK_DATA / SEEK_HOLE)),  ||
+||    and skipHole() passes over the hole that follows, for the caller to    ||
+||    hash as zeros with MessageHash::updateZeros().                         ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    Hashes/hash_abstract.cpp (hash_abstract.lib)                           ||
+||    Hashes/hash_abstract.h                                                 ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file direct_reader.cpp
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+
+#ifndef _GNU_SOURCE
+  #define _GNU_SOURCE               // O_DIRECT
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "direct_reader.h"
+
+const uint32_t DirectReader::ALIGNMENT;
+const uint32_t DirectReader::READ_BUFFER_BYTES;
+
+const uint32_t CacheGuard::WINDOW_BYTES;
+const uint32_t CacheGuard::DROP_BYTES;
+
+/******************************************************
+**            Constructors / Destructors             **
+******************************************************/
+
+/** Initialize a DirectReader object.
+ *
+ *  @pre bufferBytes is a positive multiple of ALIGNMENT.
+ *  @post hash() reads files bufferBytes at a time.
+ *  @param bufferBytes The size of each read.
+*/
+DirectReader::DirectReader (uint32_t bufferBytes)
+    : _buffer(NULL),
+      _bufferBytes(bufferBytes),
+      _fd(-1),
+      _direct(false),
+      _bypassed(false),
+      _fileSize(0),
+      _sparse(false),
+      _dataEnd(0),
+      _offset(0),
+      _bytesRead(0)
+{}
+
+/** Default destructor.  */
+DirectReader::~DirectReader ()
+{
+    close();
+    free(_buffer);
+}
+
+/******************************************************
+**               Accessors / Mutators                **
+******************************************************/
+
+////////////////////
+//    Getters
+////////////////////
+
+/** Determine whether the last file was opened with O_DIRECT.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return true The file bypassed the page cache.
+ *  @return false It was read through the cache (and dropped, if it
+ *          was opened to bypass it).
+*/
+bool DirectReader::bypassed (void) const
+{
+    return _bypassed;
+}
+
+/** Retrieve the size of the open file.
+ *
+ *  @pre open() succeeded.
+ *  @post none.
+ *  @return The size in bytes when it was opened.
+*/
+uint64_t DirectReader::fileSize (void) const
+{
+    return _fileSize;
+}
+
+/** Retrieve the number of bytes read from the last file.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return The bytes read (the holes that were skipped are not
+ *          counted).
+*/
+uint64_t DirectReader::bytesRead (void) const
+{
+    return _bytesRead;
+}
+
+/******************************************************
+**                      Methods                      **
+******************************************************/
+
+/** Open a file.
+ *
+ *  @pre none.
+ *  @post Any file that was open is closed.
+ *  @param path The file.
+ *  @param bypass Whether to read around the page cache; if false the
+ *         file is read through the cache as usual.
+ *  @return true The file was opened.
+ *  @return false It could not be opened.
+*/
+bool DirectReader::open (const string &path, bool bypass)
+{
+    close();
+
+    _direct = false;
+    _fd = bypass ? openFile(path, _direct) : ::open(path.c_str(), O_RDONLY);
+    if (_fd < 0)
+        return false;
+
+    struct stat status;
+    bool known = (fstat(_fd, &status) == 0);
+
+    _fileSize = known ? (uint64_t)status.st_size : 0;
+
+    // Only a file that has fewer blocks than its size can have holes, so
+    // the others are read without looking for them.
+    _sparse = known && ((uint64_t)status.st_blocks * 512 < _fileSize);
+    _dataEnd = _sparse ? 0 : _fileSize;
+    _bypassed = _direct;
+    _offset = 0;
+    _bytesRead = 0;
+
+    if (!_direct)
+        posix_fadvise(_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    // Where O_DIRECT is refused, what is read is dropped again.
+    _cache.attach((bypass && !_direct) ? _fd : -1);
+
+    return true;
+}
+
+/** Read the next block of the open file.
+ *
+ *  @pre open() succeeded; buffer is aligned to ALIGNMENT and bytes is
+ *       a multiple of it.
+ *  @post The block is in buffer.
+ *  @param buffer Receives the block.
+ *  @param bytes The size of buffer.
+ *  @return The number of bytes read (short at the end of the file),
+ *          0 at the end of the file, or -1 if the file could not be
+ *          read.
+*/
+int64_t DirectReader::read (byte_t *buffer, uint32_t bytes)
+{
+    for (;;)
+    {
+        // Stop at the next hole, which skipHole() passes over.
+        if ((_dataEnd > _offset) && (_dataEnd < _fileSize)
+            && (_dataEnd - _offset < bytes))
+            bytes = (uint32_t)(_dataEnd - _offset);
+
+        _cache.prepare(_offset, bytes);
+
+        ssize_t length = pread(_fd, buffer, bytes, (off_t)_offset);
+
+        if ((length < 0) && (errno == EINTR))
+            continue;
+
+        // Some file systems accept O_DIRECT when the file is opened, but
+        // not for reads (or not at this alignment).
+        if ((length < 0) && (errno == EINVAL) && _direct)
+        {
+            _readCached();
+            continue;
+        }
+
+        if (length <= 0)
+            return (length < 0) ? -1 : 0;
+
+        // The block is copied out of the cache, so its pages can go.
+        _cache.release(_offset, (uint64_t)length);
+
+        _offset += (uint64_t)length;
+        _bytesRead += (uint64_t)length;
+
+        // A short direct read ends at the end of the file, which is not
+        // aligned, so the (empty) read that confirms it is not direct.
+        if (_direct && ((uint64_t)length % ALIGNMENT != 0))
+            _readCached();
+
+        return (int64_t)length;
+    }
+}
+
+/** Pass over the hole (if any) at the position of the next read, so
+ *  that it is not read.  A read stops at the start of a hole.
+ *
+ *  @pre open() succeeded.
+ *  @post The next read is at the end of the hole.
+ *  @return The length of the hole in bytes (0 if the next read is of
+ *          data, or at the end of the file); the caller hashes it as
+ *          that many zero bytes.
+*/
+uint64_t DirectReader::skipHole (void)
+{
+    if ((_fd < 0) || (_offset < _dataEnd) || (_offset >= _fileSize))
+        return 0;
+
+    off_t data = lseek(_fd, (off_t)_offset, SEEK_DATA);
+
+    if (data < 0)
+    {
+        // The file system cannot tell where the data is, so the rest of
+        // the file is read.
+        if (errno != ENXIO)
+        {
+            _dataEnd = _fileSize;
+            return 0;
+        }
+
+        // There is no data after the offset: the file ends in a hole.
+        data = (off_t)_fileSize;
+    }
+
+    off_t hole = ((uint64_t)data < _fileSize)
+                 ? lseek(_fd, data, SEEK_HOLE) : data;
+
+    if (hole < 0)
+        hole = (off_t)_fileSize;
+
+    // The extents are in blocks of the file system, but they are rounded
+    // to ALIGNMENT so that the reads stay aligned for O_DIRECT (the ends
+    // of a hole are then read as data, which hashes the same).
+    uint64_t start = (uint64_t)data - (uint64_t)data % ALIGNMENT,
+             end = (uint64_t)hole + (ALIGNMENT - 1);
+
+    end -= end % ALIGNMENT;
+
+    if (start < _offset)
+        start = _offset;
+
+    if (start > _fileSize)
+        start = _fileSize;
+
+    if (end > _fileSize)
+        end = _fileSize;
+
+    _dataEnd = end;
+
+    if (start == _offset)
+        return 0;
+
+    uint64_t zeros = start - _offset;
+
+    _offset = start;
+    _cache.skip(start);
+
+    return zeros;
+}
+
+/** Close the file (if it is open).
+ *
+ *  @pre none.
+ *  @post No file is open, and the last of its pages that were read
+ *        into the cache are dropped.
+ *  @return none.
+*/
+void DirectReader::close (void)
+{
+    if (_fd < 0)
+        return;
+
+    _cache.flush();
+    _cache.attach(-1);
+    ::close(_fd);
+    _fd = -1;
+
+    return;
+}
+
+/** Hash a file.
+ *
+ *  @pre none.
+ *  @post On success hash holds the (finalized) digest of the file.
+ *  @param path The file.
+ *  @param hash The hash; it is reset first.
+ *  @return true The file was hashed.
+ *  @return false It could not be opened or read.
+*/
+bool DirectReader::hash (const string &path, MessageHash &hash)
+{
+    // The buffer is only allocated once a file is read.
+    if (_buffer == NULL)
+    {
+        void *memory = NULL;
+        if (posix_memalign(&memory, ALIGNMENT, _bufferBytes) != 0)
+            return false;
+
+        _buffer = (byte_t *)memory;
+    }
+
+    if (!open(path))
+        return false;
+
+    int64_t length;
+
+    hash.reset();
+
+    for (;;)
+    {
+        uint64_t zeros = skipHole();
+        if (zeros > 0)
+            hash.updateZeros(zeros);
+
+        if ((length = read(_buffer, _bufferBytes)) <= 0)
+            break;
+
+        hash.update(_buffer, (uint64_t)length);
+    }
+
+    close();
+
+    if (length < 0)
+        return false;
+
+    hash.finalize();
+
+    return true;
+}
+
+/******************************************************
+**                  Static Methods                   **
+******************************************************/
+
+/** Open a file for reading with O_DIRECT, or without it if the file
+ *  system refuses it.
+ *
+ *  @pre none.
+ *  @post The caller owns (and must close) the descriptor.
+ *  @param path The file.
+ *  @param direct Receives whether O_DIRECT was used.
+ *  @return The descriptor, or -1 if the file could not be opened.
+*/
+int DirectReader::openFile (const string &path, bool &direct)
+{
+    int fd = ::open(path.c_str(), O_RDONLY | O_DIRECT);
+
+    direct = (fd >= 0);
+    if (direct || (errno != EINVAL))
+        return fd;
+
+    return ::open(path.c_str(), O_RDONLY);
+}
+
+/******************************************************
+**                   Helper Methods                  **
+******************************************************/
+
+/** Read through the page cache from now on (O_DIRECT is refused).
+ *
+ *  @return none.
+*/
+void DirectReader::_readCached (void)
+{
+    int flags = fcntl(_fd, F_GETFL);
+    if (flags >= 0)
+        fcntl(_fd, F_SETFL, flags & ~O_DIRECT);
+
+    posix_fadvise(_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    _direct = false;
+    _cache.attach(_fd);
+
+    return;
+}
+
+/******************************************************
+**                    CacheGuard                     **
+******************************************************/
+
+/** Initialize a CacheGuard object.
+ *
+ *  @pre none.
+ *  @post No file is guarded.
+*/
+CacheGuard::CacheGuard ()
+    : _fd(-1),
+      _first(0),
+      _released(0),
+      _dropped(0)
+{}
+
+/** Guard a file (that is about to be read through the cache).
+ *
+ *  @pre none.
+ *  @post Any earlier file is forgotten (its pages are not dropped).
+ *  @param fd The file.
+ *  @return none.
+*/
+void CacheGuard::attach (int fd)
+{
+    _fd = fd;
+    _first = 0;
+    _released = 0;
+    _dropped = 0;
+    _windows.clear();
+
+    return;
+}
+
+/** Prepare to read a range of the file.
+ *
+ *  @pre attach() has been called.
+ *  @post The residency of the range, and of the window after it, has
+ *        been sampled.
+ *  @param offset The first byte of the range.
+ *  @param length The number of bytes.
+ *  @return none.
+*/
+void CacheGuard::prepare (uint64_t offset, uint64_t length)
+{
+    if (_fd < 0)
+        return;
+
+    // The kernel reads ahead of a read by far less than a window, so
+    // a window that is sampled while the one before it is being read has
+    // not been touched yet.
+    uint64_t last = (offset + length) / WINDOW_BYTES + 1;
+
+    if (_windows.empty())
+        _first = offset / WINDOW_BYTES;
+
+    while (_first + _windows.size() <= last)
+        _sample();
+
+    return;
+}
+
+/** Drop the pages of a range that has been read (and used).  The
+ *  ranges must be released in the order of the file.
+ *
+ *  @pre prepare() was called for the range before it was read.
+ *  @post The pages of the range that were not cached when it was
+ *        sampled are dropped (some of them only by a later release() or
+ *        flush()).
+ *  @param offset The first byte of the range.
+ *  @param length The number of bytes.
+ *  @return none.
+*/
+void CacheGuard::release (uint64_t offset, uint64_t length)
+{
+    if (_fd < 0)
+        return;
+
+    if (_released == _dropped)
+        _dropped = offset;
+
+    _released = offset + length;
+
+    // The cache holds a file in folios of up to a few MiB (aligned to
+    // their size), and a folio is only dropped if all of it is, so the
+    // pages are dropped in whole DROP_BYTES blocks.
+    uint64_t end = _released - _released % DROP_BYTES;
+    if (end > _dropped)
+    {
+        _drop(_dropped, end);
+        _dropped = end;
+    }
+
+    return;
+}
+
+/** Drop the pages of the ranges released since the last block.
+ *
+ *  @pre none.
+ *  @post Every released page that was not cached before is dropped.
+ *  @return none.
+*/
+void CacheGuard::flush (void)
+{
+    if ((_fd >= 0) && (_released > _dropped))
+        _drop(_dropped, _released);
+
+    _dropped = _released;
+
+    return;
+}
+
+/** Move on past a range that is not read (a hole of the file).
+ *
+ *  @pre attach() has been called.
+ *  @post The ranges released so far are dropped (as by flush()), and
+ *        the windows before offset are forgotten.
+ *  @param offset The position of the next read.
+ *  @return none.
+*/
+void CacheGuard::skip (uint64_t offset)
+{
+    if (_fd < 0)
+        return;
+
+    flush();
+
+    // The windows of the hole are not sampled; prepare() starts again at
+    // the window of the offset.
+    while (!_windows.empty() && ((_first + 1) * WINDOW_BYTES <= offset))
+    {
+        _windows.erase(_windows.begin());
+        ++_first;
+    }
+
+    return;
+}
+
+/** Drop the pages of [from, to) that were not cached when they were
+ *  sampled, and forget the windows before to.  */
+void CacheGuard::_drop (uint64_t from, uint64_t to)
+{
+    static const uint64_t PAGE = (uint64_t)sysconf(_SC_PAGESIZE);
+
+    uint64_t page = from / PAGE,
+             end = (to + PAGE - 1) / PAGE;
+
+    while (page < end)
+    {
+        uint64_t window = page * PAGE / WINDOW_BYTES;
+
+        // Pages before the first window kept were never sampled.
+        if (window < _first)
+        {
+            page = (_first * WINDOW_BYTES) / PAGE;
+            continue;
+        }
+
+        if (window >= _first + _windows.size())
+            break;
+
+        const vector < byte_t > &resident = _windows[window - _first];
+        uint64_t base = window * WINDOW_BYTES / PAGE,
+                 stop = (window + 1) * WINDOW_BYTES / PAGE;
+
+        if (stop > end)
+            stop = end;
+
+        // Drop each run of pages that was not cached before.
+        while (page < stop)
+        {
+            if (!resident.empty() && (resident[page - base] & 1))
+            {
+                ++page;
+                continue;
+            }
+
+            uint64_t run = page;
+            while ((run < stop)
+                   && (resident.empty() || !(resident[run - base] & 1)))
+                ++run;
+
+            posix_fadvise(_fd, (off_t)(page * PAGE),
+                          (off_t)((run - page) * PAGE), POSIX_FADV_DONTNEED);
+            page = run;
+        }
+    }
+
+    // Forget the windows that are behind the reads.
+    while (!_windows.empty() && ((_first + 1) * WINDOW_BYTES <= to))
+    {
+        _windows.erase(_windows.begin());
+        ++_first;
+    }
+
+    return;
+}
+
+/** Sample the residency of the window after the last one.  */
+void CacheGuard::_sample (void)
+{
+    static const uint64_t PAGE = (uint64_t)sysconf(_SC_PAGESIZE);
+
+    uint64_t window = _first + _windows.size();
+    _windows.push_back(vector < byte_t >());
+
+    // Mapping the window (past the end of the file is allowed) does not
+    // read it; mincore() reports which of its pages are cached.  If that
+    // fails the residency is unknown, and every page is dropped.
+    void *map = mmap(NULL, WINDOW_BYTES, PROT_READ, MAP_SHARED, _fd,
+                     (off_t)(window * WINDOW_BYTES));
+    if (map == MAP_FAILED)
+        return;
+
+    vector < byte_t > &resident = _windows.back();
+    resident.resize((size_t)(WINDOW_BYTES / PAGE));
+
+    if (mincore(map, WINDOW_BYTES, &resident[0]) != 0)
+        resident.clear();
+
+    munmap(map, WINDOW_BYTES);
+
+    return;
+}
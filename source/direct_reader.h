@@ -0,0 +1,343 @@
+/******************************************************************************
+||  direct_reader.h                                                          ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    Reads whole files for hashing without leaving them in the page cache,  ||
+||    so that a sweep of a file system does not evict the working set of the ||
+||    other processes on the host.  Files are opened with O_DIRECT and read  ||
+||    into aligned buffers straight from the device.                         ||
+||                                                                           ||
+||    Where O_DIRECT is refused (tmpfs, some network and FUSE file systems)  ||
+||    the file is read through the cache and the pages that the read brought ||
+||    in are dropped again with posix_fadvise(POSIX_FADV_DONTNEED).  The     ||
+||    pages that were cached before the read (checked with mincore()) are    ||
+||    left alone, since another process is using them (see CacheGuard).      ||
+||                                                                           ||
+||    The holes of a sparse file are not read at all: the reads stop at the  ||
+||    end of each extent of data (found with lseek(SEEK_DATA / SEEK_HOLE)),  ||
+||    and skipHole() passes over the hole that follows, for the caller to    ||
+||    hash as zeros with MessageHash::updateZeros().                         ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    Hashes/hash_abstract.cpp (hash_abstract.lib)                           ||
+||    Hashes/hash_abstract.h                                                 ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file direct_reader.h
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+
+#ifndef _GH_DIRECT_READER_DEF_H
+#define _GH_DIRECT_READER_DEF_H
+
+#include "Hashes/hash_abstract.h"
+
+/**
+ *  @class CacheGuard Drops the pages that reading a file brings into the
+ *         page cache, but not the pages that were cached before.
+ *
+ *  Which pages are cached is sampled (with mincore()) in windows of
+ *  WINDOW_BYTES, one window ahead of the reads, so that the pages that
+ *  the kernel reads ahead are not mistaken for pages that another
+ *  process had cached.
+*/
+class CacheGuard
+{
+  public:
+    /// The size of each sampled window.
+    static const uint32_t WINDOW_BYTES = 67108864;
+
+    /// The pages are dropped in blocks of this size (larger than a folio).
+    static const uint32_t DROP_BYTES = 4194304;
+
+    /** Initialize a CacheGuard object.
+     *
+     *  @pre none.
+     *  @post No file is guarded.
+    */
+    CacheGuard ();
+
+    /** Guard a file (that is about to be read through the cache).
+     *
+     *  @pre none.
+     *  @post Any earlier file is forgotten (its pages are not dropped).
+     *  @param fd The file.
+     *  @return none.
+    */
+    void attach (int fd);
+
+    /** Prepare to read a range of the file.
+     *
+     *  @pre attach() has been called.
+     *  @post The residency of the range, and of the window after it, has
+     *        been sampled.
+     *  @param offset The first byte of the range.
+     *  @param length The number of bytes.
+     *  @return none.
+    */
+    void prepare (uint64_t offset, uint64_t length);
+
+    /** Drop the pages of a range that has been read (and used).  The
+     *  ranges must be released in the order of the file.
+     *
+     *  @pre prepare() was called for the range before it was read.
+     *  @post The pages of the range that were not cached when it was
+     *        sampled are dropped (some of them only by a later release() or
+     *        flush()).
+     *  @param offset The first byte of the range.
+     *  @param length The number of bytes.
+     *  @return none.
+    */
+    void release (uint64_t offset, uint64_t length);
+
+    /** Drop the pages of the ranges released since the last block.
+     *
+     *  @pre none.
+     *  @post Every released page that was not cached before is dropped.
+     *  @return none.
+    */
+    void flush (void);
+
+    /** Move on past a range that is not read (a hole of the file).
+     *
+     *  @pre attach() has been called.
+     *  @post The ranges released so far are dropped (as by flush()), and
+     *        the windows before offset are forgotten.
+     *  @param offset The position of the next read.
+     *  @return none.
+    */
+    void skip (uint64_t offset);
+
+  private:
+    int _fd;                        // The file.
+    uint64_t _first;                // The first window kept.
+    uint64_t _released;             // The end of the released ranges.
+    uint64_t _dropped;              // The end of the dropped pages.
+    vector < vector < byte_t > > _windows;  // The residency of each page
+                                            // of the windows from _first
+                                            // (empty: unknown).
+
+    /** Sample the residency of the window after the last one.  */
+    void _sample (void);
+
+    /** Drop the pages of [from, to) that were not cached when they were
+     *  sampled, and forget the windows before to.  */
+    void _drop (uint64_t from, uint64_t to);
+
+};  // End class CacheGuard.
+
+/**
+ *  @class DirectReader Reads (and hashes) files without caching them.
+*/
+class DirectReader
+{
+  public:
+    /******************************************************
+    **                     Constants                     **
+    ******************************************************/
+
+    /// The alignment of the buffers, offsets and lengths of direct reads
+    /// (a multiple of the logical block size of every common device).
+    static const uint32_t ALIGNMENT = 4096;
+
+    /// The default size of each read.
+    static const uint32_t READ_BUFFER_BYTES = 4194304;
+
+    /******************************************************
+    **            Constructors / Destructors             **
+    ******************************************************/
+
+    /** Initialize a DirectReader object.
+     *
+     *  @pre bufferBytes is a positive multiple of ALIGNMENT.
+     *  @post hash() reads files bufferBytes at a time.
+     *  @param bufferBytes The size of each read.
+    */
+    DirectReader (uint32_t bufferBytes = READ_BUFFER_BYTES);
+
+    /** Default destructor.  */
+    ~DirectReader ();
+
+    /******************************************************
+    **               Accessors / Mutators                **
+    ******************************************************/
+
+    ////////////////////
+    //    Getters
+    ////////////////////
+
+    /** Determine whether the last file was opened with O_DIRECT.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return true The file bypassed the page cache.
+     *  @return false It was read through the cache (and dropped, if it
+     *          was opened to bypass it).
+    */
+    bool bypassed (void) const;
+
+    /** Retrieve the size of the open file.
+     *
+     *  @pre open() succeeded.
+     *  @post none.
+     *  @return The size in bytes when it was opened.
+    */
+    uint64_t fileSize (void) const;
+
+    /** Retrieve the number of bytes read from the last file.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return The bytes read (the holes that were skipped are not
+     *          counted).
+    */
+    uint64_t bytesRead (void) const;
+
+    /******************************************************
+    **                      Methods                      **
+    ******************************************************/
+
+    /** Open a file.
+     *
+     *  @pre none.
+     *  @post Any file that was open is closed.
+     *  @param path The file.
+     *  @param bypass Whether to read around the page cache; if false the
+     *         file is read through the cache as usual.
+     *  @return true The file was opened.
+     *  @return false It could not be opened.
+    */
+    bool open (const string &path, bool bypass = true);
+
+    /** Read the next block of the open file.
+     *
+     *  @pre open() succeeded; buffer is aligned to ALIGNMENT and bytes is
+     *       a multiple of it.
+     *  @post The block is in buffer.
+     *  @param buffer Receives the block.
+     *  @param bytes The size of buffer.
+     *  @return The number of bytes read (short at the end of the file),
+     *          0 at the end of the file, or -1 if the file could not be
+     *          read.
+    */
+    int64_t read (byte_t *buffer, uint32_t bytes);
+
+    /** Pass over the hole (if any) at the position of the next read, so
+     *  that it is not read.  A read stops at the start of a hole.
+     *
+     *  @pre open() succeeded.
+     *  @post The next read is at the end of the hole.
+     *  @return The length of the hole in bytes (0 if the next read is of
+     *          data, or at the end of the file); the caller hashes it as
+     *          that many zero bytes.
+    */
+    uint64_t skipHole (void);
+
+    /** Close the file (if it is open).
+     *
+     *  @pre none.
+     *  @post No file is open, and the last of its pages that were read
+     *        into the cache are dropped.
+     *  @return none.
+    */
+    void close (void);
+
+    /** Hash a file.
+     *
+     *  @pre none.
+     *  @post On success hash holds the (finalized) digest of the file.
+     *  @param path The file.
+     *  @param hash The hash; it is reset first.
+     *  @return true The file was hashed.
+     *  @return false It could not be opened or read.
+    */
+    bool hash (const string &path, MessageHash &hash);
+
+    /******************************************************
+    **                  Static Methods                   **
+    ******************************************************/
+
+    /** Open a file for reading with O_DIRECT, or without it if the file
+     *  system refuses it.
+     *
+     *  @pre none.
+     *  @post The caller owns (and must close) the descriptor.
+     *  @param path The file.
+     *  @param direct Receives whether O_DIRECT was used.
+     *  @return The descriptor, or -1 if the file could not be opened.
+    */
+    static int openFile (const string &path, bool &direct);
+
+  private:
+    /******************************************************
+    **                      Members                      **
+    ******************************************************/
+
+    byte_t *_buffer;                // The (aligned) buffer of hash().
+    uint32_t _bufferBytes;          // Its size.
+    int _fd;                        // The open file.
+    bool _direct;                   // It is being read with O_DIRECT.
+    bool _bypassed;                 // It was opened with O_DIRECT.
+    CacheGuard _cache;              // Drops what it reads through the cache
+                                    // (if it bypasses the cache).
+    uint64_t _fileSize;             // Its size.
+    bool _sparse;                   // It has holes (fewer blocks than
+                                    // its size).
+    uint64_t _dataEnd;              // The end of the extent of data that
+                                    // is being read (the next hole).
+    uint64_t _offset;               // The position of the next read.
+    uint64_t _bytesRead;            // The bytes read from the last file.
+
+    /******************************************************
+    **                   Helper Methods                  **
+    ******************************************************/
+
+    /** Read through the page cache from now on (O_DIRECT is refused).
+     *
+     *  @return none.
+    */
+    void _readCached (void);
+
+    // Not copyable (owns _buffer and _fd).
+    DirectReader (const DirectReader &);
+    DirectReader & operator = (const DirectReader &);
+
+};  // End class DirectReader.
+
+#endif
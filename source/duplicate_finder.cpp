@@ -0,0 +1,524 @@
+/******************************************************************************
+||  duplicate_finder.cpp                                                     ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    Finds the files of a set that have identical contents.  The candidates ||
+||    are narrowed in stages, so that most files are never read in full:     ||
+||    files are first grouped by size (and files of a unique size are        ||
+||    discarded), then by a fingerprint of their first and last 64 KiB, and  ||
+||    only the survivors are hashed in full with a strong digest.            ||
+||                                                                           ||
+||    The reads of each stage are spread over a pool of threads.  Hard links ||
+||    to the same file are read once and listed together.                    ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    duplicate_finder.h                                                     ||
+||    Hashes/hash_abstract.cpp (hash_abstract.lib)                           ||
+||    Hashes/hash_abstract.h                                                 ||
+||    Hashes/xxh3.cpp (xxh3.lib)                                             ||
+||    Hashes/xxh3.h                                                          ||
+||    pthread                                                                ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file duplicate_finder.cpp
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <map>
+
+#include "duplicate_finder.h"
+#include "Hashes/xxh3.h"
+
+const uint32_t DuplicateFinder::SAMPLE_BYTES;
+const uint32_t DuplicateFinder::READ_BUFFER_BYTES;
+
+/**
+ *  @struct KeyJob The work shared by the threads of a stage.
+*/
+struct DuplicateFinder::KeyJob
+{
+    vector < Candidate > *candidates;
+    const vector < size_t > *work;
+    bool full;
+    const MessageHash *prototype;
+
+    pthread_mutex_t lock;           // Guards next and bytes.
+    size_t next;                    // The next entry of work to take.
+    uint64_t bytes;                 // The bytes read so far.
+};
+
+/** Order groups of candidates by their first members.  */
+static bool firstMemberBefore (const vector < size_t > &lhs,
+                               const vector < size_t > &rhs)
+{
+    return (lhs[0] < rhs[0]);
+}
+
+/******************************************************
+**            Constructors / Destructors             **
+******************************************************/
+
+/** Initialize a DuplicateFinder object.
+ *
+ *  @pre none.
+ *  @post The full digests are computed with clones of prototype, on
+ *        one thread per online processor.
+ *  @param prototype A (reset) hash object of the confirming
+ *         algorithm; it is copied.
+*/
+DuplicateFinder::DuplicateFinder (const MessageHash &prototype)
+    : _prototype(prototype.clone()),
+      _threads(1),
+      _bytesRead(0)
+{
+    setThreads(0);
+}
+
+/** Default destructor.  */
+DuplicateFinder::~DuplicateFinder ()
+{
+    delete _prototype;
+}
+
+/******************************************************
+**               Accessors / Mutators                **
+******************************************************/
+
+////////////////////
+//    Getters
+////////////////////
+
+/** Retrieve the number of threads that read the files.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return The number of threads.
+*/
+uint32_t DuplicateFinder::threads (void) const
+{
+    return _threads;
+}
+
+/** Retrieve the files that the last find() could not read.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return The names of the files (which are in no group).
+*/
+const vector < string > & DuplicateFinder::unreadable (void) const
+{
+    return _unreadable;
+}
+
+/** Retrieve the number of bytes read by the last find().
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return The bytes read from the candidates.
+*/
+uint64_t DuplicateFinder::bytesRead (void) const
+{
+    return _bytesRead;
+}
+
+////////////////////
+//    Setters
+////////////////////
+
+/** Select the number of threads that read the files.
+ *
+ *  @pre none.
+ *  @post Subsequent calls to find() use the given number of threads.
+ *  @param threads The number of threads; zero selects one thread for
+ *         each online processor.
+ *  @return none.
+*/
+void DuplicateFinder::setThreads (uint32_t threads)
+{
+    if (threads == 0)
+    {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (online > 0) ? (uint32_t)online : 1;
+    }
+
+    _threads = threads;
+
+    return;
+}
+
+/******************************************************
+**                      Methods                      **
+******************************************************/
+
+/** Find the files with identical contents.  Empty files and files
+ *  that cannot be read are ignored.
+ *
+ *  @pre none.
+ *  @post unreadable() lists the files that could not be read.
+ *  @param files The files to compare.
+ *  @param groups Receives each set of two or more distinct files
+ *         with identical contents, in the order of files.
+ *  @return none.
+*/
+void DuplicateFinder::find (const vector < string > &files,
+                            vector < Group > &groups)
+{
+    vector < Candidate > candidates;
+    std::map < std::pair < uint64_t, uint64_t >, size_t > inodes;
+    std::map < uint64_t, vector < size_t > > sizes;
+
+    groups.clear();
+    _unreadable.clear();
+    _bytesRead = 0;
+
+    // Stage 1: group the files by size.  Only the metadata is read, and
+    // the names of a hard linked file join its first name.
+    for (size_t i = 0; i < files.size(); ++i)
+    {
+        struct stat status;
+
+        if (stat(files[i].c_str(), &status) != 0)
+        {
+            _unreadable.push_back(files[i]);
+            continue;
+        }
+
+        if (!S_ISREG(status.st_mode) || (status.st_size == 0))
+            continue;
+
+        std::pair < uint64_t, uint64_t > inode((uint64_t)status.st_dev,
+                                               (uint64_t)status.st_ino);
+        std::map < std::pair < uint64_t, uint64_t >, size_t >::iterator
+            link = inodes.find(inode);
+
+        if (link != inodes.end())
+        {
+            candidates[link->second].names.push_back(files[i]);
+            continue;
+        }
+
+        Candidate candidate;
+        candidate.names.push_back(files[i]);
+        candidate.size = (uint64_t)status.st_size;
+        candidate.failed = false;
+
+        inodes[inode] = candidates.size();
+        sizes[candidate.size].push_back(candidates.size());
+        candidates.push_back(candidate);
+    }
+
+    vector < vector < size_t > > sameSize;
+    for (std::map < uint64_t, vector < size_t > >::iterator it =
+             sizes.begin(); it != sizes.end(); ++it)
+    {
+        if (it->second.size() > 1)
+            sameSize.push_back(it->second);
+    }
+
+    std::sort(sameSize.begin(), sameSize.end(), firstMemberBefore);
+
+    // Stage 2: fingerprint the ends of the files that are large enough
+    // for that to save reading them in full.
+    vector < size_t > work;
+    for (size_t g = 0; g < sameSize.size(); ++g)
+    {
+        if (candidates[sameSize[g][0]].size > 2 * (uint64_t)SAMPLE_BYTES)
+            work.insert(work.end(), sameSize[g].begin(), sameSize[g].end());
+    }
+
+    _computeKeys(candidates, work, false);
+
+    vector < vector < size_t > > sampled, small;
+    for (size_t g = 0; g < sameSize.size(); ++g)
+    {
+        if (candidates[sameSize[g][0]].size > 2 * (uint64_t)SAMPLE_BYTES)
+            sampled.push_back(sameSize[g]);
+        else
+            small.push_back(sameSize[g]);
+    }
+
+    _regroup(candidates, sampled);
+
+    // Stage 3: confirm the survivors with their full digests.
+    vector < vector < size_t > > survivors(small);
+    survivors.insert(survivors.end(), sampled.begin(), sampled.end());
+    std::sort(survivors.begin(), survivors.end(), firstMemberBefore);
+
+    work.clear();
+    for (size_t g = 0; g < survivors.size(); ++g)
+        work.insert(work.end(), survivors[g].begin(), survivors[g].end());
+
+    _computeKeys(candidates, work, true);
+    _regroup(candidates, survivors);
+
+    for (size_t g = 0; g < survivors.size(); ++g)
+    {
+        Group group;
+        group.size = candidates[survivors[g][0]].size;
+        group.digest = candidates[survivors[g][0]].key;
+
+        for (size_t m = 0; m < survivors[g].size(); ++m)
+        {
+            const vector < string > &names =
+                candidates[survivors[g][m]].names;
+            group.names.insert(group.names.end(), names.begin(),
+                               names.end());
+        }
+
+        groups.push_back(group);
+    }
+
+    return;
+}
+
+/******************************************************
+**                   Helper Methods                  **
+******************************************************/
+
+/** Compute the key of every candidate of a stage in parallel.
+ *
+ *  @pre none.
+ *  @post The key (or failed) of each listed candidate is set.
+ *  @param candidates All of the candidates.
+ *  @param work The indices of the candidates to key.
+ *  @param full true to hash the whole file, false to fingerprint it.
+ *  @return none.
+*/
+void DuplicateFinder::_computeKeys (vector < Candidate > &candidates,
+                                    const vector < size_t > &work, bool full)
+{
+    if (work.empty())
+        return;
+
+    KeyJob job;
+    job.candidates = &candidates;
+    job.work = &work;
+    job.full = full;
+    job.prototype = _prototype;
+    job.next = 0;
+    job.bytes = 0;
+    pthread_mutex_init(&job.lock, NULL);
+
+    // This thread is one of the workers.
+    uint32_t threads = (_threads < work.size()) ? _threads
+                                                : (uint32_t)work.size();
+    vector < pthread_t > workers(threads);
+    vector < bool > started(threads, false);
+
+    for (uint32_t t = 1; t < threads; ++t)
+        started[t] = (pthread_create(&workers[t], NULL, _worker, &job) == 0);
+
+    _worker(&job);
+
+    for (uint32_t t = 1; t < threads; ++t)
+    {
+        if (started[t])
+            pthread_join(workers[t], NULL);
+    }
+
+    pthread_mutex_destroy(&job.lock);
+    _bytesRead += job.bytes;
+
+    for (size_t i = 0; i < work.size(); ++i)
+    {
+        const Candidate &candidate = candidates[work[i]];
+
+        if (candidate.failed)
+            _unreadable.push_back(candidate.names[0]);
+    }
+
+    return;
+}
+
+/** Split groups of candidates by their keys, dropping the candidates
+ *  that failed and the groups that end up with a single member.
+ *
+ *  @pre The keys of every candidate in groups are set.
+ *  @post groups holds the refined groups, in the order of their first
+ *        members.
+ *  @param candidates All of the candidates.
+ *  @param groups The groups of candidate indices.
+ *  @return none.
+*/
+void DuplicateFinder::_regroup (vector < Candidate > &candidates,
+                                vector < vector < size_t > > &groups)
+{
+    vector < vector < size_t > > refined;
+
+    for (size_t g = 0; g < groups.size(); ++g)
+    {
+        std::map < vector < byte_t >, vector < size_t > > byKey;
+
+        for (size_t m = 0; m < groups[g].size(); ++m)
+        {
+            const Candidate &candidate = candidates[groups[g][m]];
+
+            if (!candidate.failed)
+                byKey[candidate.key].push_back(groups[g][m]);
+        }
+
+        for (std::map < vector < byte_t >, vector < size_t > >::iterator
+                 it = byKey.begin(); it != byKey.end(); ++it)
+        {
+            if (it->second.size() > 1)
+                refined.push_back(it->second);
+        }
+    }
+
+    std::sort(refined.begin(), refined.end(), firstMemberBefore);
+    groups.swap(refined);
+
+    return;
+}
+
+/******************************************************
+**                  Static Methods                   **
+******************************************************/
+
+/** The body of each thread of _computeKeys().  */
+void * DuplicateFinder::_worker (void *arg)
+{
+    KeyJob *job = (KeyJob *)arg;
+    MessageHash *hash = job->prototype->clone();
+    vector < byte_t > buffer(READ_BUFFER_BYTES);
+    uint64_t bytes = 0;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&job->lock);
+        size_t next = job->next++;
+        pthread_mutex_unlock(&job->lock);
+
+        if (next >= job->work->size())
+            break;
+
+        Candidate &candidate = (*job->candidates)[(*job->work)[next]];
+        bytes += _key(candidate, job->full, *hash, &buffer[0]);
+    }
+
+    pthread_mutex_lock(&job->lock);
+    job->bytes += bytes;
+    pthread_mutex_unlock(&job->lock);
+
+    delete hash;
+
+    return NULL;
+}
+
+/** Read a file and set its key.
+ *
+ *  @param candidate The file.
+ *  @param full true to hash the whole file with hash, false to
+ *         fingerprint its first and last SAMPLE_BYTES.
+ *  @param hash The confirming hash (only used when full is set).
+ *  @param buffer A buffer of READ_BUFFER_BYTES.
+ *  @return The number of bytes read.
+*/
+uint64_t DuplicateFinder::_key (Candidate &candidate, bool full,
+                                MessageHash &hash, byte_t *buffer)
+{
+    int fd = open(candidate.names[0].c_str(), O_RDONLY);
+    uint64_t total = 0;
+
+    if (fd < 0)
+    {
+        candidate.failed = true;
+        return 0;
+    }
+
+    if (full)
+    {
+        posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        hash.reset();
+
+        for (;;)
+        {
+            ssize_t length = read(fd, buffer, READ_BUFFER_BYTES);
+
+            if (length <= 0)
+            {
+                candidate.failed = (length < 0);
+                break;
+            }
+
+            hash.update(buffer, (uint64_t)length);
+            total += (uint64_t)length;
+        }
+
+        hash.finalize();
+        candidate.key = hash.asBytes();
+    }
+    else
+    {
+        // The samples do not overlap (stage 2 only sees files larger
+        // than two samples).
+        XXH3_64 fingerprint;
+        off_t offsets[2] = { 0, (off_t)(candidate.size - SAMPLE_BYTES) };
+
+        for (uint32_t i = 0; i < 2; ++i)
+        {
+            ssize_t length = pread(fd, buffer, SAMPLE_BYTES, offsets[i]);
+
+            if (length != (ssize_t)SAMPLE_BYTES)
+            {
+                candidate.failed = true;
+                break;
+            }
+
+            fingerprint.update(buffer, SAMPLE_BYTES);
+            total += SAMPLE_BYTES;
+        }
+
+        fingerprint.finalize();
+        candidate.key = fingerprint.asBytes();
+    }
+
+    // A file that changed size since it was grouped is left out.
+    if (full && (total != candidate.size))
+        candidate.failed = true;
+
+    close(fd);
+
+    return total;
+}
\ No newline at end of file
@@ -0,0 +1,249 @@
+/******************************************************************************
+||  duplicate_finder.h                                                       ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    Finds the files of a set that have identical contents.  The candidates ||
+||    are narrowed in stages, so that most files are never read in full:     ||
+||    files are first grouped by size (and files of a unique size are        ||
+||    discarded), then by a fingerprint of their first and last 64 KiB, and  ||
+||    only the survivors are hashed in full with a strong digest.            ||
+||                                                                           ||
+||    The reads of each stage are spread over a pool of threads.  Hard links ||
+||    to the same file are read once and listed together.                    ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    Hashes/hash_abstract.cpp (hash_abstract.lib)                           ||
+||    Hashes/hash_abstract.h                                                 ||
+||    Hashes/xxh3.cpp (xxh3.lib)                                             ||
+||    Hashes/xxh3.h                                                          ||
+||    pthread                                                                ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file duplicate_finder.h
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+
+#ifndef _GH_DUPLICATE_FINDER_DEF_H
+#define _GH_DUPLICATE_FINDER_DEF_H
+
+#include "Hashes/hash_abstract.h"
+
+/**
+ *  @class DuplicateFinder Groups files by their contents.
+*/
+class DuplicateFinder
+{
+  public:
+    /******************************************************
+    **                     Constants                     **
+    ******************************************************/
+
+    /// The bytes at each end of a file that make up its fingerprint.
+    static const uint32_t SAMPLE_BYTES = 65536;
+
+    /// The size of the buffer that each thread reads files with.
+    static const uint32_t READ_BUFFER_BYTES = 1048576;
+
+    /**
+     *  @struct Group A set of files with identical contents.
+    */
+    struct Group
+    {
+        uint64_t size;              // The size of each file.
+        vector < byte_t > digest;   // The digest of each file.
+        vector < string > names;    // The files (hard links are adjacent).
+    };
+
+    /******************************************************
+    **            Constructors / Destructors             **
+    ******************************************************/
+
+    /** Initialize a DuplicateFinder object.
+     *
+     *  @pre none.
+     *  @post The full digests are computed with clones of prototype, on
+     *        one thread per online processor.
+     *  @param prototype A (reset) hash object of the confirming
+     *         algorithm; it is copied.
+    */
+    DuplicateFinder (const MessageHash &prototype);
+
+    /** Default destructor.  */
+    ~DuplicateFinder ();
+
+    /******************************************************
+    **               Accessors / Mutators                **
+    ******************************************************/
+
+    ////////////////////
+    //    Getters
+    ////////////////////
+
+    /** Retrieve the number of threads that read the files.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return The number of threads.
+    */
+    uint32_t threads (void) const;
+
+    /** Retrieve the files that the last find() could not read.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return The names of the files (which are in no group).
+    */
+    const vector < string > & unreadable (void) const;
+
+    /** Retrieve the number of bytes read by the last find().
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return The bytes read from the candidates.
+    */
+    uint64_t bytesRead (void) const;
+
+    ////////////////////
+    //    Setters
+    ////////////////////
+
+    /** Select the number of threads that read the files.
+     *
+     *  @pre none.
+     *  @post Subsequent calls to find() use the given number of threads.
+     *  @param threads The number of threads; zero selects one thread for
+     *         each online processor.
+     *  @return none.
+    */
+    void setThreads (uint32_t threads);
+
+    /******************************************************
+    **                      Methods                      **
+    ******************************************************/
+
+    /** Find the files with identical contents.  Empty files and files
+     *  that cannot be read are ignored.
+     *
+     *  @pre none.
+     *  @post unreadable() lists the files that could not be read.
+     *  @param files The files to compare.
+     *  @param groups Receives each set of two or more distinct files
+     *         with identical contents, in the order of files.
+     *  @return none.
+    */
+    void find (const vector < string > &files, vector < Group > &groups);
+
+  private:
+    /******************************************************
+    **                      Members                      **
+    ******************************************************/
+
+    /**
+     *  @struct Candidate A file (and its hard links) under comparison.
+    */
+    struct Candidate
+    {
+        vector < string > names;    // The names of the file.
+        uint64_t size;              // The size of the file.
+        vector < byte_t > key;      // The fingerprint or the digest.
+        bool failed;                // The file could not be read.
+    };
+
+    struct KeyJob;                  // The shared state of _computeKeys().
+
+    MessageHash *_prototype;        // The confirming algorithm.
+    uint32_t _threads;              // The threads that read the files.
+    uint64_t _bytesRead;            // The bytes read by find().
+    vector < string > _unreadable;  // The files find() could not read.
+
+    // Not copyable (owns _prototype).
+    DuplicateFinder (const DuplicateFinder &);
+    DuplicateFinder & operator = (const DuplicateFinder &);
+
+    /******************************************************
+    **                   Helper Methods                  **
+    ******************************************************/
+
+    /** Compute the key of every candidate of a stage in parallel.
+     *
+     *  @pre none.
+     *  @post The key (or failed) of each listed candidate is set.
+     *  @param candidates All of the candidates.
+     *  @param work The indices of the candidates to key.
+     *  @param full true to hash the whole file, false to fingerprint it.
+     *  @return none.
+    */
+    void _computeKeys (vector < Candidate > &candidates,
+                       const vector < size_t > &work, bool full);
+
+    /** Split groups of candidates by their keys, dropping the candidates
+     *  that failed and the groups that end up with a single member.
+     *
+     *  @pre The keys of every candidate in groups are set.
+     *  @post groups holds the refined groups, in the order of their first
+     *        members.
+     *  @param candidates All of the candidates.
+     *  @param groups The groups of candidate indices.
+     *  @return none.
+    */
+    void _regroup (vector < Candidate > &candidates,
+                   vector < vector < size_t > > &groups);
+
+    /******************************************************
+    **                  Static Methods                   **
+    ******************************************************/
+
+    /** The body of each thread of _computeKeys().  */
+    static void * _worker (void *arg);
+
+    /** Read a file and set its key.
+     *
+     *  @param candidate The file.
+     *  @param full true to hash the whole file with hash, false to
+     *         fingerprint its first and last SAMPLE_BYTES.
+     *  @param hash The confirming hash (only used when full is set).
+     *  @param buffer A buffer of READ_BUFFER_BYTES.
+     *  @return The number of bytes read.
+    */
+    static uint64_t _key (Candidate &candidate, bool full, MessageHash &hash,
+                          byte_t *buffer);
+
+};  // End class DuplicateFinder.
+
+#endif
\ No newline at end of file
@@ -4,7 +4,7 @@
 ||                                                                           ||
 ||    Author: Gary Hammock, PE                                               ||
 ||    Creation Date: 2008-09-17                                              ||
-||    Last Edit Date: 2014-02-28                                             ||
+||    Last Edit Date: 2026-10-16                                             ||
 ||                                                                           ||
 ||===========================================================================||
 ||  DESCRIPTION                                                              ||
@@ -40,23 +40,389 @@
 
 /** @file gash.cpp
  *  @author Gary Hammock, PE
- *  @date 2014-02-28
+ *  @date 2026-10-16
 */
 
+#include <fcntl.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <algorithm>
+
 #include "gash.h"
 
+///////////////////////////////////////
+//    Hash types
+////////////////////////
+
+/**
+ *  @struct HashType A command line flag and the hash it selects.
+*/
+struct HashType
+{
+    const char *flag;               // The command line flag.
+    const char *label;              // The label printed before the hash.
+    MessageHash * (*create)(void);  // Allocates the hash object.
+};
+
+/** Allocate a hash object of type T.
+ *
+ *  @pre none.
+ *  @post The caller owns (and must delete) the object.
+ *  @return A new T object.
+*/
+template < class T >
+static MessageHash * newHash (void)
+{
+    return new T();
+}
+
+static const HashType HASH_TYPES[] =
+{
+    { "-md5",        "MD5: ",         newHash < MD5 >        },
+    { "-sha1",       "SHA-1: ",       newHash < SHA1 >       },
+    { "-sha224",     "SHA-224: ",     newHash < SHA224 >     },
+    { "-sha256",     "SHA-256: ",     newHash < SHA256 >     },
+    { "-sha384",     "SHA-384: ",     newHash < SHA384 >     },
+    { "-sha512",     "SHA-512: ",     newHash < SHA512 >     },
+    { "-sha512_256", "SHA-512/256: ", newHash < SHA512_256 > },
+    { "-blake3",     "BLAKE3: ",      newHash < BLAKE3 >     },
+    { "-blake2b",    "BLAKE2b-512: ", newHash < BLAKE2b >    },
+    { "-blake2bp",   "BLAKE2bp: ",    newHash < BLAKE2bp >   },
+    { "-blake2s",    "BLAKE2s-256: ", newHash < BLAKE2s >    },
+    { "-blake2sp",   "BLAKE2sp: ",    newHash < BLAKE2sp >   },
+    { "-xxh64",      "XXH64: ",       newHash < XXH64 >      },
+    { "-xxh3",       "XXH3-64: ",     newHash < XXH3_64 >    },
+    { "-xxh128",     "XXH3-128: ",    newHash < XXH3_128 >   },
+    { "-crc",        "CRC: ",         newHash < CRC32 >      },
+    { "-elf",        "ELF: ",         newHash < ELF >        },
+    { "-adler32",    "Adler32: ",     newHash < Adler32 >    }
+};
+
+static const size_t HASH_TYPE_COUNT = sizeof(HASH_TYPES) / sizeof(HashType);
+
 int main (int argc, char *argv[])
 {
-    ifstream file;  // A handle to the file to be hashed.
-    string filename(argv[argc - 1]);
-    stringstream arg;
-    bool noFile = false;
+    Options options;             // The options of this run.
+    vector < string > args;      // The arguments that are not options.
+
+    options.checkpoint = false;
+    options.checkpointInterval = Checkpoint::DEFAULT_INTERVAL;
+    options.incremental = false;
+    options.useCache = true;
+    options.verifyCache = false;
+    options.useXattr = false;
+    options.chunkMin = Chunker::DEFAULT_MIN_BYTES;
+    options.chunkAverage = Chunker::DEFAULT_AVERAGE_BYTES;
+    options.chunkMax = Chunker::DEFAULT_MAX_BYTES;
+    options.blockBytes = 0;
+    options.uringDepth = 0;
+    options.uringBatch = 0;
+    options.direct = false;
+    options.buffers = PrefetchReader::DEFAULT_BUFFERS;
+    options.threads = 0;
+    options.debounce = TreeWatcher::DEFAULT_DEBOUNCE;
+    options.json = NULL;
+    options.progress = NULL;
+    options.perf = NULL;
+
+    bool jsonOutput = false;     // Report in NDJSON.
+    bool showProgress = false;   // Draw the progress line.
+    bool perfReport = false;     // Report the hardware counters.
+
+    // Separate the long options from the hash type and file names.
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg(argv[i]);
+
+        if (arg == "--checkpoint")
+            options.checkpoint = true;
+        else if (arg.compare(0, 13, "--checkpoint=") == 0)
+        {
+            options.checkpoint = true;
+            options.checkpointFile = arg.substr(13);
+        }
+        else if (arg == "--incremental")
+            options.incremental = true;
+        else if (arg.compare(0, 14, "--incremental=") == 0)
+        {
+            options.incremental = true;
+            options.tailFile = arg.substr(14);
+        }
+        else if (arg.compare(0, 22, "--checkpoint-interval=") == 0)
+        {
+            char *end = NULL;
+            unsigned long seconds = strtoul(arg.c_str() + 22, &end, 10);
+
+            if ((end == arg.c_str() + 22) || (*end != '\0')
+                || (seconds == 0) || (seconds > 0xFFFFFFFFUL))
+            {
+                cerr << "Error: invalid checkpoint interval \""
+                     << arg.substr(22) << "\".";
+
+                return 1;
+            }
+
+            options.checkpointInterval = (uint32_t)seconds;
+        }
+        else if (arg == "--no-cache")
+            options.useCache = false;
+        else if (arg == "--verify-cache")
+            options.verifyCache = true;
+        else if (arg.compare(0, 8, "--cache=") == 0)
+            options.cacheFile = arg.substr(8);
+        else if (arg == "--xattr")
+            options.useXattr = true;
+        else if (arg.compare(0, 13, "--chunk-size=") == 0)
+        {
+            unsigned long sizes[3] = { 0, 0, 0 };
+            const char *text = arg.c_str() + 13;
+            char *end = NULL;
+
+            for (uint32_t s = 0; s < 3; ++s)
+            {
+                sizes[s] = strtoul(text, &end, 10);
+                if ((end == text) || (*end != ((s < 2) ? ':' : '\0')))
+                    break;
+
+                text = end + 1;
+            }
+
+            if ((*end != '\0') || (sizes[2] > 0xFFFFFFFFUL)
+                || !Chunker::validSizes((uint32_t)sizes[0],
+                                        (uint32_t)sizes[1],
+                                        (uint32_t)sizes[2]))
+            {
+                cerr << "Error: invalid chunk sizes \"" << arg.substr(13)
+                     << "\" (MIN:AVG:MAX, with " << Chunker::WINDOW_BYTES
+                     << " <= MIN <= AVG <= MAX <= " << Chunker::MAX_CHUNK_BYTES
+                     << ").";
+
+                return 1;
+            }
+
+            options.chunkMin = (uint32_t)sizes[0];
+            options.chunkAverage = (uint32_t)sizes[1];
+            options.chunkMax = (uint32_t)sizes[2];
+        }
+        else if (arg.compare(0, 13, "--block-size=") == 0)
+        {
+            char *end = NULL;
+            unsigned long bytes = strtoul(arg.c_str() + 13, &end, 10);
+
+            if ((end == arg.c_str() + 13) || (*end != '\0')
+                || (bytes < Signature::MIN_BLOCK_BYTES)
+                || (bytes > Signature::MAX_BLOCK_BYTES))
+            {
+                cerr << "Error: invalid block size \"" << arg.substr(13)
+                     << "\" (" << Signature::MIN_BLOCK_BYTES << " to "
+                     << Signature::MAX_BLOCK_BYTES << " bytes).";
+
+                return 1;
+            }
+
+            options.blockBytes = (uint32_t)bytes;
+        }
+        else if (arg == "--io-uring")
+        {
+            options.uringDepth = UringReader::DEFAULT_QUEUE_DEPTH;
+            options.uringBatch = UringReader::DEFAULT_BATCH;
+        }
+        else if (arg.compare(0, 11, "--io-uring=") == 0)
+        {
+            const char *text = arg.c_str() + 11;
+            char *end = NULL;
+            unsigned long depth = strtoul(text, &end, 10),
+                          batch = UringReader::DEFAULT_BATCH;
+
+            if ((end != text) && (*end == ':'))
+            {
+                text = end + 1;
+                batch = strtoul(text, &end, 10);
+            }
+            else if (batch > depth)
+                batch = depth;
+
+            if ((end == text) || (*end != '\0') || (depth > 0xFFFFFFFFUL)
+                || (batch > 0xFFFFFFFFUL)
+                || !UringReader::validSettings((uint32_t)depth,
+                                               (uint32_t)batch,
+                                               UringReader::DEFAULT_READ_BYTES))
+            {
+                cerr << "Error: invalid io_uring settings \"" << arg.substr(11)
+                     << "\" (DEPTH[:BATCH], with 1 <= BATCH <= DEPTH <= "
+                     << UringReader::MAX_QUEUE_DEPTH << ").";
+
+                return 1;
+            }
+
+            options.uringDepth = (uint32_t)depth;
+            options.uringBatch = (uint32_t)batch;
+        }
+        else if (arg == "--json")
+            jsonOutput = true;
+        else if (arg == "--progress")
+            showProgress = true;
+        else if (arg == "--perf")
+            perfReport = true;
+        else if (arg == "--direct")
+            options.direct = true;
+        else if (arg == "--tee")
+            options.teeFile = "-";
+        else if ((arg.compare(0, 6, "--tee=") == 0) && (arg.size() > 6))
+            options.teeFile = arg.substr(6);
+        else if (arg.compare(0, 10, "--buffers=") == 0)
+        {
+            char *end = NULL;
+            unsigned long count = strtoul(arg.c_str() + 10, &end, 10);
+
+            if ((end == arg.c_str() + 10) || (*end != '\0') || (count < 1)
+                || (count > PrefetchReader::MAX_BUFFERS))
+            {
+                cerr << "Error: invalid buffer count \"" << arg.substr(10)
+                     << "\" (1 to " << PrefetchReader::MAX_BUFFERS << ").";
+
+                return 1;
+            }
+
+            options.buffers = (uint32_t)count;
+        }
+        else if (arg.compare(0, 9, "--socket=") == 0)
+            options.socketPath = arg.substr(9);
+        else if (arg.compare(0, 10, "--threads=") == 0)
+        {
+            char *end = NULL;
+            unsigned long count = strtoul(arg.c_str() + 10, &end, 10);
+
+            if ((end == arg.c_str() + 10) || (*end != '\0') || (count < 1)
+                || (count > HashDaemon::MAX_THREADS))
+            {
+                cerr << "Error: invalid thread count \"" << arg.substr(10)
+                     << "\" (1 to " << HashDaemon::MAX_THREADS << ").";
+
+                return 1;
+            }
+
+            options.threads = (uint32_t)count;
+        }
+        else if (arg.compare(0, 11, "--debounce=") == 0)
+        {
+            char *end = NULL;
+            unsigned long interval = strtoul(arg.c_str() + 11, &end, 10);
+
+            if ((end == arg.c_str() + 11) || (*end != '\0')
+                || (interval > 3600000))
+            {
+                cerr << "Error: invalid debounce interval \"" << arg.substr(11)
+                     << "\" (0 to 3600000 milliseconds).";
+
+                return 1;
+            }
+
+            options.debounce = (uint32_t)interval;
+        }
+        else if (arg.compare(0, 8, "--range=") == 0)
+        {
+            if (!RangeHasher::parse(arg.substr(8), options.ranges))
+            {
+                cerr << "Error: invalid byte ranges \"" << arg.substr(8)
+                     << "\" (OFFSET:LENGTH[,OFFSET:LENGTH]...).";
+
+                return 1;
+            }
+        }
+        else
+            args.push_back(arg);
+    }
+
+    // Run as gashd, gash is the daemon.
+    string program(argv[0]);
+    if ((program.size() >= 5)
+        && (program.compare(program.size() - 5, 5, "gashd") == 0)
+        && ((program.size() == 5) || (program[program.size() - 6] == '/')))
+        args.insert(args.begin(), "daemon");
+
+    // The data passes through standard output, so the report goes to
+    // standard error.
+    if (options.teeFile == "-")
+        cout.rdbuf(cerr.rdbuf());
+
+    // The records go where the report would, one per line, without the
+    // banner.
+    JsonWriter json((options.teeFile == "-") ? STDERR_FILENO
+                                             : STDOUT_FILENO);
+
+    if (jsonOutput)
+        options.json = &json;
+    else
+        cout << "Gash version: " << _VERSION_ << endl;
+
+    if (options.checkpoint && options.incremental)
+    {
+        cerr << "Error: --checkpoint and --incremental cannot be combined.";
+
+        return 1;
+    }
+
+    if ((options.uringDepth > 0)
+        && (options.checkpoint || options.incremental
+            || !options.ranges.empty()))
+    {
+        cerr << "Error: --io-uring cannot be combined with --checkpoint,"
+             << " --incremental or --range.";
+
+        return 1;
+    }
+
+    if (options.direct
+        && (options.checkpoint || options.incremental
+            || !options.ranges.empty()))
+    {
+        cerr << "Error: --direct cannot be combined with --checkpoint,"
+             << " --incremental or --range.";
+
+        return 1;
+    }
+
+    if (!options.teeFile.empty()
+        && (options.checkpoint || options.incremental || options.direct
+            || (options.uringDepth > 0) || !options.ranges.empty()))
+    {
+        cerr << "Error: --tee cannot be combined with --checkpoint,"
+             << " --incremental, --direct, --io-uring or --range.";
+
+        return 1;
+    }
+
+    if (!options.ranges.empty() && (options.checkpoint || options.incremental))
+    {
+        cerr << "Error: --range cannot be combined with --checkpoint or"
+             << " --incremental.";
+
+        return 1;
+    }
+
+    if (!options.ranges.empty() && showProgress)
+    {
+        cerr << "Error: --progress cannot be combined with --range.";
+
+        return 1;
+    }
+
+    if (perfReport
+        && (options.checkpoint || options.incremental
+            || (options.uringDepth > 0) || !options.ranges.empty()))
+    {
+        cerr << "Error: --perf cannot be combined with --checkpoint,"
+             << " --incremental, --io-uring or --range.";
 
-    cout << "Gash version: " << _VERSION_ << endl;
+        return 1;
+    }
 
-    // If too few or too many arguments were given,
-    // display the usage information.
-    if ((argc < 2) || (argc > 3))
+    // If no arguments were given, display the usage information.
+    if (args.empty())
     {
         displayHelp();
 
@@ -67,58 +433,259 @@ int main (int argc, char *argv[])
     }
 
     // Handle the non-file flags.
-    arg << argv[1];
-    if (argc == 2)
+    if (args.size() == 1)
     {
-        if (arg.str() == "-c")
+        if (args[0] == "-c")
         {
-            noFile = true;
             dispCredits();
+            cout << endl << endl;
+
+            return 0;
         }
-        else if (arg.str() == "-h")
+        else if (args[0] == "-h")
         {
-            noFile = true;
             displayHelp();
+            cout << endl << endl;
+
+            return 0;
         }
     }
 
-    // Check to make sure that we can access the file specified by the caller.
-    if (!noFile)
+    // gash daemon (or gashd) serves the clients of the socket.
+    if (!args.empty() && (args[0] == "daemon"))
     {
-        if (!getFileHandle(filename, file))
+        if (args.size() != 1)
         {
-            cerr << "Error: could not open file \"" << filename << "\".";
+            displayHelp();
+
+            // Tidy up the console.
+            cout << endl << endl;
 
             return 1;
         }
 
-        // Echo the name of the file.
-        cout << "File: " << filename << endl;
+        if ((options.json != NULL) || showProgress || perfReport)
+        {
+            cerr << "Error: --json, --progress and --perf only apply to"
+                 << " hashing files.";
+
+            return 1;
+        }
+
+        return runDaemon(options);
     }
 
-    // If no specific hash algoritm is given use MD5.
-    if ((argc == 2) && (!noFile))
-        cout << "MD5: " << MD5(file);
-    else
+    // gash dupes [<hashType>] <paths>... lists the duplicate files, and
+    // gash chunks [<hashType>] <paths>... the content-defined chunks.
+    // gash watch [<hashType>] <directory> reports the changes to a tree.
+    // gash signature, delta and patch take fixed file arguments.
+    string mode;
+    if ((args.size() > 1)
+        && ((args[0] == "dupes") || (args[0] == "chunks")
+            || (args[0] == "watch") || (args[0] == "signature")
+            || (args[0] == "delta") || (args[0] == "patch")))
     {
-        if (arg.str() == "-sha256")
-            cout << "SHA-256: " << SHA256(file);
-        else if (arg.str() == "-md5")
-            cout << "MD5: " << MD5(file);
-        else if (arg.str() == "-crc")
-            cout << "CRC: " << CRC32(file);
-        else if (arg.str() == "-elf")
-            cout << "ELF: " << ELF(file);
-        else if (arg.str() == "-adler32")
-            cout << "Adler32: " << Adler32(file);
-        else
+        mode = args[0];
+        args.erase(args.begin());
+    }
+
+    if (!mode.empty()
+        && ((options.json != NULL) || showProgress || perfReport))
+    {
+        cerr << "Error: --json, --progress and --perf only apply to hashing"
+             << " files.";
+
+        return 1;
+    }
+
+    // If no specific hash algoritm is given use MD5 (SHA-256 for the
+    // modes).
+    vector < string > paths(args.begin(), args.end());
+    options.hashFlag = mode.empty() ? "-md5" : "-sha256";
+
+    if ((args.size() > 1) && (args[0].size() > 1) && (args[0][0] == '-'))
+    {
+        options.hashFlag = args[0];
+        paths.erase(paths.begin());
+    }
+
+    string label;
+    MessageHash *probe = createHash(options.hashFlag, label);
+    if (probe == NULL)
+    {
+        displayHelp();
+
+        // Tidy up the console.
+        cout << endl << endl;
+
+        return 0;
+    }
+
+    delete probe;
+
+    if ((mode == "signature") || (mode == "delta") || (mode == "patch"))
+    {
+        size_t expected = (mode == "signature") ? 2 : 3;
+
+        if ((paths.size() != expected)
+            || ((mode != "signature") && (options.hashFlag != "-sha256")))
+        {
+            displayHelp();
+
+            // Tidy up the console.
+            cout << endl << endl;
+
+            return 1;
+        }
+
+        if (mode == "signature")
+            return writeSignature(paths[0], paths[1], options);
+
+        if (mode == "delta")
+            return writeDelta(paths[0], paths[1], paths[2]);
+
+        return applyDelta(paths[0], paths[1], paths[2]);
+    }
+
+    if (mode == "watch")
+    {
+        if (paths.size() != 1)
+        {
             displayHelp();
+
+            // Tidy up the console.
+            cout << endl << endl;
+
+            return 1;
+        }
+
+        return runWatch(paths[0], options);
     }
 
-    // Tidy up the console.
-    cout << endl << endl;
+    // Walk any directories (in a stable order).
+    vector < string > files;
+    for (size_t i = 0; i < paths.size(); ++i)
+        collectFiles(paths[i], files);
 
-    return 0;
+    if (mode == "dupes")
+        return findDuplicates(files, options.hashFlag);
+
+    if (mode == "chunks")
+    {
+        int status = 0;
+
+        for (size_t i = 0; i < files.size(); ++i)
+            status |= chunkFile(files[i], options);
+
+        return status;
+    }
+
+    // Byte ranges are neither cached nor checkpointed.
+    if (!options.ranges.empty())
+    {
+        int status = 0;
+
+        for (size_t i = 0; i < files.size(); ++i)
+            status |= hashRanges(files[i], options);
+
+        if ((options.json != NULL) && !options.json->flush())
+        {
+            cerr << "Error: could not write the output." << endl;
+            status = 1;
+        }
+
+        return status;
+    }
+
+    if ((files.size() != 1) && !options.teeFile.empty())
+    {
+        cerr << "Error: --tee can only pass on a single file.";
+
+        return 1;
+    }
+
+    if ((files.size() > 1)
+        && (!options.checkpointFile.empty() || !options.tailFile.empty()))
+    {
+        cerr << "Error: a checkpoint or tail state file can only be named"
+             << " for a single file.";
+
+        return 1;
+    }
+
+    DigestCache *cache = NULL;
+    if (options.useCache)
+    {
+        if (options.cacheFile.empty())
+            options.cacheFile = DigestCache::defaultPath();
+
+        if (!options.cacheFile.empty())
+            cache = new DigestCache(options.cacheFile);
+    }
+
+    // The counters behind --progress and SIGUSR1; the monitor starts
+    // before the threads that hash, so that they leave SIGUSR1 to it.
+    ProgressMonitor progress(showProgress);
+
+    options.progress = &progress;
+    progress.start(files);
+
+    // --perf counts the events of the updates on this thread, which is
+    // the one that hashes.
+    PerfCounters perf;
+    uint64_t runStart = monotonicTime();
+
+    if (perfReport)
+    {
+        perf.open();
+        options.perf = &perf;
+    }
+
+    int status = 0;
+
+    if (options.uringDepth > 0)
+        status = hashFilesAsync(files, options, cache);
+    else
+    {
+        for (size_t i = 0; i < files.size(); ++i)
+        {
+            status |= hashFile(files[i], options, cache);
+            progress.fileDone();
+        }
+    }
+
+    uint64_t runTime = monotonicTime() - runStart;
+
+    progress.stop();
+
+    if (options.perf != NULL)
+    {
+        string label;
+        MessageHash *hash = createHash(options.hashFlag, label);
+
+        perf.report(cerr, hash->algorithmName(), hash->kernelName(),
+                    runTime);
+        delete hash;
+    }
+
+    if (cache != NULL)
+    {
+        if (!cache->save())
+        {
+            cerr << "Warning: could not write the digest cache \""
+                 << cache->path() << "\"." << endl;
+        }
+
+        delete cache;
+    }
+
+    if ((options.json != NULL) && !options.json->flush())
+    {
+        cerr << "Error: could not write the output." << endl;
+        status = 1;
+    }
+
+    return status;
 }
 
 bool getFileHandle (string filename, ifstream &file)
@@ -132,20 +699,1179 @@ bool getFileHandle (string filename, ifstream &file)
         return false;
 }
 
-void displayHelp (void)
+void collectFiles (const string &path, vector < string > &files,
+                   ostream &warnings)
 {
-    cout << "Usage:" << endl
-         << "    gash <hashType> [filename]" << endl
-         << "    gash <options>" << endl
-         << endl
-         << "Where <hashType> can be any of:" << endl
-         << "    -md5 : MD5" << endl
-         << "    -sha256 : SHA-256" << endl
-         << "    -adler32 : Adler-32" << endl
-         << "    -crc : CRC" << endl
-         << "    -elf : ELF" << endl
-         << "And <options> can include:" << endl
-         << "    -c : credits";
+    struct stat status;
+
+    // Files that are named explicitly are always hashed (and errors are
+    // reported by hashFile()); inside directories symbolic links are
+    // skipped so that a sweep cannot loop.
+    if ((stat(path.c_str(), &status) != 0) || !S_ISDIR(status.st_mode))
+    {
+        files.push_back(path);
+        return;
+    }
+
+    DIR *directory = opendir(path.c_str());
+    if (directory == NULL)
+    {
+        warnings << "Warning: could not read directory \"" << path << "\"."
+                 << endl;
+        return;
+    }
+
+    vector < string > names;
+    struct dirent *entry;
+
+    while ((entry = readdir(directory)) != NULL)
+    {
+        string name(entry->d_name);
+        if ((name != ".") && (name != ".."))
+            names.push_back(name);
+    }
+
+    closedir(directory);
+    std::sort(names.begin(), names.end());
+
+    string prefix = path;
+    if (prefix[prefix.size() - 1] != '/')
+        prefix += "/";
+
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+        string child = prefix + names[i];
+
+        if (lstat(child.c_str(), &status) != 0)
+            continue;
+
+        if (S_ISDIR(status.st_mode))
+            collectFiles(child, files, warnings);
+        else if (S_ISREG(status.st_mode))
+            files.push_back(child);
+    }
+
+    return;
+}
+
+int hashFile (const string &filename, const Options &options,
+              DigestCache *cache)
+{
+    ifstream file;    // A handle to the file to be hashed.
+    struct stat before;
+
+    // Standard input ("-"), pipes and devices are streamed: they cannot
+    // be sized, seeked or cached.  So is any file that is passed on.
+    if ((filename == "-") || !options.teeFile.empty()
+        || ((stat(filename.c_str(), &before) == 0)
+            && !S_ISREG(before.st_mode)))
+        return hashStream(filename, options);
+
+    uint64_t start = monotonicTime();
+
+    // Check to make sure that we can access the file specified by the caller.
+    if ((stat(filename.c_str(), &before) != 0)
+        || !getFileHandle(filename, file))
+    {
+        cerr << "Error: could not open file \"" << filename << "\"." << endl;
+
+        return 1;
+    }
+
+    // Echo the name of the file.
+    if (options.json == NULL)
+        cout << "File: " << filename << "\n";
+
+    uint32_t device = (options.progress != NULL)
+                      ? options.progress->device(before.st_dev) : 0;
+
+    string label;
+    MessageHash *hash = createHash(options.hashFlag, label);
+    FileReport report;
+
+    report.size = (uint64_t)before.st_size;
+    report.cached = false;
+    report.split = false;
+    report.readTime = 0;
+    report.hashTime = 0;
+
+    bool attributed = false;
+    bool cached = lookupDigest(filename, before, options, cache, *hash,
+                               attributed);
+
+    if (cached && !options.verifyCache)
+    {
+        // Files that were renamed or copied with their attributes are
+        // found in the cache from now on.
+        if (attributed && (cache != NULL))
+            cache->store(before, *hash);
+
+        if (options.progress != NULL)
+            options.progress->skip((uint64_t)before.st_size);
+
+        report.cached = true;
+        report.elapsed = monotonicTime() - start;
+        reportDigest(filename, label, *hash, report, options);
+        delete hash;
+
+        return 0;
+    }
+
+    vector < byte_t > cachedDigest;
+    if (cached)
+        cachedDigest = hash->asBytes();
+
+    bool hashed = true;
+
+    if (options.incremental)
+    {
+        string tailFile = options.tailFile.empty() ? (filename + ".gashtail")
+                                                   : options.tailFile;
+
+        TailState tail(tailFile, filename);
+        hashed = hashIncrementally(*hash, file, tail, options.progress,
+                                   device);
+    }
+    else if (options.checkpoint)
+    {
+        string checkpointFile = options.checkpointFile.empty()
+                                ? (filename + ".gashckpt")
+                                : options.checkpointFile;
+
+        Checkpoint job(checkpointFile, filename);
+        hashed = hashWithCheckpoints(*hash, file, job,
+                                     options.checkpointInterval,
+                                     options.progress, device);
+    }
+    else
+    {
+        // One reader (and its I/O thread) serves the whole sweep.
+        static PrefetchReader reader(options.buffers);
+
+        reader.setDirect(options.direct);
+        reader.setProgress(options.progress, device);
+        reader.setPerf(options.perf);
+        hashed = reader.hash(filename, *hash);
+
+        report.split = true;
+        report.readTime = reader.readTime();
+        report.hashTime = reader.hashTime();
+    }
+
+    if (!hashed)
+    {
+        cerr << "Error: could not read file \"" << filename << "\"." << endl;
+        delete hash;
+
+        return 1;
+    }
+
+    report.elapsed = monotonicTime() - start;
+
+    int status = recordDigest(filename, before, options, cache, *hash,
+                              attributed, cachedDigest);
+
+    reportDigest(filename, label, *hash, report, options);
+    delete hash;
+
+    return status;
+}
+
+int hashFilesAsync (const vector < string > &files, const Options &options,
+                    DigestCache *cache)
+{
+    /**
+     *  @struct SweepFile What is known about a file before it is read.
+     */
+    struct SweepFile
+    {
+        struct stat before;         // Its metadata.
+        bool readable;              // It could be stat()ed.
+        bool streamed;              // It is not a regular file.
+        bool attributed;            // Its digest came from an attribute.
+        bool queued;                // It is to be read.
+        vector < byte_t > stored;   // Its cached digest (if any).
+    };
+
+    string label;
+    MessageHash *hash = createHash(options.hashFlag, label);
+    vector < SweepFile > sweep(files.size());
+    vector < string > queued;
+
+    // The stored digests are looked up first, so that only the files
+    // that have to be read are handed to the reader.
+    for (size_t i = 0; i < files.size(); ++i)
+    {
+        SweepFile &file = sweep[i];
+
+        file.readable = (stat(files[i].c_str(), &file.before) == 0);
+        file.streamed = (files[i] == "-")
+                        || (file.readable && !S_ISREG(file.before.st_mode));
+        file.attributed = false;
+        file.queued = false;
+
+        if (!file.readable || file.streamed)
+        {
+            // The streams are counted as they are read (below).
+            if (!file.readable && (options.progress != NULL))
+                options.progress->fileDone();
+
+            continue;
+        }
+
+        if (lookupDigest(files[i], file.before, options, cache, *hash,
+                         file.attributed))
+            file.stored = hash->asBytes();
+
+        file.queued = file.stored.empty() || options.verifyCache;
+        if (file.queued)
+            queued.push_back(files[i]);
+        else if (options.progress != NULL)
+        {
+            options.progress->skip((uint64_t)file.before.st_size);
+            options.progress->fileDone();
+        }
+    }
+
+    if (!UringReader::supported())
+    {
+        cerr << "Warning: io_uring is not available; the files are read"
+             << " with blocking reads." << endl;
+    }
+
+    UringReader reader(*hash, options.uringDepth, options.uringBatch);
+    reader.setDirect(options.direct);
+    reader.setProgress(options.progress);
+    UringReader::Result result;
+    int status = 0;
+
+    reader.start(queued);
+
+    for (size_t i = 0; i < files.size(); ++i)
+    {
+        SweepFile &file = sweep[i];
+
+        // Streams are read in turn, in the order of the list.
+        if (file.streamed)
+        {
+            status |= hashStream(files[i], options);
+
+            if (options.progress != NULL)
+                options.progress->fileDone();
+
+            continue;
+        }
+
+        if (file.queued && reader.next(result) && result.failed)
+            file.readable = false;
+
+        if (!file.readable)
+        {
+            cerr << "Error: could not open file \"" << files[i] << "\"."
+                 << endl;
+            status = 1;
+
+            continue;
+        }
+
+        if (options.json == NULL)
+            cout << "File: " << files[i] << "\n";
+
+        // The reads of the files overlap, so they are not timed one by
+        // one.
+        FileReport report;
+
+        report.size = file.queued ? result.bytes
+                                  : (uint64_t)file.before.st_size;
+        report.cached = !file.queued;
+        report.elapsed = 0;
+        report.split = false;
+        report.readTime = 0;
+        report.hashTime = 0;
+
+        if (file.queued)
+        {
+            hash->setHash(result.digest);
+            status |= recordDigest(files[i], file.before, options, cache,
+                                   *hash, file.attributed, file.stored);
+        }
+        else
+        {
+            hash->setHash(file.stored);
+
+            if (file.attributed && (cache != NULL))
+                cache->store(file.before, *hash);
+        }
+
+        reportDigest(files[i], label, *hash, report, options);
+    }
+
+    delete hash;
+
+    return status;
+}
+
+bool lookupDigest (const string &filename, const struct stat &before,
+                   const Options &options, DigestCache *cache,
+                   MessageHash &hash, bool &attributed)
+{
+    // An unchanged file costs no reads at all.
+    bool cached = (cache != NULL) && cache->lookup(before, hash);
+
+    attributed = !cached && options.useXattr
+                 && DigestAttribute::load(filename, before, hash);
+
+    return cached || attributed;
+}
+
+int recordDigest (const string &filename, struct stat before,
+                  const Options &options, DigestCache *cache,
+                  const MessageHash &hash, bool attributed,
+                  const vector < byte_t > &cachedDigest)
+{
+    int status = 0;
+
+    if (!cachedDigest.empty() && (hash.asBytes() != cachedDigest))
+    {
+        cerr << "Error: \"" << filename << "\" does not match its cached"
+             << " digest." << endl;
+        status = 1;
+    }
+
+    // The digest is only stored if the file did not change while it was
+    // being read.
+    struct stat after;
+    bool unchanged = (stat(filename.c_str(), &after) == 0)
+                     && isUnchanged(before, after)
+                     && (after.st_ctim.tv_sec == before.st_ctim.tv_sec)
+                     && (after.st_ctim.tv_nsec == before.st_ctim.tv_nsec);
+
+    // A verified attribute is left alone (writing it changes the ctime).
+    if (unchanged && options.useXattr && !(attributed && (status == 0)))
+    {
+        if (DigestAttribute::store(filename, before, hash))
+        {
+            unchanged = (stat(filename.c_str(), &after) == 0)
+                        && isUnchanged(before, after);
+            before.st_ctim = after.st_ctim;
+        }
+        else
+        {
+            cerr << "Warning: could not store the digest of \"" << filename
+                 << "\" in an extended attribute." << endl;
+        }
+    }
+
+    if (unchanged && (cache != NULL))
+        cache->store(before, hash);
+
+    return status;
+}
+
+int hashRanges (const string &filename, const Options &options)
+{
+    string label;
+    MessageHash *hash = createHash(options.hashFlag, label);
+    RangeHasher ranges(*hash);
+
+    delete hash;
+
+    if (!ranges.open(filename))
+    {
+        cerr << "Error: could not open file \"" << filename << "\"." << endl;
+
+        return 1;
+    }
+
+    if (options.json == NULL)
+        cout << "File: " << filename << "\n";
+
+    // One line per range: its offset, its length and its digest.
+    for (size_t i = 0; i < options.ranges.size(); ++i)
+    {
+        const RangeHasher::Range &range = options.ranges[i];
+
+        if (!ranges.hash(range))
+        {
+            cerr << "Error: could not read bytes " << range.offset << " to "
+                 << range.offset + range.length << " of \"" << filename
+                 << "\" (" << ranges.fileSize() << " bytes)." << endl;
+
+            return 1;
+        }
+
+        if (options.json != NULL)
+        {
+            JsonWriter &json = *options.json;
+
+            json.beginRecord();
+            json.field("path", filename);
+            json.field("offset", range.offset);
+            json.field("length", range.length);
+            json.field("algorithm", label.substr(0, label.find(':')));
+            json.field("digest", ranges.digest().asString());
+            json.endRecord();
+        }
+        else
+        {
+            cout << "Range " << range.offset << ":" << range.length << " "
+                 << label << ranges.digest() << "\n";
+        }
+    }
+
+    if (options.json == NULL)
+        cout << "\n";
+
+    return 0;
+}
+
+int hashStream (const string &filename, const Options &options)
+{
+    if (options.checkpoint || options.incremental)
+    {
+        cerr << "Error: \"" << filename << "\" is not a regular file; it"
+             << " cannot be checkpointed or hashed incrementally." << endl;
+
+        return 1;
+    }
+
+    bool standardInput = (filename == "-");
+    int in = standardInput ? STDIN_FILENO : open(filename.c_str(), O_RDONLY);
+
+    if (in < 0)
+    {
+        cerr << "Error: could not open file \"" << filename << "\"." << endl;
+
+        return 1;
+    }
+
+    string outputName = (options.teeFile == "-") ? "standard output"
+                                                 : options.teeFile;
+    int out = -1;
+
+    if (options.teeFile == "-")
+        out = STDOUT_FILENO;
+    else if (!options.teeFile.empty())
+    {
+        // Not truncated until it is known not to be the input.
+        out = open(options.teeFile.c_str(), O_WRONLY | O_CREAT, 0666);
+
+        if (out < 0)
+        {
+            cerr << "Error: could not create \"" << outputName << "\"."
+                 << endl;
+
+            if (!standardInput)
+                close(in);
+
+            return 1;
+        }
+    }
+
+    // Passing a file on to itself would truncate it, or read back what is
+    // being written without end.
+    struct stat inStatus,
+                outStatus;
+
+    if ((out >= 0) && (fstat(in, &inStatus) == 0)
+        && (fstat(out, &outStatus) == 0)
+        && (inStatus.st_dev == outStatus.st_dev)
+        && (inStatus.st_ino == outStatus.st_ino))
+    {
+        cerr << "Error: \"" << outputName << "\" is the input \""
+             << filename << "\"; it cannot be passed on to itself." << endl;
+
+        if (!standardInput)
+            close(in);
+        if (out != STDOUT_FILENO)
+            close(out);
+
+        return 1;
+    }
+
+    if ((out >= 0) && (out != STDOUT_FILENO) && (ftruncate(out, 0) != 0))
+    {
+        cerr << "Error: could not create \"" << outputName << "\"." << endl;
+
+        if (!standardInput)
+            close(in);
+        close(out);
+
+        return 1;
+    }
+
+    // Echo the name of the file.
+    if (options.json == NULL)
+        cout << "File: " << filename << endl;
+
+    string label;
+    MessageHash *hash = createHash(options.hashFlag, label);
+    StreamHasher stream;
+    uint64_t start = monotonicTime();
+    struct stat status;
+
+    if ((options.progress != NULL) && (fstat(in, &status) == 0))
+        stream.setProgress(options.progress,
+                           options.progress->device(status.st_dev));
+
+    stream.setPerf(options.perf);
+
+    bool hashed = stream.hash(in, *hash, out),
+         written = !stream.writeFailed();
+
+    if (!standardInput)
+        close(in);
+
+    if ((out >= 0) && (out != STDOUT_FILENO) && (close(out) != 0))
+        written = false;
+
+    if (!written)
+    {
+        cerr << "Error: could not write \"" << outputName << "\"." << endl;
+        delete hash;
+
+        return 1;
+    }
+
+    if (!hashed)
+    {
+        cerr << "Error: could not read file \"" << filename << "\"." << endl;
+        delete hash;
+
+        return 1;
+    }
+
+    FileReport report;
+
+    report.size = stream.bytes();
+    report.cached = false;
+    report.elapsed = monotonicTime() - start;
+    report.split = false;
+    report.readTime = 0;
+    report.hashTime = 0;
+
+    reportDigest(filename, label, *hash, report, options);
+    delete hash;
+
+    return 0;
+}
+
+void reportDigest (const string &filename, const string &label,
+                   const MessageHash &hash, const FileReport &report,
+                   const Options &options)
+{
+    if (options.json == NULL)
+    {
+        cout << label << hash << "\n\n";
+        return;
+    }
+
+    JsonWriter &json = *options.json;
+
+    json.beginRecord();
+    json.field("path", filename);
+    json.field("size", report.size);
+    json.field("algorithm", label.substr(0, label.find(':')));
+    json.field("digest", hash.asString());
+    json.field("cached", report.cached);
+
+    if (report.elapsed > 0)
+    {
+        double seconds = (double)report.elapsed / 1e9;
+
+        json.field("seconds", seconds);
+
+        // The reads may overlap the hashing (on the I/O thread), so the
+        // two can add up to more than the whole.
+        if (report.split)
+        {
+            json.field("read_seconds", (double)report.readTime / 1e9);
+            json.field("hash_seconds", (double)report.hashTime / 1e9);
+        }
+
+        if (!report.cached)
+        {
+            json.field("bytes_per_second",
+                       (uint64_t)((double)report.size / seconds));
+        }
+    }
+
+    json.endRecord();
+
+    return;
+}
+
+int runDaemon (const Options &options)
+{
+    string path = options.socketPath.empty() ? DaemonChannel::defaultPath()
+                                             : options.socketPath;
+
+    DigestCache *cache = NULL;
+    if (options.useCache)
+    {
+        string cacheFile = options.cacheFile.empty()
+                           ? DigestCache::defaultPath() : options.cacheFile;
+
+        if (!cacheFile.empty())
+            cache = new DigestCache(cacheFile);
+    }
+
+    int status = 1;
+
+    // The daemon is destroyed (and its socket removed) before the cache.
+    {
+        HashDaemon daemon(cache, options.threads);
+
+        if (path.empty())
+        {
+            cerr << "Error: /tmp/gashd-" << geteuid() << " is not a private"
+                 << " directory; give the socket with --socket." << endl;
+        }
+        else if (!daemon.listen(path))
+        {
+            cerr << "Error: could not listen on \"" << path << "\" (is"
+                 << " another gash daemon running?)." << endl;
+        }
+        else
+        {
+            cout << "Listening on " << path << " with " << daemon.threads()
+                 << ((daemon.threads() == 1) ? " thread." : " threads.")
+                 << endl;
+
+            status = daemon.run();
+        }
+    }
+
+    delete cache;
+
+    return status;
+}
+
+int runWatch (const string &directory, const Options &options)
+{
+    DigestCache *cache = NULL;
+    if (options.useCache)
+    {
+        string cacheFile = options.cacheFile.empty()
+                           ? DigestCache::defaultPath() : options.cacheFile;
+
+        if (!cacheFile.empty())
+            cache = new DigestCache(cacheFile);
+    }
+
+    int status = 1;
+
+    // The watcher (and its threads) is destroyed before the cache.
+    {
+        TreeWatcher watcher(options.hashFlag, cache, options.threads,
+                            options.debounce);
+
+        watcher.setDirect(options.direct);
+
+        if (!watcher.watch(directory))
+        {
+            cerr << "Error: could not watch directory \"" << directory
+                 << "\"." << endl;
+        }
+        else
+            status = watcher.run();
+    }
+
+    delete cache;
+
+    return status;
+}
+
+int findDuplicates (const vector < string > &files, const string &hashFlag)
+{
+    string label;
+    MessageHash *hash = createHash(hashFlag, label);
+
+    DuplicateFinder finder(*hash);
+    vector < DuplicateFinder::Group > groups;
+    finder.find(files, groups);
+
+    const vector < string > &unreadable = finder.unreadable();
+    for (size_t i = 0; i < unreadable.size(); ++i)
+    {
+        cerr << "Warning: could not read file \"" << unreadable[i] << "\"."
+             << endl;
+    }
+
+    for (size_t g = 0; g < groups.size(); ++g)
+    {
+        hash->setHash(groups[g].digest);
+
+        cout << "Duplicates (" << groups[g].size << " bytes, " << label
+             << *hash << "):" << endl;
+
+        for (size_t i = 0; i < groups[g].names.size(); ++i)
+            cout << "    " << groups[g].names[i] << endl;
+
+        cout << endl;
+    }
+
+    cout << "Sets of duplicates: " << groups.size() << endl;
+    delete hash;
+
+    return unreadable.empty() ? 0 : 1;
+}
+
+int chunkFile (const string &filename, const Options &options)
+{
+    ifstream file;
+
+    if (!getFileHandle(filename, file))
+    {
+        cerr << "Error: could not open file \"" << filename << "\"." << endl;
+
+        return 1;
+    }
+
+    cout << "File: " << filename << endl;
+
+    string label;
+    MessageHash *hash = createHash(options.hashFlag, label);
+
+    Chunker chunker(*hash, options.chunkMin, options.chunkAverage,
+                    options.chunkMax);
+    Chunker::Chunk chunk;
+    uint64_t count = 0;
+
+    // One line per chunk: its offset, its length and its digest.
+    chunker.start(file);
+    while (chunker.next(chunk))
+    {
+        hash->setHash(chunk.digest);
+        cout << chunk.offset << " " << chunk.length << " " << *hash << endl;
+        ++count;
+    }
+
+    delete hash;
+
+    if (chunker.failed())
+    {
+        cerr << "Error: could not read file \"" << filename << "\"." << endl;
+
+        return 1;
+    }
+
+    cout << "Chunks: " << count << endl << endl;
+
+    return 0;
+}
+
+int writeSignature (const string &filename, const string &signatureFile,
+                    const Options &options)
+{
+    ifstream file;
+
+    if (!getFileHandle(filename, file))
+    {
+        cerr << "Error: could not open file \"" << filename << "\"." << endl;
+
+        return 1;
+    }
+
+    string label;
+    MessageHash *hash = createHash(options.hashFlag, label);
+    Signature signature;
+
+    bool signedFile = signature.compute(file, *hash, options.blockBytes);
+    delete hash;
+
+    if (!signedFile)
+    {
+        cerr << "Error: could not read file \"" << filename << "\"." << endl;
+
+        return 1;
+    }
+
+    if (!signature.save(signatureFile))
+    {
+        cerr << "Error: could not write the signature \"" << signatureFile
+             << "\"." << endl;
+
+        return 1;
+    }
+
+    cout << "File: " << filename << endl
+         << "Signature: " << signatureFile << " (" << signature.blockCount()
+         << " blocks of " << signature.blockBytes() << " bytes, "
+         << signature.algorithm() << ")" << endl << endl;
+
+    return 0;
+}
+
+int writeDelta (const string &signatureFile, const string &filename,
+                const string &deltaFile)
+{
+    Signature signature;
+
+    if (!signature.load(signatureFile))
+    {
+        cerr << "Error: could not read the signature \"" << signatureFile
+             << "\"." << endl;
+
+        return 1;
+    }
+
+    MessageHash *hash = createHashNamed(signature.algorithm());
+    if (hash == NULL)
+    {
+        cerr << "Error: unknown digest \"" << signature.algorithm()
+             << "\" in the signature." << endl;
+
+        return 1;
+    }
+
+    ifstream file;
+
+    if (!getFileHandle(filename, file))
+    {
+        cerr << "Error: could not open file \"" << filename << "\"." << endl;
+        delete hash;
+
+        return 1;
+    }
+
+    Delta delta;
+    bool written = delta.generate(file, signature, *hash, deltaFile);
+    delete hash;
+
+    if (!written)
+    {
+        cerr << "Error: could not write the delta of \"" << filename
+             << "\" to \"" << deltaFile << "\"." << endl;
+
+        return 1;
+    }
+
+    cout << "File: " << filename << endl
+         << "Delta: " << deltaFile << " (" << delta.copiedBytes()
+         << " bytes matched, " << delta.literalBytes() << " literal)"
+         << endl << endl;
+
+    return 0;
+}
+
+int applyDelta (const string &basisFile, const string &deltaFile,
+                const string &outputFile)
+{
+    Delta delta;
+
+    if (!delta.open(deltaFile))
+    {
+        cerr << "Error: could not read the delta \"" << deltaFile << "\"."
+             << endl;
+
+        return 1;
+    }
+
+    MessageHash *hash = createHashNamed(delta.algorithm());
+    if (hash == NULL)
+    {
+        cerr << "Error: unknown digest \"" << delta.algorithm()
+             << "\" in the delta." << endl;
+
+        return 1;
+    }
+
+    ifstream file;
+
+    if (!getFileHandle(basisFile, file))
+    {
+        cerr << "Error: could not open file \"" << basisFile << "\"."
+             << endl;
+        delete hash;
+
+        return 1;
+    }
+
+    bool rebuilt = delta.apply(file, *hash, outputFile);
+    delete hash;
+
+    if (!rebuilt)
+    {
+        cerr << "Error: could not rebuild \"" << outputFile << "\" (the"
+             << " delta is damaged or was not made against \"" << basisFile
+             << "\")." << endl;
+
+        return 1;
+    }
+
+    cout << "File: " << outputFile << " (" << delta.copiedBytes()
+         << " bytes copied, " << delta.literalBytes() << " literal)"
+         << endl << endl;
+
+    return 0;
+}
+
+bool isUnchanged (const struct stat &before, const struct stat &after)
+{
+    return (after.st_dev == before.st_dev) && (after.st_ino == before.st_ino)
+           && (after.st_size == before.st_size)
+           && (after.st_mtim.tv_sec == before.st_mtim.tv_sec)
+           && (after.st_mtim.tv_nsec == before.st_mtim.tv_nsec);
+}
+
+uint64_t monotonicTime (void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+MessageHash * createHash (const string &flag, string &label)
+{
+    for (size_t i = 0; i < HASH_TYPE_COUNT; ++i)
+    {
+        if (flag == HASH_TYPES[i].flag)
+        {
+            label = HASH_TYPES[i].label;
+            return HASH_TYPES[i].create();
+        }
+    }
+
+    return NULL;
+}
+
+MessageHash * createHashNamed (const string &algorithm)
+{
+    for (size_t i = 0; i < HASH_TYPE_COUNT; ++i)
+    {
+        MessageHash *hash = HASH_TYPES[i].create();
+
+        if (hash->algorithmName() == algorithm)
+            return hash;
+
+        delete hash;
+    }
+
+    return NULL;
+}
+
+bool hashWithCheckpoints (MessageHash &hash, ifstream &file,
+                          Checkpoint &checkpoint, uint32_t interval,
+                          ProgressMonitor *progress, uint32_t device)
+{
+    uint64_t offset = 0;
+
+    if (checkpoint.load(hash, offset))
+    {
+        cout << "Resuming at byte " << offset << " from checkpoint \""
+             << checkpoint.path() << "\"." << endl;
+
+        file.seekg((std::streamoff)offset);
+
+        if (progress != NULL)
+            progress->skip(offset);
+    }
+
+    vector < byte_t > buffer(Checkpoint::READ_BUFFER_BYTES);
+    time_t lastSave = time(NULL);
+    bool warned = false;
+
+    while (file.good())
+    {
+        file.read((char *)&buffer[0], buffer.size());
+
+        uint64_t count = (uint64_t)file.gcount();
+        hash.update(&buffer[0], count);
+        offset += count;
+
+        if (progress != NULL)
+            progress->add(device, count);
+
+        if (file.good() && ((uint64_t)(time(NULL) - lastSave) >= interval))
+        {
+            if (!checkpoint.save(hash, offset) && !warned)
+            {
+                cerr << "Warning: could not write checkpoint \""
+                     << checkpoint.path() << "\"." << endl;
+                warned = true;
+            }
+
+            lastSave = time(NULL);
+        }
+    }
+
+    // A read error keeps the last checkpoint so that the job can resume.
+    if (file.bad())
+        return false;
+
+    hash.finalize();
+    checkpoint.remove();
+
+    return true;
+}
+
+bool hashIncrementally (MessageHash &hash, ifstream &file, TailState &tail,
+                        ProgressMonitor *progress, uint32_t device)
+{
+    uint64_t offset = 0;
+
+    if (tail.load(hash, file, offset))
+    {
+        cout << "Resuming at byte " << offset << " from tail state \""
+             << tail.path() << "\"." << endl;
+
+        if (progress != NULL)
+            progress->skip(offset);
+    }
+
+    file.clear();
+    file.seekg((std::streamoff)offset);
+
+    vector < byte_t > buffer(Checkpoint::READ_BUFFER_BYTES);
+
+    while (file.good())
+    {
+        file.read((char *)&buffer[0], buffer.size());
+
+        uint64_t count = (uint64_t)file.gcount();
+        hash.update(&buffer[0], count);
+        offset += count;
+
+        if (progress != NULL)
+            progress->add(device, count);
+    }
+
+    if (file.bad())
+        return false;
+
+    // The midstate is stored before the hash is finalized.
+    if (!tail.save(hash, file, offset))
+    {
+        cerr << "Warning: could not write tail state \"" << tail.path()
+             << "\"." << endl;
+    }
+
+    hash.finalize();
+
+    return true;
+}
+
+void displayHelp (void)
+{
+    cout << "Usage:" << endl
+         << "    gash [--checkpoint[=FILE] | --incremental[=FILE]]"
+         << " [<cache options>]" << endl
+         << "         <hashType> <filename or directory>..." << endl
+         << "    gash --io-uring[=DEPTH[:BATCH]] [--direct] [<cache options>]"
+         << " <hashType>" << endl
+         << "         <filename or directory>..." << endl
+         << "    gash --range=OFFSET:LENGTH[,OFFSET:LENGTH]... <hashType>"
+         << " <filename>..." << endl
+         << "    gash --tee[=FILE] <hashType> <filename or ->" << endl
+         << "    gash dupes [<hashType>] <filename or directory>..." << endl
+         << "    gash chunks [--chunk-size=MIN:AVG:MAX] [<hashType>]" << endl
+         << "         <filename or directory>..." << endl
+         << "    gash signature [--block-size=BYTES] [<hashType>] <filename>"
+         << " <signature>" << endl
+         << "    gash delta <signature> <filename> <delta>" << endl
+         << "    gash patch <basis> <delta> <output>" << endl
+         << "    gash daemon [--socket=PATH] [--threads=COUNT]"
+         << " [<cache options>]" << endl
+         << "    gash watch [--debounce=MS] [--threads=COUNT]"
+         << " [<cache options>] [<hashType>]" << endl
+         << "         <directory>" << endl
+         << "    gash <options>" << endl
+         << endl
+         << "Where <hashType> can be any of:" << endl
+         << "    -md5 : MD5" << endl
+         << "    -sha1 : SHA-1" << endl
+         << "    -sha224 : SHA-224" << endl
+         << "    -sha256 : SHA-256" << endl
+         << "    -sha384 : SHA-384" << endl
+         << "    -sha512 : SHA-512" << endl
+         << "    -sha512_256 : SHA-512/256" << endl
+         << "    -blake3 : BLAKE3" << endl
+         << "    -blake2b : BLAKE2b-512" << endl
+         << "    -blake2bp : BLAKE2bp" << endl
+         << "    -blake2s : BLAKE2s-256" << endl
+         << "    -blake2sp : BLAKE2sp" << endl
+         << "    -xxh64 : XXH64 (non-cryptographic)" << endl
+         << "    -xxh3 : XXH3-64 (non-cryptographic)" << endl
+         << "    -xxh128 : XXH3-128 (non-cryptographic)" << endl
+         << "    -adler32 : Adler-32" << endl
+         << "    -crc : CRC" << endl
+         << "    -elf : ELF" << endl
+         << "And <options> can include:" << endl
+         << "    -c : credits" << endl
+         << "    -h : help" << endl
+         << "    --checkpoint[=FILE] : save the progress of the hash so"
+         << " that an" << endl
+         << "        interrupted run resumes (FILE defaults to"
+         << " <filename>.gashckpt)" << endl
+         << "    --checkpoint-interval=SECONDS : the time between"
+         << " checkpoints (default 60)" << endl
+         << "    --incremental[=FILE] : keep the state of the hash so that"
+         << " a file that" << endl
+         << "        is only appended to is hashed from where the last run"
+         << " ended" << endl
+         << "        (FILE defaults to <filename>.gashtail)" << endl
+         << "    --cache=FILE : the digest cache (default"
+         << " ~/.cache/gash/digests)" << endl
+         << "    --no-cache : neither use nor update the digest cache"
+         << endl
+         << "    --verify-cache : hash every file and check its cached"
+         << " digest" << endl
+         << "    --xattr : also keep each digest in a user.gash.*"
+         << " extended attribute" << endl
+         << "        of the file (it follows renames and rsync -X copies)"
+         << endl
+         << "    --chunk-size=MIN:AVG:MAX : the chunk sizes of gash chunks"
+         << " (default" << endl
+         << "        16384:65536:262144)" << endl
+         << "    --block-size=BYTES : the block size of gash signature"
+         << " (default about" << endl
+         << "        the square root of the file size)" << endl
+         << "    --range=OFFSET:LENGTH[,...] : hash only these byte ranges"
+         << " of each file" << endl
+         << "        (with pread; numbers may be 0x hexadecimal and end in"
+         << " K, M or G)" << endl
+         << "    --io-uring[=DEPTH[:BATCH]] : read the files asynchronously"
+         << " through io_uring," << endl
+         << "        DEPTH reads outstanding per thread (default 64),"
+         << " submitted BATCH at a" << endl
+         << "        time (default 16)" << endl
+         << "    --direct : read the files around the page cache (O_DIRECT,"
+         << " or dropping" << endl
+         << "        the pages that were read where it is refused)" << endl
+         << "    --buffers=COUNT : read each file ahead into COUNT 1 MiB"
+         << " buffers on an I/O" << endl
+         << "        thread while it is hashed (default 4; 1 reads and"
+         << " hashes in turn)" << endl
+         << "    --tee[=FILE] : pass the data on to FILE (default standard"
+         << " output, with" << endl
+         << "        the report on standard error) as it is hashed"
+         << endl
+         << "    --json : report one JSON object per line (path, size,"
+         << " algorithm, digest," << endl
+         << "        and the seconds, bytes per second and read and hash"
+         << " time when timed)" << endl
+         << "    --progress : show the files and bytes done, the rate and"
+         << " the time left" << endl
+         << "        on standard error (SIGUSR1 reports them at any time)"
+         << endl
+         << "    --perf : report the cycles per byte, IPC and cache and"
+         << " branch misses" << endl
+         << "        of the hashing kernel on standard error" << endl
+         << "    --socket=PATH : the socket of gash daemon (default"
+         << " $GASH_SOCKET, else" << endl
+         << "        $XDG_RUNTIME_DIR/gashd.sock or"
+         << " /tmp/gashd-<uid>/gashd.sock)" << endl
+         << "    --threads=COUNT : the worker threads of gash daemon and"
+         << " gash watch" << endl
+         << "        (default one per CPU)" << endl
+         << "    --debounce=MS : hash a watched file once it has been left"
+         << " alone this long" << endl
+         << "        (default 500)" << endl
+         << "    A <filename> of - is standard input; pipes and devices are"
+         << " read as streams";
 
     return;
 }
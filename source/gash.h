@@ -4,7 +4,7 @@
 ||                                                                           ||
 ||    Author: Gary Hammock, PE                                               ||
 ||    Creation Date: 2008-09-17                                              ||
-||    Last Edit Date: 2014-03-13                                             ||
+||    Last Edit Date: 2026-10-16                                             ||
 ||                                                                           ||
 ||===========================================================================||
 ||  DESCRIPTION                                                              ||
@@ -40,7 +40,7 @@
 
 /** @file gash.h
  *  @author Gary Hammock, PE
- *  @date 2014-03-13
+ *  @date 2026-10-16
 */
 
 #ifndef _GASH_DEF_H
@@ -52,10 +52,38 @@
 #include <sstream>
 
 #include "Hashes/adler32.h"
+#include "Hashes/blake2b.h"
+#include "Hashes/blake2s.h"
+#include "Hashes/blake3.h"
 #include "Hashes/crc32.h"
 #include "Hashes/elf.h"
+#include "Hashes/hmac.h"
+#include "Hashes/kdf.h"
 #include "Hashes/md5.h"
+#include "Hashes/sha1.h"
 #include "Hashes/sha256.h"
+#include "Hashes/sha512.h"
+#include "Hashes/xxh3.h"
+#include "Hashes/xxh64.h"
+#include "checkpoint.h"
+#include "chunker.h"
+#include "delta.h"
+#include "digest_attribute.h"
+#include "daemon_channel.h"
+#include "digest_cache.h"
+#include "direct_reader.h"
+#include "duplicate_finder.h"
+#include "hash_daemon.h"
+#include "json_writer.h"
+#include "prefetch_reader.h"
+#include "progress_monitor.h"
+#include "perf_counters.h"
+#include "range_hasher.h"
+#include "signature.h"
+#include "stream_hasher.h"
+#include "tail_state.h"
+#include "tree_watcher.h"
+#include "uring_reader.h"
 
 using std::string;
 using std::ifstream;
@@ -67,10 +95,116 @@ using std::ios;
 
 #define _VERSION_ "1.0.0"
 
+///////////////////////////////////////
+//    Type definitions
+////////////////////////
+
+/**
+ *  @struct Options The command line options of a run.
+*/
+struct Options
+{
+    string hashFlag;              // The flag that selects the hash.
+
+    bool checkpoint;              // Checkpoint the job so it can resume.
+    string checkpointFile;        // Where to checkpoint (default: beside
+                                  // the file that is hashed).
+    uint32_t checkpointInterval;  // The seconds between checkpoints.
+
+    bool incremental;             // Only hash what was appended since the
+    string tailFile;              // tail state in tailFile was stored.
+
+    bool useCache;                // Reuse (and store) cached digests.
+    bool verifyCache;             // Hash anyway and check cached digests.
+    string cacheFile;             // The cache (default: defaultPath()).
+    bool useXattr;                // Keep digests in extended attributes.
+
+    uint32_t chunkMin;            // The chunk sizes of gash chunks.
+    uint32_t chunkAverage;
+    uint32_t chunkMax;
+
+    uint32_t blockBytes;          // The block size of gash signature
+                                  // (zero: chosen by the file size).
+
+    vector < RangeHasher::Range > ranges;  // Hash only these byte ranges.
+
+    uint32_t uringDepth;          // The io_uring queue depth (zero: read
+    uint32_t uringBatch;          // with ifstream) and batch size.
+
+    bool direct;                  // Read around the page cache (O_DIRECT).
+    uint32_t buffers;             // The read-ahead buffers of each file.
+
+    string teeFile;               // Pass the data on to this file ("-":
+                                  // standard output; empty: nowhere).
+
+    string socketPath;            // The socket of gash daemon.
+    uint32_t threads;             // Its worker threads, and those of gash
+                                  // watch (zero: one per CPU).
+    uint32_t debounce;            // The quiet time of a change to a
+                                  // watched file (ms).
+
+    JsonWriter *json;             // The NDJSON output (NULL: text).
+    ProgressMonitor *progress;    // The progress counters (NULL: none).
+    PerfCounters *perf;           // The event counters of --perf (NULL:
+                                  // none).
+};
+
+/**
+ *  @struct FileReport What is reported about a file besides its digest.
+*/
+struct FileReport
+{
+    uint64_t size;                // The bytes hashed.
+    bool cached;                  // The digest was looked up, not hashed.
+    uint64_t elapsed;             // The time it took (ns; zero: not timed).
+    bool split;                   // readTime and hashTime are known.
+    uint64_t readTime;            // The time spent reading (ns).
+    uint64_t hashTime;            // The time spent hashing (ns).
+};
+
 ///////////////////////////////////////
 //    Function Declarations
 ////////////////////////
 bool getFileHandle (string filename, ifstream &file);
+void collectFiles (const string &path, vector < string > &files,
+                   ostream &warnings = cerr);
+int hashFile (const string &filename, const Options &options,
+              DigestCache *cache);
+int hashFilesAsync (const vector < string > &files, const Options &options,
+                    DigestCache *cache);
+bool lookupDigest (const string &filename, const struct stat &before,
+                   const Options &options, DigestCache *cache,
+                   MessageHash &hash, bool &attributed);
+int recordDigest (const string &filename, struct stat before,
+                  const Options &options, DigestCache *cache,
+                  const MessageHash &hash, bool attributed,
+                  const vector < byte_t > &cachedDigest);
+void reportDigest (const string &filename, const string &label,
+                   const MessageHash &hash, const FileReport &report,
+                   const Options &options);
+int hashRanges (const string &filename, const Options &options);
+int hashStream (const string &filename, const Options &options);
+int chunkFile (const string &filename, const Options &options);
+int writeSignature (const string &filename, const string &signatureFile,
+                    const Options &options);
+int writeDelta (const string &signatureFile, const string &filename,
+                const string &deltaFile);
+int applyDelta (const string &basisFile, const string &deltaFile,
+                const string &outputFile);
+int runDaemon (const Options &options);
+int runWatch (const string &directory, const Options &options);
+int findDuplicates (const vector < string > &files, const string &hashFlag);
+bool isUnchanged (const struct stat &before, const struct stat &after);
+uint64_t monotonicTime (void);
+MessageHash * createHash (const string &flag, string &label);
+MessageHash * createHashNamed (const string &algorithm);
+bool hashWithCheckpoints (MessageHash &hash, ifstream &file,
+                          Checkpoint &checkpoint, uint32_t interval,
+                          ProgressMonitor *progress = NULL,
+                          uint32_t device = 0);
+bool hashIncrementally (MessageHash &hash, ifstream &file, TailState &tail,
+                        ProgressMonitor *progress = NULL,
+                        uint32_t device = 0);
 void displayHelp (void);
 void dispCredits (void);
 
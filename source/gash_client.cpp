@@ -0,0 +1,275 @@
+/******************************************************************************
+||  gash_client.cpp                                                          ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    gashc, the thin client of the hashing daemon.  It takes the arguments  ||
+||    of gash, sends the files to the daemon as one batch and prints the     ||
+||    reply exactly as gash would, so that it is a drop-in for gash in       ||
+||    scripts; it links none of the hashes, so it starts in a fraction of the||
+||    time.                                                                  ||
+||                                                                           ||
+||    Anything the daemon does not serve (the help, the modes, standard      ||
+||    input, --checkpoint, --incremental, --tee, --io-uring and the other    ||
+||    options) and any request that it refuses, or a daemon that is not      ||
+||    running, is handed to gash itself with exec, which then behaves as     ||
+||    usual.                                                                 ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    daemon_channel.cpp                                                     ||
+||    daemon_channel.h                                                       ||
+||    Hashes/hash_state.cpp                                                  ||
+||    Hashes/hash_state.h                                                    ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file gash_client.cpp
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+#include <limits.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <iostream>
+
+#include "daemon_channel.h"
+
+using std::cout;
+using std::cerr;
+using std::endl;
+
+///////////////////////////////////////
+//    Function Declarations
+////////////////////////
+void runGash (char *argv[]);
+string hexDigest (const vector < byte_t > &digest);
+
+int main (int argc, char *argv[])
+{
+    DaemonChannel::Request request;
+    string socketPath = DaemonChannel::defaultPath();
+    vector < string > args;
+    bool served = true;          // The daemon can serve the arguments.
+
+    request.flags = 0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg(argv[i]);
+
+        if (arg.compare(0, 9, "--socket=") == 0)
+            socketPath = arg.substr(9);
+        else if (arg == "--no-cache")
+            request.flags |= DaemonChannel::NO_CACHE;
+        else if (arg == "--verify-cache")
+            request.flags |= DaemonChannel::VERIFY_CACHE;
+        else if (arg == "--direct")
+            request.flags |= DaemonChannel::DIRECT;
+        else if (arg.compare(0, 10, "--buffers=") == 0)
+            ;  // The workers of the daemon read ahead their own way.
+        else if (arg.compare(0, 8, "--range=") == 0)
+        {
+            if (!request.ranges.empty())
+                request.ranges += ",";
+
+            request.ranges += arg.substr(8);
+        }
+        else if (arg.compare(0, 2, "--") == 0)
+            served = false;
+        else
+            args.push_back(arg);
+    }
+
+    // The help, the credits, the modes and standard input are left to
+    // gash, as is any option that the daemon does not take.
+    if (args.empty()
+        || ((args.size() == 1) && ((args[0] == "-c") || (args[0] == "-h")))
+        || (args[0] == "dupes") || (args[0] == "chunks")
+        || (args[0] == "signature") || (args[0] == "delta")
+        || (args[0] == "patch") || (args[0] == "daemon")
+        || (args[0] == "watch"))
+        served = false;
+
+    // If no specific hash algoritm is given use MD5.
+    request.hashFlag = "-md5";
+    request.paths = args;
+
+    if ((args.size() > 1) && (args[0].size() > 1) && (args[0][0] == '-'))
+    {
+        request.hashFlag = args[0];
+        request.paths.erase(request.paths.begin());
+    }
+
+    for (size_t i = 0; i < request.paths.size(); ++i)
+    {
+        if (request.paths[i] == "-")
+            served = false;
+    }
+
+    char directory[PATH_MAX];
+    if (getcwd(directory, sizeof(directory)) == NULL)
+        served = false;
+    else
+        request.directory = directory;
+
+    DaemonChannel channel;
+    HashState frame;
+
+    if (!served || !channel.connect(socketPath)
+        || !channel.sendRequest(request) || !channel.get(frame)
+        || (frame.getWord32() != DaemonChannel::RECORD_ACCEPT))
+        runGash(argv);
+
+    cout << "Gash version: " << frame.getString() << endl;
+
+    for (;;)
+    {
+        if (!channel.get(frame))
+        {
+            cout.flush();
+            cerr << "Error: the connection to the gash daemon was lost."
+                 << endl;
+
+            return 1;
+        }
+
+        uint32_t record = frame.getWord32();
+
+        if (record == DaemonChannel::RECORD_FILE)
+            cout << "File: " << frame.getString() << "\n";
+        else if (record == DaemonChannel::RECORD_DIGEST)
+        {
+            string label = frame.getString();
+            cout << label << hexDigest(frame.getBlob()) << "\n\n";
+        }
+        else if (record == DaemonChannel::RECORD_RANGE)
+        {
+            uint64_t offset = frame.getWord64(),
+                     length = frame.getWord64();
+            string label = frame.getString();
+
+            cout << "Range " << offset << ":" << length << " " << label
+                 << hexDigest(frame.getBlob()) << "\n";
+        }
+        else if (record == DaemonChannel::RECORD_END)
+            cout << "\n";
+        else if (record == DaemonChannel::RECORD_MESSAGE)
+        {
+            cout.flush();
+            cerr << frame.getString();
+            cerr.flush();
+        }
+        else if (record == DaemonChannel::RECORD_DONE)
+        {
+            cout.flush();
+
+            return (int)frame.getWord32();
+        }
+    }
+}
+
+/** Run gash with the arguments instead (it is beside gashc, or on the
+ *  PATH).  This only returns if gash cannot be run.
+ *
+ *  @pre none.
+ *  @post The process is gash.
+ *  @param argv The arguments of gashc.
+ *  @return none.
+*/
+void runGash (char *argv[])
+{
+    vector < char * > args;
+    char program[PATH_MAX];
+    ssize_t length = readlink("/proc/self/exe", program, sizeof(program) - 1);
+    string gash = "gash";
+
+    if (length > 0)
+    {
+        string self(program, (size_t)length);
+        string::size_type slash = self.rfind('/');
+
+        if (slash != string::npos)
+            gash = self.substr(0, slash + 1) + "gash";
+    }
+
+    // A gashc that is installed as gash would run itself.
+    if (getenv("GASHC_FALLBACK") != NULL)
+    {
+        cerr << "Error: neither the gash daemon nor gash could be run."
+             << endl;
+        exit(1);
+    }
+
+    setenv("GASHC_FALLBACK", "1", 1);
+    args.push_back((char *)"gash");
+
+    for (int i = 1; argv[i] != NULL; ++i)
+        args.push_back(argv[i]);
+
+    args.push_back(NULL);
+
+    if (access(gash.c_str(), X_OK) == 0)
+        execv(gash.c_str(), &args[0]);
+
+    execvp("gash", &args[0]);
+
+    cerr << "Error: neither the gash daemon nor gash could be run." << endl;
+    exit(1);
+}
+
+/** Format a digest as gash prints it.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @param digest The digest.
+ *  @return The digest in lower case hexadecimal.
+*/
+string hexDigest (const vector < byte_t > &digest)
+{
+    static const char DIGITS[] = "0123456789abcdef";
+    string text;
+
+    text.reserve(digest.size() * 2);
+
+    for (size_t i = 0; i < digest.size(); ++i)
+    {
+        text += DIGITS[digest[i] >> 4];
+        text += DIGITS[digest[i] & 0x0F];
+    }
+
+    return text;
+}
@@ -0,0 +1,789 @@
+/******************************************************************************
+||  hash_daemon.cpp                                                          ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    A long-running hashing daemon.  Programs that hash many files, a few at||
+||    a time, pay for a process, its start-up and an empty digest cache each ||
+||    time they run gash; the daemon serves their batches over a Unix domain ||
+||    socket (see DaemonChannel) instead, from one process that keeps the    ||
+||    digest cache, the worker threads and the selected CPU kernels warm.    ||
+||                                                                           ||
+||    Each client has a thread that reads its requests, walks their          ||
+||    directories and queues one job per file.  A pool of worker threads,    ||
+||    each with a PrefetchReader of its own, takes the jobs in turn, whoever ||
+||    queued them, and the client thread sends the replies in the order of   ||
+||    the request.  The digest cache is shared under a lock and saved every  ||
+||    SAVE_INTERVAL seconds, and when the daemon stops (on SIGINT or         ||
+||    SIGTERM).                                                              ||
+||                                                                           ||
+||    The socket is created for its owner alone, and a connection from any   ||
+||    other user is closed at once, since the files are read with the rights ||
+||    of the daemon.                                                         ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    daemon_channel.cpp                                                     ||
+||    daemon_channel.h                                                       ||
+||    digest_cache.cpp                                                       ||
+||    digest_cache.h                                                         ||
+||    gash.cpp (createHash, collectFiles)                                    ||
+||    gash.h                                                                 ||
+||    prefetch_reader.cpp                                                    ||
+||    prefetch_reader.h                                                      ||
+||    range_hasher.cpp                                                       ||
+||    range_hasher.h                                                         ||
+||    Hashes/hash_abstract.cpp (hash_abstract.lib)                           ||
+||    Hashes/hash_abstract.h                                                 ||
+||    pthread                                                                ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file hash_daemon.cpp
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include "gash.h"
+#include "hash_daemon.h"
+
+const uint32_t HashDaemon::MAX_THREADS;
+const uint32_t HashDaemon::SAVE_INTERVAL;
+
+// Set by SIGINT and SIGTERM.
+static volatile sig_atomic_t stopRequested = 0;
+
+/** Ask the daemon to stop (the handler of SIGINT and SIGTERM).
+ *
+ *  @param signal The signal.
+ *  @return none.
+*/
+static void requestStop (int signal)
+{
+    (void)signal;
+    stopRequested = 1;
+}
+
+/******************************************************
+**            Constructors / Destructors             **
+******************************************************/
+
+/** Initialize a HashDaemon object.
+ *
+ *  @pre threads <= MAX_THREADS.
+ *  @post The daemon is ready to listen().
+ *  @param cache The digest cache that all the clients share (or NULL
+ *         for none); the caller keeps ownership of it.
+ *  @param threads The number of worker threads (zero: one per CPU).
+*/
+HashDaemon::HashDaemon (DigestCache *cache, uint32_t threads)
+    : _cache(cache),
+      _dirty(false),
+      _socket(-1),
+      _threads(threads),
+      _stop(false)
+{
+    if (_threads == 0)
+    {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        _threads = (online < 1) ? 1 : (online > (long)MAX_THREADS)
+                                      ? MAX_THREADS : (uint32_t)online;
+    }
+
+    pthread_mutex_init(&_cacheLock, NULL);
+    pthread_mutex_init(&_lock, NULL);
+    pthread_cond_init(&_queued, NULL);
+    pthread_cond_init(&_finished, NULL);
+}
+
+/** Default destructor (closes the socket).  */
+HashDaemon::~HashDaemon ()
+{
+    if (_socket >= 0)
+    {
+        close(_socket);
+        unlink(_path.c_str());
+    }
+
+    pthread_cond_destroy(&_finished);
+    pthread_cond_destroy(&_queued);
+    pthread_mutex_destroy(&_lock);
+    pthread_mutex_destroy(&_cacheLock);
+}
+
+/******************************************************
+**               Accessors / Mutators                **
+******************************************************/
+
+////////////////////
+//    Getters
+////////////////////
+
+/** Retrieve the number of worker threads.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return The number of threads.
+*/
+uint32_t HashDaemon::threads (void) const
+{
+    return _threads;
+}
+
+/******************************************************
+**                      Methods                      **
+******************************************************/
+
+/** Create the socket and listen on it.  A socket that is left over
+ *  from a daemon that is no longer running is replaced.
+ *
+ *  @pre none.
+ *  @post The socket exists, and only its owner can connect to it.
+ *  @param path The path of the socket.
+ *  @return true The daemon is listening.
+ *  @return false The socket could not be created (or another daemon
+ *          is listening on it).
+*/
+bool HashDaemon::listen (const string &path)
+{
+    struct sockaddr_un address;
+
+    if (path.empty() || (path.size() >= sizeof(address.sun_path)))
+        return false;
+
+    // A socket that still accepts connections belongs to a live daemon.
+    DaemonChannel probe;
+    if (probe.connect(path))
+        return false;
+
+    struct stat status;
+    if (lstat(path.c_str(), &status) == 0)
+    {
+        if (!S_ISSOCK(status.st_mode))
+            return false;
+
+        unlink(path.c_str());
+    }
+
+    _socket = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (_socket < 0)
+        return false;
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    memcpy(address.sun_path, path.c_str(), path.size());
+
+    // The socket is created without access for the group and others.
+    mode_t mask = umask(0077);
+    int bound = bind(_socket, (const struct sockaddr *)&address,
+                     sizeof(address));
+    umask(mask);
+
+    if ((bound != 0) || (::listen(_socket, SOMAXCONN) != 0))
+    {
+        close(_socket);
+        _socket = -1;
+
+        return false;
+    }
+
+    _path = path;
+
+    return true;
+}
+
+/** Serve the clients until SIGINT or SIGTERM.
+ *
+ *  @pre listen() succeeded.
+ *  @post The digest cache is saved and the socket is removed.
+ *  @return 0 on success, 1 if the cache could not be saved.
+*/
+int HashDaemon::run (void)
+{
+    struct sigaction action;
+
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = requestStop;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    for (uint32_t t = 0; t < _threads; ++t)
+    {
+        pthread_t thread;
+
+        if (pthread_create(&thread, NULL, _workerThread, this) == 0)
+            _workers.push_back(thread);
+    }
+
+    if (_workers.empty())
+        return 1;
+
+    time_t saved = time(NULL);
+
+    // The socket is polled with a timeout, so that a signal (which may be
+    // taken by any thread) and the saves of the cache are noticed.
+    while (!stopRequested)
+    {
+        struct pollfd listening;
+
+        listening.fd = _socket;
+        listening.events = POLLIN;
+        listening.revents = 0;
+
+        if (poll(&listening, 1, 1000) > 0)
+        {
+            int fd = accept4(_socket, NULL, NULL, SOCK_CLOEXEC);
+            struct ucred peer;
+            socklen_t length = sizeof(peer);
+
+            // Only the owner of the daemon is served: the files are read
+            // with its rights.
+            if ((fd >= 0)
+                && ((getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &peer,
+                                &length) != 0)
+                    || (peer.uid != geteuid())))
+            {
+                close(fd);
+                fd = -1;
+            }
+
+            if (fd >= 0)
+            {
+                Client *client = new Client;
+                pthread_t thread;
+
+                client->daemon = this;
+                client->fd = fd;
+
+                pthread_mutex_lock(&_lock);
+                _clients.insert(fd);
+                pthread_mutex_unlock(&_lock);
+
+                if (pthread_create(&thread, NULL, _clientThread, client) == 0)
+                    pthread_detach(thread);
+                else
+                {
+                    pthread_mutex_lock(&_lock);
+                    _clients.erase(fd);
+                    pthread_mutex_unlock(&_lock);
+
+                    close(fd);
+                    delete client;
+                }
+            }
+        }
+
+        if (time(NULL) - saved >= (time_t)SAVE_INTERVAL)
+        {
+            _save();
+            saved = time(NULL);
+        }
+    }
+
+    close(_socket);
+    _socket = -1;
+    unlink(_path.c_str());
+
+    pthread_mutex_lock(&_lock);
+    _stop = true;
+    pthread_cond_broadcast(&_queued);
+    pthread_mutex_unlock(&_lock);
+
+    for (size_t t = 0; t < _workers.size(); ++t)
+        pthread_join(_workers[t], NULL);
+
+    _workers.clear();
+
+    // The jobs that were not started fail, and the clients are
+    // disconnected once they have their replies.
+    pthread_mutex_lock(&_lock);
+
+    for (size_t i = 0; i < _queue.size(); ++i)
+    {
+        _message(*_queue[i], "Error: the gash daemon stopped before \""
+                             + _queue[i]->name + "\" was hashed.\n");
+        _queue[i]->status = 1;
+        _queue[i]->done = true;
+    }
+
+    _queue.clear();
+    pthread_cond_broadcast(&_finished);
+
+    std::set < int >::const_iterator it;
+    for (it = _clients.begin(); it != _clients.end(); ++it)
+        shutdown(*it, SHUT_RD);
+
+    while (!_clients.empty())
+        pthread_cond_wait(&_finished, &_lock);
+
+    pthread_mutex_unlock(&_lock);
+
+    return _save() ? 0 : 1;
+}
+
+/******************************************************
+**                   Helper Methods                  **
+******************************************************/
+
+/** Serve the requests of one client.
+ *
+ *  @param fd The connection.
+ *  @return none.
+*/
+void HashDaemon::_serve (int fd)
+{
+    DaemonChannel channel(fd);
+    DaemonChannel::Request request;
+    uint32_t version;
+    bool connected = true;
+
+    while (connected && channel.receiveRequest(request, version))
+    {
+        Batch batch;
+        string label,
+               reason;
+        HashState reply;
+
+        batch.flags = request.flags;
+        batch.hashFlag = request.hashFlag;
+
+        MessageHash *probe = (version == DaemonChannel::VERSION)
+                             ? createHash(request.hashFlag, label) : NULL;
+
+        if (version != DaemonChannel::VERSION)
+            reason = "unsupported protocol version";
+        else if (probe == NULL)
+            reason = "unknown hash type \"" + request.hashFlag + "\"";
+        else if (!request.ranges.empty()
+                 && !RangeHasher::parse(request.ranges, batch.ranges))
+            reason = "invalid byte ranges \"" + request.ranges + "\"";
+
+        delete probe;
+
+        // The client leaves a request that is refused to gash itself.
+        if (!reason.empty())
+        {
+            reply.putWord32(DaemonChannel::RECORD_REFUSE);
+            reply.putString(reason);
+            connected = channel.put(reply) && channel.flush();
+
+            continue;
+        }
+
+        reply.putWord32(DaemonChannel::RECORD_ACCEPT);
+        reply.putString(_VERSION_);
+        channel.put(reply);
+
+        // Relative paths are in the working directory of the client, and
+        // are reported as it named them.
+        string prefix = request.directory;
+        if (!prefix.empty() && (prefix[prefix.size() - 1] != '/'))
+            prefix += "/";
+
+        vector < Job * > jobs;
+        stringstream warnings;
+
+        for (size_t i = 0; i < request.paths.size(); ++i)
+        {
+            const string &path = request.paths[i];
+            bool relative = path.empty() || (path[0] != '/');
+            vector < string > files;
+
+            collectFiles(relative ? (prefix + path) : path, files, warnings);
+
+            for (size_t f = 0; f < files.size(); ++f)
+            {
+                Job *job = new Job;
+
+                job->batch = &batch;
+                job->path = files[f];
+                job->name = relative ? files[f].substr(prefix.size())
+                                     : files[f];
+                job->done = false;
+                job->status = 0;
+                jobs.push_back(job);
+            }
+        }
+
+        if (!warnings.str().empty())
+        {
+            HashState message;
+
+            message.putWord32(DaemonChannel::RECORD_MESSAGE);
+            message.putString(warnings.str());
+            channel.put(message);
+        }
+
+        pthread_mutex_lock(&_lock);
+
+        for (size_t i = 0; i < jobs.size(); ++i)
+        {
+            if (!_stop)
+                _queue.push_back(jobs[i]);
+            else
+            {
+                _message(*jobs[i], "Error: the gash daemon stopped before \""
+                                   + jobs[i]->name + "\" was hashed.\n");
+                jobs[i]->status = 1;
+                jobs[i]->done = true;
+            }
+        }
+
+        pthread_cond_broadcast(&_queued);
+        pthread_mutex_unlock(&_lock);
+
+        // The replies are sent in the order of the request.  The jobs are
+        // waited for even if the client has gone, since the workers hold
+        // them.
+        int status = 0;
+
+        for (size_t i = 0; i < jobs.size(); ++i)
+        {
+            Job *job = jobs[i];
+
+            pthread_mutex_lock(&_lock);
+            if (!job->done)
+            {
+                pthread_mutex_unlock(&_lock);
+                connected = connected && channel.flush();
+                pthread_mutex_lock(&_lock);
+
+                while (!job->done)
+                    pthread_cond_wait(&_finished, &_lock);
+            }
+            pthread_mutex_unlock(&_lock);
+
+            status |= job->status;
+
+            for (size_t r = 0; r < job->records.size(); ++r)
+                connected = connected && channel.put(job->records[r]);
+
+            delete job;
+        }
+
+        HashState done;
+        done.putWord32(DaemonChannel::RECORD_DONE);
+        done.putWord32((uint32_t)status);
+
+        connected = connected && channel.put(done) && channel.flush();
+    }
+
+    // The descriptor is closed (by the channel) only once run() can no
+    // longer shut it down.
+    pthread_mutex_lock(&_lock);
+    _clients.erase(fd);
+    pthread_cond_broadcast(&_finished);
+    pthread_mutex_unlock(&_lock);
+
+    return;
+}
+
+/** Hash the file of a job and record the reply.
+ *
+ *  @param job The job.
+ *  @param reader The reader of the worker thread.
+ *  @return none.
+*/
+void HashDaemon::_hashFile (Job &job, PrefetchReader &reader)
+{
+    // O_NONBLOCK: opening a FIFO that has no writer would otherwise hold
+    // the worker until one comes.
+    struct stat before;
+    int fd = open(job.path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+
+    if ((fd < 0) || (fstat(fd, &before) != 0))
+    {
+        _message(job, "Error: could not open file \"" + job.name + "\".\n");
+        job.status = 1;
+
+        if (fd >= 0)
+            close(fd);
+
+        return;
+    }
+
+    close(fd);
+
+    // Pipes and devices are left to gash, which streams them.
+    if (!S_ISREG(before.st_mode))
+    {
+        _message(job, "Error: \"" + job.name + "\" is not a regular file.\n");
+        job.status = 1;
+
+        return;
+    }
+
+    HashState file;
+    file.putWord32(DaemonChannel::RECORD_FILE);
+    file.putString(job.name);
+    job.records.push_back(file);
+
+    uint32_t flags = job.batch->flags;
+    bool useCache = (_cache != NULL) && !(flags & DaemonChannel::NO_CACHE),
+         cached = false;
+    string label;
+    MessageHash *hash = createHash(job.batch->hashFlag, label);
+
+    if (useCache)
+    {
+        pthread_mutex_lock(&_cacheLock);
+        cached = _cache->lookup(before, *hash);
+        pthread_mutex_unlock(&_cacheLock);
+    }
+
+    if (!cached || (flags & DaemonChannel::VERIFY_CACHE))
+    {
+        vector < byte_t > stored;
+        if (cached)
+            stored = hash->asBytes();
+
+        reader.setDirect((flags & DaemonChannel::DIRECT) != 0);
+
+        if (!reader.hash(job.path, *hash))
+        {
+            _message(job, "Error: could not read file \"" + job.name
+                          + "\".\n");
+            job.status = 1;
+            delete hash;
+
+            return;
+        }
+
+        if (!stored.empty() && (hash->asBytes() != stored))
+        {
+            _message(job, "Error: \"" + job.name + "\" does not match its"
+                          " cached digest.\n");
+            job.status = 1;
+        }
+
+        // The digest is only stored if the file did not change while it
+        // was being read.
+        struct stat after;
+
+        if (useCache && (stat(job.path.c_str(), &after) == 0)
+            && isUnchanged(before, after)
+            && (after.st_ctim.tv_sec == before.st_ctim.tv_sec)
+            && (after.st_ctim.tv_nsec == before.st_ctim.tv_nsec))
+        {
+            pthread_mutex_lock(&_cacheLock);
+            _cache->store(before, *hash);
+            _dirty = true;
+            pthread_mutex_unlock(&_cacheLock);
+        }
+    }
+
+    HashState digest;
+    digest.putWord32(DaemonChannel::RECORD_DIGEST);
+    digest.putString(label);
+    digest.putBlob(hash->asBytes());
+    job.records.push_back(digest);
+
+    delete hash;
+
+    return;
+}
+
+/** Hash the byte ranges of the file of a job and record the reply.
+ *
+ *  @param job The job.
+ *  @return none.
+*/
+void HashDaemon::_hashRanges (Job &job)
+{
+    string label;
+    MessageHash *hash = createHash(job.batch->hashFlag, label);
+    RangeHasher ranges(*hash);
+
+    delete hash;
+
+    if (!ranges.open(job.path))
+    {
+        _message(job, "Error: could not open file \"" + job.name + "\".\n");
+        job.status = 1;
+
+        return;
+    }
+
+    HashState file;
+    file.putWord32(DaemonChannel::RECORD_FILE);
+    file.putString(job.name);
+    job.records.push_back(file);
+
+    for (size_t i = 0; i < job.batch->ranges.size(); ++i)
+    {
+        const RangeHasher::Range &range = job.batch->ranges[i];
+
+        if (!ranges.hash(range))
+        {
+            stringstream text;
+
+            text << "Error: could not read bytes " << range.offset << " to "
+                 << range.offset + range.length << " of \"" << job.name
+                 << "\" (" << ranges.fileSize() << " bytes).\n";
+            _message(job, text.str());
+            job.status = 1;
+
+            return;
+        }
+
+        HashState digest;
+        digest.putWord32(DaemonChannel::RECORD_RANGE);
+        digest.putWord64(range.offset);
+        digest.putWord64(range.length);
+        digest.putString(label);
+        digest.putBlob(ranges.digest().asBytes());
+        job.records.push_back(digest);
+    }
+
+    HashState end;
+    end.putWord32(DaemonChannel::RECORD_END);
+    job.records.push_back(end);
+
+    return;
+}
+
+/** Save the digest cache if digests were stored since the last save.
+ *
+ *  @return true The cache is saved.
+ *  @return false It could not be written.
+*/
+bool HashDaemon::_save (void)
+{
+    bool saved = true;
+
+    pthread_mutex_lock(&_cacheLock);
+
+    if (_dirty)
+    {
+        saved = _cache->save();
+        _dirty = !saved;
+    }
+
+    pthread_mutex_unlock(&_cacheLock);
+
+    if (!saved)
+    {
+        cerr << "Warning: could not write the digest cache \""
+             << _cache->path() << "\"." << endl;
+    }
+
+    return saved;
+}
+
+/** Record a message (for the standard error of the client).
+ *
+ *  @param job The job.
+ *  @param text The message.
+ *  @return none.
+*/
+void HashDaemon::_message (Job &job, const string &text)
+{
+    HashState message;
+
+    message.putWord32(DaemonChannel::RECORD_MESSAGE);
+    message.putString(text);
+    job.records.push_back(message);
+
+    return;
+}
+
+/** The body of a worker thread.
+ *
+ *  @param arg The HashDaemon.
+ *  @return NULL.
+*/
+void * HashDaemon::_workerThread (void *arg)
+{
+    HashDaemon &daemon = *(HashDaemon *)arg;
+
+    // Each worker reads ahead with a reader (and I/O thread) of its own.
+    PrefetchReader reader;
+
+    pthread_mutex_lock(&daemon._lock);
+
+    for (;;)
+    {
+        while (daemon._queue.empty() && !daemon._stop)
+            pthread_cond_wait(&daemon._queued, &daemon._lock);
+
+        if (daemon._stop)
+            break;
+
+        Job *job = daemon._queue.front();
+        daemon._queue.pop_front();
+        pthread_mutex_unlock(&daemon._lock);
+
+        if (job->batch->ranges.empty())
+            daemon._hashFile(*job, reader);
+        else
+            daemon._hashRanges(*job);
+
+        pthread_mutex_lock(&daemon._lock);
+        job->done = true;
+        pthread_cond_broadcast(&daemon._finished);
+    }
+
+    pthread_mutex_unlock(&daemon._lock);
+
+    return NULL;
+}
+
+/** The body of the thread of a client.
+ *
+ *  @param arg A new Client.
+ *  @return NULL.
+*/
+void * HashDaemon::_clientThread (void *arg)
+{
+    Client *client = (Client *)arg;
+    HashDaemon *daemon = client->daemon;
+    int fd = client->fd;
+
+    delete client;
+    daemon->_serve(fd);
+
+    return NULL;
+}
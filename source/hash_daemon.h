@@ -0,0 +1,283 @@
+/******************************************************************************
+||  hash_daemon.h                                                            ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    A long-running hashing daemon.  Programs that hash many files, a few at||
+||    a time, pay for a process, its start-up and an empty digest cache each ||
+||    time they run gash; the daemon serves their batches over a Unix domain ||
+||    socket (see DaemonChannel) instead, from one process that keeps the    ||
+||    digest cache, the worker threads and the selected CPU kernels warm.    ||
+||                                                                           ||
+||    Each client has a thread that reads its requests, walks their          ||
+||    directories and queues one job per file.  A pool of worker threads,    ||
+||    each with a PrefetchReader of its own, takes the jobs in turn, whoever ||
+||    queued them, and the client thread sends the replies in the order of   ||
+||    the request.  The digest cache is shared under a lock and saved every  ||
+||    SAVE_INTERVAL seconds, and when the daemon stops (on SIGINT or         ||
+||    SIGTERM).                                                              ||
+||                                                                           ||
+||    The socket is created for its owner alone, and a connection from any   ||
+||    other user is closed at once, since the files are read with the rights ||
+||    of the daemon.                                                         ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    daemon_channel.cpp                                                     ||
+||    daemon_channel.h                                                       ||
+||    digest_cache.cpp                                                       ||
+||    digest_cache.h                                                         ||
+||    gash.cpp (createHash, collectFiles)                                    ||
+||    gash.h                                                                 ||
+||    prefetch_reader.cpp                                                    ||
+||    prefetch_reader.h                                                      ||
+||    range_hasher.cpp                                                       ||
+||    range_hasher.h                                                         ||
+||    Hashes/hash_abstract.cpp (hash_abstract.lib)                           ||
+||    Hashes/hash_abstract.h                                                 ||
+||    pthread                                                                ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file hash_daemon.h
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+
+#ifndef _GH_HASH_DAEMON_DEF_H
+#define _GH_HASH_DAEMON_DEF_H
+
+#include <pthread.h>
+
+#include <deque>
+#include <set>
+
+#include "Hashes/hash_abstract.h"
+#include "daemon_channel.h"
+#include "digest_cache.h"
+#include "prefetch_reader.h"
+#include "range_hasher.h"
+
+/**
+ *  @class HashDaemon Serves batches of files to hash over a Unix domain
+ *         socket.
+*/
+class HashDaemon
+{
+  public:
+    /******************************************************
+    **                     Constants                     **
+    ******************************************************/
+
+    /// The most worker threads.
+    static const uint32_t MAX_THREADS = 256;
+
+    /// The seconds between the saves of the digest cache.
+    static const uint32_t SAVE_INTERVAL = 30;
+
+    /******************************************************
+    **            Constructors / Destructors             **
+    ******************************************************/
+
+    /** Initialize a HashDaemon object.
+     *
+     *  @pre threads <= MAX_THREADS.
+     *  @post The daemon is ready to listen().
+     *  @param cache The digest cache that all the clients share (or NULL
+     *         for none); the caller keeps ownership of it.
+     *  @param threads The number of worker threads (zero: one per CPU).
+    */
+    HashDaemon (DigestCache *cache, uint32_t threads = 0);
+
+    /** Default destructor (closes the socket).  */
+    ~HashDaemon ();
+
+    /******************************************************
+    **               Accessors / Mutators                **
+    ******************************************************/
+
+    ////////////////////
+    //    Getters
+    ////////////////////
+
+    /** Retrieve the number of worker threads.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return The number of threads.
+    */
+    uint32_t threads (void) const;
+
+    /******************************************************
+    **                      Methods                      **
+    ******************************************************/
+
+    /** Create the socket and listen on it.  A socket that is left over
+     *  from a daemon that is no longer running is replaced.
+     *
+     *  @pre none.
+     *  @post The socket exists, and only its owner can connect to it.
+     *  @param path The path of the socket.
+     *  @return true The daemon is listening.
+     *  @return false The socket could not be created (or another daemon
+     *          is listening on it).
+    */
+    bool listen (const string &path);
+
+    /** Serve the clients until SIGINT or SIGTERM.
+     *
+     *  @pre listen() succeeded.
+     *  @post The digest cache is saved and the socket is removed.
+     *  @return 0 on success, 1 if the cache could not be saved.
+    */
+    int run (void);
+
+  private:
+    /******************************************************
+    **                      Members                      **
+    ******************************************************/
+
+    /**
+     *  @struct Batch A request that is being served.
+     */
+    struct Batch
+    {
+        uint32_t flags;                         // Of the request.
+        string hashFlag;
+        vector < RangeHasher::Range > ranges;
+    };
+
+    /**
+     *  @struct Client A connection that is handed to its thread.
+     */
+    struct Client
+    {
+        HashDaemon *daemon;
+        int fd;
+    };
+
+    /**
+     *  @struct Job A file of a batch.
+     */
+    struct Job
+    {
+        const Batch *batch;                     // The request.
+        string name;                            // The name to report.
+        string path;                            // The file to open.
+        bool done;                              // The job is finished.
+        int status;                             // 0, or 1 on an error.
+        vector < HashState > records;           // Its reply.
+    };
+
+    DigestCache *_cache;            // The shared cache (or NULL).
+    pthread_mutex_t _cacheLock;     // Guards it.
+    bool _dirty;                    // Digests were stored since the last
+                                    // save.
+
+    string _path;                   // The socket.
+    int _socket;                    // The listening socket.
+    uint32_t _threads;              // The number of worker threads.
+
+    vector < pthread_t > _workers;  // The worker threads.
+    pthread_mutex_t _lock;          // Guards the members below.
+    pthread_cond_t _queued;         // Signalled when a job is queued.
+    pthread_cond_t _finished;       // Signalled when a job is done (or a
+                                    // client leaves).
+    std::deque < Job * > _queue;    // The jobs that are waiting.
+    std::set < int > _clients;      // The connections being served.
+    bool _stop;                     // The daemon is stopping.
+
+    /******************************************************
+    **                   Helper Methods                  **
+    ******************************************************/
+
+    /** Serve the requests of one client.
+     *
+     *  @param fd The connection.
+     *  @return none.
+    */
+    void _serve (int fd);
+
+    /** Hash the file of a job and record the reply.
+     *
+     *  @param job The job.
+     *  @param reader The reader of the worker thread.
+     *  @return none.
+    */
+    void _hashFile (Job &job, PrefetchReader &reader);
+
+    /** Hash the byte ranges of the file of a job and record the reply.
+     *
+     *  @param job The job.
+     *  @return none.
+    */
+    void _hashRanges (Job &job);
+
+    /** Save the digest cache if digests were stored since the last save.
+     *
+     *  @return true The cache is saved.
+     *  @return false It could not be written.
+    */
+    bool _save (void);
+
+    /** Record a message (for the standard error of the client).
+     *
+     *  @param job The job.
+     *  @param text The message.
+     *  @return none.
+    */
+    static void _message (Job &job, const string &text);
+
+    /** The body of a worker thread.
+     *
+     *  @param arg The HashDaemon.
+     *  @return NULL.
+    */
+    static void * _workerThread (void *arg);
+
+    /** The body of the thread of a client.
+     *
+     *  @param arg A new Client.
+     *  @return NULL.
+    */
+    static void * _clientThread (void *arg);
+
+    // Not copyable (owns the socket and the threads).
+    HashDaemon (const HashDaemon &);
+    HashDaemon & operator = (const HashDaemon &);
+
+};  // End class HashDaemon.
+
+#endif
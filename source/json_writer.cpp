@@ -0,0 +1,351 @@
+/******************************************************************************
+||  json_writer.cpp                                                          ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    The writer of --json output: one JSON object per line (NDJSON), for    ||
+||    tools that ingest the digests of millions of files.  The records are   ||
+||    built in a 1 MiB buffer and written with write(2) when it fills (and at||
+||    the end), rather than through iostreams and a flush per line.          ||
+||                                                                           ||
+||    Strings are escaped as JSON requires.  File names need not be UTF-8, so||
+||    a byte that is not part of a well-formed UTF-8 sequence is written as a||
+||    lone surrogate (U+DC80 to U+DCFF, as Python's surrogateescape does),   ||
+||    which keeps every name distinct and recoverable.                       ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    Hashes/hash_abstract.h (byte_t)                                        ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file json_writer.cpp
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+#include <errno.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include "json_writer.h"
+
+const uint32_t JsonWriter::BUFFER_BYTES;
+
+/******************************************************
+**            Constructors / Destructors             **
+******************************************************/
+
+/** Initialize a JsonWriter object.
+ *
+ *  @pre fd is open for writing.
+ *  @post Records are written to fd (which is not closed).
+ *  @param fd The output.
+*/
+JsonWriter::JsonWriter (int fd)
+    : _fd(fd),
+      _first(true),
+      _failed(false)
+{}
+
+/** Default destructor (writes out what is buffered).  */
+JsonWriter::~JsonWriter ()
+{
+    flush();
+}
+
+/******************************************************
+**               Accessors / Mutators                **
+******************************************************/
+
+////////////////////
+//    Getters
+////////////////////
+
+/** Determine whether a write has failed.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return true Some output was lost.
+ *  @return false Everything written out so far was written.
+*/
+bool JsonWriter::failed (void) const
+{
+    return _failed;
+}
+
+/******************************************************
+**                      Methods                      **
+******************************************************/
+
+/** Start a record.
+ *
+ *  @pre No record is open.
+ *  @post The fields that follow belong to the record.
+ *  @return none.
+*/
+void JsonWriter::beginRecord (void)
+{
+    // The buffer is only allocated once there is something to write.
+    if (_buffer.capacity() < BUFFER_BYTES)
+        _buffer.reserve(BUFFER_BYTES + 4096);
+
+    _buffer += '{';
+    _first = true;
+
+    return;
+}
+
+/** Add a string field to the record.
+ *
+ *  @pre A record is open.
+ *  @post The field is buffered.
+ *  @param name The name of the field.
+ *  @param value Its value (bytes that are not UTF-8 are escaped as
+ *         lone surrogates, U+DC80 to U+DCFF).
+ *  @return none.
+*/
+void JsonWriter::field (const char *name, const string &value)
+{
+    _name(name);
+    _quote(value);
+
+    return;
+}
+
+/** Add an integer field to the record.
+ *
+ *  @pre A record is open.
+ *  @post The field is buffered.
+ *  @param name The name of the field.
+ *  @param value Its value.
+ *  @return none.
+*/
+void JsonWriter::field (const char *name, uint64_t value)
+{
+    char text[24];
+
+    snprintf(text, sizeof(text), "%llu", (unsigned long long)value);
+
+    _name(name);
+    _buffer += text;
+
+    return;
+}
+
+/** Add a number field to the record.
+ *
+ *  @pre A record is open.
+ *  @post The field is buffered.
+ *  @param name The name of the field.
+ *  @param value Its value (six decimal places).
+ *  @return none.
+*/
+void JsonWriter::field (const char *name, double value)
+{
+    char text[64];
+
+    snprintf(text, sizeof(text), "%.6f", value);
+
+    _name(name);
+    _buffer += text;
+
+    return;
+}
+
+/** Add a boolean field to the record.
+ *
+ *  @pre A record is open.
+ *  @post The field is buffered.
+ *  @param name The name of the field.
+ *  @param value Its value.
+ *  @return none.
+*/
+void JsonWriter::field (const char *name, bool value)
+{
+    _name(name);
+    _buffer += value ? "true" : "false";
+
+    return;
+}
+
+/** End the record (and its line).
+ *
+ *  @pre A record is open.
+ *  @post The record is buffered, and the buffer is written out if it
+ *        is full.
+ *  @return none.
+*/
+void JsonWriter::endRecord (void)
+{
+    _buffer += "}\n";
+
+    if (_buffer.size() >= BUFFER_BYTES)
+        flush();
+
+    return;
+}
+
+/** Write out what is buffered.
+ *
+ *  @pre none.
+ *  @post The buffer is empty.
+ *  @return true The output was written.
+ *  @return false A write failed (now or before).
+*/
+bool JsonWriter::flush (void)
+{
+    size_t written = 0;
+
+    while (!_failed && (written < _buffer.size()))
+    {
+        ssize_t length = write(_fd, _buffer.data() + written,
+                               _buffer.size() - written);
+
+        if ((length < 0) && (errno == EINTR))
+            continue;
+
+        if (length <= 0)
+            _failed = true;
+        else
+            written += (size_t)length;
+    }
+
+    _buffer.clear();
+
+    return !_failed;
+}
+
+/******************************************************
+**                   Helper Methods                  **
+******************************************************/
+
+/** Buffer the name of a field (and the separator before it).
+ *
+ *  @param name The name.
+ *  @return none.
+*/
+void JsonWriter::_name (const char *name)
+{
+    if (!_first)
+        _buffer += ',';
+
+    _first = false;
+
+    _buffer += '"';
+    _buffer += name;
+    _buffer += "\":";
+
+    return;
+}
+
+/** Buffer a quoted, escaped string.
+ *
+ *  @param text The string.
+ *  @return none.
+*/
+void JsonWriter::_quote (const string &text)
+{
+    static const char DIGITS[] = "0123456789abcdef";
+    const byte_t *bytes = (const byte_t *)text.data();
+    size_t length = text.size();
+
+    _buffer += '"';
+
+    for (size_t i = 0; i < length; )
+    {
+        byte_t c = bytes[i];
+
+        if (c < 0x80)
+        {
+            if ((c == '"') || (c == '\\'))
+            {
+                _buffer += '\\';
+                _buffer += (char)c;
+            }
+            else if (c == '\n')
+                _buffer += "\\n";
+            else if (c == '\t')
+                _buffer += "\\t";
+            else if (c < 0x20)
+            {
+                _buffer += "\\u00";
+                _buffer += DIGITS[c >> 4];
+                _buffer += DIGITS[c & 0x0F];
+            }
+            else
+                _buffer += (char)c;
+
+            ++i;
+            continue;
+        }
+
+        // A well-formed UTF-8 sequence (no overlong forms or surrogates)
+        // is copied as it is.
+        size_t count = (c >= 0xC2 && c <= 0xDF) ? 2
+                     : (c >= 0xE0 && c <= 0xEF) ? 3
+                     : (c >= 0xF0 && c <= 0xF4) ? 4 : 0;
+        bool valid = (count > 0) && (i + count <= length);
+
+        for (size_t k = 1; valid && (k < count); ++k)
+            valid = ((bytes[i + k] & 0xC0) == 0x80);
+
+        if (valid && (count == 3))
+            valid = !((c == 0xE0) && (bytes[i + 1] < 0xA0))
+                    && !((c == 0xED) && (bytes[i + 1] >= 0xA0));
+
+        if (valid && (count == 4))
+            valid = !((c == 0xF0) && (bytes[i + 1] < 0x90))
+                    && !((c == 0xF4) && (bytes[i + 1] >= 0x90));
+
+        if (valid)
+        {
+            _buffer.append(text, i, count);
+            i += count;
+
+            continue;
+        }
+
+        // Any other byte is kept as a lone surrogate, which decoders such
+        // as Python's (with surrogateescape) turn back into the byte.
+        _buffer += "\\udc";
+        _buffer += DIGITS[c >> 4];
+        _buffer += DIGITS[c & 0x0F];
+        ++i;
+    }
+
+    _buffer += '"';
+
+    return;
+}
@@ -0,0 +1,215 @@
+/******************************************************************************
+||  json_writer.h                                                            ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    The writer of --json output: one JSON object per line (NDJSON), for    ||
+||    tools that ingest the digests of millions of files.  The records are   ||
+||    built in a 1 MiB buffer and written with write(2) when it fills (and at||
+||    the end), rather than through iostreams and a flush per line.          ||
+||                                                                           ||
+||    Strings are escaped as JSON requires.  File names need not be UTF-8, so||
+||    a byte that is not part of a well-formed UTF-8 sequence is written as a||
+||    lone surrogate (U+DC80 to U+DCFF, as Python's surrogateescape does),   ||
+||    which keeps every name distinct and recoverable.                       ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    Hashes/hash_abstract.h (byte_t)                                        ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file json_writer.h
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+
+#ifndef _GH_JSON_WRITER_DEF_H
+#define _GH_JSON_WRITER_DEF_H
+
+#include "Hashes/hash_abstract.h"
+
+/**
+ *  @class JsonWriter Writes records as newline-delimited JSON through a
+ *         large buffer.
+*/
+class JsonWriter
+{
+  public:
+    /******************************************************
+    **                     Constants                     **
+    ******************************************************/
+
+    /// The size of the buffer; it is written out once it is this full.
+    static const uint32_t BUFFER_BYTES = 1048576;
+
+    /******************************************************
+    **            Constructors / Destructors             **
+    ******************************************************/
+
+    /** Initialize a JsonWriter object.
+     *
+     *  @pre fd is open for writing.
+     *  @post Records are written to fd (which is not closed).
+     *  @param fd The output.
+    */
+    JsonWriter (int fd);
+
+    /** Default destructor (writes out what is buffered).  */
+    ~JsonWriter ();
+
+    /******************************************************
+    **               Accessors / Mutators                **
+    ******************************************************/
+
+    ////////////////////
+    //    Getters
+    ////////////////////
+
+    /** Determine whether a write has failed.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return true Some output was lost.
+     *  @return false Everything written out so far was written.
+    */
+    bool failed (void) const;
+
+    /******************************************************
+    **                      Methods                      **
+    ******************************************************/
+
+    /** Start a record.
+     *
+     *  @pre No record is open.
+     *  @post The fields that follow belong to the record.
+     *  @return none.
+    */
+    void beginRecord (void);
+
+    /** Add a string field to the record.
+     *
+     *  @pre A record is open.
+     *  @post The field is buffered.
+     *  @param name The name of the field.
+     *  @param value Its value (bytes that are not UTF-8 are escaped as
+     *         lone surrogates, U+DC80 to U+DCFF).
+     *  @return none.
+    */
+    void field (const char *name, const string &value);
+
+    /** Add an integer field to the record.
+     *
+     *  @pre A record is open.
+     *  @post The field is buffered.
+     *  @param name The name of the field.
+     *  @param value Its value.
+     *  @return none.
+    */
+    void field (const char *name, uint64_t value);
+
+    /** Add a number field to the record.
+     *
+     *  @pre A record is open.
+     *  @post The field is buffered.
+     *  @param name The name of the field.
+     *  @param value Its value (six decimal places).
+     *  @return none.
+    */
+    void field (const char *name, double value);
+
+    /** Add a boolean field to the record.
+     *
+     *  @pre A record is open.
+     *  @post The field is buffered.
+     *  @param name The name of the field.
+     *  @param value Its value.
+     *  @return none.
+    */
+    void field (const char *name, bool value);
+
+    /** End the record (and its line).
+     *
+     *  @pre A record is open.
+     *  @post The record is buffered, and the buffer is written out if it
+     *        is full.
+     *  @return none.
+    */
+    void endRecord (void);
+
+    /** Write out what is buffered.
+     *
+     *  @pre none.
+     *  @post The buffer is empty.
+     *  @return true The output was written.
+     *  @return false A write failed (now or before).
+    */
+    bool flush (void);
+
+  private:
+    /******************************************************
+    **                      Members                      **
+    ******************************************************/
+
+    int _fd;                        // The output.
+    string _buffer;                 // The records not written yet.
+    bool _first;                    // No field is in the open record.
+    bool _failed;                   // A write failed.
+
+    /******************************************************
+    **                   Helper Methods                  **
+    ******************************************************/
+
+    /** Buffer the name of a field (and the separator before it).
+     *
+     *  @param name The name.
+     *  @return none.
+    */
+    void _name (const char *name);
+
+    /** Buffer a quoted, escaped string.
+     *
+     *  @param text The string.
+     *  @return none.
+    */
+    void _quote (const string &text);
+
+    // Not copyable (owns the buffer).
+    JsonWriter (const JsonWriter &);
+    JsonWriter & operator = (const JsonWriter &);
+
+};  // End class JsonWriter.
+
+#endif
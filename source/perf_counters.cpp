@@ -0,0 +1,479 @@
+/******************************************************************************
+||  perf_counters.cpp                                                        ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    Hardware performance counters for the hashing (--perf): the cycles,    ||
+||    instructions, cache misses and branch misses of the updates, read from ||
+||    perf_event_open(2) for the hashing thread and user space only.  The    ||
+||    report gives the cycles per byte and instructions per cycle of the     ||
+||    algorithm and of the kernel that was selected for this processor       ||
+||    (SHA-NI, AVX2, the portable code), so that a kernel can be measured    ||
+||    rather than guessed at.                                                ||
+||                                                                           ||
+||    The events form a group led by the cycles, enabled just before each    ||
+||    update of the hash and disabled just after, so the reads and the rest  ||
+||    of the program are not counted.  A group the processor cannot hold at  ||
+||    once is multiplexed by the kernel, and the counts are scaled by the    ||
+||    time they ran.                                                         ||
+||                                                                           ||
+||    Comparing the time spent hashing with the time the run took, and the   ||
+||    instructions per cycle with the cache misses, the report says whether  ||
+||    the run is I/O-, memory- or compute-bound.  Without the counters (a    ||
+||    virtual machine, or kernel.perf_event_paranoid) only the bytes and the ||
+||    time are kept.                                                         ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    Hashes/hash_abstract.h                                                 ||
+||    linux/perf_event.h (where there is one)                                ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file perf_counters.cpp
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "perf_counters.h"
+
+#if defined(__linux__) && defined(__has_include)
+  #if __has_include(<linux/perf_event.h>)
+    #define GASH_PERF_EVENTS 1
+  #endif
+#endif
+
+#ifdef GASH_PERF_EVENTS
+  #include <linux/perf_event.h>
+  #include <sys/ioctl.h>
+  #include <sys/syscall.h>
+#endif
+
+const uint32_t PerfCounters::MIN_HASH_SHARE;
+const uint32_t PerfCounters::MIN_COMPUTE_IPC;
+const uint32_t PerfCounters::MIN_MEMORY_MISSES;
+
+/******************************************************
+**            Constructors / Destructors             **
+******************************************************/
+
+/** Initialize a PerfCounters object.
+ *
+ *  @pre none.
+ *  @post Nothing is counted until open() is called.
+*/
+PerfCounters::PerfCounters ()
+    : _leader(-1),
+      _opened(0),
+      _bytes(0),
+      _time(0),
+      _started(0)
+{
+    for (uint32_t c = 0; c < COUNTER_COUNT; ++c)
+    {
+        _fds[c] = -1;
+        _slots[c] = -1;
+    }
+}
+
+/** Default destructor (closes the counters).  */
+PerfCounters::~PerfCounters ()
+{
+    for (uint32_t c = 0; c < COUNTER_COUNT; ++c)
+        if (_fds[c] >= 0)
+            close(_fds[c]);
+}
+
+/******************************************************
+**               Accessors / Mutators                **
+******************************************************/
+
+////////////////////
+//    Getters
+////////////////////
+
+/** Determine whether the hardware counters could be opened.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return true The events are counted.
+ *  @return false Only the bytes and the time are (see error()).
+*/
+bool PerfCounters::available (void) const
+{
+    return (_leader >= 0);
+}
+
+/** Retrieve why the hardware counters could not be opened.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return The error, or "" if they were.
+*/
+string PerfCounters::error (void) const
+{
+    return _error;
+}
+
+/** Retrieve the bytes hashed while counting.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return The bytes.
+*/
+uint64_t PerfCounters::bytes (void) const
+{
+    return _bytes;
+}
+
+/** Retrieve the time spent hashing while counting.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return The time in nanoseconds.
+*/
+uint64_t PerfCounters::time (void) const
+{
+    return _time;
+}
+
+/** Read a counter (scaled up if the kernel multiplexed it).
+ *
+ *  @pre none.
+ *  @post none.
+ *  @param counter The event.
+ *  @param value Receives its count.
+ *  @return true The event is counted.
+ *  @return false The host does not count it.
+*/
+bool PerfCounters::value (Counter counter, uint64_t &value) const
+{
+    value = 0;
+
+#ifdef GASH_PERF_EVENTS
+    if ((_leader < 0) || (_slots[counter] < 0))
+        return false;
+
+    // PERF_FORMAT_GROUP: the number of events, the times the group was
+    // enabled and running, then a value for each event.
+    uint64_t data[3 + COUNTER_COUNT];
+    ssize_t length = read(_leader, data, sizeof(data));
+
+    if (length < (ssize_t)((3 + _opened) * sizeof(uint64_t)))
+        return false;
+
+    uint64_t enabled = data[1];
+    uint64_t running = data[2];
+    double count = (double)data[3 + _slots[counter]];
+
+    // When there are more events than counters the kernel takes turns
+    // with them; the count is scaled to the whole time.
+    if ((running > 0) && (running < enabled))
+        count = count * (double)enabled / (double)running;
+
+    value = (uint64_t)count;
+
+    return true;
+#else
+    (void)counter;
+
+    return false;
+#endif
+}
+
+/******************************************************
+**                      Methods                      **
+******************************************************/
+
+/** Open the counters, for the calling thread and user space only.
+ *
+ *  @pre none.
+ *  @post The counters are open, and stopped.
+ *  @return true The hardware counters are available.
+ *  @return false They are not (a virtual machine, or
+ *          perf_event_paranoid); the bytes and time are still kept.
+*/
+bool PerfCounters::open (void)
+{
+#ifdef GASH_PERF_EVENTS
+    static const uint64_t EVENTS[COUNTER_COUNT] =
+    {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES
+    };
+
+    if (_leader >= 0)
+        return true;
+
+    // The cycles lead the group, so the events are counted over the same
+    // stretches of time and their ratios hold.  Without cycles there is
+    // nothing to report per byte.
+    _leader = _openCounter(EVENTS[CYCLES], -1);
+
+    if (_leader < 0)
+    {
+        _error = string("perf_event_open: ") + strerror(errno);
+        return false;
+    }
+
+    _fds[CYCLES] = _leader;
+    _slots[CYCLES] = 0;
+    _opened = 1;
+
+    // An event the processor does not have is left out.
+    for (uint32_t c = CYCLES + 1; c < COUNTER_COUNT; ++c)
+    {
+        _fds[c] = _openCounter(EVENTS[c], _leader);
+
+        if (_fds[c] >= 0)
+            _slots[c] = _opened++;
+    }
+
+    return true;
+#else
+    _error = "this system has no perf_event_open";
+
+    return false;
+#endif
+}
+
+/** Start counting (before an update of the hash).
+ *
+ *  @pre open() has been called, on this thread.
+ *  @post The events of this thread are counted.
+ *  @return none.
+*/
+void PerfCounters::start (void)
+{
+#ifdef GASH_PERF_EVENTS
+    if (_leader >= 0)
+        ioctl(_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+
+    _started = _now();
+
+    return;
+}
+
+/** Stop counting (after the update).
+ *
+ *  @pre start() has been called.
+ *  @post The events are no longer counted.
+ *  @param bytes The bytes that were hashed.
+ *  @return none.
+*/
+void PerfCounters::stop (uint64_t bytes)
+{
+    _time += _now() - _started;
+    _bytes += bytes;
+
+#ifdef GASH_PERF_EVENTS
+    if (_leader >= 0)
+        ioctl(_leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+#endif
+
+    return;
+}
+
+/** Write the report: cycles per byte, IPC, misses per KiB, the share
+ *  of the run spent hashing, and whether the run is compute-, memory-
+ *  or I/O-bound.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @param out The stream.
+ *  @param algorithm The name of the algorithm.
+ *  @param kernel The name of its kernel.
+ *  @param elapsed The time the whole run took (ns).
+ *  @return none.
+*/
+void PerfCounters::report (ostream &out, const string &algorithm,
+                           const string &kernel, uint64_t elapsed) const
+{
+    char text[160];
+    string report = "Performance of " + algorithm + " (" + kernel
+                    + " kernel):\n";
+
+    if (_bytes == 0)
+    {
+        out << report << "    Nothing was hashed.\n";
+        out.flush();
+
+        return;
+    }
+
+    double seconds = (double)_time / 1e9;
+    double kib = (double)_bytes / 1024.0;
+
+    snprintf(text, sizeof(text), "    Hashed:         %.1f MiB in %.3f s"
+             " (%.1f MiB/s)\n", kib / 1024.0, seconds,
+             (seconds > 0.0) ? kib / 1024.0 / seconds : 0.0);
+    report += text;
+
+    uint64_t cycles = 0, instructions = 0, cacheMisses = 0,
+             branchMisses = 0;
+    bool counted = value(CYCLES, cycles) && (cycles > 0);
+    bool haveInstructions = counted && value(INSTRUCTIONS, instructions);
+    bool haveCacheMisses = counted && value(CACHE_MISSES, cacheMisses);
+    bool haveBranchMisses = counted && value(BRANCH_MISSES, branchMisses);
+    double ipc = haveInstructions ? (double)instructions / (double)cycles
+                                  : 0.0;
+
+    if (counted)
+    {
+        snprintf(text, sizeof(text), "    Cycles/byte:    %.2f\n",
+                 (double)cycles / (double)_bytes);
+        report += text;
+
+        if (haveInstructions)
+        {
+            snprintf(text, sizeof(text), "    IPC:            %.2f\n", ipc);
+            report += text;
+        }
+
+        if (haveCacheMisses)
+        {
+            snprintf(text, sizeof(text), "    Cache misses:   %.3f per KiB\n",
+                     (double)cacheMisses / kib);
+            report += text;
+        }
+
+        if (haveBranchMisses)
+        {
+            snprintf(text, sizeof(text), "    Branch misses:  %.3f per KiB\n",
+                     (double)branchMisses / kib);
+            report += text;
+        }
+    }
+    else
+    {
+        report += "    Counters:       not available ("
+                  + (_error.empty() ? string("no cycles were counted")
+                                    : _error)
+                  + ")\n                    (virtual machines may not"
+                  + " have them; see kernel.perf_event_paranoid)\n";
+    }
+
+    double share = (elapsed > 0) ? 100.0 * (double)_time / (double)elapsed
+                                 : 100.0;
+
+    if (share > 100.0)
+        share = 100.0;
+
+    snprintf(text, sizeof(text), "    Hashing:        %.0f%% of %.3f s\n",
+             share, (double)elapsed / 1e9);
+    report += text;
+
+    // The hashing thread idles between the buffers when the reads are the
+    // limit; otherwise the counters tell a kernel that waits on memory
+    // (few instructions per cycle, with cache misses) from one that does
+    // not.
+    report += "    Verdict:        ";
+
+    if (share < (double)MIN_HASH_SHARE)
+        report += "I/O-bound (the hashing waits for the reads)\n";
+    else if (!counted || !haveInstructions)
+        report += "compute- or memory-bound (the counters would tell)\n";
+    else if ((ipc * 100.0 < (double)MIN_COMPUTE_IPC)
+             && (!haveCacheMisses
+                 || ((double)cacheMisses / kib >= (double)MIN_MEMORY_MISSES)))
+        report += "memory-bound (the kernel waits on cache misses)\n";
+    else
+        report += "compute-bound (the kernel is the limit)\n";
+
+    out << report;
+    out.flush();
+
+    return;
+}
+
+/******************************************************
+**                   Helper Methods                  **
+******************************************************/
+
+/** Open a hardware counter.
+ *
+ *  @param config The event (PERF_COUNT_HW_*).
+ *  @param group The group leader, or -1 to open one.
+ *  @return The descriptor, or -1.
+*/
+int PerfCounters::_openCounter (uint64_t config, int group)
+{
+#ifdef GASH_PERF_EVENTS
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED
+                       | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    // Only the leader starts disabled: the members follow it.  The kernel
+    // is left out, so that the reads are not charged to the hash.
+    attr.disabled = (group < 0) ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    // This thread only (pid 0), on whatever CPU it runs.
+    return (int)syscall(__NR_perf_event_open, &attr, 0, -1, group,
+                        PERF_FLAG_FD_CLOEXEC);
+#else
+    (void)config;
+    (void)group;
+
+    return -1;
+#endif
+}
+
+/** Read the monotonic clock.
+ *
+ *  @return The time in nanoseconds.
+*/
+uint64_t PerfCounters::_now (void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
@@ -0,0 +1,258 @@
+/******************************************************************************
+||  perf_counters.h                                                          ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    Hardware performance counters for the hashing (--perf): the cycles,    ||
+||    instructions, cache misses and branch misses of the updates, read from ||
+||    perf_event_open(2) for the hashing thread and user space only.  The    ||
+||    report gives the cycles per byte and instructions per cycle of the     ||
+||    algorithm and of the kernel that was selected for this processor       ||
+||    (SHA-NI, AVX2, the portable code), so that a kernel can be measured    ||
+||    rather than guessed at.                                                ||
+||                                                                           ||
+||    The events form a group led by the cycles, enabled just before each    ||
+||    update of the hash and disabled just after, so the reads and the rest  ||
+||    of the program are not counted.  A group the processor cannot hold at  ||
+||    once is multiplexed by the kernel, and the counts are scaled by the    ||
+||    time they ran.                                                         ||
+||                                                                           ||
+||    Comparing the time spent hashing with the time the run took, and the   ||
+||    instructions per cycle with the cache misses, the report says whether  ||
+||    the run is I/O-, memory- or compute-bound.  Without the counters (a    ||
+||    virtual machine, or kernel.perf_event_paranoid) only the bytes and the ||
+||    time are kept.                                                         ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    Hashes/hash_abstract.h                                                 ||
+||    linux/perf_event.h (where there is one)                                ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file perf_counters.h
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+
+#ifndef _GH_PERF_COUNTERS_DEF_H
+#define _GH_PERF_COUNTERS_DEF_H
+
+#include "Hashes/hash_abstract.h"
+
+/**
+ *  @class PerfCounters Counts the cycles, instructions, cache misses and
+ *         branch misses of the hashing on the calling thread.
+*/
+class PerfCounters
+{
+  public:
+    /******************************************************
+    **                     Constants                     **
+    ******************************************************/
+
+    /// The hardware events that are counted.
+    enum Counter
+    {
+        CYCLES = 0,
+        INSTRUCTIONS,
+        CACHE_MISSES,
+        BRANCH_MISSES,
+        COUNTER_COUNT
+    };
+
+    /// Below this share of the run (in percent) hashing is not what
+    /// limits it: the run is I/O-bound.
+    static const uint32_t MIN_HASH_SHARE = 50;
+
+    /// Below this many instructions per hundred cycles, with cache misses,
+    /// the kernel is waiting on memory.
+    static const uint32_t MIN_COMPUTE_IPC = 100;
+
+    /// The cache misses per KiB hashed from which the data is taken to
+    /// come from memory rather than the caches.
+    static const uint32_t MIN_MEMORY_MISSES = 1;
+
+    /******************************************************
+    **            Constructors / Destructors             **
+    ******************************************************/
+
+    /** Initialize a PerfCounters object.
+     *
+     *  @pre none.
+     *  @post Nothing is counted until open() is called.
+    */
+    PerfCounters ();
+
+    /** Default destructor (closes the counters).  */
+    ~PerfCounters ();
+
+    /******************************************************
+    **               Accessors / Mutators                **
+    ******************************************************/
+
+    ////////////////////
+    //    Getters
+    ////////////////////
+
+    /** Determine whether the hardware counters could be opened.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return true The events are counted.
+     *  @return false Only the bytes and the time are (see error()).
+    */
+    bool available (void) const;
+
+    /** Retrieve why the hardware counters could not be opened.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return The error, or "" if they were.
+    */
+    string error (void) const;
+
+    /** Retrieve the bytes hashed while counting.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return The bytes.
+    */
+    uint64_t bytes (void) const;
+
+    /** Retrieve the time spent hashing while counting.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return The time in nanoseconds.
+    */
+    uint64_t time (void) const;
+
+    /** Read a counter (scaled up if the kernel multiplexed it).
+     *
+     *  @pre none.
+     *  @post none.
+     *  @param counter The event.
+     *  @param value Receives its count.
+     *  @return true The event is counted.
+     *  @return false The host does not count it.
+    */
+    bool value (Counter counter, uint64_t &value) const;
+
+    /******************************************************
+    **                      Methods                      **
+    ******************************************************/
+
+    /** Open the counters, for the calling thread and user space only.
+     *
+     *  @pre none.
+     *  @post The counters are open, and stopped.
+     *  @return true The hardware counters are available.
+     *  @return false They are not (a virtual machine, or
+     *          perf_event_paranoid); the bytes and time are still kept.
+    */
+    bool open (void);
+
+    /** Start counting (before an update of the hash).
+     *
+     *  @pre open() has been called, on this thread.
+     *  @post The events of this thread are counted.
+     *  @return none.
+    */
+    void start (void);
+
+    /** Stop counting (after the update).
+     *
+     *  @pre start() has been called.
+     *  @post The events are no longer counted.
+     *  @param bytes The bytes that were hashed.
+     *  @return none.
+    */
+    void stop (uint64_t bytes);
+
+    /** Write the report: cycles per byte, IPC, misses per KiB, the share
+     *  of the run spent hashing, and whether the run is compute-, memory-
+     *  or I/O-bound.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @param out The stream.
+     *  @param algorithm The name of the algorithm.
+     *  @param kernel The name of its kernel.
+     *  @param elapsed The time the whole run took (ns).
+     *  @return none.
+    */
+    void report (ostream &out, const string &algorithm, const string &kernel,
+                 uint64_t elapsed) const;
+
+  private:
+    /******************************************************
+    **                      Members                      **
+    ******************************************************/
+
+    int _leader;                    // The group leader (cycles), or -1.
+    int _fds[COUNTER_COUNT];        // The counters (-1: not counted).
+    int _slots[COUNTER_COUNT];      // Their places in a group read.
+    uint32_t _opened;               // The counters in the group.
+    string _error;                  // Why the group could not be opened.
+    uint64_t _bytes;                // The bytes hashed while counting.
+    uint64_t _time;                 // The time spent counting (ns).
+    uint64_t _started;              // When start() was called (ns).
+
+    /******************************************************
+    **                   Helper Methods                  **
+    ******************************************************/
+
+    /** Open a hardware counter.
+     *
+     *  @param config The event (PERF_COUNT_HW_*).
+     *  @param group The group leader, or -1 to open one.
+     *  @return The descriptor, or -1.
+    */
+    static int _openCounter (uint64_t config, int group);
+
+    /** Read the monotonic clock.
+     *
+     *  @return The time in nanoseconds.
+    */
+    static uint64_t _now (void);
+
+    // Not copyable (owns the descriptors).
+    PerfCounters (const PerfCounters &);
+    PerfCounters & operator = (const PerfCounters &);
+
+};  // End class PerfCounters.
+
+#endif
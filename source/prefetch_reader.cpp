@@ -0,0 +1,489 @@
+/******************************************************************************
+||  prefetch_reader.cpp                                                      ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    Hashes a file with its reads and its hashing overlapped.  A dedicated  ||
+||    I/O thread reads the file ahead into a ring of reusable, aligned       ||
+||    buffers while the calling thread hashes the buffers that are already   ||
+||    full, so that hashing a large file takes about as long as the slower of||
+||    reading it and hashing it, rather than their sum.                      ||
+||                                                                           ||
+||    The I/O thread lives as long as the reader and serves one file after   ||
+||    another; files that fit in one buffer are read by the calling thread,  ||
+||    which costs no hand-off.  The reads go through a DirectReader, so they ||
+||    can bypass the page cache as well.                                     ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    direct_reader.cpp                                                      ||
+||    direct_reader.h                                                        ||
+||    Hashes/hash_abstract.cpp (hash_abstract.lib)                           ||
+||    Hashes/hash_abstract.h                                                 ||
+||    pthread                                                                ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file prefetch_reader.cpp
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+
+#include <stdlib.h>
+#include <time.h>
+
+#include "prefetch_reader.h"
+
+const uint32_t PrefetchReader::DEFAULT_BUFFERS;
+const uint32_t PrefetchReader::MAX_BUFFERS;
+const uint32_t PrefetchReader::BUFFER_BYTES;
+
+/******************************************************
+**            Constructors / Destructors             **
+******************************************************/
+
+/** Initialize a PrefetchReader object.
+ *
+ *  @pre 1 <= buffers <= MAX_BUFFERS.
+ *  @post Files are read ahead into the given number of buffers; with
+ *        a single buffer there is no I/O thread, and each read is
+ *        hashed before the next is made.
+ *  @param buffers The number of buffers.
+*/
+PrefetchReader::PrefetchReader (uint32_t buffers)
+    : _source(BUFFER_BYTES),
+      _direct(false),
+      _progress(NULL),
+      _device(0),
+      _perf(NULL),
+      _ring(buffers),
+      _started(false),
+      _reading(false),
+      _stop(false),
+      _filled(0),
+      _head(0),
+      _readTime(0),
+      _hashTime(0)
+{
+    for (size_t b = 0; b < _ring.size(); ++b)
+    {
+        _ring[b].data = NULL;
+        _ring[b].zeros = 0;
+        _ring[b].length = 0;
+    }
+
+    pthread_mutex_init(&_lock, NULL);
+    pthread_cond_init(&_changed, NULL);
+}
+
+/** Default destructor.  */
+PrefetchReader::~PrefetchReader ()
+{
+    if (_started)
+    {
+        pthread_mutex_lock(&_lock);
+        _stop = true;
+        pthread_cond_broadcast(&_changed);
+        pthread_mutex_unlock(&_lock);
+
+        pthread_join(_thread, NULL);
+    }
+
+    for (size_t b = 0; b < _ring.size(); ++b)
+        free(_ring[b].data);
+
+    pthread_cond_destroy(&_changed);
+    pthread_mutex_destroy(&_lock);
+}
+
+/******************************************************
+**               Accessors / Mutators                **
+******************************************************/
+
+////////////////////
+//    Getters
+////////////////////
+
+/** Retrieve the number of buffers.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return The number of buffers.
+*/
+uint32_t PrefetchReader::buffers (void) const
+{
+    return (uint32_t)_ring.size();
+}
+
+/** Determine whether the files are read without caching them.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return true The files are read around the page cache.
+ *  @return false They are read through it.
+*/
+bool PrefetchReader::direct (void) const
+{
+    return _direct;
+}
+
+/** Retrieve the number of bytes read from the last file.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return The bytes read.
+*/
+uint64_t PrefetchReader::bytesRead (void) const
+{
+    return _source.bytesRead();
+}
+
+/** Retrieve the time spent reading the last file (on the I/O thread,
+ *  if there is one, so it overlaps hashTime()).
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return The time in nanoseconds.
+*/
+uint64_t PrefetchReader::readTime (void) const
+{
+    return _readTime;
+}
+
+/** Retrieve the time spent hashing the last file.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return The time in nanoseconds.
+*/
+uint64_t PrefetchReader::hashTime (void) const
+{
+    return _hashTime;
+}
+
+////////////////////
+//    Setters
+////////////////////
+
+/** Select whether the files are read without caching them.
+ *
+ *  @pre none.
+ *  @post The files that are hashed from now on are read with O_DIRECT,
+ *        or dropped from the page cache (see DirectReader).
+ *  @param direct Whether to bypass the page cache.
+ *  @return none.
+*/
+void PrefetchReader::setDirect (bool direct)
+{
+    _direct = direct;
+
+    return;
+}
+
+/** Count the bytes of the files hashed from now on.
+ *
+ *  @pre device was returned by progress->device().
+ *  @post Each buffer that is hashed is added to the counter of device.
+ *  @param progress The counters (or NULL for none).
+ *  @param device The counter of the device of the next file.
+ *  @return none.
+*/
+void PrefetchReader::setProgress (ProgressMonitor *progress, uint32_t device)
+{
+    _progress = progress;
+    _device = device;
+
+    return;
+}
+
+/** Count the events of the updates of the hash.
+ *
+ *  @pre perf has been opened on the thread that calls hash().
+ *  @post Each update (and finalization) is counted.
+ *  @param perf The counters (or NULL for none).
+ *  @return none.
+*/
+void PrefetchReader::setPerf (PerfCounters *perf)
+{
+    _perf = perf;
+
+    return;
+}
+
+/******************************************************
+**                      Methods                      **
+******************************************************/
+
+/** Hash a file.
+ *
+ *  @pre none.
+ *  @post On success hash holds the (finalized) digest of the file.
+ *  @param path The file.
+ *  @param hash The hash; it is reset first.
+ *  @return true The file was hashed.
+ *  @return false It could not be opened or read.
+*/
+bool PrefetchReader::hash (const string &path, MessageHash &hash)
+{
+    // The buffers are only allocated once a file is read (aligned, so
+    // that they can take direct reads).
+    for (size_t b = 0; b < _ring.size(); ++b)
+    {
+        void *memory = NULL;
+
+        if (_ring[b].data != NULL)
+            continue;
+
+        if (posix_memalign(&memory, DirectReader::ALIGNMENT,
+                           BUFFER_BYTES) != 0)
+            return false;
+
+        _ring[b].data = (byte_t *)memory;
+    }
+
+    if (!_source.open(path, _direct))
+        return false;
+
+    hash.reset();
+    _readTime = 0;
+    _hashTime = 0;
+
+    // A file that fits in one buffer has nothing to overlap.
+    bool read = ((_ring.size() == 1) || (_source.fileSize() <= BUFFER_BYTES))
+                ? _hashInline(hash)
+                : _hashPrefetched(hash);
+
+    _source.close();
+
+    if (!read)
+        return false;
+
+    uint64_t start = _clock();
+
+    if (_perf != NULL)
+        _perf->start();
+
+    hash.finalize();
+
+    if (_perf != NULL)
+        _perf->stop(0);
+
+    _hashTime += _clock() - start;
+
+    return true;
+}
+
+/******************************************************
+**                   Helper Methods                  **
+******************************************************/
+
+/** Hash the open file on the calling thread alone.
+ *
+ *  @param hash The (reset) hash.
+ *  @return true The file was read to the end.
+ *  @return false A read failed.
+*/
+bool PrefetchReader::_hashInline (MessageHash &hash)
+{
+    int64_t length;
+
+    // The clock is read between the reads and the updates (two vDSO
+    // calls per buffer).
+    for (;;)
+    {
+        uint64_t start = _clock();
+        uint64_t zeros = _source.skipHole();
+        length = _source.read(_ring[0].data, BUFFER_BYTES);
+        uint64_t read = _clock();
+
+        _readTime += read - start;
+
+        if (_perf != NULL)
+            _perf->start();
+
+        if (zeros > 0)
+            hash.updateZeros(zeros);
+
+        if (length > 0)
+            hash.update(_ring[0].data, (uint64_t)length);
+
+        if (_perf != NULL)
+            _perf->stop(zeros + (uint64_t)((length > 0) ? length : 0));
+
+        _hashTime += _clock() - read;
+
+        if ((_progress != NULL) && (length >= 0))
+            _progress->add(_device, zeros + (uint64_t)length);
+
+        if (length <= 0)
+            break;
+    }
+
+    return (length == 0);
+}
+
+/** Hash the open file while the I/O thread reads ahead.
+ *
+ *  @param hash The (reset) hash.
+ *  @return true The file was read to the end.
+ *  @return false A read failed.
+*/
+bool PrefetchReader::_hashPrefetched (MessageHash &hash)
+{
+    if (!_started)
+    {
+        if (pthread_create(&_thread, NULL, _ioThread, this) != 0)
+            return _hashInline(hash);
+
+        _started = true;
+    }
+
+    pthread_mutex_lock(&_lock);
+    _filled = 0;
+    _head = 0;
+    _reading = true;
+    pthread_cond_broadcast(&_changed);
+
+    int64_t length;
+
+    for (;;)
+    {
+        while (_filled == 0)
+            pthread_cond_wait(&_changed, &_lock);
+
+        // The I/O thread only fills the buffers after the full ones, so
+        // this one can be hashed without the lock.
+        Buffer &buffer = _ring[_head];
+        pthread_mutex_unlock(&_lock);
+
+        uint64_t start = _clock();
+
+        if (_perf != NULL)
+            _perf->start();
+
+        if (buffer.zeros > 0)
+            hash.updateZeros(buffer.zeros);
+
+        length = buffer.length;
+        if (length > 0)
+            hash.update(buffer.data, (uint64_t)length);
+
+        if (_perf != NULL)
+            _perf->stop(buffer.zeros
+                        + (uint64_t)((length > 0) ? length : 0));
+
+        _hashTime += _clock() - start;
+
+        if ((_progress != NULL) && (length >= 0))
+            _progress->add(_device, buffer.zeros + (uint64_t)length);
+
+        pthread_mutex_lock(&_lock);
+        _head = (_head + 1) % (uint32_t)_ring.size();
+        --_filled;
+        pthread_cond_broadcast(&_changed);
+
+        // The last buffer of the file (which the I/O thread stopped at).
+        if (length <= 0)
+            break;
+    }
+
+    pthread_mutex_unlock(&_lock);
+
+    return (length == 0);
+}
+
+/** The body of the I/O thread.
+ *
+ *  @param arg The PrefetchReader.
+ *  @return NULL.
+*/
+void * PrefetchReader::_ioThread (void *arg)
+{
+    PrefetchReader &reader = *(PrefetchReader *)arg;
+    const uint32_t count = (uint32_t)reader._ring.size();
+
+    pthread_mutex_lock(&reader._lock);
+
+    for (;;)
+    {
+        while (!reader._stop
+               && !(reader._reading && (reader._filled < count)))
+            pthread_cond_wait(&reader._changed, &reader._lock);
+
+        if (reader._stop)
+            break;
+
+        uint32_t tail = (reader._head + reader._filled) % count;
+        pthread_mutex_unlock(&reader._lock);
+
+        // A hole is handed over with the data after it, to be hashed as
+        // zeros.
+        uint64_t start = _clock();
+        uint64_t zeros = reader._source.skipHole();
+        int64_t length = reader._source.read(reader._ring[tail].data,
+                                             BUFFER_BYTES);
+        uint64_t elapsed = _clock() - start;
+
+        pthread_mutex_lock(&reader._lock);
+        reader._readTime += elapsed;
+        reader._ring[tail].zeros = zeros;
+        reader._ring[tail].length = length;
+        ++reader._filled;
+
+        // The file is not touched again once its end (or an error) has
+        // been handed over, so that hash() can close it.
+        if (length <= 0)
+            reader._reading = false;
+
+        pthread_cond_broadcast(&reader._changed);
+    }
+
+    pthread_mutex_unlock(&reader._lock);
+
+    return NULL;
+}
+
+/** Read the monotonic clock.
+ *
+ *  @return The time in nanoseconds.
+*/
+uint64_t PrefetchReader::_clock (void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)now.tv_sec * 1000000000 + (uint64_t)now.tv_nsec;
+}
@@ -0,0 +1,281 @@
+/******************************************************************************
+||  prefetch_reader.h                                                        ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    Hashes a file with its reads and its hashing overlapped.  A dedicated  ||
+||    I/O thread reads the file ahead into a ring of reusable, aligned       ||
+||    buffers while the calling thread hashes the buffers that are already   ||
+||    full, so that hashing a large file takes about as long as the slower of||
+||    reading it and hashing it, rather than their sum.                      ||
+||                                                                           ||
+||    The I/O thread lives as long as the reader and serves one file after   ||
+||    another; files that fit in one buffer are read by the calling thread,  ||
+||    which costs no hand-off.  The reads go through a DirectReader, so they ||
+||    can bypass the page cache as well.                                     ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    direct_reader.cpp                                                      ||
+||    direct_reader.h                                                        ||
+||    Hashes/hash_abstract.cpp (hash_abstract.lib)                           ||
+||    Hashes/hash_abstract.h                                                 ||
+||    pthread                                                                ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file prefetch_reader.h
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+
+#ifndef _GH_PREFETCH_READER_DEF_H
+#define _GH_PREFETCH_READER_DEF_H
+
+#include <pthread.h>
+
+#include "Hashes/hash_abstract.h"
+#include "direct_reader.h"
+#include "progress_monitor.h"
+#include "perf_counters.h"
+
+/**
+ *  @class PrefetchReader Hashes files while a second thread reads ahead.
+*/
+class PrefetchReader
+{
+  public:
+    /******************************************************
+    **                     Constants                     **
+    ******************************************************/
+
+    /// The default number of buffers.
+    static const uint32_t DEFAULT_BUFFERS = 4;
+
+    /// The most buffers.
+    static const uint32_t MAX_BUFFERS = 64;
+
+    /// The size of each buffer (and of each read).
+    static const uint32_t BUFFER_BYTES = 1048576;
+
+    /******************************************************
+    **            Constructors / Destructors             **
+    ******************************************************/
+
+    /** Initialize a PrefetchReader object.
+     *
+     *  @pre 1 <= buffers <= MAX_BUFFERS.
+     *  @post Files are read ahead into the given number of buffers; with
+     *        a single buffer there is no I/O thread, and each read is
+     *        hashed before the next is made.
+     *  @param buffers The number of buffers.
+    */
+    PrefetchReader (uint32_t buffers = DEFAULT_BUFFERS);
+
+    /** Default destructor.  */
+    ~PrefetchReader ();
+
+    /******************************************************
+    **               Accessors / Mutators                **
+    ******************************************************/
+
+    ////////////////////
+    //    Getters
+    ////////////////////
+
+    /** Retrieve the number of buffers.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return The number of buffers.
+    */
+    uint32_t buffers (void) const;
+
+    /** Determine whether the files are read without caching them.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return true The files are read around the page cache.
+     *  @return false They are read through it.
+    */
+    bool direct (void) const;
+
+    /** Retrieve the number of bytes read from the last file.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return The bytes read.
+    */
+    uint64_t bytesRead (void) const;
+
+    /** Retrieve the time spent reading the last file (on the I/O thread,
+     *  if there is one, so it overlaps hashTime()).
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return The time in nanoseconds.
+    */
+    uint64_t readTime (void) const;
+
+    /** Retrieve the time spent hashing the last file.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return The time in nanoseconds.
+    */
+    uint64_t hashTime (void) const;
+
+    ////////////////////
+    //    Setters
+    ////////////////////
+
+    /** Select whether the files are read without caching them.
+     *
+     *  @pre none.
+     *  @post The files that are hashed from now on are read with O_DIRECT,
+     *        or dropped from the page cache (see DirectReader).
+     *  @param direct Whether to bypass the page cache.
+     *  @return none.
+    */
+    void setDirect (bool direct);
+
+    /** Count the bytes of the files hashed from now on.
+     *
+     *  @pre device was returned by progress->device().
+     *  @post Each buffer that is hashed is added to the counter of device.
+     *  @param progress The counters (or NULL for none).
+     *  @param device The counter of the device of the next file.
+     *  @return none.
+    */
+    void setProgress (ProgressMonitor *progress, uint32_t device);
+
+    /** Count the events of the updates of the hash.
+     *
+     *  @pre perf has been opened on the thread that calls hash().
+     *  @post Each update (and finalization) is counted.
+     *  @param perf The counters (or NULL for none).
+     *  @return none.
+    */
+    void setPerf (PerfCounters *perf);
+
+    /******************************************************
+    **                      Methods                      **
+    ******************************************************/
+
+    /** Hash a file.
+     *
+     *  @pre none.
+     *  @post On success hash holds the (finalized) digest of the file.
+     *  @param path The file.
+     *  @param hash The hash; it is reset first.
+     *  @return true The file was hashed.
+     *  @return false It could not be opened or read.
+    */
+    bool hash (const string &path, MessageHash &hash);
+
+  private:
+    /******************************************************
+    **                      Members                      **
+    ******************************************************/
+
+    /**
+     *  @struct Buffer A buffer of the ring and the read that filled it.
+    */
+    struct Buffer
+    {
+        byte_t *data;               // The (aligned) buffer.
+        uint64_t zeros;             // The hole of the file before it.
+        int64_t length;             // The bytes read: 0 at the end of the
+                                    // file, or -1 if the read failed.
+    };
+
+    DirectReader _source;           // The file being read.
+    bool _direct;                   // Bypass the page cache.
+    ProgressMonitor *_progress;     // The progress counters (or NULL).
+    uint32_t _device;               // The counter of the file.
+    PerfCounters *_perf;            // The event counters (or NULL).
+    vector < Buffer > _ring;        // The buffers.
+
+    pthread_t _thread;              // The I/O thread (once started).
+    bool _started;
+    pthread_mutex_t _lock;          // Guards the members below.
+    pthread_cond_t _changed;        // Signalled when they change.
+    bool _reading;                  // The I/O thread is reading a file.
+    bool _stop;                     // The I/O thread is to exit.
+    uint32_t _filled;               // The full buffers, which start at
+    uint32_t _head;                 // _head (in the order of the file).
+    uint64_t _readTime;             // The time spent in reads (ns).
+    uint64_t _hashTime;             // The time spent hashing (ns).
+
+    /******************************************************
+    **                   Helper Methods                  **
+    ******************************************************/
+
+    /** Hash the open file on the calling thread alone.
+     *
+     *  @param hash The (reset) hash.
+     *  @return true The file was read to the end.
+     *  @return false A read failed.
+    */
+    bool _hashInline (MessageHash &hash);
+
+    /** Hash the open file while the I/O thread reads ahead.
+     *
+     *  @param hash The (reset) hash.
+     *  @return true The file was read to the end.
+     *  @return false A read failed.
+    */
+    bool _hashPrefetched (MessageHash &hash);
+
+    /** The body of the I/O thread.
+     *
+     *  @param arg The PrefetchReader.
+     *  @return NULL.
+    */
+    static void * _ioThread (void *arg);
+
+    /** Read the monotonic clock.
+     *
+     *  @return The time in nanoseconds.
+    */
+    static uint64_t _clock (void);
+
+    // Not copyable (owns the buffers and the thread).
+    PrefetchReader (const PrefetchReader &);
+    PrefetchReader & operator = (const PrefetchReader &);
+
+};  // End class PrefetchReader.
+
+#endif
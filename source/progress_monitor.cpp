@@ -0,0 +1,577 @@
+/******************************************************************************
+||  progress_monitor.cpp                                                     ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    The progress of a run: the files finished and the bytes hashed, in     ||
+||    total and for each device, with the current rate and the time left.    ||
+||    Long runs are otherwise silent until they end.                         ||
+||                                                                           ||
+||    The readers count the bytes of each buffer they hash with a relaxed    ||
+||    atomic add, and that is all the hashing pays.  A thread of the monitor ||
+||    samples the counters once a second, sizes the files (a batch at a time,||
+||    so the total is known early on) and, with --progress, draws a progress ||
+||    line on the standard error (redrawn in place on a terminal, logged     ||
+||    every ten seconds elsewhere).                                          ||
+||                                                                           ||
+||    SIGUSR1 (and SIGINFO, where the system has it) asks for a full status  ||
+||    report at any time.  The signals are blocked in every thread and taken ||
+||    with sigtimedwait() by the monitor thread, so the report is not written||
+||    from a signal handler.                                                 ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    Hashes/hash_abstract.h                                                 ||
+||    pthread                                                                ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file progress_monitor.cpp
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+
+#include "progress_monitor.h"
+
+const uint32_t ProgressMonitor::MAX_DEVICES;
+const uint32_t ProgressMonitor::SAMPLE_INTERVAL;
+const uint32_t ProgressMonitor::LOG_SAMPLES;
+const uint32_t ProgressMonitor::SIZE_BATCH;
+
+// The milliseconds the monitor thread waits for a signal at a time (and
+// so the longest that stop() waits for it).
+static const long POLL_INTERVAL = 100;
+
+/******************************************************
+**            Constructors / Destructors             **
+******************************************************/
+
+/** Initialize a ProgressMonitor object.
+ *
+ *  @pre none.
+ *  @post The counters are zero.
+ *  @param display Whether to show the progress on the standard error
+ *         (otherwise it is only reported on SIGUSR1 or SIGINFO).
+*/
+ProgressMonitor::ProgressMonitor (bool display)
+    : _skipped(0),
+      _done(0),
+      _deviceCount(0),
+      _overflow(false),
+      _display(display),
+      _terminal(isatty(STDERR_FILENO) != 0),
+      _started(false),
+      _stop(false),
+      _sized(0),
+      _totalBytes(0),
+      _streams(false),
+      _startTime(0),
+      _sampleTime(0),
+      _samples(0)
+{
+    for (uint32_t d = 0; d < MAX_DEVICES; ++d)
+    {
+        _bytes[d] = 0;
+        _devices[d] = 0;
+        _sampled[d] = 0;
+        _rates[d] = 0.0;
+    }
+
+    sigemptyset(&_signals);
+    pthread_mutex_init(&_lock, NULL);
+}
+
+/** Default destructor (stops the thread).  */
+ProgressMonitor::~ProgressMonitor ()
+{
+    stop();
+    pthread_mutex_destroy(&_lock);
+}
+
+/******************************************************
+**                      Methods                      **
+******************************************************/
+
+/** Start the thread that samples the counters, sizes the files and
+ *  reports the progress.  SIGUSR1 (and SIGINFO, where there is one) is
+ *  blocked, so the threads that are created from now on leave it to
+ *  the monitor.
+ *
+ *  @pre Called once, before the threads that hash are created.
+ *  @post The thread is running.
+ *  @param files The files of the run (to size the work).
+ *  @return true The thread is running.
+ *  @return false It could not be created (the counters still count).
+*/
+bool ProgressMonitor::start (const vector < string > &files)
+{
+    sigaddset(&_signals, SIGUSR1);
+#ifdef SIGINFO
+    sigaddset(&_signals, SIGINFO);
+#endif
+
+    // The signals are taken with sigtimedwait() on the monitor thread,
+    // rather than by a handler, so the report can be written safely.
+    pthread_sigmask(SIG_BLOCK, &_signals, NULL);
+
+    _files = files;
+    _startTime = _now();
+    _sampleTime = _startTime;
+
+    if (pthread_create(&_thread, NULL, _monitorThread, this) != 0)
+    {
+        pthread_sigmask(SIG_UNBLOCK, &_signals, NULL);
+
+        return false;
+    }
+
+    _started = true;
+
+    return true;
+}
+
+/** Stop the thread (and clear the progress line).
+ *
+ *  @pre none.
+ *  @post The thread has exited.  The signals stay blocked, so that one
+ *        that arrives late is not fatal.
+ *  @return none.
+*/
+void ProgressMonitor::stop (void)
+{
+    if (!_started)
+        return;
+
+    __atomic_store_n(&_stop, true, __ATOMIC_RELEASE);
+    pthread_join(_thread, NULL);
+    _started = false;
+
+    if (_display && _terminal && (_samples > 0))
+        _write("\r\033[K");
+
+    return;
+}
+
+/** Find the counter of a device.
+ *
+ *  @pre none.
+ *  @post The device is counted from now on.
+ *  @param device The device of a file (st_dev).
+ *  @return The index of its counter, for add().
+*/
+uint32_t ProgressMonitor::device (dev_t device)
+{
+    pthread_mutex_lock(&_lock);
+
+    uint32_t d = 0;
+    while ((d < _deviceCount) && (_devices[d] != device))
+        ++d;
+
+    if (d == _deviceCount)
+    {
+        if (_deviceCount < MAX_DEVICES)
+        {
+            _devices[d] = device;
+            ++_deviceCount;
+        }
+        else
+        {
+            // The last counter takes every device beyond the table.
+            d = MAX_DEVICES - 1;
+            _overflow = true;
+        }
+    }
+
+    pthread_mutex_unlock(&_lock);
+
+    return d;
+}
+
+/** Count bytes that were hashed (from any thread).
+ *
+ *  @pre device was returned by device().
+ *  @post The bytes are counted.
+ *  @param device The counter of the device.
+ *  @param bytes The bytes.
+ *  @return none.
+*/
+void ProgressMonitor::add (uint32_t device, uint64_t bytes)
+{
+    // Nothing is ordered by the counters, so a relaxed add (a locked add
+    // on x86, once per buffer) is all that the readers pay.
+    __atomic_fetch_add(&_bytes[device], bytes, __ATOMIC_RELAXED);
+
+    return;
+}
+
+/** Count bytes that were not read (a cached digest, or the part of a
+ *  file that a checkpoint covers): they are done, but not hashed.
+ *
+ *  @pre none.
+ *  @post The bytes are counted.
+ *  @param bytes The bytes.
+ *  @return none.
+*/
+void ProgressMonitor::skip (uint64_t bytes)
+{
+    __atomic_fetch_add(&_skipped, bytes, __ATOMIC_RELAXED);
+
+    return;
+}
+
+/** Count a file that is finished (or failed).
+ *
+ *  @pre none.
+ *  @post The file is counted.
+ *  @return none.
+*/
+void ProgressMonitor::fileDone (void)
+{
+    __atomic_fetch_add(&_done, (uint64_t)1, __ATOMIC_RELAXED);
+
+    return;
+}
+
+/******************************************************
+**                   Helper Methods                  **
+******************************************************/
+
+/** The loop of the monitor thread.
+ *
+ *  @return none.
+*/
+void ProgressMonitor::_run (void)
+{
+    for (;;)
+    {
+        struct timespec timeout;
+        timeout.tv_sec = 0;
+        timeout.tv_nsec = POLL_INTERVAL * 1000000L;
+
+        int signal = sigtimedwait(&_signals, NULL, &timeout);
+
+        if (__atomic_load_n(&_stop, __ATOMIC_ACQUIRE))
+            break;
+
+        // The files are sized a batch at a time, off the threads that
+        // hash them, so that the first report is not held up by a large
+        // tree.
+        for (uint32_t i = 0; (i < SIZE_BATCH) && (_sized < _files.size());
+             ++i, ++_sized)
+        {
+            struct stat status;
+
+            if (stat(_files[_sized].c_str(), &status) != 0)
+                continue;
+
+            if (S_ISREG(status.st_mode))
+                _totalBytes += (uint64_t)status.st_size;
+            else
+                _streams = true;
+        }
+
+        uint64_t now = _now();
+
+        if (now - _sampleTime >= (uint64_t)SAMPLE_INTERVAL * 1000000)
+        {
+            _sample(now);
+
+            if (_display && (_terminal || (_samples % LOG_SAMPLES == 0)))
+                _draw(now);
+        }
+
+        if (signal > 0)
+            _dump(now);
+    }
+
+    return;
+}
+
+/** Sample the counters and update the recent rates.
+ *
+ *  @param now The current time (ns).
+ *  @return none.
+*/
+void ProgressMonitor::_sample (uint64_t now)
+{
+    double seconds = (double)(now - _sampleTime) / 1e9;
+
+    for (uint32_t d = 0; d < MAX_DEVICES; ++d)
+    {
+        uint64_t bytes = __atomic_load_n(&_bytes[d], __ATOMIC_RELAXED);
+        double rate = (double)(bytes - _sampled[d]) / seconds;
+
+        // Smoothed over the last few samples, so that the rate (and the
+        // time left) does not jump with each file.
+        _rates[d] = (_samples == 0) ? rate : (_rates[d] + rate) / 2;
+        _sampled[d] = bytes;
+    }
+
+    _sampleTime = now;
+    ++_samples;
+
+    return;
+}
+
+/** Write the progress line.
+ *
+ *  @param now The current time (ns).
+ *  @return none.
+*/
+void ProgressMonitor::_draw (uint64_t now)
+{
+    uint64_t files = __atomic_load_n(&_done, __ATOMIC_RELAXED),
+             done = _hashed() + __atomic_load_n(&_skipped, __ATOMIC_RELAXED);
+    bool sized = (_sized == _files.size()) && !_streams;
+    char text[256];
+
+    (void)now;
+
+    if (sized)
+    {
+        int percent = (_totalBytes > 0) && (done < _totalBytes)
+                      ? (int)(done * 100 / _totalBytes) : 100;
+
+        snprintf(text, sizeof(text),
+                 "%llu/%llu files, %s of %s (%d%%), %s/s, ETA %s",
+                 (unsigned long long)files,
+                 (unsigned long long)_files.size(),
+                 _size((double)done).c_str(),
+                 _size((double)_totalBytes).c_str(), percent,
+                 _size(_rate()).c_str(), _eta(done).c_str());
+    }
+    else
+    {
+        snprintf(text, sizeof(text), "%llu/%llu files, %s, %s/s",
+                 (unsigned long long)files,
+                 (unsigned long long)_files.size(),
+                 _size((double)done).c_str(), _size(_rate()).c_str());
+    }
+
+    // On a terminal the line is redrawn in place (and the cursor left at
+    // its start, for whatever is written next); elsewhere it is logged.
+    if (_terminal)
+        _write(string("\r\033[K") + text + "\r");
+    else
+        _write(string(text) + "\n");
+
+    return;
+}
+
+/** Write the full status report (for SIGUSR1).
+ *
+ *  @param now The current time (ns).
+ *  @return none.
+*/
+void ProgressMonitor::_dump (uint64_t now)
+{
+    uint64_t files = __atomic_load_n(&_done, __ATOMIC_RELAXED),
+             hashed = _hashed(),
+             done = hashed + __atomic_load_n(&_skipped, __ATOMIC_RELAXED);
+    double seconds = (double)(now - _startTime) / 1e9;
+    bool sized = (_sized == _files.size()) && !_streams;
+    string report = (_display && _terminal) ? "\r\033[K" : "";
+    char text[256];
+
+    snprintf(text, sizeof(text), "Progress: %llu of %llu files, %s",
+             (unsigned long long)files, (unsigned long long)_files.size(),
+             _size((double)done).c_str());
+    report += text;
+
+    if (sized)
+        report += " of " + _size((double)_totalBytes);
+
+    report += " in " + _duration((uint64_t)seconds) + ".\n";
+
+    snprintf(text, sizeof(text), "Rate: %s/s (%s/s on average), ETA %s.\n",
+             _size(_rate()).c_str(),
+             _size((seconds > 0) ? (double)hashed / seconds : 0.0).c_str(),
+             sized ? _eta(done).c_str() : "unknown");
+    report += text;
+
+    pthread_mutex_lock(&_lock);
+
+    for (uint32_t d = 0; d < _deviceCount; ++d)
+    {
+        uint64_t bytes = __atomic_load_n(&_bytes[d], __ATOMIC_RELAXED);
+
+        if (_overflow && (d == MAX_DEVICES - 1))
+            snprintf(text, sizeof(text), "Other devices: ");
+        else
+        {
+            snprintf(text, sizeof(text), "Device %u:%u: ",
+                     major(_devices[d]), minor(_devices[d]));
+        }
+
+        report += text;
+        report += _size((double)bytes) + ", " + _size(_rates[d]) + "/s.\n";
+    }
+
+    pthread_mutex_unlock(&_lock);
+
+    _write(report);
+
+    return;
+}
+
+/** Sum the bytes hashed from every device.
+ *
+ *  @return The bytes.
+*/
+uint64_t ProgressMonitor::_hashed (void) const
+{
+    uint64_t bytes = 0;
+
+    for (uint32_t d = 0; d < MAX_DEVICES; ++d)
+        bytes += __atomic_load_n(&_bytes[d], __ATOMIC_RELAXED);
+
+    return bytes;
+}
+
+/** Retrieve the recent rate over every device.
+ *
+ *  @return The rate (bytes/s).
+*/
+double ProgressMonitor::_rate (void) const
+{
+    double rate = 0.0;
+
+    for (uint32_t d = 0; d < MAX_DEVICES; ++d)
+        rate += _rates[d];
+
+    return rate;
+}
+
+/** Format the time left at the recent rate.
+ *
+ *  @param done The bytes done.
+ *  @return The time ("1:02:03"), or "unknown".
+*/
+string ProgressMonitor::_eta (uint64_t done) const
+{
+    double rate = _rate();
+
+    if (done >= _totalBytes)
+        return _duration(0);
+
+    if (rate < 1.0)
+        return "unknown";
+
+    return _duration((uint64_t)((double)(_totalBytes - done) / rate + 0.5));
+}
+
+/** Write a report to the standard error in a single write.
+ *
+ *  @param text The report.
+ *  @return none.
+*/
+void ProgressMonitor::_write (const string &text)
+{
+    // One write, so that the report is not interleaved with the error
+    // messages of the other threads.
+    ssize_t written = write(STDERR_FILENO, text.data(), text.size());
+    (void)written;
+
+    return;
+}
+
+/** Format a number of bytes ("1.5 GiB").
+ *
+ *  @param bytes The bytes.
+ *  @return The text.
+*/
+string ProgressMonitor::_size (double bytes)
+{
+    static const char *UNITS[] = { "B", "KiB", "MiB", "GiB", "TiB", "PiB" };
+    size_t unit = 0;
+    char text[32];
+
+    while ((bytes >= 1024.0) && (unit + 1 < sizeof(UNITS) / sizeof(UNITS[0])))
+    {
+        bytes /= 1024.0;
+        ++unit;
+    }
+
+    snprintf(text, sizeof(text), (unit == 0) ? "%.0f %s" : "%.1f %s", bytes,
+             UNITS[unit]);
+
+    return text;
+}
+
+/** Format a duration ("1:02:03").
+ *
+ *  @param seconds The seconds.
+ *  @return The text.
+*/
+string ProgressMonitor::_duration (uint64_t seconds)
+{
+    char text[32];
+
+    snprintf(text, sizeof(text), "%llu:%02u:%02u",
+             (unsigned long long)(seconds / 3600),
+             (unsigned)(seconds / 60 % 60), (unsigned)(seconds % 60));
+
+    return text;
+}
+
+/** Read the monotonic clock.
+ *
+ *  @return The time in nanoseconds.
+*/
+uint64_t ProgressMonitor::_now (void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+/** The body of the monitor thread.
+ *
+ *  @param arg The ProgressMonitor.
+ *  @return NULL.
+*/
+void * ProgressMonitor::_monitorThread (void *arg)
+{
+    ((ProgressMonitor *)arg)->_run();
+
+    return NULL;
+}
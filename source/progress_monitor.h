@@ -0,0 +1,304 @@
+/******************************************************************************
+||  progress_monitor.h                                                       ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    The progress of a run: the files finished and the bytes hashed, in     ||
+||    total and for each device, with the current rate and the time left.    ||
+||    Long runs are otherwise silent until they end.                         ||
+||                                                                           ||
+||    The readers count the bytes of each buffer they hash with a relaxed    ||
+||    atomic add, and that is all the hashing pays.  A thread of the monitor ||
+||    samples the counters once a second, sizes the files (a batch at a time,||
+||    so the total is known early on) and, with --progress, draws a progress ||
+||    line on the standard error (redrawn in place on a terminal, logged     ||
+||    every ten seconds elsewhere).                                          ||
+||                                                                           ||
+||    SIGUSR1 (and SIGINFO, where the system has it) asks for a full status  ||
+||    report at any time.  The signals are blocked in every thread and taken ||
+||    with sigtimedwait() by the monitor thread, so the report is not written||
+||    from a signal handler.                                                 ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    Hashes/hash_abstract.h                                                 ||
+||    pthread                                                                ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file progress_monitor.h
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+
+#ifndef _GH_PROGRESS_MONITOR_DEF_H
+#define _GH_PROGRESS_MONITOR_DEF_H
+
+#include <pthread.h>
+#include <signal.h>
+#include <sys/types.h>
+
+#include "Hashes/hash_abstract.h"
+
+/**
+ *  @class ProgressMonitor Counts the files and bytes of a run, and reports
+ *         the progress from a thread of its own.
+*/
+class ProgressMonitor
+{
+  public:
+    /******************************************************
+    **                     Constants                     **
+    ******************************************************/
+
+    /// The most devices that are counted apart (the rest share the last).
+    static const uint32_t MAX_DEVICES = 16;
+
+    /// The milliseconds between the samples of the counters (and the
+    /// redraws of the progress line on a terminal).
+    static const uint32_t SAMPLE_INTERVAL = 1000;
+
+    /// The samples between the progress lines that are not written to a
+    /// terminal.
+    static const uint32_t LOG_SAMPLES = 10;
+
+    /// The files that are sized at a time (between the waits for a
+    /// signal).
+    static const uint32_t SIZE_BATCH = 4096;
+
+    /******************************************************
+    **            Constructors / Destructors             **
+    ******************************************************/
+
+    /** Initialize a ProgressMonitor object.
+     *
+     *  @pre none.
+     *  @post The counters are zero.
+     *  @param display Whether to show the progress on the standard error
+     *         (otherwise it is only reported on SIGUSR1 or SIGINFO).
+    */
+    ProgressMonitor (bool display);
+
+    /** Default destructor (stops the thread).  */
+    ~ProgressMonitor ();
+
+    /******************************************************
+    **                      Methods                      **
+    ******************************************************/
+
+    /** Start the thread that samples the counters, sizes the files and
+     *  reports the progress.  SIGUSR1 (and SIGINFO, where there is one) is
+     *  blocked, so the threads that are created from now on leave it to
+     *  the monitor.
+     *
+     *  @pre Called once, before the threads that hash are created.
+     *  @post The thread is running.
+     *  @param files The files of the run (to size the work).
+     *  @return true The thread is running.
+     *  @return false It could not be created (the counters still count).
+    */
+    bool start (const vector < string > &files);
+
+    /** Stop the thread (and clear the progress line).
+     *
+     *  @pre none.
+     *  @post The thread has exited.  The signals stay blocked, so that one
+     *        that arrives late is not fatal.
+     *  @return none.
+    */
+    void stop (void);
+
+    /** Find the counter of a device.
+     *
+     *  @pre none.
+     *  @post The device is counted from now on.
+     *  @param device The device of a file (st_dev).
+     *  @return The index of its counter, for add().
+    */
+    uint32_t device (dev_t device);
+
+    /** Count bytes that were hashed (from any thread).
+     *
+     *  @pre device was returned by device().
+     *  @post The bytes are counted.
+     *  @param device The counter of the device.
+     *  @param bytes The bytes.
+     *  @return none.
+    */
+    void add (uint32_t device, uint64_t bytes);
+
+    /** Count bytes that were not read (a cached digest, or the part of a
+     *  file that a checkpoint covers): they are done, but not hashed.
+     *
+     *  @pre none.
+     *  @post The bytes are counted.
+     *  @param bytes The bytes.
+     *  @return none.
+    */
+    void skip (uint64_t bytes);
+
+    /** Count a file that is finished (or failed).
+     *
+     *  @pre none.
+     *  @post The file is counted.
+     *  @return none.
+    */
+    void fileDone (void);
+
+  private:
+    /******************************************************
+    **                      Members                      **
+    ******************************************************/
+
+    // The counters (updated with relaxed atomic adds).
+    uint64_t _bytes[MAX_DEVICES];   // The bytes hashed from each device.
+    uint64_t _skipped;              // The bytes done without reading.
+    uint64_t _done;                 // The files finished.
+
+    pthread_mutex_t _lock;          // Guards the device table.
+    dev_t _devices[MAX_DEVICES];    // The device of each counter.
+    uint32_t _deviceCount;          // The counters in use.
+    bool _overflow;                 // The last counter is shared.
+
+    bool _display;                  // Show the progress.
+    bool _terminal;                 // ... on a terminal (redrawn).
+    sigset_t _signals;              // The signals that ask for a report.
+    pthread_t _thread;              // The monitor thread.
+    bool _started;                  // It is running.
+    bool _stop;                     // It should exit.
+
+    // The state of the monitor thread.
+    vector < string > _files;       // The files to size.
+    size_t _sized;                  // The files sized so far.
+    uint64_t _totalBytes;           // Their bytes.
+    bool _streams;                  // Some of them cannot be sized.
+    uint64_t _startTime;            // When the run started (ns).
+    uint64_t _sampleTime;           // When the counters were last sampled.
+    uint64_t _sampled[MAX_DEVICES]; // The bytes at the last sample.
+    double _rates[MAX_DEVICES];     // The recent rate of each device
+                                    // (bytes/s).
+    uint32_t _samples;              // The samples taken.
+
+    /******************************************************
+    **                   Helper Methods                  **
+    ******************************************************/
+
+    /** The loop of the monitor thread.
+     *
+     *  @return none.
+    */
+    void _run (void);
+
+    /** Sample the counters and update the recent rates.
+     *
+     *  @param now The current time (ns).
+     *  @return none.
+    */
+    void _sample (uint64_t now);
+
+    /** Write the progress line.
+     *
+     *  @param now The current time (ns).
+     *  @return none.
+    */
+    void _draw (uint64_t now);
+
+    /** Write the full status report (for SIGUSR1).
+     *
+     *  @param now The current time (ns).
+     *  @return none.
+    */
+    void _dump (uint64_t now);
+
+    /** Sum the bytes hashed from every device.
+     *
+     *  @return The bytes.
+    */
+    uint64_t _hashed (void) const;
+
+    /** Retrieve the recent rate over every device.
+     *
+     *  @return The rate (bytes/s).
+    */
+    double _rate (void) const;
+
+    /** Format the time left at the recent rate.
+     *
+     *  @param done The bytes done.
+     *  @return The time ("1:02:03"), or "unknown".
+    */
+    string _eta (uint64_t done) const;
+
+    /** Write a report to the standard error in a single write.
+     *
+     *  @param text The report.
+     *  @return none.
+    */
+    static void _write (const string &text);
+
+    /** Format a number of bytes ("1.5 GiB").
+     *
+     *  @param bytes The bytes.
+     *  @return The text.
+    */
+    static string _size (double bytes);
+
+    /** Format a duration ("1:02:03").
+     *
+     *  @param seconds The seconds.
+     *  @return The text.
+    */
+    static string _duration (uint64_t seconds);
+
+    /** Read the monotonic clock.
+     *
+     *  @return The time in nanoseconds.
+    */
+    static uint64_t _now (void);
+
+    /** The body of the monitor thread.
+     *
+     *  @param arg The ProgressMonitor.
+     *  @return NULL.
+    */
+    static void * _monitorThread (void *arg);
+
+    // Not copyable (owns the thread).
+    ProgressMonitor (const ProgressMonitor &);
+    ProgressMonitor & operator = (const ProgressMonitor &);
+
+};  // End class ProgressMonitor.
+
+#endif
@@ -0,0 +1,355 @@
+/******************************************************************************
+||  range_hasher.cpp                                                         ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    Hashes byte ranges of a file ([offset, offset + length)) with          ||
+||    positioned reads (pread), so that a segment of a large container file  ||
+||    or a database page can be verified without reading the rest of the     ||
+||    file.  Each range of a list gets its own digest, and the ranges are    ||
+||    read in the order given, without moving a shared file position.        ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    range_hasher.h                                                         ||
+||    Hashes/hash_abstract.cpp (hash_abstract.lib)                           ||
+||    Hashes/hash_abstract.h                                                 ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file range_hasher.cpp
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "range_hasher.h"
+
+const uint32_t RangeHasher::READ_BUFFER_BYTES;
+
+/******************************************************
+**            Constructors / Destructors             **
+******************************************************/
+
+/** Initialize a RangeHasher object.
+ *
+ *  @pre none.
+ *  @post The ranges are hashed with a clone of prototype.
+ *  @param prototype A hash object of the algorithm; it is copied.
+*/
+RangeHasher::RangeHasher (const MessageHash &prototype)
+    : _hash(prototype.clone()),
+      _fd(-1),
+      _fileSize(0),
+      _bytesRead(0)
+{}
+
+/** Default destructor.  */
+RangeHasher::~RangeHasher ()
+{
+    close();
+    delete _hash;
+}
+
+/******************************************************
+**               Accessors / Mutators                **
+******************************************************/
+
+////////////////////
+//    Getters
+////////////////////
+
+/** Retrieve the size of the open file.
+ *
+ *  @pre open() succeeded.
+ *  @post none.
+ *  @return The size in bytes.
+*/
+uint64_t RangeHasher::fileSize (void) const
+{
+    return _fileSize;
+}
+
+/** Retrieve the number of bytes read since open().
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return The bytes read.
+*/
+uint64_t RangeHasher::bytesRead (void) const
+{
+    return _bytesRead;
+}
+
+/******************************************************
+**                      Methods                      **
+******************************************************/
+
+/** Open a file.
+ *
+ *  @pre none.
+ *  @post Any file that was open is closed.
+ *  @param path The file.
+ *  @return true The file was opened.
+ *  @return false It could not be opened (or is not a regular file).
+*/
+bool RangeHasher::open (const string &path)
+{
+    close();
+
+    _fd = ::open(path.c_str(), O_RDONLY);
+    if (_fd < 0)
+        return false;
+
+    struct stat status;
+    if ((fstat(_fd, &status) != 0) || !S_ISREG(status.st_mode))
+    {
+        close();
+        return false;
+    }
+
+    _fileSize = (uint64_t)status.st_size;
+    _bytesRead = 0;
+
+    // The ranges may be anywhere, so the kernel should not read ahead
+    // of them past what each range asks for.
+    posix_fadvise(_fd, 0, 0, POSIX_FADV_RANDOM);
+
+    return true;
+}
+
+/** Close the file (if it is open).
+ *
+ *  @pre none.
+ *  @post No file is open.
+ *  @return none.
+*/
+void RangeHasher::close (void)
+{
+    if (_fd >= 0)
+        ::close(_fd);
+
+    _fd = -1;
+    _fileSize = 0;
+
+    return;
+}
+
+/** Hash a byte range of the open file.
+ *
+ *  @pre open() succeeded.
+ *  @post On success the digest of the range is in digest().
+ *  @param range The range; it must lie within the file.
+ *  @return true The range was hashed.
+ *  @return false The range runs past the end of the file, or it
+ *          could not be read.
+*/
+bool RangeHasher::hash (const Range &range)
+{
+    if ((_fd < 0) || (range.offset > _fileSize)
+        || (range.length > _fileSize - range.offset))
+        return false;
+
+    if (_buffer.empty())
+        _buffer.resize(READ_BUFFER_BYTES);
+
+    // A long range is read ahead as it is hashed.
+    if (range.length > READ_BUFFER_BYTES)
+    {
+        posix_fadvise(_fd, (off_t)range.offset, (off_t)range.length,
+                      POSIX_FADV_WILLNEED);
+    }
+
+    uint64_t offset = range.offset,
+             left = range.length;
+
+    _hash->reset();
+
+    while (left > 0)
+    {
+        size_t wanted = (left < READ_BUFFER_BYTES) ? (size_t)left
+                                                   : READ_BUFFER_BYTES;
+        ssize_t length = pread(_fd, &_buffer[0], wanted, (off_t)offset);
+
+        if ((length < 0) && (errno == EINTR))
+            continue;
+
+        // The file was truncated (or failed) under us.
+        if (length <= 0)
+            return false;
+
+        _hash->update(&_buffer[0], (uint64_t)length);
+        _bytesRead += (uint64_t)length;
+        offset += (uint64_t)length;
+        left -= (uint64_t)length;
+    }
+
+    _hash->finalize();
+
+    return true;
+}
+
+/** Hash each of a list of byte ranges of the open file.
+ *
+ *  @pre open() succeeded.
+ *  @post digests holds one digest for each range that was hashed.
+ *  @param ranges The ranges.
+ *  @param digests Receives the digests, in the order of ranges.
+ *  @return true Every range was hashed.
+ *  @return false A range runs past the end of the file or could not
+ *          be read; the ranges before it were hashed.
+*/
+bool RangeHasher::hash (const vector < Range > &ranges,
+                        vector < vector < byte_t > > &digests)
+{
+    digests.clear();
+    digests.reserve(ranges.size());
+
+    for (size_t i = 0; i < ranges.size(); ++i)
+    {
+        if (!hash(ranges[i]))
+            return false;
+
+        digests.push_back(_hash->asBytes());
+    }
+
+    return true;
+}
+
+/** Retrieve the hash object, which holds the digest of the last
+ *  range that was hashed.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return The hash object.
+*/
+const MessageHash & RangeHasher::digest (void) const
+{
+    return *_hash;
+}
+
+/******************************************************
+**                  Static Methods                   **
+******************************************************/
+
+/** Parse a list of ranges, OFFSET:LENGTH[,OFFSET:LENGTH]...  The
+ *  numbers are decimal, or hexadecimal with a 0x prefix, and may end
+ *  in K, M or G (binary multiples).
+ *
+ *  @pre none.
+ *  @post The ranges are appended to ranges.
+ *  @param text The list.
+ *  @param ranges Receives the ranges.
+ *  @return true The list was parsed.
+ *  @return false The list is malformed (ranges is unchanged).
+*/
+bool RangeHasher::parse (const string &text, vector < Range > &ranges)
+{
+    vector < Range > parsed;
+    const char *at = text.c_str();
+
+    for (;;)
+    {
+        Range range;
+
+        if (!_parseNumber(at, range.offset) || (*at++ != ':')
+            || !_parseNumber(at, range.length)
+            || (range.offset + range.length < range.offset))
+            return false;
+
+        parsed.push_back(range);
+
+        if (*at == '\0')
+            break;
+
+        if (*at++ != ',')
+            return false;
+    }
+
+    ranges.insert(ranges.end(), parsed.begin(), parsed.end());
+
+    return true;
+}
+
+/******************************************************
+**                   Helper Methods                  **
+******************************************************/
+
+/** Parse a number with an optional K, M or G suffix.
+ *
+ *  @param text The text, which is advanced past the number.
+ *  @param value Receives the number.
+ *  @return true A number was parsed.
+ *  @return false There is no number, or it overflows.
+*/
+bool RangeHasher::_parseNumber (const char *&text, uint64_t &value)
+{
+    // strtoull() would accept a sign (and wrap a negative number).
+    if ((*text < '0') || (*text > '9'))
+        return false;
+
+    // Hexadecimal only after 0x: base 0 would read a leading 0 as octal.
+    int base = ((text[0] == '0') && ((text[1] == 'x') || (text[1] == 'X')))
+               ? 16 : 10;
+
+    char *end = NULL;
+    errno = 0;
+    value = strtoull(text, &end, base);
+
+    if ((end == text) || (errno == ERANGE))
+        return false;
+
+    uint32_t shift = 0;
+    switch (*end)
+    {
+        case 'K':  shift = 10;  ++end;  break;
+        case 'M':  shift = 20;  ++end;  break;
+        case 'G':  shift = 30;  ++end;  break;
+        default:   break;
+    }
+
+    if ((shift > 0) && (value > (0xFFFFFFFFFFFFFFFFULL >> shift)))
+        return false;
+
+    value <<= shift;
+    text = end;
+
+    return true;
+}
@@ -0,0 +1,224 @@
+/******************************************************************************
+||  range_hasher.h                                                           ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    Hashes byte ranges of a file ([offset, offset + length)) with          ||
+||    positioned reads (pread), so that a segment of a large container file  ||
+||    or a database page can be verified without reading the rest of the     ||
+||    file.  Each range of a list gets its own digest, and the ranges are    ||
+||    read in the order given, without moving a shared file position.        ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    Hashes/hash_abstract.cpp (hash_abstract.lib)                           ||
+||    Hashes/hash_abstract.h                                                 ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file range_hasher.h
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+
+#ifndef _GH_RANGE_HASHER_DEF_H
+#define _GH_RANGE_HASHER_DEF_H
+
+#include "Hashes/hash_abstract.h"
+
+/**
+ *  @class RangeHasher Hashes byte ranges of a file.
+*/
+class RangeHasher
+{
+  public:
+    /******************************************************
+    **                     Constants                     **
+    ******************************************************/
+
+    /// The most bytes read per call to pread().
+    static const uint32_t READ_BUFFER_BYTES = 1048576;
+
+    /**
+     *  @struct Range A byte range of a file.
+    */
+    struct Range
+    {
+        uint64_t offset;            // The first byte.
+        uint64_t length;            // The number of bytes.
+    };
+
+    /******************************************************
+    **            Constructors / Destructors             **
+    ******************************************************/
+
+    /** Initialize a RangeHasher object.
+     *
+     *  @pre none.
+     *  @post The ranges are hashed with a clone of prototype.
+     *  @param prototype A hash object of the algorithm; it is copied.
+    */
+    RangeHasher (const MessageHash &prototype);
+
+    /** Default destructor.  */
+    ~RangeHasher ();
+
+    /******************************************************
+    **               Accessors / Mutators                **
+    ******************************************************/
+
+    ////////////////////
+    //    Getters
+    ////////////////////
+
+    /** Retrieve the size of the open file.
+     *
+     *  @pre open() succeeded.
+     *  @post none.
+     *  @return The size in bytes.
+    */
+    uint64_t fileSize (void) const;
+
+    /** Retrieve the number of bytes read since open().
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return The bytes read.
+    */
+    uint64_t bytesRead (void) const;
+
+    /******************************************************
+    **                      Methods                      **
+    ******************************************************/
+
+    /** Open a file.
+     *
+     *  @pre none.
+     *  @post Any file that was open is closed.
+     *  @param path The file.
+     *  @return true The file was opened.
+     *  @return false It could not be opened (or is not a regular file).
+    */
+    bool open (const string &path);
+
+    /** Close the file (if it is open).
+     *
+     *  @pre none.
+     *  @post No file is open.
+     *  @return none.
+    */
+    void close (void);
+
+    /** Hash a byte range of the open file.
+     *
+     *  @pre open() succeeded.
+     *  @post On success the digest of the range is in digest().
+     *  @param range The range; it must lie within the file.
+     *  @return true The range was hashed.
+     *  @return false The range runs past the end of the file, or it
+     *          could not be read.
+    */
+    bool hash (const Range &range);
+
+    /** Hash each of a list of byte ranges of the open file.
+     *
+     *  @pre open() succeeded.
+     *  @post digests holds one digest for each range that was hashed.
+     *  @param ranges The ranges.
+     *  @param digests Receives the digests, in the order of ranges.
+     *  @return true Every range was hashed.
+     *  @return false A range runs past the end of the file or could not
+     *          be read; the ranges before it were hashed.
+    */
+    bool hash (const vector < Range > &ranges,
+               vector < vector < byte_t > > &digests);
+
+    /** Retrieve the hash object, which holds the digest of the last
+     *  range that was hashed.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return The hash object.
+    */
+    const MessageHash & digest (void) const;
+
+    /******************************************************
+    **                  Static Methods                   **
+    ******************************************************/
+
+    /** Parse a list of ranges, OFFSET:LENGTH[,OFFSET:LENGTH]...  The
+     *  numbers are decimal, or hexadecimal with a 0x prefix, and may end
+     *  in K, M or G (binary multiples).
+     *
+     *  @pre none.
+     *  @post The ranges are appended to ranges.
+     *  @param text The list.
+     *  @param ranges Receives the ranges.
+     *  @return true The list was parsed.
+     *  @return false The list is malformed (ranges is unchanged).
+    */
+    static bool parse (const string &text, vector < Range > &ranges);
+
+  private:
+    /******************************************************
+    **                      Members                      **
+    ******************************************************/
+
+    MessageHash *_hash;             // The hash of the ranges.
+    int _fd;                        // The open file.
+    uint64_t _fileSize;             // The size of the open file.
+    uint64_t _bytesRead;            // The bytes read since open().
+    vector < byte_t > _buffer;      // The read buffer.
+
+    /******************************************************
+    **                   Helper Methods                  **
+    ******************************************************/
+
+    /** Parse a number with an optional K, M or G suffix.
+     *
+     *  @param text The text, which is advanced past the number.
+     *  @param value Receives the number.
+     *  @return true A number was parsed.
+     *  @return false There is no number, or it overflows.
+    */
+    static bool _parseNumber (const char *&text, uint64_t &value);
+
+    // Not copyable (owns _hash and _fd).
+    RangeHasher (const RangeHasher &);
+    RangeHasher & operator = (const RangeHasher &);
+
+};  // End class RangeHasher.
+
+#endif
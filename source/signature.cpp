@@ -0,0 +1,489 @@
+/******************************************************************************
+||  signature.cpp                                                            ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    The signature of a file for the rsync algorithm: the file is cut into  ||
+||    fixed-size blocks, and each block is described by its Adler-32 sum     ||
+||    (the weak checksum, which can be rolled) and a strong digest.  Whoever ||
+||    holds a newer version of the file can then describe it as a delta      ||
+||    against the signature without having the old version.                  ||
+||                                                                           ||
+||    The blocks are indexed by their weak sums, so that a delta scan looks  ||
+||    up each rolled sum in a hash table and only computes a strong digest   ||
+||    when the weak sum of some block matches.                               ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    signature.h                                                            ||
+||    checkpoint.cpp (checkpoint.lib)                                        ||
+||    checkpoint.h                                                           ||
+||    Hashes/adler32.cpp (adler32.lib)                                       ||
+||    Hashes/adler32.h                                                       ||
+||    Hashes/hash_abstract.cpp (hash_abstract.lib)                           ||
+||    Hashes/hash_abstract.h                                                 ||
+||    Hashes/hash_state.cpp (hash_state.lib)                                 ||
+||    Hashes/hash_state.h                                                    ||
+||                                                                           ||
+||===========================================================================||
+||  REFERENCES                                                               ||
+||===========================================================================||
+||    Tridgell, A. and Mackerras, P.  "The rsync algorithm", Technical       ||
+||        Report TR-CS-96-05, Australian National University, 1996.          ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file signature.cpp
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+
+#include <math.h>
+#include <string.h>
+
+#include "signature.h"
+#include "checkpoint.h"
+#include "Hashes/adler32.h"
+#include "Hashes/hash_state.h"
+
+// The first bytes of every signature file.
+static const char SIGNATURE_MAGIC[] = "GHSG";
+
+// The size of the blocks that files are signed in.
+static const uint32_t SIGN_BUFFER_BYTES = 16777216;
+
+const uint32_t Signature::VERSION;
+const uint32_t Signature::MIN_BLOCK_BYTES;
+const uint32_t Signature::MAX_BLOCK_BYTES;
+const uint32_t Signature::DEFAULT_MIN_BLOCK_BYTES;
+const uint64_t Signature::NO_BLOCK;
+
+/******************************************************
+**            Constructors / Destructors             **
+******************************************************/
+
+/** Default constructor (an empty signature).  */
+Signature::Signature ()
+    : _blockBytes(0),
+      _fileSize(0),
+      _strongBytes(0),
+      _bucketShift(32)
+{}
+
+/** Default destructor.  */
+Signature::~Signature ()  { }
+
+/******************************************************
+**               Accessors / Mutators                **
+******************************************************/
+
+////////////////////
+//    Getters
+////////////////////
+
+/** Retrieve the block size.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return The bytes per block.
+*/
+uint32_t Signature::blockBytes (void) const
+{
+    return _blockBytes;
+}
+
+/** Retrieve the size of the file that was signed.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return The size in bytes.
+*/
+uint64_t Signature::fileSize (void) const
+{
+    return _fileSize;
+}
+
+/** Retrieve the number of blocks, including a final partial block
+ *  (which only a delta that ends with the same bytes can match).
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return The number of blocks.
+*/
+uint64_t Signature::blockCount (void) const
+{
+    return _weak.size();
+}
+
+/** Retrieve the number of whole blocks: those that are indexed by
+ *  find().
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return The number of blocks of blockBytes() bytes.
+*/
+uint64_t Signature::wholeBlocks (void) const
+{
+    return (_blockBytes == 0) ? 0 : _fileSize / _blockBytes;
+}
+
+/** Retrieve the length of a block.
+ *
+ *  @pre block < blockCount().
+ *  @post none.
+ *  @param block The index of the block.
+ *  @return blockBytes(), or fewer for the final partial block.
+*/
+uint32_t Signature::blockLength (uint64_t block) const
+{
+    uint64_t left = _fileSize - block * _blockBytes;
+
+    return (left < _blockBytes) ? (uint32_t)left : _blockBytes;
+}
+
+/** Retrieve the name of the strong digest algorithm.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return The algorithmName() of the strong digests.
+*/
+const string & Signature::algorithm (void) const
+{
+    return _algorithm;
+}
+
+/** Retrieve the length of the strong digests.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return The bytes per strong digest.
+*/
+uint32_t Signature::strongBytes (void) const
+{
+    return _strongBytes;
+}
+
+/** Retrieve the weak checksum of a block.
+ *
+ *  @pre block < blockCount().
+ *  @post none.
+ *  @param block The index of the block.
+ *  @return The Adler-32 sum of the block.
+*/
+uint32_t Signature::weak (uint64_t block) const
+{
+    return _weak[block];
+}
+
+/** Retrieve the strong digest of a block.
+ *
+ *  @pre block < blockCount().
+ *  @post none.
+ *  @param block The index of the block.
+ *  @return A pointer to strongBytes() bytes.
+*/
+const byte_t * Signature::strong (uint64_t block) const
+{
+    return &_strong[block * _strongBytes];
+}
+
+/** Find the (next) whole block with a weak checksum.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @param weak The weak checksum.
+ *  @param after NO_BLOCK to find the first block, or a block that
+ *         was returned to find the next one.
+ *  @return The index of the block, or NO_BLOCK.
+*/
+uint64_t Signature::find (uint32_t weak, uint64_t after) const
+{
+    if (_heads.empty())
+        return NO_BLOCK;
+
+    uint64_t block = (after == NO_BLOCK) ? _heads[_bucket(weak)]
+                                         : _next[after];
+
+    while ((block != NO_BLOCK) && (_weak[block] != weak))
+        block = _next[block];
+
+    return block;
+}
+
+/******************************************************
+**                      Methods                      **
+******************************************************/
+
+/** Sign a file.
+ *
+ *  @pre file is open in binary mode at the start of the file.
+ *  @post The signature describes the file.
+ *  @param file The file.
+ *  @param prototype A hash object of the strong digest algorithm.
+ *  @param blockBytes The block size; zero selects
+ *         defaultBlockBytes() for the size of the file.
+ *  @return true The file was signed.
+ *  @return false The file could not be read (or the block size is
+ *          out of range).
+*/
+bool Signature::compute (ifstream &file, const MessageHash &prototype,
+                         uint32_t blockBytes)
+{
+    file.seekg(0, ios::end);
+    uint64_t size = (uint64_t)file.tellg();
+    file.seekg(0, ios::beg);
+
+    if (file.fail())
+        return false;
+
+    if (blockBytes == 0)
+        blockBytes = defaultBlockBytes(size);
+
+    if ((blockBytes < MIN_BLOCK_BYTES) || (blockBytes > MAX_BLOCK_BYTES))
+        return false;
+
+    MessageHash *strong = prototype.clone();
+    Adler32 adler;
+
+    _blockBytes = blockBytes;
+    _fileSize = 0;
+    _algorithm = strong->algorithmName();
+    _strongBytes = (uint32_t)strong->asBytes().size();
+    _weak.clear();
+    _strong.clear();
+    _weak.reserve((size + blockBytes - 1) / blockBytes);
+    _strong.reserve(((size + blockBytes - 1) / blockBytes) * _strongBytes);
+
+    // Read whole blocks at a time, so that only the last read can end
+    // with a partial block.  That block is signed too (as rsync does), so
+    // an unchanged tail is copied rather than sent.
+    vector < byte_t > buffer((SIGN_BUFFER_BYTES / blockBytes) * blockBytes);
+
+    while (file.good())
+    {
+        file.read((char *)&buffer[0], buffer.size());
+        size_t length = (size_t)file.gcount();
+        _fileSize += length;
+
+        for (size_t at = 0; at < length; at += blockBytes)
+        {
+            size_t part = (length - at < blockBytes) ? length - at
+                                                     : blockBytes;
+
+            adler.reset();
+            adler.update(&buffer[at], part);
+            _weak.push_back(adler.checksum());
+
+            strong->reset();
+            strong->update(&buffer[at], part);
+            strong->finalize();
+
+            vector < byte_t > digest = strong->asBytes();
+            _strong.insert(_strong.end(), digest.begin(), digest.end());
+        }
+    }
+
+    bool read = file.eof();
+    delete strong;
+
+    file.clear();
+    file.seekg(0);
+
+    _index();
+
+    return read;
+}
+
+/** Write the signature to a file.
+ *
+ *  @pre none.
+ *  @post The file is replaced atomically.
+ *  @param path The signature file.
+ *  @return true The file was written.
+ *  @return false The file could not be written.
+*/
+bool Signature::save (const string &path) const
+{
+    HashState state;
+
+    state.putBytes((const byte_t *)SIGNATURE_MAGIC, 4);
+    state.putWord32(VERSION);
+    state.putWord32(_blockBytes);
+    state.putWord64(_fileSize);
+    state.putString(_algorithm);
+    state.putWord32(_strongBytes);
+    state.putWord64(_weak.size());
+
+    for (uint64_t block = 0; block < _weak.size(); ++block)
+    {
+        state.putWord32(_weak[block]);
+        state.putBytes(strong(block), _strongBytes);
+    }
+
+    return Checkpoint::replaceFile(path, state.bytes());
+}
+
+/** Read a signature file.
+ *
+ *  @pre none.
+ *  @post The signature holds the file's blocks.
+ *  @param path The signature file.
+ *  @return true The file was read.
+ *  @return false The file could not be read or is not a valid
+ *          signature.
+*/
+bool Signature::load (const string &path)
+{
+    vector < byte_t > bytes;
+    if (!Checkpoint::readFile(path, bytes))
+        return false;
+
+    HashState state(bytes);
+    byte_t magic[4];
+
+    state.getBytes(magic, 4);
+    uint32_t version = state.getWord32();
+    uint32_t blockBytes = state.getWord32();
+    uint64_t fileSize = state.getWord64();
+    string algorithm = state.getString();
+    uint32_t strongBytes = state.getWord32();
+    uint64_t count = state.getWord64();
+
+    if (!state.good() || (memcmp(magic, SIGNATURE_MAGIC, 4) != 0)
+        || (version != VERSION) || (blockBytes < MIN_BLOCK_BYTES)
+        || (blockBytes > MAX_BLOCK_BYTES) || (strongBytes == 0)
+        || (count != (fileSize + blockBytes - 1) / blockBytes)
+        || (count > bytes.size() / (4 + (uint64_t)strongBytes)))
+        return false;
+
+    _blockBytes = blockBytes;
+    _fileSize = fileSize;
+    _algorithm = algorithm;
+    _strongBytes = strongBytes;
+    _weak.resize(count);
+    _strong.resize(count * strongBytes);
+
+    for (uint64_t block = 0; block < count; ++block)
+    {
+        _weak[block] = state.getWord32();
+        state.getBytes(&_strong[block * strongBytes], strongBytes);
+    }
+
+    if (!state.good() || !state.atEnd())
+    {
+        _weak.clear();
+        _strong.clear();
+        _heads.clear();
+
+        return false;
+    }
+
+    _index();
+
+    return true;
+}
+
+/******************************************************
+**                  Static Methods                   **
+******************************************************/
+
+/** Choose the block size for a file, as rsync does: about the square
+ *  root of the file size, which balances the size of the signature
+ *  against that of the literal data in a delta.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @param fileSize The size of the file.
+ *  @return A multiple of 8 from DEFAULT_MIN_BLOCK_BYTES to
+ *          MAX_BLOCK_BYTES.
+*/
+uint32_t Signature::defaultBlockBytes (uint64_t fileSize)
+{
+    uint64_t root = (uint64_t)sqrt((double)fileSize) & ~7ULL;
+
+    if (root < DEFAULT_MIN_BLOCK_BYTES)
+        return DEFAULT_MIN_BLOCK_BYTES;
+
+    if (root > MAX_BLOCK_BYTES)
+        return MAX_BLOCK_BYTES;
+
+    return (uint32_t)root;
+}
+
+/******************************************************
+**                   Helper Methods                  **
+******************************************************/
+
+/** Build the weak checksum index.
+ *
+ *  @pre The blocks are loaded.
+ *  @post find() can be called.
+ *  @return none.
+*/
+void Signature::_index (void)
+{
+    // About two buckets per block, so that most chains are empty.
+    uint32_t bits = 4;
+    while ((bits < 32) && ((1ULL << bits) < 2 * _weak.size()))
+        ++bits;
+
+    _bucketShift = 32 - bits;
+    _heads.assign(1ULL << bits, NO_BLOCK);
+    _next.assign(_weak.size(), NO_BLOCK);
+
+    // Insert in reverse so that each chain runs in file order.  A final
+    // partial block is left out: its sum is not that of a full window.
+    for (uint64_t block = wholeBlocks(); block-- > 0; )
+    {
+        uint64_t bucket = _bucket(_weak[block]);
+
+        _next[block] = _heads[bucket];
+        _heads[bucket] = block;
+    }
+
+    return;
+}
+
+/** Map a weak checksum to its bucket.
+ *
+ *  @param weak The weak checksum.
+ *  @return The bucket.
+*/
+uint64_t Signature::_bucket (uint32_t weak) const
+{
+    // The low half (A) of an Adler-32 sum of a short block spans a
+    // narrow range, so the bits are mixed before the top ones are taken.
+    return (uint64_t)((weak * 0x9E3779B1U) >> _bucketShift);
+}
@@ -0,0 +1,301 @@
+/******************************************************************************
+||  signature.h                                                              ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    The signature of a file for the rsync algorithm: the file is cut into  ||
+||    fixed-size blocks, and each block is described by its Adler-32 sum     ||
+||    (the weak checksum, which can be rolled) and a strong digest.  Whoever ||
+||    holds a newer version of the file can then describe it as a delta      ||
+||    against the signature without having the old version.                  ||
+||                                                                           ||
+||    The blocks are indexed by their weak sums, so that a delta scan looks  ||
+||    up each rolled sum in a hash table and only computes a strong digest   ||
+||    when the weak sum of some block matches.                               ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    checkpoint.cpp (checkpoint.lib)                                        ||
+||    checkpoint.h                                                           ||
+||    Hashes/adler32.cpp (adler32.lib)                                       ||
+||    Hashes/adler32.h                                                       ||
+||    Hashes/hash_abstract.cpp (hash_abstract.lib)                           ||
+||    Hashes/hash_abstract.h                                                 ||
+||    Hashes/hash_state.cpp (hash_state.lib)                                 ||
+||    Hashes/hash_state.h                                                    ||
+||                                                                           ||
+||===========================================================================||
+||  REFERENCES                                                               ||
+||===========================================================================||
+||    Tridgell, A. and Mackerras, P.  "The rsync algorithm", Technical       ||
+||        Report TR-CS-96-05, Australian National University, 1996.          ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file signature.h
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+
+#ifndef _GH_SIGNATURE_DEF_H
+#define _GH_SIGNATURE_DEF_H
+
+#include "Hashes/hash_abstract.h"
+
+/**
+ *  @class Signature The block checksums of a file (rsync).
+*/
+class Signature
+{
+  public:
+    /******************************************************
+    **                     Constants                     **
+    ******************************************************/
+
+    /// The layout version of the signature file.
+    static const uint32_t VERSION = 1;
+
+    /// The range of block sizes.
+    static const uint32_t MIN_BLOCK_BYTES = 64;
+    static const uint32_t MAX_BLOCK_BYTES = 131072;
+
+    /// The smallest block that defaultBlockBytes() selects.
+    static const uint32_t DEFAULT_MIN_BLOCK_BYTES = 2048;
+
+    /// The block index that find() returns when there is no match.
+    static const uint64_t NO_BLOCK = 0xFFFFFFFFFFFFFFFFULL;
+
+    /******************************************************
+    **            Constructors / Destructors             **
+    ******************************************************/
+
+    /** Default constructor (an empty signature).  */
+    Signature ();
+
+    /** Default destructor.  */
+    ~Signature ();
+
+    /******************************************************
+    **               Accessors / Mutators                **
+    ******************************************************/
+
+    ////////////////////
+    //    Getters
+    ////////////////////
+
+    /** Retrieve the block size.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return The bytes per block.
+    */
+    uint32_t blockBytes (void) const;
+
+    /** Retrieve the size of the file that was signed.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return The size in bytes.
+    */
+    uint64_t fileSize (void) const;
+
+    /** Retrieve the number of blocks, including a final partial block
+     *  (which only a delta that ends with the same bytes can match).
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return The number of blocks.
+    */
+    uint64_t blockCount (void) const;
+
+    /** Retrieve the number of whole blocks: those that are indexed by
+     *  find().
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return The number of blocks of blockBytes() bytes.
+    */
+    uint64_t wholeBlocks (void) const;
+
+    /** Retrieve the length of a block.
+     *
+     *  @pre block < blockCount().
+     *  @post none.
+     *  @param block The index of the block.
+     *  @return blockBytes(), or fewer for the final partial block.
+    */
+    uint32_t blockLength (uint64_t block) const;
+
+    /** Retrieve the name of the strong digest algorithm.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return The algorithmName() of the strong digests.
+    */
+    const string & algorithm (void) const;
+
+    /** Retrieve the length of the strong digests.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return The bytes per strong digest.
+    */
+    uint32_t strongBytes (void) const;
+
+    /** Retrieve the weak checksum of a block.
+     *
+     *  @pre block < blockCount().
+     *  @post none.
+     *  @param block The index of the block.
+     *  @return The Adler-32 sum of the block.
+    */
+    uint32_t weak (uint64_t block) const;
+
+    /** Retrieve the strong digest of a block.
+     *
+     *  @pre block < blockCount().
+     *  @post none.
+     *  @param block The index of the block.
+     *  @return A pointer to strongBytes() bytes.
+    */
+    const byte_t * strong (uint64_t block) const;
+
+    /** Find the (next) whole block with a weak checksum.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @param weak The weak checksum.
+     *  @param after NO_BLOCK to find the first block, or a block that
+     *         was returned to find the next one.
+     *  @return The index of the block, or NO_BLOCK.
+    */
+    uint64_t find (uint32_t weak, uint64_t after = NO_BLOCK) const;
+
+    /******************************************************
+    **                      Methods                      **
+    ******************************************************/
+
+    /** Sign a file.
+     *
+     *  @pre file is open in binary mode at the start of the file.
+     *  @post The signature describes the file.
+     *  @param file The file.
+     *  @param prototype A hash object of the strong digest algorithm.
+     *  @param blockBytes The block size; zero selects
+     *         defaultBlockBytes() for the size of the file.
+     *  @return true The file was signed.
+     *  @return false The file could not be read (or the block size is
+     *          out of range).
+    */
+    bool compute (ifstream &file, const MessageHash &prototype,
+                  uint32_t blockBytes = 0);
+
+    /** Write the signature to a file.
+     *
+     *  @pre none.
+     *  @post The file is replaced atomically.
+     *  @param path The signature file.
+     *  @return true The file was written.
+     *  @return false The file could not be written.
+    */
+    bool save (const string &path) const;
+
+    /** Read a signature file.
+     *
+     *  @pre none.
+     *  @post The signature holds the file's blocks.
+     *  @param path The signature file.
+     *  @return true The file was read.
+     *  @return false The file could not be read or is not a valid
+     *          signature.
+    */
+    bool load (const string &path);
+
+    /******************************************************
+    **                  Static Methods                   **
+    ******************************************************/
+
+    /** Choose the block size for a file, as rsync does: about the square
+     *  root of the file size, which balances the size of the signature
+     *  against that of the literal data in a delta.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @param fileSize The size of the file.
+     *  @return A multiple of 8 from DEFAULT_MIN_BLOCK_BYTES to
+     *          MAX_BLOCK_BYTES.
+    */
+    static uint32_t defaultBlockBytes (uint64_t fileSize);
+
+  private:
+    /******************************************************
+    **                      Members                      **
+    ******************************************************/
+
+    uint32_t _blockBytes;           // The bytes per block.
+    uint64_t _fileSize;             // The size of the signed file.
+    string _algorithm;              // The strong digest algorithm.
+    uint32_t _strongBytes;          // The bytes per strong digest.
+
+    vector < uint32_t > _weak;      // The weak checksum of each block.
+    vector < byte_t > _strong;      // The strong digests, end to end.
+
+    // The blocks chained by weak checksum bucket.
+    vector < uint64_t > _heads;     // The first block of each bucket.
+    vector < uint64_t > _next;      // The next block of the same bucket.
+    uint32_t _bucketShift;          // 32 - log2(buckets).
+
+    /******************************************************
+    **                   Helper Methods                  **
+    ******************************************************/
+
+    /** Build the weak checksum index.
+     *
+     *  @pre The blocks are loaded.
+     *  @post find() can be called.
+     *  @return none.
+    */
+    void _index (void);
+
+    /** Map a weak checksum to its bucket.
+     *
+     *  @param weak The weak checksum.
+     *  @return The bucket.
+    */
+    uint64_t _bucket (uint32_t weak) const;
+
+};  // End class Signature.
+
+#endif
@@ -0,0 +1,418 @@
+/******************************************************************************
+||  stream_hasher.cpp                                                        ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    Hashes a stream (standard input, a pipe, a device) in constant memory, ||
+||    reading it in order to its end without seeking or sizing it, and       ||
+||    optionally passes the data on to another descriptor (standard output or||
+||    a file) as it is hashed, so that a backup stream is checksummed inline ||
+||    with no second read.                                                   ||
+||                                                                           ||
+||    When the input is a pipe the data is passed on without copying it      ||
+||    through user space: tee() duplicates what is in the input pipe into an ||
+||    internal pipe, splice() moves the original on to the output, and only  ||
+||    the duplicate is read to be hashed.  Otherwise (or where the output    ||
+||    refuses splice(), e.g. a file opened for appending) the data is read,  ||
+||    hashed and written.  vmsplice() is not used; the pages it hands over   ||
+||    stay referenced by whatever the reader splices them into, so a reused  ||
+||    buffer could change data already passed on.                            ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    Hashes/hash_abstract.cpp (hash_abstract.lib)                           ||
+||    Hashes/hash_abstract.h                                                 ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file stream_hasher.cpp
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+
+#ifndef _GNU_SOURCE
+  #define _GNU_SOURCE               // tee(), splice(), F_SETPIPE_SZ
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "stream_hasher.h"
+
+const uint32_t StreamHasher::BUFFER_BYTES;
+
+/******************************************************
+**            Constructors / Destructors             **
+******************************************************/
+
+/** Initialize a StreamHasher object.
+ *
+ *  @pre none.
+ *  @post none.
+*/
+StreamHasher::StreamHasher ()
+    : _bytes(0),
+      _spliced(false),
+      _writeFailed(false),
+      _progress(NULL),
+      _device(0),
+      _perf(NULL)
+{}
+
+/******************************************************
+**               Accessors / Mutators                **
+******************************************************/
+
+////////////////////
+//    Getters
+////////////////////
+
+/** Retrieve the number of bytes hashed from the last stream.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return The bytes hashed.
+*/
+uint64_t StreamHasher::bytes (void) const
+{
+    return _bytes;
+}
+
+/** Determine whether the last stream was passed on with splice().
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return true The data was moved to the output without a copy.
+ *  @return false It was written (or there was no output).
+*/
+bool StreamHasher::spliced (void) const
+{
+    return _spliced;
+}
+
+/** Determine whether the last stream failed because the output
+ *  could not be written.
+ *
+ *  @pre hash() returned false.
+ *  @post none.
+ *  @return true Writing the output failed.
+ *  @return false Reading the input failed.
+*/
+bool StreamHasher::writeFailed (void) const
+{
+    return _writeFailed;
+}
+
+////////////////////
+//    Setters
+////////////////////
+
+/** Count the bytes of the streams hashed from now on.
+ *
+ *  @pre device was returned by progress->device().
+ *  @post Each buffer that is hashed is added to the counter of device.
+ *  @param progress The counters (or NULL for none).
+ *  @param device The counter of the device of the next stream.
+ *  @return none.
+*/
+void StreamHasher::setProgress (ProgressMonitor *progress, uint32_t device)
+{
+    _progress = progress;
+    _device = device;
+
+    return;
+}
+
+/** Count the events of the updates of the hash.
+ *
+ *  @pre perf has been opened on the thread that calls hash().
+ *  @post Each update is counted.
+ *  @param perf The counters (or NULL for none).
+ *  @return none.
+*/
+void StreamHasher::setPerf (PerfCounters *perf)
+{
+    _perf = perf;
+
+    return;
+}
+
+/******************************************************
+**                      Methods                      **
+******************************************************/
+
+/** Hash a stream to its end, passing it on to out as it is read.
+ *
+ *  @pre in is open for reading, and out (if any) for writing.
+ *  @post On success hash holds the (finalized) digest of the stream,
+ *        and out has been sent all of it.
+ *  @param in The stream.
+ *  @param hash The hash; it is reset first.
+ *  @param out The descriptor to pass the data on to, or -1.
+ *  @return true The stream was hashed (and passed on).
+ *  @return false It could not be read, or out could not be written.
+*/
+bool StreamHasher::hash (int in, MessageHash &hash, int out)
+{
+    _bytes = 0;
+    _spliced = false;
+    _writeFailed = false;
+
+    if (_buffer.empty())
+        _buffer.resize(BUFFER_BYTES);
+
+    hash.reset();
+
+    struct stat status;
+    bool pipe = (fstat(in, &status) == 0) && S_ISFIFO(status.st_mode);
+
+    // A larger pipe lets the writer run further ahead of us (and costs
+    // fewer wake-ups); it is only a request.
+    if (pipe)
+        fcntl(in, F_SETPIPE_SZ, (int)BUFFER_BYTES);
+    else if (S_ISREG(status.st_mode))
+        posix_fadvise(in, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    if (pipe && (out >= 0))
+    {
+        Outcome outcome = _teeSplice(in, hash, out);
+
+        if (outcome != UNSUPPORTED)
+        {
+            if (outcome == FAILED)
+                return false;
+
+            hash.finalize();
+            return true;
+        }
+    }
+
+    if (!_copy(in, hash, out))
+        return false;
+
+    hash.finalize();
+
+    return true;
+}
+
+/******************************************************
+**                   Helper Methods                  **
+******************************************************/
+
+/** Pass a pipe on with tee() and splice(), hashing the duplicate.
+ *
+ *  @param in The input pipe.
+ *  @param hash The (reset) hash.
+ *  @param out The output.
+ *  @return The outcome.
+*/
+StreamHasher::Outcome StreamHasher::_teeSplice (int in, MessageHash &hash,
+                                                int out)
+{
+    int copy[2];
+    if (pipe2(copy, O_CLOEXEC) != 0)
+        return UNSUPPORTED;
+
+    fcntl(copy[1], F_SETPIPE_SZ, (int)BUFFER_BYTES);
+
+    Outcome outcome = DONE;
+
+    for (;;)
+    {
+        // Duplicate what is in the input pipe (without consuming it).
+        ssize_t teed = tee(in, copy[1], BUFFER_BYTES, 0);
+
+        if ((teed < 0) && (errno == EINTR))
+            continue;
+
+        if (teed < 0)
+        {
+            outcome = ((errno == EINVAL) && (_bytes == 0)) ? UNSUPPORTED
+                                                           : FAILED;
+            break;
+        }
+
+        // No data and no writer: the end of the stream.
+        if (teed == 0)
+            break;
+
+        // Move the same bytes on to the output.
+        ssize_t moved = 0;
+        while (moved < teed)
+        {
+            ssize_t length = splice(in, NULL, out, NULL,
+                                    (size_t)(teed - moved), SPLICE_F_MOVE);
+
+            if ((length < 0) && (errno == EINTR))
+                continue;
+
+            if (length <= 0)
+                break;
+
+            moved += length;
+        }
+
+        if (moved < teed)
+        {
+            // An output that refuses splice() (e.g. a file opened for
+            // appending) refuses it at once, before anything is moved;
+            // the input still holds the data.
+            if ((moved == 0) && (_bytes == 0) && (errno == EINVAL))
+                outcome = UNSUPPORTED;
+            else
+            {
+                outcome = FAILED;
+                _writeFailed = true;
+            }
+
+            break;
+        }
+
+        // Hash the duplicate.
+        ssize_t left = teed;
+        while (left > 0)
+        {
+            ssize_t length = read(copy[0], &_buffer[0],
+                                  ((size_t)left < _buffer.size())
+                                  ? (size_t)left : _buffer.size());
+
+            if ((length < 0) && (errno == EINTR))
+                continue;
+
+            if (length <= 0)
+                break;
+
+            if (_perf != NULL)
+                _perf->start();
+
+            hash.update(&_buffer[0], (uint64_t)length);
+
+            if (_perf != NULL)
+                _perf->stop((uint64_t)length);
+
+            _bytes += (uint64_t)length;
+            left -= length;
+
+            if (_progress != NULL)
+                _progress->add(_device, (uint64_t)length);
+        }
+
+        if (left > 0)
+        {
+            outcome = FAILED;
+            break;
+        }
+
+        _spliced = true;
+    }
+
+    close(copy[0]);
+    close(copy[1]);
+
+    return outcome;
+}
+
+/** Read, hash and (if out >= 0) write the stream.
+ *
+ *  @param in The input.
+ *  @param hash The hash.
+ *  @param out The output, or -1.
+ *  @return true The stream was hashed (and passed on).
+ *  @return false A read or write failed.
+*/
+bool StreamHasher::_copy (int in, MessageHash &hash, int out)
+{
+    for (;;)
+    {
+        ssize_t length = read(in, &_buffer[0], _buffer.size());
+
+        if ((length < 0) && (errno == EINTR))
+            continue;
+
+        if (length == 0)
+            return true;
+
+        if (length < 0)
+            return false;
+
+        if (_perf != NULL)
+            _perf->start();
+
+        hash.update(&_buffer[0], (uint64_t)length);
+
+        if (_perf != NULL)
+            _perf->stop((uint64_t)length);
+
+        _bytes += (uint64_t)length;
+
+        if (_progress != NULL)
+            _progress->add(_device, (uint64_t)length);
+
+        if ((out >= 0) && !_writeAll(out, &_buffer[0], (size_t)length))
+        {
+            _writeFailed = true;
+            return false;
+        }
+    }
+}
+
+/** Write all of a buffer.
+ *
+ *  @param out The output.
+ *  @param data The data.
+ *  @param length The number of bytes.
+ *  @return true Everything was written.
+ *  @return false The output failed.
+*/
+bool StreamHasher::_writeAll (int out, const byte_t *data, size_t length)
+{
+    while (length > 0)
+    {
+        ssize_t written = write(out, data, length);
+
+        if ((written < 0) && (errno == EINTR))
+            continue;
+
+        if (written <= 0)
+            return false;
+
+        data += written;
+        length -= (size_t)written;
+    }
+
+    return true;
+}
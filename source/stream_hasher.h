@@ -0,0 +1,229 @@
+/******************************************************************************
+||  stream_hasher.h                                                          ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    Hashes a stream (standard input, a pipe, a device) in constant memory, ||
+||    reading it in order to its end without seeking or sizing it, and       ||
+||    optionally passes the data on to another descriptor (standard output or||
+||    a file) as it is hashed, so that a backup stream is checksummed inline ||
+||    with no second read.                                                   ||
+||                                                                           ||
+||    When the input is a pipe the data is passed on without copying it      ||
+||    through user space: tee() duplicates what is in the input pipe into an ||
+||    internal pipe, splice() moves the original on to the output, and only  ||
+||    the duplicate is read to be hashed.  Otherwise (or where the output    ||
+||    refuses splice(), e.g. a file opened for appending) the data is read,  ||
+||    hashed and written.  vmsplice() is not used; the pages it hands over   ||
+||    stay referenced by whatever the reader splices them into, so a reused  ||
+||    buffer could change data already passed on.                            ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    Hashes/hash_abstract.cpp (hash_abstract.lib)                           ||
+||    Hashes/hash_abstract.h                                                 ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file stream_hasher.h
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+
+#ifndef _GH_STREAM_HASHER_DEF_H
+#define _GH_STREAM_HASHER_DEF_H
+
+#include "Hashes/hash_abstract.h"
+#include "progress_monitor.h"
+#include "perf_counters.h"
+
+/**
+ *  @class StreamHasher Hashes a stream (and passes it on).
+*/
+class StreamHasher
+{
+  public:
+    /******************************************************
+    **                     Constants                     **
+    ******************************************************/
+
+    /// The size of each read (and the size requested for the pipes).
+    static const uint32_t BUFFER_BYTES = 1048576;
+
+    /******************************************************
+    **            Constructors / Destructors             **
+    ******************************************************/
+
+    /** Initialize a StreamHasher object.
+     *
+     *  @pre none.
+     *  @post none.
+    */
+    StreamHasher ();
+
+    /******************************************************
+    **               Accessors / Mutators                **
+    ******************************************************/
+
+    ////////////////////
+    //    Getters
+    ////////////////////
+
+    /** Retrieve the number of bytes hashed from the last stream.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return The bytes hashed.
+    */
+    uint64_t bytes (void) const;
+
+    /** Determine whether the last stream was passed on with splice().
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return true The data was moved to the output without a copy.
+     *  @return false It was written (or there was no output).
+    */
+    bool spliced (void) const;
+
+    /** Determine whether the last stream failed because the output
+     *  could not be written.
+     *
+     *  @pre hash() returned false.
+     *  @post none.
+     *  @return true Writing the output failed.
+     *  @return false Reading the input failed.
+    */
+    bool writeFailed (void) const;
+
+    ////////////////////
+    //    Setters
+    ////////////////////
+
+    /** Count the bytes of the streams hashed from now on.
+     *
+     *  @pre device was returned by progress->device().
+     *  @post Each buffer that is hashed is added to the counter of device.
+     *  @param progress The counters (or NULL for none).
+     *  @param device The counter of the device of the next stream.
+     *  @return none.
+    */
+    void setProgress (ProgressMonitor *progress, uint32_t device);
+
+    /** Count the events of the updates of the hash.
+     *
+     *  @pre perf has been opened on the thread that calls hash().
+     *  @post Each update is counted.
+     *  @param perf The counters (or NULL for none).
+     *  @return none.
+    */
+    void setPerf (PerfCounters *perf);
+
+    /******************************************************
+    **                      Methods                      **
+    ******************************************************/
+
+    /** Hash a stream to its end, passing it on to out as it is read.
+     *
+     *  @pre in is open for reading, and out (if any) for writing.
+     *  @post On success hash holds the (finalized) digest of the stream,
+     *        and out has been sent all of it.
+     *  @param in The stream.
+     *  @param hash The hash; it is reset first.
+     *  @param out The descriptor to pass the data on to, or -1.
+     *  @return true The stream was hashed (and passed on).
+     *  @return false It could not be read, or out could not be written.
+    */
+    bool hash (int in, MessageHash &hash, int out = -1);
+
+  private:
+    /******************************************************
+    **                      Members                      **
+    ******************************************************/
+
+    vector < byte_t > _buffer;      // The read buffer.
+    uint64_t _bytes;                // The bytes hashed.
+    bool _spliced;                  // The output was spliced.
+    bool _writeFailed;              // The output could not be written.
+    ProgressMonitor *_progress;     // The progress counters (or NULL).
+    uint32_t _device;               // The counter of the stream.
+    PerfCounters *_perf;            // The event counters (or NULL).
+
+    /******************************************************
+    **                   Helper Methods                  **
+    ******************************************************/
+
+    /**
+     *  @enum Outcome The outcome of _teeSplice().
+    */
+    enum Outcome
+    {
+        DONE,                       // The stream was hashed and passed on.
+        FAILED,                     // A read or write failed.
+        UNSUPPORTED                 // Nothing was moved; copy instead.
+    };
+
+    /** Pass a pipe on with tee() and splice(), hashing the duplicate.
+     *
+     *  @param in The input pipe.
+     *  @param hash The (reset) hash.
+     *  @param out The output.
+     *  @return The outcome.
+    */
+    Outcome _teeSplice (int in, MessageHash &hash, int out);
+
+    /** Read, hash and (if out >= 0) write the stream.
+     *
+     *  @param in The input.
+     *  @param hash The hash.
+     *  @param out The output, or -1.
+     *  @return true The stream was hashed (and passed on).
+     *  @return false A read or write failed.
+    */
+    bool _copy (int in, MessageHash &hash, int out);
+
+    /** Write all of a buffer.
+     *
+     *  @param out The output.
+     *  @param data The data.
+     *  @param length The number of bytes.
+     *  @return true Everything was written.
+     *  @return false The output failed.
+    */
+    static bool _writeAll (int out, const byte_t *data, size_t length);
+
+};  // End class StreamHasher.
+
+#endif
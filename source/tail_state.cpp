@@ -0,0 +1,242 @@
+/******************************************************************************
+||  tail_state.cpp                                                           ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    The stored tail midstate of an append-only file (a log or journal).    ||
+||    After a file has been hashed the midstate at its last byte is kept,    ||
+||    together with a digest of the last bytes (the guard).  When the file   ||
+||    has only been appended to since, the next hash resumes from the stored ||
+||    offset and reads only the new bytes.                                   ||
+||                                                                           ||
+||    A file that was replaced (another inode), truncated, rewritten in      ||
+||    place or whose guard no longer matches is hashed again from the start, ||
+||    as it is when the state file fails its checksum (see Checkpoint).      ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    checkpoint.cpp (checkpoint.lib)                                        ||
+||    checkpoint.h                                                           ||
+||    Hashes/sha256.cpp (sha256.lib)                                         ||
+||    Hashes/sha256.h                                                        ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file tail_state.cpp
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+#include <string.h>
+#include <sys/stat.h>
+
+#include "tail_state.h"
+#include "Hashes/hash_state.h"
+#include "Hashes/sha256.h"
+
+// The first bytes of every tail state file.
+static const char TAIL_MAGIC[] = "GHTL";
+
+const uint32_t TailState::VERSION;
+const uint32_t TailState::GUARD_BYTES;
+
+/******************************************************
+**            Constructors / Destructors             **
+******************************************************/
+
+/** Initialize a TailState object.
+ *
+ *  @pre none.
+ *  @post Nothing is read or written until load() or save().
+ *  @param path The file that holds the tail state.
+ *  @param target The file that is being hashed.
+*/
+TailState::TailState (const string &path, const string &target)
+    : Checkpoint(path, target)
+{}
+
+/** Default destructor.  */
+TailState::~TailState ()  { }
+
+/******************************************************
+**               Accessors / Mutators                **
+******************************************************/
+
+////////////////////
+//    Setters
+////////////////////
+
+/** Resume the hash of the target from the stored tail state.
+ *
+ *  @pre file is open on the target.
+ *  @post On success hash holds the midstate of the first offset
+ *        bytes of the target.  The read position of file is
+ *        undefined (the guard has been read).
+ *  @param hash The hash that is to be resumed.
+ *  @param file A handle to the target.
+ *  @param offset Receives the number of bytes already hashed.
+ *  @return true The target has only been appended to since the
+ *          state was stored.
+ *  @return false The target must be hashed from the start; hash is
+ *          then reset.
+*/
+bool TailState::load (MessageHash &hash, ifstream &file, uint64_t &offset)
+{
+    hash.reset();
+    offset = 0;
+
+    vector < byte_t > bytes;
+    struct stat status;
+
+    // A state whose checksum does not match is rejected like a stale one.
+    if (!readFile(_path, bytes) || !_unseal(bytes)
+        || (stat(_target.c_str(), &status) != 0))
+        return false;
+
+    HashState state(bytes);
+    byte_t magic[4];
+    state.getBytes(magic, sizeof(magic));
+
+    bool sameFile = (memcmp(magic, TAIL_MAGIC, sizeof(magic)) == 0)
+                    && (state.getWord32() == VERSION)
+                    && (state.getWord64() == (uint64_t)status.st_dev)
+                    && (state.getWord64() == (uint64_t)status.st_ino);
+
+    uint64_t seconds = state.getWord64();
+    uint64_t nanoseconds = state.getWord64();
+    uint64_t storedAt = state.getWord64();
+    vector < byte_t > guard = state.getBlob();
+    vector < byte_t > midstate = state.getBlob();
+
+    if (!sameFile || !state.good() || !state.atEnd()
+        || (storedAt > (uint64_t)status.st_size))
+        return false;
+
+    // A file of the same length must not have been written since; a
+    // longer one must still hold the bytes that were hashed before
+    // (which the guard checks for the end of that data).
+    if ((storedAt == (uint64_t)status.st_size)
+        && ((seconds != (uint64_t)status.st_mtim.tv_sec)
+            || (nanoseconds != (uint64_t)status.st_mtim.tv_nsec)))
+        return false;
+
+    vector < byte_t > current;
+    if (!_guard(file, storedAt, current) || (current != guard))
+        return false;
+
+    if (!hash.importState(midstate))
+    {
+        hash.reset();
+        return false;
+    }
+
+    offset = storedAt;
+
+    return true;
+}
+
+/** Store the tail state of the target.
+ *
+ *  @pre hash has absorbed exactly the first offset bytes of the
+ *       target (and has not been finalized).
+ *  @post The state file holds the midstate, the offset and the
+ *        guard.  The read position of file is undefined.
+ *  @param hash The hash of the target.
+ *  @param file A handle to the target.
+ *  @param offset The number of bytes that hash has absorbed.
+ *  @return true The state was written.
+ *  @return false The state file could not be written.
+*/
+bool TailState::save (const MessageHash &hash, ifstream &file,
+                      uint64_t offset)
+{
+    vector < byte_t > guard;
+    struct stat status;
+
+    if (!_guard(file, offset, guard) || (stat(_target.c_str(), &status) != 0))
+        return false;
+
+    HashState state;
+    state.putBytes((const byte_t *)TAIL_MAGIC, 4);
+    state.putWord32(VERSION);
+    state.putWord64((uint64_t)status.st_dev);
+    state.putWord64((uint64_t)status.st_ino);
+    state.putWord64((uint64_t)status.st_mtim.tv_sec);
+    state.putWord64((uint64_t)status.st_mtim.tv_nsec);
+    state.putWord64(offset);
+    state.putBlob(guard);
+    state.putBlob(hash.exportState());
+
+    vector < byte_t > bytes = state.bytes();
+    _seal(bytes);
+
+    return replaceFile(_path, bytes);
+}
+
+/******************************************************
+**                   Helper Methods                  **
+******************************************************/
+
+/** Calculate the guard digest of the bytes before an offset.
+ *
+ *  @pre file is open on the target.
+ *  @post The read position of file is undefined.
+ *  @param file A handle to the target.
+ *  @param offset The end of the guarded bytes.
+ *  @param digest Receives the SHA-256 of the (up to GUARD_BYTES)
+ *         bytes before offset.
+ *  @return true The guarded bytes were read.
+ *  @return false The target is shorter than offset.
+*/
+bool TailState::_guard (ifstream &file, uint64_t offset,
+                        vector < byte_t > &digest)
+{
+    uint64_t length = (offset < GUARD_BYTES) ? offset : GUARD_BYTES;
+    vector < byte_t > buffer((size_t)length + 1);
+
+    file.clear();
+    file.seekg((std::streamoff)(offset - length));
+    file.read((char *)&buffer[0], (std::streamsize)length);
+
+    if ((uint64_t)file.gcount() != length)
+        return false;
+
+    SHA256 guard;
+    guard.update(&buffer[0], length);
+    guard.finalize();
+
+    digest = guard.asBytes();
+
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,158 @@
+/******************************************************************************
+||  tail_state.h                                                             ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    The stored tail midstate of an append-only file (a log or journal).    ||
+||    After a file has been hashed the midstate at its last byte is kept,    ||
+||    together with a digest of the last bytes (the guard).  When the file   ||
+||    has only been appended to since, the next hash resumes from the stored ||
+||    offset and reads only the new bytes.                                   ||
+||                                                                           ||
+||    A file that was replaced (another inode), truncated, rewritten in      ||
+||    place or whose guard no longer matches is hashed again from the start, ||
+||    as it is when the state file fails its checksum (see Checkpoint).      ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    checkpoint.cpp (checkpoint.lib)                                        ||
+||    checkpoint.h                                                           ||
+||    Hashes/sha256.cpp (sha256.lib)                                         ||
+||    Hashes/sha256.h                                                        ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file tail_state.h
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+#ifndef _GH_TAIL_STATE_DEF_H
+#define _GH_TAIL_STATE_DEF_H
+
+#include "checkpoint.h"
+
+/**
+ *  @class TailState The stored tail midstate of one file.
+*/
+class TailState : public Checkpoint
+{
+  public:
+    /******************************************************
+    **                     Constants                     **
+    ******************************************************/
+
+    /// The layout version of the file; other versions are ignored.
+    static const uint32_t VERSION = 1;
+
+    /// The number of bytes before the stored offset that the guard
+    /// digest covers.
+    static const uint32_t GUARD_BYTES = 4096;
+
+    /******************************************************
+    **            Constructors / Destructors             **
+    ******************************************************/
+
+    /** Initialize a TailState object.
+     *
+     *  @pre none.
+     *  @post Nothing is read or written until load() or save().
+     *  @param path The file that holds the tail state.
+     *  @param target The file that is being hashed.
+    */
+    TailState (const string &path, const string &target);
+
+    /** Default destructor.  */
+    ~TailState ();
+
+    /******************************************************
+    **               Accessors / Mutators                **
+    ******************************************************/
+
+    ////////////////////
+    //    Setters
+    ////////////////////
+
+    /** Resume the hash of the target from the stored tail state.
+     *
+     *  @pre file is open on the target.
+     *  @post On success hash holds the midstate of the first offset
+     *        bytes of the target.  The read position of file is
+     *        undefined (the guard has been read).
+     *  @param hash The hash that is to be resumed.
+     *  @param file A handle to the target.
+     *  @param offset Receives the number of bytes already hashed.
+     *  @return true The target has only been appended to since the
+     *          state was stored.
+     *  @return false The target must be hashed from the start; hash is
+     *          then reset.
+    */
+    bool load (MessageHash &hash, ifstream &file, uint64_t &offset);
+
+    /** Store the tail state of the target.
+     *
+     *  @pre hash has absorbed exactly the first offset bytes of the
+     *       target (and has not been finalized).
+     *  @post The state file holds the midstate, the offset and the
+     *        guard.  The read position of file is undefined.
+     *  @param hash The hash of the target.
+     *  @param file A handle to the target.
+     *  @param offset The number of bytes that hash has absorbed.
+     *  @return true The state was written.
+     *  @return false The state file could not be written.
+    */
+    bool save (const MessageHash &hash, ifstream &file, uint64_t offset);
+
+  private:
+    /******************************************************
+    **                   Helper Methods                  **
+    ******************************************************/
+
+    /** Calculate the guard digest of the bytes before an offset.
+     *
+     *  @pre file is open on the target.
+     *  @post The read position of file is undefined.
+     *  @param file A handle to the target.
+     *  @param offset The end of the guarded bytes.
+     *  @param digest Receives the SHA-256 of the (up to GUARD_BYTES)
+     *         bytes before offset.
+     *  @return true The guarded bytes were read.
+     *  @return false The target is shorter than offset.
+    */
+    static bool _guard (ifstream &file, uint64_t offset,
+                        vector < byte_t > &digest);
+
+};  // End class TailState.
+
+#endif
\ No newline at end of file
@@ -0,0 +1,119 @@
+/******************************************************************************
+||  kdf_test.cpp                                                             ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-17                                              ||
+||    Last Edit Date: 2026-10-17                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    Checks of the key derivation functions: HKDF against the test vectors  ||
+||    of RFC 5869, and its refusal of a request for more than 255 blocks of  ||
+||    output.  Run by make check.                                            ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    Hashes/kdf.h                                                           ||
+||    Hashes/kdf.cpp (kdf.lib)                                               ||
+||    Hashes/sha256.cpp (sha256.lib)                                         ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file kdf_test.cpp
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-17
+*/
+
+#include <iostream>
+#include <string.h>
+
+#include "../Hashes/kdf.h"
+
+using namespace std;
+
+/** Parse hexadecimal text.
+ *
+ *  @param text The text (an even number of digits).
+ *  @return The bytes.
+*/
+static vector < byte_t > fromHex (const char *text)
+{
+    vector < byte_t > bytes;
+
+    for (size_t i = 0; text[i] != '\0'; i += 2)
+    {
+        unsigned int value = 0;
+        sscanf(text + i, "%2x", &value);
+        bytes.push_back((byte_t)value);
+    }
+
+    return bytes;
+}
+
+/** Report a check.
+ *
+ *  @param name The name of the check.
+ *  @param passed Whether it passed.
+ *  @return 0 if it passed, else 1.
+*/
+static int check (const char *name, bool passed)
+{
+    cout << (passed ? "PASS: " : "FAIL: ") << name << endl;
+
+    return passed ? 0 : 1;
+}
+
+int main (void)
+{
+    int failures = 0;
+
+    // RFC 5869, test case 1.
+    vector < byte_t > ikm(22, 0x0B),
+                      salt = fromHex("000102030405060708090a0b0c"),
+                      info = fromHex("f0f1f2f3f4f5f6f7f8f9"),
+                      expected = fromHex("3cb25f25faacd57a90434f64d0362f2a"
+                                         "2d2d0a90cf1a5a4c5db02d56ecc4c5bf"
+                                         "34007208d5b887185865");
+
+    failures += check("HKDF-SHA256 (RFC 5869 case 1)",
+                      hkdf < SHA256 > (ikm, salt, info, 42) == expected);
+
+    // 255 blocks is the most HKDF can give; one byte more is an error,
+    // not a shorter key.
+    failures += check("HKDF-SHA256 of 255 blocks",
+                      hkdf < SHA256 > (ikm, salt, info, 255 * 32).size()
+                      == 255 * 32);
+    failures += check("HKDF-SHA256 longer than 255 blocks",
+                      hkdf < SHA256 > (ikm, salt, info, 255 * 32 + 1).empty());
+    failures += check("HKDF-SHA256 of 10000 bytes",
+                      hkdf < SHA256 > (ikm, salt, info, 10000).empty());
+
+    return (failures == 0) ? 0 : 1;
+}
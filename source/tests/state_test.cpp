@@ -0,0 +1,195 @@
+/******************************************************************************
+||  state_test.cpp                                                           ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-17                                              ||
+||    Last Edit Date: 2026-10-17                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    Checks of the midstates (exportState, importState): every byte of the  ||
+||    state of each algorithm, keyed and seeded ones included, is corrupted  ||
+||    in turn.  An object that refuses the state must be left as it was, its ||
+||    key and seed intact, rather than read out of bounds.                   ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    Hashes/*.h                                                             ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+/** @file state_test.cpp
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-17
+*/
+
+#include <iostream>
+#include <string.h>
+
+#include "../Hashes/adler32.h"
+#include "../Hashes/blake2b.h"
+#include "../Hashes/blake2s.h"
+#include "../Hashes/blake3.h"
+#include "../Hashes/crc32.h"
+#include "../Hashes/elf.h"
+#include "../Hashes/hmac.h"
+#include "../Hashes/md5.h"
+#include "../Hashes/sha1.h"
+#include "../Hashes/sha256.h"
+#include "../Hashes/sha512.h"
+#include "../Hashes/xxh3.h"
+#include "../Hashes/xxh64.h"
+
+using namespace std;
+
+/** Report a check.
+ *
+ *  @param name The name of the check.
+ *  @param passed Whether it passed.
+ *  @return 0 if it passed, else 1.
+*/
+static int check (const string &name, bool passed)
+{
+    cout << (passed ? "PASS: " : "FAIL: ") << name << endl;
+
+    return passed ? 0 : 1;
+}
+
+/** Import every single-byte corruption of a midstate into a copy of a
+ *  fresh object.  An import that fails must leave the copy as fresh as
+ *  the original (same key, seed and digest); one that succeeds must
+ *  still finalize.
+ *
+ *  @param fresh The object, configured (key, seed) and not yet updated.
+ *  @param message The message; the state is taken after its first half.
+ *  @return 0 if every corruption passed, else 1.
+*/
+static int checkCorruptStates (const MessageHash &fresh,
+                               const vector < byte_t > &message)
+{
+    static const byte_t MASKS[] = { 0x01, 0x80, 0xFF };
+
+    MessageHash *reference = fresh.clone();
+    string expected = reference->calculateHash(message);
+    delete reference;
+
+    MessageHash *partial = fresh.clone();
+    partial->update(&message[0], message.size() / 2);
+    vector < byte_t > state = partial->exportState();
+    delete partial;
+
+    bool passed = true;
+
+    for (size_t i = 0; i < state.size(); ++i)
+    {
+        for (size_t m = 0; m < (sizeof(MASKS) / sizeof(MASKS[0])); ++m)
+        {
+            vector < byte_t > corrupt(state);
+            corrupt[i] ^= MASKS[m];
+
+            MessageHash *copy = fresh.clone();
+
+            if (copy->importState(corrupt))
+                copy->finalize();
+            else
+            {
+                copy->update(&message[0], message.size());
+                passed = passed && (copy->finalize() == expected);
+            }
+
+            delete copy;
+        }
+    }
+
+    // A truncated state is refused just the same.
+    MessageHash *copy = fresh.clone();
+    vector < byte_t > truncated(state.begin(), state.end() - 1);
+    passed = passed && !copy->importState(truncated);
+    copy->update(&message[0], message.size());
+    passed = passed && (copy->finalize() == expected);
+    delete copy;
+
+    return check("corrupt states of " + fresh.algorithmName(), passed);
+}
+
+int main (void)
+{
+    int failures = 0;
+
+    vector < byte_t > message(3000),
+                      key(32);
+
+    for (size_t i = 0; i < message.size(); ++i)
+        message[i] = (byte_t)((i * 131) + 7);
+    for (size_t i = 0; i < key.size(); ++i)
+        key[i] = (byte_t)(0xA0 + i);
+
+    BLAKE2b blake2b;
+    BLAKE2bp blake2bp;
+    BLAKE2s blake2s;
+    BLAKE2sp blake2sp;
+    BLAKE3 blake3;
+    XXH64 xxh64;
+    XXH3_64 xxh3;
+    XXH3_128 xxh128;
+
+    blake2b.setKey(&key[0], 32);
+    blake2bp.setKey(&key[0], 32);
+    blake2s.setKey(&key[0], 16);
+    blake2sp.setKey(&key[0], 16);
+    blake3.setKey(&key[0]);
+    xxh64.setSeed(0x0123456789ABCDEFULL);
+    xxh3.setSeed(0x0123456789ABCDEFULL);
+    xxh128.setSeed(0x0123456789ABCDEFULL);
+
+    failures += checkCorruptStates(MD5(), message);
+    failures += checkCorruptStates(SHA1(), message);
+    failures += checkCorruptStates(SHA224(), message);
+    failures += checkCorruptStates(SHA256(), message);
+    failures += checkCorruptStates(SHA384(), message);
+    failures += checkCorruptStates(SHA512(), message);
+    failures += checkCorruptStates(SHA512_256(), message);
+    failures += checkCorruptStates(BLAKE2b(), message);
+    failures += checkCorruptStates(blake2b, message);
+    failures += checkCorruptStates(blake2bp, message);
+    failures += checkCorruptStates(BLAKE2s(), message);
+    failures += checkCorruptStates(blake2s, message);
+    failures += checkCorruptStates(blake2sp, message);
+    failures += checkCorruptStates(BLAKE3(), message);
+    failures += checkCorruptStates(blake3, message);
+    failures += checkCorruptStates(xxh64, message);
+    failures += checkCorruptStates(xxh3, message);
+    failures += checkCorruptStates(xxh128, message);
+    failures += checkCorruptStates(Adler32(), message);
+    failures += checkCorruptStates(CRC32(), message);
+    failures += checkCorruptStates(ELF(), message);
+    failures += checkCorruptStates(HMAC < SHA256 > (key), message);
+
+    return (failures == 0) ? 0 : 1;
+}
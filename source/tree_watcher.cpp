@@ -0,0 +1,844 @@
+/******************************************************************************
+||  tree_watcher.cpp                                                         ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    gash watch: keeps the digests of a directory tree current as its files ||
+||    change, instead of sweeping the tree again and again.  Every directory ||
+||    of the tree is watched with inotify for files that are written and     ||
+||    closed, created, deleted and renamed, and for directories that come and||
+||    go (which are then watched, or forgotten, in turn).                    ||
+||                                                                           ||
+||    Changes are debounced: a file is hashed once it has been left alone for||
+||    the debounce interval (or, if it never is, at the latest MAX_DEBOUNCES ||
+||    intervals after it first changed), so that a burst of writes, or a save||
+||    that writes a temporary file and renames it over the original, costs   ||
+||    one hash.  The files are hashed by a pool of worker threads, each with ||
+||    a PrefetchReader of its own, while the main thread goes on reading     ||
+||    events.                                                                ||
+||                                                                           ||
+||    The digests are kept in an index in memory, which is compared with each||
+||    new digest so that only real changes are reported (as Added, Changed   ||
+||    and Removed records), and in the digest cache, so that gash and the    ||
+||    gash daemon look them up instead of reading the files.  If the kernel  ||
+||    drops events (its queue overflowed) the whole tree is checked again.   ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    digest_cache.cpp                                                       ||
+||    digest_cache.h                                                         ||
+||    gash.cpp (createHash, isUnchanged)                                     ||
+||    gash.h                                                                 ||
+||    prefetch_reader.cpp                                                    ||
+||    prefetch_reader.h                                                      ||
+||    Hashes/hash_abstract.cpp (hash_abstract.lib)                           ||
+||    Hashes/hash_abstract.h                                                 ||
+||    inotify (Linux 2.6.27 or later)                                        ||
+||    pthread                                                                ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file tree_watcher.cpp
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <signal.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+
+#include "gash.h"
+#include "tree_watcher.h"
+
+const uint32_t TreeWatcher::DEFAULT_DEBOUNCE;
+const uint32_t TreeWatcher::MAX_DEBOUNCES;
+const uint32_t TreeWatcher::MAX_THREADS;
+const uint32_t TreeWatcher::SAVE_INTERVAL;
+
+// The events that are watched in each directory: files that were written
+// and closed, and the entries that appear and disappear.
+static const uint32_t WATCH_EVENTS = IN_CLOSE_WRITE | IN_CREATE | IN_DELETE
+                                   | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+
+// Set by SIGINT and SIGTERM.
+static volatile sig_atomic_t stopRequested = 0;
+
+/** Ask the watcher to stop (the handler of SIGINT and SIGTERM).
+ *
+ *  @param signal The signal.
+ *  @return none.
+*/
+static void requestStop (int signal)
+{
+    (void)signal;
+    stopRequested = 1;
+}
+
+/******************************************************
+**            Constructors / Destructors             **
+******************************************************/
+
+/** Initialize a TreeWatcher object.
+ *
+ *  @pre hashFlag names a hash (see createHash()); threads <=
+ *       MAX_THREADS.
+ *  @post The watcher is ready to watch().
+ *  @param hashFlag The hash, as on the command line.
+ *  @param cache The digest cache to use and keep current (or NULL for
+ *         none); the caller keeps ownership of it.
+ *  @param threads The number of worker threads (zero: one per CPU).
+ *  @param debounce The milliseconds a file must be left alone before
+ *         it is hashed.
+*/
+TreeWatcher::TreeWatcher (const string &hashFlag, DigestCache *cache,
+                          uint32_t threads, uint32_t debounce)
+    : _hashFlag(hashFlag),
+      _cache(cache),
+      _dirty(false),
+      _threads(threads),
+      _debounce(debounce),
+      _direct(false),
+      _inotify(-1),
+      _wakeup(-1),
+      _stop(false)
+{
+    delete createHash(_hashFlag, _label);
+
+    if (_threads == 0)
+    {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        _threads = (online < 1) ? 1 : (online > (long)MAX_THREADS)
+                                      ? MAX_THREADS : (uint32_t)online;
+    }
+
+    pthread_mutex_init(&_cacheLock, NULL);
+    pthread_mutex_init(&_lock, NULL);
+    pthread_cond_init(&_queued, NULL);
+}
+
+/** Default destructor (stops watching).  */
+TreeWatcher::~TreeWatcher ()
+{
+    if (_inotify >= 0)
+        close(_inotify);
+
+    if (_wakeup >= 0)
+        close(_wakeup);
+
+    for (size_t i = 0; i < _queue.size(); ++i)
+        delete _queue[i];
+
+    for (size_t i = 0; i < _done.size(); ++i)
+        delete _done[i];
+
+    pthread_cond_destroy(&_queued);
+    pthread_mutex_destroy(&_lock);
+    pthread_mutex_destroy(&_cacheLock);
+}
+
+/******************************************************
+**               Accessors / Mutators                **
+******************************************************/
+
+////////////////////
+//    Getters
+////////////////////
+
+/** Retrieve the number of worker threads.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return The number of threads.
+*/
+uint32_t TreeWatcher::threads (void) const
+{
+    return _threads;
+}
+
+////////////////////
+//    Setters
+////////////////////
+
+/** Read the files around the page cache (see PrefetchReader).
+ *
+ *  @pre run() has not been called.
+ *  @post The workers read with O_DIRECT where they can.
+ *  @param direct Whether to read around the page cache.
+ *  @return none.
+*/
+void TreeWatcher::setDirect (bool direct)
+{
+    _direct = direct;
+
+    return;
+}
+
+/******************************************************
+**                      Methods                      **
+******************************************************/
+
+/** Watch a directory tree, and queue its files to be indexed.
+ *
+ *  @pre none.
+ *  @post Every directory of the tree is watched.
+ *  @param root The directory.
+ *  @return true The tree is watched.
+ *  @return false root is not a directory that can be watched.
+*/
+bool TreeWatcher::watch (const string &root)
+{
+    struct stat status;
+
+    if (root.empty() || (stat(root.c_str(), &status) != 0)
+        || !S_ISDIR(status.st_mode))
+        return false;
+
+    _inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    _wakeup = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    if ((_inotify < 0) || (_wakeup < 0))
+        return false;
+
+    _root = root;
+    while ((_root.size() > 1) && (_root[_root.size() - 1] == '/'))
+        _root.erase(_root.size() - 1);
+
+    // The files that are there to begin with are indexed, not reported.
+    _addTree(_root, 0);
+
+    std::map < string, Pending >::const_iterator it;
+    for (it = _pending.begin(); it != _pending.end(); ++it)
+        _quiet.insert(it->first);
+
+    return !_directories.empty();
+}
+
+/** Index the tree, then report its changes until SIGINT or SIGTERM:
+ *  "Added:", "Changed:" (each with the new digest) and "Removed:"
+ *  records on the standard output.
+ *
+ *  @pre watch() succeeded.
+ *  @post The digest cache is saved.
+ *  @return 0 on success, 1 if the cache could not be saved.
+*/
+int TreeWatcher::run (void)
+{
+    struct sigaction action;
+
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = requestStop;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    for (uint32_t t = 0; t < _threads; ++t)
+    {
+        pthread_t thread;
+
+        if (pthread_create(&thread, NULL, _workerThread, this) == 0)
+            _workers.push_back(thread);
+    }
+
+    if (_workers.empty())
+        return 1;
+
+    time_t saved = time(NULL);
+    bool indexed = false;
+
+    // The watch ends with the tree itself, once its last changes are in.
+    while (!stopRequested
+           && (!_directories.empty() || !_pending.empty()
+               || !_running.empty()))
+    {
+        int wait = _dispatch(_now());
+
+        // The descriptors are polled with a timeout, so that a signal
+        // (which may be taken by any thread) and the saves of the cache
+        // are noticed.
+        if ((wait < 0) || (wait > 1000))
+            wait = 1000;
+
+        struct pollfd fds[2];
+
+        fds[0].fd = _inotify;
+        fds[0].events = POLLIN;
+        fds[0].revents = 0;
+        fds[1].fd = _wakeup;
+        fds[1].events = POLLIN;
+        fds[1].revents = 0;
+
+        if (poll(fds, 2, wait) > 0)
+        {
+            if (fds[1].revents != 0)
+                _collect();
+
+            if (fds[0].revents != 0)
+                _readEvents(_now());
+        }
+
+        if (!indexed && _quiet.empty())
+        {
+            cout << "Indexed " << _index.size() << " files in " << _root
+                 << "; watching for changes." << endl;
+            indexed = true;
+        }
+
+        if (time(NULL) - saved >= (time_t)SAVE_INTERVAL)
+        {
+            _save();
+            saved = time(NULL);
+        }
+    }
+
+    pthread_mutex_lock(&_lock);
+    _stop = true;
+    pthread_cond_broadcast(&_queued);
+    pthread_mutex_unlock(&_lock);
+
+    for (size_t t = 0; t < _workers.size(); ++t)
+        pthread_join(_workers[t], NULL);
+
+    _workers.clear();
+
+    return _save() ? 0 : 1;
+}
+
+/******************************************************
+**                   Helper Methods                  **
+******************************************************/
+
+/** Watch a directory and those below it, and mark their files as
+ *  changed.
+ *
+ *  @param path The directory.
+ *  @param now The time of the change (ms).
+ *  @return none.
+*/
+void TreeWatcher::_addTree (const string &path, uint64_t now)
+{
+    // The directory is watched before it is listed, so that no file that
+    // appears in between is missed.
+    int wd = inotify_add_watch(_inotify, path.c_str(), WATCH_EVENTS);
+
+    if (wd < 0)
+    {
+        cerr << "Warning: could not watch directory \"" << path << "\"";
+
+        if (errno == ENOSPC)
+            cerr << " (raise fs.inotify.max_user_watches)";
+
+        cerr << "." << endl;
+
+        return;
+    }
+
+    _directories[wd] = path;
+
+    DIR *directory = opendir(path.c_str());
+    if (directory == NULL)
+    {
+        cerr << "Warning: could not read directory \"" << path << "\"."
+             << endl;
+        return;
+    }
+
+    vector < string > names;
+    struct dirent *entry;
+
+    while ((entry = readdir(directory)) != NULL)
+    {
+        string name(entry->d_name);
+        if ((name != ".") && (name != ".."))
+            names.push_back(name);
+    }
+
+    closedir(directory);
+
+    string prefix = path;
+    if (prefix[prefix.size() - 1] != '/')
+        prefix += "/";
+
+    // As in collectFiles(), symbolic links are skipped.
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+        string child = prefix + names[i];
+        struct stat status;
+
+        if (lstat(child.c_str(), &status) != 0)
+            continue;
+
+        if (S_ISDIR(status.st_mode))
+            _addTree(child, now);
+        else if (S_ISREG(status.st_mode))
+            _touch(child, now);
+    }
+
+    return;
+}
+
+/** Stop watching a directory and those below it, and mark the files
+ *  indexed under it as changed (they are then found to be gone).
+ *
+ *  @param path The directory.
+ *  @param now The time of the change (ms).
+ *  @return none.
+*/
+void TreeWatcher::_removeTree (const string &path, uint64_t now)
+{
+    string prefix = path + "/";
+
+    std::map < int, string >::iterator it = _directories.begin();
+    while (it != _directories.end())
+    {
+        if ((it->second == path)
+            || (it->second.compare(0, prefix.size(), prefix) == 0))
+        {
+            inotify_rm_watch(_inotify, it->first);
+            _directories.erase(it++);
+        }
+        else
+            ++it;
+    }
+
+    std::map < string, string >::const_iterator file;
+    for (file = _index.lower_bound(prefix);
+         (file != _index.end())
+         && (file->first.compare(0, prefix.size(), prefix) == 0);
+         ++file)
+        _touch(file->first, now);
+
+    return;
+}
+
+/** Read the pending inotify events.
+ *
+ *  @param now The current time (ms).
+ *  @return none.
+*/
+void TreeWatcher::_readEvents (uint64_t now)
+{
+    char buffer[65536]
+        __attribute__ ((aligned(__alignof__(struct inotify_event))));
+
+    for (;;)
+    {
+        ssize_t length = read(_inotify, buffer, sizeof(buffer));
+
+        if ((length < 0) && (errno == EINTR))
+            continue;
+
+        if (length <= 0)
+            break;
+
+        for (ssize_t at = 0; at < length; )
+        {
+            const struct inotify_event *event =
+                (const struct inotify_event *)(buffer + at);
+
+            at += sizeof(struct inotify_event) + event->len;
+
+            // Events were lost: everything is checked again.
+            if (event->mask & IN_Q_OVERFLOW)
+            {
+                cerr << "Warning: inotify events were lost; rescanning \""
+                     << _root << "\"." << endl;
+
+                std::map < string, string >::const_iterator file;
+                for (file = _index.begin(); file != _index.end(); ++file)
+                    _touch(file->first, now);
+
+                _addTree(_root, now);
+
+                continue;
+            }
+
+            std::map < int, string >::iterator directory =
+                _directories.find(event->wd);
+
+            if (directory == _directories.end())
+                continue;
+
+            // The directory itself is gone.
+            if (event->mask & IN_IGNORED)
+            {
+                _directories.erase(directory);
+                continue;
+            }
+
+            if (event->len == 0)
+                continue;
+
+            string path = directory->second;
+            if (path[path.size() - 1] != '/')
+                path += "/";
+
+            path += event->name;
+
+            if (!(event->mask & IN_ISDIR))
+                _touch(path, now);
+            else if (event->mask & (IN_CREATE | IN_MOVED_TO))
+                _addTree(path, now);
+            else if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+                _removeTree(path, now);
+        }
+    }
+
+    return;
+}
+
+/** Mark a file as changed.
+ *
+ *  @param path The file.
+ *  @param now The time of the change (ms).
+ *  @return none.
+*/
+void TreeWatcher::_touch (const string &path, uint64_t now)
+{
+    // The digest cache (and its temporary file) may be in the tree.
+    if ((_cache != NULL)
+        && ((path == _cache->path()) || (path == _cache->path() + ".tmp")))
+        return;
+
+    std::map < string, Pending >::iterator it = _pending.find(path);
+
+    if (it == _pending.end())
+    {
+        Pending &pending = _pending[path];
+
+        pending.first = now;
+        pending.last = now;
+    }
+    else
+        it->second.last = now;
+
+    return;
+}
+
+/** Queue the changed files that have been left alone long enough.
+ *
+ *  @param now The current time (ms).
+ *  @return The milliseconds until the next file is due (or -1).
+*/
+int TreeWatcher::_dispatch (uint64_t now)
+{
+    uint64_t next = 0;
+    vector < Job * > jobs;
+
+    std::map < string, Pending >::iterator it = _pending.begin();
+    while (it != _pending.end())
+    {
+        // A file that is still being hashed is hashed again afterwards.
+        if (_running.count(it->first) != 0)
+        {
+            ++it;
+            continue;
+        }
+
+        // A file is due once it has been left alone for the debounce
+        // interval, or has been changing for MAX_DEBOUNCES of them.
+        uint64_t due = std::min(it->second.last + _debounce,
+                                it->second.first
+                                + (uint64_t)_debounce * MAX_DEBOUNCES);
+
+        if (due > now)
+        {
+            if ((next == 0) || (due < next))
+                next = due;
+
+            ++it;
+            continue;
+        }
+
+        Job *job = new Job;
+
+        job->path = it->first;
+        job->missing = false;
+        jobs.push_back(job);
+
+        _running.insert(it->first);
+        _pending.erase(it++);
+    }
+
+    if (!jobs.empty())
+    {
+        pthread_mutex_lock(&_lock);
+        _queue.insert(_queue.end(), jobs.begin(), jobs.end());
+        pthread_cond_broadcast(&_queued);
+        pthread_mutex_unlock(&_lock);
+    }
+
+    return (next == 0) ? -1 : (int)std::min(next - now, (uint64_t)INT_MAX);
+}
+
+/** Fold the finished jobs into the index and report the changes.
+ *
+ *  @return none.
+*/
+void TreeWatcher::_collect (void)
+{
+    uint64_t count;
+    std::deque < Job * > done;
+
+    // Clear the eventfd before taking the jobs, so that no wakeup is lost.
+    while (read(_wakeup, &count, sizeof(count)) == (ssize_t)sizeof(count))
+        ;
+
+    pthread_mutex_lock(&_lock);
+    done.swap(_done);
+    pthread_mutex_unlock(&_lock);
+
+    for (size_t i = 0; i < done.size(); ++i)
+    {
+        Job *job = done[i];
+        bool quiet = (_quiet.erase(job->path) != 0);
+
+        _running.erase(job->path);
+
+        std::map < string, string >::iterator it = _index.find(job->path);
+
+        if (!job->error.empty())
+        {
+            cout.flush();
+            cerr << job->error;
+        }
+        else if (job->missing)
+        {
+            if (it != _index.end())
+            {
+                _index.erase(it);
+
+                if (!quiet)
+                    cout << "Removed: " << job->path << "\n\n";
+            }
+        }
+        else if (it == _index.end())
+        {
+            _index[job->path] = job->digest;
+
+            if (!quiet)
+            {
+                cout << "Added: " << job->path << "\n" << _label
+                     << job->digest << "\n\n";
+            }
+        }
+        else if (it->second != job->digest)
+        {
+            it->second = job->digest;
+
+            cout << "Changed: " << job->path << "\n" << _label
+                 << job->digest << "\n\n";
+        }
+
+        delete job;
+    }
+
+    cout.flush();
+
+    return;
+}
+
+/** Hash the file of a job.
+ *
+ *  @param job The job.
+ *  @param reader The reader of the worker thread.
+ *  @return none.
+*/
+void TreeWatcher::_hashFile (Job &job, PrefetchReader &reader)
+{
+    struct stat before;
+
+    if (lstat(job.path.c_str(), &before) != 0)
+    {
+        if ((errno == ENOENT) || (errno == ENOTDIR))
+            job.missing = true;
+        else
+            job.error = "Error: could not open file \"" + job.path + "\".\n";
+
+        return;
+    }
+
+    // A file that was replaced by a directory or a link has left the
+    // index (a directory is watched in its own right).
+    if (!S_ISREG(before.st_mode))
+    {
+        job.missing = true;
+        return;
+    }
+
+    string label;
+    MessageHash *hash = createHash(_hashFlag, label);
+    bool cached = false;
+
+    if (_cache != NULL)
+    {
+        pthread_mutex_lock(&_cacheLock);
+        cached = _cache->lookup(before, *hash);
+        pthread_mutex_unlock(&_cacheLock);
+    }
+
+    if (!cached)
+    {
+        if (!reader.hash(job.path, *hash))
+        {
+            struct stat after;
+
+            if ((lstat(job.path.c_str(), &after) != 0) && (errno == ENOENT))
+                job.missing = true;
+            else
+            {
+                job.error = "Error: could not read file \"" + job.path
+                            + "\".\n";
+            }
+
+            delete hash;
+
+            return;
+        }
+
+        // The digest is only stored if the file did not change while it
+        // was being read.
+        struct stat after;
+
+        if ((_cache != NULL) && (stat(job.path.c_str(), &after) == 0)
+            && isUnchanged(before, after)
+            && (after.st_ctim.tv_sec == before.st_ctim.tv_sec)
+            && (after.st_ctim.tv_nsec == before.st_ctim.tv_nsec))
+        {
+            pthread_mutex_lock(&_cacheLock);
+            _cache->store(before, *hash);
+            _dirty = true;
+            pthread_mutex_unlock(&_cacheLock);
+        }
+    }
+
+    job.digest = hash->asString();
+    delete hash;
+
+    return;
+}
+
+/** Save the digest cache if digests were stored since the last save.
+ *
+ *  @return true The cache is saved.
+ *  @return false It could not be written.
+*/
+bool TreeWatcher::_save (void)
+{
+    bool saved = true;
+
+    pthread_mutex_lock(&_cacheLock);
+
+    if (_dirty)
+    {
+        saved = _cache->save();
+        _dirty = !saved;
+    }
+
+    pthread_mutex_unlock(&_cacheLock);
+
+    if (!saved)
+    {
+        cerr << "Warning: could not write the digest cache \""
+             << _cache->path() << "\"." << endl;
+    }
+
+    return saved;
+}
+
+/** Read the monotonic clock.
+ *
+ *  @return The time in milliseconds.
+*/
+uint64_t TreeWatcher::_now (void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)now.tv_sec * 1000 + (uint64_t)now.tv_nsec / 1000000;
+}
+
+/** The body of a worker thread.
+ *
+ *  @param arg The TreeWatcher.
+ *  @return NULL.
+*/
+void * TreeWatcher::_workerThread (void *arg)
+{
+    TreeWatcher &watcher = *(TreeWatcher *)arg;
+
+    // Each worker reads ahead with a reader (and I/O thread) of its own.
+    PrefetchReader reader;
+    reader.setDirect(watcher._direct);
+
+    pthread_mutex_lock(&watcher._lock);
+
+    for (;;)
+    {
+        while (watcher._queue.empty() && !watcher._stop)
+            pthread_cond_wait(&watcher._queued, &watcher._lock);
+
+        if (watcher._stop)
+            break;
+
+        Job *job = watcher._queue.front();
+        watcher._queue.pop_front();
+        pthread_mutex_unlock(&watcher._lock);
+
+        watcher._hashFile(*job, reader);
+
+        pthread_mutex_lock(&watcher._lock);
+        watcher._done.push_back(job);
+
+        // A full counter has woken the main thread already.
+        uint64_t one = 1;
+        ssize_t written = write(watcher._wakeup, &one, sizeof(one));
+        (void)written;
+    }
+
+    pthread_mutex_unlock(&watcher._lock);
+
+    return NULL;
+}
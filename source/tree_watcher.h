@@ -0,0 +1,328 @@
+/******************************************************************************
+||  tree_watcher.h                                                           ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    gash watch: keeps the digests of a directory tree current as its files ||
+||    change, instead of sweeping the tree again and again.  Every directory ||
+||    of the tree is watched with inotify for files that are written and     ||
+||    closed, created, deleted and renamed, and for directories that come and||
+||    go (which are then watched, or forgotten, in turn).                    ||
+||                                                                           ||
+||    Changes are debounced: a file is hashed once it has been left alone for||
+||    the debounce interval (or, if it never is, at the latest MAX_DEBOUNCES ||
+||    intervals after it first changed), so that a burst of writes, or a save||
+||    that writes a temporary file and renames it over the original, costs   ||
+||    one hash.  The files are hashed by a pool of worker threads, each with ||
+||    a PrefetchReader of its own, while the main thread goes on reading     ||
+||    events.                                                                ||
+||                                                                           ||
+||    The digests are kept in an index in memory, which is compared with each||
+||    new digest so that only real changes are reported (as Added, Changed   ||
+||    and Removed records), and in the digest cache, so that gash and the    ||
+||    gash daemon look them up instead of reading the files.  If the kernel  ||
+||    drops events (its queue overflowed) the whole tree is checked again.   ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    digest_cache.cpp                                                       ||
+||    digest_cache.h                                                         ||
+||    gash.cpp (createHash, isUnchanged)                                     ||
+||    gash.h                                                                 ||
+||    prefetch_reader.cpp                                                    ||
+||    prefetch_reader.h                                                      ||
+||    Hashes/hash_abstract.cpp (hash_abstract.lib)                           ||
+||    Hashes/hash_abstract.h                                                 ||
+||    inotify (Linux 2.6.27 or later)                                        ||
+||    pthread                                                                ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file tree_watcher.h
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+
+#ifndef _GH_TREE_WATCHER_DEF_H
+#define _GH_TREE_WATCHER_DEF_H
+
+#include <pthread.h>
+
+#include <deque>
+#include <map>
+#include <set>
+
+#include "Hashes/hash_abstract.h"
+#include "digest_cache.h"
+#include "prefetch_reader.h"
+
+/**
+ *  @class TreeWatcher Keeps the digests of a directory tree current as
+ *         its files change (inotify), and reports the changes.
+*/
+class TreeWatcher
+{
+  public:
+    /******************************************************
+    **                     Constants                     **
+    ******************************************************/
+
+    /// The milliseconds a file must be left alone before it is hashed.
+    static const uint32_t DEFAULT_DEBOUNCE = 500;
+
+    /// A file that keeps changing is hashed at the latest this many
+    /// debounce intervals after it first changed.
+    static const uint32_t MAX_DEBOUNCES = 20;
+
+    /// The most worker threads.
+    static const uint32_t MAX_THREADS = 256;
+
+    /// The seconds between the saves of the digest cache.
+    static const uint32_t SAVE_INTERVAL = 30;
+
+    /******************************************************
+    **            Constructors / Destructors             **
+    ******************************************************/
+
+    /** Initialize a TreeWatcher object.
+     *
+     *  @pre hashFlag names a hash (see createHash()); threads <=
+     *       MAX_THREADS.
+     *  @post The watcher is ready to watch().
+     *  @param hashFlag The hash, as on the command line.
+     *  @param cache The digest cache to use and keep current (or NULL for
+     *         none); the caller keeps ownership of it.
+     *  @param threads The number of worker threads (zero: one per CPU).
+     *  @param debounce The milliseconds a file must be left alone before
+     *         it is hashed.
+    */
+    TreeWatcher (const string &hashFlag, DigestCache *cache,
+                 uint32_t threads = 0, uint32_t debounce = DEFAULT_DEBOUNCE);
+
+    /** Default destructor (stops watching).  */
+    ~TreeWatcher ();
+
+    /******************************************************
+    **               Accessors / Mutators                **
+    ******************************************************/
+
+    ////////////////////
+    //    Getters
+    ////////////////////
+
+    /** Retrieve the number of worker threads.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return The number of threads.
+    */
+    uint32_t threads (void) const;
+
+    ////////////////////
+    //    Setters
+    ////////////////////
+
+    /** Read the files around the page cache (see PrefetchReader).
+     *
+     *  @pre run() has not been called.
+     *  @post The workers read with O_DIRECT where they can.
+     *  @param direct Whether to read around the page cache.
+     *  @return none.
+    */
+    void setDirect (bool direct);
+
+    /******************************************************
+    **                      Methods                      **
+    ******************************************************/
+
+    /** Watch a directory tree, and queue its files to be indexed.
+     *
+     *  @pre none.
+     *  @post Every directory of the tree is watched.
+     *  @param root The directory.
+     *  @return true The tree is watched.
+     *  @return false root is not a directory that can be watched.
+    */
+    bool watch (const string &root);
+
+    /** Index the tree, then report its changes until SIGINT or SIGTERM:
+     *  "Added:", "Changed:" (each with the new digest) and "Removed:"
+     *  records on the standard output.
+     *
+     *  @pre watch() succeeded.
+     *  @post The digest cache is saved.
+     *  @return 0 on success, 1 if the cache could not be saved.
+    */
+    int run (void);
+
+  private:
+    /******************************************************
+    **                      Members                      **
+    ******************************************************/
+
+    /**
+     *  @struct Pending A file that changed and has not been hashed yet.
+     */
+    struct Pending
+    {
+        uint64_t first;             // When it first changed (ms).
+        uint64_t last;              // When it last changed (ms).
+    };
+
+    /**
+     *  @struct Job A file for a worker to hash.
+     */
+    struct Job
+    {
+        string path;                // The file.
+        bool missing;               // It is gone (or not a regular file).
+        string error;               // Why it could not be hashed.
+        string digest;              // Its digest (hexadecimal).
+    };
+
+    string _hashFlag;               // The hash.
+    string _label;                  // Its label ("SHA-256: ").
+    DigestCache *_cache;            // The digest cache (or NULL).
+    pthread_mutex_t _cacheLock;     // Guards it.
+    bool _dirty;                    // Digests were stored since the last
+                                    // save.
+    uint32_t _threads;              // The number of worker threads.
+    uint32_t _debounce;             // The quiet time of a change (ms).
+    bool _direct;                   // Read around the page cache.
+
+    string _root;                   // The tree.
+    int _inotify;                   // The inotify instance.
+    int _wakeup;                    // An eventfd the workers signal.
+    std::map < int, string > _directories;   // The watched directories.
+
+    // The state of the main thread.
+    std::map < string, string > _index;             // The digests.
+    std::map < string, Pending > _pending;          // Changed files.
+    std::set < string > _running;                   // Files being hashed.
+    std::set < string > _quiet;                     // Files of the first
+                                                    // scan (not reported).
+
+    vector < pthread_t > _workers;  // The worker threads.
+    pthread_mutex_t _lock;          // Guards the members below.
+    pthread_cond_t _queued;         // Signalled when a job is queued.
+    std::deque < Job * > _queue;    // The jobs that are waiting.
+    std::deque < Job * > _done;     // The jobs that are finished.
+    bool _stop;                     // The watcher is stopping.
+
+    /******************************************************
+    **                   Helper Methods                  **
+    ******************************************************/
+
+    /** Watch a directory and those below it, and mark their files as
+     *  changed.
+     *
+     *  @param path The directory.
+     *  @param now The time of the change (ms).
+     *  @return none.
+    */
+    void _addTree (const string &path, uint64_t now);
+
+    /** Stop watching a directory and those below it, and mark the files
+     *  indexed under it as changed (they are then found to be gone).
+     *
+     *  @param path The directory.
+     *  @param now The time of the change (ms).
+     *  @return none.
+    */
+    void _removeTree (const string &path, uint64_t now);
+
+    /** Read the pending inotify events.
+     *
+     *  @param now The current time (ms).
+     *  @return none.
+    */
+    void _readEvents (uint64_t now);
+
+    /** Mark a file as changed.
+     *
+     *  @param path The file.
+     *  @param now The time of the change (ms).
+     *  @return none.
+    */
+    void _touch (const string &path, uint64_t now);
+
+    /** Queue the changed files that have been left alone long enough.
+     *
+     *  @param now The current time (ms).
+     *  @return The milliseconds until the next file is due (or -1).
+    */
+    int _dispatch (uint64_t now);
+
+    /** Fold the finished jobs into the index and report the changes.
+     *
+     *  @return none.
+    */
+    void _collect (void);
+
+    /** Hash the file of a job.
+     *
+     *  @param job The job.
+     *  @param reader The reader of the worker thread.
+     *  @return none.
+    */
+    void _hashFile (Job &job, PrefetchReader &reader);
+
+    /** Save the digest cache if digests were stored since the last save.
+     *
+     *  @return true The cache is saved.
+     *  @return false It could not be written.
+    */
+    bool _save (void);
+
+    /** Read the monotonic clock.
+     *
+     *  @return The time in milliseconds.
+    */
+    static uint64_t _now (void);
+
+    /** The body of a worker thread.
+     *
+     *  @param arg The TreeWatcher.
+     *  @return NULL.
+    */
+    static void * _workerThread (void *arg);
+
+    // Not copyable (owns the inotify instance and the threads).
+    TreeWatcher (const TreeWatcher &);
+    TreeWatcher & operator = (const TreeWatcher &);
+
+};  // End class TreeWatcher.
+
+#endif
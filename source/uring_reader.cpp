@@ -0,0 +1,1190 @@
+/******************************************************************************
+||  uring_reader.cpp                                                         ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    Reads and hashes many files through io_uring, so that a few threads    ||
+||    keep a deep queue of reads outstanding on fast (NVMe) storage instead  ||
+||    of each waiting on one blocking read at a time.                        ||
+||                                                                           ||
+||    Each thread owns a ring, whose read buffers are registered with the    ||
+||    kernel once (READ_FIXED), and a table of registered (fixed) files.  A  ||
+||    thread keeps up to 64 files open and spreads its queue depth of reads  ||
+||    over them round robin, submitting and reaping them in batches.  A      ||
+||    completed read is hashed as soon as the reads before it in its file    ||
+||    have been; later ones wait in their buffers.  Where io_uring is        ||
+||    unavailable (or blocked) the threads fall back to blocking reads.      ||
+||    With setDirect() the files are read around the page cache (see         ||
+||    DirectReader).                                                         ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    uring_reader.h                                                         ||
+||    direct_reader.cpp                                                      ||
+||    direct_reader.h                                                        ||
+||    Hashes/hash_abstract.cpp (hash_abstract.lib)                           ||
+||    Hashes/hash_abstract.h                                                 ||
+||    linux/io_uring.h (Linux 5.6 or later)                                  ||
+||    pthread                                                                ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file uring_reader.cpp
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+
+#ifndef _GNU_SOURCE
+  #define _GNU_SOURCE               // O_DIRECT
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <map>
+
+#include "uring_reader.h"
+
+#ifdef GASH_IO_URING
+  #include <linux/io_uring.h>
+  #include <sys/mman.h>
+  #include <sys/syscall.h>
+  #include <sys/uio.h>
+#endif
+
+const uint32_t UringReader::DEFAULT_QUEUE_DEPTH;
+const uint32_t UringReader::DEFAULT_BATCH;
+const uint32_t UringReader::DEFAULT_READ_BYTES;
+const uint32_t UringReader::MAX_QUEUE_DEPTH;
+const uint32_t UringReader::MAX_OPEN_FILES;
+
+// The largest read (and the alignment of the read buffers).
+static const uint32_t MAX_READ_BYTES = 16777216;
+static const uint32_t BUFFER_ALIGNMENT = 4096;
+
+/**
+ *  @struct UringReader::Job The list of files shared by the threads.
+*/
+struct UringReader::Job
+{
+    const MessageHash *prototype;   // The algorithm.
+    vector < string > files;        // The files.
+    uint32_t queueDepth;            // The settings of each ring.
+    uint32_t batch;
+    uint32_t readBytes;
+    bool direct;                    // Bypass the page cache.
+    ProgressMonitor *progress;      // The progress counters (or NULL).
+
+    pthread_mutex_t lock;           // Guards the members below.
+    pthread_cond_t published;       // Signalled for each result.
+    size_t next;                    // The next file to claim.
+    size_t returned;                // The results returned by next().
+    vector < Result > results;      // The result for each file.
+    vector < bool > done;           // Whether each result is ready.
+
+    vector < pthread_t > threads;
+};
+
+#ifdef GASH_IO_URING
+
+/**
+ *  @struct Ring An io_uring instance: the submission and completion
+ *          queues that are shared with the kernel.
+*/
+struct Ring
+{
+    int fd;                         // The io_uring descriptor.
+    uint32_t entries;               // The size of the submission queue.
+    uint32_t queued;                // Entries not yet submitted.
+
+    unsigned *sqHead;               // The submission queue.
+    unsigned *sqTail;
+    unsigned *sqMask;
+    unsigned *sqArray;
+    struct io_uring_sqe *sqes;
+
+    unsigned *cqHead;               // The completion queue.
+    unsigned *cqTail;
+    unsigned *cqMask;
+    struct io_uring_cqe *cqes;
+
+    void *sqMap;                    // The mappings of the queues.
+    void *cqMap;
+    size_t sqMapBytes;
+    size_t cqMapBytes;
+    size_t sqesBytes;
+};
+
+/** Release an io_uring instance.  */
+static void ringTeardown (Ring &ring)
+{
+    if (ring.sqes != NULL)
+        munmap(ring.sqes, ring.sqesBytes);
+
+    if ((ring.cqMap != NULL) && (ring.cqMap != ring.sqMap))
+        munmap(ring.cqMap, ring.cqMapBytes);
+
+    if (ring.sqMap != NULL)
+        munmap(ring.sqMap, ring.sqMapBytes);
+
+    if (ring.fd >= 0)
+        close(ring.fd);
+
+    memset(&ring, 0, sizeof(ring));
+    ring.fd = -1;
+
+    return;
+}
+
+/** Create an io_uring instance and map its queues.
+ *
+ *  @param ring Receives the instance.
+ *  @param entries The size of the submission queue.
+ *  @return true The instance was created.
+ *  @return false io_uring is unavailable.
+*/
+static bool ringSetup (Ring &ring, uint32_t entries)
+{
+    struct io_uring_params params;
+
+    memset(&ring, 0, sizeof(ring));
+    memset(&params, 0, sizeof(params));
+
+    ring.fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+    if (ring.fd < 0)
+        return false;
+
+    ring.entries = params.sq_entries;
+    ring.sqMapBytes = params.sq_off.array
+                      + params.sq_entries * sizeof(unsigned);
+    ring.cqMapBytes = params.cq_off.cqes
+                      + params.cq_entries * sizeof(struct io_uring_cqe);
+
+    // Since Linux 5.4 both rings share one mapping.
+    bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single && (ring.cqMapBytes > ring.sqMapBytes))
+        ring.sqMapBytes = ring.cqMapBytes;
+
+    ring.sqMap = mmap(NULL, ring.sqMapBytes, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ring.fd, IORING_OFF_SQ_RING);
+    if (ring.sqMap == MAP_FAILED)
+    {
+        ring.sqMap = NULL;
+        ringTeardown(ring);
+        return false;
+    }
+
+    ring.cqMap = single ? ring.sqMap
+                        : mmap(NULL, ring.cqMapBytes, PROT_READ | PROT_WRITE,
+                               MAP_SHARED | MAP_POPULATE, ring.fd,
+                               IORING_OFF_CQ_RING);
+    if (ring.cqMap == MAP_FAILED)
+    {
+        ring.cqMap = NULL;
+        ringTeardown(ring);
+        return false;
+    }
+
+    ring.sqesBytes = params.sq_entries * sizeof(struct io_uring_sqe);
+    void *sqes = mmap(NULL, ring.sqesBytes, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ring.fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED)
+    {
+        ringTeardown(ring);
+        return false;
+    }
+
+    ring.sqes = (struct io_uring_sqe *)sqes;
+
+    char *sq = (char *)ring.sqMap,
+         *cq = (char *)ring.cqMap;
+
+    ring.sqHead = (unsigned *)(sq + params.sq_off.head);
+    ring.sqTail = (unsigned *)(sq + params.sq_off.tail);
+    ring.sqMask = (unsigned *)(sq + params.sq_off.ring_mask);
+    ring.sqArray = (unsigned *)(sq + params.sq_off.array);
+    ring.cqHead = (unsigned *)(cq + params.cq_off.head);
+    ring.cqTail = (unsigned *)(cq + params.cq_off.tail);
+    ring.cqMask = (unsigned *)(cq + params.cq_off.ring_mask);
+    ring.cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+
+    return true;
+}
+
+/** Queue a read (it is submitted by the next ringEnter()).
+ *
+ *  @param ring The instance.
+ *  @param fd The descriptor, or the index of a registered file.
+ *  @param fixedFile Whether fd is the index of a registered file.
+ *  @param buffer The destination.
+ *  @param bufferIndex The index of the registered buffer that contains
+ *         the destination, or -1 if the buffers are not registered.
+ *  @param length The number of bytes.
+ *  @param offset The position in the file.
+ *  @param userData The tag of the completion.
+ *  @return none.
+*/
+static void ringRead (Ring &ring, int fd, bool fixedFile, byte_t *buffer,
+                      int bufferIndex, uint32_t length, uint64_t offset,
+                      uint64_t userData)
+{
+    // The caller never has more reads outstanding than there are
+    // entries, so there is always room.
+    unsigned tail = *ring.sqTail,
+             index = tail & *ring.sqMask;
+    struct io_uring_sqe *sqe = &ring.sqes[index];
+
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = (bufferIndex >= 0) ? IORING_OP_READ_FIXED
+                                     : IORING_OP_READ;
+    sqe->flags = fixedFile ? IOSQE_FIXED_FILE : 0;
+    sqe->fd = fd;
+    sqe->addr = (uint64_t)(uintptr_t)buffer;
+    sqe->len = length;
+    sqe->off = offset;
+    sqe->buf_index = (bufferIndex >= 0) ? (uint16_t)bufferIndex : 0;
+    sqe->user_data = userData;
+
+    ring.sqArray[index] = index;
+    __atomic_store_n(ring.sqTail, tail + 1, __ATOMIC_RELEASE);
+    ++ring.queued;
+
+    return;
+}
+
+/** Submit the queued reads and wait for completions.
+ *
+ *  @param ring The instance.
+ *  @param wait The number of completions to wait for.
+ *  @return true The reads were submitted.
+ *  @return false The kernel refused them.
+*/
+static bool ringEnter (Ring &ring, uint32_t wait)
+{
+    for (;;)
+    {
+        long submitted = syscall(__NR_io_uring_enter, ring.fd, ring.queued,
+                                 wait, (wait > 0) ? IORING_ENTER_GETEVENTS
+                                                  : 0,
+                                 NULL, 0);
+
+        if (submitted >= 0)
+        {
+            ring.queued -= (uint32_t)submitted;
+
+            if (ring.queued == 0)
+                return true;
+
+            wait = 0;
+            continue;
+        }
+
+        if ((errno != EINTR) && (errno != EAGAIN) && (errno != EBUSY))
+            return false;
+    }
+}
+
+/** Register buffers or files with an instance.  */
+static bool ringRegister (Ring &ring, unsigned opcode, const void *arg,
+                          unsigned count)
+{
+    return syscall(__NR_io_uring_register, ring.fd, opcode, arg, count) == 0;
+}
+
+/** Replace a registered file.
+ *
+ *  @param ring The instance.
+ *  @param index The index in the file table.
+ *  @param fd The descriptor, or -1 to clear the entry.
+ *  @return true The entry was replaced.
+ *  @return false The kernel refused.
+*/
+static bool ringSetFile (Ring &ring, uint32_t index, int fd)
+{
+    struct io_uring_files_update update;
+
+    memset(&update, 0, sizeof(update));
+    update.offset = index;
+    update.fds = (uint64_t)(uintptr_t)&fd;
+
+    return syscall(__NR_io_uring_register, ring.fd,
+                   IORING_REGISTER_FILES_UPDATE, &update, 1) == 1;
+}
+
+#endif
+
+/******************************************************
+**            Constructors / Destructors             **
+******************************************************/
+
+/** Initialize a UringReader object.
+ *
+ *  @pre validSettings(queueDepth, batch, readBytes).
+ *  @post The files are hashed with clones of prototype, on one
+ *        thread per online processor.
+ *  @param prototype A (reset) hash object of the algorithm; it is
+ *         copied.
+ *  @param queueDepth The reads that each thread keeps outstanding.
+ *  @param batch The reads submitted per system call.
+ *  @param readBytes The size of each read.
+*/
+UringReader::UringReader (const MessageHash &prototype, uint32_t queueDepth,
+                          uint32_t batch, uint32_t readBytes)
+    : _prototype(prototype.clone()),
+      _queueDepth(queueDepth),
+      _batch(batch),
+      _readBytes(readBytes),
+      _threads(1),
+      _direct(false),
+      _progress(NULL),
+      _job(NULL)
+{
+    setThreads(0);
+}
+
+/** Default destructor.  */
+UringReader::~UringReader ()
+{
+    _finish();
+    delete _prototype;
+}
+
+/******************************************************
+**               Accessors / Mutators                **
+******************************************************/
+
+////////////////////
+//    Getters
+////////////////////
+
+/** Retrieve the queue depth of each thread.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return The number of reads.
+*/
+uint32_t UringReader::queueDepth (void) const
+{
+    return _queueDepth;
+}
+
+/** Retrieve the batch size.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return The reads submitted per system call.
+*/
+uint32_t UringReader::batch (void) const
+{
+    return _batch;
+}
+
+/** Retrieve the number of threads that read the files.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return The number of threads.
+*/
+uint32_t UringReader::threads (void) const
+{
+    return _threads;
+}
+
+/** Determine whether the files are read without caching them.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return true The files are read with O_DIRECT (or dropped from
+ *          the page cache after they are read).
+ *  @return false They are read through the page cache.
+*/
+bool UringReader::direct (void) const
+{
+    return _direct;
+}
+
+////////////////////
+//    Setters
+////////////////////
+
+/** Select the number of threads that read the files.
+ *
+ *  @pre none.
+ *  @post Subsequent calls to start() use the given number of threads.
+ *  @param threads The number of threads; zero selects one thread for
+ *         each online processor.
+ *  @return none.
+*/
+void UringReader::setThreads (uint32_t threads)
+{
+    if (threads == 0)
+    {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (online > 0) ? (uint32_t)online : 1;
+    }
+
+    _threads = threads;
+
+    return;
+}
+
+/** Select whether the files are read without caching them.
+ *
+ *  @pre none.
+ *  @post Subsequent calls to start() read the files with O_DIRECT,
+ *        or drop the pages that they read where O_DIRECT is refused
+ *        (see DirectReader).
+ *  @param direct Whether to bypass the page cache.
+ *  @return none.
+*/
+void UringReader::setDirect (bool direct)
+{
+    _direct = direct;
+
+    return;
+}
+
+/** Count the bytes that the threads hash.
+ *
+ *  @pre none.
+ *  @post Subsequent calls to start() add each buffer that is hashed
+ *        to the counter of the device of its file.
+ *  @param progress The counters (or NULL for none).
+ *  @return none.
+*/
+void UringReader::setProgress (ProgressMonitor *progress)
+{
+    _progress = progress;
+
+    return;
+}
+
+/******************************************************
+**                      Methods                      **
+******************************************************/
+
+/** Start hashing a list of files (in the background).
+ *
+ *  @pre none.
+ *  @post Any earlier list is abandoned, and next() returns the
+ *        results for files.
+ *  @param files The files.
+ *  @return none.
+*/
+void UringReader::start (const vector < string > &files)
+{
+    _finish();
+
+    _job = new Job();
+    _job->prototype = _prototype;
+    _job->files = files;
+    _job->queueDepth = _queueDepth;
+    _job->batch = _batch;
+    _job->readBytes = _readBytes;
+    _job->direct = _direct;
+    _job->progress = _progress;
+    _job->next = 0;
+    _job->returned = 0;
+    _job->results.resize(files.size());
+    _job->done.assign(files.size(), false);
+
+    pthread_mutex_init(&_job->lock, NULL);
+    pthread_cond_init(&_job->published, NULL);
+
+    // No more threads than files.
+    size_t threads = (_threads < files.size()) ? _threads : files.size();
+    _job->threads.resize(threads);
+
+    for (size_t t = 0; t < threads; ++t)
+        pthread_create(&_job->threads[t], NULL, _worker, _job);
+
+    return;
+}
+
+/** Retrieve the result for the next file, waiting for it to be
+ *  hashed.  The results are returned in the order of the files,
+ *  although they are hashed concurrently.
+ *
+ *  @pre start() has been called.
+ *  @post result holds the next file's digest.
+ *  @param result Receives the result.
+ *  @return true A result was returned.
+ *  @return false Every file has been returned.
+*/
+bool UringReader::next (Result &result)
+{
+    if ((_job == NULL) || (_job->returned == _job->files.size()))
+        return false;
+
+    pthread_mutex_lock(&_job->lock);
+
+    while (!_job->done[_job->returned])
+        pthread_cond_wait(&_job->published, &_job->lock);
+
+    Result &ready = _job->results[_job->returned++];
+    result.name.swap(ready.name);
+    result.digest.swap(ready.digest);
+    result.bytes = ready.bytes;
+    result.failed = ready.failed;
+
+    pthread_mutex_unlock(&_job->lock);
+
+    return true;
+}
+
+/******************************************************
+**                  Static Methods                   **
+******************************************************/
+
+/** Determine whether the kernel provides io_uring to this process
+ *  (it may be disabled, or blocked by a seccomp filter).
+ *
+ *  @pre none.
+ *  @post none.
+ *  @return true An io_uring instance can be created.
+ *  @return false The threads would use blocking reads.
+*/
+bool UringReader::supported (void)
+{
+#ifdef GASH_IO_URING
+    Ring ring;
+
+    if (!ringSetup(ring, 1))
+        return false;
+
+    ringTeardown(ring);
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+/** Determine whether the engine settings are valid.
+ *
+ *  @pre none.
+ *  @post none.
+ *  @param queueDepth The reads that each thread keeps outstanding.
+ *  @param batch The reads submitted per system call.
+ *  @param readBytes The size of each read.
+ *  @return true 1 <= batch <= queueDepth <= MAX_QUEUE_DEPTH, and
+ *          readBytes is a positive multiple of 4096 of at most
+ *          16 MiB.
+ *  @return false Otherwise.
+*/
+bool UringReader::validSettings (uint32_t queueDepth, uint32_t batch,
+                                 uint32_t readBytes)
+{
+    return (batch >= 1) && (batch <= queueDepth)
+           && (queueDepth <= MAX_QUEUE_DEPTH) && (readBytes > 0)
+           && (readBytes % BUFFER_ALIGNMENT == 0)
+           && (readBytes <= MAX_READ_BYTES);
+}
+
+/******************************************************
+**                   Helper Methods                  **
+******************************************************/
+
+/** Wait for the threads of the current list and release it.
+ *
+ *  @return none.
+*/
+void UringReader::_finish (void)
+{
+    if (_job == NULL)
+        return;
+
+    // Abandoned files are still hashed (the threads cannot be
+    // interrupted mid-read), but no more are claimed.
+    pthread_mutex_lock(&_job->lock);
+    _job->next = _job->files.size();
+    pthread_mutex_unlock(&_job->lock);
+
+    for (size_t t = 0; t < _job->threads.size(); ++t)
+        pthread_join(_job->threads[t], NULL);
+
+    pthread_cond_destroy(&_job->published);
+    pthread_mutex_destroy(&_job->lock);
+
+    delete _job;
+    _job = NULL;
+
+    return;
+}
+
+/** The body of each thread.
+ *
+ *  @param arg The Job.
+ *  @return NULL.
+*/
+void * UringReader::_worker (void *arg)
+{
+    Job &job = *(Job *)arg;
+
+    if (!_runRing(job))
+        _runBlocking(job);
+
+    return NULL;
+}
+
+/** Hash files through an io_uring instance.
+ *
+ *  @param job The list.
+ *  @return true The files were hashed.
+ *  @return false No io_uring instance could be created (and no file
+ *          was claimed).
+*/
+bool UringReader::_runRing (Job &job)
+{
+#ifdef GASH_IO_URING
+    /**
+     *  @struct OpenFile A file that the ring is reading.
+    */
+    struct OpenFile
+    {
+        bool used;                  // The entry holds a file.
+        size_t index;               // The index of the file in the list.
+        int fd;                     // Its descriptor.
+        bool direct;                // It was opened with O_DIRECT.
+        CacheGuard cache;           // Drops what is read through the cache
+                                    // (if the list bypasses it).
+        bool fixed;                 // It is in the registered file table.
+        uint64_t size;              // Its size when it was opened.
+        uint32_t device;            // Its progress counter.
+        uint64_t submitted;         // The bytes that reads were queued for.
+        uint64_t hashed;            // The bytes hashed (in order).
+        uint32_t inflight;          // Its reads outstanding.
+        bool failed;                // A read failed.
+        MessageHash *hash;          // Its hash.
+        std::map < uint64_t, uint32_t > ready;  // Completed reads that
+                                                // wait their turn (by
+                                                // offset, to slot).
+    };
+
+    /**
+     *  @struct Slot A read buffer and the read that uses it.
+    */
+    struct Slot
+    {
+        uint32_t file;              // The OpenFile entry.
+        uint64_t offset;            // The position of the read.
+        uint32_t length;            // The bytes requested.
+        uint32_t filled;            // The bytes read so far.
+    };
+
+    Ring ring;
+    if (!ringSetup(ring, job.queueDepth))
+        return false;
+
+    const uint32_t depth = job.queueDepth,
+                   readBytes = job.readBytes;
+    const uint32_t fileCount = (depth < MAX_OPEN_FILES) ? depth
+                                                        : MAX_OPEN_FILES;
+
+    void *memory = NULL;
+    if (posix_memalign(&memory, BUFFER_ALIGNMENT,
+                       (size_t)depth * readBytes) != 0)
+    {
+        ringTeardown(ring);
+        return false;
+    }
+
+    byte_t *buffers = (byte_t *)memory;
+
+    // The buffers are pinned once, rather than for every read, and the
+    // files are looked up once when they are opened, rather than for
+    // every read.  Either can fail (e.g. under RLIMIT_MEMLOCK), in which
+    // case plain reads are used.
+    vector < struct iovec > iovecs(depth);
+    for (uint32_t s = 0; s < depth; ++s)
+    {
+        iovecs[s].iov_base = buffers + (size_t)s * readBytes;
+        iovecs[s].iov_len = readBytes;
+    }
+
+    bool fixedBuffers = ringRegister(ring, IORING_REGISTER_BUFFERS,
+                                     &iovecs[0], depth);
+
+    vector < int > emptyTable(fileCount, -1);
+    bool fixedFiles = ringRegister(ring, IORING_REGISTER_FILES,
+                                   &emptyTable[0], fileCount);
+
+    vector < OpenFile > files(fileCount);
+    vector < Slot > slots(depth);
+    vector < uint32_t > freeSlots;
+
+    for (uint32_t f = 0; f < fileCount; ++f)
+    {
+        files[f].used = false;
+        files[f].hash = job.prototype->clone();
+    }
+
+    for (uint32_t s = depth; s-- > 0; )
+        freeSlots.push_back(s);
+
+    uint32_t openCount = 0,
+             inflight = 0,
+             cursor = 0;
+    bool exhausted = false,
+         broken = false;
+
+    for (;;)
+    {
+        // Keep the file table full.
+        while (!exhausted && (openCount < fileCount))
+        {
+            size_t index;
+            if (!_claim(job, index))
+            {
+                exhausted = true;
+                break;
+            }
+
+            uint32_t f = 0;
+            while (files[f].used)
+                ++f;
+
+            OpenFile &file = files[f];
+            struct stat status;
+
+            file.direct = false;
+            file.fd = job.direct ? DirectReader::openFile(job.files[index],
+                                                          file.direct)
+                                 : open(job.files[index].c_str(), O_RDONLY);
+            if ((file.fd < 0) || (fstat(file.fd, &status) != 0))
+            {
+                if (file.fd >= 0)
+                    close(file.fd);
+
+                _publish(job, index, *file.hash, 0, true);
+                continue;
+            }
+
+            file.hash->reset();
+
+            if (status.st_size == 0)
+            {
+                close(file.fd);
+                file.hash->finalize();
+                _publish(job, index, *file.hash, 0, false);
+                continue;
+            }
+
+            if (!file.direct)
+                posix_fadvise(file.fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+            // Where O_DIRECT is refused, what is read is dropped again.
+            file.cache.attach((job.direct && !file.direct) ? file.fd : -1);
+
+            file.used = true;
+            file.index = index;
+            file.fixed = fixedFiles && ringSetFile(ring, f, file.fd);
+            file.size = (uint64_t)status.st_size;
+            file.device = (job.progress != NULL)
+                          ? job.progress->device(status.st_dev) : 0;
+            file.submitted = 0;
+            file.hashed = 0;
+            file.inflight = 0;
+            file.failed = false;
+            ++openCount;
+        }
+
+        // Spread the free buffers over the open files.
+        uint32_t queued = 0,
+                 idle = 0;
+
+        while ((queued < job.batch) && !freeSlots.empty()
+               && (idle < fileCount))
+        {
+            OpenFile &file = files[cursor];
+            uint32_t f = cursor;
+            cursor = (cursor + 1) % fileCount;
+
+            if (!file.used || file.failed || (file.submitted == file.size))
+            {
+                ++idle;
+                continue;
+            }
+
+            idle = 0;
+
+            uint32_t s = freeSlots.back();
+            freeSlots.pop_back();
+
+            Slot &slot = slots[s];
+            uint64_t left = file.size - file.submitted;
+
+            slot.file = f;
+            slot.offset = file.submitted;
+            slot.length = (left < readBytes) ? (uint32_t)left : readBytes;
+            slot.filled = 0;
+
+            file.cache.prepare(slot.offset, slot.length);
+
+            // A direct read must be a whole number of blocks; the last
+            // one of the file is short.
+            uint32_t request = slot.length;
+            if (file.direct)
+                request = (request + BUFFER_ALIGNMENT - 1)
+                          & ~(BUFFER_ALIGNMENT - 1);
+
+            ringRead(ring, file.fixed ? (int)f : file.fd, file.fixed,
+                     buffers + (size_t)s * readBytes,
+                     fixedBuffers ? (int)s : -1, request, slot.offset, s);
+
+            file.submitted += slot.length;
+            ++file.inflight;
+            ++inflight;
+            ++queued;
+        }
+
+        if ((inflight == 0) && (openCount == 0) && exhausted)
+            break;
+
+        // Wait for a batch of completions once no more reads can be
+        // queued (but never for more than are outstanding).
+        bool full = freeSlots.empty() || (idle >= fileCount);
+        uint32_t wait = full ? ((job.batch < inflight) ? job.batch : inflight)
+                             : 0;
+
+        if (((ring.queued > 0) || (wait > 0)) && !ringEnter(ring, wait))
+        {
+            broken = true;
+            break;
+        }
+
+        unsigned head = *ring.cqHead,
+                 tail = __atomic_load_n(ring.cqTail, __ATOMIC_ACQUIRE);
+
+        for (; head != tail; ++head)
+        {
+            struct io_uring_cqe *cqe = &ring.cqes[head & *ring.cqMask];
+            uint32_t s = (uint32_t)cqe->user_data;
+            int32_t result = cqe->res;
+            Slot &slot = slots[s];
+            OpenFile &file = files[slot.file];
+
+            --inflight;
+
+            // Some file systems accept O_DIRECT when the file is opened,
+            // but not for reads (or not at this alignment, after a short
+            // read); the file is read through the page cache instead.
+            if ((result == -EINVAL) && file.direct)
+            {
+                int flags = fcntl(file.fd, F_GETFL);
+                if (flags >= 0)
+                    fcntl(file.fd, F_SETFL, flags & ~O_DIRECT);
+
+                file.direct = false;
+                file.cache.attach(file.fd);
+                file.cache.prepare(slot.offset, slot.length);
+                result = -EAGAIN;
+            }
+
+            if ((result == -EINTR) || (result == -EAGAIN)
+                || ((result > 0)
+                    && (slot.filled + (uint32_t)result < slot.length)))
+            {
+                // Finish a short (or interrupted) read.
+                if (result > 0)
+                    slot.filled += (uint32_t)result;
+
+                ringRead(ring, file.fixed ? (int)slot.file : file.fd,
+                         file.fixed, buffers + (size_t)s * readBytes
+                                     + slot.filled,
+                         fixedBuffers ? (int)s : -1,
+                         slot.length - slot.filled, slot.offset + slot.filled,
+                         s);
+                ++inflight;
+                continue;
+            }
+
+            --file.inflight;
+
+            // A read at or past the end of the file means that it was
+            // truncated under us.
+            if (result <= 0)
+            {
+                file.failed = true;
+                freeSlots.push_back(s);
+                continue;
+            }
+
+            file.ready[slot.offset] = s;
+
+            // Hash the reads that are now in order.
+            std::map < uint64_t, uint32_t >::iterator next;
+            while (!file.failed
+                   && ((next = file.ready.find(file.hashed))
+                       != file.ready.end()))
+            {
+                uint32_t r = next->second;
+
+                file.hash->update(buffers + (size_t)r * readBytes,
+                                  slots[r].length);
+                file.cache.release(file.hashed, slots[r].length);
+
+                if (job.progress != NULL)
+                    job.progress->add(file.device, slots[r].length);
+
+                file.hashed += slots[r].length;
+                file.ready.erase(next);
+                freeSlots.push_back(r);
+            }
+        }
+
+        __atomic_store_n(ring.cqHead, head, __ATOMIC_RELEASE);
+
+        // Retire the files that are complete (or failed and quiet).
+        for (uint32_t f = 0; f < fileCount; ++f)
+        {
+            OpenFile &file = files[f];
+
+            if (!file.used || (file.inflight > 0)
+                || (!file.failed && (file.hashed < file.size)))
+                continue;
+
+            if (!file.failed)
+                file.hash->finalize();
+
+            _publish(job, file.index, *file.hash, file.hashed, file.failed);
+
+            for (std::map < uint64_t, uint32_t >::iterator r =
+                     file.ready.begin(); r != file.ready.end(); ++r)
+                freeSlots.push_back(r->second);
+
+            file.ready.clear();
+
+            if (file.fixed)
+                ringSetFile(ring, f, -1);
+
+            file.cache.flush();
+            close(file.fd);
+            file.used = false;
+            --openCount;
+        }
+    }
+
+    // If the kernel refused a submission the files that were open are
+    // read again, and the rest of the list, with blocking reads.
+    if (broken)
+    {
+        vector < byte_t > buffer(job.direct ? 0 : readBytes);
+        DirectReader *direct = job.direct ? new DirectReader(readBytes)
+                                          : NULL;
+
+        for (uint32_t f = 0; f < fileCount; ++f)
+        {
+            if (files[f].used)
+            {
+                close(files[f].fd);
+                _hashFile(job, files[f].index, *files[f].hash, buffer,
+                          direct);
+            }
+        }
+
+        delete direct;
+    }
+
+    for (uint32_t f = 0; f < fileCount; ++f)
+        delete files[f].hash;
+
+    ringTeardown(ring);
+
+    // The kernel may still complete reads into the buffers after the
+    // ring is closed, so they are only released when none are pending.
+    if (inflight == 0)
+        free(memory);
+
+    if (broken)
+        _runBlocking(job);
+
+    return true;
+#else
+    (void)job;
+    return false;
+#endif
+}
+
+/** Hash files with blocking reads.
+ *
+ *  @param job The list.
+ *  @return none.
+*/
+void UringReader::_runBlocking (Job &job)
+{
+    MessageHash *hash = job.prototype->clone();
+    vector < byte_t > buffer(job.direct ? 0 : job.readBytes);
+    DirectReader *direct = job.direct ? new DirectReader(job.readBytes)
+                                      : NULL;
+    size_t index;
+
+    while (_claim(job, index))
+        _hashFile(job, index, *hash, buffer, direct);
+
+    delete direct;
+    delete hash;
+
+    return;
+}
+
+/** Hash one file with blocking reads and publish its result.
+ *
+ *  @param job The list.
+ *  @param index The index of the file.
+ *  @param hash The hash to use.
+ *  @param buffer The read buffer.
+ *  @param direct The reader to use instead of buffer (if the files
+ *         bypass the page cache), or NULL.
+ *  @return none.
+*/
+void UringReader::_hashFile (Job &job, size_t index, MessageHash &hash,
+                             vector < byte_t > &buffer, DirectReader *direct)
+{
+    // The progress counter of the device of the file.
+    uint32_t device = 0;
+    struct stat status;
+
+    if ((job.progress != NULL)
+        && (stat(job.files[index].c_str(), &status) == 0))
+        device = job.progress->device(status.st_dev);
+
+    if (direct != NULL)
+    {
+        bool failed = !direct->hash(job.files[index], hash);
+
+        if (job.progress != NULL)
+            job.progress->add(device, direct->bytesRead());
+
+        _publish(job, index, hash, direct->bytesRead(), failed);
+
+        return;
+    }
+
+    int fd = open(job.files[index].c_str(), O_RDONLY);
+    uint64_t total = 0;
+    bool failed = (fd < 0);
+
+    if (!failed)
+    {
+        posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        hash.reset();
+
+        for (;;)
+        {
+            ssize_t length = read(fd, &buffer[0], buffer.size());
+
+            if ((length < 0) && (errno == EINTR))
+                continue;
+
+            if (length <= 0)
+            {
+                failed = (length < 0);
+                break;
+            }
+
+            hash.update(&buffer[0], (uint64_t)length);
+            total += (uint64_t)length;
+
+            if (job.progress != NULL)
+                job.progress->add(device, (uint64_t)length);
+        }
+
+        hash.finalize();
+        close(fd);
+    }
+
+    _publish(job, index, hash, total, failed);
+
+    return;
+}
+
+/** Claim the next file of the list.
+ *
+ *  @param job The list.
+ *  @param index Receives the index of the file.
+ *  @return true A file was claimed.
+ *  @return false Every file has been claimed.
+*/
+bool UringReader::_claim (Job &job, size_t &index)
+{
+    pthread_mutex_lock(&job.lock);
+
+    bool claimed = (job.next < job.files.size());
+    if (claimed)
+        index = job.next++;
+
+    pthread_mutex_unlock(&job.lock);
+
+    return claimed;
+}
+
+/** Hand the result for a file to next().
+ *
+ *  @param job The list.
+ *  @param index The index of the file.
+ *  @param hash The finalized hash (unless failed).
+ *  @param bytes The bytes read.
+ *  @param failed Whether the file could not be read.
+ *  @return none.
+*/
+void UringReader::_publish (Job &job, size_t index, const MessageHash &hash,
+                            uint64_t bytes, bool failed)
+{
+    vector < byte_t > digest;
+    if (!failed)
+        digest = hash.asBytes();
+
+    pthread_mutex_lock(&job.lock);
+
+    Result &result = job.results[index];
+    result.name = job.files[index];
+    result.digest.swap(digest);
+    result.bytes = bytes;
+    result.failed = failed;
+    job.done[index] = true;
+
+    pthread_cond_broadcast(&job.published);
+    pthread_mutex_unlock(&job.lock);
+
+    if (job.progress != NULL)
+        job.progress->fileDone();
+
+    return;
+}
@@ -0,0 +1,362 @@
+/******************************************************************************
+||  uring_reader.h                                                           ||
+||===========================================================================||
+||                                                                           ||
+||    Author: Gary Hammock, PE                                               ||
+||    Creation Date: 2026-10-16                                              ||
+||    Last Edit Date: 2026-10-16                                             ||
+||                                                                           ||
+||===========================================================================||
+||  DESCRIPTION                                                              ||
+||===========================================================================||
+||    Reads and hashes many files through io_uring, so that a few threads    ||
+||    keep a deep queue of reads outstanding on fast (NVMe) storage instead  ||
+||    of each waiting on one blocking read at a time.                        ||
+||                                                                           ||
+||    Each thread owns a ring, whose read buffers are registered with the    ||
+||    kernel once (READ_FIXED), and a table of registered (fixed) files.  A  ||
+||    thread keeps up to 64 files open and spreads its queue depth of reads  ||
+||    over them round robin, submitting and reaping them in batches.  A      ||
+||    completed read is hashed as soon as the reads before it in its file    ||
+||    have been; later ones wait in their buffers.  Where io_uring is        ||
+||    unavailable (or blocked) the threads fall back to blocking reads.      ||
+||    With setDirect() the files are read around the page cache (see         ||
+||    DirectReader).                                                         ||
+||                                                                           ||
+||===========================================================================||
+||  CODE DEPENDENCIES                                                        ||
+||===========================================================================||
+||    direct_reader.cpp                                                      ||
+||    direct_reader.h                                                        ||
+||    Hashes/hash_abstract.cpp (hash_abstract.lib)                           ||
+||    Hashes/hash_abstract.h                                                 ||
+||    linux/io_uring.h (Linux 5.6 or later)                                  ||
+||    pthread                                                                ||
+||                                                                           ||
+||===========================================================================||
+||  LICENSE    (MIT/X11 License)                                             ||
+||===========================================================================||
+||    Copyright (C) 2008-2014 Gary Hammock                                   ||
+||                                                                           ||
+||    Permission is hereby granted, free of charge, to any person obtaining  ||
+||    a copy of this software and associated documentation files (the        ||
+||    "Software"), to deal in the Software without restriction, including    ||
+||    without limitation the rights to use, copy, modify, merge, publish,    ||
+||    distribute, sublicense, and/or sell copies of the Software, and to     ||
+||    permit persons to whom the Software is furnished to do so, subject to  ||
+||    the following conditions:                                              ||
+||                                                                           ||
+||    The above copyright notice and this permission notice shall be         ||
+||    included in all copies or substantial portions of the Software.        ||
+||                                                                           ||
+||    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        ||
+||    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     ||
+||    MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. ||
+||    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   ||
+||    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   ||
+||    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      ||
+||    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 ||
+||                                                                           ||
+******************************************************************************/
+
+/** @file uring_reader.h
+ *  @author Gary Hammock, PE
+ *  @date 2026-10-16
+*/
+
+
+#ifndef _GH_URING_READER_DEF_H
+#define _GH_URING_READER_DEF_H
+
+#include "Hashes/hash_abstract.h"
+#include "direct_reader.h"
+#include "progress_monitor.h"
+
+#if defined(__linux__) && defined(__has_include)
+  #if __has_include(<linux/io_uring.h>)
+    #define GASH_IO_URING 1
+  #endif
+#endif
+
+/**
+ *  @class UringReader Hashes files with asynchronous (io_uring) reads.
+*/
+class UringReader
+{
+  public:
+    /******************************************************
+    **                     Constants                     **
+    ******************************************************/
+
+    /// The default number of reads that each thread keeps outstanding.
+    static const uint32_t DEFAULT_QUEUE_DEPTH = 64;
+
+    /// The default number of reads submitted (and completions waited
+    /// for) per system call.
+    static const uint32_t DEFAULT_BATCH = 16;
+
+    /// The default size of each read.
+    static const uint32_t DEFAULT_READ_BYTES = 262144;
+
+    /// The largest queue depth.
+    static const uint32_t MAX_QUEUE_DEPTH = 4096;
+
+    /// The most files that each thread keeps open.
+    static const uint32_t MAX_OPEN_FILES = 64;
+
+    /**
+     *  @struct Result The digest of a file.
+    */
+    struct Result
+    {
+        string name;                // The file.
+        vector < byte_t > digest;   // The digest (if not failed).
+        uint64_t bytes;             // The bytes read.
+        bool failed;                // The file could not be read.
+    };
+
+    /******************************************************
+    **            Constructors / Destructors             **
+    ******************************************************/
+
+    /** Initialize a UringReader object.
+     *
+     *  @pre validSettings(queueDepth, batch, readBytes).
+     *  @post The files are hashed with clones of prototype, on one
+     *        thread per online processor.
+     *  @param prototype A (reset) hash object of the algorithm; it is
+     *         copied.
+     *  @param queueDepth The reads that each thread keeps outstanding.
+     *  @param batch The reads submitted per system call.
+     *  @param readBytes The size of each read.
+    */
+    UringReader (const MessageHash &prototype,
+                 uint32_t queueDepth = DEFAULT_QUEUE_DEPTH,
+                 uint32_t batch = DEFAULT_BATCH,
+                 uint32_t readBytes = DEFAULT_READ_BYTES);
+
+    /** Default destructor.  */
+    ~UringReader ();
+
+    /******************************************************
+    **               Accessors / Mutators                **
+    ******************************************************/
+
+    ////////////////////
+    //    Getters
+    ////////////////////
+
+    /** Retrieve the queue depth of each thread.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return The number of reads.
+    */
+    uint32_t queueDepth (void) const;
+
+    /** Retrieve the batch size.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return The reads submitted per system call.
+    */
+    uint32_t batch (void) const;
+
+    /** Retrieve the number of threads that read the files.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return The number of threads.
+    */
+    uint32_t threads (void) const;
+
+    /** Determine whether the files are read without caching them.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return true The files are read with O_DIRECT (or dropped from
+     *          the page cache after they are read).
+     *  @return false They are read through the page cache.
+    */
+    bool direct (void) const;
+
+    ////////////////////
+    //    Setters
+    ////////////////////
+
+    /** Select the number of threads that read the files.
+     *
+     *  @pre none.
+     *  @post Subsequent calls to start() use the given number of threads.
+     *  @param threads The number of threads; zero selects one thread for
+     *         each online processor.
+     *  @return none.
+    */
+    void setThreads (uint32_t threads);
+
+    /** Select whether the files are read without caching them.
+     *
+     *  @pre none.
+     *  @post Subsequent calls to start() read the files with O_DIRECT,
+     *        or drop the pages that they read where O_DIRECT is refused
+     *        (see DirectReader).
+     *  @param direct Whether to bypass the page cache.
+     *  @return none.
+    */
+    void setDirect (bool direct);
+
+    /** Count the bytes that the threads hash.
+     *
+     *  @pre none.
+     *  @post Subsequent calls to start() add each buffer that is hashed
+     *        to the counter of the device of its file.
+     *  @param progress The counters (or NULL for none).
+     *  @return none.
+    */
+    void setProgress (ProgressMonitor *progress);
+
+    /******************************************************
+    **                      Methods                      **
+    ******************************************************/
+
+    /** Start hashing a list of files (in the background).
+     *
+     *  @pre none.
+     *  @post Any earlier list is abandoned, and next() returns the
+     *        results for files.
+     *  @param files The files.
+     *  @return none.
+    */
+    void start (const vector < string > &files);
+
+    /** Retrieve the result for the next file, waiting for it to be
+     *  hashed.  The results are returned in the order of the files,
+     *  although they are hashed concurrently.
+     *
+     *  @pre start() has been called.
+     *  @post result holds the next file's digest.
+     *  @param result Receives the result.
+     *  @return true A result was returned.
+     *  @return false Every file has been returned.
+    */
+    bool next (Result &result);
+
+    /******************************************************
+    **                  Static Methods                   **
+    ******************************************************/
+
+    /** Determine whether the kernel provides io_uring to this process
+     *  (it may be disabled, or blocked by a seccomp filter).
+     *
+     *  @pre none.
+     *  @post none.
+     *  @return true An io_uring instance can be created.
+     *  @return false The threads would use blocking reads.
+    */
+    static bool supported (void);
+
+    /** Determine whether the engine settings are valid.
+     *
+     *  @pre none.
+     *  @post none.
+     *  @param queueDepth The reads that each thread keeps outstanding.
+     *  @param batch The reads submitted per system call.
+     *  @param readBytes The size of each read.
+     *  @return true 1 <= batch <= queueDepth <= MAX_QUEUE_DEPTH, and
+     *          readBytes is a positive multiple of 4096 of at most
+     *          16 MiB.
+     *  @return false Otherwise.
+    */
+    static bool validSettings (uint32_t queueDepth, uint32_t batch,
+                               uint32_t readBytes);
+
+  private:
+    /******************************************************
+    **                      Members                      **
+    ******************************************************/
+
+    struct Job;                     // The state shared with the threads.
+
+    MessageHash *_prototype;        // The algorithm.
+    uint32_t _queueDepth;           // The reads kept outstanding.
+    uint32_t _batch;                // The reads per system call.
+    uint32_t _readBytes;            // The size of each read.
+    uint32_t _threads;              // The threads that read the files.
+    bool _direct;                   // Bypass the page cache.
+    ProgressMonitor *_progress;     // The progress counters (or NULL).
+    Job *_job;                      // The list being hashed (or NULL).
+
+    // Not copyable (owns _prototype and _job).
+    UringReader (const UringReader &);
+    UringReader & operator = (const UringReader &);
+
+    /******************************************************
+    **                   Helper Methods                  **
+    ******************************************************/
+
+    /** Wait for the threads of the current list and release it.
+     *
+     *  @return none.
+    */
+    void _finish (void);
+
+    /** The body of each thread.
+     *
+     *  @param arg The Job.
+     *  @return NULL.
+    */
+    static void * _worker (void *arg);
+
+    /** Hash files through an io_uring instance.
+     *
+     *  @param job The list.
+     *  @return true The files were hashed.
+     *  @return false No io_uring instance could be created (and no file
+     *          was claimed).
+    */
+    static bool _runRing (Job &job);
+
+    /** Hash files with blocking reads.
+     *
+     *  @param job The list.
+     *  @return none.
+    */
+    static void _runBlocking (Job &job);
+
+    /** Hash one file with blocking reads and publish its result.
+     *
+     *  @param job The list.
+     *  @param index The index of the file.
+     *  @param hash The hash to use.
+     *  @param buffer The read buffer.
+     *  @param direct The reader to use instead of buffer (if the files
+     *         bypass the page cache), or NULL.
+     *  @return none.
+    */
+    static void _hashFile (Job &job, size_t index, MessageHash &hash,
+                           vector < byte_t > &buffer, DirectReader *direct);
+
+    /** Claim the next file of the list.
+     *
+     *  @param job The list.
+     *  @param index Receives the index of the file.
+     *  @return true A file was claimed.
+     *  @return false Every file has been claimed.
+    */
+    static bool _claim (Job &job, size_t &index);
+
+    /** Hand the result for a file to next().
+     *
+     *  @param job The list.
+     *  @param index The index of the file.
+     *  @param hash The finalized hash (unless failed).
+     *  @param bytes The bytes read.
+     *  @param failed Whether the file could not be read.
+     *  @return none.
+    */
+    static void _publish (Job &job, size_t index, const MessageHash &hash,
+                          uint64_t bytes, bool failed);
+
+};  // End class UringReader.
+
+#endif